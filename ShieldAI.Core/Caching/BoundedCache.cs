@@ -0,0 +1,425 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Caching/BoundedCache.cs
+// كاش متزامن محدود بالعدد والحجم مع صلاحية وإحصائيات
+// =====================================================
+
+using System.Text.Json;
+
+namespace ShieldAI.Core.Caching
+{
+    /// <summary>
+    /// سياسة اختيار الضحية عند تجاوز الميزانية
+    /// </summary>
+    public enum CacheEvictionPolicy
+    {
+        /// <summary>
+        /// الأقل استخداماً مؤخراً - القراءة تجدد العنصر
+        /// </summary>
+        Lru,
+
+        /// <summary>
+        /// الأقدم إدراجاً - القراءة لا تغير الترتيب
+        /// </summary>
+        Fifo
+    }
+
+    /// <summary>
+    /// إعدادات الكاش المحدود
+    /// </summary>
+    public class BoundedCacheOptions
+    {
+        /// <summary>
+        /// اسم الكاش في السجلات والإحصائيات
+        /// </summary>
+        public string Name { get; set; } = "Cache";
+
+        /// <summary>
+        /// أقصى عدد للعناصر
+        /// </summary>
+        public int MaxEntries { get; set; } = 10_000;
+
+        /// <summary>
+        /// أقصى حجم تقديري بالبايت (0 = بلا حد، يتطلب دالة الحجم)
+        /// </summary>
+        public long MaxBytes { get; set; }
+
+        /// <summary>
+        /// مدة الصلاحية (null = بلا انتهاء)
+        /// </summary>
+        public TimeSpan? Ttl { get; set; }
+
+        /// <summary>
+        /// سياسة الإخلاء
+        /// </summary>
+        public CacheEvictionPolicy Policy { get; set; } = CacheEvictionPolicy.Lru;
+
+        /// <summary>
+        /// عدد الأقسام المستقلة القفل (0 = تلقائي حسب الحجم)
+        /// </summary>
+        public int SegmentCount { get; set; }
+
+        /// <summary>
+        /// مسار ملف الحفظ (null = في الذاكرة فقط)
+        /// </summary>
+        public string? PersistencePath { get; set; }
+    }
+
+    /// <summary>
+    /// لقطة إحصائيات الكاش
+    /// </summary>
+    public readonly record struct CacheStatistics(
+        string Name,
+        int Count,
+        long Bytes,
+        long Hits,
+        long Misses,
+        long Evictions,
+        long Expirations)
+    {
+        /// <summary>
+        /// نسبة الإصابة (0-1)
+        /// </summary>
+        public double HitRatio => Hits + Misses == 0 ? 0 : (double)Hits / (Hits + Misses);
+    }
+
+    /// <summary>
+    /// كاش عام متزامن: ميزانية عدد/حجم، صلاحية، سياسة إخلاء، حفظ اختياري وإحصائيات.
+    /// المفاتيح موزعة على أقسام بقفل مستقل لكل قسم، وكل قسم يحمل حصته من الميزانية.
+    /// </summary>
+    public sealed class BoundedCache<TKey, TValue> where TKey : notnull
+    {
+        private readonly BoundedCacheOptions _options;
+        private readonly Func<TValue, long>? _sizeOf;
+        private readonly IEqualityComparer<TKey> _comparer;
+        private readonly Func<DateTime> _clock;
+        private readonly Segment[] _segments;
+        private readonly int _segmentMask;
+        private readonly int _segmentMaxEntries;
+        private readonly long _segmentMaxBytes;
+
+        private long _hits;
+        private long _misses;
+        private long _evictions;
+        private long _expirations;
+
+        public BoundedCache(
+            BoundedCacheOptions options,
+            Func<TValue, long>? sizeOf = null,
+            IEqualityComparer<TKey>? comparer = null,
+            Func<DateTime>? clock = null)
+        {
+            _options = options;
+            _sizeOf = sizeOf;
+            _comparer = comparer ?? EqualityComparer<TKey>.Default;
+            _clock = clock ?? (() => DateTime.UtcNow);
+
+            var maxEntries = Math.Max(1, options.MaxEntries);
+            var segmentCount = options.SegmentCount > 0
+                ? options.SegmentCount
+                : Math.Clamp(maxEntries / 1024, 1, Environment.ProcessorCount * 2);
+            segmentCount = (int)Math.Min(System.Numerics.BitOperations.RoundUpToPowerOf2((uint)segmentCount), 64);
+
+            _segments = new Segment[segmentCount];
+            for (int i = 0; i < segmentCount; i++)
+                _segments[i] = new Segment(_comparer);
+            _segmentMask = segmentCount - 1;
+            _segmentMaxEntries = Math.Max(1, (maxEntries + segmentCount - 1) / segmentCount);
+            _segmentMaxBytes = options.MaxBytes > 0 && sizeOf != null
+                ? Math.Max(1, (options.MaxBytes + segmentCount - 1) / segmentCount)
+                : 0;
+
+            if (!string.IsNullOrEmpty(options.PersistencePath))
+                Load(options.PersistencePath);
+        }
+
+        /// <summary>
+        /// اسم الكاش
+        /// </summary>
+        public string Name => _options.Name;
+
+        /// <summary>
+        /// عدد العناصر الحالية (قد يشمل عناصر منتهية لم تُكنس بعد)
+        /// </summary>
+        public int Count
+        {
+            get
+            {
+                int count = 0;
+                foreach (var segment in _segments)
+                    lock (segment) count += segment.Map.Count;
+                return count;
+            }
+        }
+
+        /// <summary>
+        /// الحجم التقديري الحالي بالبايت
+        /// </summary>
+        public long Bytes
+        {
+            get
+            {
+                long bytes = 0;
+                foreach (var segment in _segments)
+                    lock (segment) bytes += segment.Bytes;
+                return bytes;
+            }
+        }
+
+        public bool TryGet(TKey key, out TValue value)
+        {
+            var segment = SegmentFor(key);
+            lock (segment)
+            {
+                if (segment.Map.TryGetValue(key, out var node))
+                {
+                    if (IsExpired(node.Value))
+                    {
+                        segment.Remove(node);
+                        Interlocked.Increment(ref _expirations);
+                    }
+                    else
+                    {
+                        if (_options.Policy == CacheEvictionPolicy.Lru)
+                        {
+                            segment.Order.Remove(node);
+                            segment.Order.AddLast(node);
+                        }
+                        Interlocked.Increment(ref _hits);
+                        value = node.Value.Value;
+                        return true;
+                    }
+                }
+            }
+
+            Interlocked.Increment(ref _misses);
+            value = default!;
+            return false;
+        }
+
+        public void Set(TKey key, TValue value)
+        {
+            var size = _sizeOf?.Invoke(value) ?? 0;
+            var segment = SegmentFor(key);
+            lock (segment)
+            {
+                if (segment.Map.TryGetValue(key, out var existing))
+                    segment.Remove(existing);
+
+                // عنصر أكبر من حصة القسم كاملة لا يُخزن أصلاً
+                if (_segmentMaxBytes > 0 && size > _segmentMaxBytes)
+                    return;
+
+                segment.Add(new Entry(key, value, _clock(), size));
+                EvictIfNeeded(segment);
+            }
+        }
+
+        public bool Remove(TKey key)
+        {
+            var segment = SegmentFor(key);
+            lock (segment)
+            {
+                if (!segment.Map.TryGetValue(key, out var node))
+                    return false;
+                segment.Remove(node);
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// حذف العناصر المنتهية من كل الأقسام
+        /// </summary>
+        public int RemoveExpired()
+        {
+            if (_options.Ttl == null)
+                return 0;
+
+            int removed = 0;
+            foreach (var segment in _segments)
+            {
+                lock (segment)
+                {
+                    var node = segment.Order.First;
+                    while (node != null)
+                    {
+                        var next = node.Next;
+                        if (IsExpired(node.Value))
+                        {
+                            segment.Remove(node);
+                            removed++;
+                        }
+                        node = next;
+                    }
+                }
+            }
+
+            Interlocked.Add(ref _expirations, removed);
+            return removed;
+        }
+
+        public void Clear()
+        {
+            foreach (var segment in _segments)
+            {
+                lock (segment)
+                {
+                    segment.Map.Clear();
+                    segment.Order.Clear();
+                    segment.Bytes = 0;
+                }
+            }
+        }
+
+        public CacheStatistics GetStatistics() => new(
+            _options.Name,
+            Count,
+            Bytes,
+            Interlocked.Read(ref _hits),
+            Interlocked.Read(ref _misses),
+            Interlocked.Read(ref _evictions),
+            Interlocked.Read(ref _expirations));
+
+        /// <summary>
+        /// حفظ العناصر الصالحة في ملف الحفظ (إن كان مهيأً) عبر ملف مؤقت ثم إعادة تسمية
+        /// </summary>
+        public void Save()
+        {
+            var path = _options.PersistencePath;
+            if (string.IsNullOrEmpty(path))
+                return;
+
+            var snapshot = new List<PersistedEntry>();
+            foreach (var segment in _segments)
+            {
+                lock (segment)
+                {
+                    foreach (var entry in segment.Order)
+                    {
+                        if (!IsExpired(entry))
+                            snapshot.Add(new PersistedEntry { Key = entry.Key, Value = entry.Value, CreatedUtc = entry.CreatedUtc });
+                    }
+                }
+            }
+
+            var directory = Path.GetDirectoryName(path);
+            if (!string.IsNullOrEmpty(directory))
+                Directory.CreateDirectory(directory);
+
+            var tempPath = path + ".tmp";
+            File.WriteAllText(tempPath, JsonSerializer.Serialize(snapshot));
+            File.Move(tempPath, path, overwrite: true);
+        }
+
+        private void Load(string path)
+        {
+            if (!File.Exists(path))
+                return;
+
+            List<PersistedEntry>? snapshot;
+            try
+            {
+                snapshot = JsonSerializer.Deserialize<List<PersistedEntry>>(File.ReadAllText(path));
+            }
+            catch (JsonException)
+            {
+                // ملف تالف: نبدأ بكاش فارغ ويُستبدل عند الحفظ التالي
+                return;
+            }
+
+            if (snapshot == null)
+                return;
+
+            foreach (var item in snapshot.OrderBy(e => e.CreatedUtc))
+            {
+                if (item.Key == null || item.Value == null)
+                    continue;
+
+                var entry = new Entry(item.Key, item.Value, item.CreatedUtc, _sizeOf?.Invoke(item.Value) ?? 0);
+                if (IsExpired(entry))
+                    continue;
+
+                var segment = SegmentFor(item.Key);
+                lock (segment)
+                {
+                    if (segment.Map.TryGetValue(item.Key, out var existing))
+                        segment.Remove(existing);
+                    segment.Add(entry);
+                    EvictIfNeeded(segment);
+                }
+            }
+        }
+
+        private void EvictIfNeeded(Segment segment)
+        {
+            while (segment.Map.Count > 1 &&
+                   (segment.Map.Count > _segmentMaxEntries ||
+                    (_segmentMaxBytes > 0 && segment.Bytes > _segmentMaxBytes)))
+            {
+                var victim = segment.Order.First!;
+                if (IsExpired(victim.Value))
+                    Interlocked.Increment(ref _expirations);
+                else
+                    Interlocked.Increment(ref _evictions);
+                segment.Remove(victim);
+            }
+        }
+
+        private bool IsExpired(Entry entry) =>
+            _options.Ttl is { } ttl && _clock() - entry.CreatedUtc > ttl;
+
+        private Segment SegmentFor(TKey key) =>
+            _segments[(_comparer.GetHashCode(key) & 0x7FFFFFFF) & _segmentMask];
+
+        private sealed class Entry
+        {
+            public Entry(TKey key, TValue value, DateTime createdUtc, long size)
+            {
+                Key = key;
+                Value = value;
+                CreatedUtc = createdUtc;
+                Size = size;
+            }
+
+            public TKey Key { get; }
+            public TValue Value { get; }
+            public DateTime CreatedUtc { get; }
+            public long Size { get; }
+        }
+
+        /// <summary>
+        /// قسم مستقل: قاموس للبحث وقائمة مرتبة للإخلاء (الأول = الضحية التالية)
+        /// </summary>
+        private sealed class Segment
+        {
+            public Segment(IEqualityComparer<TKey> comparer)
+            {
+                Map = new Dictionary<TKey, LinkedListNode<Entry>>(comparer);
+            }
+
+            public Dictionary<TKey, LinkedListNode<Entry>> Map { get; }
+            public LinkedList<Entry> Order { get; } = new();
+            public long Bytes { get; set; }
+
+            public void Add(Entry entry)
+            {
+                Map[entry.Key] = Order.AddLast(entry);
+                Bytes += entry.Size;
+            }
+
+            public void Remove(LinkedListNode<Entry> node)
+            {
+                Order.Remove(node);
+                Map.Remove(node.Value.Key);
+                Bytes -= node.Value.Size;
+            }
+        }
+
+        private sealed class PersistedEntry
+        {
+            public TKey? Key { get; set; }
+            public TValue? Value { get; set; }
+            public DateTime CreatedUtc { get; set; }
+        }
+    }
+}
@@ -63,6 +63,21 @@ namespace ShieldAI.Core.Configuration
         /// المجلدات المستبعدة من الفحص
         /// </summary>
         public List<string> ExcludedFolders { get; set; } = new();
+
+        /// <summary>
+        /// مسارات موثوقة إضافية (جذور مطلقة) تُضاف لمجلدات النظام
+        /// </summary>
+        public List<string> TrustedPaths { get; set; } = new();
+
+        /// <summary>
+        /// مجلدات تنزيلات إضافية (جذر مطلق أو مقاطع) - مقطع downloads مشمول دائماً
+        /// </summary>
+        public List<string> DownloadFolders { get; set; } = new();
+
+        /// <summary>
+        /// الفاصل الزمني لنشر تقدم الفحص (ميلي ثانية)
+        /// </summary>
+        public int ScanProgressIntervalMs { get; set; } = 100;
         #endregion
 
         #region ML Settings
@@ -109,6 +124,16 @@ namespace ShieldAI.Core.Configuration
         /// تفعيل رفع الملفات إلى VirusTotal
         /// </summary>
         public bool AllowVirusTotalUpload { get; set; } = false;
+
+        /// <summary>
+        /// حصة طلبات VirusTotal في الدقيقة (الخطة المجانية: 4)
+        /// </summary>
+        public int VirusTotalRequestsPerMinute { get; set; } = 4;
+
+        /// <summary>
+        /// الحصة اليومية لطلبات VirusTotal (0 = بلا حد)
+        /// </summary>
+        public int VirusTotalDailyQuota { get; set; } = 500;
         #endregion
 
         #region AI Scan Settings
@@ -197,9 +222,140 @@ namespace ShieldAI.Core.Configuration
         public int PipelineQueueCapacity { get; set; } = 10_000;
 
         /// <summary>
-        /// حد الضغط العالي لتعطيل المحركات الثقيلة مؤقتاً
+        /// سعة مسار التنفيذيات والسكربتات والتنزيلات (0 = ربع السعة الإجمالية)
+        /// </summary>
+        public int PipelineHighLaneCapacity { get; set; } = 0;
+
+        /// <summary>
+        /// سعة مسار المستندات والأرشيفات (0 = ربع السعة الإجمالية)
+        /// </summary>
+        public int PipelineNormalLaneCapacity { get; set; } = 0;
+
+        /// <summary>
+        /// سعة مسار باقي الملفات (0 = نصف السعة الإجمالية)
+        /// </summary>
+        public int PipelineLowLaneCapacity { get; set; } = 0;
+
+        /// <summary>
+        /// أولوية صارمة بين المسارات بدل التوزيع بالأوزان
+        /// </summary>
+        public bool PipelineStrictPriority { get; set; } = false;
+
+        /// <summary>
+        /// أقصى انتظار للكاتب عند امتلاء المسار العالي قبل تحويل الحدث لاستعادة المجلد (ms)
+        /// </summary>
+        public int PipelineHighLaneBackpressureMs { get; set; } = 250;
+
+        /// <summary>
+        /// حد الضغط العالي لتعطيل المحركات الثقيلة مؤقتاً (مستوى High - الأقل منه ومن DegradedModeThreshold)
         /// </summary>
         public int PipelineHighPressureThreshold { get; set; } = 2_000;
+
+        /// <summary>
+        /// أقصى عدد محاولات لملف مقفل أو فارغ قبل إسقاطه من التجميع
+        /// </summary>
+        public int CoalescerMaxRetries { get; set; } = 8;
+
+        /// <summary>
+        /// أقصى تأخير بين محاولات جاهزية الملف (مللي ثانية)
+        /// </summary>
+        public int CoalescerMaxRetryDelayMs { get; set; } = 30_000;
+        #endregion
+
+        #region Realtime Event Source
+        /// <summary>
+        /// مصدر أحداث الملفات: Auto = fanotify ثم inotify على Linux، و FileSystemWatcher على غيره
+        /// </summary>
+        public RealtimeEventSourceKind RealtimeEventSource { get; set; } = RealtimeEventSourceKind.Auto;
+
+        /// <summary>
+        /// حجم المخزن الداخلي لـ FileSystemWatcher بالكيلوبايت (الحد الأقصى 64)
+        /// </summary>
+        public int WatcherBufferSizeKB { get; set; } = 64;
+
+        /// <summary>
+        /// الحد الأدنى المطلوب لـ fs.inotify.max_queued_events (0 = عدم التعديل)
+        /// </summary>
+        public int InotifyMaxQueuedEvents { get; set; } = 65_536;
+
+        /// <summary>
+        /// الحد الأدنى المطلوب لـ fs.inotify.max_user_watches (0 = عدم التعديل)
+        /// </summary>
+        public int InotifyMaxUserWatches { get; set; } = 524_288;
+
+        /// <summary>
+        /// استعادة الأحداث المفقودة عند الفيضان بمقارنة لقطة المجلدات
+        /// </summary>
+        public bool EnableOverflowRecovery { get; set; } = true;
+
+        /// <summary>
+        /// أقصى عدد ملفات في لقطة الاستعادة (بعده تُقارن المجلدات بوقت التعديل فقط)
+        /// </summary>
+        public int OverflowSnapshotMaxFiles { get; set; } = 1_000_000;
+
+        /// <summary>
+        /// انتظار بعد الفيضان قبل المقارنة حتى تهدأ العاصفة (مللي ثانية)
+        /// </summary>
+        public int OverflowRecoveryDelayMs { get; set; } = 1_000;
+        #endregion
+
+        #region Scan Executor
+        /// <summary>
+        /// الحد الأقصى لأعمال الفحص المتزامنة في المنفذ المشترك (0 = تلقائي)
+        /// </summary>
+        public int ScanExecutorMaxConcurrency { get; set; } = 0;
+
+        /// <summary>
+        /// عدد الخانات المحجوزة للفحص الفوري فقط
+        /// </summary>
+        public int ScanExecutorReservedRealtimeSlots { get; set; } = 1;
+
+        /// <summary>
+        /// وزن الفحص الفوري في التوزيع
+        /// </summary>
+        public int ScanExecutorRealtimeWeight { get; set; } = 16;
+
+        /// <summary>
+        /// وزن الفحص اليدوي في التوزيع
+        /// </summary>
+        public int ScanExecutorOnDemandWeight { get; set; } = 4;
+
+        /// <summary>
+        /// وزن الفحص المجدول في التوزيع
+        /// </summary>
+        public int ScanExecutorScheduledWeight { get; set; } = 1;
+        #endregion
+
+        #region Scan Checkpoints
+        /// <summary>
+        /// تفعيل حفظ نقاط الاستئناف للفحوصات الطويلة
+        /// </summary>
+        public bool EnableScanCheckpoints { get; set; } = true;
+
+        /// <summary>
+        /// مسار مجلد نقاط الاستئناف
+        /// </summary>
+        public string ScanCheckpointPath { get; set; } = @"C:\ProgramData\ShieldAI\Checkpoints";
+
+        /// <summary>
+        /// الفاصل الزمني لحفظ نقطة الاستئناف (ثواني)
+        /// </summary>
+        public int ScanCheckpointIntervalSeconds { get; set; } = 30;
+
+        /// <summary>
+        /// الحد الأدنى لعدد الملفات لتفعيل نقاط الاستئناف (الفحص الكامل دائماً)
+        /// </summary>
+        public int ScanCheckpointMinFiles { get; set; } = 5_000;
+
+        /// <summary>
+        /// عمر نقطة الاستئناف الأقصى (أيام) - الأقدم تُحذف
+        /// </summary>
+        public int ScanCheckpointMaxAgeDays { get; set; } = 7;
+
+        /// <summary>
+        /// أقصى عدد نقاط استئناف محفوظة (الأحدث تبقى)
+        /// </summary>
+        public int ScanCheckpointMaxCount { get; set; } = 10;
         #endregion
 
         #region Scan Cache
@@ -217,6 +373,65 @@ namespace ShieldAI.Core.Configuration
         /// الحد الأقصى لعناصر كاش الفحص
         /// </summary>
         public int ScanCacheMaxEntries { get; set; } = 20_000;
+
+        /// <summary>
+        /// الحد الأقصى التقديري لذاكرة كاش الفحص بالميجابايت (0 = العدد فقط)
+        /// </summary>
+        public int ScanCacheMaxMegabytes { get; set; } = 64;
+        #endregion
+
+        #region Archive Scanning
+        /// <summary>
+        /// أقصى عمق للأرشيفات المتداخلة
+        /// </summary>
+        public int ArchiveMaxDepth { get; set; } = 3;
+
+        /// <summary>
+        /// أقصى نسبة ضغط مقبولة قبل اعتبار الأرشيف قنبلة ضغط
+        /// </summary>
+        public int ArchiveMaxCompressionRatio { get; set; } = 100;
+
+        /// <summary>
+        /// أقصى حجم إجمالي بعد فك الضغط لأرشيف واحد (ميجابايت)
+        /// </summary>
+        public int ArchiveMaxTotalMB { get; set; } = 512;
+
+        /// <summary>
+        /// أقصى حجم لعنصر واحد داخل الأرشيف (ميجابايت)
+        /// </summary>
+        public int ArchiveMaxEntryMB { get; set; } = 64;
+
+        /// <summary>
+        /// أقصى عدد عناصر يُفحص في أرشيف واحد
+        /// </summary>
+        public int ArchiveMaxEntries { get; set; } = 10_000;
+        #endregion
+
+        #region Sharded Scanning
+        /// <summary>
+        /// توزيع الفحص الكامل على عدة عمليات عامل
+        /// </summary>
+        public bool EnableShardedScans { get; set; } = false;
+
+        /// <summary>
+        /// عدد عمليات العمال (0 = تلقائي: ربع عدد المعالجات، 2 على الأقل)
+        /// </summary>
+        public int ShardWorkerCount { get; set; } = 0;
+
+        /// <summary>
+        /// عدد الأجزاء المستهدف لكل عامل (لموازنة الحمل)
+        /// </summary>
+        public int ShardsPerWorker { get; set; } = 4;
+
+        /// <summary>
+        /// أقصى عدد محاولات للجزء عند انهيار العامل
+        /// </summary>
+        public int ShardMaxAttempts { get; set; } = 3;
+
+        /// <summary>
+        /// فترة استعلام تقدم العمال (مللي ثانية)
+        /// </summary>
+        public int ShardPollIntervalMs { get; set; } = 500;
         #endregion
 
         #region Quick Gate / Atomic Quarantine
@@ -239,6 +454,26 @@ namespace ShieldAI.Core.Configuration
         /// الحد الأقصى لتأخير إعادة المحاولة
         /// </summary>
         public int AtomicMoveMaxDelayMs { get; set; } = 800;
+
+        /// <summary>
+        /// سعة قائمة إجراءات الحجر (المنتجون ينتظرون عند الامتلاء)
+        /// </summary>
+        public int QuarantineQueueCapacity { get; set; } = 4096;
+
+        /// <summary>
+        /// أقصى عدد طلبات تُثبَّت في السجل بإلحاق واحد
+        /// </summary>
+        public int QuarantineBatchSize { get; set; } = 64;
+
+        /// <summary>
+        /// عدد عمليات تشفير الحجر المتوازية (0 = نصف الأنوية)
+        /// </summary>
+        public int QuarantineCryptoWorkers { get; set; } = 0;
+
+        /// <summary>
+        /// مستهلكو إجراءات التهديد المتوازيون في المراقبة الفورية (كل إجراء ينتظر دفعة الحجر)
+        /// </summary>
+        public int ThreatActionWorkers { get; set; } = 4;
         #endregion
 
         #region Second Opinion Policy
@@ -286,6 +521,31 @@ namespace ShieldAI.Core.Configuration
         /// تشغيل Defender إذا الملف من Temp/AppData
         /// </summary>
         public bool DefenderWhenTempOrAppData { get; set; } = true;
+
+        /// <summary>
+        /// تفعيل ClamAV (clamd) كرأي ثانٍ - يخضع لنفس قواعد Defender
+        /// </summary>
+        public bool EnableClamdSecondOpinion { get; set; } = false;
+
+        /// <summary>
+        /// عنوان clamd: tcp://host:port أو unix:/path/to/clamd.sock
+        /// </summary>
+        public string ClamdEndpoint { get; set; } = "tcp://127.0.0.1:3310";
+
+        /// <summary>
+        /// أقصى عدد اتصالات دائمة بـ clamd
+        /// </summary>
+        public int ClamdMaxConnections { get; set; } = 4;
+
+        /// <summary>
+        /// أقصى حجم ملف يُرسل إلى clamd بالميجابايت (StreamMaxLength)
+        /// </summary>
+        public int ClamdMaxStreamMegabytes { get; set; } = 25;
+
+        /// <summary>
+        /// أقصى عدد ملفات في دفعة الماسح الخارجي
+        /// </summary>
+        public int ExternalScannerBatchSize { get; set; } = 32;
         #endregion
 
         #region RealTime Action Policy
@@ -312,14 +572,79 @@ namespace ShieldAI.Core.Configuration
 
         #region Degraded Mode
         /// <summary>
-        /// حد الضغط لتفعيل الوضع المخفف
+        /// حد الضغط لمستوى High (تخطي المحركات الثقيلة)
         /// </summary>
         public int DegradedModeThreshold { get; set; } = 2_000;
 
         /// <summary>
-        /// حد التعافي لإلغاء الوضع المخفف
+        /// حد التعافي من مستوى High - نسبته إلى DegradedModeThreshold تُطبَّق على كل المستويات
         /// </summary>
         public int DegradedRecoveryThreshold { get; set; } = 800;
+
+        /// <summary>
+        /// عمق الطابور لمستوى Elevated (توسيع نافذة التجميع)
+        /// </summary>
+        public int LoadShedElevatedDepth { get; set; } = 500;
+
+        /// <summary>
+        /// عمق الطابور لمستوى Critical (تأجيل غير التنفيذيات)
+        /// </summary>
+        public int LoadShedCriticalDepth { get; set; } = 6_000;
+
+        /// <summary>
+        /// زمن انتظار الأحداث في القائمة لكل مستوى (مللي ثانية)
+        /// </summary>
+        public int LoadShedElevatedLatencyMs { get; set; } = 2_000;
+        public int LoadShedHighLatencyMs { get; set; } = 5_000;
+        public int LoadShedCriticalLatencyMs { get; set; } = 15_000;
+
+        /// <summary>
+        /// مدة الهدوء المطلوبة قبل النزول مستوى واحد (مللي ثانية)
+        /// </summary>
+        public int LoadShedRecoveryHoldMs { get; set; } = 10_000;
+
+        /// <summary>
+        /// سعة طابور الأحداث المؤجلة
+        /// </summary>
+        public int LoadShedBacklogCapacity { get; set; } = 50_000;
+
+        /// <summary>
+        /// عدد الأحداث المؤجلة المعادة للقائمة في كل تقييم بعد التعافي
+        /// </summary>
+        public int LoadShedDrainBatch { get; set; } = 500;
+        #endregion
+
+        #region Prevalence Tracking
+        /// <summary>
+        /// طريقة تتبع الانتشار المحلي: عدّاد دقيق لكل بصمة أو تقدير بذاكرة ثابتة
+        /// </summary>
+        public PrevalenceTrackingMode PrevalenceMode { get; set; } = PrevalenceTrackingMode.Exact;
+
+        /// <summary>
+        /// عرض count-min sketch (عدد الخلايا في كل صف) - الخطأ يقارب e × أحداث النافذة / العرض،
+        /// والعدّ تحت هذا الحد يُعامل كغير مرئي (نافذة مزدحمة تفقد دقة العدّ الصغير لا أكثر)
+        /// </summary>
+        public int PrevalenceSketchWidth { get; set; } = 1 << 19;
+
+        /// <summary>
+        /// عدد صفوف count-min sketch
+        /// </summary>
+        public int PrevalenceSketchDepth { get; set; } = 4;
+
+        /// <summary>
+        /// طول النافذة الزمنية للتقدير (ساعات)
+        /// </summary>
+        public int PrevalenceWindowHours { get; set; } = 48;
+
+        /// <summary>
+        /// عدد النوافذ المحتفظ بها (الأقدم يُمسح عند الدوران)
+        /// </summary>
+        public int PrevalenceWindowCount { get; set; } = 4;
+
+        /// <summary>
+        /// وزن كل نافذة أقدم بالنسبة للتي تليها (1.0 = بلا تلاشٍ)
+        /// </summary>
+        public double PrevalenceDecayFactor { get; set; } = 0.5;
         #endregion
 
         #region Logging
@@ -352,4 +677,24 @@ namespace ShieldAI.Core.Configuration
         Error = 4,
         Critical = 5
     }
+
+    /// <summary>
+    /// مصدر أحداث الحماية الفورية
+    /// </summary>
+    public enum RealtimeEventSourceKind
+    {
+        Auto = 0,
+        FileSystemWatcher = 1,
+        Fanotify = 2,
+        Inotify = 3
+    }
+
+    /// <summary>
+    /// طريقة تتبع الانتشار المحلي
+    /// </summary>
+    public enum PrevalenceTrackingMode
+    {
+        Exact = 0,          // سجل دقيق لكل بصمة (LocalPrevalenceStore)
+        Approximate = 1     // count-min sketch + HyperLogLog بذاكرة ثابتة (PrevalenceSketch)
+    }
 }
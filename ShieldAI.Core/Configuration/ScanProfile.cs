@@ -5,6 +5,7 @@
 // =====================================================
 
 using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
 
 namespace ShieldAI.Core.Configuration
 {
@@ -73,6 +74,39 @@ namespace ShieldAI.Core.Configuration
         /// </summary>
         public int Priority { get; set; } = 5;
 
+        #region Throttling
+        /// <summary>
+        /// الحد الأقصى للقراءة بالبايت في الثانية (0 = بلا حد)
+        /// </summary>
+        public long MaxBytesPerSecond { get; set; } = 0;
+
+        /// <summary>
+        /// الحد الأقصى للملفات في الثانية (0 = بلا حد)
+        /// </summary>
+        public int MaxFilesPerSecond { get; set; } = 0;
+
+        /// <summary>
+        /// نسبة وقت المعالج المسموحة لكل عامل (1-100)
+        /// </summary>
+        public int CpuDutyCyclePercent { get; set; } = 100;
+
+        /// <summary>
+        /// رفع الحدود تلقائياً عندما يكون النظام خاملاً
+        /// </summary>
+        public bool IdleAware { get; set; } = false;
+
+        /// <summary>
+        /// خيارات التقييد المشتقة من ملف التعريف
+        /// </summary>
+        public ScanThrottleOptions GetThrottleOptions() => new()
+        {
+            MaxBytesPerSecond = MaxBytesPerSecond,
+            MaxFilesPerSecond = MaxFilesPerSecond,
+            CpuDutyCyclePercent = CpuDutyCyclePercent,
+            IdleAware = IdleAware
+        };
+        #endregion
+
         #region Static Profiles
         /// <summary>
         /// ملف تعريف الفحص السريع
@@ -113,7 +147,10 @@ namespace ShieldAI.Core.Configuration
             ScanSystemFiles = true,
             DeepScan = true,
             MaxDepth = -1, // unlimited
-            Priority = 3
+            Priority = 3,
+            MaxBytesPerSecond = 64L * 1024 * 1024,
+            CpuDutyCyclePercent = 50,
+            IdleAware = true
         };
 
         /// <summary>
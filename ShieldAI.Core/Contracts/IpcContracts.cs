@@ -119,6 +119,12 @@ namespace ShieldAI.Core.Contracts
         public const string StopScan = "stop_scan";
         public const string GetScanProgress = "get_scan_progress";
         public const string GetScanReport = "get_scan_report";
+        public const string ResumeScan = "resume_scan";
+        public const string GetResumableScans = "get_resumable_scans";
+
+        // أجزاء الفحص الموزّع (منسق ← عامل)
+        public const string ScanShard = "scan_shard";
+        public const string GetShardProgress = "get_shard_progress";
 
         // الحماية الفورية
         public const string EnableRealTime = "enable_realtime";
@@ -130,6 +136,9 @@ namespace ShieldAI.Core.Contracts
         public const string RestoreFromQuarantine = "restore_quarantine";
         public const string DeleteFromQuarantine = "delete_quarantine";
         public const string ClearQuarantine = "clear_quarantine";
+        public const string BulkQuarantine = "bulk_quarantine";
+        public const string BulkRestoreQuarantine = "bulk_restore_quarantine";
+        public const string BulkDeleteQuarantine = "bulk_delete_quarantine";
 
         // الإعدادات
         public const string UpdateSettings = "update_settings";
@@ -178,6 +187,70 @@ namespace ShieldAI.Core.Contracts
         public string? CurrentFile { get; set; }
     }
 
+    public class ResumeScanRequest
+    {
+        public Guid JobId { get; set; }
+    }
+
+    public class ResumableScanDto
+    {
+        public Guid JobId { get; set; }
+        public ScanType ScanType { get; set; }
+        public List<string> Paths { get; set; } = new();
+        public int TotalFiles { get; set; }
+        public int ScannedFiles { get; set; }
+        public int ThreatsFound { get; set; }
+        public double ProgressPercent { get; set; }
+        public DateTime StartedAt { get; set; }
+        public DateTime UpdatedAt { get; set; }
+    }
+
+    public class ResumableScansResponse
+    {
+        public List<ResumableScanDto> Scans { get; set; } = new();
+    }
+
+    #endregion
+
+    #region Shard Commands
+
+    /// <summary>
+    /// جزء من فحص موزّع: شجرة مجلد واحدة بعمق محدد
+    /// </summary>
+    public class ScanShardRequest
+    {
+        public int ShardId { get; set; }
+        public Guid JobId { get; set; }
+        public string Path { get; set; } = "";
+        public int MaxDepth { get; set; } = -1;
+        public ScanType ScanType { get; set; } = ScanType.Custom;
+        public bool UseVirusTotal { get; set; }
+        public bool DeepScan { get; set; } = true;
+        public bool ScanArchives { get; set; }
+        public bool ScanHiddenFiles { get; set; } = true;
+        public int Priority { get; set; }
+    }
+
+    public class ShardProgressResponse
+    {
+        public int ShardId { get; set; }
+        public ScanStatus Status { get; set; }
+        public int TotalFiles { get; set; }
+        public int ScannedFiles { get; set; }
+        public int ThreatsFound { get; set; }
+        public int ErrorCount { get; set; }
+
+        /// <summary>
+        /// التهديدات المكتشفة منذ آخر استعلام
+        /// </summary>
+        public List<ScanResult> NewThreats { get; set; } = new();
+
+        /// <summary>
+        /// انتهى الجزء ولم يبقَ تهديدات لم تُرسل
+        /// </summary>
+        public bool IsFinal { get; set; }
+    }
+
     #endregion
 
     #region Quarantine Commands
@@ -204,6 +277,32 @@ namespace ShieldAI.Core.Contracts
         public string? RestorePath { get; set; } // للاستعادة فقط
     }
 
+    public class BulkQuarantineRequest
+    {
+        public List<string> Paths { get; set; } = new();
+    }
+
+    public class BulkQuarantineActionRequest
+    {
+        public List<string> ItemIds { get; set; } = new();
+        public string? RestoreDirectory { get; set; } // للاستعادة فقط - الافتراضي: المسار الأصلي
+    }
+
+    public class QuarantineItemOutcomeDto
+    {
+        public string Target { get; set; } = "";
+        public bool Success { get; set; }
+        public string? ItemId { get; set; }
+        public string? Error { get; set; }
+    }
+
+    public class BulkQuarantineResponse
+    {
+        public List<QuarantineItemOutcomeDto> Outcomes { get; set; } = new();
+        public int Succeeded { get; set; }
+        public int Failed { get; set; }
+    }
+
     #endregion
 
     #region Service Status
@@ -219,6 +318,47 @@ namespace ShieldAI.Core.Contracts
         public string Version { get; set; } = "1.0.0";
     }
 
+    public class RealTimeStatusResponse
+    {
+        public bool Enabled { get; set; }
+        public bool DegradedMode { get; set; }
+        public string? EventSource { get; set; }
+        public int PendingEvents { get; set; }
+        public int CoalescerPending { get; set; }
+        public int CoalescerRetryPending { get; set; }
+        public long CoalescerDropped { get; set; }
+        public long OverflowRecoveries { get; set; }
+        public long OverflowRecoveredFiles { get; set; }
+        public string LoadTier { get; set; } = "Normal";
+        public double QueueLatencyMs { get; set; }
+        public int DeferredPending { get; set; }
+        public long DeferredTotal { get; set; }
+        public long DeferredDrained { get; set; }
+        public long DeferredOverflow { get; set; }
+        public List<EventLaneStatusDto> Lanes { get; set; } = new();
+        public List<LoadTierTransitionDto> LoadTierTransitions { get; set; } = new();
+    }
+
+    public class LoadTierTransitionDto
+    {
+        public string From { get; set; } = "";
+        public string To { get; set; } = "";
+        public DateTime TimestampUtc { get; set; }
+        public int PendingEvents { get; set; }
+        public double QueueLatencyMs { get; set; }
+    }
+
+    public class EventLaneStatusDto
+    {
+        public string Lane { get; set; } = "";
+        public int Pending { get; set; }
+        public int Capacity { get; set; }
+        public long Enqueued { get; set; }
+        public long Dequeued { get; set; }
+        public long Dropped { get; set; }
+        public long Rejected { get; set; }
+    }
+
     #endregion
 
     #region Events (Service → UI)
@@ -232,6 +372,7 @@ namespace ShieldAI.Core.Contracts
         public const string LogEntry = "event_log_entry";
         public const string ThreatActionRequired = "event_threat_action_required";
         public const string ThreatActionApplied = "event_threat_action_applied";
+        public const string LoadTierChanged = "event_load_tier_changed";
     }
 
     public class EventEnvelope
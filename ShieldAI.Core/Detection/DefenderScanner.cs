@@ -16,6 +16,7 @@ namespace ShieldAI.Core.Detection
     public class DefenderScanner
     {
         private readonly int _timeoutSeconds;
+        private readonly bool _disableRemediation;
         private string? _mpCmdRunPath;
 
         /// <summary>
@@ -23,9 +24,12 @@ namespace ShieldAI.Core.Detection
         /// </summary>
         public bool IsAvailable => FindMpCmdRunPath() != null;
 
-        public DefenderScanner(int timeoutSeconds = 60)
+        /// <param name="timeoutSeconds">مهلة الفحص</param>
+        /// <param name="disableRemediation">الاكتفاء بالكشف دون أن يحذف Defender الملف (للرأي الثاني)</param>
+        public DefenderScanner(int timeoutSeconds = 60, bool disableRemediation = false)
         {
             _timeoutSeconds = timeoutSeconds;
+            _disableRemediation = disableRemediation;
         }
 
         /// <summary>
@@ -118,7 +122,7 @@ namespace ShieldAI.Core.Detection
                 var startInfo = new ProcessStartInfo
                 {
                     FileName = mpCmdRunPath,
-                    Arguments = $"-Scan -ScanType 3 -File \"{filePath}\"",
+                    Arguments = $"-Scan -ScanType 3 -File \"{filePath}\"" + (_disableRemediation ? " -DisableRemediation" : ""),
                     RedirectStandardOutput = true,
                     RedirectStandardError = true,
                     UseShellExecute = false,
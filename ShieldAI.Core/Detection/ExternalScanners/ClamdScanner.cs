@@ -0,0 +1,550 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/ExternalScanners/ClamdScanner.cs
+// عميل clamd دائم: جلسات IDSESSION مجمّعة + INSTREAM لعدة ملفات
+// =====================================================
+
+using System.Buffers;
+using System.Buffers.Binary;
+using System.Collections.Concurrent;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Logging;
+
+namespace ShieldAI.Core.Detection.ExternalScanners
+{
+    /// <summary>
+    /// خيارات الاتصال بـ clamd
+    /// </summary>
+    public class ClamdScannerOptions
+    {
+        /// <summary>
+        /// نقطة الاتصال: tcp://host:port أو unix:/path/to/clamd.sock
+        /// </summary>
+        public string Endpoint { get; set; } = "tcp://127.0.0.1:3310";
+
+        /// <summary>
+        /// أقصى عدد اتصالات مفتوحة (= أقصى دفعات متزامنة)
+        /// </summary>
+        public int MaxConnections { get; set; } = 4;
+
+        /// <summary>
+        /// أقصى عدد ملفات في الدفعة
+        /// </summary>
+        public int MaxBatchSize { get; set; } = 32;
+
+        /// <summary>
+        /// أقصى حجم يُرسل (يطابق StreamMaxLength في clamd.conf)
+        /// </summary>
+        public long MaxStreamBytes { get; set; } = 25L * 1024 * 1024;
+
+        /// <summary>
+        /// حجم قطعة INSTREAM
+        /// </summary>
+        public int ChunkSize { get; set; } = 64 * 1024;
+
+        /// <summary>
+        /// مهلة الدفعة الكاملة
+        /// </summary>
+        public TimeSpan Timeout { get; set; } = TimeSpan.FromSeconds(30);
+
+        /// <summary>
+        /// إغلاق الجلسة الخاملة قبل أن يغلقها clamd (IdleTimeout الافتراضي 30 ثانية)
+        /// </summary>
+        public TimeSpan SessionIdleTimeout { get; set; } = TimeSpan.FromSeconds(20);
+
+        /// <summary>
+        /// الفاصل بين فحوص الجاهزية (PING)
+        /// </summary>
+        public TimeSpan HealthCheckInterval { get; set; } = TimeSpan.FromSeconds(30);
+
+        public static ClamdScannerOptions FromSettings(AppSettings settings) => new()
+        {
+            Endpoint = settings.ClamdEndpoint,
+            MaxConnections = Math.Max(1, settings.ClamdMaxConnections),
+            MaxBatchSize = Math.Max(1, settings.ExternalScannerBatchSize),
+            MaxStreamBytes = Math.Max(1, settings.ClamdMaxStreamMegabytes) * 1024L * 1024
+        };
+    }
+
+    /// <summary>
+    /// ماسح clamd - اتصالات دائمة بدلاً من عملية لكل ملف
+    /// </summary>
+    public sealed class ClamdScanner : IExternalScanner, IDisposable
+    {
+        private static readonly byte[] IdSessionCommand = Encoding.ASCII.GetBytes("zIDSESSION\0");
+        private static readonly byte[] InStreamCommand = Encoding.ASCII.GetBytes("zINSTREAM\0");
+        private static readonly byte[] PingCommand = Encoding.ASCII.GetBytes("zPING\0");
+        private static readonly byte[] EndCommand = Encoding.ASCII.GetBytes("zEND\0");
+
+        private readonly ClamdScannerOptions _options;
+        private readonly ILogger? _logger;
+        private readonly EndPoint _endpoint;
+        private readonly SemaphoreSlim _connectionSlots;
+        private readonly ConcurrentBag<ClamdSession> _idleSessions = new();
+
+        private volatile bool _available;
+        private long _nextHealthCheckTicks;
+        private int _healthCheckRunning;
+        private long _sessionsOpened;
+        private long _batchesSent;
+        private bool _disposed;
+
+        public ClamdScanner(ClamdScannerOptions? options = null, ILogger? logger = null)
+        {
+            _options = options ?? ClamdScannerOptions.FromSettings(ConfigManager.Instance.Settings);
+            _logger = logger;
+            _endpoint = ParseEndpoint(_options.Endpoint);
+            _connectionSlots = new SemaphoreSlim(Math.Max(1, _options.MaxConnections));
+        }
+
+        public string Name => "ClamAV";
+        public int MaxBatchSize => Math.Max(1, _options.MaxBatchSize);
+        public int MaxConcurrentBatches => Math.Max(1, _options.MaxConnections);
+
+        /// <summary>
+        /// عدد الجلسات المفتوحة منذ البدء (تشخيص إعادة استخدام الاتصالات)
+        /// </summary>
+        public long SessionsOpened => Interlocked.Read(ref _sessionsOpened);
+
+        /// <summary>
+        /// عدد الدفعات المرسلة
+        /// </summary>
+        public long BatchesSent => Interlocked.Read(ref _batchesSent);
+
+        /// <summary>
+        /// آخر حالة معروفة - التحديث يجري في الخلفية دون حجب الفحص
+        /// </summary>
+        public bool IsAvailable
+        {
+            get
+            {
+                if (Environment.TickCount64 >= Interlocked.Read(ref _nextHealthCheckTicks) &&
+                    Interlocked.CompareExchange(ref _healthCheckRunning, 1, 0) == 0)
+                {
+                    _ = Task.Run(async () =>
+                    {
+                        try
+                        {
+                            await PingAsync().ConfigureAwait(false);
+                        }
+                        finally
+                        {
+                            Volatile.Write(ref _healthCheckRunning, 0);
+                        }
+                    });
+                }
+
+                return _available;
+            }
+        }
+
+        /// <summary>
+        /// فحص جاهزية clamd عبر PING على اتصال مستقل
+        /// </summary>
+        public async Task<bool> PingAsync(CancellationToken ct = default)
+        {
+            try
+            {
+                using var timeout = CancellationTokenSource.CreateLinkedTokenSource(ct);
+                timeout.CancelAfter(_options.Timeout);
+
+                using var session = await ClamdSession.ConnectAsync(_endpoint, timeout.Token).ConfigureAwait(false);
+                await session.WriteAsync(PingCommand, timeout.Token).ConfigureAwait(false);
+                var reply = await session.ReadReplyAsync(timeout.Token).ConfigureAwait(false);
+                _available = reply == "PONG";
+            }
+            catch (Exception ex) when (!ct.IsCancellationRequested)
+            {
+                _logger?.Debug("clamd غير متاح على {0}: {1}", _options.Endpoint, ex.Message);
+                _available = false;
+            }
+
+            Interlocked.Exchange(ref _nextHealthCheckTicks,
+                Environment.TickCount64 + (long)_options.HealthCheckInterval.TotalMilliseconds);
+            return _available;
+        }
+
+        public async Task<IReadOnlyList<ExternalScanVerdict>> ScanBatchAsync(
+            IReadOnlyList<ExternalScanItem> items,
+            CancellationToken ct = default)
+        {
+            ObjectDisposedException.ThrowIf(_disposed, this);
+
+            var verdicts = new ExternalScanVerdict?[items.Count];
+            var pending = new List<int>(items.Count);
+
+            for (int i = 0; i < items.Count; i++)
+            {
+                var verdict = Precheck(items[i]);
+                if (verdict != null)
+                    verdicts[i] = verdict;
+                else
+                    pending.Add(i);
+            }
+
+            if (pending.Count > 0)
+                await SendAsync(items, pending, verdicts, ct).ConfigureAwait(false);
+
+            return verdicts.Select(v => v ?? ExternalScanVerdict.Failed("لا رد من clamd")).ToArray();
+        }
+
+        private ExternalScanVerdict? Precheck(ExternalScanItem item)
+        {
+            long length;
+            if (item.Content != null)
+            {
+                length = item.Content.LongLength;
+            }
+            else
+            {
+                try
+                {
+                    var info = new FileInfo(item.FilePath);
+                    if (!info.Exists)
+                        return ExternalScanVerdict.Failed("الملف غير موجود");
+                    length = info.Length;
+                }
+                catch (Exception ex)
+                {
+                    return ExternalScanVerdict.Failed(ex.Message);
+                }
+            }
+
+            return length > _options.MaxStreamBytes
+                ? ExternalScanVerdict.Skipped($"الحجم يتجاوز حد clamd ({_options.MaxStreamBytes} بايت)")
+                : null;
+        }
+
+        private async Task SendAsync(
+            IReadOnlyList<ExternalScanItem> items,
+            List<int> pending,
+            ExternalScanVerdict?[] verdicts,
+            CancellationToken ct)
+        {
+            using var timeout = CancellationTokenSource.CreateLinkedTokenSource(ct);
+            timeout.CancelAfter(_options.Timeout);
+
+            await _connectionSlots.WaitAsync(ct).ConfigureAwait(false);
+            try
+            {
+                // محاولة ثانية فقط إذا كانت الجلسة المعاد استخدامها قد أُغلقت من clamd
+                for (int attempt = 0; ; attempt++)
+                {
+                    var session = RentIdleSession();
+                    var reused = session != null;
+
+                    try
+                    {
+                        session ??= await OpenSessionAsync(timeout.Token).ConfigureAwait(false);
+                        Interlocked.Increment(ref _batchesSent);
+
+                        var healthy = await RunBatchAsync(session, items, pending, verdicts, timeout.Token).ConfigureAwait(false);
+                        _available = true;
+
+                        if (healthy)
+                            ReturnSession(session);
+                        else
+                            session.Dispose();
+                        return;
+                    }
+                    catch (Exception ex) when (!ct.IsCancellationRequested)
+                    {
+                        session?.Dispose();
+                        pending.RemoveAll(i => verdicts[i] != null);
+
+                        if (reused && attempt == 0 && !timeout.IsCancellationRequested && pending.Count > 0)
+                            continue;
+
+                        if (!reused && ex is SocketException)
+                            _available = false;
+
+                        var error = timeout.IsCancellationRequested
+                            ? $"انتهت مهلة clamd ({_options.Timeout.TotalSeconds:F0} ثانية)"
+                            : $"خطأ اتصال clamd: {ex.Message}";
+                        _logger?.Warning("فشل فحص دفعة عبر clamd: {0}", error);
+
+                        foreach (var index in pending)
+                            verdicts[index] = ExternalScanVerdict.Failed(error);
+                        return;
+                    }
+                }
+            }
+            finally
+            {
+                _connectionSlots.Release();
+            }
+        }
+
+        /// <summary>
+        /// إرسال كل العناصر على الجلسة ثم قراءة الردود بالمعرّفات (clamd قد يرد بغير الترتيب)
+        /// </summary>
+        /// <returns>false إذا أبلغ clamd عن خطأ يجعل الجلسة غير صالحة لإعادة الاستخدام</returns>
+        private async Task<bool> RunBatchAsync(
+            ClamdSession session,
+            IReadOnlyList<ExternalScanItem> items,
+            List<int> pending,
+            ExternalScanVerdict?[] verdicts,
+            CancellationToken ct)
+        {
+            var byRequestId = new Dictionary<int, int>(pending.Count);
+            var buffer = ArrayPool<byte>.Shared.Rent(4 + _options.ChunkSize);
+            try
+            {
+                foreach (var index in pending)
+                {
+                    byRequestId[session.NextRequestId()] = index;
+                    await session.WriteAsync(InStreamCommand, ct).ConfigureAwait(false);
+                    await StreamItemAsync(session, items[index], buffer, ct).ConfigureAwait(false);
+                }
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(buffer);
+            }
+
+            var healthy = true;
+            while (byRequestId.Count > 0)
+            {
+                var reply = await session.ReadReplyAsync(ct).ConfigureAwait(false)
+                    ?? throw new IOException("أغلق clamd الاتصال قبل إرسال كل الردود");
+
+                var (requestId, verdict) = ParseSessionReply(reply);
+                if (!byRequestId.Remove(requestId, out var index))
+                    throw new InvalidDataException($"رد clamd بمعرّف غير متوقع: {reply}");
+
+                verdicts[index] = verdict;
+                if (verdict.Status == ExternalScanStatus.Failed)
+                    healthy = false;
+            }
+
+            return healthy;
+        }
+
+        private async Task StreamItemAsync(ClamdSession session, ExternalScanItem item, byte[] buffer, CancellationToken ct)
+        {
+            var chunkSize = _options.ChunkSize;
+            long remaining = _options.MaxStreamBytes;
+
+            if (item.Content != null)
+            {
+                for (int offset = 0; offset < item.Content.Length && remaining > 0;)
+                {
+                    var count = (int)Math.Min(Math.Min(chunkSize, item.Content.Length - offset), remaining);
+                    BinaryPrimitives.WriteInt32BigEndian(buffer, count);
+                    Buffer.BlockCopy(item.Content, offset, buffer, 4, count);
+                    await session.WriteAsync(buffer.AsMemory(0, 4 + count), ct).ConfigureAwait(false);
+                    offset += count;
+                    remaining -= count;
+                }
+            }
+            else
+            {
+                await using var stream = new FileStream(
+                    item.FilePath, FileMode.Open, FileAccess.Read,
+                    FileShare.ReadWrite | FileShare.Delete, chunkSize,
+                    FileOptions.Asynchronous | FileOptions.SequentialScan);
+
+                while (remaining > 0)
+                {
+                    var read = await stream.ReadAsync(buffer.AsMemory(4, (int)Math.Min(chunkSize, remaining)), ct).ConfigureAwait(false);
+                    if (read == 0)
+                        break;
+
+                    // ترويسة الطول وبيانات القطعة في كتابة واحدة
+                    BinaryPrimitives.WriteInt32BigEndian(buffer, read);
+                    await session.WriteAsync(buffer.AsMemory(0, 4 + read), ct).ConfigureAwait(false);
+                    remaining -= read;
+                }
+            }
+
+            BinaryPrimitives.WriteInt32BigEndian(buffer, 0);
+            await session.WriteAsync(buffer.AsMemory(0, 4), ct).ConfigureAwait(false);
+        }
+
+        /// <summary>
+        /// تحليل رد الجلسة: "3: stream: Eicar-Signature FOUND"
+        /// </summary>
+        public static (int RequestId, ExternalScanVerdict Verdict) ParseSessionReply(string reply)
+        {
+            var separator = reply.IndexOf(": ", StringComparison.Ordinal);
+            if (separator <= 0 || !int.TryParse(reply.AsSpan(0, separator), out var requestId))
+                throw new InvalidDataException($"رد clamd غير صالح: {reply}");
+
+            var body = reply[(separator + 2)..];
+            if (body.StartsWith("stream: ", StringComparison.Ordinal))
+                body = body["stream: ".Length..];
+
+            if (body.EndsWith(" FOUND", StringComparison.Ordinal))
+                return (requestId, ExternalScanVerdict.Infected(body[..^" FOUND".Length].Trim()));
+
+            if (body == "OK")
+                return (requestId, ExternalScanVerdict.Clean);
+
+            return (requestId, ExternalScanVerdict.Failed(body.EndsWith(" ERROR", StringComparison.Ordinal)
+                ? body[..^" ERROR".Length].Trim()
+                : body));
+        }
+
+        private ClamdSession? RentIdleSession()
+        {
+            while (_idleSessions.TryTake(out var session))
+            {
+                if (Environment.TickCount64 - session.LastUsedTicks < _options.SessionIdleTimeout.TotalMilliseconds)
+                    return session;
+
+                session.Close(EndCommand);
+            }
+
+            return null;
+        }
+
+        private void ReturnSession(ClamdSession session)
+        {
+            session.LastUsedTicks = Environment.TickCount64;
+            if (_disposed)
+                session.Close(EndCommand);
+            else
+                _idleSessions.Add(session);
+        }
+
+        private async Task<ClamdSession> OpenSessionAsync(CancellationToken ct)
+        {
+            var session = await ClamdSession.ConnectAsync(_endpoint, ct).ConfigureAwait(false);
+            try
+            {
+                await session.WriteAsync(IdSessionCommand, ct).ConfigureAwait(false);
+                Interlocked.Increment(ref _sessionsOpened);
+                return session;
+            }
+            catch
+            {
+                session.Dispose();
+                throw;
+            }
+        }
+
+        internal static EndPoint ParseEndpoint(string endpoint)
+        {
+            if (endpoint.StartsWith("unix:", StringComparison.OrdinalIgnoreCase))
+            {
+                var path = endpoint["unix:".Length..];
+                return new UnixDomainSocketEndPoint(path.StartsWith("//", StringComparison.Ordinal) ? path[2..] : path);
+            }
+
+            var address = endpoint.StartsWith("tcp://", StringComparison.OrdinalIgnoreCase)
+                ? endpoint["tcp://".Length..]
+                : endpoint;
+            address = address.TrimEnd('/');
+
+            var colon = address.LastIndexOf(':');
+            if (colon > 0 && int.TryParse(address.AsSpan(colon + 1), out var port))
+                return new DnsEndPoint(address[..colon].Trim('[', ']'), port);
+
+            return new DnsEndPoint(address, 3310);
+        }
+
+        public void Dispose()
+        {
+            if (_disposed)
+                return;
+            _disposed = true;
+
+            while (_idleSessions.TryTake(out var session))
+                session.Close(EndCommand);
+        }
+
+        /// <summary>
+        /// اتصال واحد بـ clamd مع مخزن لقراءة الردود المنتهية بـ \0
+        /// </summary>
+        private sealed class ClamdSession : IDisposable
+        {
+            private readonly Socket _socket;
+            private readonly NetworkStream _stream;
+            private readonly byte[] _readBuffer = new byte[4096];
+            private int _readStart;
+            private int _readEnd;
+            private int _lastRequestId;
+
+            public long LastUsedTicks { get; set; } = Environment.TickCount64;
+
+            private ClamdSession(Socket socket)
+            {
+                _socket = socket;
+                _stream = new NetworkStream(socket, ownsSocket: true);
+            }
+
+            public static async Task<ClamdSession> ConnectAsync(EndPoint endpoint, CancellationToken ct)
+            {
+                var socket = endpoint is UnixDomainSocketEndPoint
+                    ? new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified)
+                    : new Socket(SocketType.Stream, ProtocolType.Tcp) { NoDelay = true };
+
+                try
+                {
+                    await socket.ConnectAsync(endpoint, ct).ConfigureAwait(false);
+                    return new ClamdSession(socket);
+                }
+                catch
+                {
+                    socket.Dispose();
+                    throw;
+                }
+            }
+
+            /// <summary>
+            /// معرّفات clamd تبدأ من 1 لكل جلسة وتزيد مع كل أمر
+            /// </summary>
+            public int NextRequestId() => ++_lastRequestId;
+
+            public ValueTask WriteAsync(ReadOnlyMemory<byte> data, CancellationToken ct) =>
+                _stream.WriteAsync(data, ct);
+
+            /// <summary>
+            /// قراءة رد واحد حتى \0 (null = أُغلق الاتصال)
+            /// </summary>
+            public async Task<string?> ReadReplyAsync(CancellationToken ct)
+            {
+                while (true)
+                {
+                    var terminator = Array.IndexOf(_readBuffer, (byte)0, _readStart, _readEnd - _readStart);
+                    if (terminator >= 0)
+                    {
+                        var reply = Encoding.ASCII.GetString(_readBuffer, _readStart, terminator - _readStart);
+                        _readStart = terminator + 1;
+                        return reply;
+                    }
+
+                    if (_readStart > 0)
+                    {
+                        Buffer.BlockCopy(_readBuffer, _readStart, _readBuffer, 0, _readEnd - _readStart);
+                        _readEnd -= _readStart;
+                        _readStart = 0;
+                    }
+
+                    if (_readEnd == _readBuffer.Length)
+                        throw new InvalidDataException("رد clamd أطول من المتوقع");
+
+                    var read = await _stream.ReadAsync(_readBuffer.AsMemory(_readEnd), ct).ConfigureAwait(false);
+                    if (read == 0)
+                        return null;
+                    _readEnd += read;
+                }
+            }
+
+            public void Close(byte[] endCommand)
+            {
+                try { _stream.Write(endCommand); } catch { }
+                Dispose();
+            }
+
+            public void Dispose()
+            {
+                _stream.Dispose();
+                _socket.Dispose();
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/ExternalScanners/DefenderExternalScanner.cs
+// Windows Defender كماسح خارجي (MpCmdRun لكل ملف)
+// =====================================================
+
+using ShieldAI.Core.Configuration;
+
+namespace ShieldAI.Core.Detection.ExternalScanners
+{
+    /// <summary>
+    /// ماسح Defender - لا يملك بروتوكول دفعات، فتُفحص عناصر الدفعة بتوازٍ محدود
+    /// </summary>
+    public sealed class DefenderExternalScanner : IExternalScanner
+    {
+        private readonly DefenderScanner _scanner;
+        private readonly int _maxParallelism;
+
+        public DefenderExternalScanner(DefenderScanner? scanner = null, int maxParallelism = 2)
+        {
+            _scanner = scanner ?? new DefenderScanner(
+                ConfigManager.Instance.Settings.DefenderTimeoutSeconds,
+                disableRemediation: true);
+            _maxParallelism = Math.Max(1, maxParallelism);
+        }
+
+        public string Name => "Windows Defender";
+        public bool IsAvailable => OperatingSystem.IsWindows() && _scanner.IsAvailable;
+        public int MaxBatchSize => 8;
+        public int MaxConcurrentBatches => 1;
+
+        public async Task<IReadOnlyList<ExternalScanVerdict>> ScanBatchAsync(
+            IReadOnlyList<ExternalScanItem> items,
+            CancellationToken ct = default)
+        {
+            var verdicts = new ExternalScanVerdict[items.Count];
+
+            await Parallel.ForEachAsync(
+                Enumerable.Range(0, items.Count),
+                new ParallelOptions { MaxDegreeOfParallelism = _maxParallelism, CancellationToken = ct },
+                async (index, token) =>
+                {
+                    var item = items[index];
+
+                    // MpCmdRun يفحص ملفات على القرص فقط
+                    if (item.Content != null)
+                    {
+                        verdicts[index] = ExternalScanVerdict.Skipped("Defender لا يفحص المحتوى من الذاكرة");
+                        return;
+                    }
+
+                    var result = await _scanner.ScanFileAsync(item.FilePath, token).ConfigureAwait(false);
+                    verdicts[index] = !result.Success
+                        ? ExternalScanVerdict.Failed(result.ErrorMessage ?? "فشل فحص Defender")
+                        : result.IsThreat
+                            ? ExternalScanVerdict.Infected(result.ThreatName ?? "Defender-Detected")
+                            : ExternalScanVerdict.Clean;
+                }).ConfigureAwait(false);
+
+            return verdicts;
+        }
+    }
+}
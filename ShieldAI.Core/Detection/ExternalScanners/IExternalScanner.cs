@@ -0,0 +1,71 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/ExternalScanners/IExternalScanner.cs
+// واجهة الماسحات الخارجية (clamd، Defender) بفحص دفعات
+// =====================================================
+
+namespace ShieldAI.Core.Detection.ExternalScanners
+{
+    /// <summary>
+    /// ماسح خارجي يفحص دفعة ملفات بطلب واحد
+    /// </summary>
+    public interface IExternalScanner
+    {
+        /// <summary>
+        /// اسم الماسح للعرض
+        /// </summary>
+        string Name { get; }
+
+        /// <summary>
+        /// هل الماسح متاح (يجب أن يكون سريعاً - يُستدعى لكل ملف)
+        /// </summary>
+        bool IsAvailable { get; }
+
+        /// <summary>
+        /// أقصى عدد عناصر في الدفعة الواحدة
+        /// </summary>
+        int MaxBatchSize { get; }
+
+        /// <summary>
+        /// أقصى عدد دفعات متزامنة
+        /// </summary>
+        int MaxConcurrentBatches { get; }
+
+        /// <summary>
+        /// فحص دفعة - النتائج بنفس ترتيب العناصر
+        /// </summary>
+        Task<IReadOnlyList<ExternalScanVerdict>> ScanBatchAsync(
+            IReadOnlyList<ExternalScanItem> items,
+            CancellationToken ct = default);
+    }
+
+    /// <summary>
+    /// عنصر فحص: ملف على القرص أو محتوى في الذاكرة (عنصر أرشيف)
+    /// </summary>
+    public sealed record ExternalScanItem(string FilePath, byte[]? Content = null);
+
+    /// <summary>
+    /// حالة نتيجة الماسح الخارجي
+    /// </summary>
+    public enum ExternalScanStatus
+    {
+        Clean,
+        Infected,
+        Skipped,
+        Failed
+    }
+
+    /// <summary>
+    /// نتيجة فحص عنصر واحد
+    /// </summary>
+    public sealed record ExternalScanVerdict(ExternalScanStatus Status, string? ThreatName = null, string? Message = null)
+    {
+        public static readonly ExternalScanVerdict Clean = new(ExternalScanStatus.Clean);
+
+        public static ExternalScanVerdict Infected(string threatName) => new(ExternalScanStatus.Infected, threatName);
+
+        public static ExternalScanVerdict Skipped(string reason) => new(ExternalScanStatus.Skipped, Message: reason);
+
+        public static ExternalScanVerdict Failed(string error) => new(ExternalScanStatus.Failed, Message: error);
+    }
+}
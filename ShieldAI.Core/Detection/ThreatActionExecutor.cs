@@ -19,6 +19,7 @@ namespace ShieldAI.Core.Detection
     public class ThreatActionExecutor
     {
         private readonly QuarantineStore _quarantineStore;
+        private readonly QuarantineActionQueue? _actionQueue;
         private readonly AppSettings _settings;
         private readonly Microsoft.Extensions.Logging.ILogger? _logger;
         private readonly ConcurrentDictionary<string, ThreatEventDto> _pendingThreats = new();
@@ -36,9 +37,11 @@ namespace ShieldAI.Core.Detection
         public ThreatActionExecutor(
             QuarantineStore quarantineStore,
             AppSettings? settings = null,
-            Microsoft.Extensions.Logging.ILogger? logger = null)
+            Microsoft.Extensions.Logging.ILogger? logger = null,
+            QuarantineActionQueue? actionQueue = null)
         {
             _quarantineStore = quarantineStore;
+            _actionQueue = actionQueue;
             _settings = settings ?? ConfigManager.Instance.Settings;
             _logger = logger;
         }
@@ -191,6 +194,12 @@ namespace ShieldAI.Core.Detection
                 return;
             }
 
+            if (_actionQueue != null)
+            {
+                await ExecuteQueuedQuarantineAsync(dto, filePath);
+                return;
+            }
+
             try
             {
                 var (success, movedPath) = await _quarantineStore.TryAtomicMoveToQuarantineAsync(
@@ -223,6 +232,32 @@ namespace ShieldAI.Core.Detection
             }
         }
 
+        /// <summary>
+        /// الحجر عبر قائمة الإجراءات: النقل الذري والتشفير والتثبيت تتم ضمن دفعة
+        /// </summary>
+        private async Task ExecuteQueuedQuarantineAsync(ThreatEventDto dto, string filePath)
+        {
+            var outcome = await _actionQueue!.QuarantineAsync(new QuarantineRequest(filePath)
+            {
+                Verdict = string.IsNullOrWhiteSpace(dto.Verdict) ? null : dto.Verdict,
+                AtomicMove = true
+            });
+
+            dto.ActionTaken = outcome.Success;
+            if (outcome.Success)
+            {
+                dto.QuarantineId = outcome.Item?.Id;
+                dto.ActionResult = "Quarantined";
+                dto.RecommendedAction = "Quarantine";
+                _logger?.LogInformation("[ThreatAction] Quarantined {Path}", filePath);
+            }
+            else
+            {
+                dto.ActionResult = outcome.Error;
+                _logger?.LogWarning("[ThreatAction] Quarantine FAILED for {Path}: {Error}", filePath, outcome.Error);
+            }
+        }
+
         private async Task ExecuteDeleteAsync(ThreatEventDto dto, string filePath)
         {
             // أولاً: حاول الحذف من الحجر إذا كان محجوراً
@@ -31,11 +31,12 @@ namespace ShieldAI.Core.Detection.ThreatScoring
                 if (!ScriptExtensions.Contains(context.Extension))
                     return Task.FromResult(ThreatScanResult.Clean(EngineName));
 
-                if (!File.Exists(context.FilePath))
+                // عناصر الأرشيف تُفحص من الذاكرة مباشرة
+                if (context.Content == null && !File.Exists(context.FilePath))
                     return Task.FromResult(ThreatScanResult.Clean(EngineName));
 
-                var fileInfo = new FileInfo(context.FilePath);
-                if (fileInfo.Length > 5 * 1024 * 1024) // 5MB حد معقول للسكربت
+                var length = context.Content?.LongLength ?? new FileInfo(context.FilePath).Length;
+                if (length > 5 * 1024 * 1024) // 5MB حد معقول للسكربت
                 {
                     result.Score = 0;
                     result.Verdict = EngineVerdict.Clean;
@@ -43,8 +44,8 @@ namespace ShieldAI.Core.Detection.ThreatScoring
                     return Task.FromResult(result);
                 }
 
-                var content = File.ReadAllBytes(context.FilePath);
-                var amsiResult = AmsiScan(content, Path.GetFileName(context.FilePath));
+                var content = context.Content ?? File.ReadAllBytes(context.FilePath);
+                var amsiResult = AmsiScan(content, context.FileName);
 
                 if (amsiResult >= AmsiNative.AMSI_RESULT_DETECTED)
                 {
@@ -0,0 +1,25 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/ThreatScoring/ClamAvEngine.cs
+// محرك ClamAV كرأي ثانٍ عبر خادم clamd المحلي
+// =====================================================
+
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Detection.ExternalScanners;
+
+namespace ShieldAI.Core.Detection.ThreatScoring
+{
+    /// <summary>
+    /// محرك ClamAV - يفحص عبر اتصالات clamd دائمة بدلاً من تشغيل عملية لكل ملف
+    /// </summary>
+    public class ClamAvEngine : ExternalScannerEngine
+    {
+        public ClamAvEngine(ClamdScanner? scanner = null)
+            : base(scanner ?? new ClamdScanner(), "ClamAvEngine")
+        {
+        }
+
+        public override bool IsReady =>
+            ConfigManager.Instance.Settings.EnableClamdSecondOpinion && base.IsReady;
+    }
+}
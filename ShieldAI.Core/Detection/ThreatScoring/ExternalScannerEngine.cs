@@ -0,0 +1,186 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/ThreatScoring/ExternalScannerEngine.cs
+// محرك رأي ثانٍ عام فوق ماسح خارجي مع تجميع الطلبات في دفعات
+// =====================================================
+
+using System.Threading.Channels;
+using ShieldAI.Core.Detection.ExternalScanners;
+
+namespace ShieldAI.Core.Detection.ThreatScoring
+{
+    /// <summary>
+    /// محرك فوق ماسح خارجي: الطلبات المتزامنة تُجمع في دفعة واحدة
+    /// بينما الدفعات السابقة قيد التنفيذ (بدون انتظار مصطنع)
+    /// </summary>
+    public class ExternalScannerEngine : IThreatEngine, IDisposable
+    {
+        private readonly IExternalScanner _scanner;
+        private readonly Channel<PendingScan> _queue = Channel.CreateUnbounded<PendingScan>(
+            new UnboundedChannelOptions { SingleReader = true });
+        private readonly SemaphoreSlim _batchSlots;
+        private readonly CancellationTokenSource _shutdown = new();
+        private readonly Task _dispatcher;
+        private long _batchesDispatched;
+
+        public string EngineName { get; }
+        public double DefaultWeight { get; }
+
+        /// <summary>
+        /// الماسح الخارجي المستخدم
+        /// </summary>
+        public IExternalScanner Scanner => _scanner;
+
+        /// <summary>
+        /// عدد الدفعات المرسلة إلى الماسح
+        /// </summary>
+        public long BatchesDispatched => Interlocked.Read(ref _batchesDispatched);
+
+        public virtual bool IsReady => _scanner.IsAvailable;
+
+        public ExternalScannerEngine(IExternalScanner scanner, string engineName, double defaultWeight = 0.9)
+        {
+            _scanner = scanner;
+            EngineName = engineName;
+            DefaultWeight = defaultWeight;
+            _batchSlots = new SemaphoreSlim(Math.Max(1, scanner.MaxConcurrentBatches));
+            _dispatcher = Task.Run(DispatchLoopAsync);
+        }
+
+        public async Task<ThreatScanResult> ScanAsync(ThreatScanContext context, CancellationToken ct = default)
+        {
+            if (!IsReady || (context.Content == null && !File.Exists(context.FilePath)))
+                return ThreatScanResult.Clean(EngineName);
+
+            var pending = new PendingScan(new ExternalScanItem(context.FilePath, context.Content));
+            using var registration = ct.Register(() => pending.Completion.TrySetCanceled(ct));
+
+            if (!_queue.Writer.TryWrite(pending))
+                return ThreatScanResult.Error(EngineName, "المحرك متوقف");
+
+            try
+            {
+                return ToResult(await pending.Completion.Task.ConfigureAwait(false));
+            }
+            catch (OperationCanceledException)
+            {
+                return ThreatScanResult.Error(EngineName, $"{_scanner.Name}: تم إلغاء الفحص");
+            }
+        }
+
+        private async Task DispatchLoopAsync()
+        {
+            var reader = _queue.Reader;
+            var token = _shutdown.Token;
+
+            try
+            {
+                while (await reader.WaitToReadAsync(token).ConfigureAwait(false))
+                {
+                    // انتظار مقعد دفعة أولاً: ما يصل خلال ذلك ينضم للدفعة التالية
+                    await _batchSlots.WaitAsync(token).ConfigureAwait(false);
+
+                    var batch = new List<PendingScan>(_scanner.MaxBatchSize);
+                    while (batch.Count < _scanner.MaxBatchSize && reader.TryRead(out var pending))
+                    {
+                        if (!pending.Completion.Task.IsCompleted)
+                            batch.Add(pending);
+                    }
+
+                    if (batch.Count == 0)
+                    {
+                        _batchSlots.Release();
+                        continue;
+                    }
+
+                    Interlocked.Increment(ref _batchesDispatched);
+                    _ = RunBatchAsync(batch);
+                }
+            }
+            catch (OperationCanceledException)
+            {
+            }
+
+            while (reader.TryRead(out var pending))
+                pending.Completion.TrySetResult(ExternalScanVerdict.Failed("المحرك متوقف"));
+        }
+
+        private async Task RunBatchAsync(List<PendingScan> batch)
+        {
+            try
+            {
+                var verdicts = await _scanner.ScanBatchAsync(
+                    batch.Select(p => p.Item).ToArray(), _shutdown.Token).ConfigureAwait(false);
+
+                for (int i = 0; i < batch.Count; i++)
+                {
+                    batch[i].Completion.TrySetResult(i < verdicts.Count
+                        ? verdicts[i]
+                        : ExternalScanVerdict.Failed("نتيجة ناقصة من الماسح"));
+                }
+            }
+            catch (Exception ex)
+            {
+                foreach (var pending in batch)
+                    pending.Completion.TrySetResult(ExternalScanVerdict.Failed(ex.Message));
+            }
+            finally
+            {
+                _batchSlots.Release();
+            }
+        }
+
+        private ThreatScanResult ToResult(ExternalScanVerdict verdict)
+        {
+            switch (verdict.Status)
+            {
+                case ExternalScanStatus.Infected:
+                    var result = new ThreatScanResult
+                    {
+                        EngineName = EngineName,
+                        Score = 95,
+                        Verdict = EngineVerdict.Malicious,
+                        Confidence = 0.95
+                    };
+                    result.Reasons.Add($"{_scanner.Name} اكتشف تهديد: {verdict.ThreatName}");
+                    result.Metadata["ExternalScanner"] = _scanner.Name;
+                    result.Metadata["ExternalThreatName"] = verdict.ThreatName ?? "";
+                    return result;
+
+                case ExternalScanStatus.Clean:
+                    return new ThreatScanResult
+                    {
+                        EngineName = EngineName,
+                        Score = 0,
+                        Verdict = EngineVerdict.Clean,
+                        Confidence = 0.85
+                    };
+
+                case ExternalScanStatus.Skipped:
+                    return ThreatScanResult.Clean(EngineName);
+
+                default:
+                    return ThreatScanResult.Error(EngineName, $"{_scanner.Name}: {verdict.Message}");
+            }
+        }
+
+        public void Dispose()
+        {
+            _queue.Writer.TryComplete();
+            _shutdown.Cancel();
+            try { _dispatcher.Wait(TimeSpan.FromSeconds(2)); } catch { }
+            (_scanner as IDisposable)?.Dispose();
+            GC.SuppressFinalize(this);
+        }
+
+        private sealed class PendingScan
+        {
+            public PendingScan(ExternalScanItem item) => Item = item;
+
+            public ExternalScanItem Item { get; }
+
+            public TaskCompletionSource<ExternalScanVerdict> Completion { get; } =
+                new(TaskCreationOptions.RunContinuationsAsynchronously);
+        }
+    }
+}
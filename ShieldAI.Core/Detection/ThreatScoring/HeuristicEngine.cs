@@ -48,14 +48,6 @@ namespace ShieldAI.Core.Detection.ThreatScoring
             ".aspack", ".adata", ".boom", ".MPRESS", ".nsp0", ".nsp1", ".petite"
         };
 
-        // مسارات تشغيل مشبوهة
-        private static readonly string[] SuspiciousPaths = new[]
-        {
-            @"\temp\", @"\tmp\", @"\appdata\local\temp\", @"\appdata\roaming\",
-            @"\downloads\", @"\public\", @"\programdata\",
-            @"\windows\temp\", @"\users\public\"
-        };
-
         public Task<ThreatScanResult> ScanAsync(ThreatScanContext context, CancellationToken ct = default)
         {
             var result = new ThreatScanResult { EngineName = EngineName };
@@ -272,16 +264,12 @@ namespace ShieldAI.Core.Detection.ThreatScoring
         private int AnalyzePath(ThreatScanContext context, ThreatScanResult result)
         {
             int score = 0;
-            var lowerPath = context.FilePath.ToLowerInvariant();
 
-            foreach (var suspPath in SuspiciousPaths)
+            // مسارات تشغيل مشبوهة (القائمة الموحدة في PathPolicy)
+            if (PathPolicy.Current.Matches(context.FilePath, PathClass.Suspicious))
             {
-                if (lowerPath.Contains(suspPath, StringComparison.OrdinalIgnoreCase))
-                {
-                    score += 10;
-                    result.Reasons.Add($"تشغيل من مسار مشبوه: {context.Directory}");
-                    break;
-                }
+                score += 10;
+                result.Reasons.Add($"تشغيل من مسار مشبوه: {context.Directory}");
             }
 
             // ملف تنفيذي بامتداد مزدوج
@@ -0,0 +1,47 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/ThreatScoring/IPrevalenceTracker.cs
+// واجهة تتبع الانتشار المحلي (دقيق أو تقريبي)
+// =====================================================
+
+using ShieldAI.Core.Configuration;
+
+namespace ShieldAI.Core.Detection.ThreatScoring
+{
+    /// <summary>
+    /// تتبع عدد مرات رؤية البصمة محلياً - يغذي ReputationEngine.EvaluatePrevalence
+    /// </summary>
+    public interface IPrevalenceTracker
+    {
+        /// <summary>
+        /// تسجيل رؤية وإرجاع الحالة بعدها
+        /// </summary>
+        PrevalenceEntry Record(string sha256);
+
+        /// <summary>
+        /// الحالة دون تسجيل
+        /// </summary>
+        bool TryGet(string sha256, out PrevalenceEntry entry);
+
+        /// <summary>
+        /// عدد البصمات المختلفة (تقديري في الوضع التقريبي)
+        /// </summary>
+        long DistinctCount { get; }
+    }
+
+    /// <summary>
+    /// اختيار المتتبع المشترك حسب الإعدادات
+    /// </summary>
+    public static class PrevalenceTracker
+    {
+        private static readonly Lazy<IPrevalenceTracker> SharedTracker = new(() =>
+            ConfigManager.Instance.Settings.PrevalenceMode == PrevalenceTrackingMode.Approximate
+                ? PrevalenceSketch.Shared
+                : LocalPrevalenceStore.Shared);
+
+        /// <summary>
+        /// المتتبع المشترك للعملية (يُحدد مرة واحدة عند أول استخدام)
+        /// </summary>
+        public static IPrevalenceTracker Shared => SharedTracker.Value;
+    }
+}
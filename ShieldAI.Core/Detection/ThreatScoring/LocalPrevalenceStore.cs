@@ -4,59 +4,222 @@
 // تتبع مدى انتشار الملفات محلياً
 // =====================================================
 
+using System.Buffers.Binary;
 using System.Collections.Concurrent;
+using System.Security.Cryptography;
+using System.Text;
 using System.Text.Json;
 
 namespace ShieldAI.Core.Detection.ThreatScoring
 {
-    public class LocalPrevalenceStore
+    /// <summary>
+    /// مخزن الانتشار المحلي - سجل ثنائي إلحاقي (append-only) بمفتاح البصمة:
+    /// التسجيل في الذاكرة فقط، والتغييرات تُكتب دفعة واحدة على مؤقت (group commit)،
+    /// والسجل يُضغط إلى لقطة عندما تتجاوز السجلات القديمة عدد الإدخالات الحية.
+    /// </summary>
+    public class LocalPrevalenceStore : IPrevalenceTracker, IDisposable
     {
+        // الترويسة: "SPRV" + رقم الإصدار
+        private const uint Magic = 0x56525053;
+        private const ushort FormatVersion = 1;
+        private const int HeaderSize = 6;
+
+        // السجل: digest(32) + firstSeen(8) + lastSeen(8) + count(4) + checksum(4)
+        internal const int RecordSize = 56;
+        private const int PayloadSize = RecordSize - 4;
+
+        // الضغط عندما يتجاوز السجل ضعف الإدخالات الحية (وبحد أدنى حتى لا يُضغط ملف صغير باستمرار)
+        private const int CompactionMinRecords = 4096;
+        private const int CompactionRatio = 2;
+
+        private static readonly Lazy<LocalPrevalenceStore> SharedStore = new(CreateShared);
+
         private readonly string _storePath;
-        private readonly ConcurrentDictionary<string, PrevalenceEntry> _entries = new();
+        private readonly ConcurrentDictionary<PrevalenceDigest, PrevalenceEntry> _entries = new();
+        private readonly ConcurrentDictionary<PrevalenceDigest, byte> _dirty = new();
         private readonly object _lock = new();
+        private readonly Timer? _flushTimer;
+        private long _logRecords;
+        private long _flushCount;
+        private long _compactionCount;
+        private bool _disposed;
 
-        public LocalPrevalenceStore(string? storePath = null)
+        /// <param name="storePath">مسار ملف السجل</param>
+        /// <param name="flushIntervalMs">فترة الكتابة الجماعية (0 = يدوياً عبر Flush فقط)</param>
+        public LocalPrevalenceStore(string? storePath = null, int flushIntervalMs = 2000)
         {
             _storePath = storePath ?? Path.Combine(
                 Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData),
-                "ShieldAI", "reputation_store.json");
+                "ShieldAI", "reputation_store.dat");
             Load();
+
+            if (flushIntervalMs > 0)
+            {
+                _flushTimer = new Timer(_ => Flush(), null, flushIntervalMs, flushIntervalMs);
+            }
         }
 
+        /// <summary>
+        /// المخزن المشترك للعملية (المسار الافتراضي) - كل المحركات تكتب لنفس الملف
+        /// </summary>
+        public static LocalPrevalenceStore Shared => SharedStore.Value;
+
+        /// <summary>
+        /// عدد البصمات المعروفة
+        /// </summary>
+        public int Count => _entries.Count;
+
+        long IPrevalenceTracker.DistinctCount => _entries.Count;
+
+        /// <summary>
+        /// تغييرات لم تُكتب بعد
+        /// </summary>
+        public int PendingWrites => _dirty.Count;
+
+        /// <summary>
+        /// عدد السجلات في ملف السجل (الحية + القديمة)
+        /// </summary>
+        public long LogRecordCount => Interlocked.Read(ref _logRecords);
+
+        public long FlushCount => Interlocked.Read(ref _flushCount);
+        public long CompactionCount => Interlocked.Read(ref _compactionCount);
+
         public PrevalenceEntry Record(string sha256)
         {
             var now = DateTime.UtcNow;
-            var entry = _entries.AddOrUpdate(sha256,
-                _ => new PrevalenceEntry { FirstSeenUtc = now, LastSeenUtc = now, SeenCount = 1 },
-                (_, existing) =>
-                {
-                    existing.LastSeenUtc = now;
-                    existing.SeenCount++;
-                    return existing;
-                });
+            var digest = PrevalenceDigest.From(sha256);
 
-            Save();
+            var entry = _entries.GetOrAdd(digest, _ => new PrevalenceEntry { FirstSeenUtc = now });
+            lock (entry)
+            {
+                entry.LastSeenUtc = now;
+                entry.SeenCount++;
+            }
+
+            _dirty[digest] = 0;
             return entry;
         }
 
         public bool TryGet(string sha256, out PrevalenceEntry entry)
         {
-            return _entries.TryGetValue(sha256, out entry!);
+            return _entries.TryGetValue(PrevalenceDigest.From(sha256), out entry!);
         }
 
-        private void Load()
+        /// <summary>
+        /// كتابة التغييرات المعلقة دفعة واحدة ثم الضغط إذا لزم
+        /// </summary>
+        public void Flush()
+        {
+            lock (_lock)
+            {
+                try
+                {
+                    if (!_dirty.IsEmpty)
+                        AppendDirty();
+
+                    var records = Interlocked.Read(ref _logRecords);
+                    if (records > CompactionMinRecords && records > (long)_entries.Count * CompactionRatio)
+                        Compact();
+                }
+                catch
+                {
+                    // ignore - المحاولة التالية تعيد الكتابة (الإدخالات تبقى في _dirty)
+                }
+            }
+        }
+
+        /// <summary>
+        /// إعادة كتابة السجل كلقطة للإدخالات الحية فقط
+        /// </summary>
+        public void Compact()
+        {
+            lock (_lock)
+            {
+                EnsureDirectory();
+                // _dirty لا يُمسح: تغيير متزامن مع اللقطة يُلحق بعدها كسجل مكرر (غير ضار)
+                var tempPath = _storePath + ".tmp";
+
+                long written = 0;
+                using (var stream = new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None, 64 * 1024))
+                {
+                    WriteHeader(stream);
+
+                    var buffer = new byte[RecordSize];
+                    foreach (var (digest, entry) in _entries)
+                    {
+                        EncodeRecord(buffer, digest, entry);
+                        stream.Write(buffer);
+                        written++;
+                    }
+
+                    stream.Flush(flushToDisk: true);
+                }
+
+                File.Move(tempPath, _storePath, overwrite: true);
+                Interlocked.Exchange(ref _logRecords, written);
+                Interlocked.Increment(ref _compactionCount);
+            }
+        }
+
+        private void AppendDirty()
         {
+            EnsureDirectory();
+
+            var keys = _dirty.Keys;
+            var buffer = new byte[keys.Count * RecordSize];
+            int count = 0;
+
+            foreach (var digest in keys)
+            {
+                if (!_dirty.TryRemove(digest, out _) || !_entries.TryGetValue(digest, out var entry))
+                    continue;
+
+                if ((count + 1) * RecordSize > buffer.Length)
+                    Array.Resize(ref buffer, buffer.Length * 2 + RecordSize);
+
+                EncodeRecord(buffer.AsSpan(count * RecordSize, RecordSize), digest, entry);
+                count++;
+            }
+
+            if (count == 0)
+                return;
+
             try
             {
-                if (!File.Exists(_storePath))
-                    return;
+                using var stream = new FileStream(_storePath, FileMode.OpenOrCreate, FileAccess.Write, FileShare.Read);
+                if (stream.Length < HeaderSize)
+                {
+                    stream.SetLength(0);
+                    WriteHeader(stream);
+                }
+                else
+                {
+                    stream.Seek(0, SeekOrigin.End);
+                }
 
-                var json = File.ReadAllText(_storePath);
-                var data = JsonSerializer.Deserialize<Dictionary<string, PrevalenceEntry>>(json);
-                if (data == null) return;
+                stream.Write(buffer, 0, count * RecordSize);
+                stream.Flush(flushToDisk: true);
+            }
+            catch
+            {
+                // لم تُكتب - تعود للدفعة التالية
+                for (int i = 0; i < count; i++)
+                    _dirty[DecodeDigest(buffer.AsSpan(i * RecordSize, 32))] = 0;
+                throw;
+            }
 
-                foreach (var kvp in data)
-                    _entries[kvp.Key] = kvp.Value;
+            Interlocked.Add(ref _logRecords, count);
+            Interlocked.Increment(ref _flushCount);
+        }
+
+        private void Load()
+        {
+            try
+            {
+                if (File.Exists(_storePath))
+                    LoadLog();
+
+                ImportLegacyJson();
             }
             catch
             {
@@ -64,28 +227,208 @@ namespace ShieldAI.Core.Detection.ThreatScoring
             }
         }
 
-        private void Save()
+        private void LoadLog()
         {
-            lock (_lock)
+            long validLength;
+            long records = 0;
+            bool validHeader;
+
+            using (var stream = new FileStream(_storePath, FileMode.Open, FileAccess.Read, FileShare.Read, 64 * 1024))
             {
-                try
-                {
-                    var dir = Path.GetDirectoryName(_storePath);
-                    if (!string.IsNullOrEmpty(dir) && !Directory.Exists(dir))
-                        Directory.CreateDirectory(dir);
+                Span<byte> header = stackalloc byte[HeaderSize];
+                validHeader = stream.ReadAtLeast(header, HeaderSize, throwOnEndOfStream: false) == HeaderSize &&
+                              BinaryPrimitives.ReadUInt32LittleEndian(header) == Magic &&
+                              BinaryPrimitives.ReadUInt16LittleEndian(header[4..]) == FormatVersion;
 
-                    var json = JsonSerializer.Serialize(_entries, new JsonSerializerOptions
-                    {
-                        WriteIndented = true
-                    });
-                    File.WriteAllText(_storePath, json);
-                }
-                catch
+                // ترويسة غير معروفة: الملف يُفرَّغ ويبدأ سجل جديد
+                validLength = validHeader ? HeaderSize : 0;
+                var record = new byte[RecordSize];
+
+                while (validHeader && stream.ReadAtLeast(record, RecordSize, throwOnEndOfStream: false) == RecordSize)
                 {
-                    // ignore
+                    if (!TryDecodeRecord(record, out var digest, out var entry))
+                        break;
+
+                    // آخر سجل للبصمة هو الأحدث
+                    _entries[digest] = entry;
+                    validLength += RecordSize;
+                    records++;
                 }
             }
+
+            // ذيل ممزق من كتابة انقطعت - يُقص ليبقى الإلحاق على حدود السجلات
+            if (new FileInfo(_storePath).Length != validLength)
+            {
+                using var stream = new FileStream(_storePath, FileMode.Open, FileAccess.Write, FileShare.Read);
+                stream.SetLength(validLength);
+            }
+
+            _logRecords = records;
+        }
+
+        /// <summary>
+        /// ترحيل reputation_store.json القديم (مرة واحدة) ثم حذفه
+        /// </summary>
+        private void ImportLegacyJson()
+        {
+            var legacyPath = Path.Combine(Path.GetDirectoryName(_storePath) ?? "", "reputation_store.json");
+            if (!File.Exists(legacyPath))
+                return;
+
+            var data = JsonSerializer.Deserialize<Dictionary<string, PrevalenceEntry>>(File.ReadAllText(legacyPath));
+            if (data != null)
+            {
+                foreach (var kvp in data)
+                    _entries.TryAdd(PrevalenceDigest.From(kvp.Key), kvp.Value);
+            }
+
+            Compact();
+            File.Delete(legacyPath);
+        }
+
+        private static LocalPrevalenceStore CreateShared()
+        {
+            var store = new LocalPrevalenceStore();
+            // آخر دفعة قبل الخروج - بدونها تضيع تغييرات فترة مؤقت واحدة على الأكثر
+            AppDomain.CurrentDomain.ProcessExit += (_, _) => store.Flush();
+            return store;
+        }
+
+        private void EnsureDirectory()
+        {
+            var dir = Path.GetDirectoryName(_storePath);
+            if (!string.IsNullOrEmpty(dir) && !Directory.Exists(dir))
+                Directory.CreateDirectory(dir);
+        }
+
+        private static void WriteHeader(Stream stream)
+        {
+            Span<byte> header = stackalloc byte[HeaderSize];
+            BinaryPrimitives.WriteUInt32LittleEndian(header, Magic);
+            BinaryPrimitives.WriteUInt16LittleEndian(header[4..], FormatVersion);
+            stream.Write(header);
+        }
+
+        private static void EncodeRecord(Span<byte> buffer, PrevalenceDigest digest, PrevalenceEntry entry)
+        {
+            digest.WriteTo(buffer);
+
+            lock (entry)
+            {
+                BinaryPrimitives.WriteInt64LittleEndian(buffer[32..], entry.FirstSeenUtc.Ticks);
+                BinaryPrimitives.WriteInt64LittleEndian(buffer[40..], entry.LastSeenUtc.Ticks);
+                BinaryPrimitives.WriteInt32LittleEndian(buffer[48..], entry.SeenCount);
+            }
+
+            BinaryPrimitives.WriteUInt32LittleEndian(buffer[PayloadSize..], Checksum(buffer[..PayloadSize]));
+        }
+
+        private static bool TryDecodeRecord(ReadOnlySpan<byte> buffer, out PrevalenceDigest digest, out PrevalenceEntry entry)
+        {
+            digest = default;
+            entry = null!;
+
+            if (BinaryPrimitives.ReadUInt32LittleEndian(buffer[PayloadSize..]) != Checksum(buffer[..PayloadSize]))
+                return false;
+
+            var first = BinaryPrimitives.ReadInt64LittleEndian(buffer[32..]);
+            var last = BinaryPrimitives.ReadInt64LittleEndian(buffer[40..]);
+            if ((ulong)first > (ulong)DateTime.MaxValue.Ticks || (ulong)last > (ulong)DateTime.MaxValue.Ticks)
+                return false;
+
+            digest = DecodeDigest(buffer);
+            entry = new PrevalenceEntry
+            {
+                FirstSeenUtc = new DateTime(first, DateTimeKind.Utc),
+                LastSeenUtc = new DateTime(last, DateTimeKind.Utc),
+                SeenCount = BinaryPrimitives.ReadInt32LittleEndian(buffer[48..])
+            };
+            return true;
+        }
+
+        private static PrevalenceDigest DecodeDigest(ReadOnlySpan<byte> buffer) => new(
+            BinaryPrimitives.ReadUInt64LittleEndian(buffer),
+            BinaryPrimitives.ReadUInt64LittleEndian(buffer[8..]),
+            BinaryPrimitives.ReadUInt64LittleEndian(buffer[16..]),
+            BinaryPrimitives.ReadUInt64LittleEndian(buffer[24..]));
+
+        /// <summary>
+        /// FNV-1a 32 - يكشف السجلات الممزقة أو التالفة
+        /// </summary>
+        private static uint Checksum(ReadOnlySpan<byte> data)
+        {
+            uint hash = 2166136261;
+            foreach (var b in data)
+            {
+                hash ^= b;
+                hash *= 16777619;
+            }
+            return hash;
         }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+
+            _flushTimer?.Dispose();
+            Flush();
+            _disposed = true;
+        }
+    }
+
+    /// <summary>
+    /// بصمة SHA256 بتمثيل ثنائي مضغوط (32 بايت بدل سلسلة hex من 64 حرفاً)
+    /// </summary>
+    public readonly record struct PrevalenceDigest(ulong A, ulong B, ulong C, ulong D)
+    {
+        /// <summary>
+        /// من hex (64 حرفاً، أي حالة) - أي مفتاح آخر يُشتق بـ SHA256 لنصه
+        /// </summary>
+        public static PrevalenceDigest From(string sha256)
+        {
+            Span<byte> bytes = stackalloc byte[32];
+            if (!TryParseHex(sha256, bytes))
+                SHA256.HashData(Encoding.UTF8.GetBytes(sha256), bytes);
+
+            return new PrevalenceDigest(
+                BinaryPrimitives.ReadUInt64LittleEndian(bytes),
+                BinaryPrimitives.ReadUInt64LittleEndian(bytes[8..]),
+                BinaryPrimitives.ReadUInt64LittleEndian(bytes[16..]),
+                BinaryPrimitives.ReadUInt64LittleEndian(bytes[24..]));
+        }
+
+        public void WriteTo(Span<byte> buffer)
+        {
+            BinaryPrimitives.WriteUInt64LittleEndian(buffer, A);
+            BinaryPrimitives.WriteUInt64LittleEndian(buffer[8..], B);
+            BinaryPrimitives.WriteUInt64LittleEndian(buffer[16..], C);
+            BinaryPrimitives.WriteUInt64LittleEndian(buffer[24..], D);
+        }
+
+        private static bool TryParseHex(string text, Span<byte> bytes)
+        {
+            if (text.Length != 64)
+                return false;
+
+            for (int i = 0; i < 32; i++)
+            {
+                int high = HexValue(text[2 * i]);
+                int low = HexValue(text[2 * i + 1]);
+                if ((high | low) < 0)
+                    return false;
+                bytes[i] = (byte)(high << 4 | low);
+            }
+
+            return true;
+        }
+
+        private static int HexValue(char c) => c switch
+        {
+            >= '0' and <= '9' => c - '0',
+            >= 'a' and <= 'f' => c - 'a' + 10,
+            >= 'A' and <= 'F' => c - 'A' + 10,
+            _ => -1
+        };
     }
 
     public class PrevalenceEntry
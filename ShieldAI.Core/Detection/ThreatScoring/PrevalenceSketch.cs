@@ -0,0 +1,505 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/ThreatScoring/PrevalenceSketch.cs
+// تقدير الانتشار بذاكرة ثابتة (count-min sketch + HyperLogLog)
+// =====================================================
+
+using System.Numerics;
+using System.Runtime.InteropServices;
+using ShieldAI.Core.Configuration;
+
+namespace ShieldAI.Core.Detection.ThreatScoring
+{
+    /// <summary>
+    /// إعدادات المقدّر
+    /// </summary>
+    public class PrevalenceSketchOptions
+    {
+        public int Width { get; set; } = 1 << 19;
+        public int Depth { get; set; } = 4;
+        public TimeSpan WindowDuration { get; set; } = TimeSpan.FromHours(48);
+        public int WindowCount { get; set; } = 4;
+        public double DecayFactor { get; set; } = 0.5;
+
+        public static PrevalenceSketchOptions FromSettings(AppSettings settings) => new()
+        {
+            Width = settings.PrevalenceSketchWidth,
+            Depth = settings.PrevalenceSketchDepth,
+            WindowDuration = TimeSpan.FromHours(Math.Max(1, settings.PrevalenceWindowHours)),
+            WindowCount = settings.PrevalenceWindowCount,
+            DecayFactor = settings.PrevalenceDecayFactor
+        };
+    }
+
+    /// <summary>
+    /// متتبع انتشار تقريبي: count-min sketch (تحديث محافظ) و HyperLogLog لكل نافذة زمنية.
+    /// النوافذ حلقة ثابتة - الأقدم يُمسح عند الدوران، والعدّ = مجموع النوافذ موزوناً بالتلاشي.
+    /// الذاكرة = النوافذ × العمق × العرض × 2 بايت، مهما كان عدد البصمات.
+    /// ضجيج التصادمات في كل نافذة يُقاس ببصمات مرجعية لم تُسجَّل قط ويُطرح من تقديرها - وإلا تبدو
+    /// البصمة الجديدة في نافذة مزدحمة شائعة وقديمة. حد الخطأ النظري (e / العرض × الإضافات) أعلى
+    /// بكثير من الضجيج الفعلي مع التحديث المحافظ، واستخدامه يخفي بصمات حقيقية متوسطة الانتشار.
+    /// </summary>
+    public class PrevalenceSketch : IPrevalenceTracker, IDisposable
+    {
+        private const uint Magic = 0x4B535053; // "SPSK"
+        private const ushort FormatVersion = 2;
+
+        private static readonly Lazy<PrevalenceSketch> SharedSketch = new(CreateShared);
+
+        private readonly PrevalenceSketchOptions _options;
+        private readonly Window[] _windows;
+        private readonly double[] _weights;
+        private readonly Func<DateTime> _clock;
+        private readonly string? _snapshotPath;
+        private readonly Timer? _saveTimer;
+        private readonly object _lock = new();
+        private int _current;
+        private bool _disposed;
+
+        /// <param name="snapshotPath">ملف اللقطة (null = في الذاكرة فقط)</param>
+        /// <param name="saveIntervalMs">فترة حفظ اللقطة (0 = يدوياً عبر Save)</param>
+        /// <param name="clock">مصدر الوقت (UTC) - للاختبارات</param>
+        public PrevalenceSketch(
+            PrevalenceSketchOptions? options = null,
+            string? snapshotPath = null,
+            int saveIntervalMs = 0,
+            Func<DateTime>? clock = null)
+        {
+            _options = options ?? new PrevalenceSketchOptions();
+            _clock = clock ?? (() => DateTime.UtcNow);
+            _snapshotPath = snapshotPath;
+
+            var count = Math.Clamp(_options.WindowCount, 1, 64);
+            var decay = Math.Clamp(_options.DecayFactor, 0.0, 1.0);
+            _windows = new Window[count];
+            _weights = new double[count];
+            for (int i = 0; i < count; i++)
+            {
+                _windows[i] = new Window(_options.Width, _options.Depth);
+                _weights[i] = Math.Pow(decay, i);
+            }
+
+            _windows[0].StartUtc = _clock();
+
+            if (_snapshotPath != null)
+                Load();
+
+            if (_snapshotPath != null && saveIntervalMs > 0)
+                _saveTimer = new Timer(_ => Save(), null, saveIntervalMs, saveIntervalMs);
+        }
+
+        /// <summary>
+        /// المقدّر المشترك للعملية (إعدادات ConfigManager، لقطة كل 5 دقائق وعند الخروج)
+        /// </summary>
+        public static PrevalenceSketch Shared => SharedSketch.Value;
+
+        /// <summary>
+        /// الذاكرة المحجوزة للعدادات والسجلات (بايت)
+        /// </summary>
+        public long MemoryBytes => _windows.Sum(w => w.Counts.MemoryBytes + HyperLogLog.MemoryBytes);
+
+        /// <summary>
+        /// عدد البصمات المختلفة في النوافذ الحية (HyperLogLog مدموج)
+        /// </summary>
+        public long DistinctCount
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    Rotate(_clock());
+                    var merged = new HyperLogLog();
+                    foreach (var window in _windows)
+                    {
+                        if (window.IsActive)
+                            merged.Merge(window.Distinct);
+                    }
+                    return (long)Math.Round(merged.Estimate());
+                }
+            }
+        }
+
+        public PrevalenceEntry Record(string sha256) => Record(PrevalenceDigest.From(sha256));
+
+        /// <summary>
+        /// تسجيل رؤية لبصمة محللة مسبقاً
+        /// </summary>
+        public PrevalenceEntry Record(PrevalenceDigest digest)
+        {
+            var now = _clock();
+
+            lock (_lock)
+            {
+                Rotate(now);
+                var window = _windows[_current];
+                window.Counts.Add(digest.A, digest.B);
+                window.Distinct.Add(digest.C);
+                window.Adds++;
+
+                // تحت حد الخطأ في كل النوافذ = رؤية أولى
+                var entry = EstimateLocked(digest, now) ?? new PrevalenceEntry { FirstSeenUtc = now, SeenCount = 1 };
+                entry.LastSeenUtc = now;
+                return entry;
+            }
+        }
+
+        public bool TryGet(string sha256, out PrevalenceEntry entry)
+        {
+            var digest = PrevalenceDigest.From(sha256);
+            var now = _clock();
+
+            lock (_lock)
+            {
+                Rotate(now);
+                entry = EstimateLocked(digest, now)!;
+                return entry != null;
+            }
+        }
+
+        /// <summary>
+        /// عدّ موزون عبر النوافذ؛ أول رؤية ≈ بداية أقدم نافذة تحتوي البصمة
+        /// </summary>
+        private PrevalenceEntry? EstimateLocked(PrevalenceDigest digest, DateTime now)
+        {
+            double total = 0;
+            DateTime? first = null;
+            DateTime? last = null;
+
+            for (int age = 0; age < _windows.Length; age++)
+            {
+                var window = _windows[(_current - age + _windows.Length) % _windows.Length];
+                if (!window.IsActive)
+                    continue;
+
+                var count = window.Counts.Estimate(digest.A, digest.B) - window.NoiseFloor;
+                if (count <= 0)
+                    continue;
+
+                total += count * _weights[age];
+                first = window.StartUtc;
+                last ??= age == 0 ? now : window.StartUtc + _options.WindowDuration;
+            }
+
+            if (first == null)
+                return null;
+
+            return new PrevalenceEntry
+            {
+                FirstSeenUtc = first.Value,
+                LastSeenUtc = last!.Value < now ? last.Value : now,
+                SeenCount = Math.Max(1, (int)Math.Round(total))
+            };
+        }
+
+        /// <summary>
+        /// تقديم الحلقة إلى النافذة التي تحتوي now (مسح النوافذ المنتهية)
+        /// </summary>
+        private void Rotate(DateTime now)
+        {
+            var start = _windows[_current].StartUtc;
+            var duration = _options.WindowDuration.Ticks;
+            var elapsed = (now - start).Ticks / duration;
+            if (elapsed <= 0)
+                return;
+
+            var steps = (int)Math.Min(elapsed, _windows.Length);
+            for (int step = 1; step <= steps; step++)
+            {
+                _current = (_current + 1) % _windows.Length;
+                _windows[_current].Reset(start.AddTicks((elapsed - steps + step) * duration));
+            }
+        }
+
+        /// <summary>
+        /// حفظ لقطة ثنائية (ملف مؤقت ثم استبدال)
+        /// </summary>
+        public void Save()
+        {
+            if (_snapshotPath == null)
+                return;
+
+            lock (_lock)
+            {
+                try
+                {
+                    var dir = Path.GetDirectoryName(_snapshotPath);
+                    if (!string.IsNullOrEmpty(dir) && !Directory.Exists(dir))
+                        Directory.CreateDirectory(dir);
+
+                    var tempPath = _snapshotPath + ".tmp";
+                    using (var stream = new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None, 1 << 16))
+                    using (var writer = new BinaryWriter(stream))
+                    {
+                        writer.Write(Magic);
+                        writer.Write(FormatVersion);
+                        writer.Write(_windows[0].Counts.Width);
+                        writer.Write(_windows[0].Counts.Depth);
+                        writer.Write(_windows.Length);
+                        writer.Write(_options.WindowDuration.Ticks);
+                        writer.Write(_current);
+
+                        foreach (var window in _windows)
+                        {
+                            writer.Write(window.StartUtc.Ticks);
+                            writer.Write(window.Adds);
+                            writer.Write(MemoryMarshal.AsBytes(window.Counts.Table.AsSpan()));
+                            writer.Write(window.Distinct.Registers);
+                        }
+
+                        stream.Flush(flushToDisk: true);
+                    }
+
+                    File.Move(tempPath, _snapshotPath, overwrite: true);
+                }
+                catch
+                {
+                    // ignore - اللقطة التالية تعيد المحاولة
+                }
+            }
+        }
+
+        private void Load()
+        {
+            try
+            {
+                if (!File.Exists(_snapshotPath))
+                    return;
+
+                using var stream = new FileStream(_snapshotPath!, FileMode.Open, FileAccess.Read, FileShare.Read, 1 << 16);
+                using var reader = new BinaryReader(stream);
+
+                // هندسة مختلفة (تغيّرت الإعدادات) = لقطة غير صالحة، نبدأ من الصفر
+                if (reader.ReadUInt32() != Magic)
+                    return;
+
+                var version = reader.ReadUInt16();
+                if (version is < 1 or > FormatVersion ||
+                    reader.ReadInt32() != _windows[0].Counts.Width ||
+                    reader.ReadInt32() != _windows[0].Counts.Depth ||
+                    reader.ReadInt32() != _windows.Length ||
+                    reader.ReadInt64() != _options.WindowDuration.Ticks)
+                {
+                    return;
+                }
+
+                var current = reader.ReadInt32();
+                if (current < 0 || current >= _windows.Length)
+                    return;
+
+                foreach (var window in _windows)
+                {
+                    window.StartUtc = new DateTime(reader.ReadInt64(), DateTimeKind.Utc);
+                    window.Adds = version >= 2 ? reader.ReadInt64() : -1;
+                    stream.ReadExactly(MemoryMarshal.AsBytes(window.Counts.Table.AsSpan()));
+                    stream.ReadExactly(window.Distinct.Registers);
+
+                    // الإصدار 1 بلا عدّاد إضافات: عدد البصمات المختلفة (HyperLogLog) حد أدنى له
+                    if (window.Adds < 0)
+                        window.Adds = (long)Math.Round(window.Distinct.Estimate());
+                }
+
+                _current = current;
+            }
+            catch
+            {
+                foreach (var window in _windows)
+                    window.Reset(default);
+                _current = 0;
+                _windows[0].StartUtc = _clock();
+            }
+        }
+
+        private static PrevalenceSketch CreateShared()
+        {
+            var path = Path.Combine(
+                Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData),
+                "ShieldAI", "prevalence_sketch.bin");
+            var sketch = new PrevalenceSketch(
+                PrevalenceSketchOptions.FromSettings(ConfigManager.Instance.Settings), path, saveIntervalMs: 300_000);
+            AppDomain.CurrentDomain.ProcessExit += (_, _) => sketch.Save();
+            return sketch;
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+
+            _saveTimer?.Dispose();
+            Save();
+        }
+
+        private sealed class Window
+        {
+            public readonly CountMinSketch Counts;
+            public readonly HyperLogLog Distinct = new();
+            public DateTime StartUtc;
+            public long Adds;
+            private int _noiseFloor;
+            private long _noiseAdds = -1;
+
+            public Window(int width, int depth)
+            {
+                Counts = new CountMinSketch(width, depth);
+            }
+
+            public bool IsActive => StartUtc != default;
+
+            /// <summary>
+            /// أعلى تقدير لبصمات مرجعية غير مسجلة = ضجيج التصادمات الحالي في النافذة.
+            /// يُعاد قياسه بعد نمو الإضافات بنحو 1.5% فقط (16 × العمق قراءة لكل قياس).
+            /// </summary>
+            public int NoiseFloor
+            {
+                get
+                {
+                    if (_noiseAdds < 0 || Adds < _noiseAdds || Adds - _noiseAdds >= Math.Max(64, _noiseAdds / 64))
+                    {
+                        var floor = 0;
+                        foreach (var (a, b) in NoiseProbes)
+                            floor = Math.Max(floor, Counts.Estimate(a, b));
+                        _noiseFloor = floor;
+                        _noiseAdds = Adds;
+                    }
+                    return _noiseFloor;
+                }
+            }
+
+            public void Reset(DateTime startUtc)
+            {
+                Counts.Clear();
+                Distinct.Clear();
+                Adds = 0;
+                StartUtc = startUtc;
+                _noiseAdds = -1;
+            }
+
+            private static readonly (ulong A, ulong B)[] NoiseProbes = CreateNoiseProbes();
+
+            private static (ulong A, ulong B)[] CreateNoiseProbes()
+            {
+                // SplitMix64 ببذرة ثابتة: نفس المراجع بين التشغيلات واللقطات
+                ulong state = 0x5348494C44414950UL;
+                ulong Next()
+                {
+                    var z = state += 0x9E3779B97F4A7C15UL;
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+                    return z ^ (z >> 31);
+                }
+
+                var probes = new (ulong A, ulong B)[16];
+                for (int i = 0; i < probes.Length; i++)
+                    probes[i] = (Next(), Next());
+                return probes;
+            }
+        }
+    }
+
+    /// <summary>
+    /// count-min sketch بعدادات 16 بت مشبعة وتحديث محافظ (conservative update):
+    /// التقدير لا ينقص أبداً عن العدّ الحقيقي، والزيادة محدودة بالتصادمات.
+    /// المدخل بصمة موزعة بانتظام أصلاً (SHA256) فالفهرسة double hashing بلا دالة hash إضافية.
+    /// </summary>
+    public sealed class CountMinSketch
+    {
+        private readonly int _mask;
+
+        internal readonly ushort[] Table;
+
+        public CountMinSketch(int width, int depth)
+        {
+            Width = (int)BitOperations.RoundUpToPowerOf2((uint)Math.Clamp(width, 64, 1 << 26));
+            Depth = Math.Clamp(depth, 1, 16);
+            _mask = Width - 1;
+            Table = new ushort[Width * Depth];
+        }
+
+        public int Width { get; }
+        public int Depth { get; }
+        public long MemoryBytes => Table.LongLength * sizeof(ushort);
+
+        public void Add(ulong hash1, ulong hash2)
+        {
+            var min = Estimate(hash1, hash2);
+            if (min == ushort.MaxValue)
+                return;
+
+            // التحديث المحافظ: لا تُرفع إلا الخلايا التي تساوي الحد الأدنى
+            var target = (ushort)(min + 1);
+            for (int row = 0; row < Depth; row++)
+            {
+                ref var cell = ref Table[Index(row, hash1, hash2)];
+                if (cell < target)
+                    cell = target;
+            }
+        }
+
+        public int Estimate(ulong hash1, ulong hash2)
+        {
+            int min = int.MaxValue;
+            for (int row = 0; row < Depth; row++)
+                min = Math.Min(min, Table[Index(row, hash1, hash2)]);
+            return min;
+        }
+
+        public void Clear() => Array.Clear(Table);
+
+        private int Index(int row, ulong hash1, ulong hash2) =>
+            row * Width + (int)((hash1 + (ulong)row * (hash2 | 1)) & (ulong)_mask);
+    }
+
+    /// <summary>
+    /// HyperLogLog بدقة 14 بت (16384 سجلاً، خطأ معياري ≈ 0.8%)
+    /// </summary>
+    public sealed class HyperLogLog
+    {
+        private const int Precision = 14;
+        private const int RegisterCount = 1 << Precision;
+
+        public const long MemoryBytes = RegisterCount;
+
+        internal readonly byte[] Registers = new byte[RegisterCount];
+
+        public void Add(ulong hash)
+        {
+            var index = (int)(hash >> (64 - Precision));
+            // بت حارس يحد الرتبة عند 64 - Precision + 1
+            var rank = (byte)(BitOperations.LeadingZeroCount((hash << Precision) | (1UL << (Precision - 1))) + 1);
+            if (rank > Registers[index])
+                Registers[index] = rank;
+        }
+
+        public void Merge(HyperLogLog other)
+        {
+            for (int i = 0; i < RegisterCount; i++)
+            {
+                if (other.Registers[i] > Registers[i])
+                    Registers[i] = other.Registers[i];
+            }
+        }
+
+        public double Estimate()
+        {
+            double sum = 0;
+            int zeros = 0;
+            foreach (var register in Registers)
+            {
+                sum += 1.0 / (1UL << register);
+                if (register == 0) zeros++;
+            }
+
+            const double m = RegisterCount;
+            var alpha = 0.7213 / (1 + 1.079 / m);
+            var estimate = alpha * m * m / sum;
+
+            // تصحيح النطاق الصغير (linear counting)
+            if (estimate <= 2.5 * m && zeros > 0)
+                estimate = m * Math.Log(m / zeros);
+
+            return estimate;
+        }
+
+        public void Clear() => Array.Clear(Registers);
+    }
+}
@@ -4,51 +4,50 @@
 // كاش السمعة لتقليل التكرار
 // =====================================================
 
-using System.Collections.Concurrent;
+using ShieldAI.Core.Caching;
 
 namespace ShieldAI.Core.Detection.ThreatScoring
 {
+    /// <summary>
+    /// كاش نتائج السمعة - محدود بالعدد حتى لا ينمو مع كل بصمة جديدة
+    /// </summary>
     public class ReputationCache
     {
-        private readonly ConcurrentDictionary<string, CacheEntry> _entries = new();
-        private readonly TimeSpan _ttl;
+        private readonly BoundedCache<string, ReputationResult> _entries;
 
-        public ReputationCache(TimeSpan? ttl = null)
+        public ReputationCache(TimeSpan? ttl = null, int maxEntries = 50_000)
         {
-            _ttl = ttl ?? TimeSpan.FromMinutes(30);
+            _entries = new BoundedCache<string, ReputationResult>(
+                new BoundedCacheOptions
+                {
+                    Name = "ReputationCache",
+                    MaxEntries = maxEntries,
+                    Ttl = ttl ?? TimeSpan.FromMinutes(30),
+                    Policy = CacheEvictionPolicy.Lru
+                },
+                comparer: StringComparer.OrdinalIgnoreCase);
         }
 
+        /// <summary>
+        /// إحصائيات الإصابة والإخلاء
+        /// </summary>
+        public CacheStatistics Statistics => _entries.GetStatistics();
+
         public bool TryGet(string key, out ReputationResult? result)
         {
-            result = null;
-            if (!_entries.TryGetValue(key, out var entry))
-                return false;
-
-            if (DateTime.UtcNow - entry.TimestampUtc > _ttl)
+            if (_entries.TryGet(key, out var cached))
             {
-                _entries.TryRemove(key, out _);
-                return false;
+                result = cached;
+                return true;
             }
 
-            result = entry.Result;
-            return true;
+            result = null;
+            return false;
         }
 
         public void Store(string key, ReputationResult result)
         {
-            _entries[key] = new CacheEntry(result);
-        }
-
-        private sealed class CacheEntry
-        {
-            public CacheEntry(ReputationResult result)
-            {
-                Result = result;
-                TimestampUtc = DateTime.UtcNow;
-            }
-
-            public ReputationResult Result { get; }
-            public DateTime TimestampUtc { get; }
+            _entries.Set(key, result);
         }
     }
 
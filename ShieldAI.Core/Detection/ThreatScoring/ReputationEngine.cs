@@ -4,6 +4,8 @@
 // محرك السمعة - يقيّم الملف بناءً على الناشر والمسار
 // =====================================================
 
+using ShieldAI.Core.Scanning;
+
 namespace ShieldAI.Core.Detection.ThreatScoring
 {
     /// <summary>
@@ -16,7 +18,8 @@ namespace ShieldAI.Core.Detection.ThreatScoring
         public bool IsReady => true;
 
         private readonly ReputationCache _cache = new(TimeSpan.FromMinutes(30));
-        private readonly LocalPrevalenceStore _prevalenceStore = new();
+        private readonly IPrevalenceTracker _prevalenceStore;
+        private readonly AuthenticodeVerifier _authenticode = AuthenticodeVerifier.Shared;
 
         // ناشرون موثوقون
         private static readonly HashSet<string> TrustedPublishers = new(StringComparer.OrdinalIgnoreCase)
@@ -35,27 +38,6 @@ namespace ShieldAI.Core.Detection.ThreatScoring
             "Logitech"
         };
 
-        // مسارات موثوقة
-        private static readonly string[] TrustedPaths = new[]
-        {
-            @"C:\Windows\",
-            @"C:\Program Files\",
-            @"C:\Program Files (x86)\",
-            @"C:\Windows\System32\",
-            @"C:\Windows\SysWOW64\"
-        };
-
-        // مسارات مشبوهة
-        private static readonly string[] SuspiciousPaths = new[]
-        {
-            @"\Temp\", @"\Tmp\",
-            @"\AppData\Local\Temp\",
-            @"\AppData\Roaming\",
-            @"\Users\Public\",
-            @"\ProgramData\",
-            @"\Downloads\"
-        };
-
         // امتدادات عالية الخطورة
         private static readonly HashSet<string> HighRiskExtensions = new(StringComparer.OrdinalIgnoreCase)
         {
@@ -63,6 +45,12 @@ namespace ShieldAI.Core.Detection.ThreatScoring
             ".ps1", ".bat", ".cmd", ".reg", ".msi", ".msp"
         };
 
+        /// <param name="prevalence">متتبع الانتشار (الافتراضي: المشترك حسب PrevalenceMode)</param>
+        public ReputationEngine(IPrevalenceTracker? prevalence = null)
+        {
+            _prevalenceStore = prevalence ?? PrevalenceTracker.Shared;
+        }
+
         public Task<ThreatScanResult> ScanAsync(ThreatScanContext context, CancellationToken ct = default)
         {
             var result = new ThreatScanResult { EngineName = EngineName };
@@ -133,7 +121,7 @@ namespace ShieldAI.Core.Detection.ThreatScoring
 
             if (!string.IsNullOrEmpty(context.SignerName))
             {
-                if (TrustedPublishers.Contains(context.SignerName))
+                if (TrustedPublishers.Contains(context.SignerName) && !context.IsUnsignedOrUntrustedPublisher)
                 {
                     score -= 20; // خصم نقاط للناشر الموثوق
                     result.Reasons.Add($"ناشر موثوق: {context.SignerName}");
@@ -161,57 +149,63 @@ namespace ShieldAI.Core.Detection.ThreatScoring
 
         private void UpdateSignatureInfo(ThreatScanContext context, ThreatScanResult result)
         {
-            if (!File.Exists(context.FilePath))
-                return;
+            // التوقيع محلل مسبقاً في PEAnalyzer؛ وإلا من الملف مع الكاش حسب البصمة
+            var signature = context.PEInfo?.Signature;
+            if (signature == null)
+            {
+                if (context.Content != null || !File.Exists(context.FilePath))
+                    return;
+                signature = _authenticode.GetSignature(context.FilePath, context.Sha256Hash);
+            }
 
-            try
+            if (!signature.IsSigned)
             {
-                var cert = System.Security.Cryptography.X509Certificates.X509Certificate.CreateFromSignedFile(context.FilePath);
-                if (cert != null)
-                {
-                    var x509 = new System.Security.Cryptography.X509Certificates.X509Certificate2(cert);
-                    context.SignerName = x509.SubjectName.Name;
-                    context.HasValidSignature = true;
-                    result.Reasons.Add($"توقيع رقمي: {x509.Subject}");
-                    if (!string.IsNullOrEmpty(context.SignerName) &&
-                        TrustedPublishers.Contains(context.SignerName))
-                    {
-                        context.IsUnsignedOrUntrustedPublisher = false;
-                    }
-                }
+                context.IsUnsignedOrUntrustedPublisher = true;
+                return;
             }
-            catch
+
+            if (!signature.IsValid)
             {
-                // unsigned or invalid
+                context.HasValidSignature = false;
                 context.IsUnsignedOrUntrustedPublisher = true;
+                result.Reasons.Add($"توقيع رقمي غير سليم: {signature.SignerSubject ?? signature.Error}");
+                return;
+            }
+
+            context.SignerName = signature.SignerName;
+            context.HasValidSignature = true;
+            result.Reasons.Add($"توقيع رقمي: {signature.SignerSubject}");
+
+            if (!string.IsNullOrEmpty(context.SignerName) &&
+                TrustedPublishers.Contains(context.SignerName))
+            {
+                // الاسم وحده قابل للانتحال: الثقة تتطلب سلسلة شهادات موثوقة (محسوبة مرة لكل شهادة)
+                var verdict = _authenticode.GetPublisherVerdict(signature);
+                context.IsUnsignedOrUntrustedPublisher = verdict?.ChainTrusted != true;
+                if (context.IsUnsignedOrUntrustedPublisher)
+                    result.Reasons.Add($"اسم ناشر موثوق بسلسلة شهادات غير موثوقة: {context.SignerName}");
             }
         }
 
         private int EvaluatePath(ThreatScanContext context, ThreatScanResult result)
         {
             int score = 0;
-            var filePath = context.FilePath;
+            var policy = PathPolicy.Current;
+            var pathClass = policy.Classify(context.FilePath);
 
             // مسار موثوق
-            foreach (var trusted in TrustedPaths)
+            if ((pathClass & PathClass.Trusted) != 0)
             {
-                if (filePath.StartsWith(trusted, StringComparison.OrdinalIgnoreCase))
-                {
-                    score -= 10;
-                    result.Reasons.Add($"مسار موثوق: {trusted}");
-                    return score;
-                }
+                score -= 10;
+                result.Reasons.Add($"مسار موثوق: {policy.FindRule(context.FilePath, PathClass.Trusted)}");
+                return score;
             }
 
             // مسار مشبوه
-            foreach (var suspicious in SuspiciousPaths)
+            if ((pathClass & PathClass.Suspicious) != 0)
             {
-                if (filePath.Contains(suspicious, StringComparison.OrdinalIgnoreCase))
-                {
-                    score += 15;
-                    result.Reasons.Add($"مسار مشبوه: يحتوي على {suspicious.Trim('\\')}");
-                    break;
-                }
+                score += 15;
+                result.Reasons.Add($"مسار مشبوه: يحتوي على {policy.FindRule(context.FilePath, PathClass.Suspicious)}");
             }
 
             return score;
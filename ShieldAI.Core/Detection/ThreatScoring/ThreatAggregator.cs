@@ -6,6 +6,7 @@
 
 using ShieldAI.Core.Configuration;
 using ShieldAI.Core.Logging;
+using ShieldAI.Core.Models;
 using ShieldAI.Core.Scanning;
 using Microsoft.Extensions.Logging;
 using MsILogger = Microsoft.Extensions.Logging.ILogger;
@@ -79,7 +80,8 @@ namespace ShieldAI.Core.Detection.ThreatScoring
                 new MlEngine(),
                 new ReputationEngine(),
                 new AmsiEngine(),
-                new DefenderEngine()
+                new DefenderEngine(),
+                new ClamAvEngine()
             };
 
             return new ThreatAggregator(engines, weights, scanCache: scanCache);
@@ -115,9 +117,10 @@ namespace ShieldAI.Core.Detection.ThreatScoring
                 }
             }
 
-            // تشغيل جميع المحركات بالتوازي
+            // تشغيل جميع المحركات بالتوازي (الماسحات الخارجية تعمل كرأي ثانٍ فقط)
             var enginesToRun = _engines
                 .Where(e => e.IsReady)
+                .Where(e => e is not ExternalScannerEngine)
                 .Where(e => !HighPressureMode || !IsHeavyEngine(e.EngineName));
 
             var tasks = enginesToRun
@@ -184,7 +187,8 @@ namespace ShieldAI.Core.Detection.ThreatScoring
         /// <summary>
         /// بناء سياق الفحص من مسار الملف
         /// </summary>
-        public ThreatScanContext BuildContext(string filePath)
+        /// <param name="sha256Hash">بصمة محسوبة مسبقاً (تجنب إعادة قراءة الملف)</param>
+        public ThreatScanContext BuildContext(string filePath, string? sha256Hash = null)
         {
             var context = ThreatScanContext.FromFile(filePath);
 
@@ -193,15 +197,40 @@ namespace ShieldAI.Core.Detection.ThreatScoring
 
             try
             {
-                // حساب الـ Hash
-                context.Sha256Hash = PEAnalyzer.CalculateSha256(filePath);
-
-                // تحليل PE
+                // تحليل PE (يحسب البصمة والتوقيع من نفس القراءة)
                 var peInfo = _peAnalyzer.Analyze(filePath);
                 context.PEInfo = peInfo;
 
+                // حساب الـ Hash
+                context.Sha256Hash = sha256Hash?.ToUpperInvariant()
+                    ?? (string.IsNullOrEmpty(peInfo.Sha256Hash) ? PEAnalyzer.CalculateSha256(filePath) : peInfo.Sha256Hash);
+
                 // التوقيع الرقمي
-                context.HasValidSignature = peInfo.HasDigitalSignature;
+                ApplySignature(context, peInfo);
+            }
+            catch
+            {
+                // تجاهل الأخطاء في بناء السياق
+            }
+
+            return context;
+        }
+
+        /// <summary>
+        /// بناء سياق الفحص لعنصر أرشيف من الذاكرة (بدون ملفات مؤقتة)
+        /// </summary>
+        public ThreatScanContext BuildContext(string containerPath, string entryName, byte[] content)
+        {
+            // تاريخ ثابت: مفتاح الكاش يعتمد على بصمة المحتوى فقط
+            var context = ThreatScanContext.FromArchiveEntry(containerPath, entryName, content, DateTime.UnixEpoch);
+
+            try
+            {
+                var peInfo = _peAnalyzer.Analyze(content);
+                context.Sha256Hash = peInfo.Sha256Hash;
+                context.Md5Hash = Convert.ToHexString(System.Security.Cryptography.MD5.HashData(content));
+                context.PEInfo = peInfo;
+                ApplySignature(context, peInfo);
             }
             catch
             {
@@ -211,6 +240,16 @@ namespace ShieldAI.Core.Detection.ThreatScoring
             return context;
         }
 
+        /// <summary>
+        /// نقل نتيجة Authenticode إلى السياق: وجود جدول شهادات وحده لا يكفي
+        /// </summary>
+        private static void ApplySignature(ThreatScanContext context, PEFileInfo peInfo)
+        {
+            context.HasValidSignature = peInfo.Signature?.IsValid ?? false;
+            if (context.HasValidSignature)
+                context.SignerName = peInfo.Signature!.SignerName;
+        }
+
         /// <summary>
         /// حساب النتيجة المرجّحة
         /// </summary>
@@ -292,7 +331,7 @@ namespace ShieldAI.Core.Detection.ThreatScoring
 
         private static bool IsHeavyEngine(string engineName)
         {
-            return engineName is "MlEngine" or "ReputationEngine" or "DefenderEngine" or "VirusTotalEngine";
+            return engineName is "MlEngine" or "ReputationEngine" or "DefenderEngine" or "ClamAvEngine" or "VirusTotalEngine";
         }
 
         /// <summary>
@@ -307,34 +346,36 @@ namespace ShieldAI.Core.Detection.ThreatScoring
             var extra = new List<ThreatScanResult>();
 
             bool shouldRunVT = ShouldRunVirusTotal(context, initialResults, riskScore);
-            bool shouldRunDefender = ShouldRunDefender(context, initialResults, riskScore);
+            bool shouldRunExternal = ShouldRunExternalScanner(context, initialResults, riskScore);
 
             var secondOpinionEngines = _engines
                 .Where(e => e.IsReady)
                 .Where(e =>
                     (shouldRunVT && e.EngineName == "VirusTotalEngine") ||
-                    (shouldRunDefender && e.EngineName == "DefenderEngine"));
+                    (shouldRunExternal && e is ExternalScannerEngine))
+                .ToList();
 
-            foreach (var engine in secondOpinionEngines)
+            // محركات الرأي الثاني بالتوازي - الماسحات الخارجية تجمع الطلبات المتزامنة في دفعات
+            var tasks = secondOpinionEngines.Select(async engine =>
             {
                 try
                 {
-                    var reason = shouldRunDefender && engine.EngineName == "DefenderEngine"
+                    var reason = shouldRunExternal && engine is ExternalScannerEngine
                         ? (IsInSuspicionZone(riskScore) ? "SuspicionZone" : "PolicyRule")
                         : (IsInSuspicionZone(riskScore) ? "SuspicionZone" : "UnsignedSuspiciousPath");
 
                     ScanDiagnosticLog.LogSecondOpinion(
                         _logger, context.FilePath, engine.EngineName, riskScore, reason);
 
-                    var result = await engine.ScanAsync(context, ct);
-                    extra.Add(result);
+                    return await engine.ScanAsync(context, ct);
                 }
                 catch (Exception ex)
                 {
-                    extra.Add(ThreatScanResult.Error(engine.EngineName, ex.Message));
+                    return ThreatScanResult.Error(engine.EngineName, ex.Message);
                 }
-            }
+            });
 
+            extra.AddRange(await Task.WhenAll(tasks));
             return extra;
         }
 
@@ -362,9 +403,9 @@ namespace ShieldAI.Core.Detection.ThreatScoring
             return false;
         }
 
-        private bool ShouldRunDefender(ThreatScanContext context, ThreatScanResult[] results, int riskScore)
+        private bool ShouldRunExternalScanner(ThreatScanContext context, ThreatScanResult[] results, int riskScore)
         {
-            if (!_settings.EnableDefenderSecondOpinion)
+            if (!_settings.EnableDefenderSecondOpinion && !_settings.EnableClamdSecondOpinion)
                 return false;
 
             // القاعدة 1: داخل منطقة الشك
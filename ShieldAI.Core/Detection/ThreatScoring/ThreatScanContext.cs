@@ -5,6 +5,7 @@
 // =====================================================
 
 using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
 
 namespace ShieldAI.Core.Detection.ThreatScoring
 {
@@ -74,6 +75,21 @@ namespace ShieldAI.Core.Detection.ThreatScoring
         /// </summary>
         public string? CommandLine { get; set; }
 
+        /// <summary>
+        /// محتوى العنصر في الذاكرة (لعناصر الأرشيف - لا يوجد ملف على القرص)
+        /// </summary>
+        public byte[]? Content { get; set; }
+
+        /// <summary>
+        /// مسار الأرشيف الحاوي (null للملفات العادية)
+        /// </summary>
+        public string? ContainerPath { get; set; }
+
+        /// <summary>
+        /// هل السياق لعنصر داخل أرشيف
+        /// </summary>
+        public bool IsArchiveEntry => ContainerPath != null;
+
         /// <summary>
         /// امتداد الملف
         /// </summary>
@@ -119,32 +135,40 @@ namespace ShieldAI.Core.Detection.ThreatScoring
         /// </summary>
         public bool IsUnsignedOrUntrustedPublisher { get; set; }
 
+        /// <summary>
+        /// إنشاء سياق لعنصر داخل أرشيف من محتواه في الذاكرة
+        /// </summary>
+        public static ThreatScanContext FromArchiveEntry(string containerPath, string entryName, byte[] content, DateTime lastWriteTime)
+        {
+            var container = FromFile(containerPath);
+            return new ThreatScanContext
+            {
+                FilePath = $"{containerPath}>{entryName}",
+                ContainerPath = containerPath,
+                Content = content,
+                FileSize = content.LongLength,
+                CreationTime = lastWriteTime,
+                LastWriteTime = lastWriteTime,
+                IsFromTempOrAppData = container.IsFromTempOrAppData,
+                IsStartupLocation = container.IsStartupLocation
+            };
+        }
+
         /// <summary>
         /// إنشاء سياق من مسار ملف
         /// </summary>
         public static ThreatScanContext FromFile(string filePath)
         {
             var fileInfo = new FileInfo(filePath);
-            var fullPath = Path.GetFullPath(filePath);
-            var tempPath = Path.GetFullPath(Path.GetTempPath());
-            var appData = Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData);
-            var localAppData = Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData);
-            var startup = Environment.GetFolderPath(Environment.SpecialFolder.Startup);
-            var isFromTempOrAppData = fullPath.StartsWith(tempPath, StringComparison.OrdinalIgnoreCase)
-                                     || (!string.IsNullOrWhiteSpace(appData) &&
-                                         fullPath.StartsWith(Path.GetFullPath(appData), StringComparison.OrdinalIgnoreCase))
-                                     || (!string.IsNullOrWhiteSpace(localAppData) &&
-                                         fullPath.StartsWith(Path.GetFullPath(localAppData), StringComparison.OrdinalIgnoreCase));
-            var isStartupLocation = !string.IsNullOrWhiteSpace(startup)
-                                    && fullPath.StartsWith(Path.GetFullPath(startup), StringComparison.OrdinalIgnoreCase);
+            var pathClass = PathPolicy.Current.Classify(filePath);
             return new ThreatScanContext
             {
                 FilePath = filePath,
                 FileSize = fileInfo.Exists ? fileInfo.Length : 0,
                 CreationTime = fileInfo.Exists ? fileInfo.CreationTime : DateTime.MinValue,
                 LastWriteTime = fileInfo.Exists ? fileInfo.LastWriteTime : DateTime.MinValue,
-                IsFromTempOrAppData = isFromTempOrAppData,
-                IsStartupLocation = isStartupLocation
+                IsFromTempOrAppData = (pathClass & PathClass.TempOrAppData) != 0,
+                IsStartupLocation = (pathClass & PathClass.Startup) != 0
             };
         }
     }
@@ -4,11 +4,14 @@
 // تكامل مع VirusTotal API
 // =====================================================
 
+using System.Net;
 using System.Net.Http.Headers;
 using System.Net.Http.Json;
 using System.Security.Cryptography;
 using System.Text.Json;
 using System.Text.Json.Serialization;
+using ShieldAI.Core.Caching;
+using ShieldAI.Core.Configuration;
 using ShieldAI.Core.Logging;
 
 namespace ShieldAI.Core.Detection
@@ -21,27 +24,52 @@ namespace ShieldAI.Core.Detection
         private readonly HttpClient _httpClient;
         private readonly ILogger? _logger;
         private readonly string _apiKey;
-        private readonly Dictionary<string, VTCacheEntry> _cache;
+        private readonly BoundedCache<string, VTScanResult> _cache;
+        private readonly VirusTotalScheduler _scheduler;
         private bool _disposed;
 
-        private const string BaseUrl = "https://www.virustotal.com/api/v3";
-        private const int MaxFileSize = 32 * 1024 * 1024; // 32MB للخطة المجانية
+        // الشرطة الختامية ضرورية: المسارات النسبية تُلحق بـ api/v3 ولا تستبدلها
+        private const string BaseUrl = "https://www.virustotal.com/api/v3/";
+        internal const int MaxFileSize = 32 * 1024 * 1024; // 32MB للخطة المجانية
         private static readonly TimeSpan CacheDuration = TimeSpan.FromHours(24);
+        private const int CacheMaxEntries = 10_000;
 
         /// <summary>
         /// هل الـ API Key صالح ومتوفر
         /// </summary>
         public bool IsConfigured => !string.IsNullOrWhiteSpace(_apiKey);
 
-        public VirusTotalClient(string? apiKey = null, ILogger? logger = null)
+        /// <summary>
+        /// إحصائيات كاش النتائج
+        /// </summary>
+        public CacheStatistics CacheStatistics => _cache.GetStatistics();
+
+        /// <summary>
+        /// مجدول الطلبات (الحصة، الأولوية، دمج البصمات المكررة)
+        /// </summary>
+        public VirusTotalScheduler Scheduler => _scheduler;
+
+        /// <param name="apiKey">مفتاح الـ API</param>
+        /// <param name="logger">المسجل</param>
+        /// <param name="cachePath">ملف حفظ الكاش بين التشغيلات (يوفر حصة الطلبات)</param>
+        /// <param name="schedulerOptions">حصة الطلبات والاستطلاع (الافتراضي: من الإعدادات)</param>
+        /// <param name="baseUrl">عنوان الـ API (للاختبار مقابل خادم محلي)</param>
+        public VirusTotalClient(
+            string? apiKey = null,
+            ILogger? logger = null,
+            string? cachePath = null,
+            VirusTotalSchedulerOptions? schedulerOptions = null,
+            string? baseUrl = null)
         {
             _apiKey = apiKey ?? "";
             _logger = logger;
-            _cache = new Dictionary<string, VTCacheEntry>(StringComparer.OrdinalIgnoreCase);
+            _cache = CreateCache(cachePath ?? Path.Combine(
+                Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData),
+                "ShieldAI", "virustotal_cache.json"));
             
             _httpClient = new HttpClient
             {
-                BaseAddress = new Uri(BaseUrl),
+                BaseAddress = new Uri(baseUrl ?? BaseUrl),
                 Timeout = TimeSpan.FromMinutes(5)
             };
             
@@ -49,13 +77,27 @@ namespace ShieldAI.Core.Detection
             {
                 _httpClient.DefaultRequestHeaders.Add("x-apikey", _apiKey);
             }
+
+            _scheduler = new VirusTotalScheduler(
+                this, schedulerOptions ?? VirusTotalSchedulerOptions.FromSettings(ConfigManager.Instance.Settings), logger);
         }
 
         #region Public Methods
         /// <summary>
         /// فحص ملف عبر VirusTotal
         /// </summary>
-        public async Task<VTScanResult> ScanFileAsync(string filePath, CancellationToken cancellationToken = default)
+        public Task<VTScanResult> ScanFileAsync(string filePath, CancellationToken cancellationToken = default)
+        {
+            return ScanFileAsync(filePath, null, 0, cancellationToken);
+        }
+
+        /// <summary>
+        /// فحص ملف ببصمة محسوبة مسبقاً - الطلب يُجدول حسب درجة الخطورة ويكتمل دون حجز العامل
+        /// </summary>
+        /// <param name="sha256">بصمة الملف إن كانت معروفة (تجنب إعادة القراءة)</param>
+        /// <param name="riskScore">درجة الخطورة المحلية (0-100) - الأعلى يُخدم أولاً</param>
+        public async Task<VTScanResult> ScanFileAsync(
+            string filePath, string? sha256, int riskScore, CancellationToken cancellationToken = default)
         {
             if (!IsConfigured)
                 return VTScanResult.Error("VirusTotal API Key غير مكتمل");
@@ -65,36 +107,22 @@ namespace ShieldAI.Core.Detection
 
             try
             {
-                // حساب SHA256
-                var sha256 = await ComputeSha256Async(filePath);
+                sha256 = string.IsNullOrEmpty(sha256)
+                    ? await ComputeSha256Async(filePath)
+                    : sha256.ToLowerInvariant();
 
                 // التحقق من الكاش أولاً
-                if (_cache.TryGetValue(sha256, out var cached) && !cached.IsExpired)
+                if (_cache.TryGet(sha256, out var cached))
                 {
                     _logger?.Debug("نتيجة VT من الكاش: {0}", sha256);
-                    return cached.Result;
-                }
-
-                // البحث عن التقرير الموجود
-                var existingResult = await GetFileReportAsync(sha256, cancellationToken);
-                if (existingResult.Found)
-                {
-                    CacheResult(sha256, existingResult);
-                    return existingResult;
+                    return cached;
                 }
 
-                // رفع الملف إذا لم يكن موجوداً
-                var fileInfo = new FileInfo(filePath);
-                if (fileInfo.Length > MaxFileSize)
-                    return VTScanResult.Error($"حجم الملف أكبر من الحد المسموح ({MaxFileSize / 1024 / 1024}MB)");
-
-                var uploadResult = await UploadFileAsync(filePath, cancellationToken);
-                return uploadResult;
+                return await _scheduler.SubmitAsync(sha256, filePath, riskScore, cancellationToken);
             }
-            catch (HttpRequestException ex)
+            catch (OperationCanceledException)
             {
-                _logger?.Error(ex, "خطأ في الاتصال بـ VirusTotal");
-                return VTScanResult.Error($"خطأ في الاتصال: {ex.Message}");
+                throw;
             }
             catch (Exception ex)
             {
@@ -106,27 +134,16 @@ namespace ShieldAI.Core.Detection
         /// <summary>
         /// الحصول على تقرير ملف عبر Hash
         /// </summary>
-        public async Task<VTScanResult> GetFileReportAsync(string sha256, CancellationToken cancellationToken = default)
+        public Task<VTScanResult> GetFileReportAsync(string sha256, CancellationToken cancellationToken = default)
         {
             if (!IsConfigured)
-                return VTScanResult.Error("VirusTotal API Key غير مكتمل");
+                return Task.FromResult(VTScanResult.Error("VirusTotal API Key غير مكتمل"));
 
-            try
-            {
-                var response = await _httpClient.GetAsync($"/files/{sha256}", cancellationToken);
-                
-                if (response.StatusCode == System.Net.HttpStatusCode.NotFound)
-                    return new VTScanResult { Found = false };
-
-                response.EnsureSuccessStatusCode();
-                
-                var json = await response.Content.ReadAsStringAsync(cancellationToken);
-                return ParseFileReport(json, sha256);
-            }
-            catch (HttpRequestException ex) when (ex.StatusCode == System.Net.HttpStatusCode.NotFound)
-            {
-                return new VTScanResult { Found = false };
-            }
+            sha256 = sha256.ToLowerInvariant();
+            if (_cache.TryGet(sha256, out var cached))
+                return Task.FromResult(cached);
+
+            return _scheduler.SubmitAsync(sha256, null, 0, cancellationToken);
         }
 
         /// <summary>
@@ -139,7 +156,7 @@ namespace ShieldAI.Core.Detection
             try
             {
                 // فحص hash بسيط للتأكد من صحة المفتاح
-                var response = await _httpClient.GetAsync("/files/275a021bbfb6489e54d471899f7db9d1663fc695ec2fe2a2c4538aabf651fd0f");
+                var response = await _httpClient.GetAsync("files/275a021bbfb6489e54d471899f7db9d1663fc695ec2fe2a2c4538aabf651fd0f");
                 return response.IsSuccessStatusCode || response.StatusCode == System.Net.HttpStatusCode.NotFound;
             }
             catch
@@ -150,7 +167,23 @@ namespace ShieldAI.Core.Detection
         #endregion
 
         #region Private Methods
-        private async Task<VTScanResult> UploadFileAsync(string filePath, CancellationToken cancellationToken)
+        /// <summary>
+        /// GET /files/{sha256} - طلب واحد بلا إعادة محاولة (المجدول يتولى الحصة و429)
+        /// </summary>
+        internal async Task<VTApiResponse> SendReportRequestAsync(string sha256, CancellationToken cancellationToken)
+        {
+            using var response = await _httpClient.GetAsync($"files/{sha256}", cancellationToken);
+            if (!response.IsSuccessStatusCode)
+                return VTApiResponse.From(response);
+
+            var json = await response.Content.ReadAsStringAsync(cancellationToken);
+            return VTApiResponse.From(response) with { Report = ParseFileReport(json, sha256) };
+        }
+
+        /// <summary>
+        /// POST /files - رفع الملف وإرجاع معرّف التحليل
+        /// </summary>
+        internal async Task<VTApiResponse> SendUploadAsync(string filePath, CancellationToken cancellationToken)
         {
             using var content = new MultipartFormDataContent();
             using var fileStream = File.OpenRead(filePath);
@@ -159,44 +192,34 @@ namespace ShieldAI.Core.Detection
             streamContent.Headers.ContentType = new MediaTypeHeaderValue("application/octet-stream");
             content.Add(streamContent, "file", Path.GetFileName(filePath));
 
-            var response = await _httpClient.PostAsync("/files", content, cancellationToken);
-            response.EnsureSuccessStatusCode();
+            using var response = await _httpClient.PostAsync("files", content, cancellationToken);
+            if (!response.IsSuccessStatusCode)
+                return VTApiResponse.From(response);
 
             var json = await response.Content.ReadAsStringAsync(cancellationToken);
             var uploadResponse = JsonSerializer.Deserialize<VTUploadResponse>(json);
+            if (uploadResponse?.Data?.Id != null)
+                _logger?.Information("تم رفع الملف إلى VirusTotal: {0}", uploadResponse.Data.Id);
 
-            if (uploadResponse?.Data?.Id == null)
-                return VTScanResult.Error("فشل رفع الملف");
-
-            _logger?.Information("تم رفع الملف إلى VirusTotal: {0}", uploadResponse.Data.Id);
-
-            // انتظار النتيجة
-            return await WaitForAnalysisAsync(uploadResponse.Data.Id, cancellationToken);
+            return VTApiResponse.From(response) with { AnalysisId = uploadResponse?.Data?.Id };
         }
 
-        private async Task<VTScanResult> WaitForAnalysisAsync(string analysisId, CancellationToken cancellationToken)
+        /// <summary>
+        /// GET /analyses/{id} - حالة تحليل ملف مرفوع
+        /// </summary>
+        internal async Task<VTApiResponse> SendAnalysisRequestAsync(string analysisId, CancellationToken cancellationToken)
         {
-            for (int i = 0; i < 30; i++) // 5 دقائق كحد أقصى
-            {
-                await Task.Delay(10000, cancellationToken); // 10 ثواني
+            using var response = await _httpClient.GetAsync($"analyses/{analysisId}", cancellationToken);
+            if (!response.IsSuccessStatusCode)
+                return VTApiResponse.From(response);
 
-                var response = await _httpClient.GetAsync($"/analyses/{analysisId}", cancellationToken);
-                if (!response.IsSuccessStatusCode) continue;
-
-                var json = await response.Content.ReadAsStringAsync(cancellationToken);
-                var analysis = JsonSerializer.Deserialize<VTAnalysisResponse>(json);
-
-                if (analysis?.Data?.Attributes?.Status == "completed")
-                {
-                    var sha256 = analysis.Data?.Meta?.FileInfo?.Sha256 ?? "";
-                    if (!string.IsNullOrEmpty(sha256))
-                    {
-                        return await GetFileReportAsync(sha256, cancellationToken);
-                    }
-                }
-            }
-
-            return VTScanResult.Error("انتهت مهلة الانتظار");
+            var json = await response.Content.ReadAsStringAsync(cancellationToken);
+            var analysis = JsonSerializer.Deserialize<VTAnalysisResponse>(json);
+            return VTApiResponse.From(response) with
+            {
+                AnalysisStatus = analysis?.Data?.Attributes?.Status,
+                AnalysisSha256 = analysis?.Data?.Meta?.FileInfo?.Sha256
+            };
         }
 
         private VTScanResult ParseFileReport(string json, string sha256)
@@ -247,13 +270,32 @@ namespace ShieldAI.Core.Detection
             }
         }
 
-        private void CacheResult(string sha256, VTScanResult result)
+        internal void CacheResult(string sha256, VTScanResult result)
+        {
+            _cache.Set(sha256, result);
+        }
+
+        private BoundedCache<string, VTScanResult> CreateCache(string cachePath)
         {
-            _cache[sha256] = new VTCacheEntry
+            var options = new BoundedCacheOptions
             {
-                Result = result,
-                CachedAt = DateTime.Now
+                Name = "VirusTotal",
+                MaxEntries = CacheMaxEntries,
+                Ttl = CacheDuration,
+                Policy = CacheEvictionPolicy.Lru,
+                PersistencePath = cachePath
             };
+
+            try
+            {
+                return new BoundedCache<string, VTScanResult>(options, comparer: StringComparer.OrdinalIgnoreCase);
+            }
+            catch (Exception ex)
+            {
+                _logger?.Warning("تعذر تحميل كاش VT المحفوظ: {0}", ex.Message);
+                options.PersistencePath = null;
+                return new BoundedCache<string, VTScanResult>(options, comparer: StringComparer.OrdinalIgnoreCase);
+            }
         }
 
         private async Task<string> ComputeSha256Async(string filePath)
@@ -268,6 +310,17 @@ namespace ShieldAI.Core.Detection
         {
             if (_disposed) return;
             _disposed = true;
+            _scheduler.Dispose();
+
+            try
+            {
+                _cache.Save();
+            }
+            catch (Exception ex)
+            {
+                _logger?.Warning("تعذر حفظ كاش VT: {0}", ex.Message);
+            }
+
             _httpClient.Dispose();
         }
         #endregion
@@ -316,11 +369,25 @@ namespace ShieldAI.Core.Detection
         public string Result { get; set; } = "";
     }
 
-    internal class VTCacheEntry
+    /// <summary>
+    /// استجابة خام من الـ API للمجدول: الحالة ومهلة Retry-After والحقول المحللة
+    /// </summary>
+    internal sealed record VTApiResponse(HttpStatusCode StatusCode, TimeSpan? RetryAfter)
     {
-        public VTScanResult Result { get; set; } = new();
-        public DateTime CachedAt { get; set; }
-        public bool IsExpired => DateTime.Now - CachedAt > TimeSpan.FromHours(24);
+        public VTScanResult? Report { get; init; }
+        public string? AnalysisId { get; init; }
+        public string? AnalysisStatus { get; init; }
+        public string? AnalysisSha256 { get; init; }
+
+        public bool IsRateLimited => StatusCode == HttpStatusCode.TooManyRequests;
+
+        public static VTApiResponse From(HttpResponseMessage response)
+        {
+            var retryAfter = response.Headers.RetryAfter;
+            TimeSpan? delay = retryAfter?.Delta
+                ?? (retryAfter?.Date is { } date ? date - DateTimeOffset.UtcNow : null);
+            return new VTApiResponse(response.StatusCode, delay);
+        }
     }
 
     // API Response Models
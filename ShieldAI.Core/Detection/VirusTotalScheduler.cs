@@ -0,0 +1,448 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Detection/VirusTotalScheduler.cs
+// جدولة طلبات VirusTotal: حصة، أولوية، دمج، استطلاع بتراجع أسي
+// =====================================================
+
+using System.Net;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Logging;
+using ShieldAI.Core.Scanning;
+
+namespace ShieldAI.Core.Detection
+{
+    /// <summary>
+    /// خيارات مجدول VirusTotal
+    /// </summary>
+    public class VirusTotalSchedulerOptions
+    {
+        /// <summary>
+        /// الطلبات المسموحة في الدقيقة
+        /// </summary>
+        public double RequestsPerMinute { get; set; } = 4;
+
+        /// <summary>
+        /// أقصى دفعة فورية من الطلبات
+        /// </summary>
+        public int BurstSize { get; set; } = 4;
+
+        /// <summary>
+        /// الحصة اليومية (0 = بلا حد)
+        /// </summary>
+        public int DailyQuota { get; set; } = 500;
+
+        /// <summary>
+        /// السماح برفع الملفات غير المعروفة
+        /// </summary>
+        public bool AllowUpload { get; set; }
+
+        /// <summary>
+        /// أول انتظار قبل استطلاع نتيجة التحليل
+        /// </summary>
+        public TimeSpan PollInitialDelay { get; set; } = TimeSpan.FromSeconds(15);
+
+        /// <summary>
+        /// سقف الانتظار بين محاولات الاستطلاع
+        /// </summary>
+        public TimeSpan PollMaxDelay { get; set; } = TimeSpan.FromMinutes(2);
+
+        /// <summary>
+        /// معامل مضاعفة الانتظار بعد كل محاولة
+        /// </summary>
+        public double PollBackoffFactor { get; set; } = 2.0;
+
+        /// <summary>
+        /// أقصى عدد لمحاولات الاستطلاع
+        /// </summary>
+        public int MaxPollAttempts { get; set; } = 8;
+
+        /// <summary>
+        /// مرات إعادة المحاولة بعد 429 قبل الاستسلام
+        /// </summary>
+        public int MaxRateLimitRetries { get; set; } = 3;
+
+        /// <summary>
+        /// الانتظار بعد 429 إن لم يحدد الخادم Retry-After
+        /// </summary>
+        public TimeSpan DefaultRetryAfter { get; set; } = TimeSpan.FromMinutes(1);
+
+        public static VirusTotalSchedulerOptions FromSettings(AppSettings settings) => new()
+        {
+            RequestsPerMinute = Math.Max(1, settings.VirusTotalRequestsPerMinute),
+            BurstSize = Math.Max(1, settings.VirusTotalRequestsPerMinute),
+            DailyQuota = Math.Max(0, settings.VirusTotalDailyQuota),
+            AllowUpload = settings.AllowVirusTotalUpload
+        };
+    }
+
+    /// <summary>
+    /// مجدول خلفي لطلبات VirusTotal: يدمج طلبات نفس البصمة، يحترم الحصة عبر دلو رموز،
+    /// يخدم الأخطر أولاً، ويستطلع التحليلات بتراجع أسي دون حجز المستدعي.
+    /// </summary>
+    public sealed class VirusTotalScheduler : IDisposable
+    {
+        private const string QuotaExceededMessage = "تم استنفاد الحصة اليومية لـ VirusTotal";
+
+        private readonly VirusTotalClient _client;
+        private readonly VirusTotalSchedulerOptions _options;
+        private readonly ILogger? _logger;
+        private readonly Func<DateTime> _clock;
+        private readonly TokenBucket _bucket;
+
+        private readonly object _lock = new();
+        private readonly PriorityQueue<PendingLookup, (int NegativeRisk, long Sequence)> _queue = new();
+        private readonly Dictionary<string, PendingLookup> _pending = new(StringComparer.OrdinalIgnoreCase);
+        private readonly SemaphoreSlim _signal = new(0);
+        private readonly CancellationTokenSource _stopping = new();
+        private readonly Task _dispatcher;
+
+        private long _sequence;
+        private DateTime _quotaDay;
+        private int _quotaUsed;
+        private long _requestsSent;
+        private long _coalesced;
+        private long _rateLimited;
+        private int _inFlight;
+        private bool _disposed;
+
+        public VirusTotalScheduler(
+            VirusTotalClient client,
+            VirusTotalSchedulerOptions? options = null,
+            ILogger? logger = null,
+            Func<DateTime>? clock = null)
+        {
+            _client = client;
+            _options = options ?? new VirusTotalSchedulerOptions();
+            _logger = logger;
+            _clock = clock ?? (() => DateTime.UtcNow);
+
+            var ratePerSecond = Math.Max(0.001, _options.RequestsPerMinute / 60.0);
+            _bucket = new TokenBucket(ratePerSecond, Math.Max(1, _options.BurstSize) / ratePerSecond);
+
+            _dispatcher = Task.Run(DispatchLoopAsync);
+        }
+
+        /// <summary>
+        /// بصمات تنتظر دورها
+        /// </summary>
+        public int QueueLength
+        {
+            get { lock (_lock) return _pending.Count - _inFlight; }
+        }
+
+        /// <summary>
+        /// طلبات HTTP المرسلة فعلياً
+        /// </summary>
+        public long RequestsSent => Interlocked.Read(ref _requestsSent);
+
+        /// <summary>
+        /// طلبات دُمجت مع طلب قائم لنفس البصمة
+        /// </summary>
+        public long CoalescedCount => Interlocked.Read(ref _coalesced);
+
+        /// <summary>
+        /// مرات رد الخادم بـ 429
+        /// </summary>
+        public long RateLimitedCount => Interlocked.Read(ref _rateLimited);
+
+        /// <summary>
+        /// جدولة استعلام بصمة (مع رفع الملف إن سُمح ولم تكن معروفة)
+        /// </summary>
+        public Task<VTScanResult> SubmitAsync(string sha256, string? filePath, int riskScore, CancellationToken cancellationToken = default)
+        {
+            PendingLookup lookup;
+            lock (_lock)
+            {
+                if (_disposed)
+                    return Task.FromResult(VTScanResult.Error("تم إيقاف مجدول VirusTotal"));
+
+                if (_pending.TryGetValue(sha256, out var existing))
+                {
+                    Interlocked.Increment(ref _coalesced);
+                    lookup = existing;
+                    lookup.FilePath ??= filePath;
+
+                    // ترقية الأولوية: المدخل القديم في الطابور يُتجاهل عند سحبه
+                    if (!lookup.Dispatched && riskScore > lookup.RiskScore)
+                        Enqueue(lookup, riskScore);
+                }
+                else
+                {
+                    lookup = new PendingLookup(sha256, filePath);
+                    _pending[sha256] = lookup;
+                    Enqueue(lookup, riskScore);
+                }
+            }
+
+            return cancellationToken.CanBeCanceled
+                ? lookup.Completion.Task.WaitAsync(cancellationToken)
+                : lookup.Completion.Task;
+        }
+
+        private void Enqueue(PendingLookup lookup, int riskScore)
+        {
+            lookup.RiskScore = riskScore;
+            lookup.Sequence = ++_sequence;
+            _queue.Enqueue(lookup, (-riskScore, lookup.Sequence));
+            _signal.Release();
+        }
+
+        private async Task DispatchLoopAsync()
+        {
+            var ct = _stopping.Token;
+            try
+            {
+                while (!ct.IsCancellationRequested)
+                {
+                    await _signal.WaitAsync(ct);
+
+                    // الرمز يُحجز قبل السحب كي يفوز الأخطر الذي وصل أثناء الانتظار
+                    var withinQuota = TryConsumeQuota();
+                    if (withinQuota)
+                        await WaitForTokenAsync(ct);
+
+                    PendingLookup? lookup = null;
+                    lock (_lock)
+                    {
+                        while (_queue.TryDequeue(out var candidate, out var priority))
+                        {
+                            if (!candidate.Dispatched && priority.Sequence == candidate.Sequence)
+                            {
+                                candidate.Dispatched = true;
+                                _inFlight++;
+                                lookup = candidate;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (lookup == null)
+                    {
+                        if (withinQuota)
+                            RefundQuota();
+                        continue;
+                    }
+
+                    if (!withinQuota)
+                    {
+                        Complete(lookup, VTScanResult.Error(QuotaExceededMessage));
+                        continue;
+                    }
+
+                    _ = ProcessAsync(lookup, ct);
+                }
+            }
+            catch (OperationCanceledException)
+            {
+                // إيقاف
+            }
+        }
+
+        private async Task ProcessAsync(PendingLookup lookup, CancellationToken ct)
+        {
+            VTScanResult result;
+            try
+            {
+                result = await LookupAsync(lookup, ct);
+            }
+            catch (OperationCanceledException)
+            {
+                result = VTScanResult.Error("تم إيقاف مجدول VirusTotal");
+            }
+            catch (QuotaExceededException)
+            {
+                result = VTScanResult.Error(QuotaExceededMessage);
+            }
+            catch (HttpRequestException ex)
+            {
+                _logger?.Error(ex, "خطأ في الاتصال بـ VirusTotal");
+                result = VTScanResult.Error($"خطأ في الاتصال: {ex.Message}");
+            }
+            catch (Exception ex)
+            {
+                _logger?.Error(ex, "خطأ أثناء طلب VirusTotal");
+                result = VTScanResult.Error(ex.Message);
+            }
+
+            if (result.Found && !result.HasError)
+                _client.CacheResult(lookup.Sha256, result);
+
+            Complete(lookup, result);
+        }
+
+        private void Complete(PendingLookup lookup, VTScanResult result)
+        {
+            lock (_lock)
+            {
+                _pending.Remove(lookup.Sha256);
+                _inFlight--;
+            }
+
+            lookup.Completion.TrySetResult(result);
+        }
+
+        private async Task<VTScanResult> LookupAsync(PendingLookup lookup, CancellationToken ct)
+        {
+            // رمز الطلب الأول محجوز من حلقة التوزيع
+            var report = await SendAsync(c => _client.SendReportRequestAsync(lookup.Sha256, c), tokenHeld: true, ct);
+            if (report.Report != null)
+                return report.Report;
+
+            if (report.StatusCode != HttpStatusCode.NotFound)
+                return VTScanResult.Error($"استجابة غير متوقعة من VirusTotal: {(int)report.StatusCode}");
+
+            var unknown = new VTScanResult { Found = false, Sha256 = lookup.Sha256 };
+            if (!_options.AllowUpload || lookup.FilePath == null || !File.Exists(lookup.FilePath))
+                return unknown;
+
+            if (new FileInfo(lookup.FilePath).Length > VirusTotalClient.MaxFileSize)
+                return VTScanResult.Error($"حجم الملف أكبر من الحد المسموح ({VirusTotalClient.MaxFileSize / 1024 / 1024}MB)");
+
+            var upload = await SendAsync(c => _client.SendUploadAsync(lookup.FilePath, c), tokenHeld: false, ct);
+            if (upload.AnalysisId == null)
+                return VTScanResult.Error("فشل رفع الملف");
+
+            return await PollAnalysisAsync(upload.AnalysisId, lookup.Sha256, ct);
+        }
+
+        private async Task<VTScanResult> PollAnalysisAsync(string analysisId, string sha256, CancellationToken ct)
+        {
+            var delay = _options.PollInitialDelay;
+            for (int attempt = 0; attempt < _options.MaxPollAttempts; attempt++)
+            {
+                await Task.Delay(delay, ct);
+
+                var analysis = await SendAsync(c => _client.SendAnalysisRequestAsync(analysisId, c), tokenHeld: false, ct);
+                if (analysis.AnalysisStatus == "completed")
+                {
+                    var report = await SendAsync(
+                        c => _client.SendReportRequestAsync(analysis.AnalysisSha256 ?? sha256, c), tokenHeld: false, ct);
+                    return report.Report ?? VTScanResult.Error("اكتمل التحليل دون تقرير");
+                }
+
+                delay = TimeSpan.FromTicks(Math.Min(
+                    _options.PollMaxDelay.Ticks,
+                    (long)(delay.Ticks * Math.Max(1.0, _options.PollBackoffFactor))));
+            }
+
+            return VTScanResult.Error("انتهت مهلة الانتظار");
+        }
+
+        /// <summary>
+        /// إرسال طلب ضمن الحصة مع احترام 429 و Retry-After
+        /// </summary>
+        private async Task<VTApiResponse> SendAsync(
+            Func<CancellationToken, Task<VTApiResponse>> send, bool tokenHeld, CancellationToken ct)
+        {
+            for (int retry = 0; ; retry++)
+            {
+                if (!tokenHeld)
+                    await AcquireTokenAsync(ct);
+                tokenHeld = false;
+
+                Interlocked.Increment(ref _requestsSent);
+                var response = await send(ct);
+                if (!response.IsRateLimited || retry >= _options.MaxRateLimitRetries)
+                    return response;
+
+                Interlocked.Increment(ref _rateLimited);
+                var retryAfter = response.RetryAfter is { } after && after > TimeSpan.Zero
+                    ? after
+                    : _options.DefaultRetryAfter;
+                _logger?.Warning("VirusTotal رد بـ 429 - إيقاف الطلبات لمدة {0} ثانية", (int)retryAfter.TotalSeconds);
+                _bucket.Penalize(retryAfter);
+            }
+        }
+
+        private async Task AcquireTokenAsync(CancellationToken ct)
+        {
+            if (!TryConsumeQuota())
+                throw new QuotaExceededException();
+
+            await WaitForTokenAsync(ct);
+        }
+
+        private bool TryConsumeQuota()
+        {
+            lock (_lock)
+            {
+                var today = _clock().Date;
+                if (today != _quotaDay)
+                {
+                    _quotaDay = today;
+                    _quotaUsed = 0;
+                }
+
+                if (_options.DailyQuota > 0 && _quotaUsed >= _options.DailyQuota)
+                    return false;
+
+                _quotaUsed++;
+                return true;
+            }
+        }
+
+        private void RefundQuota()
+        {
+            lock (_lock)
+                _quotaUsed = Math.Max(0, _quotaUsed - 1);
+            _bucket.Refund(1);
+        }
+
+        private async Task WaitForTokenAsync(CancellationToken ct)
+        {
+            var wait = _bucket.Reserve(1);
+            if (wait > TimeSpan.Zero)
+                await Task.Delay(wait, ct);
+        }
+
+        public void Dispose()
+        {
+            List<PendingLookup> abandoned;
+            lock (_lock)
+            {
+                if (_disposed)
+                    return;
+                _disposed = true;
+                abandoned = _pending.Values.Where(p => !p.Dispatched).ToList();
+            }
+
+            _stopping.Cancel();
+            try
+            {
+                _dispatcher.Wait(TimeSpan.FromSeconds(2));
+            }
+            catch (AggregateException)
+            {
+                // الحلقة تنتهي بالإلغاء
+            }
+
+            foreach (var lookup in abandoned)
+                lookup.Completion.TrySetResult(VTScanResult.Error("تم إيقاف مجدول VirusTotal"));
+
+            _stopping.Dispose();
+            _signal.Dispose();
+        }
+
+        private sealed class PendingLookup
+        {
+            public PendingLookup(string sha256, string? filePath)
+            {
+                Sha256 = sha256;
+                FilePath = filePath;
+            }
+
+            public string Sha256 { get; }
+            public string? FilePath { get; set; }
+            public int RiskScore { get; set; }
+            public long Sequence { get; set; }
+            public bool Dispatched { get; set; }
+
+            public TaskCompletionSource<VTScanResult> Completion { get; } =
+                new(TaskCreationOptions.RunContinuationsAsynchronously);
+        }
+
+        private sealed class QuotaExceededException : Exception
+        {
+        }
+    }
+}
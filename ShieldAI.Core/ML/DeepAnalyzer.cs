@@ -194,7 +194,12 @@ namespace ShieldAI.Core.ML
 
             try
             {
-                var vtResult = await _vtClient.ScanFileAsync(result.FilePath, cancellationToken);
+                // الملفات الأخطر محلياً تتقدم في طابور الحصة
+                var localRisk = Math.Max(
+                    result.HeuristicResult?.TotalScore ?? 0,
+                    (int)((result.MLPrediction?.Probability ?? 0) * 100));
+                var vtResult = await _vtClient.ScanFileAsync(
+                    result.FilePath, null, Math.Clamp(localRisk, 0, 100), cancellationToken);
                 result.VirusTotalResult = vtResult;
 
                 if (vtResult.IsThreat)
@@ -1,3 +1,5 @@
+using ShieldAI.Core.Scanning;
+
 namespace ShieldAI.Core.Models;
 
 /// <summary>
@@ -206,6 +208,11 @@ public class PEFileInfo
     /// هل يحتوي على توقيع رقمي
     /// </summary>
     public bool HasDigitalSignature { get; set; }
+
+    /// <summary>
+    /// تفاصيل توقيع Authenticode (الموقّع، السلسلة، سلامة البصمة)
+    /// </summary>
+    public AuthenticodeSignature? Signature { get; set; }
     
     /// <summary>
     /// بصمة SHA256
@@ -69,20 +69,74 @@ namespace ShieldAI.Core.Models
         public DateTime? StartedAt { get; set; }
         public DateTime? CompletedAt { get; set; }
         
-        // الإحصائيات
-        public int TotalFiles { get; set; }
-        public int ScannedFiles { get; set; }
-        public int ThreatsFound { get; set; }
-        public int ErrorCount { get; set; }
+        // الإحصائيات - عدادات ذرية لأن عمال الفحص يحدثونها بالتوازي
+        private int _totalFiles;
+        private int _scannedFiles;
+        private int _threatsFound;
+        private int _errorCount;
+
+        public int TotalFiles
+        {
+            get => Volatile.Read(ref _totalFiles);
+            set => Volatile.Write(ref _totalFiles, value);
+        }
+
+        public int ScannedFiles
+        {
+            get => Volatile.Read(ref _scannedFiles);
+            set => Volatile.Write(ref _scannedFiles, value);
+        }
+
+        public int ThreatsFound
+        {
+            get => Volatile.Read(ref _threatsFound);
+            set => Volatile.Write(ref _threatsFound, value);
+        }
+
+        public int ErrorCount
+        {
+            get => Volatile.Read(ref _errorCount);
+            set => Volatile.Write(ref _errorCount, value);
+        }
+
         public string? CurrentFile { get; set; }
+
+        public int IncrementScannedFiles() => Interlocked.Increment(ref _scannedFiles);
+        public int IncrementThreatsFound() => Interlocked.Increment(ref _threatsFound);
+        public int IncrementErrorCount() => Interlocked.Increment(ref _errorCount);
         
         // الإعدادات
         public bool UseVirusTotal { get; set; }
         public bool DeepScan { get; set; }
+        public bool ScanArchives { get; set; }
+        public bool ScanHiddenFiles { get; set; } = true;
+        public int MaxDepth { get; set; } = -1;
         
         public double ProgressPercent => TotalFiles > 0 
             ? (double)ScannedFiles / TotalFiles * 100 
             : 0;
+
+        /// <summary>
+        /// لقطة متسقة من التقدم (التهديدات لا تتجاوز الملفات المفحوصة)
+        /// </summary>
+        public ScanProgressEventArgs CreateProgressSnapshot()
+        {
+            // التهديد يُحتسب بعد الملف، لذا نقرأ التهديدات أولاً
+            int threats = ThreatsFound;
+            int scanned = ScannedFiles;
+            int total = TotalFiles;
+
+            return new ScanProgressEventArgs
+            {
+                JobId = Id,
+                TotalFiles = total,
+                ScannedFiles = scanned,
+                ThreatsFound = threats,
+                CurrentFile = CurrentFile,
+                ProgressPercent = total > 0 ? (double)scanned / total * 100 : 0,
+                Status = Status
+            };
+        }
     }
 
     /// <summary>
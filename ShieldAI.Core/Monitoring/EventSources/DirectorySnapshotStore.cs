@@ -0,0 +1,355 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/DirectorySnapshotStore.cs
+// لقطة مضغوطة للمجلدات المراقبة لاستعادة الأحداث المفقودة
+// =====================================================
+
+using System.Collections.Concurrent;
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// لقطة مضغوطة لكل مجلد: hash الاسم (64 بت) ← (الحجم، وقت التعديل).
+    /// لا تُخزَّن الأسماء - المقارنة تعيد تعداد المجلد فتعرف الأسماء الحالية،
+    /// والملفات المحذوفة لا تحتاج فحصاً.
+    /// </summary>
+    public class DirectorySnapshotStore
+    {
+        private static readonly StringComparer PathComparer =
+            OperatingSystem.IsWindows() ? StringComparer.OrdinalIgnoreCase : StringComparer.Ordinal;
+
+        private static readonly EnumerationOptions SubtreeOptions = new()
+        {
+            RecurseSubdirectories = true,
+            IgnoreInaccessible = true,
+            AttributesToSkip = FileAttributes.ReparsePoint
+        };
+
+        private static readonly EnumerationOptions FlatOptions = new()
+        {
+            RecurseSubdirectories = false,
+            IgnoreInaccessible = true,
+            AttributesToSkip = FileAttributes.ReparsePoint
+        };
+
+        private readonly ConcurrentDictionary<string, DirectoryState> _directories = new(PathComparer);
+        private readonly ConcurrentDictionary<string, DateTime> _lastSync = new(PathComparer);
+        private readonly int _maxFiles;
+        private int _fileCount;
+        private volatile bool _truncated;
+
+        /// <param name="maxFiles">أقصى عدد ملفات في اللقطة (حد الذاكرة)</param>
+        public DirectorySnapshotStore(int maxFiles = 1_000_000)
+        {
+            _maxFiles = Math.Max(1, maxFiles);
+        }
+
+        /// <summary>
+        /// عدد الملفات في اللقطة
+        /// </summary>
+        public int FileCount => Volatile.Read(ref _fileCount);
+
+        /// <summary>
+        /// عدد المجلدات في اللقطة
+        /// </summary>
+        public int DirectoryCount => _directories.Count;
+
+        /// <summary>
+        /// بلغت اللقطة حدها - مجلدات خارجها تُقارن بوقت التعديل فقط
+        /// </summary>
+        public bool IsTruncated => _truncated;
+
+        /// <summary>
+        /// التقاط شجرة مجلد كاملة
+        /// </summary>
+        public void Capture(string root, CancellationToken ct = default)
+        {
+            root = NormalizeDirectory(root);
+            var started = DateTime.UtcNow;
+
+            foreach (var directory in EnumerateTree(root))
+            {
+                ct.ThrowIfCancellationRequested();
+
+                var entries = ReadDirectory(directory);
+                if (entries == null) continue;
+
+                ReplaceDirectory(directory, entries);
+            }
+
+            _lastSync[root] = started;
+        }
+
+        /// <summary>
+        /// تحديث ختم ملف واحد بعد حدث مُسلَّم (حتى لا يُعاد اكتشافه عند الفيضان)
+        /// </summary>
+        public void Record(string filePath)
+        {
+            var directory = Path.GetDirectoryName(filePath);
+            if (string.IsNullOrEmpty(directory)) return;
+
+            var hash = HashName(Path.GetFileName(filePath));
+
+            FileStamp? stamp = null;
+            try
+            {
+                var info = new FileInfo(filePath);
+                if (info.Exists)
+                    stamp = new FileStamp(info.Length, info.LastWriteTimeUtc.Ticks);
+            }
+            catch
+            {
+                return;
+            }
+
+            if (!_directories.TryGetValue(directory, out var state))
+            {
+                if (stamp == null || _truncated) return;
+
+                state = _directories.GetOrAdd(directory, _ => new DirectoryState());
+            }
+
+            lock (state)
+            {
+                if (stamp == null)
+                {
+                    if (state.Files.Remove(hash))
+                        Interlocked.Decrement(ref _fileCount);
+                    return;
+                }
+
+                if (!state.Files.ContainsKey(hash))
+                {
+                    if (!TryReserve(1)) return;
+                }
+
+                state.Files[hash] = stamp.Value;
+            }
+        }
+
+        /// <summary>
+        /// مقارنة شجرة باللقطة وتحديثها - يُعيد الملفات الجديدة أو المعدّلة فقط
+        /// </summary>
+        public IReadOnlyList<string> DiffAndRefresh(string subtreeRoot, CancellationToken ct = default)
+        {
+            subtreeRoot = NormalizeDirectory(subtreeRoot);
+            var started = DateTime.UtcNow;
+            var changed = new List<string>();
+
+            // الملفات خارج اللقطة المقطوعة: ما عُدّل بعد آخر مزامنة (مع هامش دقة الوقت)
+            var since = GetLastSync(subtreeRoot).AddSeconds(-2).Ticks;
+            var seen = new HashSet<string>(PathComparer);
+
+            foreach (var directory in EnumerateTree(subtreeRoot))
+            {
+                ct.ThrowIfCancellationRequested();
+                seen.Add(directory);
+
+                var current = ReadDirectory(directory);
+                if (current == null) continue;
+
+                if (_directories.TryGetValue(directory, out var previous))
+                {
+                    lock (previous)
+                    {
+                        foreach (var (path, hash, stamp) in current)
+                        {
+                            if (!previous.Files.TryGetValue(hash, out var old) || old != stamp)
+                                changed.Add(path);
+                        }
+                    }
+                }
+                else
+                {
+                    // مجلد لم يصله أي حدث: كله جديد، إلا إذا كانت اللقطة مقطوعة
+                    foreach (var (path, _, stamp) in current)
+                    {
+                        if (!_truncated || stamp.ModifiedTicks >= since)
+                            changed.Add(path);
+                    }
+                }
+
+                ReplaceDirectory(directory, current);
+            }
+
+            // مجلدات حُذفت
+            foreach (var directory in _directories.Keys)
+            {
+                if (!seen.Contains(directory) && IsUnder(directory, subtreeRoot))
+                    RemoveDirectory(directory);
+            }
+
+            _lastSync[subtreeRoot] = started;
+            return changed;
+        }
+
+        /// <summary>
+        /// مسح اللقطة
+        /// </summary>
+        public void Clear()
+        {
+            _directories.Clear();
+            _lastSync.Clear();
+            Interlocked.Exchange(ref _fileCount, 0);
+            _truncated = false;
+        }
+
+        private IEnumerable<string> EnumerateTree(string root)
+        {
+            if (!Directory.Exists(root))
+                yield break;
+
+            yield return root;
+
+            IEnumerator<string> enumerator;
+            try
+            {
+                enumerator = Directory.EnumerateDirectories(root, "*", SubtreeOptions).GetEnumerator();
+            }
+            catch
+            {
+                yield break;
+            }
+
+            using (enumerator)
+            {
+                while (true)
+                {
+                    try
+                    {
+                        if (!enumerator.MoveNext()) break;
+                    }
+                    catch
+                    {
+                        break;
+                    }
+
+                    yield return enumerator.Current;
+                }
+            }
+        }
+
+        /// <summary>
+        /// تعداد ملفات مجلد واحد - الحجم ووقت التعديل يأتيان من التعداد نفسه
+        /// </summary>
+        private static List<(string Path, ulong Hash, FileStamp Stamp)>? ReadDirectory(string directory)
+        {
+            try
+            {
+                var entries = new List<(string, ulong, FileStamp)>();
+                foreach (var file in new DirectoryInfo(directory).EnumerateFiles("*", FlatOptions))
+                {
+                    entries.Add((file.FullName, HashName(file.Name),
+                        new FileStamp(file.Length, file.LastWriteTimeUtc.Ticks)));
+                }
+                return entries;
+            }
+            catch
+            {
+                return null;
+            }
+        }
+
+        private void ReplaceDirectory(string directory, List<(string Path, ulong Hash, FileStamp Stamp)> entries)
+        {
+            var state = _directories.GetOrAdd(directory, _ => new DirectoryState());
+            lock (state)
+            {
+                var delta = entries.Count - state.Files.Count;
+                if (delta > 0 && !TryReserve(delta))
+                {
+                    // بلا مكان: نُبقي المجلد خارج اللقطة (سيُقارن بوقت التعديل)
+                    Interlocked.Add(ref _fileCount, -state.Files.Count);
+                    state.Files.Clear();
+                    _directories.TryRemove(new KeyValuePair<string, DirectoryState>(directory, state));
+                    return;
+                }
+
+                if (delta < 0)
+                    Interlocked.Add(ref _fileCount, delta);
+
+                state.Files.Clear();
+                foreach (var (_, hash, stamp) in entries)
+                    state.Files[hash] = stamp;
+            }
+        }
+
+        private void RemoveDirectory(string directory)
+        {
+            if (_directories.TryRemove(directory, out var state))
+            {
+                lock (state)
+                {
+                    Interlocked.Add(ref _fileCount, -state.Files.Count);
+                    state.Files.Clear();
+                }
+            }
+        }
+
+        private bool TryReserve(int count)
+        {
+            if (Interlocked.Add(ref _fileCount, count) <= _maxFiles)
+                return true;
+
+            Interlocked.Add(ref _fileCount, -count);
+            _truncated = true;
+            return false;
+        }
+
+        private DateTime GetLastSync(string root)
+        {
+            var best = DateTime.MinValue;
+            foreach (var (syncedRoot, time) in _lastSync)
+            {
+                if (IsUnder(root, syncedRoot) && time > best)
+                    best = time;
+            }
+            return best;
+        }
+
+        private static bool IsUnder(string path, string root)
+        {
+            if (path.Length < root.Length || !path.StartsWith(root, OperatingSystem.IsWindows()
+                    ? StringComparison.OrdinalIgnoreCase
+                    : StringComparison.Ordinal))
+                return false;
+
+            return path.Length == root.Length ||
+                   root.EndsWith(Path.DirectorySeparatorChar) ||
+                   path[root.Length] == Path.DirectorySeparatorChar;
+        }
+
+        private static string NormalizeDirectory(string path)
+        {
+            var full = Path.GetFullPath(path);
+            var trimmed = full.TrimEnd(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar);
+            return trimmed.Length == 0 || trimmed.EndsWith(Path.VolumeSeparatorChar) ? full : trimmed;
+        }
+
+        /// <summary>
+        /// FNV-1a 64 على اسم الملف (بدون حساسية حالة على Windows)
+        /// </summary>
+        private static ulong HashName(string name)
+        {
+            const ulong offset = 14695981039346656037;
+            const ulong prime = 1099511628211;
+            var ignoreCase = OperatingSystem.IsWindows();
+
+            var hash = offset;
+            foreach (var c in name)
+            {
+                var ch = ignoreCase ? char.ToUpperInvariant(c) : c;
+                hash = (hash ^ (byte)ch) * prime;
+                hash = (hash ^ (byte)(ch >> 8)) * prime;
+            }
+            return hash;
+        }
+
+        private readonly record struct FileStamp(long Length, long ModifiedTicks);
+
+        private sealed class DirectoryState
+        {
+            public readonly Dictionary<ulong, FileStamp> Files = new();
+        }
+    }
+}
@@ -0,0 +1,285 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/FanotifyEventSource.cs
+// مصدر أحداث fanotify على مستوى نقطة التركيب (يحتاج CAP_SYS_ADMIN)
+// =====================================================
+
+using System.Runtime.InteropServices;
+using Microsoft.Extensions.Logging;
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// مصدر أحداث fanotify: علامة واحدة لكل نقطة تركيب بدل watch لكل مجلد،
+    /// وكل حدث يحمل PID العملية الكاتبة (يُملأ في ThreatScanContext.OriginProcessId).
+    /// fanotify بدون FID لا يبلّغ عن إعادة التسمية، لذلك يرافقه inotify للنقل فقط.
+    /// </summary>
+    public class FanotifyEventSource : IFileEventSource
+    {
+        /// <summary>
+        /// حجم مخزن القراءة من واصف fanotify
+        /// </summary>
+        public const int ReadBufferSize = 256 * 1024;
+
+        // struct fanotify_event_metadata
+        private const int MetadataSize = 24;
+        private const int PollTimeoutMs = 250;
+
+        private readonly ILogger? _logger;
+        private readonly InotifyEventSource? _renameSource;
+        private readonly List<string> _roots = new();
+        private readonly int _selfPid = Environment.ProcessId;
+        private int _fd = -1;
+        private Thread? _reader;
+        private volatile bool _stopping;
+        private long _foreignEvents;
+        private bool _disposed;
+
+        public string Name => "fanotify";
+        public int WatchedRootCount => _roots.Count;
+
+        /// <summary>
+        /// أحداث من نفس نقطة التركيب خارج المجلدات المراقبة (تُتجاهل)
+        /// </summary>
+        public long ForeignEventCount => Interlocked.Read(ref _foreignEvents);
+
+        public event EventHandler<FileEventSourceArgs>? FileChanged;
+        public event EventHandler<ErrorEventArgs>? Error;
+
+        /// <param name="renameSource">مصدر inotify للنقل/إعادة التسمية (null = بدون)</param>
+        public FanotifyEventSource(ILogger? logger = null, InotifyEventSource? renameSource = null)
+        {
+            _logger = logger;
+            _renameSource = renameSource;
+
+            if (_renameSource != null)
+            {
+                _renameSource.FileChanged += (_, e) => FileChanged?.Invoke(this, e);
+                _renameSource.Error += (_, e) => Error?.Invoke(this, e);
+            }
+        }
+
+        /// <summary>
+        /// هل يمكن إنشاء fanotify في هذه العملية (Linux + صلاحية CAP_SYS_ADMIN)
+        /// </summary>
+        public static bool IsAvailable()
+        {
+            if (!OperatingSystem.IsLinux())
+                return false;
+
+            try
+            {
+                var fd = LinuxNative.fanotify_init(
+                    LinuxNative.FAN_CLASS_NOTIF | LinuxNative.FAN_CLOEXEC | LinuxNative.FAN_NONBLOCK,
+                    LinuxNative.O_RDONLY | LinuxNative.O_CLOEXEC);
+                if (fd < 0) return false;
+
+                LinuxNative.close(fd);
+                return true;
+            }
+            catch
+            {
+                return false;
+            }
+        }
+
+        public void Start(IEnumerable<string> paths)
+        {
+            if (!OperatingSystem.IsLinux())
+                throw new PlatformNotSupportedException("fanotify متاح على Linux فقط");
+
+            if (_fd >= 0) return;
+
+            _fd = LinuxNative.fanotify_init(
+                LinuxNative.FAN_CLASS_NOTIF | LinuxNative.FAN_CLOEXEC | LinuxNative.FAN_NONBLOCK,
+                LinuxNative.O_RDONLY | LinuxNative.O_CLOEXEC);
+            if (_fd < 0)
+                throw new UnauthorizedAccessException($"fanotify_init failed (errno {Marshal.GetLastPInvokeError()})");
+
+            var pathList = paths.ToList();
+            foreach (var path in pathList)
+            {
+                if (!Directory.Exists(path))
+                {
+                    _logger?.LogWarning("مجلد المراقبة غير موجود: {Path}", path);
+                    continue;
+                }
+
+                var root = Path.GetFullPath(path);
+
+                // علامة على نقطة التركيب كاملة - تكرار نفس التركيب لا يضر
+                if (LinuxNative.fanotify_mark(_fd, LinuxNative.FAN_MARK_ADD | LinuxNative.FAN_MARK_MOUNT,
+                        LinuxNative.FAN_CLOSE_WRITE, LinuxNative.AT_FDCWD, root) < 0)
+                {
+                    _logger?.LogWarning("فشل fanotify_mark (errno {Errno}): {Path}",
+                        Marshal.GetLastPInvokeError(), root);
+                    continue;
+                }
+
+                _roots.Add(root.Length > 1 ? root.TrimEnd(Path.DirectorySeparatorChar) : root);
+                _logger?.LogInformation("مراقبة ({Source}): {Path}", Name, root);
+            }
+
+            if (_roots.Count == 0)
+            {
+                LinuxNative.close(_fd);
+                _fd = -1;
+                throw new IOException("fanotify: no mount could be marked");
+            }
+
+            _renameSource?.Start(_roots);
+
+            _stopping = false;
+            _reader = new Thread(ReadLoop)
+            {
+                IsBackground = true,
+                Name = "ShieldAI-fanotify"
+            };
+            _reader.Start();
+        }
+
+        public void Stop()
+        {
+            _renameSource?.Stop();
+
+            if (_fd < 0) return;
+
+            _stopping = true;
+            _reader?.Join(PollTimeoutMs * 8);
+            _reader = null;
+
+            LinuxNative.close(_fd);
+            _fd = -1;
+            _roots.Clear();
+        }
+
+        private void ReadLoop()
+        {
+            var buffer = new byte[ReadBufferSize];
+            var linkBuffer = new byte[4096];
+
+            while (!_stopping)
+            {
+                try
+                {
+                    if (!LinuxNative.WaitReadable(_fd, PollTimeoutMs))
+                        continue;
+
+                    var length = LinuxNative.read(_fd, buffer, buffer.Length);
+                    if (length <= 0)
+                    {
+                        var errno = Marshal.GetLastPInvokeError();
+                        if (length < 0 && errno != LinuxNative.EAGAIN && errno != LinuxNative.EINTR)
+                        {
+                            RaiseError(new IOException($"fanotify read failed (errno {errno})"));
+                            Thread.Sleep(PollTimeoutMs);
+                        }
+                        continue;
+                    }
+
+                    ParseEvents(buffer, (int)length, linkBuffer);
+                }
+                catch (Exception ex)
+                {
+                    _logger?.LogDebug(ex, "خطأ في قراءة أحداث fanotify");
+                }
+            }
+        }
+
+        /// <summary>
+        /// struct fanotify_event_metadata { u32 event_len; u8 vers; u8 reserved; u16 metadata_len;
+        /// u64 mask; s32 fd; s32 pid; }
+        /// </summary>
+        private void ParseEvents(byte[] buffer, int length, byte[] linkBuffer)
+        {
+            int offset = 0;
+            while (offset + MetadataSize <= length)
+            {
+                var eventLength = (int)BitConverter.ToUInt32(buffer, offset);
+                var version = buffer[offset + 4];
+                var mask = BitConverter.ToUInt64(buffer, offset + 8);
+                var fd = BitConverter.ToInt32(buffer, offset + 16);
+                var pid = BitConverter.ToInt32(buffer, offset + 20);
+
+                if (eventLength < MetadataSize || version != LinuxNative.FANOTIFY_METADATA_VERSION)
+                {
+                    if (fd >= 0) LinuxNative.close(fd);
+                    RaiseError(new IOException($"fanotify: unexpected metadata version {version}"));
+                    return;
+                }
+
+                offset += eventLength;
+
+                if ((mask & LinuxNative.FAN_Q_OVERFLOW) != 0)
+                {
+                    RaiseError(new EventSourceOverflowException("fanotify queue overflow - events were lost"));
+                    continue;
+                }
+
+                if (fd == LinuxNative.FAN_NOFD)
+                    continue;
+
+                string? path;
+                try
+                {
+                    path = LinuxNative.ResolveFdPath(fd, linkBuffer);
+                }
+                finally
+                {
+                    // كل حدث يحمل واصفاً مفتوحاً - يجب إغلاقه دائماً
+                    LinuxNative.close(fd);
+                }
+
+                // كتابات الخدمة نفسها (الحجر، السجلات) ليست أحداثاً للفحص
+                if (path == null || pid == _selfPid)
+                    continue;
+
+                if (path.EndsWith(" (deleted)", StringComparison.Ordinal))
+                    continue;
+
+                if (!IsUnderRoots(path))
+                {
+                    Interlocked.Increment(ref _foreignEvents);
+                    continue;
+                }
+
+                try
+                {
+                    FileChanged?.Invoke(this, new FileEventSourceArgs(path, WatcherChangeTypes.Changed, pid));
+                }
+                catch (Exception ex)
+                {
+                    _logger?.LogDebug(ex, "فشل معالج حدث الملف: {Path}", path);
+                }
+            }
+        }
+
+        private bool IsUnderRoots(string path)
+        {
+            foreach (var root in _roots)
+            {
+                if (root == "/")
+                    return true;
+
+                if (path.StartsWith(root, StringComparison.Ordinal) &&
+                    (path.Length == root.Length || path[root.Length] == Path.DirectorySeparatorChar))
+                    return true;
+            }
+
+            return false;
+        }
+
+        private void RaiseError(Exception ex)
+        {
+            try { Error?.Invoke(this, new ErrorEventArgs(ex)); } catch { }
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+            Stop();
+            _renameSource?.Dispose();
+        }
+    }
+}
@@ -0,0 +1,110 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/FileEventSourceFactory.cs
+// اختيار مصدر الأحداث حسب المنصة والصلاحيات
+// =====================================================
+
+using Microsoft.Extensions.Logging;
+using ShieldAI.Core.Configuration;
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// إنشاء مصدر الأحداث المناسب:
+    /// Linux: fanotify (بصلاحيات) ثم inotify بطابور مكبّر؛ غير ذلك: FileSystemWatcher
+    /// </summary>
+    public static class FileEventSourceFactory
+    {
+        /// <summary>
+        /// النوع الفعلي بعد تطبيق Auto والرجوع عند عدم التوفر
+        /// </summary>
+        public static RealtimeEventSourceKind Resolve(RealtimeEventSourceKind requested, Func<bool>? fanotifyAvailable = null)
+        {
+            var isLinux = OperatingSystem.IsLinux();
+            fanotifyAvailable ??= FanotifyEventSource.IsAvailable;
+
+            switch (requested)
+            {
+                case RealtimeEventSourceKind.FileSystemWatcher:
+                    return RealtimeEventSourceKind.FileSystemWatcher;
+
+                case RealtimeEventSourceKind.Inotify:
+                    return isLinux ? RealtimeEventSourceKind.Inotify : RealtimeEventSourceKind.FileSystemWatcher;
+
+                case RealtimeEventSourceKind.Fanotify:
+                case RealtimeEventSourceKind.Auto:
+                default:
+                    if (!isLinux)
+                        return RealtimeEventSourceKind.FileSystemWatcher;
+
+                    return fanotifyAvailable()
+                        ? RealtimeEventSourceKind.Fanotify
+                        : RealtimeEventSourceKind.Inotify;
+            }
+        }
+
+        public static IFileEventSource Create(AppSettings settings, ILogger? logger = null)
+        {
+            var kind = Resolve(settings.RealtimeEventSource);
+
+            if (kind != settings.RealtimeEventSource && settings.RealtimeEventSource != RealtimeEventSourceKind.Auto)
+            {
+                logger?.LogWarning("مصدر الأحداث {Requested} غير متاح - استخدام {Actual}",
+                    settings.RealtimeEventSource, kind);
+            }
+
+            return kind switch
+            {
+                RealtimeEventSourceKind.Fanotify => new FanotifyEventSource(
+                    logger,
+                    new InotifyEventSource(logger, settings.InotifyMaxQueuedEvents,
+                        settings.InotifyMaxUserWatches, renamesOnly: true)),
+
+                RealtimeEventSourceKind.Inotify => new InotifyEventSource(
+                    logger, settings.InotifyMaxQueuedEvents, settings.InotifyMaxUserWatches),
+
+                _ => new FileSystemWatcherEventSource(logger, settings.WatcherBufferSizeKB)
+            };
+        }
+
+        /// <summary>
+        /// إنشاء وربط وبدء المصدر؛ إذا فشل البدء (علامة fanotify مرفوضة، inotify_init...)
+        /// يُجرَّب المصدر التالي: fanotify ثم inotify ثم FileSystemWatcher
+        /// </summary>
+        public static IFileEventSource StartWithFallback(
+            AppSettings settings,
+            IEnumerable<string> paths,
+            EventHandler<FileEventSourceArgs> onFileChanged,
+            EventHandler<ErrorEventArgs> onError,
+            ILogger? logger = null)
+        {
+            var pathList = paths.ToList();
+            var source = Create(settings, logger);
+
+            while (true)
+            {
+                source.FileChanged += onFileChanged;
+                source.Error += onError;
+
+                try
+                {
+                    source.Start(pathList);
+                    logger?.LogInformation("مصدر أحداث الحماية الفورية: {Source}", source.Name);
+                    return source;
+                }
+                catch (Exception ex) when (source is not FileSystemWatcherEventSource)
+                {
+                    logger?.LogWarning(ex, "فشل بدء مصدر الأحداث {Source} - الرجوع للتالي", source.Name);
+
+                    source.FileChanged -= onFileChanged;
+                    source.Error -= onError;
+                    source.Dispose();
+
+                    source = source is FanotifyEventSource
+                        ? new InotifyEventSource(logger, settings.InotifyMaxQueuedEvents, settings.InotifyMaxUserWatches)
+                        : new FileSystemWatcherEventSource(logger, settings.WatcherBufferSizeKB);
+                }
+            }
+        }
+    }
+}
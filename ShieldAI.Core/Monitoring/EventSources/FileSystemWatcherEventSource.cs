@@ -0,0 +1,122 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/FileSystemWatcherEventSource.cs
+// مصدر أحداث مبني على FileSystemWatcher (Windows والافتراضي)
+// =====================================================
+
+using Microsoft.Extensions.Logging;
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// مصدر أحداث FileSystemWatcher - watcher لكل مجلد جذري
+    /// بمخزن داخلي مكبّر (الافتراضي 8KB يفيض بسرعة تحت عواصف الكتابة)
+    /// </summary>
+    public class FileSystemWatcherEventSource : IFileEventSource
+    {
+        /// <summary>
+        /// أقصى حجم يقبله ReadDirectoryChangesW على مسارات الشبكة
+        /// </summary>
+        public const int MaxBufferSize = 64 * 1024;
+
+        private readonly ILogger? _logger;
+        private readonly int _bufferSize;
+        private readonly List<FileSystemWatcher> _watchers = new();
+        private bool _disposed;
+
+        public string Name => "FileSystemWatcher";
+        public int WatchedRootCount => _watchers.Count;
+
+        public event EventHandler<FileEventSourceArgs>? FileChanged;
+        public event EventHandler<ErrorEventArgs>? Error;
+
+        public FileSystemWatcherEventSource(ILogger? logger = null, int bufferSizeKB = 64)
+        {
+            _logger = logger;
+            _bufferSize = Math.Clamp(bufferSizeKB * 1024, 4 * 1024, MaxBufferSize);
+        }
+
+        public void Start(IEnumerable<string> paths)
+        {
+            foreach (var path in paths)
+            {
+                try
+                {
+                    if (!Directory.Exists(path))
+                    {
+                        _logger?.LogWarning("مجلد المراقبة غير موجود: {Path}", path);
+                        continue;
+                    }
+
+                    var watcher = new FileSystemWatcher(path)
+                    {
+                        IncludeSubdirectories = true,
+                        InternalBufferSize = _bufferSize,
+                        NotifyFilter = NotifyFilters.FileName |
+                                       NotifyFilters.LastWrite |
+                                       NotifyFilters.CreationTime,
+                        EnableRaisingEvents = false
+                    };
+
+                    watcher.Created += OnFileEvent;
+                    watcher.Changed += OnFileEvent;
+                    watcher.Renamed += OnFileRenamed;
+                    watcher.Error += OnWatcherError;
+
+                    watcher.EnableRaisingEvents = true;
+                    _watchers.Add(watcher);
+
+                    _logger?.LogInformation("مراقبة: {Path}", path);
+                }
+                catch (Exception ex)
+                {
+                    _logger?.LogError(ex, "فشل إنشاء watcher: {Path}", path);
+                }
+            }
+        }
+
+        public void Stop()
+        {
+            foreach (var watcher in _watchers)
+            {
+                try
+                {
+                    watcher.EnableRaisingEvents = false;
+                    watcher.Dispose();
+                }
+                catch { }
+            }
+
+            _watchers.Clear();
+        }
+
+        private void OnFileEvent(object sender, FileSystemEventArgs e)
+        {
+            FileChanged?.Invoke(this, new FileEventSourceArgs(e.FullPath, e.ChangeType));
+        }
+
+        private void OnFileRenamed(object sender, RenamedEventArgs e)
+        {
+            FileChanged?.Invoke(this, new FileEventSourceArgs(e.FullPath, WatcherChangeTypes.Renamed));
+        }
+
+        private void OnWatcherError(object sender, ErrorEventArgs e)
+        {
+            // الفيضان يخص هذا الـ watcher فقط - نحدد الجذر لتقتصر الاستعادة عليه
+            if (e.GetException() is InternalBufferOverflowException overflow and not EventSourceOverflowException)
+            {
+                var root = (sender as FileSystemWatcher)?.Path;
+                e = new ErrorEventArgs(new EventSourceOverflowException(overflow.Message, root));
+            }
+
+            Error?.Invoke(this, e);
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+            Stop();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/IFileEventSource.cs
+// واجهة مصدر أحداث الملفات للحماية الفورية
+// =====================================================
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// حدث ملف من مصدر الأحداث
+    /// </summary>
+    public class FileEventSourceArgs : EventArgs
+    {
+        public string FullPath { get; }
+        public WatcherChangeTypes ChangeType { get; }
+
+        /// <summary>
+        /// العملية التي سببت الحدث (fanotify فقط)
+        /// </summary>
+        public int? OriginProcessId { get; }
+
+        public FileEventSourceArgs(string fullPath, WatcherChangeTypes changeType, int? originProcessId = null)
+        {
+            FullPath = fullPath;
+            ChangeType = changeType;
+            OriginProcessId = originProcessId;
+        }
+    }
+
+    /// <summary>
+    /// مصدر أحداث ملفات قابل للاستبدال (FileSystemWatcher / fanotify / inotify)
+    /// </summary>
+    public interface IFileEventSource : IDisposable
+    {
+        /// <summary>
+        /// اسم المصدر للسجلات والحالة
+        /// </summary>
+        string Name { get; }
+
+        /// <summary>
+        /// عدد المجلدات الجذرية المراقبة فعلياً
+        /// </summary>
+        int WatchedRootCount { get; }
+
+        /// <summary>
+        /// يُطلق من خيط المصدر - يجب أن يكون المعالج سريعاً
+        /// </summary>
+        event EventHandler<FileEventSourceArgs>? FileChanged;
+
+        /// <summary>
+        /// خطأ في المصدر (EventSourceOverflowException عند فقدان أحداث)
+        /// </summary>
+        event EventHandler<ErrorEventArgs>? Error;
+
+        /// <summary>
+        /// بدء المراقبة - المسارات غير الموجودة تُتجاهل
+        /// </summary>
+        void Start(IEnumerable<string> paths);
+
+        /// <summary>
+        /// إيقاف المراقبة
+        /// </summary>
+        void Stop();
+    }
+}
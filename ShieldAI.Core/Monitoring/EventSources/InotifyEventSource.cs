@@ -0,0 +1,352 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/InotifyEventSource.cs
+// مصدر أحداث inotify أصلي على Linux
+// =====================================================
+
+using System.Runtime.InteropServices;
+using System.Text;
+using Microsoft.Extensions.Logging;
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// مصدر أحداث inotify: watch لكل مجلد (inotify غير تكراري)،
+    /// IN_CLOSE_WRITE بدل كل كتابة جزئية، ومخزن قراءة 256KB على خيط مخصص.
+    /// لا يحتاج صلاحيات - البديل عندما لا يتوفر fanotify.
+    /// </summary>
+    public class InotifyEventSource : IFileEventSource
+    {
+        /// <summary>
+        /// حجم مخزن القراءة من واصف inotify
+        /// </summary>
+        public const int ReadBufferSize = 256 * 1024;
+
+        private const int EventHeaderSize = 16;
+        private const int PollTimeoutMs = 250;
+
+        private const uint WatchFlags = LinuxNative.IN_ONLYDIR | LinuxNative.IN_DONT_FOLLOW | LinuxNative.IN_EXCL_UNLINK;
+        private const uint FullMask = WatchFlags | LinuxNative.IN_CLOSE_WRITE | LinuxNative.IN_CREATE |
+                                      LinuxNative.IN_MOVED_TO | LinuxNative.IN_DELETE_SELF;
+        private const uint RenamesMask = WatchFlags | LinuxNative.IN_CREATE | LinuxNative.IN_MOVED_TO |
+                                         LinuxNative.IN_DELETE_SELF;
+
+        private const string MaxQueuedEventsPath = "/proc/sys/fs/inotify/max_queued_events";
+        private const string MaxUserWatchesPath = "/proc/sys/fs/inotify/max_user_watches";
+
+        private readonly ILogger? _logger;
+        private readonly int _maxQueuedEvents;
+        private readonly int _maxUserWatches;
+        private readonly bool _renamesOnly;
+        private readonly uint _mask;
+        private readonly Dictionary<int, string> _watches = new();
+        private readonly object _lock = new();
+        private readonly List<string> _roots = new();
+        private int _fd = -1;
+        private Thread? _reader;
+        private volatile bool _stopping;
+        private bool _watchLimitReported;
+        private bool _disposed;
+
+        public string Name => _renamesOnly ? "inotify (renames)" : "inotify";
+        public int WatchedRootCount => _roots.Count;
+
+        /// <summary>
+        /// عدد المجلدات المراقبة (watch descriptors)
+        /// </summary>
+        public int WatchCount
+        {
+            get { lock (_lock) return _watches.Count; }
+        }
+
+        public static bool IsSupported => OperatingSystem.IsLinux();
+
+        public event EventHandler<FileEventSourceArgs>? FileChanged;
+        public event EventHandler<ErrorEventArgs>? Error;
+
+        /// <param name="maxQueuedEvents">رفع fs.inotify.max_queued_events قبل الإنشاء إن أمكن (0 = بدون تعديل)</param>
+        /// <param name="maxUserWatches">رفع fs.inotify.max_user_watches إن أمكن (0 = بدون تعديل)</param>
+        /// <param name="renamesOnly">الإبلاغ عن النقل/إعادة التسمية فقط (مكمّل لـ fanotify)</param>
+        public InotifyEventSource(
+            ILogger? logger = null,
+            int maxQueuedEvents = 0,
+            int maxUserWatches = 0,
+            bool renamesOnly = false)
+        {
+            _logger = logger;
+            _maxQueuedEvents = maxQueuedEvents;
+            _maxUserWatches = maxUserWatches;
+            _renamesOnly = renamesOnly;
+            _mask = renamesOnly ? RenamesMask : FullMask;
+        }
+
+        public void Start(IEnumerable<string> paths)
+        {
+            if (!IsSupported)
+                throw new PlatformNotSupportedException("inotify متاح على Linux فقط");
+
+            if (_fd >= 0) return;
+
+            // حد الطابور يُقرأ عند inotify_init - يجب رفعه قبل الإنشاء
+            TryRaiseLimit(MaxQueuedEventsPath, _maxQueuedEvents);
+            TryRaiseLimit(MaxUserWatchesPath, _maxUserWatches);
+
+            _fd = LinuxNative.inotify_init1(LinuxNative.IN_NONBLOCK | LinuxNative.IN_CLOEXEC);
+            if (_fd < 0)
+                throw new IOException($"inotify_init1 failed (errno {Marshal.GetLastPInvokeError()})");
+
+            foreach (var path in paths)
+            {
+                if (!Directory.Exists(path))
+                {
+                    _logger?.LogWarning("مجلد المراقبة غير موجود: {Path}", path);
+                    continue;
+                }
+
+                var root = NormalizeRoot(path);
+                AddWatchTree(root, emitExisting: false);
+                _roots.Add(root);
+
+                _logger?.LogInformation("مراقبة ({Source}): {Path}", Name, root);
+            }
+
+            _stopping = false;
+            _reader = new Thread(ReadLoop)
+            {
+                IsBackground = true,
+                Name = "ShieldAI-inotify"
+            };
+            _reader.Start();
+        }
+
+        public void Stop()
+        {
+            if (_fd < 0) return;
+
+            _stopping = true;
+            _reader?.Join(PollTimeoutMs * 8);
+            _reader = null;
+
+            LinuxNative.close(_fd);
+            _fd = -1;
+
+            lock (_lock) _watches.Clear();
+            _roots.Clear();
+        }
+
+        private void ReadLoop()
+        {
+            var buffer = new byte[ReadBufferSize];
+
+            while (!_stopping)
+            {
+                try
+                {
+                    if (!LinuxNative.WaitReadable(_fd, PollTimeoutMs))
+                        continue;
+
+                    var length = LinuxNative.read(_fd, buffer, buffer.Length);
+                    if (length <= 0)
+                    {
+                        var errno = Marshal.GetLastPInvokeError();
+                        if (length < 0 && errno != LinuxNative.EAGAIN && errno != LinuxNative.EINTR)
+                        {
+                            RaiseError(new IOException($"inotify read failed (errno {errno})"));
+                            Thread.Sleep(PollTimeoutMs);
+                        }
+                        continue;
+                    }
+
+                    ParseEvents(buffer, (int)length);
+                }
+                catch (Exception ex)
+                {
+                    _logger?.LogDebug(ex, "خطأ في قراءة أحداث inotify");
+                }
+            }
+        }
+
+        /// <summary>
+        /// struct inotify_event { int wd; uint32 mask; uint32 cookie; uint32 len; char name[len]; }
+        /// </summary>
+        private void ParseEvents(byte[] buffer, int length)
+        {
+            int offset = 0;
+            while (offset + EventHeaderSize <= length)
+            {
+                var wd = BitConverter.ToInt32(buffer, offset);
+                var mask = BitConverter.ToUInt32(buffer, offset + 4);
+                var nameLength = (int)BitConverter.ToUInt32(buffer, offset + 12);
+
+                var name = "";
+                if (nameLength > 0)
+                {
+                    var nameSpan = buffer.AsSpan(offset + EventHeaderSize, nameLength);
+                    var terminator = nameSpan.IndexOf((byte)0);
+                    name = Encoding.UTF8.GetString(terminator >= 0 ? nameSpan[..terminator] : nameSpan);
+                }
+
+                offset += EventHeaderSize + nameLength;
+                HandleEvent(wd, mask, name);
+            }
+        }
+
+        private void HandleEvent(int wd, uint mask, string name)
+        {
+            if ((mask & LinuxNative.IN_Q_OVERFLOW) != 0)
+            {
+                RaiseError(new EventSourceOverflowException("inotify queue overflow - events were lost"));
+                return;
+            }
+
+            string? directory;
+            lock (_lock)
+            {
+                if ((mask & LinuxNative.IN_IGNORED) != 0)
+                {
+                    _watches.Remove(wd);
+                    return;
+                }
+
+                _watches.TryGetValue(wd, out directory);
+            }
+
+            if (directory == null || name.Length == 0)
+                return;
+
+            var fullPath = Path.Combine(directory, name);
+
+            if ((mask & LinuxNative.IN_ISDIR) != 0)
+            {
+                // مجلد جديد: watch له ولما تحته، والملفات التي سبقت الـ watch تُبلَّغ الآن
+                var movedIn = (mask & LinuxNative.IN_MOVED_TO) != 0;
+                if (movedIn || (mask & LinuxNative.IN_CREATE) != 0)
+                    AddWatchTree(fullPath, emitExisting: movedIn || !_renamesOnly);
+                return;
+            }
+
+            WatcherChangeTypes changeType;
+            if ((mask & LinuxNative.IN_MOVED_TO) != 0)
+                changeType = WatcherChangeTypes.Renamed;
+            else if (_renamesOnly)
+                return;
+            else if ((mask & LinuxNative.IN_CLOSE_WRITE) != 0)
+                changeType = WatcherChangeTypes.Changed;
+            else if ((mask & LinuxNative.IN_CREATE) != 0)
+                changeType = WatcherChangeTypes.Created;
+            else
+                return;
+
+            RaiseFileChanged(fullPath, changeType);
+        }
+
+        private void AddWatchTree(string directory, bool emitExisting)
+        {
+            if (!AddWatch(directory))
+                return;
+
+            try
+            {
+                var options = new EnumerationOptions
+                {
+                    RecurseSubdirectories = true,
+                    IgnoreInaccessible = true,
+                    AttributesToSkip = FileAttributes.ReparsePoint
+                };
+
+                foreach (var subDirectory in Directory.EnumerateDirectories(directory, "*", options))
+                {
+                    if (!AddWatch(subDirectory))
+                        break;
+                }
+
+                if (emitExisting)
+                {
+                    var changeType = _renamesOnly ? WatcherChangeTypes.Renamed : WatcherChangeTypes.Created;
+                    foreach (var file in Directory.EnumerateFiles(directory, "*", options))
+                        RaiseFileChanged(file, changeType);
+                }
+            }
+            catch (Exception ex)
+            {
+                _logger?.LogDebug(ex, "فشل تعداد مجلد للمراقبة: {Path}", directory);
+            }
+        }
+
+        private bool AddWatch(string directory)
+        {
+            var wd = LinuxNative.inotify_add_watch(_fd, directory, _mask);
+            if (wd >= 0)
+            {
+                lock (_lock) _watches[wd] = directory;
+                return true;
+            }
+
+            var errno = Marshal.GetLastPInvokeError();
+            if (errno == LinuxNative.ENOSPC)
+            {
+                if (!_watchLimitReported)
+                {
+                    _watchLimitReported = true;
+                    _logger?.LogWarning("بلغ inotify حد fs.inotify.max_user_watches - مجلدات لن تُراقب");
+                    RaiseError(new IOException("inotify watch limit reached (fs.inotify.max_user_watches)"));
+                }
+                return false;
+            }
+
+            // مجلد حُذف أو لا صلاحية - نتابع مع الباقي
+            return true;
+        }
+
+        private void RaiseFileChanged(string fullPath, WatcherChangeTypes changeType)
+        {
+            try
+            {
+                FileChanged?.Invoke(this, new FileEventSourceArgs(fullPath, changeType));
+            }
+            catch (Exception ex)
+            {
+                _logger?.LogDebug(ex, "فشل معالج حدث الملف: {Path}", fullPath);
+            }
+        }
+
+        private void RaiseError(Exception ex)
+        {
+            try { Error?.Invoke(this, new ErrorEventArgs(ex)); } catch { }
+        }
+
+        /// <summary>
+        /// رفع حد sysctl إذا كان أقل من المطلوب (يحتاج root - الفشل صامت)
+        /// </summary>
+        private void TryRaiseLimit(string path, int wanted)
+        {
+            if (wanted <= 0) return;
+
+            try
+            {
+                var current = int.Parse(File.ReadAllText(path).Trim());
+                if (current >= wanted) return;
+
+                File.WriteAllText(path, wanted.ToString());
+                _logger?.LogInformation("رفع {Limit}: {Old} -> {New}", Path.GetFileName(path), current, wanted);
+            }
+            catch (Exception ex)
+            {
+                _logger?.LogDebug(ex, "تعذر رفع {Limit}", Path.GetFileName(path));
+            }
+        }
+
+        private static string NormalizeRoot(string path)
+        {
+            var full = Path.GetFullPath(path);
+            return full.Length > 1 ? full.TrimEnd(Path.DirectorySeparatorChar) : full;
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+            Stop();
+        }
+    }
+}
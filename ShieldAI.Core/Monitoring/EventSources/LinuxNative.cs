@@ -0,0 +1,115 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/LinuxNative.cs
+// استدعاءات libc لـ inotify و fanotify
+// =====================================================
+
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// استدعاءات libc (بدون unsafe - مخازن byte[] فقط)
+    /// </summary>
+    internal static class LinuxNative
+    {
+        private const string Libc = "libc";
+
+        // inotify_init1 / fanotify_init
+        public const int IN_NONBLOCK = 0x800;
+        public const int IN_CLOEXEC = 0x80000;
+        public const int O_RDONLY = 0;
+        public const int O_CLOEXEC = 0x80000;
+
+        // أقنعة inotify
+        public const uint IN_CLOSE_WRITE = 0x00000008;
+        public const uint IN_MOVED_TO = 0x00000080;
+        public const uint IN_CREATE = 0x00000100;
+        public const uint IN_DELETE_SELF = 0x00000400;
+        public const uint IN_Q_OVERFLOW = 0x00004000;
+        public const uint IN_IGNORED = 0x00008000;
+        public const uint IN_ONLYDIR = 0x01000000;
+        public const uint IN_DONT_FOLLOW = 0x02000000;
+        public const uint IN_EXCL_UNLINK = 0x04000000;
+        public const uint IN_ISDIR = 0x40000000;
+
+        // fanotify
+        public const uint FAN_CLASS_NOTIF = 0x0;
+        public const uint FAN_CLOEXEC = 0x1;
+        public const uint FAN_NONBLOCK = 0x2;
+        public const uint FAN_MARK_ADD = 0x1;
+        public const uint FAN_MARK_MOUNT = 0x10;
+        public const ulong FAN_CLOSE_WRITE = 0x8;
+        public const ulong FAN_Q_OVERFLOW = 0x4000;
+        public const int FANOTIFY_METADATA_VERSION = 3;
+        public const int FAN_NOFD = -1;
+        public const int AT_FDCWD = -100;
+
+        // poll
+        public const short POLLIN = 0x1;
+
+        // errno
+        public const int EINTR = 4;
+        public const int EAGAIN = 11;
+        public const int ENOSPC = 28;
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct PollFd
+        {
+            public int Fd;
+            public short Events;
+            public short Revents;
+        }
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern int inotify_init1(int flags);
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern int inotify_add_watch(int fd, [MarshalAs(UnmanagedType.LPUTF8Str)] string pathname, uint mask);
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern int inotify_rm_watch(int fd, int wd);
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern int fanotify_init(uint flags, uint eventFlags);
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern int fanotify_mark(int fanotifyFd, uint flags, ulong mask, int dirFd,
+            [MarshalAs(UnmanagedType.LPUTF8Str)] string pathname);
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern nint read(int fd, byte[] buffer, nint count);
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern int close(int fd);
+
+        [DllImport(Libc, SetLastError = true)]
+        public static extern int poll(ref PollFd fds, nuint nfds, int timeout);
+
+        [DllImport(Libc, SetLastError = true)]
+        private static extern nint readlink([MarshalAs(UnmanagedType.LPUTF8Str)] string path, byte[] buffer, nint size);
+
+        /// <summary>
+        /// انتظار قابلية القراءة - false عند انتهاء المهلة أو المقاطعة
+        /// </summary>
+        public static bool WaitReadable(int fd, int timeoutMs)
+        {
+            var pollFd = new PollFd { Fd = fd, Events = POLLIN };
+            var result = poll(ref pollFd, 1, timeoutMs);
+            return result > 0 && (pollFd.Revents & POLLIN) != 0;
+        }
+
+        /// <summary>
+        /// المسار الحالي لواصف ملف عبر /proc/self/fd
+        /// </summary>
+        public static string? ResolveFdPath(int fd, byte[] scratch)
+        {
+            var length = readlink($"/proc/self/fd/{fd}", scratch, scratch.Length);
+            if (length <= 0 || length >= scratch.Length)
+                return null;
+
+            return Encoding.UTF8.GetString(scratch, 0, (int)length);
+        }
+    }
+}
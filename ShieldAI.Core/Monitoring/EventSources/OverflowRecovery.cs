@@ -0,0 +1,243 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/EventSources/OverflowRecovery.cs
+// استعادة الأحداث المفقودة بعد فيضان مصدر الأحداث
+// =====================================================
+
+using Microsoft.Extensions.Logging;
+
+namespace ShieldAI.Core.Monitoring.EventSources
+{
+    /// <summary>
+    /// فيضان مخزن/طابور مصدر الأحداث مع الجذر المتأثر
+    /// </summary>
+    public class EventSourceOverflowException : InternalBufferOverflowException
+    {
+        /// <summary>
+        /// الجذر الذي فُقدت أحداثه (null = كل الجذور - طابور inotify/fanotify مشترك)
+        /// </summary>
+        public string? AffectedRoot { get; }
+
+        public EventSourceOverflowException(string message, string? affectedRoot = null)
+            : base(message)
+        {
+            AffectedRoot = affectedRoot;
+        }
+    }
+
+    /// <summary>
+    /// عند الفيضان: مقارنة الشجرة المتأثرة فقط باللقطة وإعادة حقن الملفات المتغيرة فعلاً،
+    /// بدل فقدان الأحداث أو إعادة فحص كل شيء.
+    /// الملفات تُسجَّل في اللقطة بعد اكتمال فحصها فقط، فالحدث الذي ضاع داخل خط المعالجة
+    /// (إزاحة من القائمة، تأجيل، إسقاط) يبقى مختلفاً عن اللقطة ويُعاد عند الاستعادة.
+    /// </summary>
+    public class OverflowRecovery : IDisposable
+    {
+        private readonly DirectorySnapshotStore _snapshot;
+        private readonly Action<string> _reinject;
+        private readonly ILogger? _logger;
+        private readonly int _delayMs;
+        private readonly List<string> _roots = new();
+        private readonly object _lock = new();
+        private readonly HashSet<string> _pendingRoots = new(StringComparer.OrdinalIgnoreCase);
+        private CancellationTokenSource? _cts;
+        private Task _captureTask = Task.CompletedTask;
+        private bool _recoveryScheduled;
+        private long _recoveries;
+        private long _recoveredFiles;
+        private bool _disposed;
+
+        /// <param name="reinject">يُستدعى لكل ملف متغير (يمر على نفس مسار الأحداث العادي)</param>
+        /// <param name="delayMs">انتظار قبل المقارنة حتى تهدأ العاصفة (فيضانات متتالية تُدمج)</param>
+        public OverflowRecovery(Action<string> reinject, ILogger? logger = null, int maxSnapshotFiles = 1_000_000, int delayMs = 1000)
+        {
+            _reinject = reinject;
+            _logger = logger;
+            _delayMs = Math.Max(0, delayMs);
+            _snapshot = new DirectorySnapshotStore(maxSnapshotFiles);
+        }
+
+        public DirectorySnapshotStore Snapshot => _snapshot;
+
+        /// <summary>
+        /// عدد عمليات الاستعادة المنفذة
+        /// </summary>
+        public long RecoveryCount => Interlocked.Read(ref _recoveries);
+
+        /// <summary>
+        /// عدد الملفات التي أعيد حقنها
+        /// </summary>
+        public long RecoveredFileCount => Interlocked.Read(ref _recoveredFiles);
+
+        /// <summary>
+        /// اكتمال اللقطة الأولى
+        /// </summary>
+        public Task CaptureCompletion => _captureTask;
+
+        /// <summary>
+        /// بدء التقاط الجذور في الخلفية
+        /// </summary>
+        public void Start(IEnumerable<string> roots)
+        {
+            Stop();
+
+            _cts = new CancellationTokenSource();
+            var ct = _cts.Token;
+
+            lock (_lock)
+            {
+                _roots.Clear();
+                _roots.AddRange(roots.Where(Directory.Exists).Select(Path.GetFullPath));
+            }
+
+            var captureRoots = _roots.ToList();
+            _captureTask = Task.Run(() =>
+            {
+                foreach (var root in captureRoots)
+                {
+                    try
+                    {
+                        _snapshot.Capture(root, ct);
+                    }
+                    catch (OperationCanceledException)
+                    {
+                        return;
+                    }
+                    catch (Exception ex)
+                    {
+                        _logger?.LogDebug(ex, "فشل التقاط لقطة المجلد: {Path}", root);
+                    }
+                }
+
+                _logger?.LogDebug("لقطة المراقبة: {Files} ملف في {Dirs} مجلد{Truncated}",
+                    _snapshot.FileCount, _snapshot.DirectoryCount,
+                    _snapshot.IsTruncated ? " (مقطوعة)" : "");
+            }, ct);
+        }
+
+        /// <summary>
+        /// إيقاف الاستعادة ومسح اللقطة
+        /// </summary>
+        public void Stop()
+        {
+            _cts?.Cancel();
+            try { _captureTask.Wait(TimeSpan.FromSeconds(5)); } catch { }
+            _cts?.Dispose();
+            _cts = null;
+
+            lock (_lock)
+            {
+                _pendingRoots.Clear();
+                _recoveryScheduled = false;
+            }
+
+            _snapshot.Clear();
+        }
+
+        /// <summary>
+        /// تسجيل ملف اكتمل فحصه في اللقطة
+        /// </summary>
+        public void Record(string filePath)
+        {
+            try { _snapshot.Record(filePath); } catch { }
+        }
+
+        /// <summary>
+        /// معالجة خطأ من مصدر الأحداث - true إذا كان فيضاناً وجُدولت استعادة
+        /// </summary>
+        public bool HandleError(object? sender, Exception ex)
+        {
+            if (ex is not InternalBufferOverflowException)
+                return false;
+
+            var root = (ex as EventSourceOverflowException)?.AffectedRoot;
+            ScheduleRecovery(root);
+            return true;
+        }
+
+        /// <summary>
+        /// جدولة مقارنة لجذر (null = كل الجذور)
+        /// </summary>
+        public void ScheduleRecovery(string? root)
+        {
+            var cts = _cts;
+            if (cts == null) return;
+            var ct = cts.Token;
+
+            lock (_lock)
+            {
+                if (root == null)
+                {
+                    foreach (var r in _roots) _pendingRoots.Add(r);
+                }
+                else
+                {
+                    _pendingRoots.Add(Path.GetFullPath(root));
+                }
+
+                if (_recoveryScheduled) return;
+                _recoveryScheduled = true;
+            }
+
+            _ = Task.Run(() => RunRecoveryAsync(ct), ct);
+        }
+
+        private async Task RunRecoveryAsync(CancellationToken ct)
+        {
+            try
+            {
+                await Task.Delay(_delayMs, ct).ConfigureAwait(false);
+
+                // المقارنة تحتاج لقطة أساس
+                await _captureTask.ConfigureAwait(false);
+
+                while (true)
+                {
+                    string[] roots;
+                    lock (_lock)
+                    {
+                        if (_pendingRoots.Count == 0)
+                        {
+                            _recoveryScheduled = false;
+                            return;
+                        }
+
+                        roots = _pendingRoots.ToArray();
+                        _pendingRoots.Clear();
+                    }
+
+                    foreach (var root in roots)
+                    {
+                        ct.ThrowIfCancellationRequested();
+
+                        var changed = _snapshot.DiffAndRefresh(root, ct);
+                        foreach (var path in changed)
+                        {
+                            try { _reinject(path); } catch { }
+                        }
+
+                        Interlocked.Increment(ref _recoveries);
+                        Interlocked.Add(ref _recoveredFiles, changed.Count);
+
+                        _logger?.LogWarning("استعادة بعد فيضان الأحداث: {Count} ملف متغير في {Root}",
+                            changed.Count, root);
+                    }
+                }
+            }
+            catch (OperationCanceledException) { }
+            catch (Exception ex)
+            {
+                _logger?.LogError(ex, "فشلت استعادة الأحداث بعد الفيضان");
+            }
+
+            lock (_lock) _recoveryScheduled = false;
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+            Stop();
+        }
+    }
+}
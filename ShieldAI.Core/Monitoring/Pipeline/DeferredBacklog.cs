@@ -0,0 +1,123 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/Pipeline/DeferredBacklog.cs
+// طابور خلفي للأحداث المؤجلة تحت الضغط الحرج
+// =====================================================
+
+using System.Collections.Concurrent;
+
+namespace ShieldAI.Core.Monitoring.Pipeline
+{
+    /// <summary>
+    /// أحداث غير تنفيذية أُجّلت في المستوى الحرج - تُعاد للقائمة تدريجياً بعد التعافي.
+    /// مسار واحد = عنصر واحد (تكرار التأجيل يحدّث الحدث ولا يضاعفه).
+    /// </summary>
+    public class DeferredBacklog
+    {
+        private readonly ConcurrentDictionary<string, FileEvent> _events = new(StringComparer.OrdinalIgnoreCase);
+        private readonly ConcurrentQueue<string> _order = new();
+        private readonly int _capacity;
+        private long _deferred;
+        private long _drained;
+        private long _overflowed;
+
+        public DeferredBacklog(int capacity = 50_000)
+        {
+            _capacity = Math.Max(1, capacity);
+        }
+
+        /// <summary>
+        /// عدد الملفات المؤجلة حالياً
+        /// </summary>
+        public int PendingCount => _events.Count;
+
+        /// <summary>
+        /// إجمالي الأحداث المؤجلة
+        /// </summary>
+        public long DeferredCount => Interlocked.Read(ref _deferred);
+
+        /// <summary>
+        /// إجمالي الأحداث المعادة للقائمة
+        /// </summary>
+        public long DrainedCount => Interlocked.Read(ref _drained);
+
+        /// <summary>
+        /// أحداث لم تُؤجَّل لامتلاء الطابور (فُحصت فوراً)
+        /// </summary>
+        public long OverflowCount => Interlocked.Read(ref _overflowed);
+
+        /// <summary>
+        /// تأجيل حدث - false إذا امتلأ الطابور (على المستدعي فحصه فوراً)
+        /// </summary>
+        public bool TryDefer(FileEvent fileEvent)
+        {
+            var key = fileEvent.FilePath;
+
+            if (_events.TryGetValue(key, out _))
+            {
+                _events[key] = fileEvent;
+                Interlocked.Increment(ref _deferred);
+                return true;
+            }
+
+            if (_events.Count >= _capacity)
+            {
+                Interlocked.Increment(ref _overflowed);
+                return false;
+            }
+
+            if (_events.TryAdd(key, fileEvent))
+                _order.Enqueue(key);
+            else
+                _events[key] = fileEvent;
+
+            Interlocked.Increment(ref _deferred);
+            return true;
+        }
+
+        /// <summary>
+        /// إعادة حتى maxCount حدث عبر sink (يتوقف عند رفض sink)
+        /// </summary>
+        public int Drain(Func<FileEvent, bool> sink, int maxCount)
+        {
+            int drained = 0;
+
+            while (drained < maxCount && _order.TryPeek(out var key))
+            {
+                if (!_events.TryGetValue(key, out var fileEvent))
+                {
+                    _order.TryDequeue(out _);
+                    continue;
+                }
+
+                // زمن الانتظار يُقاس من العودة للقائمة - التأجيل ليس تأخراً في الطابور
+                var requeued = new FileEvent
+                {
+                    FilePath = fileEvent.FilePath,
+                    ChangeType = fileEvent.ChangeType,
+                    RequiresQuickGate = fileEvent.RequiresQuickGate,
+                    OriginProcessId = fileEvent.OriginProcessId
+                };
+
+                if (!sink(requeued))
+                    break;
+
+                _order.TryDequeue(out _);
+                _events.TryRemove(key, out _);
+                drained++;
+            }
+
+            Interlocked.Add(ref _drained, drained);
+            return drained;
+        }
+
+        /// <summary>
+        /// مسح الطابور
+        /// </summary>
+        public void Clear()
+        {
+            _events.Clear();
+            while (_order.TryDequeue(out _)) { }
+        }
+    }
+}
@@ -10,83 +10,239 @@ namespace ShieldAI.Core.Monitoring.Pipeline
 {
     /// <summary>
     /// يجمّع أحداث نفس الملف خلال فترة زمنية (300-800ms)
-    /// لمنع الفحص المتكرر عند الكتابة المتعددة
+    /// لمنع الفحص المتكرر عند الكتابة المتعددة.
+    /// المواعيد في عجلة توقيت (كلفة كل tick تتناسب مع المستحق فقط)،
+    /// والملفات غير الجاهزة (مقفلة/فارغة) تُعاد جدولتها بتراجع أسي بدل إسقاطها.
     /// </summary>
     public class EventCoalescer : IDisposable
     {
         private readonly ConcurrentDictionary<string, CoalescedEvent> _pending = new(StringComparer.OrdinalIgnoreCase);
-        private readonly FileEventQueue _outputQueue;
+        private readonly Action<FileEvent> _output;
         private readonly int _coalesceMs;
+        private readonly TimingWheel<CoalescedEvent> _wheel;
+        private readonly object _wheelLock = new();
+        private readonly List<CoalescedEvent> _expired = new();
         private readonly Timer _flushTimer;
+        private int _flushing;
+        private int _retryPending;
+        private long _droppedCount;
+        private int _windowMultiplier = 1;
         private bool _disposed;
 
+        /// <summary>
+        /// أقصى عدد محاولات لملف غير جاهز قبل إسقاطه
+        /// </summary>
+        public int MaxReadinessRetries { get; set; } = 8;
+
+        /// <summary>
+        /// أقصى تأخير بين محاولات الجاهزية (مللي ثانية)
+        /// </summary>
+        public int MaxRetryDelayMs { get; set; } = 30_000;
+
+        /// <summary>
+        /// مضاعف نافذة التجميع تحت الضغط (1 = النافذة الأساسية).
+        /// المواعيد المجدولة تُمدَّد كسولاً عند استحقاقها.
+        /// </summary>
+        public int WindowMultiplier
+        {
+            get => Volatile.Read(ref _windowMultiplier);
+            set => Volatile.Write(ref _windowMultiplier, Math.Clamp(value, 1, 16));
+        }
+
+        /// <summary>
+        /// نافذة التجميع الفعلية (مللي ثانية)
+        /// </summary>
+        public int EffectiveCoalesceMs => _coalesceMs * WindowMultiplier;
+
         public EventCoalescer(FileEventQueue outputQueue, int coalesceMs = 500)
+            : this(fileEvent => outputQueue.TryEnqueue(fileEvent), coalesceMs)
+        {
+        }
+
+        /// <param name="output">يُستدعى لكل ملف مستقر وجاهز للقراءة</param>
+        public EventCoalescer(Action<FileEvent> output, int coalesceMs = 500)
         {
-            _outputQueue = outputQueue;
+            _output = output;
             _coalesceMs = Math.Clamp(coalesceMs, 100, 2000);
 
-            // فحص كل نصف فترة التجميع
-            _flushTimer = new Timer(FlushReady, null, _coalesceMs / 2, _coalesceMs / 2);
+            // دقة العجلة ربع فترة التجميع - tick بلا مستحقات لا يكلف شيئاً
+            var tickMs = Math.Max(10, _coalesceMs / 4);
+            _wheel = new TimingWheel<CoalescedEvent>(tickMs, startMs: Environment.TickCount64);
+            _flushTimer = new Timer(FlushReady, null, tickMs, tickMs);
         }
 
         /// <summary>
         /// إضافة حدث (سيتم تجميعه مع أحداث نفس الملف)
         /// </summary>
-        public void Add(string filePath, WatcherChangeTypes changeType)
+        /// <param name="requiresQuickGate">محتوى تنفيذي - يبقى مطلوباً إذا طلبه أي حدث في المجموعة</param>
+        /// <param name="originProcessId">العملية الكاتبة - يُحتفظ بآخر قيمة معروفة</param>
+        public void Add(string filePath, WatcherChangeTypes changeType, bool requiresQuickGate = false,
+            int? originProcessId = null)
         {
             var key = NormalizePath(filePath);
+            var now = Environment.TickCount64;
+
+            while (true)
+            {
+                if (_pending.TryGetValue(key, out var existing))
+                {
+                    lock (existing)
+                    {
+                        // اكتمل للتو في FlushReady - نبدأ مجموعة جديدة
+                        if (existing.Completed)
+                            continue;
+
+                        // الموعد يتأخر فقط - العنصر يبقى في خانته ويُعاد جدولته عند استحقاقها
+                        existing.LastEventMs = now;
+                        existing.ChangeType = changeType;
+                        existing.EventCount++;
+                        existing.RequiresQuickGate |= requiresQuickGate;
+                        existing.OriginProcessId = originProcessId ?? existing.OriginProcessId;
+                    }
+                    return;
+                }
 
-            _pending.AddOrUpdate(
-                key,
-                _ => new CoalescedEvent(filePath, changeType),
-                (_, existing) =>
+                var created = new CoalescedEvent(key, filePath, changeType, now)
                 {
-                    existing.LastEventTime = DateTime.UtcNow;
-                    existing.ChangeType = changeType;
-                    existing.EventCount++;
-                    return existing;
-                });
+                    RequiresQuickGate = requiresQuickGate,
+                    OriginProcessId = originProcessId
+                };
+
+                if (_pending.TryAdd(key, created))
+                {
+                    lock (_wheelLock)
+                    {
+                        _wheel.Schedule(created, created.DueMs(EffectiveCoalesceMs));
+                    }
+                    return;
+                }
+            }
         }
 
         /// <summary>
-        /// فحص وإرسال الأحداث المستقرة
+        /// إرسال الأحداث المستحقة فقط
         /// </summary>
         private void FlushReady(object? state)
         {
             if (_disposed) return;
 
-            var cutoff = DateTime.UtcNow.AddMilliseconds(-_coalesceMs);
+            // Timer قد يتداخل إذا طال الفحص - مُفرّغ واحد في كل مرة
+            if (Interlocked.Exchange(ref _flushing, 1) == 1) return;
 
-            foreach (var kvp in _pending.ToArray())
+            try
             {
-                if (kvp.Value.LastEventTime <= cutoff)
+                var now = Environment.TickCount64;
+
+                lock (_wheelLock)
+                {
+                    _wheel.Advance(now, _expired);
+                }
+
+                if (_expired.Count == 0) return;
+
+                foreach (var coalescedEvent in _expired)
                 {
-                    if (_pending.TryRemove(kvp.Key, out var coalescedEvent))
+                    ProcessDue(coalescedEvent, now);
+                }
+            }
+            finally
+            {
+                _expired.Clear();
+                Volatile.Write(ref _flushing, 0);
+            }
+        }
+
+        private void ProcessDue(CoalescedEvent coalescedEvent, long now)
+        {
+            long dueMs;
+            lock (coalescedEvent)
+            {
+                if (coalescedEvent.Completed) return;
+                dueMs = coalescedEvent.DueMs(EffectiveCoalesceMs);
+            }
+
+            // وصلت أحداث جديدة بعد الجدولة - ننتظر حتى يستقر
+            if (dueMs > now)
+            {
+                Reschedule(coalescedEvent, dueMs);
+                return;
+            }
+
+            // فتح الملف خارج الأقفال
+            var readiness = CheckReadiness(coalescedEvent.FilePath);
+
+            FileEvent? ready = null;
+            lock (coalescedEvent)
+            {
+                // حدث جديد أثناء فحص الجاهزية
+                if (coalescedEvent.DueMs(EffectiveCoalesceMs) > now)
+                {
+                    dueMs = coalescedEvent.DueMs(EffectiveCoalesceMs);
+                }
+                else if (readiness == FileReadiness.Busy && coalescedEvent.Attempts < MaxReadinessRetries)
+                {
+                    if (coalescedEvent.Attempts++ == 0)
+                        Interlocked.Increment(ref _retryPending);
+
+                    var delay = Math.Min((long)_coalesceMs << Math.Min(coalescedEvent.Attempts - 1, 16), MaxRetryDelayMs);
+                    coalescedEvent.NotBeforeMs = now + delay;
+                    dueMs = coalescedEvent.NotBeforeMs;
+                }
+                else
+                {
+                    coalescedEvent.Completed = true;
+                    if (coalescedEvent.Attempts > 0)
+                        Interlocked.Decrement(ref _retryPending);
+
+                    if (readiness == FileReadiness.Ready)
                     {
-                        // التحقق من أن الملف موجود ومستقر
-                        if (IsFileReady(coalescedEvent.FilePath))
+                        ready = new FileEvent
                         {
-                            _outputQueue.TryEnqueue(new FileEvent
-                            {
-                                FilePath = coalescedEvent.FilePath,
-                                ChangeType = coalescedEvent.ChangeType,
-                                Timestamp = coalescedEvent.LastEventTime
-                            });
-                        }
+                            FilePath = coalescedEvent.FilePath,
+                            ChangeType = coalescedEvent.ChangeType,
+                            Timestamp = DateTime.UtcNow,
+                            RequiresQuickGate = coalescedEvent.RequiresQuickGate,
+                            OriginProcessId = coalescedEvent.OriginProcessId
+                        };
+                    }
+                    else if (readiness == FileReadiness.Busy)
+                    {
+                        Interlocked.Increment(ref _droppedCount);
                     }
                 }
             }
+
+            if (!coalescedEvent.Completed)
+            {
+                Reschedule(coalescedEvent, dueMs);
+                return;
+            }
+
+            _pending.TryRemove(new KeyValuePair<string, CoalescedEvent>(coalescedEvent.Key, coalescedEvent));
+
+            if (ready != null)
+            {
+                try { _output(ready); } catch { }
+            }
+        }
+
+        private void Reschedule(CoalescedEvent coalescedEvent, long dueMs)
+        {
+            lock (_wheelLock)
+            {
+                _wheel.Schedule(coalescedEvent, dueMs);
+            }
         }
 
         /// <summary>
-        /// التحقق من أن الملف جاهز للقراءة (غير مقفل)
+        /// التحقق من أن الملف جاهز للقراءة (غير مقفل وغير فارغ)
         /// </summary>
-        private static bool IsFileReady(string filePath)
+        private static FileReadiness CheckReadiness(string filePath)
         {
             try
             {
                 if (!File.Exists(filePath))
-                    return false;
+                    return FileReadiness.Missing;
 
                 using var stream = new FileStream(
                     filePath,
@@ -94,11 +250,25 @@ namespace ShieldAI.Core.Monitoring.Pipeline
                     FileAccess.Read,
                     FileShare.ReadWrite);
 
-                return stream.Length > 0;
+                // ملف فارغ غالباً ما زال قيد الإنشاء
+                return stream.Length > 0 ? FileReadiness.Ready : FileReadiness.Busy;
+            }
+            catch (FileNotFoundException)
+            {
+                return FileReadiness.Missing;
+            }
+            catch (DirectoryNotFoundException)
+            {
+                return FileReadiness.Missing;
+            }
+            catch (IOException)
+            {
+                return FileReadiness.Busy;
             }
             catch
             {
-                return false;
+                // لا صلاحية - لن يصبح جاهزاً بالانتظار
+                return FileReadiness.Missing;
             }
         }
 
@@ -107,12 +277,33 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// </summary>
         public int PendingCount => _pending.Count;
 
+        /// <summary>
+        /// عدد الملفات المعلقة في انتظار الجاهزية (مقفلة أو فارغة)
+        /// </summary>
+        public int RetryPendingCount => Math.Max(0, Volatile.Read(ref _retryPending));
+
+        /// <summary>
+        /// عدد الملفات التي أُسقطت بعد استنفاد محاولات الجاهزية
+        /// </summary>
+        public long DroppedCount => Interlocked.Read(ref _droppedCount);
+
         /// <summary>
         /// مسح جميع الأحداث المعلقة
         /// </summary>
         public void Clear()
         {
+            lock (_wheelLock)
+            {
+                _wheel.Clear();
+            }
+
+            foreach (var kvp in _pending)
+            {
+                lock (kvp.Value) kvp.Value.Completed = true;
+            }
+
             _pending.Clear();
+            Interlocked.Exchange(ref _retryPending, 0);
         }
 
         private static string NormalizePath(string path)
@@ -125,23 +316,42 @@ namespace ShieldAI.Core.Monitoring.Pipeline
             if (_disposed) return;
             _disposed = true;
             _flushTimer.Dispose();
-            _pending.Clear();
+            Clear();
+        }
+
+        private enum FileReadiness
+        {
+            Ready,
+            Busy,
+            Missing
         }
 
         private class CoalescedEvent
         {
+            public string Key { get; }
             public string FilePath { get; }
             public WatcherChangeTypes ChangeType { get; set; }
-            public DateTime LastEventTime { get; set; }
+            public long LastEventMs { get; set; }
             public int EventCount { get; set; }
+            public bool RequiresQuickGate { get; set; }
+            public int? OriginProcessId { get; set; }
+            public int Attempts { get; set; }
+            public long NotBeforeMs { get; set; }
+            public bool Completed { get; set; }
 
-            public CoalescedEvent(string filePath, WatcherChangeTypes changeType)
+            public CoalescedEvent(string key, string filePath, WatcherChangeTypes changeType, long now)
             {
+                Key = key;
                 FilePath = filePath;
                 ChangeType = changeType;
-                LastEventTime = DateTime.UtcNow;
+                LastEventMs = now;
                 EventCount = 1;
             }
+
+            /// <summary>
+            /// الموعد: بعد فترة الهدوء وبعد موعد إعادة المحاولة
+            /// </summary>
+            public long DueMs(int coalesceMs) => Math.Max(LastEventMs + coalesceMs, NotBeforeMs);
         }
     }
 }
@@ -4,7 +4,10 @@
 // قائمة انتظار الأحداث باستخدام System.Threading.Channels
 // =====================================================
 
+using System.Runtime.CompilerServices;
 using System.Threading.Channels;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Scanning;
 
 namespace ShieldAI.Core.Monitoring.Pipeline
 {
@@ -16,32 +19,202 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         public string FilePath { get; set; } = "";
         public WatcherChangeTypes ChangeType { get; set; }
         public DateTime Timestamp { get; set; } = DateTime.UtcNow;
+
+        /// <summary>
+        /// محتوى تنفيذي حسب الفرز الأولي - يمر على Quick Gate قبل الفحص الكامل
+        /// </summary>
+        public bool RequiresQuickGate { get; set; }
+
+        /// <summary>
+        /// العملية الكاتبة إن عرفها مصدر الأحداث (fanotify)
+        /// </summary>
+        public int? OriginProcessId { get; set; }
+    }
+
+    /// <summary>
+    /// مسار الأولوية في القائمة
+    /// </summary>
+    public enum FileEventLane
+    {
+        High,       // تنفيذيات وسكربتات وتنزيلات
+        Normal,     // مستندات وأرشيفات
+        Low         // كل ما عدا ذلك (سجلات، مخرجات البناء...)
+    }
+
+    /// <summary>
+    /// طريقة السحب من المسارات
+    /// </summary>
+    public enum LaneDequeueMode
+    {
+        Strict,     // الأعلى أولاً دائماً
+        Weighted    // توزيع بالأوزان (لا يجوع المسار المنخفض)
+    }
+
+    /// <summary>
+    /// إعدادات قائمة الأحداث متعددة المسارات
+    /// </summary>
+    public class FileEventQueueOptions
+    {
+        public int HighCapacity { get; set; } = 2_500;
+        public int NormalCapacity { get; set; } = 2_500;
+        public int LowCapacity { get; set; } = 5_000;
+
+        public LaneDequeueMode Mode { get; set; } = LaneDequeueMode.Weighted;
+
+        public int HighWeight { get; set; } = 8;
+        public int NormalWeight { get; set; } = 3;
+        public int LowWeight { get; set; } = 1;
+
+        /// <summary>
+        /// المسار العالي لا يُزيح أحداثه: الكاتب ينتظر حتى هذه المدة ثم يُبلَّغ عن الحدث عبر EventDropped
+        /// </summary>
+        public int HighLaneBackpressureMs { get; set; } = 250;
+
+        /// <summary>
+        /// سياسة المسارات لتصنيف مجلدات التنزيلات - null يعني PathPolicy.Current
+        /// </summary>
+        public PathPolicy? PathPolicy { get; set; }
+
+        /// <summary>
+        /// تقسيم سعة إجمالية: ربع للعالي، ربع للعادي، نصف للمنخفض
+        /// </summary>
+        public static FileEventQueueOptions FromTotalCapacity(int capacity)
+        {
+            capacity = Math.Max(4, capacity);
+            return new FileEventQueueOptions
+            {
+                HighCapacity = capacity / 4,
+                NormalCapacity = capacity / 4,
+                LowCapacity = capacity - 2 * (capacity / 4)
+            };
+        }
+
+        public static FileEventQueueOptions FromSettings(AppSettings settings)
+        {
+            var options = FromTotalCapacity(settings.PipelineQueueCapacity);
+
+            if (settings.PipelineHighLaneCapacity > 0) options.HighCapacity = settings.PipelineHighLaneCapacity;
+            if (settings.PipelineNormalLaneCapacity > 0) options.NormalCapacity = settings.PipelineNormalLaneCapacity;
+            if (settings.PipelineLowLaneCapacity > 0) options.LowCapacity = settings.PipelineLowLaneCapacity;
+
+            options.Mode = settings.PipelineStrictPriority ? LaneDequeueMode.Strict : LaneDequeueMode.Weighted;
+            options.HighLaneBackpressureMs = Math.Max(0, settings.PipelineHighLaneBackpressureMs);
+            return options;
+        }
+    }
+
+    /// <summary>
+    /// إحصائيات مسار واحد
+    /// </summary>
+    public class FileEventLaneStats
+    {
+        public FileEventLane Lane { get; set; }
+        public int Pending { get; set; }
+        public int Capacity { get; set; }
+        public long Enqueued { get; set; }
+        public long Dequeued { get; set; }
+
+        /// <summary>
+        /// أحداث فُقدت لامتلاء المسار (الأقدم في العادي والمنخفض، الجديد في العالي بعد الانتظار)
+        /// </summary>
+        public long Dropped { get; set; }
+
+        /// <summary>
+        /// ملفات مؤقتة رُفضت تحت الضغط
+        /// </summary>
+        public long Rejected { get; set; }
     }
 
     /// <summary>
     /// قائمة انتظار الأحداث المبنية على System.Threading.Channels
-    /// أسرع وأكثر كفاءة من ConcurrentQueue + Timer
+    /// أسرع وأكثر كفاءة من ConcurrentQueue + Timer.
+    /// عدة مسارات أولوية بسعة مستقلة: عاصفة سجلات في المسار المنخفض لا تُزيح ملف .exe جديد.
+    /// المسار العالي لا يُزيح الأقدم أبداً (تنزيل حديث قد ينتظر فيه): امتلاؤه يبطئ الكاتب،
+    /// وما لا يدخل بعد المهلة يُبلَّغ عنه عبر EventDropped لاستعادة مجلده.
     /// </summary>
     public class FileEventQueue : IDisposable
     {
-        private readonly Channel<FileEvent> _channel;
-        private readonly int _capacity;
+        private static readonly HashSet<string> DocumentExtensions = new(StringComparer.OrdinalIgnoreCase)
+        {
+            ".pdf", ".doc", ".docx", ".docm", ".xls", ".xlsx", ".xlsm", ".ppt", ".pptx", ".pptm",
+            ".rtf", ".odt", ".ods", ".odp", ".one", ".xps",
+            ".zip", ".7z", ".rar", ".gz", ".tar", ".cab", ".iso", ".img", ".vhd", ".vhdx"
+        };
+
+        private readonly Lane[] _lanes;
+        private readonly LaneDequeueMode _mode;
+        private readonly FileEventLane[] _weightedCycle;
+        private readonly SemaphoreSlim _signal = new(0);
+        private readonly PathPolicy? _pathPolicy;
+        private readonly int _highLaneBackpressureMs;
+        private int _cursor;
+        private volatile bool _completed;
         private bool _disposed;
 
         /// <summary>
         /// عدد العناصر المنتظرة (تقريبي)
         /// </summary>
-        public int PendingCount => _channel.Reader.Count;
+        public int PendingCount
+        {
+            get
+            {
+                int total = 0;
+                foreach (var lane in _lanes)
+                    total += lane.Channel.Reader.Count;
+                return total;
+            }
+        }
+
+        /// <summary>
+        /// حدث فُقد من مسار ممتلئ دون أن يُفحص
+        /// </summary>
+        public event EventHandler<FileEvent>? EventDropped;
 
         public FileEventQueue(int capacity = 10_000)
+            : this(FileEventQueueOptions.FromTotalCapacity(capacity))
+        {
+        }
+
+        public FileEventQueue(FileEventQueueOptions options)
         {
-            _capacity = capacity;
-            _channel = Channel.CreateBounded<FileEvent>(new BoundedChannelOptions(capacity)
+            _mode = options.Mode;
+            _pathPolicy = options.PathPolicy;
+            _highLaneBackpressureMs = Math.Max(0, options.HighLaneBackpressureMs);
+            _lanes = new[]
             {
-                FullMode = BoundedChannelFullMode.DropOldest,
-                SingleReader = false,
-                SingleWriter = false
-            });
+                new Lane(FileEventLane.High, options.HighCapacity, OnDropped),
+                new Lane(FileEventLane.Normal, options.NormalCapacity, OnDropped),
+                new Lane(FileEventLane.Low, options.LowCapacity, OnDropped)
+            };
+
+            _weightedCycle = BuildWeightedCycle(
+                Math.Max(1, options.HighWeight),
+                Math.Max(1, options.NormalWeight),
+                Math.Max(1, options.LowWeight));
+        }
+
+        /// <summary>
+        /// تصنيف الحدث إلى مسار
+        /// </summary>
+        /// <param name="pathPolicy">سياسة مجلدات التنزيلات - null يعني PathPolicy.Current</param>
+        public static FileEventLane Classify(FileEvent fileEvent, PathPolicy? pathPolicy = null)
+        {
+            if (fileEvent.RequiresQuickGate)
+                return FileEventLane.High;
+
+            var path = fileEvent.FilePath;
+            var ext = Path.GetExtension(path);
+
+            if (MetadataPreGate.IsExecutableExtension(ext) ||
+                (pathPolicy ?? PathPolicy.Current).Matches(path, PathClass.Download))
+            {
+                return FileEventLane.High;
+            }
+
+            if (DocumentExtensions.Contains(ext))
+                return FileEventLane.Normal;
+
+            return FileEventLane.Low;
         }
 
         /// <summary>
@@ -49,12 +222,58 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// </summary>
         public bool TryEnqueue(FileEvent fileEvent)
         {
-            if (PendingCount > _capacity * 0.8 && IsTemporaryPath(fileEvent.FilePath))
+            if (_completed) return false;
+
+            var lane = _lanes[(int)Classify(fileEvent, _pathPolicy)];
+
+            if (lane.Channel.Reader.Count > lane.Capacity * 0.8 && IsTemporaryPath(fileEvent.FilePath))
+            {
+                Interlocked.Increment(ref lane.Rejected);
+                return false;
+            }
+
+            if (!lane.Channel.Writer.TryWrite(fileEvent) && !WaitForHighLane(lane, fileEvent))
             {
+                if (lane.Id == FileEventLane.High && !_completed)
+                {
+                    Interlocked.Increment(ref lane.Dropped);
+                    OnDropped(fileEvent);
+                }
                 return false;
             }
 
-            return _channel.Writer.TryWrite(fileEvent);
+            Interlocked.Increment(ref lane.Enqueued);
+            _signal.Release();
+            return true;
+        }
+
+        /// <summary>
+        /// ضغط عكسي على كاتب المسار العالي الممتلئ (المسارات الأخرى تُزيح الأقدم فلا تمتلئ)
+        /// </summary>
+        private bool WaitForHighLane(Lane lane, FileEvent fileEvent)
+        {
+            if (lane.Id != FileEventLane.High || _highLaneBackpressureMs == 0 || _completed)
+                return false;
+
+            using var cts = new CancellationTokenSource(_highLaneBackpressureMs);
+            try
+            {
+                while (lane.Channel.Writer.WaitToWriteAsync(cts.Token).AsTask().GetAwaiter().GetResult())
+                {
+                    if (lane.Channel.Writer.TryWrite(fileEvent))
+                        return true;
+                }
+            }
+            catch (OperationCanceledException)
+            {
+            }
+
+            return false;
+        }
+
+        private void OnDropped(FileEvent fileEvent)
+        {
+            try { EventDropped?.Invoke(this, fileEvent); } catch { }
         }
 
         private static bool IsTemporaryPath(string path)
@@ -66,9 +285,14 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// <summary>
         /// قراءة الأحداث (async enumerable)
         /// </summary>
-        public IAsyncEnumerable<FileEvent> ReadAllAsync(CancellationToken ct = default)
+        public async IAsyncEnumerable<FileEvent> ReadAllAsync([EnumeratorCancellation] CancellationToken ct = default)
         {
-            return _channel.Reader.ReadAllAsync(ct);
+            while (true)
+            {
+                var fileEvent = await ReadNextAsync(ct).ConfigureAwait(false);
+                if (fileEvent == null) yield break;
+                yield return fileEvent;
+            }
         }
 
         /// <summary>
@@ -76,7 +300,8 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// </summary>
         public async ValueTask<FileEvent> DequeueAsync(CancellationToken ct = default)
         {
-            return await _channel.Reader.ReadAsync(ct);
+            return await ReadNextAsync(ct).ConfigureAwait(false)
+                ?? throw new ChannelClosedException();
         }
 
         /// <summary>
@@ -84,7 +309,39 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// </summary>
         public bool TryDequeue(out FileEvent? fileEvent)
         {
-            return _channel.Reader.TryRead(out fileEvent);
+            if (_mode == LaneDequeueMode.Weighted)
+            {
+                var preferred = _weightedCycle[(int)((uint)Interlocked.Increment(ref _cursor) % _weightedCycle.Length)];
+                if (TryRead(_lanes[(int)preferred], out fileEvent))
+                    return true;
+            }
+
+            // الأعلى أولاً (أو المسار المفضل فارغ)
+            foreach (var lane in _lanes)
+            {
+                if (TryRead(lane, out fileEvent))
+                    return true;
+            }
+
+            fileEvent = null;
+            return false;
+        }
+
+        /// <summary>
+        /// إحصائيات المسارات
+        /// </summary>
+        public IReadOnlyList<FileEventLaneStats> GetLaneStats()
+        {
+            return _lanes.Select(lane => new FileEventLaneStats
+            {
+                Lane = lane.Id,
+                Pending = lane.Channel.Reader.Count,
+                Capacity = lane.Capacity,
+                Enqueued = Interlocked.Read(ref lane.Enqueued),
+                Dequeued = Interlocked.Read(ref lane.Dequeued),
+                Dropped = Interlocked.Read(ref lane.Dropped),
+                Rejected = Interlocked.Read(ref lane.Rejected)
+            }).ToList();
         }
 
         /// <summary>
@@ -92,7 +349,69 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// </summary>
         public void Complete()
         {
-            _channel.Writer.TryComplete();
+            if (_completed) return;
+            _completed = true;
+
+            foreach (var lane in _lanes)
+                lane.Channel.Writer.TryComplete();
+
+            // إيقاظ القراء المنتظرين - كل قارئ يوقظ التالي عند الخروج
+            _signal.Release();
+        }
+
+        private async ValueTask<FileEvent?> ReadNextAsync(CancellationToken ct)
+        {
+            while (true)
+            {
+                if (TryDequeue(out var fileEvent))
+                    return fileEvent;
+
+                if (_completed)
+                {
+                    _signal.Release();
+                    return null;
+                }
+
+                // الإشارة قد تزيد عن العناصر (عند إزاحة الأقدم) - إيقاظ زائد يعود للانتظار
+                await _signal.WaitAsync(ct).ConfigureAwait(false);
+            }
+        }
+
+        private static bool TryRead(Lane lane, out FileEvent? fileEvent)
+        {
+            if (lane.Channel.Reader.TryRead(out fileEvent))
+            {
+                Interlocked.Increment(ref lane.Dequeued);
+                return true;
+            }
+
+            return false;
+        }
+
+        /// <summary>
+        /// دورة سحب موزونة ناعمة (smooth weighted round-robin) - مثلاً 8:3:1
+        /// </summary>
+        private static FileEventLane[] BuildWeightedCycle(params int[] weights)
+        {
+            var total = weights.Sum();
+            var current = new int[weights.Length];
+            var cycle = new FileEventLane[total];
+
+            for (int i = 0; i < total; i++)
+            {
+                int best = 0;
+                for (int lane = 0; lane < weights.Length; lane++)
+                {
+                    current[lane] += weights[lane];
+                    if (current[lane] > current[best])
+                        best = lane;
+                }
+
+                current[best] -= total;
+                cycle[i] = (FileEventLane)best;
+            }
+
+            return cycle;
         }
 
         public void Dispose()
@@ -101,5 +420,36 @@ namespace ShieldAI.Core.Monitoring.Pipeline
             Complete();
             _disposed = true;
         }
+
+        private sealed class Lane
+        {
+            public readonly FileEventLane Id;
+            public readonly int Capacity;
+            public readonly Channel<FileEvent> Channel;
+            public long Enqueued;
+            public long Dequeued;
+            public long Dropped;
+            public long Rejected;
+
+            public Lane(FileEventLane id, int capacity, Action<FileEvent> onDropped)
+            {
+                Id = id;
+                Capacity = Math.Max(1, capacity);
+                Channel = System.Threading.Channels.Channel.CreateBounded<FileEvent>(
+                    new BoundedChannelOptions(Capacity)
+                    {
+                        FullMode = id == FileEventLane.High
+                            ? BoundedChannelFullMode.Wait
+                            : BoundedChannelFullMode.DropOldest,
+                        SingleReader = false,
+                        SingleWriter = false
+                    },
+                    dropped =>
+                    {
+                        Interlocked.Increment(ref Dropped);
+                        onDropped(dropped);
+                    });
+            }
+        }
     }
 }
@@ -0,0 +1,219 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/Pipeline/LoadSheddingPolicy.cs
+// مستويات تخفيف الحمل حسب عمق الطابور وزمن الانتظار
+// =====================================================
+
+using ShieldAI.Core.Configuration;
+
+namespace ShieldAI.Core.Monitoring.Pipeline
+{
+    /// <summary>
+    /// مستوى تخفيف الحمل
+    /// </summary>
+    public enum LoadShedTier
+    {
+        Normal = 0,     // بلا تخفيف
+        Elevated = 1,   // توسيع نافذة التجميع
+        High = 2,       // + تخطي المحركات الثقيلة (ML/Reputation/Defender/VT) والرأي الثاني
+        Critical = 3    // + تأجيل غير التنفيذيات إلى طابور خلفي
+    }
+
+    /// <summary>
+    /// حدود المستويات
+    /// </summary>
+    public class LoadSheddingOptions
+    {
+        public int ElevatedDepth { get; set; } = 500;
+        public int HighDepth { get; set; } = 2_000;
+        public int CriticalDepth { get; set; } = 6_000;
+
+        public int ElevatedLatencyMs { get; set; } = 2_000;
+        public int HighLatencyMs { get; set; } = 5_000;
+        public int CriticalLatencyMs { get; set; } = 15_000;
+
+        /// <summary>
+        /// النزول من مستوى يتطلب أن تكون الإشارتان تحت (حد الدخول × هذه النسبة)
+        /// </summary>
+        public double RecoveryRatio { get; set; } = 0.4;
+
+        /// <summary>
+        /// مدة البقاء تحت حد الخروج قبل النزول مستوى واحد
+        /// </summary>
+        public int RecoveryHoldMs { get; set; } = 10_000;
+
+        public static LoadSheddingOptions FromSettings(AppSettings settings)
+        {
+            // High = حد الوضع المخفف القديم (أو حد الضغط العالي إن كان أقل) - نفس نقطة تخطي المحركات الثقيلة
+            var highDepth = Math.Max(1, Math.Min(settings.DegradedModeThreshold, settings.PipelineHighPressureThreshold));
+
+            return new LoadSheddingOptions
+            {
+                ElevatedDepth = Math.Min(settings.LoadShedElevatedDepth, highDepth),
+                HighDepth = highDepth,
+                CriticalDepth = Math.Max(settings.LoadShedCriticalDepth, highDepth),
+                ElevatedLatencyMs = settings.LoadShedElevatedLatencyMs,
+                HighLatencyMs = settings.LoadShedHighLatencyMs,
+                CriticalLatencyMs = settings.LoadShedCriticalLatencyMs,
+                RecoveryRatio = Math.Clamp(
+                    settings.DegradedRecoveryThreshold / (double)Math.Max(1, settings.DegradedModeThreshold), 0.05, 0.95),
+                RecoveryHoldMs = settings.LoadShedRecoveryHoldMs
+            };
+        }
+    }
+
+    /// <summary>
+    /// انتقال بين مستويين
+    /// </summary>
+    public class LoadTierTransition
+    {
+        public LoadShedTier From { get; set; }
+        public LoadShedTier To { get; set; }
+        public DateTime TimestampUtc { get; set; } = DateTime.UtcNow;
+        public int PendingEvents { get; set; }
+        public double QueueLatencyMs { get; set; }
+    }
+
+    /// <summary>
+    /// سياسة تخفيف الحمل: الصعود فوري إلى أعلى مستوى تتجاوزه أي إشارة،
+    /// والنزول مستوى واحد في كل مرة بعد بقاء الإشارتين تحت حد الخروج طوال مدة التثبيت (hysteresis).
+    /// </summary>
+    public class LoadSheddingPolicy
+    {
+        private const int HistorySize = 32;
+
+        private readonly LoadSheddingOptions _options;
+        private readonly object _lock = new();
+        private readonly Queue<LoadTierTransition> _history = new();
+        private LoadShedTier _tier = LoadShedTier.Normal;
+        private long? _belowExitSinceMs;
+        private long _transitionCount;
+
+        public LoadSheddingPolicy(LoadSheddingOptions? options = null)
+        {
+            _options = options ?? new LoadSheddingOptions();
+        }
+
+        /// <summary>
+        /// يُطلق خارج القفل بعد كل انتقال
+        /// </summary>
+        public event EventHandler<LoadTierTransition>? TierChanged;
+
+        public LoadShedTier CurrentTier
+        {
+            get { lock (_lock) return _tier; }
+        }
+
+        public long TransitionCount => Interlocked.Read(ref _transitionCount);
+
+        /// <summary>
+        /// آخر الانتقالات (الأقدم أولاً)
+        /// </summary>
+        public IReadOnlyList<LoadTierTransition> GetRecentTransitions()
+        {
+            lock (_lock) return _history.ToList();
+        }
+
+        /// <summary>
+        /// تقييم الإشارات وتحديث المستوى
+        /// </summary>
+        /// <param name="pendingEvents">عمق الطابور (القائمة + التجميع)</param>
+        /// <param name="queueLatencyMs">زمن انتظار الأحداث في القائمة</param>
+        public LoadShedTier Evaluate(int pendingEvents, double queueLatencyMs, long? nowMs = null)
+        {
+            var now = nowMs ?? Environment.TickCount64;
+            LoadTierTransition? transition = null;
+
+            lock (_lock)
+            {
+                var target = TargetTier(pendingEvents, queueLatencyMs);
+
+                if (target > _tier)
+                {
+                    transition = Transition(target, pendingEvents, queueLatencyMs);
+                }
+                else if (target < _tier && IsBelowExit(_tier, pendingEvents, queueLatencyMs))
+                {
+                    _belowExitSinceMs ??= now;
+                    if (now - _belowExitSinceMs.Value >= _options.RecoveryHoldMs)
+                    {
+                        transition = Transition(_tier - 1, pendingEvents, queueLatencyMs);
+                        // كل نزول إضافي يحتاج مدة تثبيت جديدة
+                        _belowExitSinceMs = now;
+                    }
+                }
+                else
+                {
+                    _belowExitSinceMs = null;
+                }
+            }
+
+            if (transition != null)
+            {
+                try { TierChanged?.Invoke(this, transition); } catch { }
+            }
+
+            return transition?.To ?? CurrentTier;
+        }
+
+        /// <summary>
+        /// مضاعف نافذة التجميع للمستوى
+        /// </summary>
+        public static int CoalesceMultiplier(LoadShedTier tier) => tier switch
+        {
+            LoadShedTier.Elevated => 2,
+            LoadShedTier.High => 4,
+            LoadShedTier.Critical => 8,
+            _ => 1
+        };
+
+        public static bool SkipsHeavyEngines(LoadShedTier tier) => tier >= LoadShedTier.High;
+
+        public static bool DefersNonExecutables(LoadShedTier tier) => tier >= LoadShedTier.Critical;
+
+        private LoadShedTier TargetTier(int depth, double latencyMs)
+        {
+            if (depth >= _options.CriticalDepth || latencyMs >= _options.CriticalLatencyMs)
+                return LoadShedTier.Critical;
+            if (depth >= _options.HighDepth || latencyMs >= _options.HighLatencyMs)
+                return LoadShedTier.High;
+            if (depth >= _options.ElevatedDepth || latencyMs >= _options.ElevatedLatencyMs)
+                return LoadShedTier.Elevated;
+            return LoadShedTier.Normal;
+        }
+
+        private bool IsBelowExit(LoadShedTier tier, int depth, double latencyMs)
+        {
+            var (enterDepth, enterLatency) = tier switch
+            {
+                LoadShedTier.Critical => (_options.CriticalDepth, _options.CriticalLatencyMs),
+                LoadShedTier.High => (_options.HighDepth, _options.HighLatencyMs),
+                _ => (_options.ElevatedDepth, _options.ElevatedLatencyMs)
+            };
+
+            return depth <= enterDepth * _options.RecoveryRatio &&
+                   latencyMs <= enterLatency * _options.RecoveryRatio;
+        }
+
+        private LoadTierTransition Transition(LoadShedTier to, int depth, double latencyMs)
+        {
+            var transition = new LoadTierTransition
+            {
+                From = _tier,
+                To = to,
+                PendingEvents = depth,
+                QueueLatencyMs = latencyMs
+            };
+
+            _tier = to;
+            _belowExitSinceMs = null;
+            Interlocked.Increment(ref _transitionCount);
+
+            _history.Enqueue(transition);
+            while (_history.Count > HistorySize)
+                _history.Dequeue();
+
+            return transition;
+        }
+    }
+}
@@ -0,0 +1,186 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/Pipeline/MetadataPreGate.cs
+// فرز أولي رخيص للأحداث بالبيانات الوصفية فقط
+// =====================================================
+
+using System.Buffers;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Scanning;
+
+namespace ShieldAI.Core.Monitoring.Pipeline
+{
+    /// <summary>
+    /// قرار الفرز الأولي
+    /// </summary>
+    public enum PreGateDecision
+    {
+        Skip,       // تجاهل الحدث
+        Scan,       // فحص عادي بعد التجميع
+        QuickGate   // محتوى تنفيذي: Quick Gate ثم فحص (مرة واحدة لكل ملف مجمّع)
+    }
+
+    /// <summary>
+    /// فرز أولي وقت الحدث - بدون hash وبدون تحليل PE:
+    /// سياسة المسار، الامتداد، الحجم، وأول 4KB من الملف فقط
+    /// </summary>
+    public class MetadataPreGate
+    {
+        /// <summary>
+        /// حجم الترويسة المقروءة لتحديد نوع المحتوى
+        /// </summary>
+        public const int HeaderSize = 4096;
+
+        private static readonly HashSet<string> ExecutableExtensions = new(StringComparer.OrdinalIgnoreCase)
+        {
+            ".exe", ".dll", ".sys", ".scr", ".com", ".cpl", ".ocx", ".drv", ".efi",
+            ".msi", ".msp", ".ps1", ".psm1", ".bat", ".cmd", ".vbs", ".vbe",
+            ".js", ".jse", ".wsf", ".wsh", ".hta", ".lnk", ".jar", ".sh"
+        };
+
+        // نفس قائمة PipelineScanWorker - الملفات المؤقتة لا تستحق حتى الانتظار في التجميع
+        private static readonly HashSet<string> TemporaryExtensions = new(StringComparer.OrdinalIgnoreCase)
+        {
+            ".tmp", ".log", ".etl", ".lock", ".journal",
+            ".partial", ".crdownload", ".download"
+        };
+
+        private static readonly string[] TemporaryPrefixes = { "~$", "~WRL", ".~lock" };
+
+        private readonly AppSettings _settings;
+        private readonly HashSet<string> _excludedExtensions;
+        private readonly PathPolicy _pathPolicy;
+
+        public MetadataPreGate(AppSettings settings)
+        {
+            _settings = settings;
+
+            _excludedExtensions = settings.ExcludedExtensions
+                .Select(e => e.Trim().TrimStart('.').ToLowerInvariant())
+                .ToHashSet();
+
+            _pathPolicy = PathPolicy.FromSettings(settings);
+        }
+
+        /// <summary>
+        /// تقييم حدث ملف
+        /// </summary>
+        public PreGateDecision Evaluate(string filePath)
+        {
+            try
+            {
+                if (!IsAllowedByPathPolicy(filePath))
+                    return PreGateDecision.Skip;
+
+                var fileInfo = new FileInfo(filePath);
+                if (!fileInfo.Exists)
+                    return PreGateDecision.Skip;
+
+                if (fileInfo.Length > _settings.MaxFileSizeMB * 1024L * 1024L)
+                    return PreGateDecision.Skip;
+
+                if (ExecutableExtensions.Contains(fileInfo.Extension))
+                    return PreGateDecision.QuickGate;
+
+                // ملف فارغ (قيد الإنشاء) - حدث الكتابة التالي سيُقيَّم من جديد
+                if (fileInfo.Length == 0)
+                    return PreGateDecision.Scan;
+
+                return HasExecutableHeader(filePath)
+                    ? PreGateDecision.QuickGate
+                    : PreGateDecision.Scan;
+            }
+            catch
+            {
+                return PreGateDecision.Scan;
+            }
+        }
+
+        /// <summary>
+        /// سياسة المسار: الاستثناءات، الحجر، والملفات المؤقتة
+        /// </summary>
+        public bool IsAllowedByPathPolicy(string filePath)
+        {
+            var fileName = Path.GetFileName(filePath);
+            var ext = Path.GetExtension(filePath);
+
+            if (_excludedExtensions.Contains(ext.TrimStart('.').ToLowerInvariant()))
+                return false;
+
+            if (TemporaryExtensions.Contains(ext))
+                return false;
+
+            foreach (var prefix in TemporaryPrefixes)
+            {
+                if (fileName.StartsWith(prefix, StringComparison.OrdinalIgnoreCase))
+                    return false;
+            }
+
+            return !_pathPolicy.Matches(filePath, PathClass.Excluded | PathClass.Quarantine);
+        }
+
+        private static bool HasExecutableHeader(string filePath)
+        {
+            var buffer = ArrayPool<byte>.Shared.Rent(HeaderSize);
+            try
+            {
+                int read;
+                using (var stream = new FileStream(
+                    filePath, FileMode.Open, FileAccess.Read,
+                    FileShare.ReadWrite | FileShare.Delete, bufferSize: 1))
+                {
+                    read = stream.ReadAtLeast(buffer.AsSpan(0, HeaderSize), HeaderSize, throwOnEndOfStream: false);
+                }
+
+                return IsExecutableContent(buffer.AsSpan(0, read));
+            }
+            catch (IOException)
+            {
+                // مقفل للكتابة: نعامله كتنفيذي ليحصل على Quick Gate بعد التجميع
+                return true;
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(buffer);
+            }
+        }
+
+        /// <summary>
+        /// هل الامتداد لملف تنفيذي أو سكربت
+        /// </summary>
+        public static bool IsExecutableExtension(string extension) =>
+            ExecutableExtensions.Contains(extension);
+
+        /// <summary>
+        /// هل الترويسة لمحتوى تنفيذي (PE / ELF / Mach-O / سكربت shebang / OLE بماكرو محتمل)
+        /// </summary>
+        public static bool IsExecutableContent(ReadOnlySpan<byte> header)
+        {
+            if (header.Length < 2)
+                return false;
+
+            // PE/DOS: MZ
+            if (header[0] == 'M' && header[1] == 'Z')
+                return true;
+
+            // سكربت: #!
+            if (header[0] == '#' && header[1] == '!')
+                return true;
+
+            if (header.Length < 4)
+                return false;
+
+            uint magic = (uint)(header[0] << 24 | header[1] << 16 | header[2] << 8 | header[3]);
+
+            return magic switch
+            {
+                0x7F454C46 => true,                         // ELF
+                0xFEEDFACE or 0xFEEDFACF => true,           // Mach-O (big endian)
+                0xCEFAEDFE or 0xCFFAEDFE => true,           // Mach-O (little endian)
+                0xCAFEBABE => true,                         // Mach-O fat / Java class
+                0xD0CF11E0 => true,                         // OLE (مستندات Office القديمة)
+                _ => false
+            };
+        }
+    }
+}
@@ -4,10 +4,12 @@
 // عامل الفحص - يقرأ من القائمة ويفحص الملفات
 // =====================================================
 
+using System.Collections.Concurrent;
 using Microsoft.Extensions.Logging;
 using ShieldAI.Core.Configuration;
 using ShieldAI.Core.Detection.ThreatScoring;
 using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
 
 namespace ShieldAI.Core.Monitoring.Pipeline
 {
@@ -18,10 +20,20 @@ namespace ShieldAI.Core.Monitoring.Pipeline
     {
         private readonly FileEventQueue _queue;
         private readonly ThreatAggregator _aggregator;
+        private readonly ScanExecutor _executor;
         private readonly ILogger? _logger;
         private readonly AppSettings _settings;
-        private readonly HashSet<string> _quarantinedPaths;
         private readonly object _quarantineLock = new();
+        private readonly PathPolicy _pathPolicy;
+
+        // مسارات الحجر الديناميكية خارج السياسة المترجمة: إضافة تزايدية بلا إعادة بناء
+        private readonly ConcurrentDictionary<string, byte> _quarantinedFiles = new(StringComparer.OrdinalIgnoreCase);
+        private string[] _quarantinedDirectories = Array.Empty<string>();
+        private readonly ConcurrentDictionary<string, InFlightScan> _inFlight = new(StringComparer.OrdinalIgnoreCase);
+        private long _dirtyMarks;
+        private long _followUpScans;
+        private long _deferredEvents;
+        private long _latencyBits;
         private CancellationTokenSource? _cts;
         private readonly List<Task> _workerTasks = new();
         private bool _disposed;
@@ -43,18 +55,62 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         public event EventHandler<string>? FileScanStarted;
         public event EventHandler<AggregatedThreatResult>? FileScanCompleted;
 
+        /// <summary>
+        /// انتهت معالجة حدث الملف (فُحص أو استُبعد بالفلاتر) - لا يُطلق عند الإلغاء أو الخطأ
+        /// </summary>
+        public event EventHandler<string>? FileEventHandled;
+
         public bool IsRunning { get; private set; }
 
+        /// <summary>
+        /// عدد الملفات قيد الفحص حالياً
+        /// </summary>
+        public int InFlightCount => _inFlight.Count;
+
+        /// <summary>
+        /// أحداث وصلت أثناء فحص نفس الملف (دُمجت بدل فحص متوازٍ)
+        /// </summary>
+        public long DirtyMarkCount => Interlocked.Read(ref _dirtyMarks);
+
+        /// <summary>
+        /// فحوصات المتابعة التي نُفذت بعد انتهاء فحص ملف متسخ
+        /// </summary>
+        public long FollowUpScanCount => Interlocked.Read(ref _followUpScans);
+
+        /// <summary>
+        /// Quick Gate للمحتوى التنفيذي - يُستدعى مرة واحدة لكل ملف مجمّع بنفس السياق المبني.
+        /// يرجع true إذا عالج الملف (مثلاً حجره) فيُتخطى الفحص الكامل.
+        /// </summary>
+        public Func<ThreatScanContext, CancellationToken, Task<bool>>? QuickGate { get; set; }
+
+        /// <summary>
+        /// تأجيل حدث تحت الضغط - يرجع true إذا أخذ الحدث (فلا يُفحص الآن)
+        /// </summary>
+        public Func<FileEvent, bool>? DeferFilter { get; set; }
+
+        /// <summary>
+        /// أحداث أُجّلت عبر DeferFilter
+        /// </summary>
+        public long DeferredEventCount => Interlocked.Read(ref _deferredEvents);
+
+        /// <summary>
+        /// متوسط زمن انتظار الأحداث في القائمة (EWMA، مللي ثانية) - صفر إذا كانت القائمة فارغة
+        /// </summary>
+        public double QueueLatencyMs =>
+            _queue.PendingCount == 0 ? 0 : BitConverter.Int64BitsToDouble(Interlocked.Read(ref _latencyBits));
+
         public PipelineScanWorker(
             FileEventQueue queue,
             ThreatAggregator aggregator,
-            ILogger? logger = null)
+            ILogger? logger = null,
+            ScanExecutor? executor = null)
         {
             _queue = queue;
             _aggregator = aggregator;
+            _executor = executor ?? ScanExecutor.Shared;
             _logger = logger;
             _settings = ConfigManager.Instance.Settings;
-            _quarantinedPaths = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+            _pathPolicy = PathPolicy.FromSettings(_settings);
         }
 
         /// <summary>
@@ -105,9 +161,22 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// </summary>
         public void AddQuarantinedPath(string path)
         {
+            var fullPath = Path.TrimEndingDirectorySeparator(NormalizeKey(path));
+
+            if (!Directory.Exists(fullPath))
+            {
+                _quarantinedFiles.TryAdd(fullPath, 0);
+                return;
+            }
+
+            // المجلدات نادرة (مجلد الحجر نفسه) - نسخة جديدة من المصفوفة تُنشر للعمال
             lock (_quarantineLock)
             {
-                _quarantinedPaths.Add(Path.GetFullPath(path).ToLowerInvariant());
+                var current = _quarantinedDirectories;
+                if (current.Contains(fullPath, StringComparer.OrdinalIgnoreCase))
+                    return;
+
+                Volatile.Write(ref _quarantinedDirectories, current.Append(fullPath).ToArray());
             }
         }
 
@@ -124,8 +193,16 @@ namespace ShieldAI.Core.Monitoring.Pipeline
                 {
                     if (ct.IsCancellationRequested) break;
 
+                    RecordQueueLatency(fileEvent.Timestamp);
+
                     try
                     {
+                        if (DeferFilter?.Invoke(fileEvent) == true)
+                        {
+                            Interlocked.Increment(ref _deferredEvents);
+                            continue;
+                        }
+
                         await ProcessEventAsync(fileEvent, ct);
                     }
                     catch (OperationCanceledException)
@@ -145,9 +222,140 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         }
 
         /// <summary>
-        /// معالجة حدث ملف واحد
+        /// تحديث متوسط زمن الانتظار (وزن العينة الجديدة 0.2)
+        /// </summary>
+        private void RecordQueueLatency(DateTime enqueuedUtc)
+        {
+            var sample = Math.Max(0, (DateTime.UtcNow - enqueuedUtc).TotalMilliseconds);
+
+            long initial, updated;
+            do
+            {
+                initial = Interlocked.Read(ref _latencyBits);
+                var current = BitConverter.Int64BitsToDouble(initial);
+                updated = BitConverter.DoubleToInt64Bits(current + 0.2 * (sample - current));
+            }
+            while (Interlocked.CompareExchange(ref _latencyBits, updated, initial) != initial);
+        }
+
+        /// <summary>
+        /// معالجة حدث ملف واحد - ملف واحد لا يُفحص على عاملين في نفس الوقت.
+        /// الأحداث أثناء الفحص تعلّم الملف "متسخاً" فيُفحص مرة واحدة إضافية بعد الانتهاء.
         /// </summary>
         private async Task ProcessEventAsync(FileEvent fileEvent, CancellationToken ct)
+        {
+            var key = NormalizeKey(fileEvent.FilePath);
+            if (!TryBeginScan(key, fileEvent, out var inFlight))
+                return;
+
+            try
+            {
+                var current = fileEvent;
+                while (true)
+                {
+                    await ScanFileAsync(current, ct);
+                    FileEventHandled?.Invoke(this, current.FilePath);
+
+                    if (!TryTakeFollowUp(key, inFlight, out current))
+                        break;
+
+                    Interlocked.Increment(ref _followUpScans);
+                }
+            }
+            finally
+            {
+                EndScan(key, inFlight);
+            }
+        }
+
+        /// <summary>
+        /// تسجيل الملف كقيد الفحص، أو تعليمه متسخاً إذا كان يُفحص على عامل آخر
+        /// </summary>
+        private bool TryBeginScan(string key, FileEvent fileEvent, out InFlightScan inFlight)
+        {
+            while (true)
+            {
+                if (_inFlight.TryGetValue(key, out var existing))
+                {
+                    lock (existing)
+                    {
+                        // انتهى للتو - نعيد المحاولة لنصبح المالك
+                        if (existing.Completed)
+                            continue;
+
+                        existing.Dirty = true;
+                        existing.ChangeType = fileEvent.ChangeType;
+                        existing.RequiresQuickGate |= fileEvent.RequiresQuickGate;
+                        existing.OriginProcessId = fileEvent.OriginProcessId ?? existing.OriginProcessId;
+                    }
+
+                    Interlocked.Increment(ref _dirtyMarks);
+                    inFlight = existing;
+                    return false;
+                }
+
+                inFlight = new InFlightScan(fileEvent.FilePath);
+                if (_inFlight.TryAdd(key, inFlight))
+                    return true;
+            }
+        }
+
+        private bool TryTakeFollowUp(string key, InFlightScan inFlight, out FileEvent followUp)
+        {
+            lock (inFlight)
+            {
+                if (inFlight.Dirty)
+                {
+                    inFlight.Dirty = false;
+                    followUp = new FileEvent
+                    {
+                        FilePath = inFlight.FilePath,
+                        ChangeType = inFlight.ChangeType,
+                        RequiresQuickGate = inFlight.RequiresQuickGate,
+                        OriginProcessId = inFlight.OriginProcessId
+                    };
+                    inFlight.RequiresQuickGate = false;
+                    return true;
+                }
+
+                inFlight.Completed = true;
+            }
+
+            _inFlight.TryRemove(new KeyValuePair<string, InFlightScan>(key, inFlight));
+            followUp = null!;
+            return false;
+        }
+
+        /// <summary>
+        /// تحرير الملف عند الخروج (بما في ذلك الإلغاء أو الخطأ)
+        /// </summary>
+        private void EndScan(string key, InFlightScan inFlight)
+        {
+            lock (inFlight)
+            {
+                if (inFlight.Completed) return;
+                inFlight.Completed = true;
+            }
+
+            _inFlight.TryRemove(new KeyValuePair<string, InFlightScan>(key, inFlight));
+        }
+
+        private static string NormalizeKey(string filePath)
+        {
+            try
+            {
+                return Path.GetFullPath(filePath);
+            }
+            catch
+            {
+                return filePath;
+            }
+        }
+
+        /// <summary>
+        /// فحص ملف واحد (الفلاتر + Quick Gate + الفحص الكامل)
+        /// </summary>
+        private async Task ScanFileAsync(FileEvent fileEvent, CancellationToken ct)
         {
             var filePath = fileEvent.FilePath;
 
@@ -173,8 +381,26 @@ namespace ShieldAI.Core.Monitoring.Pipeline
             // === الفحص ===
             FileScanStarted?.Invoke(this, filePath);
 
-            var context = _aggregator.BuildContext(filePath);
-            var result = await _aggregator.ScanAsync(context, ct);
+            // أولوية الفحص الفوري في المنفذ المشترك
+            // السياق (hash + PE) يُبنى مرة واحدة ويُشارك بين Quick Gate والفحص الكامل
+            var context = await _executor.RunAsync(ScanPriorityClass.Realtime,
+                _ => Task.FromResult(_aggregator.BuildContext(filePath)), ct);
+
+            if (fileEvent.OriginProcessId.HasValue)
+            {
+                context.OriginProcessId = fileEvent.OriginProcessId;
+                context.OriginProcessPath ??= TryGetProcessPath(fileEvent.OriginProcessId.Value);
+            }
+
+            var quickGate = QuickGate;
+            if (fileEvent.RequiresQuickGate && quickGate != null &&
+                await quickGate(context, ct).ConfigureAwait(false))
+            {
+                return;
+            }
+
+            var result = await _executor.RunAsync(ScanPriorityClass.Realtime,
+                token => _aggregator.ScanAsync(context, token), ct);
 
             FileScanCompleted?.Invoke(this, result);
 
@@ -193,15 +419,39 @@ namespace ShieldAI.Core.Monitoring.Pipeline
         /// </summary>
         private bool IsQuarantinePath(string filePath)
         {
-            var normalized = Path.GetFullPath(filePath).ToLowerInvariant();
-
-            // فحص مسار الحجر من الإعدادات
-            if (normalized.Contains(_settings.QuarantinePath.ToLowerInvariant()))
+            var fullPath = NormalizeKey(filePath);
+            if (_quarantinedFiles.ContainsKey(fullPath))
                 return true;
 
-            lock (_quarantineLock)
+            foreach (var directory in Volatile.Read(ref _quarantinedDirectories))
+            {
+                if (fullPath.StartsWith(directory, StringComparison.OrdinalIgnoreCase) &&
+                    (fullPath.Length == directory.Length || IsSeparator(fullPath[directory.Length])))
+                    return true;
+            }
+
+            return _pathPolicy.Matches(fullPath, PathClass.Quarantine);
+        }
+
+        private static bool IsSeparator(char c) =>
+            c == Path.DirectorySeparatorChar || c == Path.AltDirectorySeparatorChar;
+
+        /// <summary>
+        /// مسار الملف التنفيذي للعملية الكاتبة (Linux: /proc/PID/exe) - null إذا انتهت العملية
+        /// </summary>
+        private static string? TryGetProcessPath(int processId)
+        {
+            try
+            {
+                if (OperatingSystem.IsLinux())
+                    return File.ResolveLinkTarget($"/proc/{processId}/exe", returnFinalTarget: false)?.FullName;
+
+                using var process = System.Diagnostics.Process.GetProcessById(processId);
+                return process.MainModule?.FileName;
+            }
+            catch
             {
-                return _quarantinedPaths.Any(qp => normalized.StartsWith(qp));
+                return null;
             }
         }
 
@@ -234,5 +484,23 @@ namespace ShieldAI.Core.Monitoring.Pipeline
             _cts?.Cancel();
             _cts?.Dispose();
         }
+
+        /// <summary>
+        /// ملف قيد الفحص
+        /// </summary>
+        private sealed class InFlightScan
+        {
+            public string FilePath { get; }
+            public WatcherChangeTypes ChangeType { get; set; }
+            public bool RequiresQuickGate { get; set; }
+            public int? OriginProcessId { get; set; }
+            public bool Dirty { get; set; }
+            public bool Completed { get; set; }
+
+            public InFlightScan(string filePath)
+            {
+                FilePath = filePath;
+            }
+        }
     }
 }
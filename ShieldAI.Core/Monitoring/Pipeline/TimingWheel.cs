@@ -0,0 +1,159 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/Pipeline/TimingWheel.cs
+// عجلة توقيت هرمية للمهل - كلفة التقدم تتناسب مع العناصر المستحقة
+// =====================================================
+
+namespace ShieldAI.Core.Monitoring.Pipeline
+{
+    /// <summary>
+    /// عجلة توقيت هرمية (Hierarchical Timing Wheel).
+    /// المستوى 0 دقته tick واحد، وكل مستوى أعلى يغطي (عدد الخانات) ضعف المستوى الذي تحته.
+    /// العناصر البعيدة تنزل للمستويات الأدنى عند اقتراب موعدها، فلا يُمسح كل المعلق في كل tick.
+    /// ليست thread-safe - المستدعي مسؤول عن القفل.
+    /// </summary>
+    public class TimingWheel<T>
+    {
+        private readonly long _tickMs;
+        private readonly int _bits;
+        private readonly int _mask;
+        private readonly List<(T Item, long DueTick)>?[][] _levels;
+        private readonly List<(T Item, long DueTick)> _overdue = new();
+        private readonly long _maxDelta;
+        private long _currentTick;
+
+        /// <summary>
+        /// عدد العناصر المجدولة
+        /// </summary>
+        public int Count { get; private set; }
+
+        /// <summary>
+        /// دقة العجلة بالمللي ثانية
+        /// </summary>
+        public long TickMs => _tickMs;
+
+        /// <param name="tickMs">دقة المستوى الأدنى</param>
+        /// <param name="slotBits">log2 لعدد الخانات في كل مستوى (6 = 64 خانة)</param>
+        /// <param name="levels">عدد المستويات (4 × 64 خانة × 50ms ≈ 9 أيام)</param>
+        /// <param name="startMs">الوقت الحالي بنفس وحدة Advance</param>
+        public TimingWheel(long tickMs, int slotBits = 6, int levels = 4, long startMs = 0)
+        {
+            if (tickMs <= 0) throw new ArgumentOutOfRangeException(nameof(tickMs));
+            if (slotBits is < 1 or > 10) throw new ArgumentOutOfRangeException(nameof(slotBits));
+            if (levels is < 1 or > 8) throw new ArgumentOutOfRangeException(nameof(levels));
+
+            _tickMs = tickMs;
+            _bits = slotBits;
+            _mask = (1 << slotBits) - 1;
+            _levels = new List<(T, long)>?[levels][];
+            for (int i = 0; i < levels; i++)
+                _levels[i] = new List<(T, long)>?[1 << slotBits];
+
+            _maxDelta = (1L << (slotBits * levels)) - 1;
+            _currentTick = startMs / tickMs;
+        }
+
+        /// <summary>
+        /// جدولة عنصر ليستحق عند dueMs
+        /// </summary>
+        public void Schedule(T item, long dueMs)
+        {
+            // التقريب للأعلى: لا يستحق العنصر قبل موعده
+            var dueTick = (dueMs + _tickMs - 1) / _tickMs;
+            Place(item, dueTick);
+            Count++;
+        }
+
+        /// <summary>
+        /// تقديم العجلة حتى nowMs وإضافة العناصر المستحقة إلى expired
+        /// </summary>
+        public void Advance(long nowMs, ICollection<T> expired)
+        {
+            var targetTick = nowMs / _tickMs;
+
+            DrainOverdue(expired);
+
+            while (_currentTick < targetTick)
+            {
+                _currentTick++;
+
+                // إنزال المستويات الأعلى عند بداية كتلتها (من الأعلى للأدنى)
+                for (int level = _levels.Length - 1; level >= 1; level--)
+                {
+                    var blockMask = (1L << (_bits * level)) - 1;
+                    if ((_currentTick & blockMask) != 0)
+                        continue;
+
+                    var index = (int)((_currentTick >> (_bits * level)) & _mask);
+                    var bucket = _levels[level][index];
+                    if (bucket == null || bucket.Count == 0)
+                        continue;
+
+                    _levels[level][index] = null;
+                    foreach (var (item, dueTick) in bucket)
+                        Place(item, dueTick);
+                }
+
+                var slot = (int)(_currentTick & _mask);
+                var due = _levels[0][slot];
+                if (due != null && due.Count > 0)
+                {
+                    _levels[0][slot] = null;
+                    foreach (var (item, _) in due)
+                    {
+                        expired.Add(item);
+                        Count--;
+                    }
+                }
+
+                DrainOverdue(expired);
+            }
+        }
+
+        /// <summary>
+        /// إزالة جميع العناصر
+        /// </summary>
+        public void Clear()
+        {
+            foreach (var level in _levels)
+                Array.Clear(level);
+
+            _overdue.Clear();
+            Count = 0;
+        }
+
+        private void Place(T item, long dueTick)
+        {
+            var delta = dueTick - _currentTick;
+            if (delta <= 0)
+            {
+                _overdue.Add((item, dueTick));
+                return;
+            }
+
+            // العناصر الأبعد من مدى العجلة توضع في آخر المدى وتُعاد جدولتها عند الإنزال
+            var placementTick = delta > _maxDelta ? _currentTick + _maxDelta : dueTick;
+            delta = placementTick - _currentTick;
+
+            int level = 0;
+            while (level < _levels.Length - 1 && delta >= 1L << (_bits * (level + 1)))
+                level++;
+
+            var index = (int)((placementTick >> (_bits * level)) & _mask);
+            (_levels[level][index] ??= new List<(T, long)>()).Add((item, dueTick));
+        }
+
+        private void DrainOverdue(ICollection<T> expired)
+        {
+            if (_overdue.Count == 0) return;
+
+            foreach (var (item, _) in _overdue)
+            {
+                expired.Add(item);
+                Count--;
+            }
+
+            _overdue.Clear();
+        }
+    }
+}
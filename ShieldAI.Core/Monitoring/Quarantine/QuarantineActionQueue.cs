@@ -0,0 +1,364 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/Quarantine/QuarantineActionQueue.cs
+// قائمة إجراءات الحجر المحدودة: دفعات بتثبيت واحد وتشفير متوازٍ
+// =====================================================
+
+using System.Threading.Channels;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Logging;
+
+namespace ShieldAI.Core.Monitoring.Quarantine
+{
+    /// <summary>
+    /// إعدادات قائمة إجراءات الحجر
+    /// </summary>
+    public class QuarantineActionQueueOptions
+    {
+        /// <summary>
+        /// سعة القائمة - المنتج ينتظر عند الامتلاء بدلاً من إسقاط التهديد
+        /// </summary>
+        public int Capacity { get; set; } = 4096;
+
+        /// <summary>
+        /// أقصى عدد طلبات في دفعة واحدة (إلحاق واحد في سجل metadata)
+        /// </summary>
+        public int MaxBatchSize { get; set; } = 64;
+
+        /// <summary>
+        /// عمليات التشفير المتوازية - نصف الأنوية افتراضياً حتى لا تجوع عمال الفحص
+        /// </summary>
+        public int MaxParallelism { get; set; } = Math.Max(1, Environment.ProcessorCount / 2);
+
+        public int AtomicMoveMaxRetries { get; set; } = 6;
+        public int AtomicMoveInitialDelayMs { get; set; } = 60;
+        public int AtomicMoveMaxDelayMs { get; set; } = 800;
+
+        /// <summary>
+        /// مهلة تصريف الطلبات المعلقة عند الإيقاف
+        /// </summary>
+        public TimeSpan DrainTimeout { get; set; } = TimeSpan.FromSeconds(10);
+
+        public static QuarantineActionQueueOptions FromSettings(AppSettings settings) => new()
+        {
+            Capacity = Math.Max(1, settings.QuarantineQueueCapacity),
+            MaxBatchSize = Math.Max(1, settings.QuarantineBatchSize),
+            MaxParallelism = settings.QuarantineCryptoWorkers > 0
+                ? settings.QuarantineCryptoWorkers
+                : Math.Max(1, Environment.ProcessorCount / 2),
+            AtomicMoveMaxRetries = settings.AtomicMoveMaxRetries,
+            AtomicMoveInitialDelayMs = settings.AtomicMoveInitialDelayMs,
+            AtomicMoveMaxDelayMs = settings.AtomicMoveMaxDelayMs
+        };
+    }
+
+    /// <summary>
+    /// قائمة إجراءات الحجر: كل إجراءات التهديد تمر من هنا بترتيب وصولها.
+    /// قارئ واحد يسحب دفعة، ينفذ النقل الذري والتشفير بالتوازي، ثم يثبت
+    /// metadata الدفعة كلها بإلحاق واحد - فانتشار 10k ملف لا يدفع 10k تثبيت على القرص.
+    /// </summary>
+    public sealed class QuarantineActionQueue : IDisposable
+    {
+        private enum ActionKind
+        {
+            Quarantine,
+            Restore,
+            Delete
+        }
+
+        private sealed class WorkItem
+        {
+            public ActionKind Kind { get; init; }
+            public QuarantineRequest? Quarantine { get; init; }
+            public QuarantineRestoreRequest? Restore { get; init; }
+            public string? DeleteId { get; init; }
+
+            public TaskCompletionSource<QuarantineItemOutcome> Completion { get; } =
+                new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+            public string Target => Kind switch
+            {
+                ActionKind.Quarantine => Quarantine!.Target,
+                ActionKind.Restore => Restore!.ItemId,
+                _ => DeleteId!
+            };
+        }
+
+        private readonly QuarantineStore _store;
+        private readonly QuarantineActionQueueOptions _options;
+        private readonly ILogger? _logger;
+        private readonly Channel<WorkItem> _channel;
+        private readonly CancellationTokenSource _cts = new();
+        private readonly Task _dispatcher;
+
+        private long _batchesProcessed;
+        private long _itemsProcessed;
+        private long _waitingPosts;
+        private long _overflowedPosts;
+        private bool _disposed;
+
+        public QuarantineActionQueue(
+            QuarantineStore store,
+            QuarantineActionQueueOptions? options = null,
+            ILogger? logger = null)
+        {
+            _store = store;
+            _options = options ?? QuarantineActionQueueOptions.FromSettings(ConfigManager.Instance.Settings);
+            _logger = logger;
+
+            _channel = Channel.CreateBounded<WorkItem>(new BoundedChannelOptions(Math.Max(1, _options.Capacity))
+            {
+                FullMode = BoundedChannelFullMode.Wait,
+                SingleReader = true,
+                SingleWriter = false
+            });
+
+            _dispatcher = Task.Run(DispatchLoopAsync);
+        }
+
+        /// <summary>
+        /// عدد الطلبات المنتظرة
+        /// </summary>
+        public int PendingCount => _channel.Reader.Count;
+
+        /// <summary>
+        /// عدد الدفعات المنفذة
+        /// </summary>
+        public long BatchesProcessed => Interlocked.Read(ref _batchesProcessed);
+
+        /// <summary>
+        /// عدد الطلبات المنفذة (ناجحة أو فاشلة)
+        /// </summary>
+        public long ItemsProcessed => Interlocked.Read(ref _itemsProcessed);
+
+        /// <summary>
+        /// طلبات Post تنتظر مكاناً في القائمة الممتلئة حالياً
+        /// </summary>
+        public long WaitingPostCount => Interlocked.Read(ref _waitingPosts);
+
+        /// <summary>
+        /// إجمالي طلبات Post التي وجدت القائمة ممتلئة
+        /// </summary>
+        public long OverflowedPostCount => Interlocked.Read(ref _overflowedPosts);
+
+        /// <summary>
+        /// حجر ملف - ينتظر مكاناً في القائمة ثم اكتمال الدفعة
+        /// </summary>
+        public async Task<QuarantineItemOutcome> QuarantineAsync(QuarantineRequest request, CancellationToken ct = default)
+        {
+            var item = new WorkItem { Kind = ActionKind.Quarantine, Quarantine = request };
+            if (!await TryEnqueueAsync(item, ct).ConfigureAwait(false))
+                return QueueClosed(item);
+
+            return await item.Completion.Task.WaitAsync(ct).ConfigureAwait(false);
+        }
+
+        /// <summary>
+        /// إضافة طلب حجر من سياق متزامن (معالجات الأحداث) دون حجب المستدعي.
+        /// عند امتلاء القائمة ينتظر الطلب مكانه بشكل غير متزامن ويُحتسب في WaitingPostCount.
+        /// </summary>
+        /// <returns>مهمة تكتمل بنتيجة الطلب</returns>
+        public Task<QuarantineItemOutcome> Post(QuarantineRequest request)
+        {
+            var item = new WorkItem { Kind = ActionKind.Quarantine, Quarantine = request };
+
+            return _channel.Writer.TryWrite(item)
+                ? item.Completion.Task
+                : PostWhenFullAsync(item);
+        }
+
+        private async Task<QuarantineItemOutcome> PostWhenFullAsync(WorkItem item)
+        {
+            Interlocked.Increment(ref _overflowedPosts);
+            Interlocked.Increment(ref _waitingPosts);
+            try
+            {
+                if (!await TryEnqueueAsync(item, CancellationToken.None).ConfigureAwait(false))
+                    return QueueClosed(item);
+            }
+            finally
+            {
+                Interlocked.Decrement(ref _waitingPosts);
+            }
+
+            return await item.Completion.Task.ConfigureAwait(false);
+        }
+
+        /// <summary>
+        /// حجر عدة ملفات - النتائج بنفس ترتيب الطلبات
+        /// </summary>
+        public Task<QuarantineItemOutcome[]> QuarantineManyAsync(IEnumerable<QuarantineRequest> requests, CancellationToken ct = default) =>
+            EnqueueManyAsync(requests.Select(r => new WorkItem { Kind = ActionKind.Quarantine, Quarantine = r }), ct);
+
+        /// <summary>
+        /// استعادة عدة عناصر - النتائج بنفس ترتيب الطلبات
+        /// </summary>
+        public Task<QuarantineItemOutcome[]> RestoreManyAsync(IEnumerable<QuarantineRestoreRequest> requests, CancellationToken ct = default) =>
+            EnqueueManyAsync(requests.Select(r => new WorkItem { Kind = ActionKind.Restore, Restore = r }), ct);
+
+        /// <summary>
+        /// حذف عدة عناصر نهائياً - النتائج بنفس ترتيب المعرفات
+        /// </summary>
+        public Task<QuarantineItemOutcome[]> DeleteManyAsync(IEnumerable<string> itemIds, CancellationToken ct = default) =>
+            EnqueueManyAsync(itemIds.Select(id => new WorkItem { Kind = ActionKind.Delete, DeleteId = id }), ct);
+
+        private async Task<QuarantineItemOutcome[]> EnqueueManyAsync(IEnumerable<WorkItem> items, CancellationToken ct)
+        {
+            var tasks = new List<Task<QuarantineItemOutcome>>();
+            foreach (var item in items)
+            {
+                tasks.Add(await TryEnqueueAsync(item, ct).ConfigureAwait(false)
+                    ? item.Completion.Task
+                    : Task.FromResult(QueueClosed(item)));
+            }
+
+            return await Task.WhenAll(tasks).WaitAsync(ct).ConfigureAwait(false);
+        }
+
+        private async Task<bool> TryEnqueueAsync(WorkItem item, CancellationToken ct)
+        {
+            try
+            {
+                await _channel.Writer.WriteAsync(item, ct).ConfigureAwait(false);
+                return true;
+            }
+            catch (ChannelClosedException)
+            {
+                return false;
+            }
+        }
+
+        private static QuarantineItemOutcome QueueClosed(WorkItem item) =>
+            QuarantineItemOutcome.Failed(item.Target, "Quarantine queue is shut down");
+
+        private async Task DispatchLoopAsync()
+        {
+            var reader = _channel.Reader;
+            var batch = new List<WorkItem>(_options.MaxBatchSize);
+
+            try
+            {
+                while (await reader.WaitToReadAsync(_cts.Token).ConfigureAwait(false))
+                {
+                    batch.Clear();
+                    while (batch.Count < _options.MaxBatchSize && reader.TryRead(out var item))
+                        batch.Add(item);
+
+                    // تنفيذ المقاطع المتتالية من نفس النوع يحفظ ترتيب الوصول بين الحجر والاستعادة
+                    int start = 0;
+                    while (start < batch.Count)
+                    {
+                        int end = start;
+                        while (end < batch.Count && batch[end].Kind == batch[start].Kind)
+                            end++;
+
+                        await ProcessRunAsync(batch.GetRange(start, end - start)).ConfigureAwait(false);
+                        start = end;
+                    }
+
+                    Interlocked.Increment(ref _batchesProcessed);
+                    Interlocked.Add(ref _itemsProcessed, batch.Count);
+                }
+            }
+            catch (OperationCanceledException) when (_cts.IsCancellationRequested)
+            {
+            }
+        }
+
+        private async Task ProcessRunAsync(List<WorkItem> run)
+        {
+            try
+            {
+                var outcomes = run[0].Kind switch
+                {
+                    ActionKind.Quarantine => await ProcessQuarantineRunAsync(run).ConfigureAwait(false),
+                    ActionKind.Restore => await _store.RestoreFilesAsync(
+                        run.Select(w => w.Restore!).ToList(), _options.MaxParallelism).ConfigureAwait(false),
+                    _ => await _store.DeleteFilesAsync(run.Select(w => w.DeleteId!).ToList()).ConfigureAwait(false)
+                };
+
+                for (int i = 0; i < run.Count; i++)
+                    run[i].Completion.TrySetResult(outcomes[i]);
+            }
+            catch (Exception ex)
+            {
+                _logger?.Error(ex, "فشل تنفيذ دفعة إجراءات الحجر");
+                foreach (var item in run)
+                    item.Completion.TrySetResult(QuarantineItemOutcome.Failed(item.Target, ex.Message));
+            }
+        }
+
+        private async Task<IReadOnlyList<QuarantineItemOutcome>> ProcessQuarantineRunAsync(List<WorkItem> run)
+        {
+            var outcomes = new QuarantineItemOutcome[run.Count];
+            var prepared = new QuarantineRequest?[run.Count];
+
+            // النقل الذري أولاً وبالتوازي: يمنع تنفيذ الملف بينما تنتظر الدفعة التشفير
+            await Parallel.ForEachAsync(
+                Enumerable.Range(0, run.Count),
+                new ParallelOptions { MaxDegreeOfParallelism = _options.MaxParallelism },
+                async (index, _) =>
+                {
+                    var request = run[index].Quarantine!;
+                    if (!request.AtomicMove)
+                    {
+                        prepared[index] = request;
+                        return;
+                    }
+
+                    var (success, movedPath) = await _store.TryAtomicMoveToQuarantineAsync(
+                        request.FilePath,
+                        _options.AtomicMoveMaxRetries,
+                        _options.AtomicMoveInitialDelayMs,
+                        _options.AtomicMoveMaxDelayMs).ConfigureAwait(false);
+
+                    if (success && movedPath != null)
+                        prepared[index] = request with { FilePath = movedPath, OriginalPath = request.Target, AtomicMove = false };
+                    else
+                        outcomes[index] = QuarantineItemOutcome.Failed(request.Target, "Quarantine failed - file locked or inaccessible");
+                }).ConfigureAwait(false);
+
+            var indexes = Enumerable.Range(0, run.Count).Where(i => prepared[i] != null).ToList();
+            var stored = await _store.QuarantineFilesAsync(
+                indexes.Select(i => prepared[i]!).ToList(), _options.MaxParallelism).ConfigureAwait(false);
+
+            for (int i = 0; i < indexes.Count; i++)
+            {
+                var outcome = stored[i];
+                if (!outcome.Success)
+                    _logger?.Warning("فشل حجر {0}: {1}", outcome.Target, outcome.Error ?? "");
+                outcomes[indexes[i]] = outcome;
+            }
+
+            return outcomes;
+        }
+
+        /// <summary>
+        /// إيقاف القائمة: الطلبات المعلقة تُصرَّف ضمن المهلة، وما يتبقى يُبلَّغ بفشله
+        /// </summary>
+        public void Dispose()
+        {
+            if (_disposed)
+                return;
+            _disposed = true;
+
+            _channel.Writer.TryComplete();
+            try
+            {
+                if (!_dispatcher.Wait(_options.DrainTimeout))
+                {
+                    _cts.Cancel();
+                    _dispatcher.Wait(TimeSpan.FromSeconds(2));
+                }
+            }
+            catch (AggregateException)
+            {
+            }
+
+            while (_channel.Reader.TryRead(out var item))
+                item.Completion.TrySetResult(QueueClosed(item));
+
+            _cts.Dispose();
+        }
+    }
+}
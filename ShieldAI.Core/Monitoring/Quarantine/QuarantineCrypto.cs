@@ -1,9 +1,12 @@
 // =====================================================
 // ShieldAI - AI-Powered Antivirus Solution
 // Monitoring/Quarantine/QuarantineCrypto.cs
-// تشفير آمن باستخدام DPAPI + AES
+// تشفير آمن باستخدام DPAPI + AES (حاوية مجزأة AES-GCM + الصيغة القديمة)
 // =====================================================
 
+using System.Buffers;
+using System.Buffers.Binary;
+using System.IO.Compression;
 using System.Security.Cryptography;
 
 namespace ShieldAI.Core.Monitoring.Quarantine
@@ -12,8 +15,37 @@ namespace ShieldAI.Core.Monitoring.Quarantine
     /// تشفير آمن للحجر الصحي
     /// يستخدم DPAPI لحماية مفتاح AES بدلاً من مفتاح ثابت
     /// </summary>
+    /// <remarks>
+    /// الحاوية المجزأة (الإصدار 2):
+    /// [Magic "SQR2":4][Version:1][Flags:1][Reserved:2][ChunkSize:4][Salt:16]
+    /// العلم 0x01: المحتوى مضغوط (Brotli) قبل تقسيمه إلى قطع
+    /// ثم قطع: [Length|FinalBit:4][Ciphertext][Tag:16]
+    /// المفتاح مشتق لكل ملف من الملح (HKDF)، والـ nonce هو رقم القطعة،
+    /// والترويسة + رقم القطعة + حقل الطول بيانات مصادَق عليها (AAD)
+    /// فلا يمكن حذف القطع أو إعادة ترتيبها أو اقتطاع الملف دون كشف ذلك
+    /// </remarks>
     public class QuarantineCrypto
     {
+        /// <summary>
+        /// حجم القطعة الافتراضي للحاوية المجزأة
+        /// </summary>
+        public const int DefaultChunkSize = 256 * 1024;
+
+        /// <summary>
+        /// إصدار الحاوية المجزأة
+        /// </summary>
+        public const int ChunkedFormatVersion = 2;
+
+        private const int HeaderSize = 28;
+        private const int SaltSize = 16;
+        private const int TagSize = 16;
+        private const int NonceSize = 12;
+        private const uint FinalChunkFlag = 0x80000000;
+        private const byte CompressedFlag = 0x01;
+        private const int CopyBufferSize = 81920;
+        private static readonly byte[] ChunkedMagic = "SQR2"u8.ToArray();
+        private static readonly byte[] ChunkKeyInfo = "ShieldAI.Quarantine.Chunked.v2"u8.ToArray();
+
         private readonly string _keyFilePath;
         private byte[]? _cachedKey;
         private readonly object _keyLock = new();
@@ -41,7 +73,437 @@ namespace ShieldAI.Core.Monitoring.Quarantine
         }
 
         /// <summary>
-        /// تشفير البيانات
+        /// تشفير تدفق إلى حاوية مجزأة بذاكرة ثابتة
+        /// </summary>
+        /// <param name="compress">ضغط المحتوى (Brotli) قبل التشفير - يُسجَّل في أعلام الترويسة</param>
+        /// <returns>بصمة SHA256 للنص الأصلي وحجمه (محسوبة أثناء القراءة)</returns>
+        public async Task<(string Sha256Hash, long Length)> EncryptStreamAsync(
+            Stream input,
+            Stream output,
+            int chunkSize = DefaultChunkSize,
+            bool compress = false,
+            CancellationToken ct = default)
+        {
+            if (chunkSize <= 0 || (chunkSize & FinalChunkFlag) != 0)
+                throw new ArgumentOutOfRangeException(nameof(chunkSize));
+
+            var header = new byte[HeaderSize];
+            ChunkedMagic.CopyTo(header, 0);
+            header[4] = ChunkedFormatVersion;
+            header[5] = compress ? CompressedFlag : (byte)0;
+            BinaryPrimitives.WriteInt32LittleEndian(header.AsSpan(8), chunkSize);
+            RandomNumberGenerator.Fill(header.AsSpan(12, SaltSize));
+
+            await output.WriteAsync(header, ct).ConfigureAwait(false);
+
+            using var aes = new AesGcm(DeriveChunkKey(header.AsSpan(12, SaltSize)), TagSize);
+            using var chunks = new ChunkEncryptStream(output, aes, header, chunkSize);
+            using var sha = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+            long total;
+
+            if (compress)
+            {
+                // إغلاق الضاغط يدفع ما تبقى إلى القطع قبل إنهائها
+                await using var brotli = new BrotliStream(chunks, CompressionLevel.Fastest, leaveOpen: true);
+                total = await CopyHashedAsync(input, brotli, sha, ct).ConfigureAwait(false);
+            }
+            else
+            {
+                total = await CopyHashedAsync(input, chunks, sha, ct).ConfigureAwait(false);
+            }
+
+            await chunks.CompleteAsync(ct).ConfigureAwait(false);
+            return (Convert.ToHexString(sha.GetHashAndReset()).ToLowerInvariant(), total);
+        }
+
+        /// <summary>
+        /// فك تشفير حاوية (مجزأة أو قديمة) إلى تدفق
+        /// كل قطعة يُتحقق منها قبل كتابتها؛ الاقتطاع أو التلاعب يرمي CryptographicException
+        /// </summary>
+        /// <returns>بصمة SHA256 للنص الأصلي وحجمه</returns>
+        public async Task<(string Sha256Hash, long Length)> DecryptStreamAsync(
+            Stream input,
+            Stream output,
+            CancellationToken ct = default)
+        {
+            var header = new byte[HeaderSize];
+            var headerRead = await ReadFullAsync(input, header, ct).ConfigureAwait(false);
+
+            if (headerRead < HeaderSize || !header.AsSpan(0, 4).SequenceEqual(ChunkedMagic))
+                return await DecryptLegacyStreamAsync(header.AsMemory(0, headerRead), input, output, ct).ConfigureAwait(false);
+
+            if (header[4] != ChunkedFormatVersion)
+                throw new CryptographicException($"إصدار حاوية الحجر غير مدعوم: {header[4]}");
+
+            if ((header[5] & ~CompressedFlag) != 0)
+                throw new CryptographicException($"أعلام حاوية الحجر غير مدعومة: {header[5]}");
+
+            var chunkSize = BinaryPrimitives.ReadInt32LittleEndian(header.AsSpan(8));
+            if (chunkSize <= 0 || chunkSize > 64 * 1024 * 1024)
+                throw new CryptographicException("حجم قطعة غير صالح في حاوية الحجر");
+
+            using var aes = new AesGcm(DeriveChunkKey(header.AsSpan(12, SaltSize)), TagSize);
+            using var chunks = new ChunkDecryptStream(input, aes, header, chunkSize);
+            using var sha = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+            long total;
+
+            if ((header[5] & CompressedFlag) != 0)
+            {
+                await using (var brotli = new BrotliStream(chunks, CompressionMode.Decompress, leaveOpen: true))
+                    total = await CopyHashedAsync(brotli, output, sha, ct).ConfigureAwait(false);
+
+                // نهاية الضغط لا تعني نهاية الحاوية - نستهلك حتى القطعة الأخيرة وفحص الذيل
+                if (await chunks.ReadAsync(new byte[1], ct).ConfigureAwait(false) != 0)
+                    throw new CryptographicException("بيانات زائدة بعد نهاية المحتوى المضغوط");
+            }
+            else
+            {
+                total = await CopyHashedAsync(chunks, output, sha, ct).ConfigureAwait(false);
+            }
+
+            return (Convert.ToHexString(sha.GetHashAndReset()).ToLowerInvariant(), total);
+        }
+
+        /// <summary>
+        /// هل التدفق حاوية مجزأة (لا يغيّر موضع القراءة)
+        /// </summary>
+        public static bool IsChunkedContainer(Stream stream)
+        {
+            var position = stream.Position;
+            try
+            {
+                Span<byte> magic = stackalloc byte[4];
+                return stream.ReadAtLeast(magic, 4, throwOnEndOfStream: false) == 4 &&
+                       magic.SequenceEqual(ChunkedMagic);
+            }
+            finally
+            {
+                stream.Position = position;
+            }
+        }
+
+        /// <summary>
+        /// الصيغة القديمة [IV][CBC][HMAC] تتطلب التحقق من HMAC قبل أي فك - تُقرأ كاملة
+        /// </summary>
+        private async Task<(string Sha256Hash, long Length)> DecryptLegacyStreamAsync(
+            ReadOnlyMemory<byte> prefix,
+            Stream input,
+            Stream output,
+            CancellationToken ct)
+        {
+            using var buffer = new MemoryStream();
+            buffer.Write(prefix.Span);
+            await input.CopyToAsync(buffer, ct).ConfigureAwait(false);
+
+            var plain = Decrypt(buffer.ToArray());
+            await output.WriteAsync(plain, ct).ConfigureAwait(false);
+            return (ComputeSha256(plain), plain.LongLength);
+        }
+
+        private byte[] DeriveChunkKey(ReadOnlySpan<byte> salt)
+        {
+            return HKDF.DeriveKey(HashAlgorithmName.SHA256, GetOrCreateKey(), 32, salt.ToArray(), ChunkKeyInfo);
+        }
+
+        /// <summary>
+        /// nonce = رقم القطعة؛ AAD = الترويسة + رقم القطعة + حقل الطول
+        /// </summary>
+        private static void FillChunkParameters(byte[] aad, byte[] nonce, long index, uint lengthField)
+        {
+            BinaryPrimitives.WriteInt64LittleEndian(aad.AsSpan(HeaderSize), index);
+            BinaryPrimitives.WriteUInt32LittleEndian(aad.AsSpan(HeaderSize + 8), lengthField);
+            BinaryPrimitives.WriteInt64LittleEndian(nonce, index);
+        }
+
+        private static async Task<int> ReadFullAsync(Stream stream, Memory<byte> buffer, CancellationToken ct)
+        {
+            return await stream.ReadAtLeastAsync(buffer, buffer.Length, throwOnEndOfStream: false, ct).ConfigureAwait(false);
+        }
+
+        /// <summary>
+        /// نسخ تدفق مع حساب SHA256 لما يمر عبره
+        /// </summary>
+        private static async Task<long> CopyHashedAsync(Stream from, Stream to, IncrementalHash sha, CancellationToken ct)
+        {
+            var buffer = ArrayPool<byte>.Shared.Rent(CopyBufferSize);
+            long total = 0;
+
+            try
+            {
+                int read;
+                while ((read = await from.ReadAsync(buffer.AsMemory(0, CopyBufferSize), ct).ConfigureAwait(false)) > 0)
+                {
+                    sha.AppendData(buffer, 0, read);
+                    total += read;
+                    await to.WriteAsync(buffer.AsMemory(0, read), ct).ConfigureAwait(false);
+                }
+            }
+            finally
+            {
+                CryptographicOperations.ZeroMemory(buffer.AsSpan(0, CopyBufferSize));
+                ArrayPool<byte>.Shared.Return(buffer);
+            }
+
+            return total;
+        }
+
+        /// <summary>
+        /// تدفق كتابة يجمع البيانات في قطع ثابتة الحجم ويشفّر كل قطعة عند امتلائها
+        /// القطعة الممتلئة لا تُكتب إلا عند وصول بيانات بعدها، فالقطعة الأخيرة تُعلَّم دائماً
+        /// </summary>
+        private sealed class ChunkEncryptStream : Stream
+        {
+            private readonly Stream _output;
+            private readonly AesGcm _aes;
+            private readonly int _chunkSize;
+            private readonly byte[] _plain;
+            private readonly byte[] _record;
+            private readonly byte[] _aad = new byte[HeaderSize + 12];
+            private readonly byte[] _nonce = new byte[NonceSize];
+            private int _filled;
+            private long _index;
+            private bool _disposed;
+
+            public ChunkEncryptStream(Stream output, AesGcm aes, byte[] header, int chunkSize)
+            {
+                _output = output;
+                _aes = aes;
+                _chunkSize = chunkSize;
+                _plain = ArrayPool<byte>.Shared.Rent(chunkSize);
+                _record = ArrayPool<byte>.Shared.Rent(4 + chunkSize + TagSize);
+                header.CopyTo(_aad, 0);
+            }
+
+            public override bool CanRead => false;
+            public override bool CanSeek => false;
+            public override bool CanWrite => true;
+            public override long Length => throw new NotSupportedException();
+            public override long Position { get => throw new NotSupportedException(); set => throw new NotSupportedException(); }
+
+            public override async ValueTask WriteAsync(ReadOnlyMemory<byte> buffer, CancellationToken cancellationToken = default)
+            {
+                while (!buffer.IsEmpty)
+                {
+                    if (_filled == _chunkSize)
+                        await _output.WriteAsync(_record.AsMemory(0, SealChunk(final: false)), cancellationToken).ConfigureAwait(false);
+
+                    var count = Fill(buffer.Span);
+                    buffer = buffer[count..];
+                }
+            }
+
+            public override void Write(ReadOnlySpan<byte> buffer)
+            {
+                while (!buffer.IsEmpty)
+                {
+                    if (_filled == _chunkSize)
+                        _output.Write(_record, 0, SealChunk(final: false));
+
+                    buffer = buffer[Fill(buffer)..];
+                }
+            }
+
+            public override Task WriteAsync(byte[] buffer, int offset, int count, CancellationToken cancellationToken) =>
+                WriteAsync(buffer.AsMemory(offset, count), cancellationToken).AsTask();
+
+            public override void Write(byte[] buffer, int offset, int count) => Write(buffer.AsSpan(offset, count));
+
+            /// <summary>
+            /// كتابة القطعة الأخيرة (قد تكون فارغة إن امتلأت السابقة تماماً)
+            /// </summary>
+            public async Task CompleteAsync(CancellationToken ct)
+            {
+                if (_filled == _chunkSize)
+                    await _output.WriteAsync(_record.AsMemory(0, SealChunk(final: false)), ct).ConfigureAwait(false);
+
+                await _output.WriteAsync(_record.AsMemory(0, SealChunk(final: true)), ct).ConfigureAwait(false);
+            }
+
+            // القطع الناقصة لا تُدفع عند Flush - حدود القطع يحددها الحجم فقط
+            public override void Flush() { }
+
+            private int Fill(ReadOnlySpan<byte> data)
+            {
+                var count = Math.Min(_chunkSize - _filled, data.Length);
+                data[..count].CopyTo(_plain.AsSpan(_filled));
+                _filled += count;
+                return count;
+            }
+
+            private int SealChunk(bool final)
+            {
+                var length = _filled;
+                var lengthField = (uint)length | (final ? FinalChunkFlag : 0);
+
+                BinaryPrimitives.WriteUInt32LittleEndian(_record, lengthField);
+                FillChunkParameters(_aad, _nonce, _index++, lengthField);
+                _aes.Encrypt(
+                    _nonce,
+                    _plain.AsSpan(0, length),
+                    _record.AsSpan(4, length),
+                    _record.AsSpan(4 + length, TagSize),
+                    _aad);
+
+                _filled = 0;
+                return 4 + length + TagSize;
+            }
+
+            public override int Read(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+            public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+            public override void SetLength(long value) => throw new NotSupportedException();
+
+            protected override void Dispose(bool disposing)
+            {
+                if (_disposed)
+                    return;
+                _disposed = true;
+
+                CryptographicOperations.ZeroMemory(_plain.AsSpan(0, _chunkSize));
+                ArrayPool<byte>.Shared.Return(_plain);
+                ArrayPool<byte>.Shared.Return(_record);
+                base.Dispose(disposing);
+            }
+        }
+
+        /// <summary>
+        /// تدفق قراءة يفك القطع ويتحقق منها عند الطلب
+        /// بعد القطعة الأخيرة يتأكد من عدم وجود بيانات زائدة
+        /// </summary>
+        private sealed class ChunkDecryptStream : Stream
+        {
+            private readonly Stream _input;
+            private readonly AesGcm _aes;
+            private readonly int _chunkSize;
+            private readonly byte[] _record;
+            private readonly byte[] _plain;
+            private readonly byte[] _lengthBytes = new byte[4];
+            private readonly byte[] _aad = new byte[HeaderSize + 12];
+            private readonly byte[] _nonce = new byte[NonceSize];
+            private int _offset;
+            private int _available;
+            private long _index;
+            private bool _finished;
+            private bool _disposed;
+
+            public ChunkDecryptStream(Stream input, AesGcm aes, byte[] header, int chunkSize)
+            {
+                _input = input;
+                _aes = aes;
+                _chunkSize = chunkSize;
+                _record = ArrayPool<byte>.Shared.Rent(chunkSize + TagSize);
+                _plain = ArrayPool<byte>.Shared.Rent(chunkSize);
+                header.CopyTo(_aad, 0);
+            }
+
+            public override bool CanRead => true;
+            public override bool CanSeek => false;
+            public override bool CanWrite => false;
+            public override long Length => throw new NotSupportedException();
+            public override long Position { get => throw new NotSupportedException(); set => throw new NotSupportedException(); }
+
+            public override async ValueTask<int> ReadAsync(Memory<byte> buffer, CancellationToken cancellationToken = default)
+            {
+                while (_offset == _available)
+                {
+                    if (_finished || buffer.IsEmpty)
+                        return 0;
+
+                    if (await ReadFullAsync(_input, _lengthBytes, cancellationToken).ConfigureAwait(false) < 4)
+                        throw new CryptographicException("حاوية الحجر مقتطعة - القطعة الأخيرة مفقودة");
+
+                    var length = ParseLength(out var final);
+                    if (await ReadFullAsync(_input, _record.AsMemory(0, length + TagSize), cancellationToken).ConfigureAwait(false) < length + TagSize)
+                        throw new CryptographicException("حاوية الحجر مقتطعة");
+
+                    OpenChunk(length, final);
+                    if (final && await ReadFullAsync(_input, _lengthBytes.AsMemory(0, 1), cancellationToken).ConfigureAwait(false) != 0)
+                        throw new CryptographicException("بيانات زائدة بعد القطعة الأخيرة في حاوية الحجر");
+                }
+
+                return Drain(buffer.Span);
+            }
+
+            public override int Read(Span<byte> buffer)
+            {
+                while (_offset == _available)
+                {
+                    if (_finished || buffer.IsEmpty)
+                        return 0;
+
+                    if (_input.ReadAtLeast(_lengthBytes, 4, throwOnEndOfStream: false) < 4)
+                        throw new CryptographicException("حاوية الحجر مقتطعة - القطعة الأخيرة مفقودة");
+
+                    var length = ParseLength(out var final);
+                    if (_input.ReadAtLeast(_record.AsSpan(0, length + TagSize), length + TagSize, throwOnEndOfStream: false) < length + TagSize)
+                        throw new CryptographicException("حاوية الحجر مقتطعة");
+
+                    OpenChunk(length, final);
+                    if (final && _input.ReadAtLeast(_lengthBytes.AsSpan(0, 1), 1, throwOnEndOfStream: false) != 0)
+                        throw new CryptographicException("بيانات زائدة بعد القطعة الأخيرة في حاوية الحجر");
+                }
+
+                return Drain(buffer);
+            }
+
+            public override Task<int> ReadAsync(byte[] buffer, int offset, int count, CancellationToken cancellationToken) =>
+                ReadAsync(buffer.AsMemory(offset, count), cancellationToken).AsTask();
+
+            public override int Read(byte[] buffer, int offset, int count) => Read(buffer.AsSpan(offset, count));
+
+            private int ParseLength(out bool final)
+            {
+                var lengthField = BinaryPrimitives.ReadUInt32LittleEndian(_lengthBytes);
+                final = (lengthField & FinalChunkFlag) != 0;
+                var length = (int)(lengthField & ~FinalChunkFlag);
+                if (length > _chunkSize || (!final && length != _chunkSize))
+                    throw new CryptographicException("طول قطعة غير صالح في حاوية الحجر");
+                return length;
+            }
+
+            private void OpenChunk(int length, bool final)
+            {
+                var lengthField = (uint)length | (final ? FinalChunkFlag : 0);
+                FillChunkParameters(_aad, _nonce, _index++, lengthField);
+                _aes.Decrypt(
+                    _nonce,
+                    _record.AsSpan(0, length),
+                    _record.AsSpan(length, TagSize),
+                    _plain.AsSpan(0, length),
+                    _aad);
+
+                _offset = 0;
+                _available = length;
+                _finished = final;
+            }
+
+            private int Drain(Span<byte> buffer)
+            {
+                var count = Math.Min(buffer.Length, _available - _offset);
+                _plain.AsSpan(_offset, count).CopyTo(buffer);
+                _offset += count;
+                return count;
+            }
+
+            public override void Flush() { }
+            public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+            public override void SetLength(long value) => throw new NotSupportedException();
+            public override void Write(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+
+            protected override void Dispose(bool disposing)
+            {
+                if (_disposed)
+                    return;
+                _disposed = true;
+
+                CryptographicOperations.ZeroMemory(_plain.AsSpan(0, _chunkSize));
+                ArrayPool<byte>.Shared.Return(_plain);
+                ArrayPool<byte>.Shared.Return(_record);
+                base.Dispose(disposing);
+            }
+        }
+
+        /// <summary>
+        /// تشفير البيانات (الصيغة القديمة - للتوافق فقط)
         /// </summary>
         public byte[] Encrypt(byte[] plainData)
         {
@@ -70,7 +532,7 @@ namespace ShieldAI.Core.Monitoring.Quarantine
         }
 
         /// <summary>
-        /// فك تشفير البيانات
+        /// فك تشفير البيانات (الصيغة القديمة)
         /// </summary>
         public byte[] Decrypt(byte[] encryptedPackage)
         {
@@ -69,10 +69,15 @@ namespace ShieldAI.Core.Monitoring.Quarantine
         public string? ThreatName { get; set; }
 
         /// <summary>
-        /// اسم ملف الحجر المشفر
+        /// اسم ملف الحجر المشفر ({sha256}.qar - مشترك بين العناصر ذات المحتوى نفسه)
         /// </summary>
         public string QuarantineFileName { get; set; } = "";
 
+        /// <summary>
+        /// إصدار صيغة ملف الحجر (1 = قديمة كاملة في الذاكرة، 2 = مجزأة AES-GCM)
+        /// </summary>
+        public int ContainerVersion { get; set; } = 1;
+
         /// <summary>
         /// هل تم الاستعادة
         /// </summary>
@@ -83,6 +88,11 @@ namespace ShieldAI.Core.Monitoring.Quarantine
         /// </summary>
         public DateTime? RestoredAt { get; set; }
 
+        /// <summary>
+        /// نسخة سطحية (لتحديث عنصر عبر السجل دون تعديل النسخة الحية)
+        /// </summary>
+        public QuarantineItemMetadata Clone() => (QuarantineItemMetadata)MemberwiseClone();
+
         /// <summary>
         /// إنشاء من نتيجة مجمّعة
         /// </summary>
@@ -0,0 +1,252 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/Quarantine/QuarantineJournal.cs
+// سجل إلحاقي لتغييرات metadata الحجر مع سلسلة HMAC
+// =====================================================
+
+using System.Buffers.Binary;
+using System.Text.Json;
+using System.Text.Json.Serialization;
+
+namespace ShieldAI.Core.Monitoring.Quarantine
+{
+    /// <summary>
+    /// نوع عملية السجل
+    /// </summary>
+    public enum QuarantineJournalOp
+    {
+        Put,
+        Remove,
+        Clear
+    }
+
+    /// <summary>
+    /// عملية واحدة على metadata الحجر (العمليات متساوية الأثر عند تكرارها)
+    /// </summary>
+    public sealed class QuarantineJournalEntry
+    {
+        public QuarantineJournalOp Op { get; set; }
+
+        [JsonIgnore(Condition = JsonIgnoreCondition.WhenWritingNull)]
+        public string? Id { get; set; }
+
+        [JsonIgnore(Condition = JsonIgnoreCondition.WhenWritingNull)]
+        public QuarantineItemMetadata? Item { get; set; }
+
+        public static QuarantineJournalEntry Put(QuarantineItemMetadata item) => new() { Op = QuarantineJournalOp.Put, Id = item.Id, Item = item };
+
+        public static QuarantineJournalEntry Remove(string id) => new() { Op = QuarantineJournalOp.Remove, Id = id };
+
+        public static QuarantineJournalEntry Clear() => new() { Op = QuarantineJournalOp.Clear };
+
+        /// <summary>
+        /// تطبيق العملية على قاموس العناصر
+        /// </summary>
+        public void ApplyTo(Dictionary<string, QuarantineItemMetadata> items)
+        {
+            switch (Op)
+            {
+                case QuarantineJournalOp.Put when Item != null:
+                    items[Item.Id] = Item;
+                    break;
+                case QuarantineJournalOp.Remove when Id != null:
+                    items.Remove(Id);
+                    break;
+                case QuarantineJournalOp.Clear:
+                    items.Clear();
+                    break;
+            }
+        }
+    }
+
+    /// <summary>
+    /// سجل إلحاقي (append-only) فوق لقطة metadata.json:
+    /// كل سجل يحمل HMAC(HMAC السابق || المحتوى) فلا يمكن حذف أو تعديل أو إعادة ترتيب
+    /// سجل دون كسر السلسلة. بذرة السلسلة هي HMAC اللقطة نفسها، فالسجل المتبقي
+    /// من لقطة قديمة (انقطاع بين كتابة اللقطة وتصفير السجل) يُتجاهل تلقائياً.
+    /// غير آمن للاستدعاء المتزامن - المالك يسلسل الاستدعاءات.
+    /// </summary>
+    public sealed class QuarantineJournal : IDisposable
+    {
+        // الترويسة: "SQJ1" + رقم الإصدار + بذرة السلسلة
+        private const uint Magic = 0x314A5153;
+        private const ushort FormatVersion = 1;
+        private const int MacSize = 32;
+        private const int HeaderSize = 6 + MacSize;
+
+        // السجل: length(4) + mac(32) + payload(JSON)
+        private const int RecordHeaderSize = 4 + MacSize;
+        private const int MaxPayloadSize = 16 * 1024 * 1024;
+
+        private readonly string _path;
+        private readonly Func<byte[], byte[]> _computeMac;
+        private FileStream? _stream;
+        private byte[] _chainMac = new byte[MacSize];
+
+        /// <param name="path">مسار ملف السجل</param>
+        /// <param name="computeMac">HMAC بمفتاح الحجر</param>
+        public QuarantineJournal(string path, Func<byte[], byte[]> computeMac)
+        {
+            _path = path;
+            _computeMac = computeMac;
+        }
+
+        /// <summary>
+        /// عدد السجلات منذ آخر لقطة
+        /// </summary>
+        public long RecordCount { get; private set; }
+
+        /// <summary>
+        /// حجم ملف السجل بالبايت
+        /// </summary>
+        public long Length => _stream?.Length ?? 0;
+
+        /// <summary>
+        /// فتح السجل وإعادة تشغيل السجلات الصالحة المرتبطة باللقطة
+        /// الذيل الممزق أو المكسور يُقص؛ السجل التابع للقطة أخرى يُصفَّر
+        /// </summary>
+        /// <param name="genesis">HMAC اللقطة الحالية</param>
+        public List<QuarantineJournalEntry> Open(byte[] genesis)
+        {
+            _stream?.Dispose();
+            _stream = OpenStream();
+
+            var entries = new List<QuarantineJournalEntry>();
+            RecordCount = 0;
+
+            Span<byte> header = stackalloc byte[HeaderSize];
+            var validHeader = _stream.ReadAtLeast(header, HeaderSize, throwOnEndOfStream: false) == HeaderSize &&
+                              BinaryPrimitives.ReadUInt32LittleEndian(header) == Magic &&
+                              BinaryPrimitives.ReadUInt16LittleEndian(header[4..]) == FormatVersion &&
+                              header[6..].SequenceEqual(genesis);
+
+            if (!validHeader)
+            {
+                Reset(genesis);
+                return entries;
+            }
+
+            _chainMac = genesis.ToArray();
+            long validLength = HeaderSize;
+            var recordHeader = new byte[RecordHeaderSize];
+
+            while (_stream.ReadAtLeast(recordHeader, RecordHeaderSize, throwOnEndOfStream: false) == RecordHeaderSize)
+            {
+                var length = BinaryPrimitives.ReadInt32LittleEndian(recordHeader);
+                if (length <= 0 || length > MaxPayloadSize || validLength + RecordHeaderSize + length > _stream.Length)
+                    break;
+
+                var payload = new byte[length];
+                if (_stream.ReadAtLeast(payload, length, throwOnEndOfStream: false) != length)
+                    break;
+
+                var expected = ChainMac(_chainMac, payload);
+                if (!System.Security.Cryptography.CryptographicOperations.FixedTimeEquals(expected, recordHeader.AsSpan(4, MacSize)))
+                    break;
+
+                QuarantineJournalEntry? entry;
+                try
+                {
+                    entry = JsonSerializer.Deserialize<QuarantineJournalEntry>(payload);
+                }
+                catch (JsonException)
+                {
+                    break;
+                }
+
+                if (entry != null)
+                    entries.Add(entry);
+
+                _chainMac = expected;
+                validLength += RecordHeaderSize + length;
+                RecordCount++;
+            }
+
+            // ذيل ممزق من كتابة انقطعت أو سجل مكسور - ما بعده غير موثوق
+            if (_stream.Length != validLength)
+                _stream.SetLength(validLength);
+
+            _stream.Seek(0, SeekOrigin.End);
+            return entries;
+        }
+
+        /// <summary>
+        /// إلحاق دفعة عمليات بكتابة واحدة وتثبيت واحد على القرص
+        /// </summary>
+        public void Append(IReadOnlyList<QuarantineJournalEntry> entries)
+        {
+            var stream = _stream ?? throw new InvalidOperationException("السجل غير مفتوح");
+            if (entries.Count == 0)
+                return;
+
+            using var buffer = new MemoryStream();
+            var chain = _chainMac;
+            var recordHeader = new byte[RecordHeaderSize];
+
+            foreach (var entry in entries)
+            {
+                var payload = JsonSerializer.SerializeToUtf8Bytes(entry);
+                chain = ChainMac(chain, payload);
+
+                BinaryPrimitives.WriteInt32LittleEndian(recordHeader, payload.Length);
+                chain.CopyTo(recordHeader, 4);
+                buffer.Write(recordHeader);
+                buffer.Write(payload);
+            }
+
+            var start = stream.Position;
+            try
+            {
+                stream.Write(buffer.GetBuffer(), 0, (int)buffer.Length);
+                stream.Flush(flushToDisk: true);
+            }
+            catch
+            {
+                // كتابة جزئية: القص يبقي السلسلة متسقة مع _chainMac
+                try { stream.SetLength(start); stream.Seek(start, SeekOrigin.Begin); } catch { }
+                throw;
+            }
+
+            _chainMac = chain;
+            RecordCount += entries.Count;
+        }
+
+        /// <summary>
+        /// تصفير السجل بعد كتابة لقطة جديدة
+        /// </summary>
+        /// <param name="genesis">HMAC اللقطة الجديدة</param>
+        public void Reset(byte[] genesis)
+        {
+            var stream = _stream ??= OpenStream();
+
+            var header = new byte[HeaderSize];
+            BinaryPrimitives.WriteUInt32LittleEndian(header, Magic);
+            BinaryPrimitives.WriteUInt16LittleEndian(header.AsSpan(4), FormatVersion);
+            genesis.CopyTo(header, 6);
+
+            stream.SetLength(0);
+            stream.Write(header);
+            stream.Flush(flushToDisk: true);
+
+            _chainMac = genesis.ToArray();
+            RecordCount = 0;
+        }
+
+        private FileStream OpenStream() => new(
+            _path, FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.Read, 64 * 1024);
+
+        private byte[] ChainMac(byte[] previous, byte[] payload)
+        {
+            var data = new byte[previous.Length + payload.Length];
+            previous.CopyTo(data, 0);
+            payload.CopyTo(data, previous.Length);
+            return _computeMac(data);
+        }
+
+        public void Dispose()
+        {
+            _stream?.Dispose();
+            _stream = null;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Monitoring/Quarantine/QuarantineRequest.cs
+// طلبات ونتائج عمليات الحجر الجماعية
+// =====================================================
+
+using ShieldAI.Core.Detection.ThreatScoring;
+using ShieldAI.Core.Models;
+
+namespace ShieldAI.Core.Monitoring.Quarantine
+{
+    /// <summary>
+    /// طلب حجر ملف ضمن دفعة
+    /// </summary>
+    /// <param name="FilePath">مسار الملف الحالي (قد يكون ملفاً منقولاً مسبقاً إلى مجلد الحجر)</param>
+    /// <param name="OriginalPath">المسار الأصلي إن كان الملف منقولاً</param>
+    /// <param name="ScanResult">نتيجة الفحص المجمّعة لملء metadata</param>
+    public sealed record QuarantineRequest(
+        string FilePath,
+        string? OriginalPath = null,
+        AggregatedThreatResult? ScanResult = null)
+    {
+        /// <summary>
+        /// اسم التهديد (للكشف من خارج المجمّع)
+        /// </summary>
+        public string? ThreatName { get; init; }
+
+        /// <summary>
+        /// القرار عند غياب نتيجة مجمّعة
+        /// </summary>
+        public string? Verdict { get; init; }
+
+        /// <summary>
+        /// نقل الملف ذرياً إلى مجلد الحجر أولاً (لمنع تنفيذه أثناء الانتظار)
+        /// </summary>
+        public bool AtomicMove { get; init; }
+
+        /// <summary>
+        /// المسار الذي يُبلَّغ عنه في النتيجة
+        /// </summary>
+        public string Target => OriginalPath ?? FilePath;
+
+        /// <summary>
+        /// طلب حجر تلقائي لكشف من الفحص (نقل ذري أولاً)
+        /// </summary>
+        public static QuarantineRequest ForDetection(ScanResult result) => new(result.FilePath)
+        {
+            ThreatName = result.ThreatName,
+            Verdict = result.Verdict.ToString(),
+            AtomicMove = true
+        };
+    }
+
+    /// <summary>
+    /// طلب استعادة عنصر ضمن دفعة
+    /// </summary>
+    /// <param name="RestorePath">مسار الاستعادة (الافتراضي: المسار الأصلي)</param>
+    public sealed record QuarantineRestoreRequest(string ItemId, string? RestorePath = null);
+
+    /// <summary>
+    /// نتيجة عملية حجر/استعادة/حذف لعنصر واحد
+    /// </summary>
+    /// <param name="Target">مسار الملف أو معرف العنصر</param>
+    /// <param name="Item">العنصر المتأثر عند النجاح</param>
+    public sealed record QuarantineItemOutcome(
+        string Target,
+        bool Success,
+        QuarantineItemMetadata? Item = null,
+        string? Error = null)
+    {
+        public static QuarantineItemOutcome Succeeded(string target, QuarantineItemMetadata item) => new(target, true, item);
+
+        public static QuarantineItemOutcome Failed(string target, string error) => new(target, false, null, error);
+    }
+}
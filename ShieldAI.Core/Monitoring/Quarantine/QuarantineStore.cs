@@ -1,7 +1,7 @@
 // =====================================================
 // ShieldAI - AI-Powered Antivirus Solution
 // Monitoring/Quarantine/QuarantineStore.cs
-// مخزن الحجر الصحي الآمن مع DPAPI + metadata كاملة
+// مخزن الحجر الصحي الآمن مع DPAPI + metadata كاملة + محتوى معنون بالبصمة
 // =====================================================
 
 using System.Security.AccessControl;
@@ -22,8 +22,22 @@ namespace ShieldAI.Core.Monitoring.Quarantine
         private readonly string _metadataPath;
         private readonly string _metadataHmacPath;
         private readonly QuarantineCrypto _crypto;
+        private readonly QuarantineJournal _journal;
         private Dictionary<string, QuarantineItemMetadata> _items;
         private readonly object _lock = new();
+
+        // يسلسل الإلحاق بالسجل والضغط؛ يُؤخذ دائماً قبل _lock
+        private readonly object _journalLock = new();
+
+        // ملفات الحجر معنونة بالبصمة ومشتركة: عدد العناصر المشيرة لكل ملف
+        // + حجوزات العمليات الجارية التي لم تُثبَّت في السجل بعد (محميان بـ _lock)
+        private readonly Dictionary<string, int> _blobRefs = new(StringComparer.OrdinalIgnoreCase);
+        private readonly Dictionary<string, int> _blobReservations = new(StringComparer.OrdinalIgnoreCase);
+
+        /// <summary>
+        /// الحد الأدنى لعدد سجلات السجل قبل ضغطه في لقطة جديدة
+        /// </summary>
+        public const int CompactionMinRecords = 1024;
         private bool _disposed;
 
         public QuarantineStore(string? quarantinePath = null)
@@ -35,6 +49,7 @@ namespace ShieldAI.Core.Monitoring.Quarantine
             _metadataPath = Path.Combine(_quarantinePath, "metadata.json");
             _metadataHmacPath = Path.Combine(_quarantinePath, "metadata.hmac");
             _crypto = new QuarantineCrypto(_quarantinePath);
+            _journal = new QuarantineJournal(Path.Combine(_quarantinePath, "metadata.journal"), _crypto.ComputeHmac);
             _items = new Dictionary<string, QuarantineItemMetadata>();
 
             EnsureDirectory();
@@ -49,6 +64,22 @@ namespace ShieldAI.Core.Monitoring.Quarantine
             get { lock (_lock) { return _items.Count; } }
         }
 
+        /// <summary>
+        /// عدد ملفات المحتوى المشفرة (أقل من Count عند تكرار المحتوى)
+        /// </summary>
+        public int BlobCount
+        {
+            get { lock (_lock) { return _blobRefs.Count; } }
+        }
+
+        /// <summary>
+        /// عدد عمليات السجل غير المضغوطة في اللقطة بعد
+        /// </summary>
+        public long PendingJournalRecords
+        {
+            get { lock (_journalLock) { return _journal.RecordCount; } }
+        }
+
         /// <summary>
         /// حجر ملف مع نتيجة فحص مجمّعة
         /// </summary>
@@ -56,56 +87,8 @@ namespace ShieldAI.Core.Monitoring.Quarantine
             string filePath,
             AggregatedThreatResult? scanResult = null)
         {
-            if (!File.Exists(filePath))
-                return null;
-
-            try
-            {
-                var fileInfo = new FileInfo(filePath);
-
-                // إنشاء metadata
-                var metadata = scanResult != null
-                    ? QuarantineItemMetadata.FromAggregatedResult(filePath, scanResult)
-                    : new QuarantineItemMetadata
-                    {
-                        OriginalPath = filePath,
-                        OriginalName = fileInfo.Name,
-                        FileSize = fileInfo.Length,
-                        Verdict = "Manual"
-                    };
-
-                var quarantineFileName = metadata.Id + ".qar";
-                metadata.QuarantineFileName = quarantineFileName;
-
-                var quarantineFilePath = Path.Combine(_quarantinePath, quarantineFileName);
-
-                // قراءة الملف الأصلي
-                var originalData = await File.ReadAllBytesAsync(filePath);
-
-                // حساب SHA256
-                metadata.Sha256Hash = QuarantineCrypto.ComputeSha256(originalData);
-
-                // تشفير وحفظ
-                var encryptedData = _crypto.Encrypt(originalData);
-                await File.WriteAllBytesAsync(quarantineFilePath, encryptedData);
-
-                // حذف الملف الأصلي
-                File.Delete(filePath);
-
-                // حفظ metadata
-                lock (_lock)
-                {
-                    _items[metadata.Id] = metadata;
-                }
-
-                await SaveMetadataAsync();
-
-                return metadata;
-            }
-            catch
-            {
-                return null;
-            }
+            var outcomes = await QuarantineFilesAsync(new[] { new QuarantineRequest(filePath, null, scanResult) });
+            return outcomes[0].Item;
         }
 
         /// <summary>
@@ -153,57 +136,111 @@ namespace ShieldAI.Core.Monitoring.Quarantine
             string originalPath,
             AggregatedThreatResult? scanResult = null)
         {
-            if (!File.Exists(movedFilePath))
-                return null;
+            var outcomes = await QuarantineFilesAsync(new[] { new QuarantineRequest(movedFilePath, originalPath, scanResult) });
+            return outcomes[0].Item;
+        }
+
+        /// <summary>
+        /// حجر دفعة ملفات: التشفير متوازٍ والتثبيت في السجل بإلحاق واحد للدفعة.
+        /// المصادر لا تُحذف إلا بعد تثبيت عناصرها - الانقطاع وسط الدفعة يترك نسخاً مكررة لا عناصر مفقودة
+        /// </summary>
+        /// <param name="maxParallelism">عدد عمليات التشفير المتزامنة</param>
+        /// <returns>نتيجة لكل طلب بنفس الترتيب</returns>
+        public async Task<IReadOnlyList<QuarantineItemOutcome>> QuarantineFilesAsync(
+            IReadOnlyList<QuarantineRequest> requests,
+            int maxParallelism = 1,
+            CancellationToken ct = default)
+        {
+            var outcomes = new QuarantineItemOutcome[requests.Count];
+            var reservedBlobs = new string?[requests.Count];
 
             try
             {
-                var fileInfo = new FileInfo(movedFilePath);
-                var originalName = Path.GetFileName(originalPath);
-
-                var metadata = scanResult != null
-                    ? QuarantineItemMetadata.FromAggregatedResult(originalPath, scanResult)
-                    : new QuarantineItemMetadata
+                await Parallel.ForEachAsync(
+                    Enumerable.Range(0, requests.Count),
+                    new ParallelOptions { MaxDegreeOfParallelism = Math.Max(1, maxParallelism), CancellationToken = ct },
+                    async (index, _) =>
                     {
-                        OriginalPath = originalPath,
-                        OriginalName = originalName,
-                        FileSize = fileInfo.Length,
-                        Verdict = "Manual"
-                    };
+                        var request = requests[index];
+                        try
+                        {
+                            if (!File.Exists(request.FilePath))
+                            {
+                                outcomes[index] = QuarantineItemOutcome.Failed(request.Target, "File not found");
+                                return;
+                            }
 
-                metadata.OriginalPath = originalPath;
-                metadata.OriginalName = string.IsNullOrWhiteSpace(originalName) ? metadata.OriginalName : originalName;
-                metadata.FileSize = fileInfo.Length;
+                            var metadata = CreateMetadata(request);
 
-                var quarantineFileName = metadata.Id + ".qar";
-                metadata.QuarantineFileName = quarantineFileName;
+                            // تخزين المحتوى (أو الإشارة لنسخة موجودة بنفس البصمة)
+                            reservedBlobs[index] = await StoreBlobAsync(request.FilePath, metadata);
 
-                var quarantineFilePath = Path.Combine(_quarantinePath, quarantineFileName);
+                            outcomes[index] = QuarantineItemOutcome.Succeeded(request.Target, metadata);
+                        }
+                        catch (Exception ex)
+                        {
+                            outcomes[index] = QuarantineItemOutcome.Failed(request.Target, ex.Message);
+                        }
+                    });
+            }
+            finally
+            {
+                try
+                {
+                    // ما خُزّن محتواه يُثبَّت حتى عند الإلغاء، ثم تُحذف مصادره
+                    var stored = Enumerable.Range(0, requests.Count)
+                        .Where(i => outcomes[i] is { Success: true, Item: not null })
+                        .ToList();
 
-                var originalData = await File.ReadAllBytesAsync(movedFilePath);
-                metadata.Sha256Hash = QuarantineCrypto.ComputeSha256(originalData);
+                    if (stored.Count > 0)
+                    {
+                        await CommitAsync(stored.Select(i => QuarantineJournalEntry.Put(outcomes[i].Item!)).ToArray());
+                        await DeleteSourcesAsync(requests, outcomes, stored);
+                    }
+                }
+                finally
+                {
+                    foreach (var blobName in reservedBlobs)
+                    {
+                        if (blobName != null)
+                            ReleaseBlobReservation(blobName);
+                    }
+                }
+            }
 
-                var encryptedData = _crypto.Encrypt(originalData);
-                await File.WriteAllBytesAsync(quarantineFilePath, encryptedData);
+            return outcomes;
+        }
 
-                File.Delete(movedFilePath);
+        /// <summary>
+        /// حذف مصادر العناصر المثبتة؛ ما تعذر حذفه يُزال من الحجر ويُبلَّغ بفشله
+        /// </summary>
+        private async Task DeleteSourcesAsync(
+            IReadOnlyList<QuarantineRequest> requests,
+            QuarantineItemOutcome[] outcomes,
+            List<int> stored)
+        {
+            var rollbacks = new List<QuarantineJournalEntry>();
 
-                lock (_lock)
+            foreach (var index in stored)
+            {
+                try
                 {
-                    _items[metadata.Id] = metadata;
+                    File.Delete(requests[index].FilePath);
+                }
+                catch (Exception ex)
+                {
+                    rollbacks.Add(QuarantineJournalEntry.Remove(outcomes[index].Item!.Id));
+                    outcomes[index] = QuarantineItemOutcome.Failed(requests[index].Target, ex.Message);
                 }
-
-                await SaveMetadataAsync();
-                return metadata;
-            }
-            catch
-            {
-                return null;
             }
+
+            if (rollbacks.Count > 0)
+                await CommitAsync(rollbacks.ToArray());
         }
 
         /// <summary>
         /// استعادة ملف من الحجر مع تحقق hash
+        /// ملف المحتوى لا يُحذف إلا عند استعادة/حذف آخر عنصر يشير إليه
         /// </summary>
         public async Task<bool> RestoreFileAsync(string itemId, string? restorePath = null)
         {
@@ -215,91 +252,216 @@ namespace ShieldAI.Core.Monitoring.Quarantine
                     return false;
             }
 
-            var quarantineFilePath = Path.Combine(_quarantinePath, metadata.QuarantineFileName);
-            if (!File.Exists(quarantineFilePath))
-                throw new FileNotFoundException($"ملف الحجر غير موجود: {quarantineFilePath}");
+            await RestoreContentAsync(metadata, restorePath ?? metadata.OriginalPath);
 
-            // قراءة وفك التشفير
-            var encryptedData = await File.ReadAllBytesAsync(quarantineFilePath);
-            var originalData = _crypto.Decrypt(encryptedData);
+            // تحديث metadata (يحذف ملف الحجر إن لم يعد مشتركاً)
+            await CommitAsync(QuarantineJournalEntry.Remove(itemId));
+            return true;
+        }
 
-            // تحقق hash قبل الإرجاع
-            var currentHash = QuarantineCrypto.ComputeSha256(originalData);
-            if (!string.IsNullOrEmpty(metadata.Sha256Hash) &&
-                !currentHash.Equals(metadata.Sha256Hash, StringComparison.OrdinalIgnoreCase))
-            {
-                throw new CryptographicException(
-                    "فشل التحقق من سلامة الملف - البصمة لا تتطابق مع الأصل");
-            }
+        /// <summary>
+        /// استعادة دفعة عناصر: فك التشفير متوازٍ والتثبيت بإلحاق واحد
+        /// </summary>
+        /// <returns>نتيجة لكل طلب بنفس الترتيب</returns>
+        public async Task<IReadOnlyList<QuarantineItemOutcome>> RestoreFilesAsync(
+            IReadOnlyList<QuarantineRestoreRequest> requests,
+            int maxParallelism = 1,
+            CancellationToken ct = default)
+        {
+            var outcomes = new QuarantineItemOutcome[requests.Count];
+            var claimed = new HashSet<string>();
 
-            // تحديد مسار الاستعادة
-            var targetPath = restorePath ?? metadata.OriginalPath;
-            if (!IsRestorePathSafe(targetPath) && !IsCurrentUserAdmin())
+            try
             {
-                throw new UnauthorizedAccessException("مسار الاستعادة غير آمن ويتطلب صلاحيات Admin");
+                await Parallel.ForEachAsync(
+                    Enumerable.Range(0, requests.Count),
+                    new ParallelOptions { MaxDegreeOfParallelism = Math.Max(1, maxParallelism), CancellationToken = ct },
+                    async (index, _) =>
+                    {
+                        var request = requests[index];
+                        QuarantineItemMetadata? metadata;
+                        lock (_lock)
+                        {
+                            // نفس العنصر مرتين في الدفعة يُستعاد مرة واحدة
+                            if (!_items.TryGetValue(request.ItemId, out metadata) || !claimed.Add(request.ItemId))
+                            {
+                                outcomes[index] = QuarantineItemOutcome.Failed(request.ItemId, "Item not found");
+                                return;
+                            }
+                        }
+
+                        try
+                        {
+                            await RestoreContentAsync(metadata, request.RestorePath ?? metadata.OriginalPath);
+                            outcomes[index] = QuarantineItemOutcome.Succeeded(request.ItemId, metadata);
+                        }
+                        catch (Exception ex)
+                        {
+                            outcomes[index] = QuarantineItemOutcome.Failed(request.ItemId, ex.Message);
+                        }
+                    });
             }
+            finally
+            {
+                var removes = outcomes
+                    .Where(o => o is { Success: true })
+                    .Select(o => QuarantineJournalEntry.Remove(o.Target))
+                    .ToArray();
 
-            // التأكد من وجود المجلد
-            var directory = Path.GetDirectoryName(targetPath);
-            if (!string.IsNullOrEmpty(directory) && !Directory.Exists(directory))
-                Directory.CreateDirectory(directory);
+                if (removes.Length > 0)
+                    await CommitAsync(removes);
+            }
 
-            // إذا كان الملف موجودًا، نضيف رقم
-            targetPath = GetUniqueFilePath(targetPath);
+            return outcomes;
+        }
 
-            // كتابة الملف المستعاد
-            await File.WriteAllBytesAsync(targetPath, originalData);
+        /// <summary>
+        /// حذف ملف من الحجر نهائياً
+        /// </summary>
+        public async Task<bool> DeleteFileAsync(string itemId)
+        {
+            var outcomes = await DeleteFilesAsync(new[] { itemId });
+            return outcomes[0].Success;
+        }
 
-            // حذف ملف الحجر
-            File.Delete(quarantineFilePath);
+        /// <summary>
+        /// حذف دفعة عناصر بإلحاق واحد في السجل
+        /// ملفات المحتوى تُحذف عند زوال آخر مرجع لها
+        /// </summary>
+        /// <returns>نتيجة لكل معرف بنفس الترتيب</returns>
+        public async Task<IReadOnlyList<QuarantineItemOutcome>> DeleteFilesAsync(IReadOnlyList<string> itemIds)
+        {
+            var outcomes = new QuarantineItemOutcome[itemIds.Count];
+            var removes = new List<QuarantineJournalEntry>();
 
-            // تحديث metadata
             lock (_lock)
             {
-                metadata.IsRestored = true;
-                metadata.RestoredAt = DateTime.Now;
-                _items.Remove(itemId);
+                var claimed = new HashSet<string>();
+                for (int i = 0; i < itemIds.Count; i++)
+                {
+                    if (_items.TryGetValue(itemIds[i], out var metadata) && claimed.Add(itemIds[i]))
+                    {
+                        outcomes[i] = QuarantineItemOutcome.Succeeded(itemIds[i], metadata);
+                        removes.Add(QuarantineJournalEntry.Remove(itemIds[i]));
+                    }
+                    else
+                    {
+                        outcomes[i] = QuarantineItemOutcome.Failed(itemIds[i], "Item not found");
+                    }
+                }
             }
 
-            await SaveMetadataAsync();
-            return true;
+            if (removes.Count > 0)
+                await CommitAsync(removes.ToArray());
+
+            return outcomes;
         }
 
         /// <summary>
-        /// حذف ملف من الحجر نهائياً
+        /// ترحيل ملفات الحجر القديمة (صيغة v1 أو ملف لكل عنصر) إلى ملفات محتوى مجزأة معنونة بالبصمة
         /// </summary>
-        public async Task<bool> DeleteFileAsync(string itemId)
+        /// <returns>عدد العناصر المرحّلة</returns>
+        public async Task<int> MigrateLegacyItemsAsync(CancellationToken ct = default)
         {
+            List<QuarantineItemMetadata> legacy;
             lock (_lock)
             {
-                if (!_items.ContainsKey(itemId))
-                    return false;
+                legacy = _items.Values
+                    .Where(i => i.ContainerVersion < QuarantineCrypto.ChunkedFormatVersion ||
+                                (!string.IsNullOrEmpty(i.Sha256Hash) &&
+                                 !i.QuarantineFileName.Equals(BlobFileName(i.Sha256Hash), StringComparison.OrdinalIgnoreCase)))
+                    .ToList();
             }
 
+            var migrated = new List<QuarantineJournalEntry>();
+            var reserved = new List<string>();
+            var committed = 0;
             try
             {
-                QuarantineItemMetadata metadata;
-                lock (_lock)
+                foreach (var metadata in legacy)
                 {
-                    metadata = _items[itemId];
-                }
+                    ct.ThrowIfCancellationRequested();
 
-                var quarantineFilePath = Path.Combine(_quarantinePath, metadata.QuarantineFileName);
-                if (File.Exists(quarantineFilePath))
-                    File.Delete(quarantineFilePath);
+                    var quarantineFilePath = Path.Combine(_quarantinePath, metadata.QuarantineFileName);
+                    var migratingPath = Path.Combine(_quarantinePath, $"{Guid.NewGuid():N}.migrating");
+                    try
+                    {
+                        if (!File.Exists(quarantineFilePath))
+                            continue;
 
-                lock (_lock)
-                {
-                    _items.Remove(itemId);
-                }
+                        bool alreadyChunked;
+                        await using (var input = OpenSequentialRead(quarantineFilePath))
+                            alreadyChunked = QuarantineCrypto.IsChunkedContainer(input);
 
-                await SaveMetadataAsync();
-                return true;
+                        var sha256 = metadata.Sha256Hash;
+                        if (!alreadyChunked)
+                        {
+                            // الصيغة القديمة لا تُفك إلا كاملة - نفك في الذاكرة ثم نعيد التشفير تدفقياً
+                            var plain = _crypto.Decrypt(await File.ReadAllBytesAsync(quarantineFilePath, ct));
+                            try
+                            {
+                                var actual = QuarantineCrypto.ComputeSha256(plain);
+                                if (!string.IsNullOrEmpty(sha256) && !actual.Equals(sha256, StringComparison.OrdinalIgnoreCase))
+                                    continue;
+                                sha256 = actual;
+
+                                await using (var output = CreateSequentialWrite(migratingPath))
+                                    await _crypto.EncryptStreamAsync(new MemoryStream(plain, writable: false), output, compress: true, ct: ct);
+                            }
+                            finally
+                            {
+                                CryptographicOperations.ZeroMemory(plain);
+                            }
+                        }
+
+                        // حاوية مجزأة بلا بصمة معروفة تبقى باسمها
+                        var blobName = string.IsNullOrEmpty(sha256) ? metadata.QuarantineFileName : BlobFileName(sha256);
+                        var sameFile = blobName.Equals(metadata.QuarantineFileName, StringComparison.OrdinalIgnoreCase);
+
+                        lock (_lock)
+                        {
+                            var blobPath = Path.Combine(_quarantinePath, blobName);
+
+                            // محتوى مكرر: العنصر يشير للملف الموجود وملفه القديم يُحذف بعد التثبيت
+                            if (sameFile || !HasBlobReferences(blobName) || !File.Exists(blobPath))
+                            {
+                                if (!alreadyChunked)
+                                    File.Move(migratingPath, blobPath, overwrite: true);
+                                else if (!sameFile)
+                                    File.Move(quarantineFilePath, blobPath, overwrite: true);
+                            }
+
+                            ReserveBlob(blobName);
+                        }
+                        reserved.Add(blobName);
+
+                        var updated = metadata.Clone();
+                        updated.Sha256Hash = sha256;
+                        updated.QuarantineFileName = blobName;
+                        updated.ContainerVersion = QuarantineCrypto.ChunkedFormatVersion;
+                        migrated.Add(QuarantineJournalEntry.Put(updated));
+                    }
+                    catch (Exception ex) when (ex is not OperationCanceledException)
+                    {
+                        // العنصر التالف يبقى بصيغته القديمة
+                    }
+                    finally
+                    {
+                        try { if (File.Exists(migratingPath)) File.Delete(migratingPath); } catch { }
+                    }
+                }
             }
-            catch
+            finally
             {
-                return false;
+                // ما نُقل من ملفات يُثبَّت حتى عند الإلغاء - عدا ما استُعيد أو حُذف أثناء الترحيل
+                if (migrated.Count > 0)
+                    committed = await CommitExistingAsync(migrated.ToArray());
+
+                foreach (var blobName in reserved)
+                    ReleaseBlobReservation(blobName);
             }
+
+            return committed;
         }
 
         /// <summary>
@@ -337,20 +499,272 @@ namespace ShieldAI.Core.Monitoring.Quarantine
         /// </summary>
         public async Task ClearAllAsync()
         {
+            // ملفات المحتوى تُحذف مع آخر مرجع لها
+            await CommitAsync(QuarantineJournalEntry.Clear());
+        }
+
+        /// <summary>
+        /// ضغط السجل في لقطة metadata.json جديدة
+        /// </summary>
+        public void CompactMetadata()
+        {
+            lock (_journalLock)
+            {
+                try
+                {
+                    CompactLocked();
+                }
+                catch
+                {
+                    // تبقى اللقطة السابقة + السجل صالحين
+                }
+            }
+        }
+
+        #region Private Methods
+
+        private const int StreamBufferSize = 81920;
+
+        private static QuarantineItemMetadata CreateMetadata(QuarantineRequest request)
+        {
+            var originalPath = request.OriginalPath ?? request.FilePath;
+            var originalName = Path.GetFileName(originalPath);
+
+            var metadata = request.ScanResult != null
+                ? QuarantineItemMetadata.FromAggregatedResult(originalPath, request.ScanResult)
+                : new QuarantineItemMetadata
+                {
+                    OriginalPath = originalPath,
+                    OriginalName = originalName,
+                    Verdict = request.Verdict ?? "Manual"
+                };
+
+            metadata.OriginalPath = originalPath;
+            metadata.OriginalName = string.IsNullOrWhiteSpace(originalName) ? metadata.OriginalName : originalName;
+            metadata.ThreatName = request.ThreatName ?? metadata.ThreatName;
+            return metadata;
+        }
+
+        /// <summary>
+        /// فك تشفير تدفقي إلى ملف مؤقت بجوار الهدف - لا يظهر الملف إلا بعد التحقق الكامل
+        /// </summary>
+        private async Task RestoreContentAsync(QuarantineItemMetadata metadata, string targetPath)
+        {
+            var quarantineFilePath = Path.Combine(_quarantinePath, metadata.QuarantineFileName);
+            if (!File.Exists(quarantineFilePath))
+                throw new FileNotFoundException($"ملف الحجر غير موجود: {quarantineFilePath}");
+
+            if (!IsRestorePathSafe(targetPath) && !IsCurrentUserAdmin())
+            {
+                throw new UnauthorizedAccessException("مسار الاستعادة غير آمن ويتطلب صلاحيات Admin");
+            }
+
+            // التأكد من وجود المجلد
+            var directory = Path.GetDirectoryName(targetPath);
+            if (!string.IsNullOrEmpty(directory) && !Directory.Exists(directory))
+                Directory.CreateDirectory(directory);
+
+            var partialPath = Path.Combine(directory ?? "", $".{Guid.NewGuid():N}.restoring");
+            try
+            {
+                string currentHash;
+                await using (var input = OpenSequentialRead(quarantineFilePath))
+                await using (var output = new FileStream(partialPath, FileMode.CreateNew, FileAccess.Write,
+                    FileShare.None, StreamBufferSize, FileOptions.Asynchronous))
+                {
+                    (currentHash, _) = await _crypto.DecryptStreamAsync(input, output);
+                }
+
+                // تحقق hash قبل الإرجاع
+                if (!string.IsNullOrEmpty(metadata.Sha256Hash) &&
+                    !currentHash.Equals(metadata.Sha256Hash, StringComparison.OrdinalIgnoreCase))
+                {
+                    throw new CryptographicException(
+                        "فشل التحقق من سلامة الملف - البصمة لا تتطابق مع الأصل");
+                }
+
+                // إذا كان الملف موجودًا، نضيف رقم
+                File.Move(partialPath, GetUniqueFilePath(targetPath));
+            }
+            finally
+            {
+                try { if (File.Exists(partialPath)) File.Delete(partialPath); } catch { }
+            }
+
             lock (_lock)
             {
-                foreach (var item in _items.Values)
+                metadata.IsRestored = true;
+                metadata.RestoredAt = DateTime.Now;
+            }
+        }
+
+        /// <summary>
+        /// تخزين محتوى ملف في ملف حجر معنون ببصمته (مضغوط ثم مشفّر)
+        /// المحتوى الموجود مسبقاً لا يُعاد تشفيره
+        /// </summary>
+        /// <returns>اسم ملف المحتوى محجوزاً - يحرره المستدعي بعد تثبيت العنصر أو فشله</returns>
+        private async Task<string> StoreBlobAsync(string sourcePath, QuarantineItemMetadata metadata)
+        {
+            // تمريرة بصمة أولاً: في الإصابة الجماعية أغلب الملفات نسخ مكررة فيُتجنب التشفير كلياً
+            string sha256;
+            long length;
+            await using (var input = OpenSequentialRead(sourcePath))
+            {
+                sha256 = Convert.ToHexString(await SHA256.HashDataAsync(input)).ToLowerInvariant();
+                length = input.Length;
+            }
+
+            var blobName = BlobFileName(sha256);
+            if (!TryReserveExistingBlob(blobName))
+            {
+                var partialPath = Path.Combine(_quarantinePath, $"{Guid.NewGuid():N}.partial");
+                try
                 {
-                    var filePath = Path.Combine(_quarantinePath, item.QuarantineFileName);
-                    try { if (File.Exists(filePath)) File.Delete(filePath); } catch { }
+                    await using (var input = OpenSequentialRead(sourcePath))
+                    await using (var output = CreateSequentialWrite(partialPath))
+                    {
+                        (sha256, length) = await _crypto.EncryptStreamAsync(input, output, compress: true);
+                    }
+
+                    // قد يتغير الملف بين التمريرتين - الاسم يتبع ما شُفّر فعلاً
+                    blobName = BlobFileName(sha256);
+                    lock (_lock)
+                    {
+                        var blobPath = Path.Combine(_quarantinePath, blobName);
+                        if (!HasBlobReferences(blobName) || !File.Exists(blobPath))
+                            File.Move(partialPath, blobPath, overwrite: true);
+
+                        ReserveBlob(blobName);
+                    }
+                }
+                finally
+                {
+                    try { if (File.Exists(partialPath)) File.Delete(partialPath); } catch { }
                 }
-                _items.Clear();
             }
 
-            await SaveMetadataAsync();
+            metadata.Sha256Hash = sha256;
+            metadata.FileSize = length;
+            metadata.QuarantineFileName = blobName;
+            metadata.ContainerVersion = QuarantineCrypto.ChunkedFormatVersion;
+            return blobName;
         }
 
-        #region Private Methods
+        private static string BlobFileName(string sha256) => sha256.ToLowerInvariant() + ".qar";
+
+        private bool TryReserveExistingBlob(string blobName)
+        {
+            lock (_lock)
+            {
+                if (!HasBlobReferences(blobName) || !File.Exists(Path.Combine(_quarantinePath, blobName)))
+                    return false;
+
+                ReserveBlob(blobName);
+                return true;
+            }
+        }
+
+        private void ReserveBlob(string blobName)
+        {
+            _blobReservations[blobName] = _blobReservations.GetValueOrDefault(blobName) + 1;
+        }
+
+        private void ReleaseBlobReservation(string blobName)
+        {
+            lock (_lock)
+            {
+                var remaining = _blobReservations.GetValueOrDefault(blobName) - 1;
+                if (remaining > 0)
+                    _blobReservations[blobName] = remaining;
+                else
+                    _blobReservations.Remove(blobName);
+
+                DeleteBlobIfUnreferenced(blobName);
+            }
+        }
+
+        private bool HasBlobReferences(string blobName) =>
+            _blobRefs.ContainsKey(blobName) || _blobReservations.ContainsKey(blobName);
+
+        /// <summary>
+        /// تحديث عدّادات المراجع لعملية قبل تطبيقها (تحت _lock)
+        /// </summary>
+        private void TrackBlobReferences(QuarantineJournalEntry entry, List<string> released)
+        {
+            switch (entry.Op)
+            {
+                case QuarantineJournalOp.Put when entry.Item != null:
+                    AddBlobReference(entry.Item.QuarantineFileName);
+                    if (_items.TryGetValue(entry.Item.Id, out var previous))
+                        RemoveBlobReference(previous.QuarantineFileName, released);
+                    break;
+                case QuarantineJournalOp.Remove when entry.Id != null:
+                    if (_items.TryGetValue(entry.Id, out var removed))
+                        RemoveBlobReference(removed.QuarantineFileName, released);
+                    break;
+                case QuarantineJournalOp.Clear:
+                    foreach (var item in _items.Values)
+                        RemoveBlobReference(item.QuarantineFileName, released);
+                    break;
+            }
+        }
+
+        private void AddBlobReference(string blobName)
+        {
+            if (!string.IsNullOrEmpty(blobName))
+                _blobRefs[blobName] = _blobRefs.GetValueOrDefault(blobName) + 1;
+        }
+
+        private void RemoveBlobReference(string blobName, List<string> released)
+        {
+            if (string.IsNullOrEmpty(blobName) || !_blobRefs.TryGetValue(blobName, out var count))
+                return;
+
+            if (count > 1)
+            {
+                _blobRefs[blobName] = count - 1;
+            }
+            else
+            {
+                _blobRefs.Remove(blobName);
+                released.Add(blobName);
+            }
+        }
+
+        private void RebuildBlobReferences()
+        {
+            _blobRefs.Clear();
+            foreach (var item in _items.Values)
+                AddBlobReference(item.QuarantineFileName);
+        }
+
+        /// <summary>
+        /// حذف ملف محتوى بلا مراجع (تحت _lock حتى لا يسبق حجزاً جديداً له)
+        /// </summary>
+        private void DeleteBlobIfUnreferenced(string blobName)
+        {
+            if (HasBlobReferences(blobName))
+                return;
+
+            try
+            {
+                var blobPath = Path.Combine(_quarantinePath, blobName);
+                if (File.Exists(blobPath))
+                    File.Delete(blobPath);
+            }
+            catch
+            {
+                // ملف مقفل - يبقى يتيماً دون مراجع
+            }
+        }
+
+        private static FileStream OpenSequentialRead(string path) => new(
+            path, FileMode.Open, FileAccess.Read, FileShare.Read,
+            StreamBufferSize, FileOptions.Asynchronous | FileOptions.SequentialScan);
+
+        private static FileStream CreateSequentialWrite(string path) => new(
+            path, FileMode.Create, FileAccess.Write, FileShare.None,
+            StreamBufferSize, FileOptions.Asynchronous);
 
         private void EnsureDirectory()
         {
@@ -362,69 +776,180 @@ namespace ShieldAI.Core.Monitoring.Quarantine
 
         private void LoadMetadata()
         {
-            lock (_lock)
+            lock (_journalLock)
             {
+                byte[]? genesis = null;
+                var items = new Dictionary<string, QuarantineItemMetadata>();
+
                 try
                 {
                     if (File.Exists(_metadataPath))
                     {
-                        var json = File.ReadAllText(_metadataPath);
-                        _items = JsonSerializer.Deserialize<Dictionary<string, QuarantineItemMetadata>>(json)
+                        var json = File.ReadAllBytes(_metadataPath);
+
+                        // اللقطات القديمة كُتبت مع BOM بينما HMAC محسوب على النص فقط
+                        if (json.AsSpan().StartsWith(Encoding.UTF8.Preamble))
+                            json = json[Encoding.UTF8.Preamble.Length..];
+
+                        items = JsonSerializer.Deserialize<Dictionary<string, QuarantineItemMetadata>>(json)
                             ?? new Dictionary<string, QuarantineItemMetadata>();
 
-                        // إذا فشل التحقق من HMAC، نعيد توليده لإصلاح البيانات
-                        if (!ValidateMetadataHmac())
+                        if (ValidateMetadataHmac(json))
+                            genesis = _crypto.ComputeHmac(json);
+                    }
+                }
+                catch
+                {
+                    items = new Dictionary<string, QuarantineItemMetadata>();
+                }
+
+                if (genesis != null)
+                {
+                    try
+                    {
+                        // إعادة تشغيل السجل فوق اللقطة - سجل لقطة أخرى يُتجاهل
+                        foreach (var entry in _journal.Open(genesis))
+                            entry.ApplyTo(items);
+
+                        lock (_lock)
                         {
-                            Task.Run(() => SaveMetadataAsync()).Wait();
+                            _items = items;
+                            RebuildBlobReferences();
                         }
+                        return;
+                    }
+                    catch
+                    {
+                        // السجل غير قابل للقراءة - نعيد بناء اللقطة مما لدينا
                     }
                 }
+
+                // لا لقطة أو فشل التحقق من HMAC: نعيد توليدها لإصلاح البيانات
+                lock (_lock)
+                {
+                    _items = items;
+                    RebuildBlobReferences();
+                }
+
+                try
+                {
+                    CompactLocked();
+                }
                 catch
                 {
-                    _items = new Dictionary<string, QuarantineItemMetadata>();
+                    // تجاهل أخطاء الحفظ
                 }
             }
         }
 
-        private async Task SaveMetadataAsync()
+        /// <summary>
+        /// تطبيق عمليات على الذاكرة وإلحاقها بالسجل كدفعة واحدة
+        /// التطبيق والإلحاق تحت نفس القفل فيتطابق ترتيب السجل مع ترتيب الذاكرة
+        /// </summary>
+        private Task CommitAsync(params QuarantineJournalEntry[] entries) => CommitCoreAsync(entries, existingOnly: false);
+
+        /// <summary>
+        /// تثبيت تحديثات لعناصر قائمة فقط: عنصر استُعيد أو حُذف أثناء عملية خلفية
+        /// (الترحيل) لا يُعاد إلى metadata بملف محتوى فقد آخر مرجع له
+        /// </summary>
+        /// <returns>عدد العمليات المثبتة</returns>
+        private Task<int> CommitExistingAsync(QuarantineJournalEntry[] entries) => CommitCoreAsync(entries, existingOnly: true);
+
+        private Task<int> CommitCoreAsync(QuarantineJournalEntry[] entries, bool existingOnly)
         {
-            try
+            lock (_journalLock)
             {
-                string json;
+                int count;
+                var released = new List<string>();
                 lock (_lock)
                 {
-                    json = JsonSerializer.Serialize(_items, new JsonSerializerOptions
+                    if (existingOnly)
                     {
-                        WriteIndented = true
-                    });
+                        entries = entries
+                            .Where(e => e.Op != QuarantineJournalOp.Put || (e.Id != null && _items.ContainsKey(e.Id)))
+                            .ToArray();
+                        if (entries.Length == 0)
+                            return Task.FromResult(0);
+                    }
+
+                    foreach (var entry in entries)
+                    {
+                        TrackBlobReferences(entry, released);
+                        entry.ApplyTo(_items);
+                    }
+                    count = _items.Count;
+                }
+
+                try
+                {
+                    _journal.Append(entries);
+
+                    // الضغط يتناسب مع عدد العناصر، فالحد المتناسب معه يبقي الكلفة ثابتة لكل عملية
+                    if (_journal.RecordCount >= Math.Max(CompactionMinRecords, count))
+                        CompactLocked();
+                }
+                catch
+                {
+                    // فشل الإلحاق: لقطة كاملة تحفظ الحالة الحالية
+                    try { CompactLocked(); } catch { }
                 }
 
-                await File.WriteAllTextAsync(_metadataPath, json, Encoding.UTF8);
-                await SaveMetadataHmacAsync(json);
+                // الحذف بعد التثبيت: الانقطاع قبله يترك ملفاً يتيماً لا عنصراً بلا ملف
+                if (released.Count > 0)
+                {
+                    lock (_lock)
+                    {
+                        foreach (var blobName in released)
+                            DeleteBlobIfUnreferenced(blobName);
+                    }
+                }
             }
-            catch
+
+            return Task.FromResult(entries.Length);
+        }
+
+        /// <summary>
+        /// كتابة لقطة كاملة (ملف مؤقت ثم نقل) ثم HMAC ثم تصفير السجل
+        /// الانقطاع في أي نقطة يترك لقطة صالحة أو سجلاً يُتجاهل لعدم تطابق بذرته
+        /// </summary>
+        private void CompactLocked()
+        {
+            byte[] json;
+            lock (_lock)
             {
-                // تجاهل أخطاء الحفظ
+                json = JsonSerializer.SerializeToUtf8Bytes(_items, new JsonSerializerOptions
+                {
+                    WriteIndented = true
+                });
             }
+
+            var hmac = _crypto.ComputeHmac(json);
+            WriteFileAtomic(_metadataPath, json);
+            WriteFileAtomic(_metadataHmacPath, Encoding.UTF8.GetBytes(Convert.ToBase64String(hmac)));
+            _journal.Reset(hmac);
         }
 
-        private async Task SaveMetadataHmacAsync(string json)
+        private static void WriteFileAtomic(string path, byte[] content)
         {
-            var hmac = _crypto.ComputeHmac(Encoding.UTF8.GetBytes(json));
-            await File.WriteAllTextAsync(_metadataHmacPath, Convert.ToBase64String(hmac), Encoding.UTF8);
+            var tempPath = path + ".tmp";
+            using (var stream = new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None))
+            {
+                stream.Write(content);
+                stream.Flush(flushToDisk: true);
+            }
+            File.Move(tempPath, path, overwrite: true);
         }
 
-        private bool ValidateMetadataHmac()
+        private bool ValidateMetadataHmac(byte[] json)
         {
             if (!File.Exists(_metadataHmacPath))
                 return false;
 
             try
             {
-                var json = File.ReadAllText(_metadataPath, Encoding.UTF8);
                 var expectedBase64 = File.ReadAllText(_metadataHmacPath, Encoding.UTF8);
                 var expected = Convert.FromBase64String(expectedBase64);
-                var actual = _crypto.ComputeHmac(Encoding.UTF8.GetBytes(json));
+                var actual = _crypto.ComputeHmac(json);
                 return CryptographicOperations.FixedTimeEquals(expected, actual);
             }
             catch
@@ -536,6 +1061,11 @@ namespace ShieldAI.Core.Monitoring.Quarantine
         {
             if (_disposed) return;
             _disposed = true;
+
+            lock (_journalLock)
+            {
+                _journal.Dispose();
+            }
         }
     }
 }
@@ -7,23 +7,25 @@
 using Microsoft.Extensions.Logging;
 using ShieldAI.Core.Configuration;
 using ShieldAI.Core.Models;
+using ShieldAI.Core.Monitoring.EventSources;
 using ShieldAI.Core.Scanning;
 
 namespace ShieldAI.Core.Monitoring
 {
     /// <summary>
     /// مراقب الملفات في الوقت الفعلي
-    /// يستخدم FileSystemWatcher مع Debounce
+    /// يستخدم مصدر أحداث قابل للاستبدال (fanotify / inotify / FileSystemWatcher) مع Debounce
     /// </summary>
     public class RealTimeMonitor : IDisposable
     {
         private readonly ILogger? _logger;
         private readonly AppSettings _settings;
-        private readonly List<FileSystemWatcher> _watchers = new();
+        private IFileEventSource? _eventSource;
         private readonly FileEventDebouncer _debouncer;
+        private readonly OverflowRecovery? _overflowRecovery;
         private readonly ScanOrchestrator _scanOrchestrator;
         private readonly HashSet<string> _excludedExtensions;
-        private readonly HashSet<string> _excludedFolders;
+        private readonly PathPolicy _pathPolicy;
         private bool _isRunning;
         private bool _disposed;
 
@@ -41,13 +43,20 @@ namespace ShieldAI.Core.Monitoring
             _scanOrchestrator = new ScanOrchestrator(logger, virusTotalApiKey);
             _debouncer = new FileEventDebouncer(OnFileReady, 1000);
 
+            if (_settings.EnableOverflowRecovery)
+            {
+                _overflowRecovery = new OverflowRecovery(
+                    path => OnFileEvent(this, new FileEventSourceArgs(path, WatcherChangeTypes.Changed)),
+                    logger,
+                    _settings.OverflowSnapshotMaxFiles,
+                    _settings.OverflowRecoveryDelayMs);
+            }
+
             _excludedExtensions = _settings.ExcludedExtensions
                 .Select(e => e.Trim().ToLowerInvariant())
                 .ToHashSet();
 
-            _excludedFolders = _settings.ExcludedFolders
-                .Select(f => f.Trim().ToLowerInvariant())
-                .ToHashSet();
+            _pathPolicy = PathPolicy.FromSettings(_settings);
 
             // ربط أحداث الفحص
             _scanOrchestrator.ThreatDetected += (s, e) =>
@@ -65,43 +74,13 @@ namespace ShieldAI.Core.Monitoring
 
             var monitorPaths = paths?.ToList() ?? GetDefaultMonitorPaths();
 
-            foreach (var path in monitorPaths)
-            {
-                try
-                {
-                    if (!Directory.Exists(path))
-                    {
-                        _logger?.LogWarning("مجلد المراقبة غير موجود: {Path}", path);
-                        continue;
-                    }
-
-                    var watcher = new FileSystemWatcher(path)
-                    {
-                        IncludeSubdirectories = true,
-                        NotifyFilter = NotifyFilters.FileName | 
-                                       NotifyFilters.LastWrite | 
-                                       NotifyFilters.CreationTime,
-                        EnableRaisingEvents = false
-                    };
-
-                    watcher.Created += OnFileEvent;
-                    watcher.Changed += OnFileEvent;
-                    watcher.Renamed += OnFileRenamed;
-                    watcher.Error += OnWatcherError;
-
-                    watcher.EnableRaisingEvents = true;
-                    _watchers.Add(watcher);
-
-                    _logger?.LogInformation("بدأت مراقبة: {Path}", path);
-                }
-                catch (Exception ex)
-                {
-                    _logger?.LogError(ex, "فشل إنشاء watcher: {Path}", path);
-                }
-            }
+            _eventSource = FileEventSourceFactory.StartWithFallback(
+                _settings, monitorPaths, OnFileEvent, OnWatcherError, _logger);
+            _overflowRecovery?.Start(monitorPaths);
 
             _isRunning = true;
-            _logger?.LogInformation("بدأت الحماية في الوقت الفعلي - {Count} مجلدات", _watchers.Count);
+            _logger?.LogInformation("بدأت الحماية في الوقت الفعلي - {Count} مجلدات ({Source})",
+                _eventSource.WatchedRootCount, _eventSource.Name);
         }
 
         /// <summary>
@@ -111,17 +90,15 @@ namespace ShieldAI.Core.Monitoring
         {
             if (!_isRunning) return;
 
-            foreach (var watcher in _watchers)
+            if (_eventSource != null)
             {
-                try
-                {
-                    watcher.EnableRaisingEvents = false;
-                    watcher.Dispose();
-                }
-                catch { }
+                _eventSource.FileChanged -= OnFileEvent;
+                _eventSource.Error -= OnWatcherError;
+                try { _eventSource.Dispose(); } catch { }
+                _eventSource = null;
             }
 
-            _watchers.Clear();
+            _overflowRecovery?.Stop();
             _debouncer.Clear();
             _isRunning = false;
 
@@ -161,7 +138,7 @@ namespace ShieldAI.Core.Monitoring
         /// <summary>
         /// معالجة حدث ملف
         /// </summary>
-        private void OnFileEvent(object sender, FileSystemEventArgs e)
+        private void OnFileEvent(object? sender, FileEventSourceArgs e)
         {
             if (!ShouldProcess(e.FullPath))
                 return;
@@ -170,23 +147,19 @@ namespace ShieldAI.Core.Monitoring
         }
 
         /// <summary>
-        /// معالجة إعادة تسمية
+        /// معالجة خطأ في مصدر الأحداث
         /// </summary>
-        private void OnFileRenamed(object sender, RenamedEventArgs e)
+        private void OnWatcherError(object? sender, ErrorEventArgs e)
         {
-            if (!ShouldProcess(e.FullPath))
-                return;
+            var ex = e.GetException();
 
-            _debouncer.Add(e.FullPath, WatcherChangeTypes.Renamed);
-        }
+            if (_overflowRecovery?.HandleError(sender, ex) == true)
+            {
+                _logger?.LogWarning("فيضان في مصدر الأحداث {Source} - جدولة استعادة", _eventSource?.Name);
+                return;
+            }
 
-        /// <summary>
-        /// معالجة خطأ في الـ Watcher
-        /// </summary>
-        private void OnWatcherError(object sender, ErrorEventArgs e)
-        {
-            var ex = e.GetException();
-            _logger?.LogError(ex, "خطأ في FileSystemWatcher");
+            _logger?.LogError(ex, "خطأ في مصدر الأحداث {Source}", _eventSource?.Name);
             MonitorError?.Invoke(this, ex.Message);
         }
 
@@ -222,6 +195,9 @@ namespace ShieldAI.Core.Monitoring
                     useVirusTotal: false, // لا نستخدم VT للمراقبة الفورية
                     deepScan: true);
 
+                // اللقطة تُحدَّث بعد الفحص فقط: حدث ضاع قبله يُكتشف عند الاستعادة
+                _overflowRecovery?.Record(filePath);
+
                 // التعامل مع التهديدات
                 foreach (var threat in report.Threats)
                 {
@@ -253,19 +229,8 @@ namespace ShieldAI.Core.Monitoring
                 if (_excludedExtensions.Contains(ext))
                     return false;
 
-                // تخطي المجلدات المستثناة
-                var dirName = Path.GetDirectoryName(filePath)?.ToLowerInvariant() ?? "";
-                foreach (var excluded in _excludedFolders)
-                {
-                    if (dirName.Contains(excluded))
-                        return false;
-                }
-
-                // تخطي ملفات الحجر
-                if (filePath.Contains(_settings.QuarantinePath, StringComparison.OrdinalIgnoreCase))
-                    return false;
-
-                return true;
+                // تخطي المجلدات المستثناة وملفات الحجر
+                return !_pathPolicy.Matches(filePath, PathClass.Excluded | PathClass.Quarantine);
             }
             catch
             {
@@ -278,6 +243,7 @@ namespace ShieldAI.Core.Monitoring
             if (_disposed) return;
 
             Stop();
+            _overflowRecovery?.Dispose();
             _debouncer.Dispose();
             _scanOrchestrator.Dispose();
 
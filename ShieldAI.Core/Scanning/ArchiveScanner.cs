@@ -0,0 +1,535 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/ArchiveScanner.cs
+// فحص الأرشيفات تدفقياً من الذاكرة بدون ملفات مؤقتة
+// =====================================================
+
+using System.Buffers.Binary;
+using System.Formats.Tar;
+using System.IO.Compression;
+using Microsoft.Extensions.Logging;
+using ShieldAI.Core.Caching;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Detection.ThreatScoring;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// صيغ الأرشيف المدعومة
+    /// </summary>
+    public enum ArchiveFormat
+    {
+        None,
+        Zip,
+        Tar,
+        GZip
+    }
+
+    /// <summary>
+    /// حدود الحماية من قنابل الضغط
+    /// </summary>
+    public class ArchiveScanLimits
+    {
+        public int MaxDepth { get; set; } = 3;
+        public int MaxCompressionRatio { get; set; } = 100;
+        public long MaxTotalBytes { get; set; } = 512L * 1024 * 1024;
+        public long MaxEntryBytes { get; set; } = 64L * 1024 * 1024;
+        public int MaxEntries { get; set; } = 10_000;
+
+        /// <summary>
+        /// الحدود من إعدادات التطبيق
+        /// </summary>
+        public static ArchiveScanLimits FromSettings(AppSettings settings) => new()
+        {
+            MaxDepth = Math.Max(1, settings.ArchiveMaxDepth),
+            MaxCompressionRatio = Math.Max(1, settings.ArchiveMaxCompressionRatio),
+            MaxTotalBytes = Math.Max(1, settings.ArchiveMaxTotalMB) * 1024L * 1024,
+            MaxEntryBytes = Math.Max(1, settings.ArchiveMaxEntryMB) * 1024L * 1024,
+            MaxEntries = Math.Max(1, settings.ArchiveMaxEntries)
+        };
+    }
+
+    /// <summary>
+    /// نتيجة فحص عنصر داخل أرشيف
+    /// </summary>
+    public class ArchiveEntryResult
+    {
+        /// <summary>
+        /// مسار العنصر داخل الأرشيف (المستويات المتداخلة مفصولة بـ '>')
+        /// </summary>
+        public string EntryPath { get; set; } = "";
+        public long Size { get; set; }
+        public string? Sha256 { get; set; }
+
+        /// <summary>
+        /// هل أُخذ الحكم من كاش العناصر
+        /// </summary>
+        public bool FromCache { get; set; }
+
+        public AggregatedThreatResult Result { get; set; } = new();
+    }
+
+    /// <summary>
+    /// عنصر لم يُفحص محتواه بسبب أحد الحدود
+    /// </summary>
+    public class ArchiveUnscannedEntry
+    {
+        public string EntryPath { get; set; } = "";
+        public string Reason { get; set; } = "";
+    }
+
+    /// <summary>
+    /// نتيجة فحص أرشيف كامل
+    /// </summary>
+    public class ArchiveScanResult
+    {
+        public string ArchivePath { get; set; } = "";
+        public ArchiveFormat Format { get; set; }
+        public List<ArchiveEntryResult> Entries { get; } = new();
+        public int EntriesScanned { get; set; }
+        public int CacheHits { get; set; }
+        public long BytesInflated { get; set; }
+
+        /// <summary>
+        /// تم اكتشاف قنبلة ضغط (نسبة ضغط أو حجم إجمالي مفرط)
+        /// </summary>
+        public bool BombDetected { get; set; }
+
+        /// <summary>
+        /// سبب توقف الفحص أو تخطي جزء منه
+        /// </summary>
+        public string? LimitReason { get; set; }
+
+        public string? ErrorMessage { get; set; }
+
+        /// <summary>
+        /// عناصر تخطاها الفحص (حجم أو عمق أو عدد) - لا يُعتبر الأرشيف نظيفاً بوجودها
+        /// </summary>
+        public List<ArchiveUnscannedEntry> UnscannedEntries { get; } = new();
+
+        public bool HasUnscannedContent => UnscannedEntries.Count > 0;
+
+        /// <summary>
+        /// العنصر الأعلى خطورة
+        /// </summary>
+        public ArchiveEntryResult? WorstEntry => Entries
+            .Where(e => e.Result.Verdict != AggregatedVerdict.Allow)
+            .OrderByDescending(e => e.Result.RiskScore)
+            .FirstOrDefault();
+
+        public bool IsThreat => BombDetected || HasUnscannedContent || WorstEntry != null;
+    }
+
+    /// <summary>
+    /// ماسح الأرشيفات - يقرأ العناصر (ZIP / TAR / GZIP) إلى الذاكرة ويمررها
+    /// لمحركات الفحص مباشرة، مع التكرار في الأرشيفات المتداخلة وكاش حكم
+    /// لكل عنصر حسب بصمته.
+    /// </summary>
+    public class ArchiveScanner
+    {
+        private const int HeaderLength = 262;
+        private const int CopyBufferSize = 81920;
+        private const long MinBytesForRatioCheck = 1024 * 1024;
+        private const int MaxCachedVerdicts = 4096;
+
+        private readonly ThreatAggregator _aggregator;
+        private readonly ArchiveScanLimits _limits;
+        private readonly ILogger? _logger;
+        private readonly BoundedCache<string, AggregatedThreatResult> _verdictCache;
+
+        public ArchiveScanLimits Limits => _limits;
+
+        public ArchiveScanner(ThreatAggregator aggregator, ArchiveScanLimits? limits = null, ILogger? logger = null)
+        {
+            _aggregator = aggregator;
+            _limits = limits ?? ArchiveScanLimits.FromSettings(ConfigManager.Instance.Settings);
+            _logger = logger;
+            _verdictCache = new BoundedCache<string, AggregatedThreatResult>(
+                new BoundedCacheOptions { Name = "ArchiveEntryVerdicts", MaxEntries = MaxCachedVerdicts },
+                comparer: StringComparer.OrdinalIgnoreCase);
+        }
+
+        public CacheStatistics VerdictCacheStatistics => _verdictCache.GetStatistics();
+
+        /// <summary>
+        /// تحديد صيغة الأرشيف من البايتات الأولى
+        /// </summary>
+        public static ArchiveFormat DetectFormat(ReadOnlySpan<byte> header)
+        {
+            if (header.Length >= 4 && header[0] == 0x50 && header[1] == 0x4B &&
+                (header[2] == 0x03 && header[3] == 0x04 || header[2] == 0x05 && header[3] == 0x06))
+                return ArchiveFormat.Zip;
+
+            if (header.Length >= 2 && header[0] == 0x1F && header[1] == 0x8B)
+                return ArchiveFormat.GZip;
+
+            // "ustar" عند الإزاحة 257
+            if (header.Length >= HeaderLength &&
+                header[257] == 'u' && header[258] == 's' && header[259] == 't' &&
+                header[260] == 'a' && header[261] == 'r')
+                return ArchiveFormat.Tar;
+
+            return ArchiveFormat.None;
+        }
+
+        /// <summary>
+        /// تحديد صيغة ملف على القرص
+        /// </summary>
+        public static ArchiveFormat DetectFormat(string filePath)
+        {
+            try
+            {
+                using var stream = new FileStream(filePath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete);
+                Span<byte> header = stackalloc byte[HeaderLength];
+                int read = stream.ReadAtLeast(header, HeaderLength, throwOnEndOfStream: false);
+                return DetectFormat(header[..read]);
+            }
+            catch
+            {
+                return ArchiveFormat.None;
+            }
+        }
+
+        /// <summary>
+        /// فحص أرشيف على القرص
+        /// </summary>
+        public async Task<ArchiveScanResult> ScanAsync(string archivePath, CancellationToken ct = default)
+        {
+            var result = new ArchiveScanResult { ArchivePath = archivePath };
+
+            try
+            {
+                await using var stream = new FileStream(
+                    archivePath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete,
+                    CopyBufferSize, FileOptions.Asynchronous | FileOptions.SequentialScan);
+
+                var header = new byte[HeaderLength];
+                int read = await stream.ReadAtLeastAsync(header, HeaderLength, throwOnEndOfStream: false, ct);
+                stream.Position = 0;
+
+                result.Format = DetectFormat(header.AsSpan(0, read));
+                if (result.Format == ArchiveFormat.None)
+                    return result;
+
+                var state = new ScanState(archivePath, result);
+                await ScanContainerAsync(stream, result.Format, "", Path.GetFileName(archivePath), stream.Length, 1, state, ct);
+            }
+            catch (OperationCanceledException)
+            {
+                throw;
+            }
+            catch (Exception ex) when (ex is InvalidDataException or IOException or UnauthorizedAccessException)
+            {
+                result.ErrorMessage = ex.Message;
+                _logger?.LogDebug("تعذر فحص الأرشيف: {Path} - {Error}", archivePath, ex.Message);
+            }
+
+            if (result.BombDetected)
+            {
+                _logger?.LogWarning("قنبلة ضغط محتملة: {Path} - {Reason}", archivePath, result.LimitReason);
+            }
+
+            return result;
+        }
+
+        /// <summary>
+        /// تفريغ كاش أحكام العناصر
+        /// </summary>
+        public void ClearCache() => _verdictCache.Clear();
+
+        private async Task ScanContainerAsync(
+            Stream stream,
+            ArchiveFormat format,
+            string prefix,
+            string containerName,
+            long compressedSize,
+            int depth,
+            ScanState state,
+            CancellationToken ct)
+        {
+            switch (format)
+            {
+                case ArchiveFormat.Zip:
+                    using (var zip = new ZipArchive(stream, ZipArchiveMode.Read, leaveOpen: true))
+                    {
+                        foreach (var entry in zip.Entries)
+                        {
+                            if (state.Stopped) return;
+                            ct.ThrowIfCancellationRequested();
+
+                            // مجلد
+                            if (entry.FullName.EndsWith('/') || entry.FullName.EndsWith('\\'))
+                                continue;
+
+                            if (!TryBeginEntry(prefix + entry.FullName, state))
+                                return;
+
+                            // نسبة الضغط المعلنة - رفض قبل فك الضغط
+                            if (IsRatioExceeded(entry.Length, entry.CompressedLength))
+                            {
+                                MarkBomb(state, $"نسبة ضغط مفرطة في {prefix}{entry.FullName}");
+                                return;
+                            }
+
+                            await using var entryStream = entry.Open();
+                            var content = await ReadBoundedAsync(entryStream, prefix + entry.FullName, entry.Length, entry.CompressedLength, state, ct);
+                            if (content != null)
+                                await ScanEntryAsync(prefix + entry.FullName, content, depth, state, ct);
+                        }
+                    }
+                    break;
+
+                case ArchiveFormat.Tar:
+                    using (var tar = new TarReader(stream, leaveOpen: true))
+                    {
+                        TarEntry? entry;
+                        while (!state.Stopped && (entry = await tar.GetNextEntryAsync(copyData: false, ct)) != null)
+                        {
+                            if (entry.EntryType is not (TarEntryType.RegularFile or TarEntryType.V7RegularFile) ||
+                                entry.DataStream == null)
+                                continue;
+
+                            if (!TryBeginEntry(prefix + entry.Name, state))
+                                return;
+
+                            // TAR غير مضغوط - الحجم الفعلي هو الحجم المعلن
+                            var content = await ReadBoundedAsync(entry.DataStream, prefix + entry.Name, entry.Length, 0, state, ct);
+                            if (content != null)
+                                await ScanEntryAsync(prefix + entry.Name, content, depth, state, ct);
+                        }
+                    }
+                    break;
+
+                case ArchiveFormat.GZip:
+                    {
+                        var innerName = StripGZipExtension(containerName);
+                        var expectedLength = ReadGZipOriginalSize(stream);
+                        byte[]? content;
+
+                        await using (var gzip = new GZipStream(stream, CompressionMode.Decompress, leaveOpen: true))
+                        {
+                            content = await ReadBoundedAsync(gzip, prefix + innerName, expectedLength, compressedSize, state, ct);
+                        }
+
+                        if (content == null)
+                            return;
+
+                        // tar.gz: GZIP غلاف شفاف لا يُحتسب مستوى تداخل
+                        if (DetectFormat(content) == ArchiveFormat.Tar)
+                        {
+                            using var inner = new MemoryStream(content, writable: false);
+                            await ScanContainerAsync(inner, ArchiveFormat.Tar, prefix, innerName, content.Length, depth, state, ct);
+                        }
+                        else if (TryBeginEntry(prefix + innerName, state))
+                        {
+                            await ScanEntryAsync(prefix + innerName, content, depth, state, ct);
+                        }
+                    }
+                    break;
+            }
+        }
+
+        /// <summary>
+        /// فحص عنصر من الذاكرة، والتكرار فيه إن كان أرشيفاً متداخلاً
+        /// </summary>
+        private async Task ScanEntryAsync(string entryPath, byte[] content, int depth, ScanState state, CancellationToken ct)
+        {
+            var nested = DetectFormat(content);
+            if (nested != ArchiveFormat.None)
+            {
+                if (depth >= _limits.MaxDepth)
+                {
+                    MarkUnscanned(state, entryPath, $"تجاوز أقصى عمق تداخل ({_limits.MaxDepth}) في {entryPath}");
+                }
+                else
+                {
+                    try
+                    {
+                        using var inner = new MemoryStream(content, writable: false);
+                        await ScanContainerAsync(inner, nested, entryPath + ">", Path.GetFileName(entryPath), content.Length, depth + 1, state, ct);
+                    }
+                    catch (Exception ex) when (ex is InvalidDataException or EndOfStreamException or FormatException)
+                    {
+                        // أرشيف داخلي تالف - يُفحص كعنصر عادي
+                        _logger?.LogDebug("أرشيف داخلي تالف: {Entry} - {Error}", entryPath, ex.Message);
+                    }
+
+                    if (state.Stopped) return;
+                }
+            }
+
+            var context = _aggregator.BuildContext(state.ArchivePath, entryPath, content);
+            var entryResult = new ArchiveEntryResult
+            {
+                EntryPath = entryPath,
+                Size = content.LongLength,
+                Sha256 = context.Sha256Hash
+            };
+
+            if (context.Sha256Hash != null && _verdictCache.TryGet(context.Sha256Hash, out var cached))
+            {
+                entryResult.Result = cached;
+                entryResult.FromCache = true;
+                state.Result.CacheHits++;
+            }
+            else
+            {
+                entryResult.Result = await _aggregator.ScanAsync(context, ct);
+
+                if (context.Sha256Hash != null)
+                    _verdictCache.Set(context.Sha256Hash, entryResult.Result);
+            }
+
+            state.Result.Entries.Add(entryResult);
+        }
+
+        /// <summary>
+        /// قراءة عنصر إلى الذاكرة مع مراقبة الحجم الفعلي بعد فك الضغط.
+        /// المصفوفة تُحجز مرة واحدة بالحجم المعلن ويُقرأ فيها مباشرة، ولا تُنسخ
+        /// إلا إن كان الحجم المعلن خاطئاً.
+        /// </summary>
+        /// <param name="expectedLength">الحجم المعلن بعد فك الضغط (0 = غير معروف)</param>
+        private async Task<byte[]?> ReadBoundedAsync(
+            Stream source, string entryPath, long expectedLength, long compressedLength, ScanState state, CancellationToken ct)
+        {
+            long maxBytes = Math.Min(_limits.MaxEntryBytes, Array.MaxLength);
+
+            // حجم معلن مزيف لا يحجز أكثر مما تسمح به نسبة الضغط
+            if (compressedLength > 0)
+                expectedLength = Math.Min(expectedLength, Math.Max(MinBytesForRatioCheck, compressedLength * _limits.MaxCompressionRatio));
+
+            var content = new byte[(int)Math.Clamp(expectedLength > 0 ? expectedLength : CopyBufferSize, 1, maxBytes)];
+            var probe = new byte[1];
+            int total = 0;
+
+            while (true)
+            {
+                int read;
+                if (total == content.Length)
+                {
+                    // المصفوفة ممتلئة: بايت واحد يحدد هل انتهى العنصر أم يجب التوسيع
+                    read = await source.ReadAsync(probe, ct);
+                    if (read == 0)
+                        break;
+
+                    if (total >= maxBytes)
+                    {
+                        MarkUnscanned(state, entryPath, $"عنصر أكبر من الحد المسموح: {entryPath}");
+                        return null;
+                    }
+
+                    Array.Resize(ref content, (int)Math.Min(maxBytes, Math.Max(content.Length * 2L, CopyBufferSize)));
+                    content[total] = probe[0];
+                }
+                else
+                {
+                    read = await source.ReadAsync(content.AsMemory(total), ct);
+                    if (read == 0)
+                        break;
+                }
+
+                total += read;
+                state.Result.BytesInflated += read;
+
+                // الأحجام المعلنة قد تكون مزيفة - نعتمد على ما فُك فعلاً
+                if (compressedLength > 0 && IsRatioExceeded(total, compressedLength))
+                {
+                    MarkBomb(state, $"نسبة ضغط مفرطة في {entryPath}");
+                    return null;
+                }
+
+                if (state.Result.BytesInflated > _limits.MaxTotalBytes)
+                {
+                    MarkBomb(state, $"تجاوز الحجم الإجمالي بعد فك الضغط ({_limits.MaxTotalBytes / (1024 * 1024)} MB)");
+                    return null;
+                }
+            }
+
+            if (total != content.Length)
+                Array.Resize(ref content, total);
+
+            return content;
+        }
+
+        /// <summary>
+        /// الحجم الأصلي من ذيل GZIP (ISIZE) إن كان التدفق قابلاً للتنقل
+        /// </summary>
+        private static long ReadGZipOriginalSize(Stream stream)
+        {
+            if (!stream.CanSeek || stream.Length - stream.Position < 18)
+                return 0;
+
+            var position = stream.Position;
+            try
+            {
+                Span<byte> trailer = stackalloc byte[4];
+                stream.Seek(-4, SeekOrigin.End);
+                stream.ReadExactly(trailer);
+                return BinaryPrimitives.ReadUInt32LittleEndian(trailer);
+            }
+            finally
+            {
+                stream.Position = position;
+            }
+        }
+
+        private bool IsRatioExceeded(long inflated, long compressed)
+        {
+            if (inflated < MinBytesForRatioCheck)
+                return false;
+
+            return compressed <= 0 || inflated / compressed > _limits.MaxCompressionRatio;
+        }
+
+        private bool TryBeginEntry(string entryPath, ScanState state)
+        {
+            if (state.Result.EntriesScanned >= _limits.MaxEntries)
+            {
+                MarkUnscanned(state, entryPath, $"تجاوز أقصى عدد عناصر ({_limits.MaxEntries})");
+                state.Stopped = true;
+                return false;
+            }
+
+            state.Result.EntriesScanned++;
+            return true;
+        }
+
+        private static void MarkUnscanned(ScanState state, string entryPath, string reason)
+        {
+            state.Result.LimitReason ??= reason;
+            state.Result.UnscannedEntries.Add(new ArchiveUnscannedEntry { EntryPath = entryPath, Reason = reason });
+        }
+
+        private static void MarkBomb(ScanState state, string reason)
+        {
+            state.Result.BombDetected = true;
+            state.Result.LimitReason = reason;
+            state.Stopped = true;
+        }
+
+        private static string StripGZipExtension(string name)
+        {
+            if (name.EndsWith(".tgz", StringComparison.OrdinalIgnoreCase))
+                return name[..^4] + ".tar";
+            if (name.EndsWith(".gz", StringComparison.OrdinalIgnoreCase))
+                return name[..^3];
+            return name;
+        }
+
+        /// <summary>
+        /// حالة فحص أرشيف واحد عبر جميع المستويات
+        /// </summary>
+        private sealed class ScanState
+        {
+            public string ArchivePath { get; }
+            public ArchiveScanResult Result { get; }
+            public bool Stopped { get; set; }
+
+            public ScanState(string archivePath, ArchiveScanResult result)
+            {
+                ArchivePath = archivePath;
+                Result = result;
+            }
+        }
+    }
+}
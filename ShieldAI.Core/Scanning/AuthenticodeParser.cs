@@ -0,0 +1,680 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/AuthenticodeParser.cs
+// محلل Authenticode مُدار لجدول الشهادات في ملفات PE
+// =====================================================
+
+using System.Formats.Asn1;
+using System.Reflection.PortableExecutable;
+using System.Security.Cryptography;
+using System.Security.Cryptography.X509Certificates;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// نتيجة تحليل توقيع Authenticode
+    /// </summary>
+    public sealed class AuthenticodeSignature
+    {
+        /// <summary>
+        /// ملف بلا جدول شهادات
+        /// </summary>
+        public static readonly AuthenticodeSignature Unsigned = new();
+
+        /// <summary>
+        /// هل يحتوي الملف على توقيع (سليماً كان أو لا)
+        /// </summary>
+        public bool IsSigned { get; init; }
+
+        /// <summary>
+        /// الاسم الشائع (CN) لشهادة الموقّع - يُطابق مع قوائم الناشرين
+        /// </summary>
+        public string? SignerName { get; init; }
+
+        /// <summary>
+        /// الاسم المميز الكامل لشهادة الموقّع
+        /// </summary>
+        public string? SignerSubject { get; init; }
+
+        /// <summary>
+        /// مُصدر شهادة الموقّع
+        /// </summary>
+        public string? IssuerSubject { get; init; }
+
+        /// <summary>
+        /// بصمة شهادة الموقّع (SHA1 بصيغة Hex)
+        /// </summary>
+        public string? Thumbprint { get; init; }
+
+        /// <summary>
+        /// سلسلة الشهادات المضمنة من الموقّع صعوداً
+        /// </summary>
+        public IReadOnlyList<string> ChainSubjects { get; init; } = Array.Empty<string>();
+
+        /// <summary>
+        /// خوارزمية بصمة الصورة (SHA256, SHA1...)
+        /// </summary>
+        public string? DigestAlgorithm { get; init; }
+
+        /// <summary>
+        /// بصمة الصورة الموقّعة (Hex) كما وردت في SpcIndirectDataContent
+        /// </summary>
+        public string? Digest { get; init; }
+
+        /// <summary>
+        /// توقيع الموقّع على الخصائص الموقّعة صحيح وبصمة المحتوى مطابقة
+        /// </summary>
+        public bool SignatureIntact { get; init; }
+
+        /// <summary>
+        /// مطابقة بصمة الصورة المحسوبة للموقّعة (null = لم تُحسب)
+        /// </summary>
+        public bool? ImageHashMatches { get; init; }
+
+        /// <summary>
+        /// وقت التوقيع (UTC) من ختم زمني تحقق توقيعه (RFC 3161 أو countersignature) - null إن لم يوجد
+        /// </summary>
+        public DateTime? TimestampUtc { get; init; }
+
+        /// <summary>
+        /// سبب فشل التحليل إن وجد
+        /// </summary>
+        public string? Error { get; init; }
+
+        /// <summary>
+        /// توقيع سليم: الموقّع تحقق والصورة لم تُعدّل بعد التوقيع
+        /// </summary>
+        public bool IsValid => IsSigned && SignatureIntact && ImageHashMatches != false;
+
+        /// <summary>
+        /// شهادة الموقّع (لبناء السلسلة عند الحاجة)
+        /// </summary>
+        internal X509Certificate2? SignerCertificate { get; init; }
+
+        /// <summary>
+        /// كل الشهادات المضمنة في الـ PKCS#7
+        /// </summary>
+        internal X509Certificate2Collection? Certificates { get; init; }
+
+        /// <summary>
+        /// شهادة سلطة الختم الزمني (تُبنى سلسلتها قبل الوثوق بالوقت)
+        /// </summary>
+        internal X509Certificate2? TimestampCertificate { get; init; }
+
+        /// <summary>
+        /// الشهادات المضمنة مع الختم الزمني (RFC 3161 يحمل شهاداته الخاصة)
+        /// </summary>
+        internal X509Certificate2Collection? TimestampCertificates { get; init; }
+
+        internal static AuthenticodeSignature Malformed(string error) => new() { IsSigned = true, Error = error };
+    }
+
+    /// <summary>
+    /// محلل جدول الشهادات (WIN_CERTIFICATE / PKCS#7) بدون WinTrust - يعمل على كل المنصات
+    /// ولا يرمي استثناءات للملفات غير الموقعة.
+    /// </summary>
+    public static class AuthenticodeParser
+    {
+        private const ushort WinCertTypePkcsSignedData = 0x0002;
+        private const string SignedDataOid = "1.2.840.113549.1.7.2";
+        private const string SpcIndirectDataOid = "1.3.6.1.4.1.311.2.1.4";
+        private const string MessageDigestOid = "1.2.840.113549.1.9.4";
+        private const string SigningTimeOid = "1.2.840.113549.1.9.5";
+        private const string CounterSignatureOid = "1.2.840.113549.1.9.6";
+        private const string Rfc3161TimestampOid = "1.3.6.1.4.1.311.3.3.1";
+        private const string TstInfoOid = "1.2.840.113549.1.9.16.1.4";
+        private const int BufferSize = 81920;
+
+        private static readonly Asn1Tag Context0 = new(TagClass.ContextSpecific, 0);
+        private static readonly Asn1Tag Context1 = new(TagClass.ContextSpecific, 1);
+
+        /// <summary>
+        /// مواقع الحقول المستثناة من بصمة الصورة
+        /// </summary>
+        private readonly record struct ImageLayout(int ChecksumOffset, int CertEntryOffset, int TableOffset, int TableSize);
+
+        /// <summary>
+        /// ختم زمني تحقق توقيعه على قيمة توقيع الموقّع
+        /// </summary>
+        private sealed record Timestamp(DateTime Utc, X509Certificate2 Certificate, X509Certificate2Collection Certificates);
+
+        /// <summary>
+        /// تحليل من صورة الملف في الذاكرة (البيانات المقروءة مسبقاً للفحص)
+        /// </summary>
+        public static AuthenticodeSignature Parse(ReadOnlySpan<byte> image, PEHeaders headers)
+        {
+            if (!TryGetLayout(headers, image.Length, out var layout))
+                return AuthenticodeSignature.Unsigned;
+
+            var signature = ParseCertificateTable(image.Slice(layout.TableOffset, layout.TableSize));
+            if (!signature.IsSigned || signature.Error != null || !TryGetHashAlgorithm(signature.DigestAlgorithm, out var algorithm))
+                return signature;
+
+            using var hash = IncrementalHash.CreateHash(algorithm);
+            hash.AppendData(image[..layout.ChecksumOffset]);
+            hash.AppendData(image[(layout.ChecksumOffset + 4)..layout.CertEntryOffset]);
+            hash.AppendData(image[(layout.CertEntryOffset + 8)..layout.TableOffset]);
+            hash.AppendData(image[(layout.TableOffset + layout.TableSize)..]);
+
+            return WithImageHash(signature, hash.GetHashAndReset());
+        }
+
+        /// <summary>
+        /// تحليل من Stream قابل للتنقل (للملفات الكبيرة دون تحميلها كاملة)
+        /// </summary>
+        public static AuthenticodeSignature Parse(Stream stream, PEHeaders headers)
+        {
+            if (stream.Length > int.MaxValue || !TryGetLayout(headers, (int)stream.Length, out var layout))
+                return AuthenticodeSignature.Unsigned;
+
+            var table = new byte[layout.TableSize];
+            stream.Position = layout.TableOffset;
+            stream.ReadExactly(table);
+
+            var signature = ParseCertificateTable(table);
+            if (!signature.IsSigned || signature.Error != null || !TryGetHashAlgorithm(signature.DigestAlgorithm, out var algorithm))
+                return signature;
+
+            using var hash = IncrementalHash.CreateHash(algorithm);
+            var buffer = new byte[BufferSize];
+            AppendRange(stream, hash, buffer, 0, layout.ChecksumOffset);
+            AppendRange(stream, hash, buffer, layout.ChecksumOffset + 4, layout.CertEntryOffset);
+            AppendRange(stream, hash, buffer, layout.CertEntryOffset + 8, layout.TableOffset);
+            AppendRange(stream, hash, buffer, layout.TableOffset + layout.TableSize, stream.Length);
+
+            return WithImageHash(signature, hash.GetHashAndReset());
+        }
+
+        /// <summary>
+        /// تحليل ملف من القرص (يقرأ الجدول ثم يمرر الصورة مرة واحدة للبصمة)
+        /// </summary>
+        public static AuthenticodeSignature Parse(string filePath)
+        {
+            try
+            {
+                using var stream = new FileStream(filePath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite, BufferSize);
+                using var peReader = new PEReader(stream, PEStreamOptions.LeaveOpen);
+                return Parse(stream, peReader.PEHeaders);
+            }
+            catch (BadImageFormatException)
+            {
+                return AuthenticodeSignature.Unsigned;
+            }
+            catch (IOException ex)
+            {
+                return new AuthenticodeSignature { Error = ex.Message };
+            }
+            catch (UnauthorizedAccessException ex)
+            {
+                return new AuthenticodeSignature { Error = ex.Message };
+            }
+        }
+
+        private static bool TryGetLayout(PEHeaders headers, int length, out ImageLayout layout)
+        {
+            layout = default;
+            var peHeader = headers.PEHeader;
+            if (peHeader == null)
+                return false;
+
+            var directory = peHeader.CertificateTableDirectory;
+            if (directory.Size < 8)
+                return false;
+
+            // عنوان جدول الشهادات إزاحة في الملف وليس RVA
+            var optionalHeader = headers.PEHeaderStartOffset;
+            var certEntry = optionalHeader + (peHeader.Magic == PEMagic.PE32Plus ? 144 : 128);
+            var tableOffset = directory.RelativeVirtualAddress;
+
+            if (tableOffset < certEntry + 8 || (long)tableOffset + directory.Size > length)
+                return false;
+
+            layout = new ImageLayout(optionalHeader + 64, certEntry, tableOffset, directory.Size);
+            return true;
+        }
+
+        private static AuthenticodeSignature ParseCertificateTable(ReadOnlySpan<byte> table)
+        {
+            // WIN_CERTIFICATE: dwLength, wRevision, wCertificateType ثم المحتوى، كل مدخل بمحاذاة 8
+            int offset = 0;
+            while (offset + 8 <= table.Length)
+            {
+                var length = BitConverter.ToInt32(table.Slice(offset, 4));
+                var type = BitConverter.ToUInt16(table.Slice(offset + 6, 2));
+                if (length < 8 || offset + length > table.Length)
+                    break;
+
+                if (type == WinCertTypePkcsSignedData)
+                    return ParsePkcs7(table.Slice(offset + 8, length - 8).ToArray());
+
+                offset += (length + 7) & ~7;
+            }
+
+            return AuthenticodeSignature.Malformed("جدول الشهادات لا يحتوي PKCS#7");
+        }
+
+        private static AuthenticodeSignature ParsePkcs7(byte[] der)
+        {
+            try
+            {
+                var contentInfo = new AsnReader(der, AsnEncodingRules.BER).ReadSequence();
+                if (contentInfo.ReadObjectIdentifier() != SignedDataOid)
+                    return AuthenticodeSignature.Malformed("ليس SignedData");
+
+                var signedData = contentInfo.ReadSequence(Context0).ReadSequence();
+                signedData.ReadInteger(); // version
+                signedData.ReadSetOf(skipSortOrderValidation: true); // digestAlgorithms
+
+                var encapContent = signedData.ReadSequence();
+                if (encapContent.ReadObjectIdentifier() != SpcIndirectDataOid)
+                    return AuthenticodeSignature.Malformed("المحتوى ليس SpcIndirectDataContent");
+
+                // Authenticode يضع SpcIndirectDataContent مباشرة داخل [0] دون OCTET STRING
+                var spcEncoded = encapContent.ReadSequence(Context0).ReadEncodedValue();
+                var spc = new AsnReader(spcEncoded, AsnEncodingRules.BER).ReadSequence();
+                spc.ReadEncodedValue(); // SpcAttributeTypeAndOptionalValue
+                var digestInfo = spc.ReadSequence();
+                var digestOid = digestInfo.ReadSequence().ReadObjectIdentifier();
+                var digest = digestInfo.ReadOctetString();
+
+                var certificates = new X509Certificate2Collection();
+                if (signedData.HasData && signedData.PeekTag().HasSameClassAndValue(Context0))
+                {
+                    var certSet = signedData.ReadSetOf(skipSortOrderValidation: true, expectedTag: Context0);
+                    while (certSet.HasData)
+                    {
+                        var tag = certSet.PeekTag();
+                        var encoded = certSet.ReadEncodedValue();
+                        if (tag.HasSameClassAndValue(Asn1Tag.Sequence))
+                            certificates.Add(new X509Certificate2(encoded.ToArray()));
+                    }
+                }
+
+                if (signedData.HasData && signedData.PeekTag().HasSameClassAndValue(Context1))
+                    signedData.ReadEncodedValue(); // crls
+
+                var signerInfo = signedData.ReadSetOf(skipSortOrderValidation: true).ReadSequence();
+                signerInfo.ReadInteger(); // version
+                if (!signerInfo.PeekTag().HasSameClassAndValue(Asn1Tag.Sequence))
+                    return AuthenticodeSignature.Malformed("معرّف الموقّع غير مدعوم");
+
+                var signerId = signerInfo.ReadSequence();
+                var issuer = signerId.ReadEncodedValue();
+                var serial = signerId.ReadIntegerBytes();
+                var signerDigestOid = signerInfo.ReadSequence().ReadObjectIdentifier();
+
+                ReadOnlyMemory<byte>? signedAttributes = null;
+                if (signerInfo.PeekTag().HasSameClassAndValue(Context0))
+                    signedAttributes = signerInfo.ReadEncodedValue();
+
+                var signatureOid = signerInfo.ReadSequence().ReadObjectIdentifier();
+                var signatureValue = signerInfo.ReadOctetString();
+
+                var signer = FindSigner(certificates, issuer.Span, serial.Span);
+                if (signer == null)
+                    return AuthenticodeSignature.Malformed("شهادة الموقّع غير مضمنة");
+
+                var intact = signedAttributes is { } attributes &&
+                             MessageDigestMatches(attributes, spcEncoded, signerDigestOid) &&
+                             VerifySignerSignature(signer, attributes, signatureValue, signatureOid, signerDigestOid);
+
+                var timestamp = intact ? ReadTimestamp(signerInfo, signatureValue, certificates) : null;
+
+                return new AuthenticodeSignature
+                {
+                    IsSigned = true,
+                    SignerName = signer.GetNameInfo(X509NameType.SimpleName, forIssuer: false),
+                    SignerSubject = signer.Subject,
+                    IssuerSubject = signer.Issuer,
+                    Thumbprint = signer.Thumbprint,
+                    ChainSubjects = BuildEmbeddedChain(signer, certificates),
+                    DigestAlgorithm = TryGetHashAlgorithm(digestOid, out var name) ? name.Name : digestOid,
+                    Digest = Convert.ToHexString(digest),
+                    SignatureIntact = intact,
+                    SignerCertificate = signer,
+                    Certificates = certificates,
+                    TimestampUtc = timestamp?.Utc,
+                    TimestampCertificate = timestamp?.Certificate,
+                    TimestampCertificates = timestamp?.Certificates
+                };
+            }
+            catch (Exception ex) when (ex is AsnContentException or CryptographicException)
+            {
+                return AuthenticodeSignature.Malformed(ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// الختم الزمني من الخصائص غير الموقعة - يُقبل فقط إذا تحقق توقيعه وطابق توقيع الموقّع.
+        /// ختم تالف لا يُفسد التوقيع نفسه، فقط يُتجاهل.
+        /// </summary>
+        private static Timestamp? ReadTimestamp(AsnReader signerInfo, byte[] signatureValue, X509Certificate2Collection certificates)
+        {
+            try
+            {
+                if (!signerInfo.HasData || !signerInfo.PeekTag().HasSameClassAndValue(Context1))
+                    return null;
+
+                var attributes = signerInfo.ReadSetOf(skipSortOrderValidation: true, expectedTag: Context1);
+                while (attributes.HasData)
+                {
+                    var attribute = attributes.ReadSequence();
+                    var oid = attribute.ReadObjectIdentifier();
+                    var value = attribute.ReadSetOf(skipSortOrderValidation: true).ReadEncodedValue();
+
+                    var timestamp = oid switch
+                    {
+                        CounterSignatureOid => ReadCounterSignature(value, signatureValue, certificates),
+                        Rfc3161TimestampOid => ReadRfc3161Token(value, signatureValue),
+                        _ => null
+                    };
+
+                    if (timestamp != null)
+                        return timestamp;
+                }
+            }
+            catch (Exception ex) when (ex is AsnContentException or CryptographicException)
+            {
+            }
+
+            return null;
+        }
+
+        /// <summary>
+        /// PKCS#9 countersignature: SignerInfo بصمته على قيمة توقيع الموقّع ووقته في signingTime
+        /// </summary>
+        private static Timestamp? ReadCounterSignature(
+            ReadOnlyMemory<byte> encoded, byte[] signatureValue, X509Certificate2Collection certificates)
+        {
+            var signerInfo = new AsnReader(encoded, AsnEncodingRules.BER).ReadSequence();
+            if (!TryVerifySignerInfo(signerInfo, certificates, out var signer, out var attributes, out var algorithm) ||
+                !DigestEquals(FindAttribute(attributes, MessageDigestOid), algorithm, signatureValue))
+            {
+                return null;
+            }
+
+            var signingTime = FindAttribute(attributes, SigningTimeOid);
+            if (signingTime == null)
+                return null;
+
+            var time = signingTime.PeekTag().HasSameClassAndValue(new Asn1Tag(UniversalTagNumber.UtcTime))
+                ? signingTime.ReadUtcTime()
+                : signingTime.ReadGeneralizedTime();
+            return new Timestamp(time.UtcDateTime, signer, certificates);
+        }
+
+        /// <summary>
+        /// ختم RFC 3161: SignedData يحمل TSTInfo - messageImprint على قيمة توقيع الموقّع والوقت في genTime
+        /// </summary>
+        private static Timestamp? ReadRfc3161Token(ReadOnlyMemory<byte> encoded, byte[] signatureValue)
+        {
+            var contentInfo = new AsnReader(encoded, AsnEncodingRules.BER).ReadSequence();
+            if (contentInfo.ReadObjectIdentifier() != SignedDataOid)
+                return null;
+
+            var signedData = contentInfo.ReadSequence(Context0).ReadSequence();
+            signedData.ReadInteger(); // version
+            signedData.ReadSetOf(skipSortOrderValidation: true); // digestAlgorithms
+
+            var encapContent = signedData.ReadSequence();
+            if (encapContent.ReadObjectIdentifier() != TstInfoOid)
+                return null;
+            var tstInfoBytes = encapContent.ReadSequence(Context0).ReadOctetString();
+
+            var certificates = new X509Certificate2Collection();
+            if (signedData.HasData && signedData.PeekTag().HasSameClassAndValue(Context0))
+            {
+                var certSet = signedData.ReadSetOf(skipSortOrderValidation: true, expectedTag: Context0);
+                while (certSet.HasData)
+                {
+                    var tag = certSet.PeekTag();
+                    var certificate = certSet.ReadEncodedValue();
+                    if (tag.HasSameClassAndValue(Asn1Tag.Sequence))
+                        certificates.Add(new X509Certificate2(certificate.ToArray()));
+                }
+            }
+
+            if (signedData.HasData && signedData.PeekTag().HasSameClassAndValue(Context1))
+                signedData.ReadEncodedValue(); // crls
+
+            var signerInfo = signedData.ReadSetOf(skipSortOrderValidation: true).ReadSequence();
+            if (!TryVerifySignerInfo(signerInfo, certificates, out var signer, out var attributes, out var algorithm) ||
+                !DigestEquals(FindAttribute(attributes, MessageDigestOid), algorithm, tstInfoBytes))
+            {
+                return null;
+            }
+
+            var tstInfo = new AsnReader(tstInfoBytes, AsnEncodingRules.DER).ReadSequence();
+            tstInfo.ReadInteger(); // version
+            tstInfo.ReadObjectIdentifier(); // policy
+            var imprint = tstInfo.ReadSequence();
+            var imprintOid = imprint.ReadSequence().ReadObjectIdentifier();
+            var hashedMessage = imprint.ReadOctetString();
+            tstInfo.ReadIntegerBytes(); // serialNumber
+            var genTime = tstInfo.ReadGeneralizedTime();
+
+            if (!TryGetHashAlgorithm(imprintOid, out var imprintAlgorithm) ||
+                !CryptographicOperations.FixedTimeEquals(HashData(imprintAlgorithm, signatureValue), hashedMessage))
+            {
+                return null;
+            }
+
+            return new Timestamp(genTime.UtcDateTime, signer, certificates);
+        }
+
+        /// <summary>
+        /// قراءة SignerInfo (issuerAndSerialNumber + خصائص موقعة) والتحقق من توقيعه
+        /// </summary>
+        private static bool TryVerifySignerInfo(
+            AsnReader signerInfo,
+            X509Certificate2Collection certificates,
+            out X509Certificate2 signer,
+            out ReadOnlyMemory<byte> signedAttributes,
+            out HashAlgorithmName algorithm)
+        {
+            signer = null!;
+            signedAttributes = default;
+            algorithm = default;
+
+            signerInfo.ReadInteger(); // version
+            if (!signerInfo.PeekTag().HasSameClassAndValue(Asn1Tag.Sequence))
+                return false;
+
+            var signerId = signerInfo.ReadSequence();
+            var issuer = signerId.ReadEncodedValue();
+            var serial = signerId.ReadIntegerBytes();
+            var digestOid = signerInfo.ReadSequence().ReadObjectIdentifier();
+
+            if (!signerInfo.PeekTag().HasSameClassAndValue(Context0))
+                return false;
+            signedAttributes = signerInfo.ReadEncodedValue();
+
+            var signatureOid = signerInfo.ReadSequence().ReadObjectIdentifier();
+            var signature = signerInfo.ReadOctetString();
+
+            var found = FindSigner(certificates, issuer.Span, serial.Span);
+            if (found == null || !TryGetHashAlgorithm(digestOid, out algorithm) ||
+                !VerifySignerSignature(found, signedAttributes, signature, signatureOid, digestOid))
+            {
+                return false;
+            }
+
+            signer = found;
+            return true;
+        }
+
+        /// <summary>
+        /// قيمة أول خاصية بالمعرّف المطلوب من مجموعة الخصائص الموقعة ([0] IMPLICIT SET)
+        /// </summary>
+        private static AsnReader? FindAttribute(ReadOnlyMemory<byte> signedAttributes, string oid)
+        {
+            var attributes = new AsnReader(signedAttributes, AsnEncodingRules.BER).ReadSetOf(skipSortOrderValidation: true, expectedTag: Context0);
+            while (attributes.HasData)
+            {
+                var attribute = attributes.ReadSequence();
+                if (attribute.ReadObjectIdentifier() == oid)
+                    return attribute.ReadSetOf(skipSortOrderValidation: true);
+            }
+
+            return null;
+        }
+
+        private static bool DigestEquals(AsnReader? messageDigest, HashAlgorithmName algorithm, ReadOnlySpan<byte> content) =>
+            messageDigest != null &&
+            CryptographicOperations.FixedTimeEquals(HashData(algorithm, content), messageDigest.ReadOctetString());
+
+        private static byte[] HashData(HashAlgorithmName algorithm, ReadOnlySpan<byte> content)
+        {
+            using var hash = IncrementalHash.CreateHash(algorithm);
+            hash.AppendData(content);
+            return hash.GetHashAndReset();
+        }
+
+        private static X509Certificate2? FindSigner(X509Certificate2Collection certificates, ReadOnlySpan<byte> issuer, ReadOnlySpan<byte> serial)
+        {
+            var wantedSerial = TrimLeadingZeros(serial);
+            foreach (var certificate in certificates)
+            {
+                if (certificate.IssuerName.RawData.AsSpan().SequenceEqual(issuer) &&
+                    TrimLeadingZeros(certificate.SerialNumberBytes.Span).SequenceEqual(wantedSerial))
+                {
+                    return certificate;
+                }
+            }
+
+            return null;
+        }
+
+        private static ReadOnlySpan<byte> TrimLeadingZeros(ReadOnlySpan<byte> value)
+        {
+            int i = 0;
+            while (i < value.Length - 1 && value[i] == 0)
+                i++;
+            return value[i..];
+        }
+
+        private static bool MessageDigestMatches(ReadOnlyMemory<byte> signedAttributes, ReadOnlyMemory<byte> spcEncoded, string digestOid)
+        {
+            if (!TryGetHashAlgorithm(digestOid, out var algorithm))
+                return false;
+
+            var attributes = new AsnReader(signedAttributes, AsnEncodingRules.BER).ReadSetOf(skipSortOrderValidation: true, expectedTag: Context0);
+            while (attributes.HasData)
+            {
+                var attribute = attributes.ReadSequence();
+                if (attribute.ReadObjectIdentifier() != MessageDigestOid)
+                    continue;
+
+                var expected = attribute.ReadSetOf(skipSortOrderValidation: true).ReadOctetString();
+
+                // البصمة تُحسب على قيمة SpcIndirectDataContent دون الوسم والطول
+                AsnDecoder.ReadEncodedValue(spcEncoded.Span, AsnEncodingRules.BER, out var contentOffset, out var contentLength, out _);
+                using var hash = IncrementalHash.CreateHash(algorithm);
+                hash.AppendData(spcEncoded.Span.Slice(contentOffset, contentLength));
+                return hash.GetHashAndReset().AsSpan().SequenceEqual(expected);
+            }
+
+            return false;
+        }
+
+        private static bool VerifySignerSignature(
+            X509Certificate2 signer, ReadOnlyMemory<byte> signedAttributes, byte[] signature, string signatureOid, string digestOid)
+        {
+            if (!TryGetHashAlgorithm(digestOid, out var algorithm))
+                return false;
+
+            // التوقيع على ترميز DER للخصائص بوسم SET بدلاً من [0] IMPLICIT
+            var toVerify = signedAttributes.ToArray();
+            toVerify[0] = 0x31;
+
+            if (signatureOid.StartsWith("1.2.840.113549.1.1.", StringComparison.Ordinal))
+            {
+                using var rsa = signer.GetRSAPublicKey();
+                return rsa != null && rsa.VerifyData(toVerify, signature, algorithm, RSASignaturePadding.Pkcs1);
+            }
+
+            if (signatureOid.StartsWith("1.2.840.10045.", StringComparison.Ordinal))
+            {
+                using var ecdsa = signer.GetECDsaPublicKey();
+                return ecdsa != null && ecdsa.VerifyData(toVerify, signature, algorithm, DSASignatureFormat.Rfc3279DerSequence);
+            }
+
+            return false;
+        }
+
+        private static IReadOnlyList<string> BuildEmbeddedChain(X509Certificate2 signer, X509Certificate2Collection certificates)
+        {
+            var chain = new List<string> { signer.Subject };
+            var current = signer;
+
+            while (chain.Count <= certificates.Count &&
+                   !current.SubjectName.RawData.AsSpan().SequenceEqual(current.IssuerName.RawData))
+            {
+                X509Certificate2? parent = null;
+                foreach (var candidate in certificates)
+                {
+                    if (candidate.SubjectName.RawData.AsSpan().SequenceEqual(current.IssuerName.RawData))
+                    {
+                        parent = candidate;
+                        break;
+                    }
+                }
+
+                if (parent == null)
+                    break;
+
+                chain.Add(parent.Subject);
+                current = parent;
+            }
+
+            return chain;
+        }
+
+        private static AuthenticodeSignature WithImageHash(AuthenticodeSignature signature, byte[] imageHash) => new()
+        {
+            IsSigned = signature.IsSigned,
+            SignerName = signature.SignerName,
+            SignerSubject = signature.SignerSubject,
+            IssuerSubject = signature.IssuerSubject,
+            Thumbprint = signature.Thumbprint,
+            ChainSubjects = signature.ChainSubjects,
+            DigestAlgorithm = signature.DigestAlgorithm,
+            Digest = signature.Digest,
+            SignatureIntact = signature.SignatureIntact,
+            ImageHashMatches = string.Equals(Convert.ToHexString(imageHash), signature.Digest, StringComparison.Ordinal),
+            SignerCertificate = signature.SignerCertificate,
+            Certificates = signature.Certificates,
+            TimestampUtc = signature.TimestampUtc,
+            TimestampCertificate = signature.TimestampCertificate,
+            TimestampCertificates = signature.TimestampCertificates
+        };
+
+        private static void AppendRange(Stream stream, IncrementalHash hash, byte[] buffer, long start, long end)
+        {
+            stream.Position = start;
+            var remaining = end - start;
+            while (remaining > 0)
+            {
+                var read = stream.Read(buffer, 0, (int)Math.Min(buffer.Length, remaining));
+                if (read <= 0)
+                    throw new EndOfStreamException();
+                hash.AppendData(buffer, 0, read);
+                remaining -= read;
+            }
+        }
+
+        private static bool TryGetHashAlgorithm(string? oidOrName, out HashAlgorithmName algorithm)
+        {
+            algorithm = oidOrName switch
+            {
+                "1.3.14.3.2.26" or "SHA1" => HashAlgorithmName.SHA1,
+                "2.16.840.1.101.3.4.2.1" or "SHA256" => HashAlgorithmName.SHA256,
+                "2.16.840.1.101.3.4.2.2" or "SHA384" => HashAlgorithmName.SHA384,
+                "2.16.840.1.101.3.4.2.3" or "SHA512" => HashAlgorithmName.SHA512,
+                "1.2.840.113549.2.5" or "MD5" => HashAlgorithmName.MD5,
+                _ => default
+            };
+            return algorithm.Name != null;
+        }
+    }
+}
@@ -0,0 +1,185 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/AuthenticodeVerifier.cs
+// كاش أحكام التوقيع حسب بصمة الملف وبصمة الشهادة
+// =====================================================
+
+using System.Reflection.PortableExecutable;
+using System.Security.Cryptography;
+using System.Security.Cryptography.X509Certificates;
+using ShieldAI.Core.Caching;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// حكم الناشر لشهادة موقّع - يُحسب مرة لكل شهادة
+    /// </summary>
+    public sealed record PublisherVerdict(
+        string Thumbprint,
+        string? PublisherName,
+        bool ChainTrusted,
+        bool TimeValid,
+        string? ChainStatus,
+        DateTime? TimestampUtc = null);
+
+    /// <summary>
+    /// التحقق من Authenticode مع كاشين: التوقيع حسب SHA256 الملف (التحليل مرة لكل ملف)
+    /// والحكم حسب بصمة الشهادة (بناء السلسلة مرة لكل ناشر).
+    /// </summary>
+    public sealed class AuthenticodeVerifier
+    {
+        private static readonly Lazy<AuthenticodeVerifier> SharedInstance = new(() => new AuthenticodeVerifier());
+
+        /// <summary>
+        /// المتحقق المشترك للعملية
+        /// </summary>
+        public static AuthenticodeVerifier Shared => SharedInstance.Value;
+
+        private const string CodeSigningEku = "1.3.6.1.5.5.7.3.3";
+        private const string TimeStampingEku = "1.3.6.1.5.5.7.3.8";
+
+        private readonly BoundedCache<string, AuthenticodeSignature> _signatures;
+        private readonly BoundedCache<string, PublisherVerdict> _verdicts;
+        private readonly X509Certificate2Collection? _trustedRoots;
+
+        /// <param name="trustedRoots">جذور ثقة بديلة عن مخزن النظام (null = مخزن النظام)</param>
+        public AuthenticodeVerifier(int maxFiles = 20_000, int maxCertificates = 1_024, X509Certificate2Collection? trustedRoots = null)
+        {
+            _trustedRoots = trustedRoots;
+            _signatures = new BoundedCache<string, AuthenticodeSignature>(
+                new BoundedCacheOptions { Name = "AuthenticodeSignatures", MaxEntries = maxFiles },
+                comparer: StringComparer.OrdinalIgnoreCase);
+            _verdicts = new BoundedCache<string, PublisherVerdict>(
+                new BoundedCacheOptions { Name = "PublisherVerdicts", MaxEntries = maxCertificates, Ttl = TimeSpan.FromHours(12) },
+                comparer: StringComparer.OrdinalIgnoreCase);
+        }
+
+        public CacheStatistics SignatureCacheStatistics => _signatures.GetStatistics();
+
+        public CacheStatistics VerdictCacheStatistics => _verdicts.GetStatistics();
+
+        /// <summary>
+        /// التوقيع من صورة مقروءة مسبقاً - لا يُعاد التحليل لنفس البصمة
+        /// </summary>
+        public AuthenticodeSignature GetSignature(ReadOnlySpan<byte> image, PEHeaders headers, string sha256)
+        {
+            if (_signatures.TryGet(sha256, out var cached))
+                return cached;
+
+            var signature = AuthenticodeParser.Parse(image, headers);
+            _signatures.Set(sha256, signature);
+            return signature;
+        }
+
+        /// <summary>
+        /// التوقيع من ملف على القرص (بدون بصمة لا يُخزن في الكاش)
+        /// </summary>
+        public AuthenticodeSignature GetSignature(string filePath, string? sha256 = null)
+        {
+            if (!string.IsNullOrEmpty(sha256) && _signatures.TryGet(sha256, out var cached))
+                return cached;
+
+            var signature = AuthenticodeParser.Parse(filePath);
+
+            // أخطاء الإدخال/الإخراج عابرة فلا تُحفظ
+            if (!string.IsNullOrEmpty(sha256) && (signature.IsSigned || signature.Error == null))
+                _signatures.Set(sha256, signature);
+
+            return signature;
+        }
+
+        /// <summary>
+        /// حكم الناشر لتوقيع موجود (null للملفات غير الموقعة)
+        /// </summary>
+        public PublisherVerdict? GetPublisherVerdict(AuthenticodeSignature signature)
+        {
+            if (!signature.IsSigned || signature.SignerCertificate == null || string.IsNullOrEmpty(signature.Thumbprint))
+                return null;
+
+            // الحكم يتبع الختم الزمني أيضاً: نفس الشهادة قد تكون منتهية لملف وصالحة لآخر خُتم قبل انتهائها
+            var key = signature.TimestampUtc is { } timestamp
+                ? $"{signature.Thumbprint}|{timestamp.Ticks}"
+                : signature.Thumbprint;
+
+            if (_verdicts.TryGet(key, out var cached))
+                return cached;
+
+            var verdict = BuildVerdict(signature);
+            _verdicts.Set(key, verdict);
+            return verdict;
+        }
+
+        /// <summary>
+        /// بناء السلسلة بغرض توقيع الشيفرة. الشهادة يجب أن تكون صالحة الآن، أو وقت ختم زمني
+        /// موثوق يقع داخل فترة صلاحيتها - وعندها تُقيَّم السلسلة كلها في وقت الختم.
+        /// </summary>
+        private PublisherVerdict BuildVerdict(AuthenticodeSignature signature)
+        {
+            var signer = signature.SignerCertificate!;
+            var timestamp = GetTrustedTimestamp(signature);
+            var verificationTime = timestamp?.ToLocalTime() ?? DateTime.Now;
+            var timeValid = signer.NotBefore <= verificationTime && verificationTime <= signer.NotAfter;
+
+            try
+            {
+                using var chain = CreateChain(CodeSigningEku, verificationTime, signature.Certificates);
+
+                var trusted = chain.Build(signer) && timeValid;
+                var status = trusted
+                    ? null
+                    : string.Join(", ", chain.ChainStatus.Select(s => s.Status.ToString()));
+
+                return new PublisherVerdict(signature.Thumbprint!, signature.SignerName, trusted, timeValid, status, timestamp);
+            }
+            catch (Exception ex)
+            {
+                return new PublisherVerdict(signature.Thumbprint!, signature.SignerName, false, timeValid, ex.Message, timestamp);
+            }
+        }
+
+        /// <summary>
+        /// وقت الختم إذا كانت سلطة الختم موثوقة (بغرض الختم الزمني) في ذلك الوقت - وإلا null
+        /// </summary>
+        private DateTime? GetTrustedTimestamp(AuthenticodeSignature signature)
+        {
+            if (signature.TimestampUtc is not { } timestamp || signature.TimestampCertificate == null)
+                return null;
+
+            try
+            {
+                using var chain = CreateChain(TimeStampingEku, timestamp.ToLocalTime(), signature.TimestampCertificates);
+                return chain.Build(signature.TimestampCertificate) ? timestamp : null;
+            }
+            catch (CryptographicException)
+            {
+                return null;
+            }
+        }
+
+        private X509Chain CreateChain(string eku, DateTime verificationTime, X509Certificate2Collection? extraCertificates)
+        {
+            var chain = new X509Chain();
+            chain.ChainPolicy.ApplicationPolicy.Add(new Oid(eku));
+            chain.ChainPolicy.VerificationTime = verificationTime;
+
+            // الإلغاء من قوائم CRL المخزنة محلياً فقط (لا شبكة في مسار الفحص)؛ الشهادة الملغاة تُرفض
+            // والحالة المجهولة لا تُسقط السلسلة
+            chain.ChainPolicy.RevocationMode = X509RevocationMode.Offline;
+            chain.ChainPolicy.RevocationFlag = X509RevocationFlag.ExcludeRoot;
+            chain.ChainPolicy.VerificationFlags =
+                X509VerificationFlags.IgnoreEndRevocationUnknown |
+                X509VerificationFlags.IgnoreCertificateAuthorityRevocationUnknown;
+
+            if (_trustedRoots != null)
+            {
+                chain.ChainPolicy.TrustMode = X509ChainTrustMode.CustomRootTrust;
+                chain.ChainPolicy.CustomTrustStore.AddRange(_trustedRoots);
+            }
+
+            if (extraCertificates != null)
+                chain.ChainPolicy.ExtraStore.AddRange(extraCertificates);
+
+            return chain;
+        }
+    }
+}
@@ -18,32 +18,35 @@ namespace ShieldAI.Core.Scanning
         private readonly ILogger? _logger;
         private readonly AppSettings _settings;
         private readonly HashSet<string> _excludedExtensions;
-        private readonly HashSet<string> _excludedFolders;
-        private readonly HashSet<string> _visitedPaths = new(StringComparer.OrdinalIgnoreCase);
+        private readonly PathPolicy? _pathPolicy;
 
-        public FileEnumerator(ILogger? logger = null)
+        /// <param name="pathPolicy">سياسة المسارات - null يعني PathPolicy.Current (تتبع تغيير الإعدادات)</param>
+        public FileEnumerator(ILogger? logger = null, PathPolicy? pathPolicy = null)
         {
             _logger = logger;
             _settings = ConfigManager.Instance.Settings;
+            _pathPolicy = pathPolicy;
             
             _excludedExtensions = _settings.ExcludedExtensions
                 .Select(e => e.Trim().ToLowerInvariant())
                 .ToHashSet();
-            
-            _excludedFolders = _settings.ExcludedFolders
-                .Select(f => f.Trim().ToLowerInvariant())
-                .ToHashSet();
         }
 
         /// <summary>
         /// تعداد الملفات في مسار
         /// </summary>
-        public IEnumerable<FileInfo> EnumerateFiles(string path, bool recursive = true)
+        /// <param name="maxDepth">أقصى عمق للمجلدات الفرعية (-1 = بلا حد)</param>
+        /// <param name="includeHidden">تضمين الملفات والمجلدات المخفية</param>
+        public IEnumerable<FileInfo> EnumerateFiles(
+            string path,
+            bool recursive = true,
+            int maxDepth = -1,
+            bool includeHidden = true)
         {
             if (File.Exists(path))
             {
                 var fileInfo = new FileInfo(path);
-                if (ShouldIncludeFile(fileInfo))
+                if (ShouldIncludeFile(fileInfo, includeHidden))
                     yield return fileInfo;
                 yield break;
             }
@@ -54,20 +57,60 @@ namespace ShieldAI.Core.Scanning
                 yield break;
             }
 
-            foreach (var file in EnumerateDirectorySafe(path, recursive))
+            // مجموعة الزيارات لكل تعداد - إعادة استخدام المعدِّد لا تتخطى مسارات فُحصت سابقاً
+            var visited = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+            var state = new EnumerationState(visited, recursive ? maxDepth : 0, includeHidden, Ordered: false);
+
+            foreach (var file in EnumerateDirectorySafe(path, 0, state))
             {
                 yield return file;
             }
         }
 
+        /// <summary>
+        /// تعداد تدفقي لعدة جذور بترتيب Ordinal للمسار الكامل (لنقاط الاستئناف).
+        /// يُرتب كل مجلد على حدة أثناء النزول، فلا تُجمع قائمة الملفات كاملة في الذاكرة.
+        /// </summary>
+        /// <param name="maxDepth">أقصى عمق للمجلدات الفرعية (-1 = بلا حد)</param>
+        /// <param name="includeHidden">تضمين الملفات والمجلدات المخفية</param>
+        public IEnumerable<FileInfo> EnumerateFilesOrdered(
+            IEnumerable<string> paths,
+            int maxDepth = -1,
+            bool includeHidden = true)
+        {
+            // الزيارات مشتركة: الجذر المتداخل مع جذر سابق لا يُعاد تعداده
+            var visited = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+            var state = new EnumerationState(visited, maxDepth, includeHidden, Ordered: true);
+
+            var roots = paths
+                .Select(p => Path.GetFullPath(p))
+                .Select(p => (Path: p, IsDirectory: Directory.Exists(p)))
+                .Select(r => (Key: r.IsDirectory ? DirectoryKey(r.Path) : r.Path, r.Path, r.IsDirectory))
+                .OrderBy(r => r.Key, StringComparer.Ordinal)
+                .ToList();
+
+            foreach (var root in roots)
+            {
+                if (!root.IsDirectory)
+                {
+                    foreach (var file in EnumerateFiles(root.Path, includeHidden: includeHidden))
+                        yield return file;
+                    continue;
+                }
+
+                foreach (var file in EnumerateDirectorySafe(root.Path, 0, state))
+                    yield return file;
+            }
+        }
+
         /// <summary>
         /// تعداد مجلد بشكل آمن
         /// </summary>
-        private IEnumerable<FileInfo> EnumerateDirectorySafe(string directory, bool recursive)
+        private IEnumerable<FileInfo> EnumerateDirectorySafe(string directory, int depth, EnumerationState state)
         {
             // تجنب الحلقات اللانهائية
             var realPath = GetRealPath(directory);
-            if (!_visitedPaths.Add(realPath))
+            if (!state.Visited.Add(realPath))
             {
                 _logger?.LogDebug("تم تخطي مسار مكرر: {Path}", directory);
                 yield break;
@@ -80,6 +123,13 @@ namespace ShieldAI.Core.Scanning
                 yield break;
             }
 
+            if (state.Ordered)
+            {
+                foreach (var file in EnumerateDirectoryOrdered(directory, depth, state))
+                    yield return file;
+                yield break;
+            }
+
             // تعداد الملفات
             IEnumerable<string> files;
             try
@@ -103,24 +153,13 @@ namespace ShieldAI.Core.Scanning
 
             foreach (var filePath in files)
             {
-                FileInfo? fileInfo = null;
-                bool shouldInclude = false;
-                try
-                {
-                    fileInfo = new FileInfo(filePath);
-                    shouldInclude = ShouldIncludeFile(fileInfo);
-                }
-                catch (Exception ex) when (ex is UnauthorizedAccessException or IOException or PathTooLongException)
-                {
-                    _logger?.LogDebug("تعذر الوصول للملف: {Path}", filePath);
-                }
-                
-                if (shouldInclude && fileInfo != null)
+                var fileInfo = TryGetIncludedFile(filePath, state.IncludeHidden);
+                if (fileInfo != null)
                     yield return fileInfo;
             }
 
             // المجلدات الفرعية
-            if (!recursive) yield break;
+            if (state.MaxDepth >= 0 && depth >= state.MaxDepth) yield break;
 
             IEnumerable<string> subdirectories;
             try
@@ -134,24 +173,104 @@ namespace ShieldAI.Core.Scanning
 
             foreach (var subdir in subdirectories)
             {
-                // تخطي Reparse Points (Symlinks, Junctions)
-                if (IsReparsePoint(subdir))
-                {
-                    _logger?.LogDebug("تم تخطي Reparse Point: {Path}", subdir);
+                if (!ShouldDescend(subdir, state))
                     continue;
-                }
 
-                foreach (var file in EnumerateDirectorySafe(subdir, true))
+                foreach (var file in EnumerateDirectorySafe(subdir, depth + 1, state))
                 {
                     yield return file;
                 }
             }
         }
 
+        /// <summary>
+        /// تعداد مجلد بترتيب Ordinal: مفتاح المجلد الفرعي = مساره + فاصل،
+        /// فكل ما بداخله يقع بين جيرانه كما في ترتيب المسارات الكاملة
+        /// </summary>
+        private IEnumerable<FileInfo> EnumerateDirectoryOrdered(string directory, int depth, EnumerationState state)
+        {
+            var entries = new List<(string Key, string Path, bool IsDirectory)>();
+            try
+            {
+                foreach (var filePath in Directory.EnumerateFiles(directory))
+                    entries.Add((filePath, filePath, false));
+            }
+            catch (Exception ex) when (ex is UnauthorizedAccessException or IOException)
+            {
+                _logger?.LogDebug("تعذر تعداد المجلد: {Path} - {Error}", directory, ex.Message);
+                yield break;
+            }
+
+            if (state.MaxDepth < 0 || depth < state.MaxDepth)
+            {
+                try
+                {
+                    foreach (var subdir in Directory.EnumerateDirectories(directory))
+                        entries.Add((DirectoryKey(subdir), subdir, true));
+                }
+                catch (Exception ex) when (ex is UnauthorizedAccessException or IOException)
+                {
+                    // الملفات المباشرة تبقى قابلة للفحص
+                }
+            }
+
+            entries.Sort((a, b) => string.CompareOrdinal(a.Key, b.Key));
+
+            foreach (var entry in entries)
+            {
+                if (!entry.IsDirectory)
+                {
+                    var fileInfo = TryGetIncludedFile(entry.Path, state.IncludeHidden);
+                    if (fileInfo != null)
+                        yield return fileInfo;
+                    continue;
+                }
+
+                if (!ShouldDescend(entry.Path, state))
+                    continue;
+
+                foreach (var file in EnumerateDirectorySafe(entry.Path, depth + 1, state))
+                    yield return file;
+            }
+        }
+
+        private static string DirectoryKey(string directory)
+        {
+            return Path.EndsInDirectorySeparator(directory)
+                ? directory
+                : directory + Path.DirectorySeparatorChar;
+        }
+
+        private FileInfo? TryGetIncludedFile(string filePath, bool includeHidden)
+        {
+            try
+            {
+                var fileInfo = new FileInfo(filePath);
+                return ShouldIncludeFile(fileInfo, includeHidden) ? fileInfo : null;
+            }
+            catch (Exception ex) when (ex is UnauthorizedAccessException or IOException or PathTooLongException)
+            {
+                _logger?.LogDebug("تعذر الوصول للملف: {Path}", filePath);
+                return null;
+            }
+        }
+
+        private bool ShouldDescend(string subdir, EnumerationState state)
+        {
+            // تخطي Reparse Points (Symlinks, Junctions)
+            if (IsReparsePoint(subdir))
+            {
+                _logger?.LogDebug("تم تخطي Reparse Point: {Path}", subdir);
+                return false;
+            }
+
+            return state.IncludeHidden || !IsHidden(subdir);
+        }
+
         /// <summary>
         /// هل يجب تضمين الملف؟
         /// </summary>
-        private bool ShouldIncludeFile(FileInfo file)
+        private bool ShouldIncludeFile(FileInfo file, bool includeHidden = true)
         {
             // تخطي الملفات الكبيرة جداً
             if (file.Length > _settings.MaxFileSizeMB * 1024 * 1024)
@@ -173,19 +292,22 @@ namespace ShieldAI.Core.Scanning
                 return false;
             }
 
+            if (!includeHidden && (file.Attributes & FileAttributes.Hidden) != 0)
+                return false;
+
             return true;
         }
 
         /// <summary>
-        /// هل المجلد مستثنى؟
+        /// هل المجلد مستثنى؟ ExcludedFolders عبر PathPolicy (جذور مطلقة ومقاطع متعددة)
         /// </summary>
         private bool IsExcludedFolder(string path)
         {
-            var dirName = Path.GetFileName(path)?.ToLowerInvariant() ?? "";
-            
-            if (_excludedFolders.Contains(dirName))
+            if ((_pathPolicy ?? PathPolicy.Current).Matches(path, PathClass.Excluded, isDirectory: true))
                 return true;
 
+            var dirName = Path.GetFileName(path)?.ToLowerInvariant() ?? "";
+
             // مجلدات النظام الشائعة
             var systemFolders = new[] 
             { 
@@ -213,6 +335,18 @@ namespace ShieldAI.Core.Scanning
             }
         }
 
+        private static bool IsHidden(string path)
+        {
+            try
+            {
+                return (File.GetAttributes(path) & FileAttributes.Hidden) != 0;
+            }
+            catch
+            {
+                return false;
+            }
+        }
+
         /// <summary>
         /// الحصول على المسار الحقيقي
         /// </summary>
@@ -273,5 +407,10 @@ namespace ShieldAI.Core.Scanning
             }
             return count;
         }
+
+        /// <summary>
+        /// حالة تعداد واحد (الزيارات والحدود)
+        /// </summary>
+        private sealed record EnumerationState(HashSet<string> Visited, int MaxDepth, bool IncludeHidden, bool Ordered);
     }
 }
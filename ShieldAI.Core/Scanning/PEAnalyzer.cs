@@ -57,71 +57,102 @@ public class PEAnalyzer
         "CryptEncrypt", "CryptDecrypt", "CryptAcquireContext"
     };
 
+    private readonly AuthenticodeVerifier _authenticode;
+
+    /// <param name="authenticode">متحقق التوقيع (الافتراضي: المشترك مع كاشه)</param>
+    public PEAnalyzer(AuthenticodeVerifier? authenticode = null)
+    {
+        _authenticode = authenticode ?? AuthenticodeVerifier.Shared;
+    }
+
     /// <summary>
     /// تحليل ملف PE واستخراج معلوماته
     /// </summary>
     public PEFileInfo Analyze(string filePath)
     {
-        var info = new PEFileInfo
-        {
-            FileSize = new FileInfo(filePath).Length
-        };
+        var fileSize = new FileInfo(filePath).Length;
 
+        // قراءة واحدة: البصمة والإنتروبيا والترويسات والتوقيع كلها من نفس البيانات
+        byte[] data;
         try
         {
-            // حساب بصمة الملف
-            info.Sha256Hash = CalculateSha256(filePath);
+            data = File.ReadAllBytes(filePath);
+        }
+        catch (Exception)
+        {
+            return new PEFileInfo { FileSize = fileSize };
+        }
 
-            using var stream = new FileStream(filePath, FileMode.Open, FileAccess.Read, FileShare.Read);
-            using var peReader = new PEReader(stream);
+        return Analyze(data);
+    }
 
-            if (!peReader.HasMetadata && peReader.PEHeaders == null)
-            {
-                info.IsValidPE = false;
-                return info;
-            }
+    /// <summary>
+    /// قراءة الترويسات والـ Sections (مشتركة بين الملف والذاكرة)
+    /// </summary>
+    private static bool ReadHeaders(PEReader peReader, PEFileInfo info)
+    {
+        if (!peReader.HasMetadata && peReader.PEHeaders == null)
+        {
+            info.IsValidPE = false;
+            return false;
+        }
 
-            info.IsValidPE = true;
-            var headers = peReader.PEHeaders;
+        info.IsValidPE = true;
+        var headers = peReader.PEHeaders;
 
-            // نوع الملف
-            info.FileType = headers.IsDll ? "DLL" : "EXE";
+        // نوع الملف
+        info.FileType = headers.IsDll ? "DLL" : "EXE";
 
-            // المعمارية
-            info.Architecture = headers.CoffHeader.Machine switch
-            {
-                Machine.I386 => "x86",
-                Machine.Amd64 => "x64",
-                Machine.Arm64 => "ARM64",
-                _ => headers.CoffHeader.Machine.ToString()
-            };
-
-            // تاريخ البناء
-            var timestamp = headers.CoffHeader.TimeDateStamp;
-            if (timestamp > 0)
-            {
-                info.TimeDateStamp = DateTimeOffset.FromUnixTimeSeconds(timestamp).DateTime;
-            }
+        // المعمارية
+        info.Architecture = headers.CoffHeader.Machine switch
+        {
+            Machine.I386 => "x86",
+            Machine.Amd64 => "x64",
+            Machine.Arm64 => "ARM64",
+            _ => headers.CoffHeader.Machine.ToString()
+        };
 
-            // تحليل الـ Sections
-            foreach (var section in headers.SectionHeaders)
-            {
-                info.SectionNames.Add(section.Name);
-            }
-            info.SectionCount = info.SectionNames.Count;
+        // تاريخ البناء
+        var timestamp = headers.CoffHeader.TimeDateStamp;
+        if (timestamp > 0)
+        {
+            info.TimeDateStamp = DateTimeOffset.FromUnixTimeSeconds(timestamp).DateTime;
+        }
 
-            // حساب الإنتروبيا
-            info.Entropy = CalculateEntropy(filePath);
+        // تحليل الـ Sections
+        foreach (var section in headers.SectionHeaders)
+        {
+            info.SectionNames.Add(section.Name);
+        }
+        info.SectionCount = info.SectionNames.Count;
 
-            // استخراج الـ Imports
-            ExtractImports(peReader, info);
+        return true;
+    }
 
-            // التحقق من التوقيع الرقمي
-            info.HasDigitalSignature = CheckDigitalSignature(filePath);
-        }
-        catch (BadImageFormatException)
+    /// <summary>
+    /// تحليل ملف PE من الذاكرة (مثل عنصر داخل أرشيف) دون كتابة على القرص
+    /// </summary>
+    public PEFileInfo Analyze(byte[] data)
+    {
+        var info = new PEFileInfo
         {
-            info.IsValidPE = false;
+            FileSize = data.Length
+        };
+
+        try
+        {
+            info.Sha256Hash = Convert.ToHexString(SHA256.HashData(data));
+
+            using var stream = new MemoryStream(data, writable: false);
+            using var peReader = new PEReader(stream);
+
+            if (!ReadHeaders(peReader, info))
+                return info;
+
+            info.Entropy = CalculateEntropy(data);
+            ExtractImports(peReader, info);
+            info.Signature = _authenticode.GetSignature(data, peReader.PEHeaders, info.Sha256Hash);
+            info.HasDigitalSignature = info.Signature.IsSigned;
         }
         catch (Exception)
         {
@@ -223,7 +254,14 @@ public class PEAnalyzer
     /// </summary>
     public static double CalculateEntropy(string filePath)
     {
-        var data = File.ReadAllBytes(filePath);
+        return CalculateEntropy(File.ReadAllBytes(filePath));
+    }
+
+    /// <summary>
+    /// حساب الإنتروبيا لبيانات في الذاكرة
+    /// </summary>
+    public static double CalculateEntropy(ReadOnlySpan<byte> data)
+    {
         if (data.Length == 0) return 0;
 
         var frequency = new int[256];
@@ -245,27 +283,6 @@ public class PEAnalyzer
         return entropy;
     }
 
-    /// <summary>
-    /// التحقق من وجود توقيع رقمي
-    /// </summary>
-    private bool CheckDigitalSignature(string filePath)
-    {
-        try
-        {
-            // استخدام WinTrust للتحقق من التوقيع
-            // هذا تطبيق مبسط - في الإنتاج نستخدم WinVerifyTrust API
-            using var stream = new FileStream(filePath, FileMode.Open, FileAccess.Read, FileShare.Read);
-            using var peReader = new PEReader(stream);
-            
-            var certificateDirectory = peReader.PEHeaders.PEHeader?.CertificateTableDirectory;
-            return certificateDirectory?.Size > 0;
-        }
-        catch
-        {
-            return false;
-        }
-    }
-
     /// <summary>
     /// الحصول على قائمة الـ DLLs المشبوهة
     /// </summary>
@@ -0,0 +1,457 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/PathPolicy.cs
+// سياسة المسارات المترجمة (شجرة مقاطع) للاستثناء والحجر والثقة
+// =====================================================
+
+using System.Buffers;
+using ShieldAI.Core.Configuration;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// تصنيفات المسار - قد يحمل المسار أكثر من تصنيف
+    /// </summary>
+    [Flags]
+    public enum PathClass
+    {
+        None = 0,
+        Excluded = 1,       // مستثنى من الفحص (ExcludedFolders)
+        Quarantine = 2,     // مجلد الحجر أو مسار محجور
+        Trusted = 4,        // مسار نظام موثوق
+        TempOrAppData = 8,  // Temp / AppData
+        Startup = 16,       // مجلد بدء التشغيل
+        Suspicious = 32,    // مقطع مشبوه (temp, downloads, public...)
+        Download = 64       // مجلد تنزيلات (DownloadFolders)
+    }
+
+    /// <summary>
+    /// قاعدة مسار: جذر مطلق (Anchored) أو تسلسل مقاطع يطابق في أي موضع من المجلدات
+    /// </summary>
+    public readonly record struct PathRule(string Pattern, PathClass Class, bool Anchored);
+
+    /// <summary>
+    /// سياسة مسارات مترجمة وغير قابلة للتعديل: شجرة مقاطع للجذور المطلقة وأخرى للمقاطع العائمة.
+    /// التصنيف مرور واحد على المقاطع بلا تخصيص ذاكرة (المقارنة غير حساسة لحالة الأحرف
+    /// والفاصلان / و \ متكافئان).
+    /// </summary>
+    public sealed class PathPolicy
+    {
+        private const int MaxStackSegments = 64;
+
+        /// <summary>
+        /// جذور النظام الموثوقة (Windows)
+        /// </summary>
+        public static readonly string[] DefaultTrustedRoots =
+        {
+            @"C:\Windows\",
+            @"C:\Program Files\",
+            @"C:\Program Files (x86)\"
+        };
+
+        /// <summary>
+        /// مقاطع المجلدات المشبوهة - القائمة الموحدة لـ HeuristicEngine و ReputationEngine
+        /// </summary>
+        public static readonly string[] DefaultSuspiciousSegments =
+        {
+            "temp", "tmp", @"appdata\roaming", "downloads", "public", "programdata"
+        };
+
+        /// <summary>
+        /// مقاطع مجلدات التنزيلات الافتراضية
+        /// </summary>
+        public static readonly string[] DefaultDownloadSegments =
+        {
+            "downloads"
+        };
+
+        private static PathPolicy? _current;
+        private static int _subscribed;
+
+        private readonly Node _anchored;
+        private readonly Node _floating;
+        private readonly PathRule[] _rules;
+
+        public static PathPolicy Empty { get; } = new PathPolicyBuilder().Build();
+
+        internal PathPolicy(PathRule[] rules, Node anchored, Node floating)
+        {
+            _rules = rules;
+            _anchored = anchored;
+            _floating = floating;
+        }
+
+        /// <summary>
+        /// السياسة المبنية من إعدادات ConfigManager - تُعاد بناؤها عند تغيير الإعدادات
+        /// </summary>
+        public static PathPolicy Current
+        {
+            get
+            {
+                var current = Volatile.Read(ref _current);
+                if (current != null)
+                    return current;
+
+                var config = ConfigManager.Instance;
+                if (Interlocked.Exchange(ref _subscribed, 1) == 0)
+                {
+                    config.SettingsChanged += (_, settings) => Volatile.Write(ref _current, FromSettings(settings));
+                }
+
+                Interlocked.CompareExchange(ref _current, FromSettings(config.Settings), null);
+                return Volatile.Read(ref _current)!;
+            }
+        }
+
+        /// <summary>
+        /// القواعد المترجمة
+        /// </summary>
+        public IReadOnlyList<PathRule> Rules => _rules;
+
+        /// <summary>
+        /// بناء السياسة من الإعدادات ومجلدات النظام
+        /// </summary>
+        public static PathPolicy FromSettings(AppSettings settings)
+        {
+            var builder = new PathPolicyBuilder();
+
+            foreach (var folder in settings.ExcludedFolders)
+                builder.Add(folder, PathClass.Excluded);
+
+            builder.AddRoot(settings.QuarantinePath, PathClass.Quarantine);
+
+            foreach (var root in DefaultTrustedRoots)
+                builder.AddRoot(root, PathClass.Trusted);
+            builder.AddRoot(Environment.GetFolderPath(Environment.SpecialFolder.Windows), PathClass.Trusted);
+            builder.AddRoot(Environment.GetFolderPath(Environment.SpecialFolder.ProgramFiles), PathClass.Trusted);
+            builder.AddRoot(Environment.GetFolderPath(Environment.SpecialFolder.ProgramFilesX86), PathClass.Trusted);
+            foreach (var root in settings.TrustedPaths)
+                builder.AddRoot(root, PathClass.Trusted);
+
+            builder.AddRoot(Path.GetTempPath(), PathClass.TempOrAppData);
+            builder.AddRoot(Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData), PathClass.TempOrAppData);
+            builder.AddRoot(Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData), PathClass.TempOrAppData);
+            builder.AddRoot(Environment.GetFolderPath(Environment.SpecialFolder.Startup), PathClass.Startup);
+
+            foreach (var segments in DefaultSuspiciousSegments)
+                builder.AddSegments(segments, PathClass.Suspicious);
+
+            foreach (var segments in DefaultDownloadSegments)
+                builder.AddSegments(segments, PathClass.Download);
+            foreach (var folder in settings.DownloadFolders)
+                builder.Add(folder, PathClass.Download);
+
+            return builder.Build();
+        }
+
+        /// <summary>
+        /// نسخة جديدة بقاعدة إضافية (السياسة الحالية لا تتغير)
+        /// </summary>
+        public PathPolicy WithRule(string pattern, PathClass pathClass)
+        {
+            var builder = new PathPolicyBuilder(_rules);
+            builder.Add(pattern, pathClass);
+            return builder.Build();
+        }
+
+        /// <summary>
+        /// تصنيف مسار. المقاطع العائمة تطابق المجلدات فقط (لا اسم الملف) إلا إذا كان المسار مجلداً.
+        /// </summary>
+        public PathClass Classify(ReadOnlySpan<char> path, bool isDirectory = false) =>
+            Walk(path, isDirectory, PathClass.None, out _);
+
+        /// <summary>
+        /// هل يحمل المسار أياً من التصنيفات المطلوبة
+        /// </summary>
+        public bool Matches(ReadOnlySpan<char> path, PathClass pathClass, bool isDirectory = false) =>
+            (Classify(path, isDirectory) & pathClass) != 0;
+
+        /// <summary>
+        /// نص أول قاعدة طابقت التصنيف المطلوب (للأسباب في النتائج) - null إذا لم تطابق
+        /// </summary>
+        public string? FindRule(ReadOnlySpan<char> path, PathClass pathClass, bool isDirectory = false)
+        {
+            Walk(path, isDirectory, pathClass, out var rule);
+            return rule;
+        }
+
+        private PathClass Walk(
+            ReadOnlySpan<char> path, bool isDirectory, PathClass wanted, out string? rule, bool normalized = false)
+        {
+            rule = null;
+            if (path.IsEmpty)
+                return PathClass.None;
+
+            // مسار نسبي: يُحل مقابل المجلد الحالي كما كان GetFullPath يفعل
+            if (!normalized && !IsRooted(path))
+                return WalkNormalized(path, isDirectory, wanted, out rule);
+
+            int[]? rented = null;
+            Span<int> bounds = stackalloc int[MaxStackSegments * 2];
+
+            try
+            {
+                var count = Split(path, bounds, out var hasParentRef);
+                if (count < 0)
+                {
+                    rented = ArrayPool<int>.Shared.Rent(path.Length + 2);
+                    bounds = rented;
+                    count = Split(path, bounds, out hasParentRef);
+                }
+
+                if (hasParentRef && !normalized)
+                    return WalkNormalized(path, isDirectory, wanted, out rule);
+
+                var classes = PathClass.None;
+
+                var node = _anchored;
+                for (int i = 0; i < count && node.HasChildren; i++)
+                {
+                    node = node.Find(path.Slice(bounds[2 * i], bounds[2 * i + 1]));
+                    if (node == null)
+                        break;
+                    Accumulate(node, wanted, ref classes, ref rule);
+                }
+
+                var directoryCount = isDirectory ? count : count - 1;
+                for (int start = 0; start < directoryCount && _floating.HasChildren; start++)
+                {
+                    node = _floating;
+                    for (int i = start; i < directoryCount && node.HasChildren; i++)
+                    {
+                        node = node.Find(path.Slice(bounds[2 * i], bounds[2 * i + 1]));
+                        if (node == null)
+                            break;
+                        Accumulate(node, wanted, ref classes, ref rule);
+                    }
+                }
+
+                return classes;
+            }
+            finally
+            {
+                if (rented != null)
+                    ArrayPool<int>.Shared.Return(rented);
+            }
+        }
+
+        private PathClass WalkNormalized(ReadOnlySpan<char> path, bool isDirectory, PathClass wanted, out string? rule)
+        {
+            rule = null;
+            string full;
+            try
+            {
+                full = Path.GetFullPath(path.ToString());
+            }
+            catch
+            {
+                return PathClass.None;
+            }
+
+            // مرة واحدة فقط: مسار Windows على Unix يبقى بمقاطع ".." بعد GetFullPath
+            return Walk(full, isDirectory, wanted, out rule, normalized: true);
+        }
+
+        private static void Accumulate(Node node, PathClass wanted, ref PathClass classes, ref string? rule)
+        {
+            if (node.Terminal == PathClass.None)
+                return;
+
+            classes |= node.Terminal;
+            if (rule == null && (node.Terminal & wanted) != 0)
+                rule = node.Rule;
+        }
+
+        /// <summary>
+        /// مطلق بحسب Windows أو Unix بغض النظر عن نظام التشغيل الحالي (C:\ و \\server و /)
+        /// </summary>
+        internal static bool IsRooted(ReadOnlySpan<char> path) =>
+            path.Length > 0 && (path[0] == '/' || path[0] == '\\' || (path.Length >= 2 && path[1] == ':'));
+
+        /// <summary>
+        /// تقسيم المسار إلى مقاطع (بداية، طول) - يتجاهل المقاطع الفارغة و "."؛ -1 إذا لم تتسع bounds
+        /// </summary>
+        internal static int Split(ReadOnlySpan<char> path, Span<int> bounds, out bool hasParentRef)
+        {
+            hasParentRef = false;
+            int count = 0;
+            int start = 0;
+
+            for (int i = 0; i <= path.Length; i++)
+            {
+                if (i < path.Length && path[i] != '/' && path[i] != '\\')
+                    continue;
+
+                var length = i - start;
+                if (length > 0 && !(length == 1 && path[start] == '.'))
+                {
+                    if (length == 2 && path[start] == '.' && path[start + 1] == '.')
+                        hasParentRef = true;
+
+                    if (2 * count + 1 >= bounds.Length)
+                        return -1;
+
+                    bounds[2 * count] = start;
+                    bounds[2 * count + 1] = length;
+                    count++;
+                }
+
+                start = i + 1;
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// عقدة مترجمة: الأبناء مرتبة حسب hash المقطع (بحث ثنائي ثم مقارنة النص)
+        /// </summary>
+        internal sealed class Node
+        {
+            public PathClass Terminal;
+            public string? Rule;
+            public int[] Hashes = Array.Empty<int>();
+            public string[] Names = Array.Empty<string>();
+            public Node[] Children = Array.Empty<Node>();
+
+            public bool HasChildren => Children.Length > 0;
+
+            public Node? Find(ReadOnlySpan<char> segment)
+            {
+                var hash = string.GetHashCode(segment, StringComparison.OrdinalIgnoreCase);
+                var index = Array.BinarySearch(Hashes, hash);
+                if (index < 0)
+                    return null;
+
+                while (index > 0 && Hashes[index - 1] == hash)
+                    index--;
+
+                for (; index < Hashes.Length && Hashes[index] == hash; index++)
+                {
+                    if (segment.Equals(Names[index], StringComparison.OrdinalIgnoreCase))
+                        return Children[index];
+                }
+
+                return null;
+            }
+        }
+    }
+
+    /// <summary>
+    /// باني سياسة المسارات
+    /// </summary>
+    public sealed class PathPolicyBuilder
+    {
+        private readonly List<PathRule> _rules = new();
+
+        public PathPolicyBuilder()
+        {
+        }
+
+        public PathPolicyBuilder(IEnumerable<PathRule> rules)
+        {
+            _rules.AddRange(rules);
+        }
+
+        /// <summary>
+        /// مسار مطلق = جذر، وإلا = تسلسل مقاطع عائم (مثل node_modules أو windows\winsxs)
+        /// </summary>
+        public PathPolicyBuilder Add(string pattern, PathClass pathClass)
+        {
+            var trimmed = pattern?.Trim();
+            if (string.IsNullOrEmpty(trimmed))
+                return this;
+
+            return PathPolicy.IsRooted(trimmed)
+                ? AddRoot(trimmed, pathClass)
+                : AddSegments(trimmed, pathClass);
+        }
+
+        /// <summary>
+        /// جذر مطلق يطابق نفسه وكل ما تحته
+        /// </summary>
+        public PathPolicyBuilder AddRoot(string root, PathClass pathClass)
+        {
+            if (!string.IsNullOrWhiteSpace(root))
+                _rules.Add(new PathRule(root.Trim(), pathClass, Anchored: true));
+            return this;
+        }
+
+        /// <summary>
+        /// تسلسل مقاطع يطابق أي موضع من مجلدات المسار
+        /// </summary>
+        public PathPolicyBuilder AddSegments(string segments, PathClass pathClass)
+        {
+            if (!string.IsNullOrWhiteSpace(segments))
+                _rules.Add(new PathRule(segments.Trim(), pathClass, Anchored: false));
+            return this;
+        }
+
+        public PathPolicy Build()
+        {
+            var anchored = new BuilderNode();
+            var floating = new BuilderNode();
+
+            foreach (var rule in _rules)
+            {
+                var pattern = rule.Pattern;
+
+                // جذر نسبي في Windows (مثل \Users) على Unix أو العكس يبقى كما هو - مقاطع فقط
+                if (rule.Anchored && !PathPolicy.IsRooted(pattern))
+                {
+                    try { pattern = Path.GetFullPath(pattern); } catch { continue; }
+                }
+
+                var node = rule.Anchored ? anchored : floating;
+                var depth = 0;
+                foreach (var segment in pattern.Split('/', '\\'))
+                {
+                    if (segment.Length == 0 || segment == ".")
+                        continue;
+
+                    if (!node.Children.TryGetValue(segment, out var child))
+                    {
+                        child = new BuilderNode();
+                        node.Children[segment] = child;
+                    }
+
+                    node = child;
+                    depth++;
+                }
+
+                // قاعدة بلا مقاطع (مثل "/") لا تُطبّق - كانت ستطابق كل شيء
+                if (depth == 0)
+                    continue;
+
+                node.Terminal |= rule.Class;
+                node.Rule ??= rule.Pattern;
+            }
+
+            return new PathPolicy(_rules.ToArray(), anchored.Compile(), floating.Compile());
+        }
+
+        private sealed class BuilderNode
+        {
+            public readonly Dictionary<string, BuilderNode> Children = new(StringComparer.OrdinalIgnoreCase);
+            public PathClass Terminal;
+            public string? Rule;
+
+            public PathPolicy.Node Compile()
+            {
+                var entries = Children
+                    .Select(kv => (Hash: string.GetHashCode(kv.Key.AsSpan(), StringComparison.OrdinalIgnoreCase),
+                                   Name: kv.Key, Node: kv.Value.Compile()))
+                    .OrderBy(e => e.Hash)
+                    .ToArray();
+
+                return new PathPolicy.Node
+                {
+                    Terminal = Terminal,
+                    Rule = Rule,
+                    Hashes = entries.Select(e => e.Hash).ToArray(),
+                    Names = entries.Select(e => e.Name).ToArray(),
+                    Children = entries.Select(e => e.Node).ToArray()
+                };
+            }
+        }
+    }
+}
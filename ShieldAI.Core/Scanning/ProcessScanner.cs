@@ -1,6 +1,5 @@
 using System.Diagnostics;
 using System.Security.Cryptography;
-using System.Security.Cryptography.X509Certificates;
 using ShieldAI.Core.Models;
 
 namespace ShieldAI.Core.Scanning;
@@ -125,8 +124,15 @@ public class ProcessScanner
             }
         }
 
-        // 2. فحص التوقيع الرقمي
-        var signatureInfo = GetDigitalSignature(info.ExecutablePath);
+        // 2. حساب الـ Hash للسمعة ومفتاحاً لكاش التوقيع
+        try
+        {
+            info.FileHash = CalculateSha256(info.ExecutablePath);
+        }
+        catch { }
+
+        // 3. فحص التوقيع الرقمي
+        var signatureInfo = GetDigitalSignature(info.ExecutablePath, info.FileHash);
         if (signatureInfo.IsSigned)
         {
             trustScore += 2;
@@ -141,13 +147,6 @@ public class ProcessScanner
             suspicionScore += 1; // غير موقع = مشبوه قليلاً
         }
 
-        // 3. حساب الـ Hash للسمعة (يمكن ربطه بقاعدة بيانات لاحقاً)
-        try
-        {
-            info.FileHash = CalculateSha256(info.ExecutablePath);
-        }
-        catch { }
-
         // تحديد الحالة النهائية
         info.IsTrusted = trustScore >= 4;
         info.IsSuspicious = suspicionScore >= 2 && trustScore < 3;
@@ -159,35 +158,17 @@ public class ProcessScanner
     }
 
     /// <summary>
-    /// الحصول على معلومات التوقيع الرقمي
+    /// الحصول على معلومات التوقيع الرقمي (محلل Authenticode مع كاش حسب بصمة الملف)
     /// </summary>
-    private (bool IsSigned, string? Publisher) GetDigitalSignature(string filePath)
+    private static (bool IsSigned, string? Publisher) GetDigitalSignature(string filePath, string? sha256)
     {
-        try
-        {
-            var cert = X509Certificate.CreateFromSignedFile(filePath);
-            var cert2 = new X509Certificate2(cert);
-            
-            // استخراج اسم الناشر من Subject
-            var subject = cert2.Subject;
-            var cnStart = subject.IndexOf("CN=", StringComparison.OrdinalIgnoreCase);
-            if (cnStart >= 0)
-            {
-                cnStart += 3;
-                var cnEnd = subject.IndexOf(',', cnStart);
-                var publisher = cnEnd > cnStart 
-                    ? subject.Substring(cnStart, cnEnd - cnStart).Trim('"')
-                    : subject.Substring(cnStart).Trim('"');
-                
-                return (true, publisher);
-            }
-            
-            return (true, cert2.Subject);
-        }
-        catch
-        {
+        var signature = AuthenticodeVerifier.Shared.GetSignature(filePath, sha256);
+        if (!signature.IsValid)
             return (false, null);
-        }
+
+        // اسم الناشر لا يُعتمد إلا مع سلسلة موثوقة
+        var verdict = AuthenticodeVerifier.Shared.GetPublisherVerdict(signature);
+        return (true, verdict?.ChainTrusted == true ? signature.SignerName : null);
     }
 
     /// <summary>
@@ -4,7 +4,7 @@
 // كاش نتائج الفحص لتقليل إعادة الفحص
 // =====================================================
 
-using System.Collections.Concurrent;
+using ShieldAI.Core.Caching;
 using ShieldAI.Core.Detection.ThreatScoring;
 
 namespace ShieldAI.Core.Scanning
@@ -14,28 +14,34 @@ namespace ShieldAI.Core.Scanning
     /// </summary>
     public class ScanCache
     {
-        private readonly ConcurrentDictionary<string, CacheEntry> _entries = new();
-        private readonly TimeSpan _ttl;
-        private readonly int _maxEntries;
+        private readonly BoundedCache<ScanCacheKey, CacheEntry> _entries;
 
-        public ScanCache(TimeSpan? ttl = null, int maxEntries = 20_000)
+        public ScanCache(TimeSpan? ttl = null, int maxEntries = 20_000, long maxBytes = 0)
         {
-            _ttl = ttl ?? TimeSpan.FromMinutes(30);
-            _maxEntries = Math.Max(1, maxEntries);
+            _entries = new BoundedCache<ScanCacheKey, CacheEntry>(
+                new BoundedCacheOptions
+                {
+                    Name = "ScanCache",
+                    MaxEntries = Math.Max(1, maxEntries),
+                    MaxBytes = maxBytes,
+                    Ttl = ttl ?? TimeSpan.FromMinutes(30),
+                    Policy = CacheEvictionPolicy.Lru
+                },
+                sizeOf: entry => entry.EstimatedBytes);
         }
 
+        /// <summary>
+        /// إحصائيات الإصابة والإخلاء
+        /// </summary>
+        public CacheStatistics Statistics => _entries.GetStatistics();
+
+        public int Count => _entries.Count;
+
         public bool TryGet(string sha256, long fileSize, DateTime lastWriteUtc, out AggregatedThreatResult? result)
         {
             result = null;
-            var key = BuildKey(sha256, fileSize, lastWriteUtc);
-            if (!_entries.TryGetValue(key, out var entry))
-                return false;
-
-            if (DateTime.UtcNow - entry.TimestampUtc > _ttl)
-            {
-                _entries.TryRemove(key, out _);
+            if (!_entries.TryGet(new ScanCacheKey(sha256, fileSize, lastWriteUtc.Ticks), out var entry))
                 return false;
-            }
 
             result = entry.CloneResult();
             return true;
@@ -43,54 +49,41 @@ namespace ShieldAI.Core.Scanning
 
         public void Store(string sha256, long fileSize, DateTime lastWriteUtc, AggregatedThreatResult result)
         {
-            var key = BuildKey(sha256, fileSize, lastWriteUtc);
-            _entries[key] = new CacheEntry(result);
-            TrimIfNeeded();
+            _entries.Set(new ScanCacheKey(sha256, fileSize, lastWriteUtc.Ticks), new CacheEntry(result));
         }
 
         public void ClearExpired()
         {
-            foreach (var kvp in _entries)
-            {
-                if (DateTime.UtcNow - kvp.Value.TimestampUtc > _ttl)
-                    _entries.TryRemove(kvp.Key, out _);
-            }
+            _entries.RemoveExpired();
         }
 
-        private void TrimIfNeeded()
-        {
-            if (_entries.Count <= _maxEntries)
-                return;
-
-            ClearExpired();
-
-            var excess = _entries.Count - _maxEntries;
-            if (excess <= 0)
-                return;
-
-            foreach (var entry in _entries
-                         .OrderBy(kvp => kvp.Value.TimestampUtc)
-                         .Take(excess))
-            {
-                _entries.TryRemove(entry.Key, out _);
-            }
-        }
-
-        private static string BuildKey(string sha256, long fileSize, DateTime lastWriteUtc)
-        {
-            return $"{sha256}:{fileSize}:{lastWriteUtc.Ticks}";
-        }
+        private readonly record struct ScanCacheKey(string Sha256, long FileSize, long LastWriteTicks);
 
         private sealed class CacheEntry
         {
             public CacheEntry(AggregatedThreatResult result)
             {
                 Result = result;
-                TimestampUtc = DateTime.UtcNow;
+                EstimatedBytes = EstimateBytes(result);
             }
 
             public AggregatedThreatResult Result { get; }
-            public DateTime TimestampUtc { get; }
+            public long EstimatedBytes { get; }
+
+            private static long EstimateBytes(AggregatedThreatResult result)
+            {
+                // تقدير تقريبي: رأس الكائن + النصوص (UTF-16) + نتائج المحركات
+                long bytes = 128 + (result.FilePath?.Length ?? 0) * 2;
+                foreach (var reason in result.Reasons)
+                    bytes += 32 + reason.Length * 2;
+                foreach (var engine in result.EngineResults)
+                {
+                    bytes += 160 + engine.EngineName.Length * 2 + engine.Metadata.Count * 64;
+                    foreach (var reason in engine.Reasons)
+                        bytes += 32 + reason.Length * 2;
+                }
+                return bytes;
+            }
 
             public AggregatedThreatResult CloneResult()
             {
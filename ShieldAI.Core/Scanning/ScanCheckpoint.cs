@@ -0,0 +1,320 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/ScanCheckpoint.cs
+// نقاط الاستئناف للفحوصات الطويلة
+// =====================================================
+
+using System.Text.Json;
+using ShieldAI.Core.Models;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// نقطة استئناف مضغوطة لمهمة فحص.
+    /// الملفات تُفحص بترتيب Ordinal للمسار، لذا الموضع = آخر مسار
+    /// اكتمل كل ما قبله + مجموعة صغيرة من المسارات المكتملة بعده.
+    /// </summary>
+    public class ScanCheckpoint
+    {
+        public Guid JobId { get; set; }
+        public List<string> Paths { get; set; } = new();
+        public ScanType Type { get; set; }
+        public bool UseVirusTotal { get; set; }
+        public bool DeepScan { get; set; }
+        public bool ScanArchives { get; set; }
+        public bool ScanHiddenFiles { get; set; } = true;
+        public int MaxDepth { get; set; } = -1;
+        public ScanPriorityClass Priority { get; set; } = ScanPriorityClass.OnDemand;
+
+        /// <summary>
+        /// حدود التقييد الأصلية للفحص (null = بلا تقييد)
+        /// </summary>
+        public ScanThrottleOptions? Throttle { get; set; }
+
+        public DateTime StartedAt { get; set; }
+        public DateTime UpdatedAt { get; set; }
+
+        // الإحصائيات حتى لحظة الحفظ
+        public int TotalFiles { get; set; }
+        public int ScannedFiles { get; set; }
+        public int ThreatsFound { get; set; }
+        public int ErrorCount { get; set; }
+
+        /// <summary>
+        /// آخر مسار اكتمل فحصه مع كل ما قبله (null = لا شيء)
+        /// </summary>
+        public string? LowWaterPath { get; set; }
+
+        /// <summary>
+        /// مسارات مكتملة بعد LowWaterPath (بسبب التوازي)
+        /// </summary>
+        public List<string> CompletedAhead { get; set; } = new();
+
+        /// <summary>
+        /// خطة الأجزاء للفحص الموزّع (null = فحص داخل العملية)
+        /// </summary>
+        public List<ScanShard>? Shards { get; set; }
+
+        /// <summary>
+        /// معرفات الأجزاء المكتملة - الجزء غير المكتمل يُفحص من جديد عند الاستئناف
+        /// </summary>
+        public List<int> CompletedShards { get; set; } = new();
+
+        /// <summary>
+        /// نسبة التقدم عند الحفظ
+        /// </summary>
+        public double ProgressPercent => TotalFiles > 0
+            ? (double)ScannedFiles / TotalFiles * 100
+            : 0;
+
+        /// <summary>
+        /// هل تم فحص هذا المسار قبل الانقطاع
+        /// </summary>
+        public bool IsCompleted(string path, HashSet<string>? completedAhead = null)
+        {
+            if (LowWaterPath != null && string.CompareOrdinal(path, LowWaterPath) <= 0)
+                return true;
+
+            return completedAhead?.Contains(path) ?? CompletedAhead.Contains(path, StringComparer.Ordinal);
+        }
+    }
+
+    /// <summary>
+    /// متتبع موضع الفحص - يحسب Low-Water Mark من فهارس الملفات المكتملة.
+    /// يحفظ مسارات ما اكتمل بعد العلامة فقط، فلا يحتاج قائمة الملفات كاملة.
+    /// </summary>
+    public class ScanCursor
+    {
+        private readonly object _lock = new();
+        private readonly Dictionary<int, string?> _completedAhead = new();
+        private int _lowWater;
+        private string? _lowWaterPath;
+
+        /// <summary>
+        /// عدد الملفات المتصلة المكتملة من البداية
+        /// </summary>
+        public int LowWaterMark
+        {
+            get { lock (_lock) return _lowWater; }
+        }
+
+        public ScanCursor(int startIndex = 0)
+        {
+            _lowWater = startIndex;
+        }
+
+        /// <summary>
+        /// تسجيل اكتمال ملف بفهرسه في الترتيب
+        /// </summary>
+        /// <param name="path">مسار الملف (لنقطة الاستئناف)</param>
+        public void MarkCompleted(int index, string? path = null)
+        {
+            lock (_lock)
+            {
+                if (index < _lowWater) return;
+
+                if (index == _lowWater)
+                {
+                    _lowWater++;
+                    _lowWaterPath = path;
+                    while (_completedAhead.Remove(_lowWater, out var nextPath))
+                    {
+                        _lowWater++;
+                        _lowWaterPath = nextPath;
+                    }
+                }
+                else
+                {
+                    _completedAhead[index] = path;
+                }
+            }
+        }
+
+        /// <summary>
+        /// لقطة من الموضع: (Low-Water Mark, الفهارس المكتملة بعده)
+        /// </summary>
+        public (int LowWater, int[] Ahead) Snapshot()
+        {
+            lock (_lock)
+            {
+                var ahead = _completedAhead.Keys.ToArray();
+                Array.Sort(ahead);
+                return (_lowWater, ahead);
+            }
+        }
+
+        /// <summary>
+        /// لقطة بالمسارات: (آخر مسار اكتمل كل ما قبله، المسارات المكتملة بعده)
+        /// </summary>
+        public (string? LowWaterPath, List<string> Ahead) SnapshotPaths()
+        {
+            lock (_lock)
+            {
+                var ahead = _completedAhead
+                    .OrderBy(e => e.Key)
+                    .Select(e => e.Value)
+                    .OfType<string>()
+                    .ToList();
+                return (_lowWaterPath, ahead);
+            }
+        }
+    }
+
+    /// <summary>
+    /// مخزن نقاط الاستئناف - ملف JSON لكل مهمة مع كتابة ذرية.
+    /// النقاط القديمة أو الزائدة عن الحد تُحذف (بوقت آخر كتابة للملف).
+    /// </summary>
+    public class ScanCheckpointStore
+    {
+        private static readonly JsonSerializerOptions JsonOptions = new() { WriteIndented = false };
+
+        private readonly string _directory;
+        private readonly TimeSpan? _maxAge;
+        private readonly int _maxCount;
+        private readonly object _ioLock = new();
+
+        public string Directory => _directory;
+
+        /// <param name="maxAge">أقصى عمر لنقطة الاستئناف (null = بلا حد)</param>
+        /// <param name="maxCount">أقصى عدد نقاط محفوظة (0 = بلا حد)</param>
+        public ScanCheckpointStore(string directory, TimeSpan? maxAge = null, int maxCount = 0)
+        {
+            _directory = directory;
+            _maxAge = maxAge;
+            _maxCount = maxCount;
+            System.IO.Directory.CreateDirectory(_directory);
+            Prune();
+        }
+
+        /// <summary>
+        /// مخزن بحدود الإعدادات
+        /// </summary>
+        public static ScanCheckpointStore FromSettings(Configuration.AppSettings settings)
+        {
+            return new ScanCheckpointStore(
+                settings.ScanCheckpointPath,
+                settings.ScanCheckpointMaxAgeDays > 0 ? TimeSpan.FromDays(settings.ScanCheckpointMaxAgeDays) : null,
+                settings.ScanCheckpointMaxCount);
+        }
+
+        /// <summary>
+        /// حفظ نقطة استئناف (كتابة ملف مؤقت ثم استبدال)
+        /// </summary>
+        public void Save(ScanCheckpoint checkpoint)
+        {
+            checkpoint.UpdatedAt = DateTime.Now;
+            var path = GetPath(checkpoint.JobId);
+            var tempPath = path + ".tmp";
+            var json = JsonSerializer.Serialize(checkpoint, JsonOptions);
+
+            lock (_ioLock)
+            {
+                File.WriteAllText(tempPath, json);
+                File.Move(tempPath, path, overwrite: true);
+            }
+
+            Prune();
+        }
+
+        /// <summary>
+        /// تحميل نقطة استئناف مهمة
+        /// </summary>
+        public ScanCheckpoint? TryLoad(Guid jobId)
+        {
+            var path = GetPath(jobId);
+            if (!File.Exists(path)) return null;
+
+            try
+            {
+                lock (_ioLock)
+                {
+                    return JsonSerializer.Deserialize<ScanCheckpoint>(File.ReadAllText(path), JsonOptions);
+                }
+            }
+            catch
+            {
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// جميع نقاط الاستئناف المحفوظة
+        /// </summary>
+        public List<ScanCheckpoint> GetAll()
+        {
+            Prune();
+
+            var list = new List<ScanCheckpoint>();
+
+            foreach (var file in System.IO.Directory.EnumerateFiles(_directory, "*.checkpoint"))
+            {
+                if (Guid.TryParse(Path.GetFileNameWithoutExtension(file), out var jobId))
+                {
+                    var checkpoint = TryLoad(jobId);
+                    if (checkpoint != null)
+                        list.Add(checkpoint);
+                }
+            }
+
+            return list.OrderByDescending(c => c.UpdatedAt).ToList();
+        }
+
+        /// <summary>
+        /// حذف نقطة استئناف
+        /// </summary>
+        public bool Delete(Guid jobId)
+        {
+            var path = GetPath(jobId);
+
+            lock (_ioLock)
+            {
+                if (!File.Exists(path)) return false;
+                File.Delete(path);
+                return true;
+            }
+        }
+
+        /// <summary>
+        /// حذف النقاط الأقدم من الحد ثم الأقدم فيما يتجاوز العدد
+        /// </summary>
+        public int Prune()
+        {
+            if (_maxAge == null && _maxCount <= 0)
+                return 0;
+
+            int removed = 0;
+
+            lock (_ioLock)
+            {
+                var files = new DirectoryInfo(_directory)
+                    .EnumerateFiles("*.checkpoint")
+                    .OrderByDescending(f => f.LastWriteTimeUtc)
+                    .ToList();
+
+                var cutoff = _maxAge.HasValue ? DateTime.UtcNow - _maxAge.Value : DateTime.MinValue;
+
+                for (int i = 0; i < files.Count; i++)
+                {
+                    bool expired = files[i].LastWriteTimeUtc < cutoff;
+                    bool overCount = _maxCount > 0 && i >= _maxCount;
+                    if (!expired && !overCount)
+                        continue;
+
+                    try
+                    {
+                        files[i].Delete();
+                        removed++;
+                    }
+                    catch (IOException)
+                    {
+                        // يُعاد المحاولة في الدورة التالية
+                    }
+                }
+            }
+
+            return removed;
+        }
+
+        private string GetPath(Guid jobId) => Path.Combine(_directory, $"{jobId:N}.checkpoint");
+    }
+}
@@ -0,0 +1,421 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/ScanExecutor.cs
+// منفذ فحص مشترك بأولويات (فوري > يدوي > مجدول)
+// =====================================================
+
+using Microsoft.Extensions.Logging;
+using ShieldAI.Core.Configuration;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// فئة أولوية عمل الفحص
+    /// </summary>
+    public enum ScanPriorityClass
+    {
+        /// <summary>فحص فوري عند الوصول (RealTime)</summary>
+        Realtime = 0,
+        /// <summary>فحص يطلبه المستخدم</summary>
+        OnDemand = 1,
+        /// <summary>فحص مجدول في الخلفية</summary>
+        Scheduled = 2
+    }
+
+    /// <summary>
+    /// منفذ فحص مشترك لكل مصادر العمل.
+    /// كل عنصر عمل = ملف واحد، لذا يحدث الاستباق عند حدود الملفات:
+    /// الفحص الفوري يأخذ الخانة التالية المتاحة دون انتظار انتهاء فحص كامل.
+    /// التوزيع بين الفئات بـ Weighted Round Robin مع خانات محجوزة للفحص الفوري.
+    /// </summary>
+    public sealed class ScanExecutor : IDisposable
+    {
+        private static readonly Lazy<ScanExecutor> _shared = new(() => new ScanExecutor());
+
+        /// <summary>
+        /// المنفذ المشترك على مستوى العملية
+        /// </summary>
+        public static ScanExecutor Shared => _shared.Value;
+
+        private const int ClassCount = 3;
+
+        private readonly ILogger? _logger;
+        private readonly object _sync = new();
+        private readonly Queue<WorkItem>[] _queues;
+        private readonly int[] _weights;
+        private readonly int[] _currentWeights = new int[ClassCount];
+        private readonly int[] _running = new int[ClassCount];
+        private readonly long[] _completed = new long[ClassCount];
+        private readonly int _maxConcurrency;
+        private readonly int _reservedRealtimeSlots;
+        private bool _disposed;
+
+        /// <summary>
+        /// الحد الأقصى للأعمال المتزامنة
+        /// </summary>
+        public int MaxConcurrency => _maxConcurrency;
+
+        /// <summary>
+        /// عدد الخانات المحجوزة للفحص الفوري
+        /// </summary>
+        public int ReservedRealtimeSlots => _reservedRealtimeSlots;
+
+        /// <summary>
+        /// عدد الأعمال قيد التنفيذ
+        /// </summary>
+        public int RunningCount
+        {
+            get { lock (_sync) return _running.Sum(); }
+        }
+
+        public ScanExecutor(
+            int maxConcurrency = 0,
+            int reservedRealtimeSlots = -1,
+            int realtimeWeight = 0,
+            int onDemandWeight = 0,
+            int scheduledWeight = 0,
+            ILogger? logger = null)
+        {
+            var settings = ConfigManager.Instance.Settings;
+            _logger = logger;
+
+            _maxConcurrency = maxConcurrency > 0
+                ? maxConcurrency
+                : settings.ScanExecutorMaxConcurrency > 0
+                    ? settings.ScanExecutorMaxConcurrency
+                    : Math.Min(Environment.ProcessorCount, 4);
+
+            var reserved = reservedRealtimeSlots >= 0 ? reservedRealtimeSlots : settings.ScanExecutorReservedRealtimeSlots;
+            _reservedRealtimeSlots = Math.Clamp(reserved, 0, _maxConcurrency - 1);
+
+            _weights = new[]
+            {
+                Math.Max(1, realtimeWeight > 0 ? realtimeWeight : settings.ScanExecutorRealtimeWeight),
+                Math.Max(1, onDemandWeight > 0 ? onDemandWeight : settings.ScanExecutorOnDemandWeight),
+                Math.Max(1, scheduledWeight > 0 ? scheduledWeight : settings.ScanExecutorScheduledWeight)
+            };
+
+            _queues = new Queue<WorkItem>[ClassCount];
+            for (int i = 0; i < ClassCount; i++)
+                _queues[i] = new Queue<WorkItem>();
+
+            _logger?.LogInformation(
+                "تم تهيئة ScanExecutor: {Max} خانات ({Reserved} محجوزة للفوري)",
+                _maxConcurrency, _reservedRealtimeSlots);
+        }
+
+        /// <summary>
+        /// حصة فئة أولوية من خانات المنفذ لعمل يُنفذ خارجه (عمال الفحص الموزّع):
+        /// الفئات الخلفية لا تمس الخانات المحجوزة، والمجدول يأخذ نصيبه بالوزن مقابل الفحص عند الطلب
+        /// </summary>
+        public int GetClassBudget(ScanPriorityClass priority)
+        {
+            int background = _maxConcurrency - _reservedRealtimeSlots;
+
+            return priority switch
+            {
+                ScanPriorityClass.Realtime => _maxConcurrency,
+                ScanPriorityClass.OnDemand => background,
+                _ => Math.Max(1, background * _weights[(int)ScanPriorityClass.Scheduled] /
+                    (_weights[(int)ScanPriorityClass.OnDemand] + _weights[(int)ScanPriorityClass.Scheduled]))
+            };
+        }
+
+        /// <summary>
+        /// تنفيذ عمل فحص (ملف واحد) ضمن فئة أولوية
+        /// </summary>
+        public Task<T> RunAsync<T>(
+            ScanPriorityClass priority,
+            Func<CancellationToken, Task<T>> work,
+            CancellationToken ct = default)
+        {
+            ArgumentNullException.ThrowIfNull(work);
+
+            if (ct.IsCancellationRequested)
+                return Task.FromCanceled<T>(ct);
+
+            var tcs = new TaskCompletionSource<T>(TaskCreationOptions.RunContinuationsAsynchronously);
+            var item = new WorkItem(priority, ct, async () =>
+            {
+                try
+                {
+                    tcs.TrySetResult(await work(ct).ConfigureAwait(false));
+                }
+                catch (OperationCanceledException) when (ct.IsCancellationRequested)
+                {
+                    tcs.TrySetCanceled(ct);
+                }
+                catch (Exception ex)
+                {
+                    tcs.TrySetException(ex);
+                }
+            }, () => tcs.TrySetCanceled(ct));
+
+            lock (_sync)
+            {
+                if (_disposed)
+                    throw new ObjectDisposedException(nameof(ScanExecutor));
+
+                _queues[(int)priority].Enqueue(item);
+
+                // الإلغاء يزيل العنصر من الطابور فوراً - لا ينتظر حتى تصل إليه خانة
+                if (ct.CanBeCanceled)
+                    item.Registration = ct.Register(() => RemoveCancelled(item));
+
+                DispatchLocked();
+            }
+
+            return tcs.Task;
+        }
+
+        /// <summary>
+        /// تنفيذ عمل فحص بدون قيمة راجعة
+        /// </summary>
+        public Task RunAsync(
+            ScanPriorityClass priority,
+            Func<CancellationToken, Task> work,
+            CancellationToken ct = default)
+        {
+            return RunAsync<bool>(priority, async token =>
+            {
+                await work(token).ConfigureAwait(false);
+                return true;
+            }, ct);
+        }
+
+        /// <summary>
+        /// عدد الأعمال المنتظرة لفئة معينة
+        /// </summary>
+        public int GetQueuedCount(ScanPriorityClass priority)
+        {
+            lock (_sync) return _queues[(int)priority].Count;
+        }
+
+        /// <summary>
+        /// عدد الأعمال قيد التنفيذ لفئة معينة
+        /// </summary>
+        public int GetRunningCount(ScanPriorityClass priority)
+        {
+            lock (_sync) return _running[(int)priority];
+        }
+
+        /// <summary>
+        /// عدد الأعمال المكتملة لفئة معينة
+        /// </summary>
+        public long GetCompletedCount(ScanPriorityClass priority)
+        {
+            lock (_sync) return _completed[(int)priority];
+        }
+
+        /// <summary>
+        /// إزالة عمل أُلغي قبل أن يبدأ (لا شيء إذا كان قيد التنفيذ أو منتهياً)
+        /// </summary>
+        private void RemoveCancelled(WorkItem item)
+        {
+            lock (_sync)
+            {
+                var queue = _queues[(int)item.Priority];
+                int count = queue.Count;
+                bool found = false;
+
+                for (int i = 0; i < count; i++)
+                {
+                    var queued = queue.Dequeue();
+                    if (ReferenceEquals(queued, item))
+                        found = true;
+                    else
+                        queue.Enqueue(queued);
+                }
+
+                if (!found) return;
+            }
+
+            item.Cancel();
+        }
+
+        /// <summary>
+        /// توزيع الأعمال على الخانات الفارغة (يُستدعى داخل القفل)
+        /// </summary>
+        private void DispatchLocked()
+        {
+            while (_running.Sum() < _maxConcurrency)
+            {
+                var cls = SelectClassLocked();
+                if (cls < 0) return;
+
+                var item = _queues[cls].Dequeue();
+                item.Registration.Unregister();
+
+                // عمل أُلغي أثناء الانتظار لا يستهلك خانة
+                if (item.Token.IsCancellationRequested)
+                {
+                    item.Cancel();
+                    continue;
+                }
+
+                _running[cls]++;
+                _ = Task.Run(async () =>
+                {
+                    try
+                    {
+                        await item.Execute().ConfigureAwait(false);
+                    }
+                    finally
+                    {
+                        lock (_sync)
+                        {
+                            _running[cls]--;
+                            _completed[cls]++;
+                            if (!_disposed) DispatchLocked();
+                        }
+                    }
+                });
+            }
+        }
+
+        /// <summary>
+        /// اختيار الفئة التالية بـ Smooth Weighted Round Robin
+        /// </summary>
+        private int SelectClassLocked()
+        {
+            int backgroundRunning = _running[(int)ScanPriorityClass.OnDemand] +
+                                    _running[(int)ScanPriorityClass.Scheduled];
+            bool backgroundAllowed = backgroundRunning < _maxConcurrency - _reservedRealtimeSlots;
+
+            int totalWeight = 0;
+            int best = -1;
+
+            for (int i = 0; i < ClassCount; i++)
+            {
+                if (_queues[i].Count == 0) continue;
+                if (i != (int)ScanPriorityClass.Realtime && !backgroundAllowed) continue;
+
+                _currentWeights[i] += _weights[i];
+                totalWeight += _weights[i];
+
+                if (best < 0 || _currentWeights[i] > _currentWeights[best])
+                    best = i;
+            }
+
+            if (best >= 0)
+                _currentWeights[best] -= totalWeight;
+
+            return best;
+        }
+
+        public void Dispose()
+        {
+            List<WorkItem> pending;
+            lock (_sync)
+            {
+                if (_disposed) return;
+                _disposed = true;
+
+                pending = _queues.SelectMany(q => q).ToList();
+                foreach (var q in _queues) q.Clear();
+            }
+
+            foreach (var item in pending)
+            {
+                item.Registration.Unregister();
+                item.Cancel();
+            }
+        }
+
+        private sealed class WorkItem
+        {
+            private readonly Action _cancel;
+
+            public ScanPriorityClass Priority { get; }
+            public CancellationToken Token { get; }
+            public Func<Task> Execute { get; }
+            public CancellationTokenRegistration Registration { get; set; }
+
+            public WorkItem(ScanPriorityClass priority, CancellationToken token, Func<Task> execute, Action cancel)
+            {
+                Priority = priority;
+                Token = token;
+                Execute = execute;
+                _cancel = cancel;
+            }
+
+            public void Cancel() => _cancel();
+        }
+    }
+
+    /// <summary>
+    /// نافذة إرسال لمُرسِل جماعي (فحص كامل/يدوي): تحد الأعمال المُرسلة غير المكتملة
+    /// بضعف سعة المنفذ، فلا يمتلئ الطابور بعنصر لكل ملف ويبقى الإلغاء والتقييد فوريين.
+    /// </summary>
+    public sealed class ScanSubmissionWindow
+    {
+        private readonly SemaphoreSlim _slots;
+
+        public int Capacity { get; }
+
+        public ScanSubmissionWindow(ScanExecutor executor, int capacity = 0)
+        {
+            Capacity = capacity > 0 ? capacity : executor.MaxConcurrency * 2;
+            _slots = new SemaphoreSlim(Capacity, Capacity);
+        }
+
+        /// <summary>
+        /// نافذة لفحص مقيد: مع نسبة CPU أقل من 100% كل خانة تمثل عاملاً واحداً
+        /// (فحص ثم راحة)، فلا تملأ الخانات الإضافية وقت الراحة بعمل آخر.
+        /// </summary>
+        public ScanSubmissionWindow(ScanExecutor executor, ScanThrottle? throttle)
+            : this(executor, throttle?.LimitsDutyCycle == true ? executor.MaxConcurrency : 0)
+        {
+        }
+
+        /// <summary>
+        /// عدد الأعمال المُرسلة التي لم تكتمل بعد
+        /// </summary>
+        public int InFlight => Capacity - _slots.CurrentCount;
+
+        /// <summary>
+        /// انتظار خانة ثم الإرسال - الخانة تُحرر عند اكتمال المهمة (نجاحاً أو فشلاً أو إلغاءً)
+        /// </summary>
+        public async Task<Task<T>> SubmitAsync<T>(Func<Task<T>> submit, CancellationToken ct = default)
+        {
+            await _slots.WaitAsync(ct).ConfigureAwait(false);
+
+            Task<T> task;
+            try
+            {
+                task = submit();
+            }
+            catch
+            {
+                _slots.Release();
+                throw;
+            }
+
+            return ReleaseWhenDoneAsync(task);
+        }
+
+        /// <summary>
+        /// إرسال عمل بدون قيمة راجعة
+        /// </summary>
+        public async Task<Task> SubmitAsync(Func<Task> submit, CancellationToken ct = default)
+        {
+            return await SubmitAsync(async () =>
+            {
+                await submit().ConfigureAwait(false);
+                return true;
+            }, ct).ConfigureAwait(false);
+        }
+
+        private async Task<T> ReleaseWhenDoneAsync<T>(Task<T> task)
+        {
+            try
+            {
+                return await task.ConfigureAwait(false);
+            }
+            finally
+            {
+                _slots.Release();
+            }
+        }
+    }
+}
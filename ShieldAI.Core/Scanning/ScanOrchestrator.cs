@@ -9,7 +9,6 @@ using Microsoft.Extensions.Logging;
 using ShieldAI.Core.Configuration;
 using ShieldAI.Core.Detection;
 using ShieldAI.Core.Detection.ThreatScoring;
-using ShieldAI.Core.ML;
 
 // استخدام Types من Models مع alias لتجنب التضارب
 using ScanType = ShieldAI.Core.Models.ScanType;
@@ -27,12 +26,16 @@ namespace ShieldAI.Core.Scanning
         private readonly ILogger? _logger;
         private readonly AppSettings _settings;
         private readonly FileEnumerator _fileEnumerator;
-        private readonly DeepAnalyzer _deepAnalyzer;
-        private readonly SemaphoreSlim _scanSemaphore;
+        private readonly VirusTotalClient? _vtClient;
+        private readonly ScanExecutor _executor;
+        private readonly ScanCheckpointStore? _checkpointStore;
         private readonly ScanCache? _scanCache;
         private readonly ThreatAggregator _aggregator;
+        private readonly ArchiveScanner _archiveScanner;
         private readonly ConcurrentDictionary<Guid, Models.ScanJob> _activeJobs = new();
         private readonly ConcurrentDictionary<Guid, CancellationTokenSource> _cancellationTokens = new();
+        private readonly ConcurrentDictionary<Guid, ScanProgressPublisher> _progressPublishers = new();
+        private readonly ConcurrentDictionary<Guid, byte> _userStopped = new();
         
         private bool _disposed;
 
@@ -41,29 +44,44 @@ namespace ShieldAI.Core.Scanning
         public event EventHandler<Models.ThreatDetectedEventArgs>? ThreatDetected;
         public event EventHandler<Models.ScanCompletedEventArgs>? ScanCompleted;
 
-        public ScanOrchestrator(ILogger? logger = null, string? virusTotalApiKey = null)
+        public ScanOrchestrator(ILogger? logger = null, string? virusTotalApiKey = null, ScanExecutor? executor = null)
         {
             _logger = logger;
             _settings = ConfigManager.Instance.Settings;
             _fileEnumerator = new FileEnumerator(logger);
-            _deepAnalyzer = new DeepAnalyzer(virusTotalApiKey);
+            if (!string.IsNullOrWhiteSpace(virusTotalApiKey))
+                _vtClient = new VirusTotalClient(virusTotalApiKey);
 
             // ScanCache
             if (_settings.EnableScanCache)
             {
                 _scanCache = new ScanCache(
                     TimeSpan.FromMinutes(_settings.ScanCacheTtlMinutes),
-                    _settings.ScanCacheMaxEntries);
+                    _settings.ScanCacheMaxEntries,
+                    _settings.ScanCacheMaxMegabytes * 1024L * 1024L);
             }
 
             // ThreatAggregator
             _aggregator = ThreatAggregator.CreateDefault(scanCache: _scanCache);
+            _archiveScanner = new ArchiveScanner(_aggregator, ArchiveScanLimits.FromSettings(_settings), logger);
             
-            // عدد الـ Threads للفحص المتوازي
-            int maxParallelism = Math.Min(Environment.ProcessorCount, 4);
-            _scanSemaphore = new SemaphoreSlim(maxParallelism, maxParallelism);
+            // المنفذ المشترك مع الفحص الفوري والمجدول
+            _executor = executor ?? ScanExecutor.Shared;
+
+            // نقاط الاستئناف
+            if (_settings.EnableScanCheckpoints)
+            {
+                try
+                {
+                    _checkpointStore = ScanCheckpointStore.FromSettings(_settings);
+                }
+                catch (Exception ex)
+                {
+                    _logger?.LogWarning("تعذر تهيئة مخزن نقاط الاستئناف: {Error}", ex.Message);
+                }
+            }
             
-            _logger?.LogInformation("تم تهيئة ScanOrchestrator مع {MaxParallelism} threads", maxParallelism);
+            _logger?.LogInformation("تم تهيئة ScanOrchestrator مع {MaxParallelism} threads", _executor.MaxConcurrency);
         }
 
         /// <summary>
@@ -74,7 +92,8 @@ namespace ShieldAI.Core.Scanning
             ScanType scanType = ScanType.Custom,
             bool useVirusTotal = false,
             bool deepScan = true,
-            CancellationToken externalToken = default)
+            CancellationToken externalToken = default,
+            ScanPriorityClass priority = ScanPriorityClass.OnDemand)
         {
             var job = new Models.ScanJob
             {
@@ -85,16 +104,112 @@ namespace ShieldAI.Core.Scanning
                 Status = ScanStatus.Pending
             };
 
-            return await ExecuteScanJobAsync(job, externalToken);
+            return await ExecuteScanJobAsync(job, externalToken, priority);
+        }
+
+        /// <summary>
+        /// بدء فحص حسب ملف تعريف (يشمل حدود التقييد)
+        /// </summary>
+        public Task<Models.ScanReport> StartScanAsync(
+            ScanProfile profile,
+            CancellationToken externalToken = default,
+            ScanPriorityClass priority = ScanPriorityClass.OnDemand)
+        {
+            var job = new Models.ScanJob
+            {
+                Paths = profile.TargetPaths.ToList(),
+                Type = profile.Type,
+                DeepScan = profile.DeepScan,
+                ScanArchives = profile.ScanArchives,
+                ScanHiddenFiles = profile.ScanHiddenFiles,
+                MaxDepth = profile.MaxDepth,
+                Status = ScanStatus.Pending
+            };
+
+            return ExecuteScanJobAsync(job, null, profile.GetThrottleOptions(), externalToken, priority);
         }
 
         /// <summary>
         /// تنفيذ مهمة فحص
         /// </summary>
-        public async Task<Models.ScanReport> ExecuteScanJobAsync(Models.ScanJob job, CancellationToken externalToken = default)
+        public Task<Models.ScanReport> ExecuteScanJobAsync(
+            Models.ScanJob job,
+            CancellationToken externalToken = default,
+            ScanPriorityClass priority = ScanPriorityClass.OnDemand)
+        {
+            return ExecuteScanJobAsync(job, null, null, externalToken, priority);
+        }
+
+        /// <summary>
+        /// استئناف فحص منقطع من آخر نقطة محفوظة
+        /// </summary>
+        public async Task<Models.ScanReport?> ResumeScanAsync(Guid jobId, CancellationToken externalToken = default)
+        {
+            if (_activeJobs.ContainsKey(jobId))
+                throw new InvalidOperationException("الفحص قيد التنفيذ بالفعل");
+
+            var checkpoint = _checkpointStore?.TryLoad(jobId);
+            if (checkpoint == null || checkpoint.Shards != null)
+            {
+                _logger?.LogWarning("لا توجد نقطة استئناف للفحص: {JobId}", jobId);
+                return null;
+            }
+
+            var job = new Models.ScanJob
+            {
+                Id = checkpoint.JobId,
+                Paths = checkpoint.Paths,
+                Type = checkpoint.Type,
+                UseVirusTotal = checkpoint.UseVirusTotal,
+                DeepScan = checkpoint.DeepScan,
+                ScanArchives = checkpoint.ScanArchives,
+                ScanHiddenFiles = checkpoint.ScanHiddenFiles,
+                MaxDepth = checkpoint.MaxDepth,
+                Status = ScanStatus.Pending
+            };
+
+            _logger?.LogInformation("استئناف الفحص: {JobId} من {Percent:F1}%", jobId, checkpoint.ProgressPercent);
+
+            return await ExecuteScanJobAsync(job, checkpoint, checkpoint.Throttle, externalToken, checkpoint.Priority);
+        }
+
+        /// <summary>
+        /// الفحوصات المنقطعة القابلة للاستئناف
+        /// </summary>
+        public IReadOnlyList<ScanCheckpoint> GetResumableScans()
+        {
+            if (_checkpointStore == null)
+                return Array.Empty<ScanCheckpoint>();
+
+            // نقاط الفحص الموزّع يستأنفها ShardCoordinator
+            return _checkpointStore.GetAll()
+                .Where(c => c.Shards == null && !_activeJobs.ContainsKey(c.JobId))
+                .ToList();
+        }
+
+        /// <summary>
+        /// تجاهل نقطة استئناف (لن يمكن استئناف الفحص)
+        /// </summary>
+        public bool DiscardCheckpoint(Guid jobId)
+        {
+            return _checkpointStore?.Delete(jobId) ?? false;
+        }
+
+        private async Task<Models.ScanReport> ExecuteScanJobAsync(
+            Models.ScanJob job,
+            ScanCheckpoint? resumeFrom,
+            ScanThrottleOptions? throttleOptions,
+            CancellationToken externalToken,
+            ScanPriorityClass priority)
         {
+            var throttle = ScanThrottle.Create(throttleOptions, _executor);
+
             var cts = CancellationTokenSource.CreateLinkedTokenSource(externalToken);
             _cancellationTokens[job.Id] = cts;
+            _progressPublishers[job.Id] = new ScanProgressPublisher(
+                job,
+                args => ScanProgress?.Invoke(this, args),
+                TimeSpan.FromMilliseconds(_settings.ScanProgressIntervalMs));
             _activeJobs[job.Id] = job;
 
             var report = new Models.ScanReport
@@ -111,45 +226,109 @@ namespace ShieldAI.Core.Scanning
                 
                 _logger?.LogInformation("بدء الفحص: {JobId} - النوع: {Type}", job.Id, job.Type);
 
-                // جمع الملفات
-                var files = new List<FileInfo>();
-                foreach (var path in job.Paths)
+                // نقطة الاستئناف: ترتيب ثابت + تخطي ما اكتمل سابقاً
+                bool useCheckpoint = _checkpointStore != null &&
+                    (resumeFrom != null ||
+                     job.Type == ScanType.Full ||
+                     _fileEnumerator.EstimateFileCount(job.Paths) >= _settings.ScanCheckpointMinFiles);
+
+                // الملفات تُعدّ تدفقياً: الفحص يبدأ مع أول ملف دون قائمة كاملة في الذاكرة
+                var files = useCheckpoint
+                    ? _fileEnumerator.EnumerateFilesOrdered(job.Paths, job.MaxDepth, job.ScanHiddenFiles)
+                    : job.Paths.SelectMany(path => _fileEnumerator.EnumerateFiles(
+                        path, recursive: true, maxDepth: job.MaxDepth, includeHidden: job.ScanHiddenFiles));
+
+                HashSet<string>? resumedAhead = null;
+                if (resumeFrom != null)
                 {
-                    files.AddRange(_fileEnumerator.EnumerateFiles(path, recursive: true));
+                    resumedAhead = new HashSet<string>(resumeFrom.CompletedAhead, StringComparer.Ordinal);
+                    job.ThreatsFound = resumeFrom.ThreatsFound;
+                    job.ErrorCount = resumeFrom.ErrorCount;
+                    job.TotalFiles = resumeFrom.TotalFiles;
+                    report.ThreatsFound = resumeFrom.ThreatsFound;
                 }
 
-                job.TotalFiles = files.Count;
-                report.TotalFiles = files.Count;
-                
-                _logger?.LogInformation("عدد الملفات للفحص: {Count}", files.Count);
-                RaiseProgress(job);
+                RaiseProgress(job, immediate: true);
+
+                var cursor = useCheckpoint ? new ScanCursor() : null;
+                using var checkpointCts = CancellationTokenSource.CreateLinkedTokenSource(cts.Token);
+                var checkpointTask = cursor != null
+                    ? RunCheckpointLoopAsync(job, cursor, resumeFrom, throttleOptions, priority, checkpointCts.Token)
+                    : Task.CompletedTask;
 
-                // فحص الملفات بالتوازي
+                // فحص الملفات بالتوازي عبر المنفذ المشترك (ملف = عنصر عمل)
+                // النافذة تحد المُرسل غير المكتمل - لا يُدفع كل الملفات إلى طابور المنفذ دفعة واحدة
+                var window = new ScanSubmissionWindow(_executor, throttle);
                 var tasks = new List<Task<Models.ScanResult>>();
-                
-                foreach (var file in files)
-                {
-                    if (cts.Token.IsCancellationRequested)
-                        break;
+                int discovered = 0;
+                int skipped = 0;
 
-                    await _scanSemaphore.WaitAsync(cts.Token);
-                    
-                    tasks.Add(Task.Run(async () =>
+                try
+                {
+                    foreach (var file in files)
                     {
+                        if (cts.Token.IsCancellationRequested)
+                            break;
+
+                        // الإجمالي يتقدم مع التعداد (تقدير الجلسة السابقة حتى يتجاوزه)
+                        discovered++;
+                        if (discovered > job.TotalFiles)
+                            job.TotalFiles = discovered;
+
+                        if (resumeFrom != null && resumeFrom.IsCompleted(file.FullName, resumedAhead))
+                        {
+                            skipped++;
+                            job.IncrementScannedFiles();
+                            continue;
+                        }
+
+                        var index = tasks.Count;
+
                         try
                         {
-                            return await ScanFileAsync(job, file, cts.Token);
+                            // التقييد يضبط وتيرة الإدخال بدلاً من حجز خانات المنفذ
+                            if (throttle != null)
+                                await throttle.BeforeFileAsync(file.Length, cts.Token);
+
+                            tasks.Add(await window.SubmitAsync(
+                                () => ScanFileThrottledAsync(job, file, index, cursor, throttle, priority, cts.Token),
+                                cts.Token));
                         }
-                        finally
+                        catch (OperationCanceledException) when (cts.Token.IsCancellationRequested)
                         {
-                            _scanSemaphore.Release();
+                            break;
                         }
-                    }, cts.Token));
+                    }
                 }
+                finally
+                {
+                    // كل ما أُرسل ينتهي (اكتمالاً أو إلغاءً) قبل حفظ نقطة الاستئناف وتفكيك المهمة
+                    await WaitSubmittedAsync(tasks);
+
+                    checkpointCts.Cancel();
+                    await checkpointTask;
+
+                    // نقطة الاستئناف تبقى لإيقاف الخدمة فقط - إيقاف المستخدم ينهي الفحص نهائياً
+                    if (cursor != null)
+                    {
+                        if (cts.Token.IsCancellationRequested && !_userStopped.ContainsKey(job.Id))
+                            SaveCheckpoint(job, cursor, resumeFrom, throttleOptions, priority);
+                        else
+                            _checkpointStore!.Delete(job.Id);
+                    }
+                }
+
+                if (!cts.Token.IsCancellationRequested)
+                    job.TotalFiles = discovered;
+                report.TotalFiles = job.TotalFiles;
+
+                _logger?.LogInformation("عدد الملفات للفحص: {Count} (تخطي {Skipped} مكتمل من الجلسة السابقة)",
+                    discovered, skipped);
+
+                // أخطاء غير الإلغاء تُفشل المهمة كما كانت؛ الملفات الملغاة لا نتيجة لها
+                await Task.WhenAll(tasks.Where(t => !t.IsCanceled));
+                var results = tasks.Where(t => t.IsCompletedSuccessfully).Select(t => t.Result).ToArray();
 
-                // جمع النتائج
-                var results = await Task.WhenAll(tasks);
-                
                 foreach (var result in results.Where(r => r != null))
                 {
                     report.Results.Add(result);
@@ -168,7 +347,7 @@ namespace ShieldAI.Core.Scanning
                     }
                 }
 
-                report.ScannedFiles = results.Length;
+                report.ScannedFiles = results.Length + skipped;
                 job.Status = cts.Token.IsCancellationRequested 
                     ? ScanStatus.Cancelled 
                     : ScanStatus.Completed;
@@ -191,8 +370,16 @@ namespace ShieldAI.Core.Scanning
                 report.FinalStatus = job.Status;
                 
                 _activeJobs.TryRemove(job.Id, out _);
+                _userStopped.TryRemove(job.Id, out _);
                 _cancellationTokens.TryRemove(job.Id, out var removedCts);
                 removedCts?.Dispose();
+
+                // لقطة أخيرة بالحالة النهائية
+                if (_progressPublishers.TryRemove(job.Id, out var publisher))
+                {
+                    publisher.Dispose();
+                    publisher.PublishNow();
+                }
                 
                 ScanCompleted?.Invoke(this, new Models.ScanCompletedEventArgs { Report = report });
                 
@@ -227,42 +414,35 @@ namespace ShieldAI.Core.Scanning
                 result.SHA256 = sha256;
                 result.MD5 = md5;
 
-                // التحليل العميق
-                if (job.DeepScan)
+                // كل الملفات عبر المجمّع مع الكاش بالبصمة المحسوبة أعلاه
+                // (يشمل الفحص العميق: نفس المحركات، والملف المفحوص سابقاً لا يُعاد تحليله)
+                var context = _aggregator.BuildContext(file.FullName, sha256);
+                context.Md5Hash = md5;
+                var aggregated = await _aggregator.ScanAsync(context, ct);
+                ApplyAggregatedResult(result, aggregated);
+
+                // الفحص العميق يضيف رأي VirusTotal فقط - مجدول بالخطورة ومخزّن بالبصمة
+                if (job.DeepScan && job.UseVirusTotal && _vtClient != null)
                 {
-                    var analysisResult = await _deepAnalyzer.AnalyzeAsync(
-                        file.FullName, 
-                        useVirusTotal: job.UseVirusTotal,
-                        cancellationToken: ct);
-
-                    // Map from AnalysisVerdict to ScanVerdict
-                    result.Verdict = MapVerdict(analysisResult.Verdict);
-                    result.RiskScore = analysisResult.OverallRiskScore;
-                    result.Confidence = analysisResult.OverallConfidence;
-                    result.ThreatName = analysisResult.DetectedNames.FirstOrDefault() ?? analysisResult.Summary;
-
-                    // Copy findings
-                    foreach (var finding in analysisResult.Findings)
-                    {
-                        result.Findings.Add(new Models.DetectionFinding
-                        {
-                            Source = finding.Source,
-                            Type = finding.Type.ToString(),
-                            Title = finding.Title,
-                            Description = finding.Description,
-                            Severity = MapSeverity(finding.Severity),
-                            Confidence = finding.Confidence
-                        });
-                    }
+                    var vtResult = await _vtClient.ScanFileAsync(
+                        file.FullName, sha256, (int)Math.Clamp(result.RiskScore, 0, 100), ct);
+                    ApplyVirusTotalResult(result, vtResult);
+                }
+
+                // فحص محتوى الأرشيف من الذاكرة
+                if (job.ScanArchives && ArchiveScanner.DetectFormat(file.FullName) != ArchiveFormat.None)
+                {
+                    var archiveResult = await _archiveScanner.ScanAsync(file.FullName, ct);
+                    MergeArchiveResult(result, archiveResult);
                 }
 
                 // تحديث الإحصائيات
-                job.ScannedFiles++;
+                job.IncrementScannedFiles();
                 job.CurrentFile = file.Name;
                 
                 if (result.IsThreat)
                 {
-                    job.ThreatsFound++;
+                    job.IncrementThreatsFound();
                     
                     // إرسال حدث اكتشاف تهديد
                     ThreatDetected?.Invoke(this, new Models.ThreatDetectedEventArgs
@@ -284,7 +464,7 @@ namespace ShieldAI.Core.Scanning
             {
                 result.Verdict = ScanVerdict.Error;
                 result.ErrorMessage = ex.Message;
-                job.ErrorCount++;
+                job.IncrementErrorCount();
                 _logger?.LogDebug("خطأ في فحص الملف: {File} - {Error}", file.FullName, ex.Message);
             }
             finally
@@ -297,29 +477,43 @@ namespace ShieldAI.Core.Scanning
         }
 
         /// <summary>
-        /// إيقاف فحص
+        /// إيقاف فحص بطلب المستخدم (تُحذف نقطة استئنافه)
         /// </summary>
         public void StopScan(Guid jobId)
         {
             if (_cancellationTokens.TryGetValue(jobId, out var cts))
             {
+                _userStopped[jobId] = 0;
                 cts.Cancel();
                 _logger?.LogInformation("تم طلب إيقاف الفحص: {JobId}", jobId);
             }
         }
 
         /// <summary>
-        /// إيقاف جميع عمليات الفحص
+        /// إيقاف جميع عمليات الفحص بطلب المستخدم
         /// </summary>
         public void StopAllScans()
         {
-            foreach (var cts in _cancellationTokens.Values)
+            foreach (var (jobId, cts) in _cancellationTokens)
             {
+                _userStopped[jobId] = 0;
                 cts.Cancel();
             }
             _logger?.LogInformation("تم إيقاف جميع عمليات الفحص");
         }
 
+        /// <summary>
+        /// تعليق جميع عمليات الفحص لإيقاف الخدمة - نقاط الاستئناف تُحفظ
+        /// </summary>
+        public void SuspendAllScans()
+        {
+            foreach (var cts in _cancellationTokens.Values)
+            {
+                cts.Cancel();
+            }
+            _logger?.LogInformation("تم تعليق جميع عمليات الفحص مع حفظ نقاط الاستئناف");
+        }
+
         /// <summary>
         /// الحصول على حالة الفحص
         /// </summary>
@@ -336,55 +530,278 @@ namespace ShieldAI.Core.Scanning
             return _activeJobs.Values.ToList();
         }
 
-        private void RaiseProgress(Models.ScanJob job)
+        /// <summary>
+        /// انتظار الفحوص المُرسلة دون رمي - النتائج والأخطاء تُقرأ من المهام بعدها
+        /// </summary>
+        private static async Task WaitSubmittedAsync(List<Task<Models.ScanResult>> tasks)
         {
-            ScanProgress?.Invoke(this, new Models.ScanProgressEventArgs
+            try
             {
-                JobId = job.Id,
-                TotalFiles = job.TotalFiles,
-                ScannedFiles = job.ScannedFiles,
-                ThreatsFound = job.ThreatsFound,
-                CurrentFile = job.CurrentFile,
-                ProgressPercent = job.ProgressPercent,
-                Status = job.Status
-            });
+                await Task.WhenAll(tasks).ConfigureAwait(false);
+            }
+            catch
+            {
+                // تُرصد لاحقاً من حالة كل مهمة
+            }
+        }
+
+        /// <summary>
+        /// فحص ملف عبر المنفذ ثم راحة CPU خارجه (لا تحجز خانة عن الفحص الفوري).
+        /// الراحة جزء من المهمة المُرسلة فتحجز خانة نافذة الإرسال حتى تنتهي.
+        /// </summary>
+        private async Task<Models.ScanResult> ScanFileThrottledAsync(
+            Models.ScanJob job,
+            FileInfo file,
+            int index,
+            ScanCursor? cursor,
+            ScanThrottle? throttle,
+            ScanPriorityClass priority,
+            CancellationToken ct)
+        {
+            var result = await _executor.RunAsync(priority, token => ScanFileAsync(job, file, token), ct);
+            cursor?.MarkCompleted(index, file.FullName);
+
+            if (throttle != null)
+                await throttle.AfterFileAsync(result.Duration, ct);
+
+            return result;
+        }
+
+        /// <summary>
+        /// حفظ نقطة الاستئناف دورياً أثناء الفحص
+        /// </summary>
+        private async Task RunCheckpointLoopAsync(
+            Models.ScanJob job,
+            ScanCursor cursor,
+            ScanCheckpoint? resumeFrom,
+            ScanThrottleOptions? throttleOptions,
+            ScanPriorityClass priority,
+            CancellationToken ct)
+        {
+            var interval = TimeSpan.FromSeconds(Math.Max(5, _settings.ScanCheckpointIntervalSeconds));
+            using var timer = new PeriodicTimer(interval);
+
+            try
+            {
+                while (await timer.WaitForNextTickAsync(ct))
+                {
+                    SaveCheckpoint(job, cursor, resumeFrom, throttleOptions, priority);
+                }
+            }
+            catch (OperationCanceledException) { }
         }
 
-        private static ScanVerdict MapVerdict(AnalysisVerdict verdict)
+        private void SaveCheckpoint(
+            Models.ScanJob job,
+            ScanCursor cursor,
+            ScanCheckpoint? resumeFrom,
+            ScanThrottleOptions? throttleOptions,
+            ScanPriorityClass priority)
         {
-            return verdict switch
+            try
             {
-                AnalysisVerdict.Clean => ScanVerdict.Clean,
-                AnalysisVerdict.Suspicious => ScanVerdict.Suspicious,
-                AnalysisVerdict.Malicious => ScanVerdict.Malicious,
-                AnalysisVerdict.PotentiallyUnwanted => ScanVerdict.PotentiallyUnwanted,
-                _ => ScanVerdict.Unknown
+                var (cursorPath, completedAhead) = cursor.SnapshotPaths();
+
+                // الملفات تُعدّ مرتبة، لذا آخر ملف متصل يغطي كل ما قبله
+                // بما فيها ما تخطيناه من الجلسة السابقة
+                string? lowWaterPath = cursorPath ?? resumeFrom?.LowWaterPath;
+
+                if (resumeFrom != null)
+                {
+                    completedAhead.AddRange(resumeFrom.CompletedAhead
+                        .Where(p => lowWaterPath == null || string.CompareOrdinal(p, lowWaterPath) > 0));
+                }
+
+                _checkpointStore!.Save(new ScanCheckpoint
+                {
+                    JobId = job.Id,
+                    Paths = job.Paths,
+                    Type = job.Type,
+                    UseVirusTotal = job.UseVirusTotal,
+                    DeepScan = job.DeepScan,
+                    ScanArchives = job.ScanArchives,
+                    ScanHiddenFiles = job.ScanHiddenFiles,
+                    MaxDepth = job.MaxDepth,
+                    Priority = priority,
+                    Throttle = throttleOptions,
+                    StartedAt = resumeFrom?.StartedAt ?? job.StartedAt ?? DateTime.Now,
+                    TotalFiles = job.TotalFiles,
+                    ScannedFiles = job.ScannedFiles,
+                    ThreatsFound = job.ThreatsFound,
+                    ErrorCount = job.ErrorCount,
+                    LowWaterPath = lowWaterPath,
+                    CompletedAhead = completedAhead
+                });
+            }
+            catch (Exception ex)
+            {
+                _logger?.LogDebug("فشل حفظ نقطة الاستئناف: {JobId} - {Error}", job.Id, ex.Message);
+            }
+        }
+
+        /// <summary>
+        /// تسجيل تقدم - يُنشر بمعدل ثابت عبر ScanProgressPublisher
+        /// </summary>
+        private void RaiseProgress(Models.ScanJob job, bool immediate = false)
+        {
+            if (!_progressPublishers.TryGetValue(job.Id, out var publisher))
+                return;
+
+            if (immediate)
+                publisher.PublishNow();
+            else
+                publisher.MarkDirty();
+        }
+
+        /// <summary>
+        /// تحويل نتيجة المجمّع إلى نتيجة فحص
+        /// </summary>
+        private static void ApplyAggregatedResult(Models.ScanResult result, AggregatedThreatResult aggregated)
+        {
+            result.Verdict = aggregated.Verdict switch
+            {
+                AggregatedVerdict.Block or AggregatedVerdict.Quarantine => ScanVerdict.Malicious,
+                AggregatedVerdict.NeedsReview => ScanVerdict.Suspicious,
+                _ => ScanVerdict.Clean
             };
+            result.RiskScore = aggregated.RiskScore;
+            result.Confidence = aggregated.EngineResults
+                .Where(r => !r.HasError && r.Verdict != EngineVerdict.Clean)
+                .Select(r => r.Confidence * 100)
+                .DefaultIfEmpty(0)
+                .Max();
+
+            if (result.IsThreat)
+                result.ThreatName = aggregated.Reasons.FirstOrDefault();
+
+            foreach (var engine in aggregated.EngineResults.Where(r => !r.HasError && r.Verdict != EngineVerdict.Clean))
+            {
+                result.Findings.Add(new Models.DetectionFinding
+                {
+                    Source = engine.EngineName,
+                    Type = engine.Verdict.ToString(),
+                    Title = engine.Reasons.FirstOrDefault() ?? engine.EngineName,
+                    Description = string.Join("; ", engine.Reasons),
+                    Severity = engine.Verdict == EngineVerdict.Malicious ? ThreatLevel.High : ThreatLevel.Medium,
+                    Confidence = (int)(engine.Confidence * 100)
+                });
+            }
         }
 
-        private static ThreatLevel MapSeverity(Detection.ThreatLevel severity)
+        /// <summary>
+        /// دمج رأي VirusTotal في نتيجة الملف (رفع الحكم فقط)
+        /// </summary>
+        private static void ApplyVirusTotalResult(Models.ScanResult result, VTScanResult vtResult)
         {
-            return severity switch
+            if (vtResult.HasError || !vtResult.IsThreat)
+                return;
+
+            var verdict = vtResult.Malicious > 5 ? ScanVerdict.Malicious : ScanVerdict.Suspicious;
+            if (verdict == ScanVerdict.Malicious || !result.IsThreat)
+            {
+                result.Verdict = verdict;
+                result.ThreatName = vtResult.Detections.FirstOrDefault() is { } detection
+                    ? $"{detection.EngineName}: {detection.Result}"
+                    : $"VirusTotal: {vtResult.Malicious}/{vtResult.TotalEngines}";
+            }
+
+            result.RiskScore = Math.Max(result.RiskScore, Math.Min(100, vtResult.DetectionRate * 2));
+            result.Findings.Add(new Models.DetectionFinding
             {
-                Detection.ThreatLevel.Critical => ThreatLevel.Critical,
-                Detection.ThreatLevel.High => ThreatLevel.High,
-                Detection.ThreatLevel.Medium => ThreatLevel.Medium,
-                Detection.ThreatLevel.Low => ThreatLevel.Low,
-                _ => ThreatLevel.Low
+                Source = "VirusTotal",
+                Type = "MultiEngineDetection",
+                Title = $"اكتشاف من {vtResult.Malicious} محرك",
+                Description = $"تم اكتشافه من {vtResult.Malicious}/{vtResult.TotalEngines} محرك antivirus",
+                Severity = vtResult.Malicious > 10 ? ThreatLevel.Critical :
+                           vtResult.Malicious > 5 ? ThreatLevel.High : ThreatLevel.Medium,
+                Confidence = (int)vtResult.DetectionRate
+            });
+        }
+
+        /// <summary>
+        /// دمج نتائج عناصر الأرشيف في نتيجة الملف (رفع الحكم فقط)
+        /// </summary>
+        private static void MergeArchiveResult(Models.ScanResult result, ArchiveScanResult archive)
+        {
+            foreach (var entry in archive.Entries.Where(e => e.Result.Verdict != AggregatedVerdict.Allow))
+            {
+                result.Findings.Add(new Models.DetectionFinding
+                {
+                    Source = "Archive",
+                    Type = entry.Result.Verdict.ToString(),
+                    Title = entry.EntryPath,
+                    Description = string.Join("; ", entry.Result.Reasons.Take(3)),
+                    Severity = entry.Result.Verdict == AggregatedVerdict.NeedsReview ? ThreatLevel.Medium : ThreatLevel.High,
+                    Confidence = entry.Result.RiskScore
+                });
+            }
+
+            if (archive.BombDetected)
+            {
+                result.Findings.Add(new Models.DetectionFinding
+                {
+                    Source = "Archive",
+                    Type = "ArchiveBomb",
+                    Title = "قنبلة ضغط محتملة",
+                    Description = archive.LimitReason ?? "",
+                    Severity = ThreatLevel.Medium,
+                    Confidence = 90
+                });
+            }
+
+            // عنصر لم يُفحص لا يُعامل كنظيف
+            foreach (var unscanned in archive.UnscannedEntries)
+            {
+                result.Findings.Add(new Models.DetectionFinding
+                {
+                    Source = "Archive",
+                    Type = "ArchiveUnscanned",
+                    Title = unscanned.EntryPath,
+                    Description = unscanned.Reason,
+                    Severity = ThreatLevel.Medium,
+                    Confidence = 50
+                });
+            }
+
+            var worst = archive.WorstEntry;
+            var verdict = worst?.Result.Verdict switch
+            {
+                AggregatedVerdict.Block or AggregatedVerdict.Quarantine => ScanVerdict.Malicious,
+                AggregatedVerdict.NeedsReview => ScanVerdict.Suspicious,
+                _ => archive.BombDetected || archive.HasUnscannedContent ? ScanVerdict.Suspicious : ScanVerdict.Clean
             };
+
+            if (verdict == ScanVerdict.Clean)
+                return;
+
+            if (verdict == ScanVerdict.Malicious || !result.IsThreat)
+            {
+                result.Verdict = verdict;
+                result.ThreatName = worst != null
+                    ? $"{worst.EntryPath}: {worst.Result.Reasons.FirstOrDefault() ?? worst.Result.Verdict.ToString()}"
+                    : archive.BombDetected ? "Archive.Bomb" : "Archive.Unscanned";
+            }
+
+            result.RiskScore = Math.Max(result.RiskScore, worst?.Result.RiskScore ?? 60);
         }
 
         public void Dispose()
         {
             if (_disposed) return;
             
-            StopAllScans();
-            _scanSemaphore.Dispose();
+            SuspendAllScans();
             
             foreach (var cts in _cancellationTokens.Values)
             {
                 cts.Dispose();
             }
+
+            foreach (var publisher in _progressPublishers.Values)
+            {
+                publisher.Dispose();
+            }
+
+            _vtClient?.Dispose();
             
             _disposed = true;
         }
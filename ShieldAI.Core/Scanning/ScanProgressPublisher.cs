@@ -0,0 +1,96 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/ScanProgressPublisher.cs
+// ناشر التقدم بمعدل ثابت بدلاً من حدث لكل ملف
+// =====================================================
+
+using ShieldAI.Core.Models;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// ناشر تقدم الفحص - يجمع التحديثات وينشر لقطة واحدة كل فترة.
+    /// العمال يستدعون MarkDirty فقط (بدون تخصيص ذاكرة أو أقفال).
+    /// </summary>
+    public sealed class ScanProgressPublisher : IDisposable
+    {
+        private readonly ScanJob _job;
+        private readonly Action<ScanProgressEventArgs> _publish;
+        private readonly Timer _timer;
+        private int _dirty;
+        private int _publishing;
+        private bool _disposed;
+
+        /// <summary>
+        /// عدد اللقطات المنشورة
+        /// </summary>
+        public long PublishedCount { get; private set; }
+
+        public ScanProgressPublisher(ScanJob job, Action<ScanProgressEventArgs> publish, TimeSpan interval)
+        {
+            _job = job;
+            _publish = publish;
+
+            if (interval <= TimeSpan.Zero)
+                interval = TimeSpan.FromMilliseconds(100);
+
+            _timer = new Timer(_ => Flush(), null, interval, interval);
+        }
+
+        /// <summary>
+        /// تسجيل وجود تحديث جديد
+        /// </summary>
+        public void MarkDirty() => Volatile.Write(ref _dirty, 1);
+
+        /// <summary>
+        /// نشر لقطة إن وجد تحديث منذ آخر نشر
+        /// </summary>
+        public void Flush()
+        {
+            if (Interlocked.Exchange(ref _dirty, 0) == 0)
+                return;
+
+            PublishSnapshot();
+        }
+
+        /// <summary>
+        /// نشر لقطة فوراً (بداية ونهاية الفحص)
+        /// </summary>
+        public void PublishNow()
+        {
+            Volatile.Write(ref _dirty, 0);
+            PublishSnapshot();
+        }
+
+        private void PublishSnapshot()
+        {
+            // منع تداخل مؤقت بطيء مع نشر فوري
+            if (Interlocked.Exchange(ref _publishing, 1) == 1)
+            {
+                MarkDirty();
+                return;
+            }
+
+            try
+            {
+                _publish(_job.CreateProgressSnapshot());
+                PublishedCount++;
+            }
+            catch { }
+            finally
+            {
+                Volatile.Write(ref _publishing, 0);
+            }
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+
+            using var done = new ManualResetEvent(false);
+            if (_timer.Dispose(done))
+                done.WaitOne(TimeSpan.FromSeconds(1));
+        }
+    }
+}
@@ -0,0 +1,126 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/ScanShardPlanner.cs
+// تقسيم مهمة الفحص إلى أجزاء حسب شجرة المجلدات
+// =====================================================
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// جزء من مهمة فحص: مجلد (أو ملف) بعمق محدد
+    /// </summary>
+    public class ScanShard
+    {
+        public int Id { get; set; }
+        public string Path { get; set; } = "";
+
+        /// <summary>
+        /// أقصى عمق داخل الجزء (0 = ملفات المجلد المباشرة فقط، -1 = بلا حد)
+        /// </summary>
+        public int MaxDepth { get; set; } = -1;
+
+        public override string ToString() => $"#{Id} {Path} (depth {MaxDepth})";
+    }
+
+    /// <summary>
+    /// مخطط الأجزاء - يوسّع المسارات الجذرية مستوى بمستوى حتى يصل لعدد كافٍ من الأجزاء.
+    /// كل مجلد موسَّع يصبح جزءاً لملفاته المباشرة (عمق 0) + جزءاً لكل مجلد فرعي،
+    /// فلا يُفحص أي ملف مرتين.
+    /// </summary>
+    public static class ScanShardPlanner
+    {
+        /// <summary>
+        /// أقصى عدد مستويات للتوسيع (تجنب تعداد كامل قبل بدء الفحص)
+        /// </summary>
+        public const int MaxExpandLevels = 3;
+
+        public static List<ScanShard> Plan(
+            IEnumerable<string> roots,
+            int targetShards,
+            int maxDepth = -1,
+            bool includeHidden = true)
+        {
+            var units = new List<(string Path, int MaxDepth)>();
+            var frontier = roots
+                .Select(NormalizePath)
+                .Distinct(StringComparer.OrdinalIgnoreCase)
+                .Select(p => (Path: p, MaxDepth: maxDepth))
+                .ToList();
+
+            for (int level = 0; level < MaxExpandLevels && frontier.Count > 0; level++)
+            {
+                if (units.Count + frontier.Count >= targetShards)
+                    break;
+
+                var next = new List<(string Path, int MaxDepth)>();
+
+                foreach (var (path, depth) in frontier)
+                {
+                    var subdirectories = depth == 0 ? null : GetSubdirectories(path, includeHidden);
+                    if (subdirectories == null || subdirectories.Count == 0)
+                    {
+                        units.Add((path, depth));
+                        continue;
+                    }
+
+                    // ملفات المجلد نفسه + كل مجلد فرعي كجزء مستقل
+                    units.Add((path, 0));
+                    foreach (var subdirectory in subdirectories)
+                    {
+                        next.Add((subdirectory, depth < 0 ? -1 : depth - 1));
+                    }
+                }
+
+                frontier = next;
+            }
+
+            units.AddRange(frontier);
+
+            return units
+                .Select((unit, index) => new ScanShard { Id = index, Path = unit.Path, MaxDepth = unit.MaxDepth })
+                .ToList();
+        }
+
+        private static List<string>? GetSubdirectories(string path, bool includeHidden)
+        {
+            if (!Directory.Exists(path))
+                return null;
+
+            try
+            {
+                var list = new List<string>();
+                foreach (var subdirectory in Directory.EnumerateDirectories(path))
+                {
+                    var attributes = File.GetAttributes(subdirectory);
+
+                    // نفس قواعد FileEnumerator: تخطي Reparse Points والمخفي عند استثنائه
+                    if ((attributes & FileAttributes.ReparsePoint) != 0)
+                        continue;
+                    if (!includeHidden && (attributes & FileAttributes.Hidden) != 0)
+                        continue;
+
+                    list.Add(subdirectory);
+                }
+
+                list.Sort(StringComparer.OrdinalIgnoreCase);
+                return list;
+            }
+            catch (Exception ex) when (ex is UnauthorizedAccessException or IOException)
+            {
+                return null;
+            }
+        }
+
+        private static string NormalizePath(string path)
+        {
+            try
+            {
+                return System.IO.Path.GetFullPath(path);
+            }
+            catch
+            {
+                return path;
+            }
+        }
+    }
+}
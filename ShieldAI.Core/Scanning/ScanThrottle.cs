@@ -0,0 +1,289 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Core/Scanning/ScanThrottle.cs
+// تقييد موارد الفحص في الخلفية (I/O + CPU)
+// =====================================================
+
+using System.Diagnostics;
+
+namespace ShieldAI.Core.Scanning
+{
+    /// <summary>
+    /// خيارات تقييد الفحص - تُحفظ مع ملف التعريف ونقطة الاستئناف
+    /// </summary>
+    public class ScanThrottleOptions
+    {
+        /// <summary>
+        /// الحد الأقصى للبايتات المقروءة في الثانية (0 = بلا حد)
+        /// </summary>
+        public long MaxBytesPerSecond { get; set; }
+
+        /// <summary>
+        /// الحد الأقصى للملفات في الثانية (0 = بلا حد)
+        /// </summary>
+        public int MaxFilesPerSecond { get; set; }
+
+        /// <summary>
+        /// نسبة وقت العمل لكل عامل فحص (1-100)
+        /// </summary>
+        public int CpuDutyCyclePercent { get; set; } = 100;
+
+        /// <summary>
+        /// تسريع الفحص عندما يكون النظام خاملاً
+        /// </summary>
+        public bool IdleAware { get; set; }
+
+        /// <summary>
+        /// معامل مضاعفة الحدود عند الخمول
+        /// </summary>
+        public double IdleSpeedupFactor { get; set; } = 4.0;
+
+        /// <summary>
+        /// الحمل الذي يعتبر النظام تحته خاملاً (0-1)
+        /// </summary>
+        public double IdleLoadThreshold { get; set; } = 0.3;
+
+        public bool IsUnlimited =>
+            MaxBytesPerSecond <= 0 &&
+            MaxFilesPerSecond <= 0 &&
+            CpuDutyCyclePercent >= 100;
+    }
+
+    /// <summary>
+    /// دلو رموز (Token Bucket) - يسمح بالدين ويعيد زمن الانتظار المطلوب
+    /// </summary>
+    public class TokenBucket
+    {
+        private readonly object _lock = new();
+        private readonly double _ratePerSecond;
+        private readonly double _capacity;
+        private double _tokens;
+        private long _lastRefillTicks;
+
+        public double RatePerSecond => _ratePerSecond;
+
+        public TokenBucket(double ratePerSecond, double burstSeconds = 1.0)
+        {
+            if (ratePerSecond <= 0)
+                throw new ArgumentOutOfRangeException(nameof(ratePerSecond));
+
+            _ratePerSecond = ratePerSecond;
+            _capacity = Math.Max(1, ratePerSecond * burstSeconds);
+            _tokens = _capacity;
+            _lastRefillTicks = Stopwatch.GetTimestamp();
+        }
+
+        /// <summary>
+        /// حجز رموز وإرجاع زمن الانتظار قبل استخدامها
+        /// </summary>
+        public TimeSpan Reserve(double tokens, double rateMultiplier = 1.0)
+        {
+            var rate = _ratePerSecond * Math.Max(0.01, rateMultiplier);
+
+            lock (_lock)
+            {
+                var now = Stopwatch.GetTimestamp();
+                var elapsed = (double)(now - _lastRefillTicks) / Stopwatch.Frequency;
+                _lastRefillTicks = now;
+
+                _tokens = Math.Min(_capacity * rateMultiplier, _tokens + elapsed * rate);
+                _tokens -= tokens;
+
+                return _tokens >= 0
+                    ? TimeSpan.Zero
+                    : TimeSpan.FromSeconds(-_tokens / rate);
+            }
+        }
+
+        /// <summary>
+        /// إعادة رموز محجوزة لم تُستخدم
+        /// </summary>
+        public void Refund(double tokens)
+        {
+            lock (_lock)
+            {
+                _tokens = Math.Min(_capacity, _tokens + tokens);
+            }
+        }
+
+        /// <summary>
+        /// تفريغ الدلو بحيث لا يتوفر رمز قبل انقضاء المدة (مثل Retry-After من الخادم)
+        /// </summary>
+        public void Penalize(TimeSpan delay)
+        {
+            lock (_lock)
+            {
+                _lastRefillTicks = Stopwatch.GetTimestamp();
+                _tokens = Math.Min(_tokens, -delay.TotalSeconds * _ratePerSecond);
+            }
+        }
+    }
+
+    /// <summary>
+    /// مقياس حمل النظام (0 = خامل، 1 = مشغول بالكامل)
+    /// </summary>
+    public static class SystemLoadMonitor
+    {
+        private static readonly object _lock = new();
+        private static double _cachedOsLoad;
+        private static long _cachedAtTicks;
+        private static TimeSpan _lastCpuTime;
+        private static long _lastCpuSampleTicks;
+
+        /// <summary>
+        /// الحمل الحالي: حمل النظام (مخزن مؤقتاً لثانية) أو عمل فوري منتظر في المنفذ
+        /// </summary>
+        /// <param name="executor">المنفذ الذي يُرسل إليه الفحص (null = المنفذ المشترك)</param>
+        public static double GetLoadFactor(ScanExecutor? executor = null)
+        {
+            double osLoad;
+            lock (_lock)
+            {
+                var now = Stopwatch.GetTimestamp();
+                if (_cachedAtTicks == 0 || now - _cachedAtTicks >= Stopwatch.Frequency)
+                {
+                    _cachedOsLoad = ReadOsLoad();
+                    _cachedAtTicks = now;
+                }
+
+                osLoad = _cachedOsLoad;
+            }
+
+            return Math.Max(osLoad, ReadExecutorPressure(executor ?? ScanExecutor.Shared));
+        }
+
+        private static double ReadOsLoad()
+        {
+            try
+            {
+                // Linux: متوسط الحمل لدقيقة / عدد المعالجات
+                if (OperatingSystem.IsLinux() && File.Exists("/proc/loadavg"))
+                {
+                    var first = File.ReadAllText("/proc/loadavg").Split(' ')[0];
+                    if (double.TryParse(first, System.Globalization.NumberStyles.Float,
+                        System.Globalization.CultureInfo.InvariantCulture, out var load))
+                    {
+                        return Math.Clamp(load / Environment.ProcessorCount, 0, 1);
+                    }
+                }
+
+                // غير ذلك: استهلاك CPU لعمليتنا بين عينتين
+                using var process = Process.GetCurrentProcess();
+                var cpu = process.TotalProcessorTime;
+                var now = Stopwatch.GetTimestamp();
+
+                double result = 0;
+                if (_lastCpuSampleTicks != 0)
+                {
+                    var wall = (double)(now - _lastCpuSampleTicks) / Stopwatch.Frequency;
+                    if (wall > 0)
+                        result = (cpu - _lastCpuTime).TotalSeconds / (wall * Environment.ProcessorCount);
+                }
+
+                _lastCpuTime = cpu;
+                _lastCpuSampleTicks = now;
+                return Math.Clamp(result, 0, 1);
+            }
+            catch
+            {
+                return 0;
+            }
+        }
+
+        private static double ReadExecutorPressure(ScanExecutor executor)
+        {
+            // عمل فوري منتظر = النظام غير خامل
+            return executor.GetQueuedCount(ScanPriorityClass.Realtime) > 0 ? 1.0 : 0;
+        }
+    }
+
+    /// <summary>
+    /// مقيد الفحص - يُستدعى قبل وبعد كل ملف
+    /// </summary>
+    public class ScanThrottle
+    {
+        private static readonly TimeSpan MaxSingleDelay = TimeSpan.FromSeconds(2);
+
+        private readonly ScanThrottleOptions _options;
+        private readonly TokenBucket? _bytesBucket;
+        private readonly TokenBucket? _filesBucket;
+        private readonly Func<double> _loadProvider;
+
+        public ScanThrottleOptions Options => _options;
+
+        public ScanThrottle(ScanThrottleOptions options, Func<double>? loadProvider = null)
+        {
+            _options = options;
+            _loadProvider = loadProvider ?? (() => SystemLoadMonitor.GetLoadFactor());
+
+            if (options.MaxBytesPerSecond > 0)
+                _bytesBucket = new TokenBucket(options.MaxBytesPerSecond);
+            if (options.MaxFilesPerSecond > 0)
+                _filesBucket = new TokenBucket(options.MaxFilesPerSecond);
+        }
+
+        /// <summary>
+        /// إنشاء مقيد من الخيارات (null = بلا تقييد)
+        /// </summary>
+        /// <param name="executor">المنفذ الذي تُقاس منه أولوية العمل الفوري (null = المنفذ المشترك)</param>
+        public static ScanThrottle? Create(ScanThrottleOptions? options, ScanExecutor? executor = null)
+        {
+            if (options == null || options.IsUnlimited)
+                return null;
+
+            return new ScanThrottle(options, () => SystemLoadMonitor.GetLoadFactor(executor));
+        }
+
+        /// <summary>
+        /// هل يحدد نسبة CPU (راحة بعد كل ملف)
+        /// </summary>
+        public bool LimitsDutyCycle => Math.Clamp(_options.CpuDutyCyclePercent, 1, 100) < 100;
+
+        /// <summary>
+        /// هل النظام خامل حالياً
+        /// </summary>
+        public bool IsIdle => _options.IdleAware && _loadProvider() < _options.IdleLoadThreshold;
+
+        /// <summary>
+        /// انتظار الرموز قبل فحص ملف
+        /// </summary>
+        public async Task BeforeFileAsync(long fileBytes, CancellationToken ct = default)
+        {
+            var multiplier = IsIdle ? Math.Max(1, _options.IdleSpeedupFactor) : 1.0;
+
+            var delay = TimeSpan.Zero;
+            if (_filesBucket != null)
+                delay = Max(delay, _filesBucket.Reserve(1, multiplier));
+            if (_bytesBucket != null)
+                delay = Max(delay, _bytesBucket.Reserve(Math.Max(1, fileBytes), multiplier));
+
+            if (delay > TimeSpan.Zero)
+                await Task.Delay(delay, ct).ConfigureAwait(false);
+        }
+
+        /// <summary>
+        /// راحة بعد فحص ملف للحفاظ على نسبة CPU.
+        /// تُنتظر داخل المهمة المُرسلة، فتبقى خانة نافذة الإرسال محجوزة وتتأخر الإرسالات التالية.
+        /// </summary>
+        public Task AfterFileAsync(TimeSpan busyTime, CancellationToken ct = default)
+        {
+            var delay = GetDutyCycleDelay(busyTime);
+            return delay > TimeSpan.Zero ? Task.Delay(delay, ct) : Task.CompletedTask;
+        }
+
+        /// <summary>
+        /// زمن الراحة المطلوب بعد عمل بمدة معينة
+        /// </summary>
+        public TimeSpan GetDutyCycleDelay(TimeSpan busyTime)
+        {
+            var duty = Math.Clamp(_options.CpuDutyCyclePercent, 1, 100);
+            if (duty >= 100 || busyTime <= TimeSpan.Zero || IsIdle)
+                return TimeSpan.Zero;
+
+            var rest = busyTime.TotalMilliseconds * (100 - duty) / duty;
+            return Max(TimeSpan.Zero, TimeSpan.FromMilliseconds(Math.Min(rest, MaxSingleDelay.TotalMilliseconds)));
+        }
+
+        private static TimeSpan Max(TimeSpan a, TimeSpan b) => a > b ? a : b;
+    }
+}
@@ -36,6 +36,10 @@ namespace ShieldAI.Service.Ipc
         {
             Commands.RestoreFromQuarantine,
             Commands.DeleteFromQuarantine,
+            Commands.ClearQuarantine,
+            Commands.BulkQuarantine,
+            Commands.BulkRestoreQuarantine,
+            Commands.BulkDeleteQuarantine,
             Commands.DisableRealTime
         };
 
@@ -259,7 +263,10 @@ namespace ShieldAI.Service.Ipc
 
         #region Security
 
-        private static PipeSecurity CreatePipeSecurity()
+        /// <summary>
+        /// ACL الـ pipe: SYSTEM والمسؤولون والمستخدم الحالي فقط (يُشارك مع pipe عمال الفحص الموزّع)
+        /// </summary>
+        internal static PipeSecurity CreatePipeSecurity()
         {
             var security = new PipeSecurity();
 
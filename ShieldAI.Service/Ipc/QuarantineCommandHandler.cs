@@ -0,0 +1,276 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Service/Ipc/QuarantineCommandHandler.cs
+// أوامر الحجر عبر IPC فوق QuarantineStore مع دمج عناصر QuarantineManager القديمة
+// =====================================================
+
+using ShieldAI.Core.Contracts;
+using ShieldAI.Core.Monitoring.Quarantine;
+using ShieldAI.Core.Security;
+
+namespace ShieldAI.Service.Ipc
+{
+    /// <summary>
+    /// معالج أوامر الحجر: القائمة والاستعادة والحذف (فردية وجماعية).
+    /// المصدر الأساسي QuarantineStore (عبر قائمة الإجراءات)؛ عناصر QuarantineManager
+    /// القديمة تظهر في القائمة وتُستعاد/تُحذف من مصدرها حتى تنفد.
+    /// الحجر الجماعي يقبل فقط مسارات كشوفات معلقة - لا يصبح أداة حذف ملفات عشوائية بصلاحيات الخدمة.
+    /// </summary>
+    public class QuarantineCommandHandler
+    {
+        private readonly QuarantineStore _store;
+        private readonly QuarantineActionQueue _queue;
+        private readonly QuarantineManager? _legacy;
+        private readonly Func<IEnumerable<string>> _pendingDetections;
+
+        /// <param name="pendingDetections">مسارات الكشوفات المعلقة المسموح بحجرها جماعياً</param>
+        public QuarantineCommandHandler(
+            QuarantineStore store,
+            QuarantineActionQueue queue,
+            QuarantineManager? legacy = null,
+            Func<IEnumerable<string>>? pendingDetections = null)
+        {
+            _store = store;
+            _queue = queue;
+            _legacy = legacy;
+            _pendingDetections = pendingDetections ?? Enumerable.Empty<string>;
+        }
+
+        /// <summary>
+        /// إجمالي العناصر المحجورة من المصدرين
+        /// </summary>
+        public int Count => _store.Count + (_legacy?.GetCount() ?? 0);
+
+        public ResponseEnvelope GetList(CommandEnvelope command)
+        {
+            var items = _store.GetAllItems()
+                .Where(i => Guid.TryParse(i.Id, out _))
+                .Select(i => new QuarantineItemDto
+                {
+                    Id = Guid.Parse(i.Id),
+                    OriginalPath = i.OriginalPath,
+                    OriginalName = i.OriginalName,
+                    ThreatName = i.ThreatName ?? i.Verdict,
+                    FileSize = i.FileSize,
+                    QuarantinedAt = i.QuarantinedAt
+                })
+                .Concat((_legacy?.GetAllEntries() ?? new List<QuarantineEntry>()).Select(e => new QuarantineItemDto
+                {
+                    Id = e.Id,
+                    OriginalPath = e.OriginalPath,
+                    OriginalName = e.OriginalName,
+                    ThreatName = e.ThreatName,
+                    FileSize = e.FileSize,
+                    QuarantinedAt = e.QuarantinedAt
+                }))
+                .OrderByDescending(i => i.QuarantinedAt)
+                .ToList();
+
+            return ResponseEnvelope.Ok(command.Id, new QuarantineListResponse
+            {
+                Items = items,
+                TotalCount = items.Count
+            });
+        }
+
+        public async Task<ResponseEnvelope> RestoreAsync(CommandEnvelope command)
+        {
+            var request = command.GetPayload<QuarantineActionRequest>();
+            if (request == null)
+                return ResponseEnvelope.Fail(command.Id, "Invalid request");
+
+            var outcome = (await RestoreManyAsync(
+                new[] { request.EntryId.ToString("N") }, id => request.RestorePath))[0];
+            return outcome.Success
+                ? ResponseEnvelope.Ok(command.Id)
+                : ResponseEnvelope.Fail(command.Id, outcome.Error ?? "Failed to restore file");
+        }
+
+        public async Task<ResponseEnvelope> DeleteAsync(CommandEnvelope command)
+        {
+            var request = command.GetPayload<QuarantineActionRequest>();
+            if (request == null)
+                return ResponseEnvelope.Fail(command.Id, "Invalid request");
+
+            var outcome = (await DeleteManyAsync(new[] { request.EntryId.ToString("N") }))[0];
+            return outcome.Success
+                ? ResponseEnvelope.Ok(command.Id)
+                : ResponseEnvelope.Fail(command.Id, outcome.Error ?? "Failed to delete file");
+        }
+
+        public async Task<ResponseEnvelope> ClearAsync(CommandEnvelope command)
+        {
+            await _store.ClearAllAsync();
+            _legacy?.ClearAll();
+            return ResponseEnvelope.Ok(command.Id);
+        }
+
+        public async Task<ResponseEnvelope> BulkQuarantineAsync(CommandEnvelope command)
+        {
+            var request = command.GetPayload<BulkQuarantineRequest>();
+            if (request == null || request.Paths.Count == 0)
+                return ResponseEnvelope.Fail(command.Id, "No paths specified");
+
+            var pending = new HashSet<string>(_pendingDetections().Select(NormalizePath), StringComparer.OrdinalIgnoreCase);
+            var results = new QuarantineItemOutcomeDto[request.Paths.Count];
+            var queued = new List<int>();
+
+            for (int i = 0; i < request.Paths.Count; i++)
+            {
+                if (pending.Contains(NormalizePath(request.Paths[i])))
+                    queued.Add(i);
+                else
+                    results[i] = new QuarantineItemOutcomeDto { Target = request.Paths[i], Error = "Not a pending detection" };
+            }
+
+            var outcomes = await _queue.QuarantineManyAsync(
+                queued.Select(i => new QuarantineRequest(request.Paths[i]) { AtomicMove = true }));
+            for (int k = 0; k < queued.Count; k++)
+                results[queued[k]] = ToDto(outcomes[k]);
+
+            return ResponseEnvelope.Ok(command.Id, ToBulkResponse(results));
+        }
+
+        public async Task<ResponseEnvelope> BulkRestoreAsync(CommandEnvelope command)
+        {
+            var request = command.GetPayload<BulkQuarantineActionRequest>();
+            if (request == null || request.ItemIds.Count == 0)
+                return ResponseEnvelope.Fail(command.Id, "No items specified");
+
+            var outcomes = await RestoreManyAsync(
+                request.ItemIds.Select(NormalizeId).ToList(),
+                id => RestorePathFor(id, request.RestoreDirectory));
+            return ResponseEnvelope.Ok(command.Id, ToBulkResponse(outcomes));
+        }
+
+        public async Task<ResponseEnvelope> BulkDeleteAsync(CommandEnvelope command)
+        {
+            var request = command.GetPayload<BulkQuarantineActionRequest>();
+            if (request == null || request.ItemIds.Count == 0)
+                return ResponseEnvelope.Fail(command.Id, "No items specified");
+
+            var outcomes = await DeleteManyAsync(request.ItemIds.Select(NormalizeId).ToList());
+            return ResponseEnvelope.Ok(command.Id, ToBulkResponse(outcomes));
+        }
+
+        private async Task<QuarantineItemOutcomeDto[]> RestoreManyAsync(
+            IReadOnlyList<string> itemIds,
+            Func<string, string?> restorePathFor)
+        {
+            var results = new QuarantineItemOutcomeDto[itemIds.Count];
+            var queued = new List<int>();
+
+            for (int i = 0; i < itemIds.Count; i++)
+            {
+                if (TryGetLegacyEntry(itemIds[i], out var entry))
+                {
+                    var restored = _legacy!.RestoreFile(entry.Id, restorePathFor(itemIds[i]));
+                    results[i] = LegacyOutcome(itemIds[i], restored, "Failed to restore file");
+                }
+                else
+                {
+                    queued.Add(i);
+                }
+            }
+
+            var outcomes = await _queue.RestoreManyAsync(
+                queued.Select(i => new QuarantineRestoreRequest(itemIds[i], restorePathFor(itemIds[i]))));
+            for (int k = 0; k < queued.Count; k++)
+                results[queued[k]] = ToDto(outcomes[k]);
+
+            return results;
+        }
+
+        private async Task<QuarantineItemOutcomeDto[]> DeleteManyAsync(IReadOnlyList<string> itemIds)
+        {
+            var results = new QuarantineItemOutcomeDto[itemIds.Count];
+            var queued = new List<int>();
+
+            for (int i = 0; i < itemIds.Count; i++)
+            {
+                if (TryGetLegacyEntry(itemIds[i], out var entry))
+                    results[i] = LegacyOutcome(itemIds[i], _legacy!.DeleteFile(entry.Id), "Failed to delete file");
+                else
+                    queued.Add(i);
+            }
+
+            var outcomes = await _queue.DeleteManyAsync(queued.Select(i => itemIds[i]));
+            for (int k = 0; k < queued.Count; k++)
+                results[queued[k]] = ToDto(outcomes[k]);
+
+            return results;
+        }
+
+        /// <summary>
+        /// عنصر قديم فقط إن لم يكن في المخزن الجديد
+        /// </summary>
+        private bool TryGetLegacyEntry(string itemId, out QuarantineEntry entry)
+        {
+            entry = null!;
+            if (_legacy == null || _store.GetItem(itemId) != null || !Guid.TryParse(itemId, out var guid))
+                return false;
+
+            var found = _legacy.GetEntry(guid);
+            if (found == null)
+                return false;
+
+            entry = found;
+            return true;
+        }
+
+        private string? RestorePathFor(string itemId, string? restoreDirectory)
+        {
+            if (string.IsNullOrWhiteSpace(restoreDirectory))
+                return null;
+
+            var name = _store.GetItem(itemId)?.OriginalName ??
+                       (Guid.TryParse(itemId, out var guid) ? _legacy?.GetEntry(guid)?.OriginalName : null);
+            return name == null ? null : Path.Combine(restoreDirectory, name);
+        }
+
+        /// <summary>
+        /// معرفات المخزن بصيغة Guid "N" - العميل قد يرسل الصيغة ذات الشرطات
+        /// </summary>
+        private static string NormalizeId(string itemId) =>
+            Guid.TryParse(itemId, out var guid) ? guid.ToString("N") : itemId;
+
+        private static string NormalizePath(string path)
+        {
+            try
+            {
+                return Path.GetFullPath(path);
+            }
+            catch
+            {
+                return path;
+            }
+        }
+
+        private static QuarantineItemOutcomeDto ToDto(QuarantineItemOutcome outcome) => new()
+        {
+            Target = outcome.Target,
+            Success = outcome.Success,
+            ItemId = outcome.Item?.Id,
+            Error = outcome.Error
+        };
+
+        private static QuarantineItemOutcomeDto LegacyOutcome(string itemId, bool success, string error) => new()
+        {
+            Target = itemId,
+            Success = success,
+            ItemId = success ? itemId : null,
+            Error = success ? null : error
+        };
+
+        private static BulkQuarantineResponse ToBulkResponse(IReadOnlyList<QuarantineItemOutcomeDto> outcomes)
+        {
+            var succeeded = outcomes.Count(o => o.Success);
+            return new BulkQuarantineResponse
+            {
+                Outcomes = outcomes.ToList(),
+                Succeeded = succeeded,
+                Failed = outcomes.Count - succeeded
+            };
+        }
+    }
+}
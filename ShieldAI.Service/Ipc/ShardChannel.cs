@@ -0,0 +1,209 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Service/Ipc/ShardChannel.cs
+// قناة الاتصال بين منسق الفحص الموزّع وعمليات العمال
+// =====================================================
+
+using System.Diagnostics;
+using System.IO.Pipes;
+using System.Reflection;
+using System.Runtime.InteropServices;
+using System.Text;
+using Microsoft.Win32.SafeHandles;
+using ShieldAI.Core.Contracts;
+using ShieldAI.Service.Workers;
+
+namespace ShieldAI.Service.Ipc
+{
+    /// <summary>
+    /// إطار الرسائل على الـ pipe: طول (4 بايت) + JSON - نفس بروتوكول IpcServerWorker
+    /// </summary>
+    public static class ShardPipeProtocol
+    {
+        public const int MaxMessageSize = 4 * 1024 * 1024;
+
+        public static async Task<string?> ReadMessageAsync(Stream pipe, CancellationToken ct)
+        {
+            var lengthBuffer = new byte[4];
+            if (await pipe.ReadAtLeastAsync(lengthBuffer, 4, throwOnEndOfStream: false, ct) < 4)
+                return null;
+
+            var length = BitConverter.ToInt32(lengthBuffer, 0);
+            if (length <= 0 || length > MaxMessageSize)
+                return null;
+
+            var messageBuffer = new byte[length];
+            if (await pipe.ReadAtLeastAsync(messageBuffer, length, throwOnEndOfStream: false, ct) < length)
+                return null;
+
+            return Encoding.UTF8.GetString(messageBuffer);
+        }
+
+        public static async Task SendMessageAsync(Stream pipe, string message, CancellationToken ct)
+        {
+            var messageBytes = Encoding.UTF8.GetBytes(message);
+            var lengthBytes = BitConverter.GetBytes(messageBytes.Length);
+
+            await pipe.WriteAsync(lengthBytes, ct);
+            await pipe.WriteAsync(messageBytes, ct);
+            await pipe.FlushAsync(ct);
+        }
+
+        /// <summary>
+        /// إنشاء pipe العامل مع ACL منذ لحظة الإنشاء - لا نافذة يتصل فيها مستخدم آخر قبل تطبيقه
+        /// </summary>
+        public static NamedPipeServerStream CreateServer(string pipeName) =>
+            NamedPipeServerStreamAcl.Create(
+                pipeName,
+                PipeDirection.InOut,
+                maxNumberOfServerInstances: 1,
+                PipeTransmissionMode.Byte,
+                PipeOptions.Asynchronous,
+                inBufferSize: 0,
+                outBufferSize: 0,
+                PipeServer.CreatePipeSecurity());
+
+        /// <summary>
+        /// هل العميل المتصل هو عملية المنسق نفسها؟ (معرّف العملية من النواة لا من الرسائل)
+        /// </summary>
+        public static bool IsClientProcess(NamedPipeServerStream pipe, int expectedProcessId)
+        {
+            if (expectedProcessId <= 0)
+                return false;
+
+            try
+            {
+                return GetNamedPipeClientProcessId(pipe.SafePipeHandle, out var clientProcessId) &&
+                       clientProcessId == (uint)expectedProcessId;
+            }
+            catch (Exception ex) when (ex is EntryPointNotFoundException or DllNotFoundException)
+            {
+                return false;
+            }
+        }
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        private static extern bool GetNamedPipeClientProcessId(SafePipeHandle pipe, out uint clientProcessId);
+    }
+
+    /// <summary>
+    /// عامل فحص يستقبل الأجزاء من المنسق
+    /// </summary>
+    public interface IShardWorker : IDisposable
+    {
+        /// <summary>
+        /// رقم الخانة لدى المنسق
+        /// </summary>
+        int SlotId { get; }
+
+        /// <summary>
+        /// هل العامل حي ومتصل
+        /// </summary>
+        bool IsAlive { get; }
+
+        Task StartAsync(CancellationToken ct);
+
+        /// <summary>
+        /// إرسال أمر وانتظار الرد (يرمي استثناء إذا انقطع العامل)
+        /// </summary>
+        Task<ResponseEnvelope> SendAsync(CommandEnvelope command, CancellationToken ct);
+    }
+
+    /// <summary>
+    /// عامل في عملية منفصلة: ShieldAI.Service --shard-worker متصل بـ pipe خاص
+    /// </summary>
+    public sealed class ShardWorkerProcess : IShardWorker
+    {
+        private static readonly TimeSpan ConnectTimeout = TimeSpan.FromSeconds(15);
+
+        private readonly int _concurrency;
+        private readonly SemaphoreSlim _sendLock = new(1, 1);
+        private Process? _process;
+        private NamedPipeClientStream? _pipe;
+        private bool _disposed;
+
+        public int SlotId { get; }
+
+        public bool IsAlive => !_disposed &&
+                               _pipe?.IsConnected == true &&
+                               _process != null && !_process.HasExited;
+
+        public ShardWorkerProcess(int slotId, int concurrency)
+        {
+            SlotId = slotId;
+            _concurrency = concurrency;
+        }
+
+        public async Task StartAsync(CancellationToken ct)
+        {
+            var pipeName = $"ShieldAI_Shard_{Environment.ProcessId}_{SlotId}_{Guid.NewGuid():N}";
+            var arguments = $"{ShardWorkerHost.Argument} --pipe {pipeName} --parent {Environment.ProcessId} --concurrency {_concurrency}";
+
+            _process = Process.Start(CreateStartInfo(arguments))
+                ?? throw new InvalidOperationException("تعذر تشغيل عملية العامل");
+
+            _pipe = new NamedPipeClientStream(".", pipeName, PipeDirection.InOut, PipeOptions.Asynchronous);
+            await _pipe.ConnectAsync((int)ConnectTimeout.TotalMilliseconds, ct);
+        }
+
+        public async Task<ResponseEnvelope> SendAsync(CommandEnvelope command, CancellationToken ct)
+        {
+            var pipe = _pipe ?? throw new InvalidOperationException("العامل لم يبدأ");
+
+            await _sendLock.WaitAsync(ct);
+            try
+            {
+                await ShardPipeProtocol.SendMessageAsync(pipe, command.ToJson(), ct);
+                var json = await ShardPipeProtocol.ReadMessageAsync(pipe, ct)
+                    ?? throw new IOException("انقطع الاتصال بعامل الفحص");
+
+                return ResponseEnvelope.FromJson(json)
+                    ?? throw new IOException("رد غير صالح من عامل الفحص");
+            }
+            finally
+            {
+                _sendLock.Release();
+            }
+        }
+
+        private static ProcessStartInfo CreateStartInfo(string arguments)
+        {
+            var processPath = Environment.ProcessPath ?? "";
+
+            // التشغيل عبر dotnet host: نمرر مسار الـ assembly أولاً
+            if (Path.GetFileNameWithoutExtension(processPath).Equals("dotnet", StringComparison.OrdinalIgnoreCase))
+            {
+                var assemblyPath = Assembly.GetEntryAssembly()?.Location ?? "";
+                arguments = $"\"{assemblyPath}\" {arguments}";
+            }
+
+            return new ProcessStartInfo(processPath, arguments)
+            {
+                UseShellExecute = false,
+                CreateNoWindow = true
+            };
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+
+            try { _pipe?.Dispose(); } catch { }
+
+            try
+            {
+                if (_process != null && !_process.HasExited)
+                {
+                    // العامل يغلق نفسه عند انقطاع الـ pipe، ننتظر قليلاً ثم نُنهيه
+                    if (!_process.WaitForExit(2000))
+                        _process.Kill(entireProcessTree: true);
+                }
+            }
+            catch { }
+
+            _process?.Dispose();
+            _sendLock.Dispose();
+        }
+    }
+}
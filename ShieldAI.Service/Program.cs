@@ -15,6 +15,13 @@ namespace ShieldAI.Service
     {
         public static void Main(string[] args)
         {
+            // عملية عامل للفحص الموزّع - بدون host الخدمة
+            if (ShardWorkerHost.IsShardWorker(args))
+            {
+                Environment.ExitCode = ShardWorkerHost.RunAsync(args).GetAwaiter().GetResult();
+                return;
+            }
+
             CreateHostBuilder(args).Build().Run();
         }
 
@@ -54,6 +61,11 @@ namespace ShieldAI.Service
                     
                     // خادم IPC
                     services.AddHostedService<IpcServerWorker>();
+
+                    // الفحوصات المجدولة عبر منسق الـ Worker (نفس المنفذ والكاش)
+                    services.AddHostedService(_ => new ScanScheduler(
+                        new Core.Logging.FileLogger(),
+                        () => ShieldAIWorker.Instance?.TryGetScanOrchestrator()));
                 });
     }
 
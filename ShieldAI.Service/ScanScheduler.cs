@@ -4,19 +4,21 @@
 // مجدول الفحص
 // =====================================================
 
+using Microsoft.Extensions.Hosting;
 using ShieldAI.Core.Configuration;
 using ShieldAI.Core.Logging;
+using ShieldAI.Core.Models;
 using ShieldAI.Core.Scanning;
 
 namespace ShieldAI.Service
 {
     /// <summary>
-    /// مجدول الفحص - يدير الفحوصات المجدولة
+    /// مجدول الفحص - يدير الفحوصات المجدولة (خدمة مستضافة)
     /// </summary>
-    public class ScanScheduler
+    public class ScanScheduler : IHostedService
     {
         private readonly Core.Logging.ILogger _logger;
-        private readonly FileScanner _fileScanner;
+        private readonly Func<ScanOrchestrator?> _orchestratorProvider;
         private readonly List<ScheduledScan> _scheduledScans;
         private CancellationTokenSource? _cts;
         private Task? _schedulerTask;
@@ -42,10 +44,18 @@ namespace ShieldAI.Service
         /// </summary>
         public event EventHandler<ScheduledScanResult>? ScanCompleted;
 
-        public ScanScheduler(Core.Logging.ILogger? logger = null)
+        public ScanScheduler(Core.Logging.ILogger? logger = null, ScanOrchestrator? orchestrator = null)
+            : this(logger, CreateFixedProvider(orchestrator ?? new ScanOrchestrator()))
+        {
+        }
+
+        /// <param name="orchestratorProvider">
+        /// منسق الفحص المشترك - null حتى تنتهي تهيئة الخدمة (الفحوصات المستحقة تنتظر)
+        /// </param>
+        public ScanScheduler(Core.Logging.ILogger? logger, Func<ScanOrchestrator?> orchestratorProvider)
         {
             _logger = logger ?? new ServiceNullLogger();
-            _fileScanner = new FileScanner();
+            _orchestratorProvider = orchestratorProvider;
             _scheduledScans = new List<ScheduledScan>();
 
             // تحميل الفحوصات المجدولة الافتراضية
@@ -160,7 +170,18 @@ namespace ShieldAI.Service
                 };
             }
 
-            return await ExecuteScheduledScanAsync(scan, cancellationToken);
+            var orchestrator = _orchestratorProvider();
+            if (orchestrator == null)
+            {
+                return new ScheduledScanResult
+                {
+                    ScanId = scanId,
+                    Success = false,
+                    Error = "الخدمة لم تكتمل تهيئتها"
+                };
+            }
+
+            return await ExecuteScheduledScanAsync(orchestrator, scan, cancellationToken);
         }
         #endregion
 
@@ -209,10 +230,15 @@ namespace ShieldAI.Service
             {
                 try
                 {
+                    // المنسق غير جاهز بعد: الفحوصات المستحقة تبقى مستحقة للدورة التالية
+                    var orchestrator = _orchestratorProvider();
+
                     // التحقق من الفحوصات المستحقة
-                    var dueScans = _scheduledScans
-                        .Where(s => s.IsEnabled && s.NextRunTime.HasValue && s.NextRunTime <= DateTime.Now)
-                        .ToList();
+                    var dueScans = orchestrator == null
+                        ? new List<ScheduledScan>()
+                        : _scheduledScans
+                            .Where(s => s.IsEnabled && s.NextRunTime.HasValue && s.NextRunTime <= DateTime.Now)
+                            .ToList();
 
                     foreach (var scan in dueScans)
                     {
@@ -220,7 +246,7 @@ namespace ShieldAI.Service
                             break;
 
                         _logger.Information("تنفيذ فحص مجدول: {0}", scan.Name);
-                        await ExecuteScheduledScanAsync(scan, cancellationToken);
+                        await ExecuteScheduledScanAsync(orchestrator!, scan, cancellationToken);
                         UpdateNextRunTime(scan);
                     }
 
@@ -277,7 +303,21 @@ namespace ShieldAI.Service
             scan.NextRunTime = nextRun;
         }
 
-        private async Task<ScheduledScanResult> ExecuteScheduledScanAsync(ScheduledScan scan, CancellationToken cancellationToken)
+        private static Func<ScanOrchestrator?> CreateFixedProvider(ScanOrchestrator orchestrator)
+        {
+            return () => orchestrator;
+        }
+
+        /// <summary>
+        /// أولوية ملف التعريف (1-10): العالية تُعامل كفحص عند الطلب، والباقي بأولوية الخلفية
+        /// </summary>
+        private static ScanPriorityClass GetPriorityClass(ScanProfile profile)
+        {
+            return profile.Priority >= 8 ? ScanPriorityClass.OnDemand : ScanPriorityClass.Scheduled;
+        }
+
+        private async Task<ScheduledScanResult> ExecuteScheduledScanAsync(
+            ScanOrchestrator orchestrator, ScheduledScan scan, CancellationToken cancellationToken)
         {
             var result = new ScheduledScanResult
             {
@@ -289,22 +329,17 @@ namespace ShieldAI.Service
             {
                 ScanStarted?.Invoke(this, scan);
 
-                // تنفيذ الفحص على كل مسار
-                int totalScanned = 0;
-                int totalThreats = 0;
-                
-                foreach (var targetPath in scan.Profile.TargetPaths)
-                {
-                    if (cancellationToken.IsCancellationRequested) break;
-                    
-                    var results = await _fileScanner.ScanDirectoryAsync(targetPath, true, cancellationToken);
-                    totalScanned += results.Count;
-                    totalThreats += results.Count(r => r.IsInfected);
-                }
+                // نفس مسار الفحص عند الطلب: تعداد حسب ملف التعريف + فحص متوازٍ عبر المنفذ المشترك
+                var report = await orchestrator.StartScanAsync(
+                    scan.Profile, cancellationToken, GetPriorityClass(scan.Profile));
+
+                if (report.FinalStatus == ScanStatus.Cancelled)
+                    throw new OperationCanceledException(cancellationToken);
 
-                result.Success = true;
-                result.FilesScanned = totalScanned;
-                result.ThreatsFound = totalThreats;
+                result.Success = report.FinalStatus == ScanStatus.Completed;
+                result.FilesScanned = report.ScannedFiles;
+                result.ThreatsFound = report.ThreatsFound;
+                result.Error = report.Errors.FirstOrDefault();
                 result.EndTime = DateTime.Now;
 
                 scan.LastRunTime = result.EndTime;
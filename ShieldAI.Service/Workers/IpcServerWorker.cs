@@ -157,21 +157,29 @@ namespace ShieldAI.Service.Workers
                         IsRunning = true,
                         RealTimeEnabled = worker.IsRealTimeEnabled,
                         StartTime = worker.StartTime,
-                        ActiveScans = worker.ScanOrchestrator.GetActiveJobs().Count(),
-                        QuarantineCount = worker.QuarantineManager.GetCount(),
+                        ActiveScans = worker.ScanOrchestrator.GetActiveJobs().Count() +
+                                      worker.ShardCoordinator.GetActiveJobs().Count(),
+                        QuarantineCount = worker.QuarantineCommands.Count,
                         TotalThreatsBlocked = worker.TotalThreatsBlocked
                     }),
 
                     Commands.StartScan => await HandleStartScanAsync(command, worker),
                     Commands.StopScan => HandleStopScan(command, worker),
                     Commands.GetScanProgress => HandleGetScanProgress(command, worker),
+                    Commands.ResumeScan => HandleResumeScan(command, worker),
+                    Commands.GetResumableScans => HandleGetResumableScans(command, worker),
 
                     Commands.EnableRealTime => HandleRealTime(command, worker, true),
                     Commands.DisableRealTime => HandleRealTime(command, worker, false),
+                    Commands.GetRealTimeStatus => ResponseEnvelope.Ok(command.Id, worker.GetRealTimeStatus()),
 
-                    Commands.GetQuarantineList => HandleGetQuarantineList(command, worker),
-                    Commands.RestoreFromQuarantine => HandleQuarantineRestore(command, worker),
-                    Commands.DeleteFromQuarantine => HandleQuarantineDelete(command, worker),
+                    Commands.GetQuarantineList => worker.QuarantineCommands.GetList(command),
+                    Commands.RestoreFromQuarantine => await worker.QuarantineCommands.RestoreAsync(command),
+                    Commands.DeleteFromQuarantine => await worker.QuarantineCommands.DeleteAsync(command),
+                    Commands.ClearQuarantine => await worker.QuarantineCommands.ClearAsync(command),
+                    Commands.BulkQuarantine => await worker.QuarantineCommands.BulkQuarantineAsync(command),
+                    Commands.BulkRestoreQuarantine => await worker.QuarantineCommands.BulkRestoreAsync(command),
+                    Commands.BulkDeleteQuarantine => await worker.QuarantineCommands.BulkDeleteAsync(command),
 
                     Commands.ResolveThreatAction => await HandleResolveThreatAsync(command, worker),
                     Commands.GetPendingThreats => HandleGetPendingThreats(command, worker),
@@ -205,7 +213,10 @@ namespace ShieldAI.Service.Workers
                 DeepScan = request.DeepScan
             };
 
-            _ = Task.Run(() => worker.ScanOrchestrator.ExecuteScanJobAsync(job));
+            if (worker.ShardCoordinator.ShouldShard(job))
+                _ = Task.Run(() => worker.ShardCoordinator.ExecuteScanJobAsync(job));
+            else
+                _ = Task.Run(() => worker.ScanOrchestrator.ExecuteScanJobAsync(job));
 
             return ResponseEnvelope.Ok(command.Id, new StartScanResponse
             {
@@ -220,17 +231,20 @@ namespace ShieldAI.Service.Workers
             if (request != null)
             {
                 worker.ScanOrchestrator.StopScan(request.JobId);
+                worker.ShardCoordinator.StopScan(request.JobId);
             }
             else
             {
                 worker.ScanOrchestrator.StopAllScans();
+                worker.ShardCoordinator.StopAllScans();
             }
             return ResponseEnvelope.Ok(command.Id);
         }
 
         private ResponseEnvelope HandleGetScanProgress(CommandEnvelope command, ShieldAIWorker worker)
         {
-            var jobs = worker.ScanOrchestrator.GetActiveJobs();
+            var jobs = worker.ScanOrchestrator.GetActiveJobs()
+                .Concat(worker.ShardCoordinator.GetActiveJobs());
             var firstJob = jobs.FirstOrDefault();
             
             if (firstJob == null)
@@ -253,56 +267,60 @@ namespace ShieldAI.Service.Workers
             });
         }
 
-        private ResponseEnvelope HandleRealTime(CommandEnvelope command, ShieldAIWorker worker, bool enable)
+        private ResponseEnvelope HandleResumeScan(CommandEnvelope command, ShieldAIWorker worker)
         {
-            worker.SetRealTimeProtection(enable);
-            return ResponseEnvelope.Ok(command.Id);
+            var request = command.GetPayload<ResumeScanRequest>();
+            if (request == null)
+                return ResponseEnvelope.Fail(command.Id, "Invalid request");
+
+            var checkpoint = GetResumableScans(worker)
+                .FirstOrDefault(c => c.JobId == request.JobId);
+            if (checkpoint == null)
+                return ResponseEnvelope.Fail(command.Id, "No checkpoint for this scan");
+
+            // الاستئناف في thread منفصل - الفحص الموزّع يُستأنف عبر المنسق
+            if (checkpoint.Shards != null)
+                _ = Task.Run(() => worker.ShardCoordinator.ResumeScanAsync(request.JobId));
+            else
+                _ = Task.Run(() => worker.ScanOrchestrator.ResumeScanAsync(request.JobId));
+
+            return ResponseEnvelope.Ok(command.Id, new StartScanResponse
+            {
+                JobId = checkpoint.JobId,
+                TotalFiles = checkpoint.TotalFiles
+            });
         }
 
-        private ResponseEnvelope HandleGetQuarantineList(CommandEnvelope command, ShieldAIWorker worker)
+        private ResponseEnvelope HandleGetResumableScans(CommandEnvelope command, ShieldAIWorker worker)
         {
-            var entries = worker.QuarantineManager.GetAllEntries();
-            return ResponseEnvelope.Ok(command.Id, new QuarantineListResponse
+            return ResponseEnvelope.Ok(command.Id, new ResumableScansResponse
             {
-                Items = entries.Select(e => new QuarantineItemDto
+                Scans = GetResumableScans(worker).Select(c => new ResumableScanDto
                 {
-                    Id = e.Id,
-                    OriginalPath = e.OriginalPath,
-                    OriginalName = e.OriginalName,
-                    ThreatName = e.ThreatName,
-                    FileSize = e.FileSize,
-                    QuarantinedAt = e.QuarantinedAt
-                }).ToList(),
-                TotalCount = entries.Count
+                    JobId = c.JobId,
+                    ScanType = c.Type,
+                    Paths = c.Paths,
+                    TotalFiles = c.TotalFiles,
+                    ScannedFiles = c.ScannedFiles,
+                    ThreatsFound = c.ThreatsFound,
+                    ProgressPercent = c.ProgressPercent,
+                    StartedAt = c.StartedAt,
+                    UpdatedAt = c.UpdatedAt
+                }).ToList()
             });
         }
 
-        private ResponseEnvelope HandleQuarantineRestore(CommandEnvelope command, ShieldAIWorker worker)
+        private static IEnumerable<Core.Scanning.ScanCheckpoint> GetResumableScans(ShieldAIWorker worker)
         {
-            var request = command.GetPayload<QuarantineActionRequest>();
-            if (request == null)
-            {
-                return ResponseEnvelope.Fail(command.Id, "Invalid request");
-            }
-
-            var success = worker.QuarantineManager.RestoreFile(request.EntryId, request.RestorePath);
-            return success 
-                ? ResponseEnvelope.Ok(command.Id) 
-                : ResponseEnvelope.Fail(command.Id, "Failed to restore file");
+            return worker.ScanOrchestrator.GetResumableScans()
+                .Concat(worker.ShardCoordinator.GetResumableScans())
+                .OrderByDescending(c => c.UpdatedAt);
         }
 
-        private ResponseEnvelope HandleQuarantineDelete(CommandEnvelope command, ShieldAIWorker worker)
+        private ResponseEnvelope HandleRealTime(CommandEnvelope command, ShieldAIWorker worker, bool enable)
         {
-            var request = command.GetPayload<QuarantineActionRequest>();
-            if (request == null)
-            {
-                return ResponseEnvelope.Fail(command.Id, "Invalid request");
-            }
-
-            var success = worker.QuarantineManager.DeleteFile(request.EntryId);
-            return success 
-                ? ResponseEnvelope.Ok(command.Id) 
-                : ResponseEnvelope.Fail(command.Id, "Failed to delete file");
+            worker.SetRealTimeProtection(enable);
+            return ResponseEnvelope.Ok(command.Id);
         }
 
         private async Task<ResponseEnvelope> HandleResolveThreatAsync(CommandEnvelope command, ShieldAIWorker worker)
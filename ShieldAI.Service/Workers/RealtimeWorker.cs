@@ -4,6 +4,7 @@
 // عامل المراقبة الفورية باستخدام Pipeline
 // =====================================================
 
+using System.Threading.Channels;
 using Microsoft.Extensions.Hosting;
 using Microsoft.Extensions.Logging;
 using ShieldAI.Core.Configuration;
@@ -11,6 +12,7 @@ using ShieldAI.Core.Contracts;
 using ShieldAI.Core.Detection;
 using ShieldAI.Core.Detection.ThreatScoring;
 using ShieldAI.Core.Logging;
+using ShieldAI.Core.Monitoring.EventSources;
 using ShieldAI.Core.Monitoring.Pipeline;
 using ShieldAI.Core.Monitoring.Quarantine;
 using ShieldAI.Core.Scanning;
@@ -28,17 +30,29 @@ namespace ShieldAI.Service.Workers
 
         private readonly FileEventQueue _eventQueue;
         private readonly EventCoalescer _coalescer;
+        private readonly MetadataPreGate _preGate;
         private readonly PipelineScanWorker _scanWorker;
         private readonly ThreatAggregator _aggregator;
+        private readonly ScanExecutor _executor;
         private readonly QuarantineStore _quarantineStore;
         private readonly ScanCache _scanCache;
         private readonly HeuristicEngine _heuristicEngine = new();
         private readonly AmsiEngine _amsiEngine = new();
         private readonly ThreatActionExecutor _actionExecutor;
+        private readonly QuarantineActionQueue _actionQueue;
+        private readonly bool _ownsActionQueue;
 
-        private readonly List<FileSystemWatcher> _watchers = new();
-        private readonly HashSet<string> _excludedExtensions;
-        private readonly HashSet<string> _excludedFolders;
+        // إجراءات التهديد: قناة محدودة بدلاً من async void لكل كشف
+        private Channel<AggregatedThreatResult>? _threatChannel;
+        private Task? _threatConsumer;
+        private long _threatHandoffsWaiting;
+        private long _threatHandoffOverflows;
+
+        private IFileEventSource? _eventSource;
+        private readonly OverflowRecovery? _overflowRecovery;
+        private readonly LoadSheddingPolicy _loadPolicy;
+        private readonly DeferredBacklog _backlog;
+        private long _lastLoadEvalMs;
 
         private bool _isRunning;
         private bool _disposed;
@@ -46,6 +60,11 @@ namespace ShieldAI.Service.Workers
         // الأحداث
         public event EventHandler<AggregatedThreatResult>? ThreatDetected;
 
+        /// <summary>
+        /// انتقال بين مستويات تخفيف الحمل
+        /// </summary>
+        public event EventHandler<LoadTierTransition>? LoadTierChanged;
+
         /// <summary>
         /// منفّذ إجراءات التهديد — للاشتراك في أحداثه من الخارج
         /// </summary>
@@ -54,15 +73,66 @@ namespace ShieldAI.Service.Workers
         public bool IsRunning => _isRunning;
         public int PendingCount => _eventQueue.PendingCount + _coalescer.PendingCount;
 
+        /// <summary>
+        /// اسم مصدر الأحداث الفعلي (fanotify / inotify / FileSystemWatcher)
+        /// </summary>
+        public string? EventSourceName => _eventSource?.Name;
+
+        /// <summary>
+        /// إحصائيات مسارات قائمة الأحداث
+        /// </summary>
+        public IReadOnlyList<FileEventLaneStats> GetQueueStats() => _eventQueue.GetLaneStats();
+
+        /// <summary>
+        /// عدد الأحداث المعلقة في التجميع / في انتظار جاهزية الملف / المُسقطة
+        /// </summary>
+        public int CoalescerPendingCount => _coalescer.PendingCount;
+        public int CoalescerRetryPendingCount => _coalescer.RetryPendingCount;
+        public long CoalescerDroppedCount => _coalescer.DroppedCount;
+
+        /// <summary>
+        /// عمليات الاستعادة بعد فيضان مصدر الأحداث والملفات المستعادة
+        /// </summary>
+        public long OverflowRecoveryCount => _overflowRecovery?.RecoveryCount ?? 0;
+        public long OverflowRecoveredFileCount => _overflowRecovery?.RecoveredFileCount ?? 0;
+
+        /// <summary>
+        /// مستوى تخفيف الحمل الحالي وزمن انتظار القائمة
+        /// </summary>
+        public LoadShedTier LoadTier => _loadPolicy.CurrentTier;
+        public double QueueLatencyMs => _scanWorker.QueueLatencyMs;
+
+        /// <summary>
+        /// الطابور الخلفي للأحداث المؤجلة في المستوى الحرج
+        /// </summary>
+        public int DeferredPendingCount => _backlog.PendingCount;
+        public long DeferredTotalCount => _backlog.DeferredCount;
+        public long DeferredDrainedCount => _backlog.DrainedCount;
+        public long DeferredOverflowCount => _backlog.OverflowCount;
+
+        /// <summary>
+        /// إجراءات تهديد تنتظر مكاناً في قناة الإجراءات الممتلئة / إجمالي مرات الامتلاء
+        /// </summary>
+        public long ThreatHandoffsWaiting => Interlocked.Read(ref _threatHandoffsWaiting);
+        public long ThreatHandoffOverflowCount => Interlocked.Read(ref _threatHandoffOverflows);
+
+        public IReadOnlyList<LoadTierTransition> GetLoadTransitions() => _loadPolicy.GetRecentTransitions();
+
         public RealtimeWorker(
             Microsoft.Extensions.Logging.ILogger logger,
             QuarantineStore quarantineStore,
-            SignatureDatabase? signatureDb = null)
+            SignatureDatabase? signatureDb = null,
+            ScanExecutor? executor = null,
+            QuarantineActionQueue? actionQueue = null)
         {
             _logger = logger;
             _settings = ConfigManager.Instance.Settings;
             _quarantineStore = quarantineStore;
+            _ownsActionQueue = actionQueue == null;
+            _actionQueue = actionQueue ?? new QuarantineActionQueue(
+                quarantineStore, QuarantineActionQueueOptions.FromSettings(_settings));
             _signatureDb = signatureDb ?? new SignatureDatabase();
+            _executor = executor ?? ScanExecutor.Shared;
 
             // إنشاء الأوزان من الإعدادات
             var weights = new EngineWeights
@@ -76,30 +146,52 @@ namespace ShieldAI.Service.Workers
 
             _scanCache = new ScanCache(
                 TimeSpan.FromMinutes(_settings.ScanCacheTtlMinutes),
-                _settings.ScanCacheMaxEntries);
+                _settings.ScanCacheMaxEntries,
+                _settings.ScanCacheMaxMegabytes * 1024L * 1024L);
             _aggregator = ThreatAggregator.CreateDefault(signatureDb, weights, _scanCache);
             _aggregator.BlockThreshold = _settings.BlockThreshold;
             _aggregator.QuarantineThreshold = _settings.QuarantineThreshold;
             _aggregator.ReviewThreshold = _settings.ReviewThreshold;
 
             // Pipeline
-            _eventQueue = new FileEventQueue(_settings.PipelineQueueCapacity);
-            _coalescer = new EventCoalescer(_eventQueue, _settings.EventCoalesceMs);
-            _scanWorker = new PipelineScanWorker(_eventQueue, _aggregator, logger);
+            _eventQueue = new FileEventQueue(FileEventQueueOptions.FromSettings(_settings));
+            _coalescer = new EventCoalescer(_eventQueue, _settings.EventCoalesceMs)
+            {
+                MaxReadinessRetries = _settings.CoalescerMaxRetries,
+                MaxRetryDelayMs = _settings.CoalescerMaxRetryDelayMs
+            };
+            _scanWorker = new PipelineScanWorker(_eventQueue, _aggregator, logger, _executor)
+            {
+                QuickGate = RunQuickGateAsync,
+                DeferFilter = TryDeferEvent
+            };
+            _preGate = new MetadataPreGate(_settings);
+
+            _loadPolicy = new LoadSheddingPolicy(LoadSheddingOptions.FromSettings(_settings));
+            _loadPolicy.TierChanged += OnLoadTierChanged;
+            _backlog = new DeferredBacklog(_settings.LoadShedBacklogCapacity);
+
+            if (_settings.EnableOverflowRecovery)
+            {
+                _overflowRecovery = new OverflowRecovery(
+                    path => HandleFileEvent(path, WatcherChangeTypes.Changed, null),
+                    logger,
+                    _settings.OverflowSnapshotMaxFiles,
+                    _settings.OverflowRecoveryDelayMs);
+            }
 
             // منفّذ الإجراءات
-            _actionExecutor = new ThreatActionExecutor(_quarantineStore, _settings, logger);
+            _actionExecutor = new ThreatActionExecutor(_quarantineStore, _settings, logger, _actionQueue);
 
             // ربط أحداث الفحص
             _scanWorker.ThreatDetected += OnThreatDetected;
 
-            _excludedExtensions = _settings.ExcludedExtensions
-                .Select(e => e.Trim().ToLowerInvariant())
-                .ToHashSet();
-
-            _excludedFolders = _settings.ExcludedFolders
-                .Select(f => f.Trim().ToLowerInvariant())
-                .ToHashSet();
+            // اللقطة تُحدَّث بعد الفحص فقط، والإزاحة من القائمة تُجدول مقارنة لمجلد الملف
+            if (_overflowRecovery != null)
+            {
+                _scanWorker.FileEventHandled += (_, path) => _overflowRecovery.Record(path);
+                _eventQueue.EventDropped += OnQueueEventDropped;
+            }
         }
 
         /// <summary>
@@ -111,36 +203,12 @@ namespace ShieldAI.Service.Workers
 
             var monitorPaths = paths?.ToList() ?? GetDefaultMonitorPaths();
 
-            foreach (var path in monitorPaths)
-            {
-                try
-                {
-                    if (!Directory.Exists(path)) continue;
-
-                    var watcher = new FileSystemWatcher(path)
-                    {
-                        IncludeSubdirectories = true,
-                        NotifyFilter = NotifyFilters.FileName |
-                                       NotifyFilters.LastWrite |
-                                       NotifyFilters.CreationTime,
-                        EnableRaisingEvents = false
-                    };
-
-                    watcher.Created += OnFileEvent;
-                    watcher.Changed += OnFileEvent;
-                    watcher.Renamed += OnFileRenamed;
-                    watcher.Error += OnWatcherError;
-
-                    watcher.EnableRaisingEvents = true;
-                    _watchers.Add(watcher);
-
-                    _logger.LogInformation("مراقبة: {Path}", path);
-                }
-                catch (Exception ex)
-                {
-                    _logger.LogError(ex, "فشل إنشاء watcher: {Path}", path);
-                }
-            }
+            _eventSource = FileEventSourceFactory.StartWithFallback(
+                _settings, monitorPaths, OnFileEvent, OnWatcherError, _logger);
+            _overflowRecovery?.Start(monitorPaths);
+
+            // مستهلكو إجراءات التهديد قبل عمال الفحص
+            StartThreatConsumers();
 
             // بدء عمال الفحص
             _scanWorker.Start(_settings.PipelineScanWorkers);
@@ -149,7 +217,8 @@ namespace ShieldAI.Service.Workers
             _scanWorker.AddQuarantinedPath(_settings.QuarantinePath);
 
             _isRunning = true;
-            _logger.LogInformation("بدأت المراقبة الفورية - {Count} مجلدات", _watchers.Count);
+            _logger.LogInformation("بدأت المراقبة الفورية - {Count} مجلدات ({Source})",
+                _eventSource.WatchedRootCount, _eventSource.Name);
         }
 
         /// <summary>
@@ -159,40 +228,77 @@ namespace ShieldAI.Service.Workers
         {
             if (!_isRunning) return;
 
-            foreach (var watcher in _watchers)
-            {
-                try
-                {
-                    watcher.EnableRaisingEvents = false;
-                    watcher.Dispose();
-                }
-                catch { }
-            }
-
-            _watchers.Clear();
+            StopEventSource();
+            _overflowRecovery?.Stop();
             _coalescer.Clear();
             await _scanWorker.StopAsync();
 
+            // عمال الفحص توقفوا - تصريف الإجراءات المعلقة (بما فيها المنتظرة لقناة ممتلئة)
+            while (Interlocked.Read(ref _threatHandoffsWaiting) > 0)
+                await Task.Delay(10);
+            _threatChannel?.Writer.TryComplete();
+            if (_threatConsumer != null)
+                await _threatConsumer;
+            _threatChannel = null;
+            _threatConsumer = null;
+
             _isRunning = false;
             _logger.LogInformation("توقفت المراقبة الفورية");
         }
 
-        private void OnFileEvent(object sender, FileSystemEventArgs e)
+        private void StopEventSource()
         {
-            _ = HandleFileEventAsync(e.FullPath, e.ChangeType);
+            if (_eventSource == null) return;
+
+            _eventSource.FileChanged -= OnFileEvent;
+            _eventSource.Error -= OnWatcherError;
+            try { _eventSource.Dispose(); } catch { }
+            _eventSource = null;
         }
 
-        private void OnFileRenamed(object sender, RenamedEventArgs e)
+        private void OnFileEvent(object? sender, FileEventSourceArgs e)
         {
-            _ = HandleFileEventAsync(e.FullPath, WatcherChangeTypes.Renamed);
+            HandleFileEvent(e.FullPath, e.ChangeType, e.OriginProcessId);
         }
 
-        private void OnWatcherError(object sender, ErrorEventArgs e)
+        private void OnWatcherError(object? sender, ErrorEventArgs e)
         {
-            _logger.LogError(e.GetException(), "خطأ في FileSystemWatcher");
+            var ex = e.GetException();
+
+            // فيضان: الأحداث المفقودة تُستعاد بمقارنة لقطة الشجرة المتأثرة
+            if (_overflowRecovery?.HandleError(sender, ex) == true)
+            {
+                _logger.LogWarning("فيضان في مصدر الأحداث {Source} - جدولة استعادة: {Message}",
+                    _eventSource?.Name, ex.Message);
+                return;
+            }
+
+            _logger.LogError(ex, "خطأ في مصدر الأحداث {Source}", _eventSource?.Name);
         }
 
-        private async void OnThreatDetected(object? sender, AggregatedThreatResult result)
+        private void OnQueueEventDropped(object? sender, FileEvent fileEvent)
+        {
+            var directory = Path.GetDirectoryName(fileEvent.FilePath);
+            if (!string.IsNullOrEmpty(directory))
+                _overflowRecovery?.ScheduleRecovery(directory);
+        }
+
+        private void StartThreatConsumers()
+        {
+            var channel = Channel.CreateBounded<AggregatedThreatResult>(
+                new BoundedChannelOptions(Math.Max(1, _settings.QuarantineQueueCapacity))
+                {
+                    FullMode = BoundedChannelFullMode.Wait
+                });
+
+            _threatChannel = channel;
+            _threatConsumer = Parallel.ForEachAsync(
+                channel.Reader.ReadAllAsync(),
+                new ParallelOptions { MaxDegreeOfParallelism = Math.Max(1, _settings.ThreatActionWorkers) },
+                async (result, _) => await ApplyThreatActionAsync(result).ConfigureAwait(false));
+        }
+
+        private void OnThreatDetected(object? sender, AggregatedThreatResult result)
         {
             ThreatDetected?.Invoke(this, result);
 
@@ -200,6 +306,35 @@ namespace ShieldAI.Service.Workers
             if (result.Verdict == AggregatedVerdict.Allow)
                 return;
 
+            var channel = _threatChannel;
+            if (channel == null)
+                return;
+
+            // القناة ممتلئة: الكتابة تنتظر بشكل غير متزامن ولا تحجب خيط عامل الفحص
+            if (!channel.Writer.TryWrite(result))
+                _ = HandOffThreatWhenFullAsync(channel, result);
+        }
+
+        private async Task HandOffThreatWhenFullAsync(Channel<AggregatedThreatResult> channel, AggregatedThreatResult result)
+        {
+            Interlocked.Increment(ref _threatHandoffOverflows);
+            Interlocked.Increment(ref _threatHandoffsWaiting);
+            try
+            {
+                await channel.Writer.WriteAsync(result).ConfigureAwait(false);
+            }
+            catch (ChannelClosedException)
+            {
+                _logger.LogWarning("تجاهل إجراء تهديد بعد إيقاف المراقبة: {File}", result.FilePath);
+            }
+            finally
+            {
+                Interlocked.Decrement(ref _threatHandoffsWaiting);
+            }
+        }
+
+        private async Task ApplyThreatActionAsync(AggregatedThreatResult result)
+        {
             try
             {
                 var context = _aggregator.BuildContext(result.FilePath);
@@ -216,35 +351,48 @@ namespace ShieldAI.Service.Workers
             }
         }
 
-        private async Task HandleFileEventAsync(string filePath, WatcherChangeTypes changeType)
+        /// <summary>
+        /// وقت الحدث: فرز بالبيانات الوصفية فقط ثم التجميع.
+        /// Quick Gate الكامل (hash + PE) يعمل لاحقاً مرة واحدة لكل ملف مجمّع وللمحتوى التنفيذي فقط.
+        /// </summary>
+        private void HandleFileEvent(string filePath, WatcherChangeTypes changeType, int? originProcessId)
         {
-            if (!ShouldProcess(filePath)) return;
+            var decision = _preGate.Evaluate(filePath);
+            if (decision == PreGateDecision.Skip) return;
 
-            UpdatePressureMode();
+            // تقييم خفيف من مسار الحدث (مرة كل 100ms على الأكثر) - التقييم الدوري في ShieldAIWorker
+            var now = Environment.TickCount64;
+            var last = Interlocked.Read(ref _lastLoadEvalMs);
+            if (now - last >= 100 && Interlocked.CompareExchange(ref _lastLoadEvalMs, now, last) == last)
+                EvaluateLoad();
 
+            _coalescer.Add(filePath, changeType, decision == PreGateDecision.QuickGate, originProcessId);
+        }
+
+        /// <summary>
+        /// Quick Gate على السياق المبني في PipelineScanWorker
+        /// </summary>
+        private async Task<bool> RunQuickGateAsync(ThreatScanContext context, CancellationToken ct)
+        {
             try
             {
-                var quickGateScore = await GetQuickGateScoreAsync(filePath).ConfigureAwait(false);
+                var quickGateScore = await GetQuickGateScoreAsync(context).ConfigureAwait(false);
                 if (quickGateScore >= _settings.QuickGateSuspiciousScore)
                 {
-                    await TryAtomicQuarantineAsync(filePath, quickGateScore).ConfigureAwait(false);
-                    return;
+                    await TryAtomicQuarantineAsync(context.FilePath, quickGateScore).ConfigureAwait(false);
+                    return true;
                 }
             }
             catch (Exception ex)
             {
-                _logger.LogDebug(ex, "فشل Quick Gate: {File}", filePath);
+                _logger.LogDebug(ex, "فشل Quick Gate: {File}", context.FilePath);
             }
 
-            _coalescer.Add(filePath, changeType);
+            return false;
         }
 
-        private async Task<int> GetQuickGateScoreAsync(string filePath)
+        private async Task<int> GetQuickGateScoreAsync(ThreatScanContext context)
         {
-            if (!File.Exists(filePath))
-                return 0;
-
-            var context = _aggregator.BuildContext(filePath);
             var engines = new IThreatEngine[]
             {
                 new SignatureEngine(_signatureDb),
@@ -294,51 +442,79 @@ namespace ShieldAI.Service.Workers
 
             if (_settings.AutoQuarantine)
             {
-                var entry = await _quarantineStore.QuarantineMovedFileAsync(movedPath, filePath, result)
+                var outcome = await _actionQueue.QuarantineAsync(new QuarantineRequest(movedPath, filePath, result))
                     .ConfigureAwait(false);
 
                 ScanDiagnosticLog.LogScanResult(
                     _logger, correlationId, context, result,
                     policyDecision: $"QuickGate={quickGateScore}",
                     quarantineAttempted: true,
-                    quarantineSuccess: entry != null);
+                    quarantineSuccess: outcome.Success);
 
-                if (entry != null)
+                if (outcome.Success)
                 {
                     ThreatDetected?.Invoke(this, result);
                 }
             }
         }
 
-        private bool ShouldProcess(string filePath)
+        /// <summary>
+        /// تقييم مستوى تخفيف الحمل من عمق الطابور وزمن الانتظار،
+        /// وإعادة الأحداث المؤجلة تدريجياً بعد النزول إلى Elevated أو أقل
+        /// </summary>
+        public LoadShedTier EvaluateLoad()
         {
-            try
-            {
-                var ext = Path.GetExtension(filePath).TrimStart('.').ToLowerInvariant();
-                if (_excludedExtensions.Contains(ext))
-                    return false;
+            var tier = _loadPolicy.Evaluate(PendingCount, _scanWorker.QueueLatencyMs);
 
-                var dirName = Path.GetDirectoryName(filePath)?.ToLowerInvariant() ?? "";
-                foreach (var excluded in _excludedFolders)
+            if (tier <= LoadShedTier.Elevated && _backlog.PendingCount > 0 &&
+                _eventQueue.PendingCount < _settings.LoadShedElevatedDepth)
+            {
+                var drained = _backlog.Drain(e => _eventQueue.TryEnqueue(e), _settings.LoadShedDrainBatch);
+                if (drained > 0)
                 {
-                    if (dirName.Contains(excluded))
-                        return false;
+                    _logger.LogDebug("تخفيف الحمل: إعادة {Count} حدث مؤجل (المتبقي {Remaining})",
+                        drained, _backlog.PendingCount);
                 }
+            }
 
-                if (filePath.Contains(_settings.QuarantinePath, StringComparison.OrdinalIgnoreCase))
-                    return false;
+            return tier;
+        }
 
-                return true;
-            }
-            catch
-            {
+        /// <summary>
+        /// المستوى الحرج: غير التنفيذيات (ليست في المسار العالي ولا تحتاج Quick Gate) تذهب للطابور الخلفي
+        /// </summary>
+        private bool TryDeferEvent(FileEvent fileEvent)
+        {
+            if (!LoadSheddingPolicy.DefersNonExecutables(_loadPolicy.CurrentTier))
                 return false;
-            }
+
+            if (fileEvent.RequiresQuickGate || FileEventQueue.Classify(fileEvent) == FileEventLane.High)
+                return false;
+
+            return _backlog.TryDefer(fileEvent);
         }
 
-        private void UpdatePressureMode()
+        private void OnLoadTierChanged(object? sender, LoadTierTransition transition)
         {
-            _aggregator.HighPressureMode = PendingCount >= _settings.PipelineHighPressureThreshold;
+            _coalescer.WindowMultiplier = LoadSheddingPolicy.CoalesceMultiplier(transition.To);
+            _aggregator.HighPressureMode = LoadSheddingPolicy.SkipsHeavyEngines(transition.To);
+
+            if (transition.To > transition.From)
+            {
+                _logger.LogWarning(
+                    "تخفيف الحمل: {From} -> {To} (الطابور {Pending}، الانتظار {Latency:F0}ms، التجميع {Window}ms)",
+                    transition.From, transition.To, transition.PendingEvents, transition.QueueLatencyMs,
+                    _coalescer.EffectiveCoalesceMs);
+            }
+            else
+            {
+                _logger.LogInformation(
+                    "تخفيف الحمل: {From} -> {To} (الطابور {Pending}، الانتظار {Latency:F0}ms، مؤجل {Deferred})",
+                    transition.From, transition.To, transition.PendingEvents, transition.QueueLatencyMs,
+                    _backlog.PendingCount);
+            }
+
+            LoadTierChanged?.Invoke(this, transition);
         }
 
         private static List<string> GetDefaultMonitorPaths()
@@ -363,14 +539,16 @@ namespace ShieldAI.Service.Workers
             if (_disposed) return;
             _disposed = true;
 
-            foreach (var w in _watchers)
-            {
-                try { w.Dispose(); } catch { }
-            }
+            StopEventSource();
+            _overflowRecovery?.Dispose();
 
             _coalescer.Dispose();
             _eventQueue.Dispose();
             _scanWorker.Dispose();
+
+            _threatChannel?.Writer.TryComplete();
+            if (_ownsActionQueue)
+                _actionQueue.Dispose();
         }
     }
 }
@@ -22,12 +22,14 @@ namespace ShieldAI.Service.Workers
         private readonly ILogger _logger;
         private readonly AppSettings _settings;
         private readonly ThreatAggregator _aggregator;
+        private readonly ArchiveScanner _archiveScanner;
         private readonly FileEnumerator _fileEnumerator;
         private readonly QuarantineStore _quarantineStore;
-        private readonly SemaphoreSlim _scanSemaphore;
+        private readonly ScanExecutor _executor;
         private readonly ScanCache _scanCache;
 
         private ScanJob? _currentJob;
+        private ScanProgressPublisher? _progressPublisher;
         private CancellationTokenSource? _currentCts;
         private bool _disposed;
 
@@ -42,7 +44,8 @@ namespace ShieldAI.Service.Workers
         public ScanWorkerService(
             ILogger logger,
             QuarantineStore quarantineStore,
-            SignatureDatabase? signatureDb = null)
+            SignatureDatabase? signatureDb = null,
+            ScanExecutor? executor = null)
         {
             _logger = logger;
             _settings = ConfigManager.Instance.Settings;
@@ -59,10 +62,10 @@ namespace ShieldAI.Service.Workers
 
             _scanCache = new ScanCache(TimeSpan.FromMinutes(_settings.ScanCacheTtlMinutes));
             _aggregator = ThreatAggregator.CreateDefault(signatureDb, weights, _scanCache);
+            _archiveScanner = new ArchiveScanner(_aggregator, ArchiveScanLimits.FromSettings(_settings), _logger);
             _fileEnumerator = new FileEnumerator(_logger);
 
-            int maxParallelism = Math.Min(Environment.ProcessorCount, 4);
-            _scanSemaphore = new SemaphoreSlim(maxParallelism, maxParallelism);
+            _executor = executor ?? ScanExecutor.Shared;
         }
 
         /// <summary>
@@ -72,7 +75,9 @@ namespace ShieldAI.Service.Workers
             IEnumerable<string> paths,
             ScanType scanType = ScanType.Custom,
             bool deepScan = true,
-            CancellationToken externalToken = default)
+            CancellationToken externalToken = default,
+            ScanPriorityClass priority = ScanPriorityClass.OnDemand,
+            bool scanArchives = false)
         {
             if (IsScanning)
                 throw new InvalidOperationException("فحص آخر قيد التنفيذ");
@@ -85,6 +90,7 @@ namespace ShieldAI.Service.Workers
                 Paths = paths.ToList(),
                 Type = scanType,
                 DeepScan = deepScan,
+                ScanArchives = scanArchives,
                 Status = ScanStatus.Running,
                 StartedAt = DateTime.Now
             };
@@ -96,6 +102,15 @@ namespace ShieldAI.Service.Workers
                 StartTime = DateTime.Now
             };
 
+            var job = _currentJob;
+            var publisher = new ScanProgressPublisher(
+                job,
+                args => ScanProgress?.Invoke(this, args),
+                TimeSpan.FromMilliseconds(_settings.ScanProgressIntervalMs));
+            _progressPublisher = publisher;
+            long bytesScanned = 0;
+            int threatsFound = 0;
+
             try
             {
                 _logger.LogInformation("بدء فحص: {Type} - {Paths}",
@@ -110,63 +125,49 @@ namespace ShieldAI.Service.Workers
 
                 _currentJob.TotalFiles = files.Count;
                 report.TotalFiles = files.Count;
-                RaiseProgress();
+                publisher.PublishNow();
 
-                // فحص الملفات بالتوازي
+                // فحص الملفات بالتوازي عبر المنفذ المشترك (ملف = عنصر عمل) ضمن نافذة إرسال محدودة
+                var window = new ScanSubmissionWindow(_executor);
                 var tasks = new List<Task>();
 
                 foreach (var file in files)
                 {
                     if (ct.IsCancellationRequested) break;
 
-                    await _scanSemaphore.WaitAsync(ct);
-
-                    tasks.Add(Task.Run(async () =>
+                    tasks.Add(await window.SubmitAsync(() => _executor.RunAsync(priority, async token =>
                     {
-                        try
+                        var result = await _aggregator.ScanAsync(file.FullName, token);
+
+                        // عناصر الأرشيف تُفحص من الذاكرة ويُنسب أخطرها للأرشيف
+                        if (job.ScanArchives && ArchiveScanner.DetectFormat(file.FullName) != ArchiveFormat.None)
                         {
-                            var result = await _aggregator.ScanAsync(file.FullName, ct);
+                            var archive = await _archiveScanner.ScanAsync(file.FullName, token);
+                            result = MergeArchiveResult(file.FullName, result, archive);
+                        }
 
-                            lock (_currentJob)
-                            {
-                                _currentJob.ScannedFiles++;
-                                _currentJob.CurrentFile = file.Name;
-                            }
+                        job.IncrementScannedFiles();
+                        job.CurrentFile = file.Name;
+                        Interlocked.Add(ref bytesScanned, file.Length);
 
-                            lock (report)
-                            {
-                                report.TotalBytesScanned += file.Length;
-                            }
+                        if (result.Verdict != AggregatedVerdict.Allow)
+                        {
+                            job.IncrementThreatsFound();
+                            Interlocked.Increment(ref threatsFound);
+
+                            ThreatDetected?.Invoke(this, result);
 
-                            if (result.Verdict != AggregatedVerdict.Allow)
+                            // الحجر التلقائي
+                            if (_settings.AutoQuarantine &&
+                                (result.Verdict == AggregatedVerdict.Block ||
+                                 result.Verdict == AggregatedVerdict.Quarantine))
                             {
-                                lock (_currentJob)
-                                {
-                                    _currentJob.ThreatsFound++;
-                                }
-                                lock (report)
-                                {
-                                    report.ThreatsFound++;
-                                }
-
-                                ThreatDetected?.Invoke(this, result);
-
-                                // الحجر التلقائي
-                                if (_settings.AutoQuarantine &&
-                                    (result.Verdict == AggregatedVerdict.Block ||
-                                     result.Verdict == AggregatedVerdict.Quarantine))
-                                {
-                                    await _quarantineStore.QuarantineFileAsync(file.FullName, result);
-                                }
+                                await _quarantineStore.QuarantineFileAsync(file.FullName, result);
                             }
-
-                            RaiseProgress();
                         }
-                        finally
-                        {
-                            _scanSemaphore.Release();
-                        }
-                    }, ct));
+
+                        publisher.MarkDirty();
+                    }, ct), ct));
                 }
 
                 await Task.WhenAll(tasks);
@@ -191,6 +192,12 @@ namespace ShieldAI.Service.Workers
                 report.EndTime = DateTime.Now;
                 report.FinalStatus = _currentJob.Status;
                 report.ScannedFiles = _currentJob.ScannedFiles;
+                report.TotalBytesScanned = Interlocked.Read(ref bytesScanned);
+                report.ThreatsFound = Volatile.Read(ref threatsFound);
+
+                publisher.Dispose();
+                publisher.PublishNow();
+                _progressPublisher = null;
 
                 ScanCompleted?.Invoke(this, report);
 
@@ -205,27 +212,48 @@ namespace ShieldAI.Service.Workers
         }
 
         /// <summary>
-        /// إيقاف الفحص الحالي
+        /// رفع حكم الأرشيف إلى حكم أخطر عنصر فيه (النتائج الأصلية قد تكون من الكاش فلا تُعدَّل)
         /// </summary>
-        public void StopScan()
+        private static AggregatedThreatResult MergeArchiveResult(
+            string archivePath, AggregatedThreatResult result, ArchiveScanResult archive)
         {
-            _currentCts?.Cancel();
+            var worst = archive.WorstEntry;
+            var verdict = worst?.Result.Verdict
+                ?? (archive.BombDetected || archive.HasUnscannedContent ? AggregatedVerdict.NeedsReview : AggregatedVerdict.Allow);
+
+            if (VerdictRank(verdict) <= VerdictRank(result.Verdict))
+                return result;
+
+            return new AggregatedThreatResult
+            {
+                FilePath = archivePath,
+                CorrelationId = result.CorrelationId,
+                Verdict = verdict,
+                RiskScore = Math.Max(result.RiskScore, worst?.Result.RiskScore ?? 0),
+                Reasons = worst != null
+                    ? worst.Result.Reasons.Select(r => $"{worst.EntryPath}: {r}").ToList()
+                    : archive.BombDetected
+                        ? new List<string> { archive.LimitReason ?? "قنبلة ضغط محتملة" }
+                        : archive.UnscannedEntries.Select(e => e.Reason).ToList(),
+                EngineResults = worst?.Result.EngineResults ?? new List<ThreatScanResult>(),
+                Duration = result.Duration
+            };
         }
 
-        private void RaiseProgress()
+        private static int VerdictRank(AggregatedVerdict verdict) => verdict switch
         {
-            if (_currentJob == null) return;
+            AggregatedVerdict.Block => 3,
+            AggregatedVerdict.Quarantine => 2,
+            AggregatedVerdict.NeedsReview => 1,
+            _ => 0
+        };
 
-            ScanProgress?.Invoke(this, new ScanProgressEventArgs
-            {
-                JobId = _currentJob.Id,
-                TotalFiles = _currentJob.TotalFiles,
-                ScannedFiles = _currentJob.ScannedFiles,
-                ThreatsFound = _currentJob.ThreatsFound,
-                CurrentFile = _currentJob.CurrentFile,
-                ProgressPercent = _currentJob.ProgressPercent,
-                Status = _currentJob.Status
-            });
+        /// <summary>
+        /// إيقاف الفحص الحالي
+        /// </summary>
+        public void StopScan()
+        {
+            _currentCts?.Cancel();
         }
 
         public void Dispose()
@@ -234,7 +262,7 @@ namespace ShieldAI.Service.Workers
             _disposed = true;
             _currentCts?.Cancel();
             _currentCts?.Dispose();
-            _scanSemaphore.Dispose();
+            _progressPublisher?.Dispose();
         }
     }
 
@@ -0,0 +1,664 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Service/Workers/ShardCoordinator.cs
+// منسق الفحص الموزّع على عدة عمليات
+// =====================================================
+
+using System.Collections.Concurrent;
+using Microsoft.Extensions.Logging;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Contracts;
+using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
+using ShieldAI.Service.Ipc;
+
+namespace ShieldAI.Service.Workers
+{
+    /// <summary>
+    /// منسق الفحص الموزّع - يقسم المهمة إلى أجزاء حسب شجرة المجلدات ويوزعها
+    /// على N عملية عامل عبر الـ pipe، ويدمج التقدم والنتائج، ويعيد إرسال
+    /// الجزء لعامل جديد إذا انهار العامل. نقطة الاستئناف = خطة الأجزاء + المكتمل منها.
+    /// </summary>
+    public class ShardCoordinator : IDisposable
+    {
+        private readonly ILogger? _logger;
+        private readonly AppSettings _settings;
+        private readonly Func<int, int, IShardWorker> _workerFactory;
+        private readonly ScanExecutor _executor;
+        private readonly ScanCheckpointStore? _checkpointStore;
+        private readonly ConcurrentDictionary<Guid, ScanJob> _activeJobs = new();
+        private readonly ConcurrentDictionary<Guid, CancellationTokenSource> _cancellationTokens = new();
+        private readonly ConcurrentDictionary<Guid, byte> _userStopped = new();
+        private bool _disposed;
+
+        // الأحداث - نفس أحداث ScanOrchestrator
+        public event EventHandler<ScanProgressEventArgs>? ScanProgress;
+        public event EventHandler<ThreatDetectedEventArgs>? ThreatDetected;
+        public event EventHandler<ScanCompletedEventArgs>? ScanCompleted;
+
+        /// <summary>
+        /// عدد عمليات العمال
+        /// </summary>
+        public int WorkerCount { get; }
+
+        /// <summary>
+        /// فترة استعلام تقدم العمال
+        /// </summary>
+        public TimeSpan PollInterval { get; set; }
+
+        /// <summary>
+        /// أقصى عدد محاولات للجزء الواحد قبل اعتباره فاشلاً
+        /// </summary>
+        public int MaxShardAttempts { get; set; }
+
+        /// <param name="workerFactory">(رقم الخانة، عدد خيوط الفحص) → عامل. الافتراضي: عملية منفصلة</param>
+        /// <param name="executor">منفذ الخدمة - مصدر ميزانية خيوط العمال (الافتراضي: المشترك)</param>
+        /// <param name="checkpointStore">مخزن نقاط الاستئناف (الافتراضي: من الإعدادات)</param>
+        public ShardCoordinator(
+            ILogger? logger = null,
+            int workerCount = 0,
+            Func<int, int, IShardWorker>? workerFactory = null,
+            ScanExecutor? executor = null,
+            ScanCheckpointStore? checkpointStore = null)
+        {
+            _logger = logger;
+            _settings = ConfigManager.Instance.Settings;
+            _workerFactory = workerFactory ?? ((slot, concurrency) => new ShardWorkerProcess(slot, concurrency));
+            _executor = executor ?? ScanExecutor.Shared;
+            _checkpointStore = checkpointStore ?? CreateCheckpointStore();
+
+            WorkerCount = workerCount > 0
+                ? workerCount
+                : _settings.ShardWorkerCount > 0
+                    ? _settings.ShardWorkerCount
+                    : Math.Max(2, Environment.ProcessorCount / 4);
+
+            PollInterval = TimeSpan.FromMilliseconds(Math.Max(50, _settings.ShardPollIntervalMs));
+            MaxShardAttempts = Math.Max(1, _settings.ShardMaxAttempts);
+        }
+
+        /// <summary>
+        /// هل يجب توزيع هذه المهمة على عدة عمليات
+        /// </summary>
+        public bool ShouldShard(ScanJob job) =>
+            _settings.EnableShardedScans && job.Type == ScanType.Full;
+
+        /// <summary>
+        /// تنفيذ مهمة فحص موزّعة
+        /// </summary>
+        public Task<ScanReport> ExecuteScanJobAsync(
+            ScanJob job,
+            CancellationToken externalToken = default,
+            ScanPriorityClass priority = ScanPriorityClass.OnDemand)
+        {
+            return ExecuteScanJobAsync(job, null, externalToken, priority);
+        }
+
+        /// <summary>
+        /// استئناف فحص موزّع منقطع: الأجزاء المكتملة لا تُرسل مرة أخرى
+        /// </summary>
+        public async Task<ScanReport?> ResumeScanAsync(Guid jobId, CancellationToken externalToken = default)
+        {
+            if (_activeJobs.ContainsKey(jobId))
+                throw new InvalidOperationException("الفحص قيد التنفيذ بالفعل");
+
+            var checkpoint = _checkpointStore?.TryLoad(jobId);
+            if (checkpoint?.Shards == null)
+            {
+                _logger?.LogWarning("لا توجد نقطة استئناف موزّعة للفحص: {JobId}", jobId);
+                return null;
+            }
+
+            var job = new ScanJob
+            {
+                Id = checkpoint.JobId,
+                Paths = checkpoint.Paths,
+                Type = checkpoint.Type,
+                UseVirusTotal = checkpoint.UseVirusTotal,
+                DeepScan = checkpoint.DeepScan,
+                ScanArchives = checkpoint.ScanArchives,
+                ScanHiddenFiles = checkpoint.ScanHiddenFiles,
+                MaxDepth = checkpoint.MaxDepth,
+                Status = ScanStatus.Pending
+            };
+
+            _logger?.LogInformation("استئناف الفحص الموزّع: {JobId} - {Completed}/{Shards} جزء مكتمل",
+                jobId, checkpoint.CompletedShards.Count, checkpoint.Shards.Count);
+
+            return await ExecuteScanJobAsync(job, checkpoint, externalToken, checkpoint.Priority);
+        }
+
+        /// <summary>
+        /// الفحوصات الموزّعة المنقطعة القابلة للاستئناف
+        /// </summary>
+        public IReadOnlyList<ScanCheckpoint> GetResumableScans()
+        {
+            if (_checkpointStore == null)
+                return Array.Empty<ScanCheckpoint>();
+
+            return _checkpointStore.GetAll()
+                .Where(c => c.Shards != null && !_activeJobs.ContainsKey(c.JobId))
+                .ToList();
+        }
+
+        private async Task<ScanReport> ExecuteScanJobAsync(
+            ScanJob job,
+            ScanCheckpoint? resumeFrom,
+            CancellationToken externalToken,
+            ScanPriorityClass priority)
+        {
+            var cts = CancellationTokenSource.CreateLinkedTokenSource(externalToken);
+            _cancellationTokens[job.Id] = cts;
+            _activeJobs[job.Id] = job;
+
+            var publisher = new ScanProgressPublisher(
+                job,
+                args => ScanProgress?.Invoke(this, args),
+                TimeSpan.FromMilliseconds(_settings.ScanProgressIntervalMs));
+
+            var report = new ScanReport
+            {
+                JobId = job.Id,
+                ScanType = job.Type,
+                StartTime = DateTime.Now
+            };
+
+            try
+            {
+                job.Status = ScanStatus.Running;
+                job.StartedAt = DateTime.Now;
+
+                // الخطة المحفوظة تُستخدم كما هي: معرفات الأجزاء المكتملة تبقى صالحة
+                var shards = resumeFrom?.Shards ?? ScanShardPlanner.Plan(
+                    job.Paths,
+                    WorkerCount * Math.Max(1, _settings.ShardsPerWorker),
+                    job.MaxDepth,
+                    job.ScanHiddenFiles);
+
+                var run = new ShardRun(job, shards, report, publisher, resumeFrom);
+
+                // ميزانية الخيوط من منفذ الخدمة حسب فئة الأولوية - العمال لا يمسون خانات الفحص الفوري
+                int slots = Math.Min(WorkerCount, Math.Max(1, run.PendingCount));
+                int concurrency = Math.Max(1, _executor.GetClassBudget(priority) / slots);
+
+                _logger?.LogInformation("فحص موزّع: {JobId} - {Shards} جزء على {Workers} عامل × {Concurrency} خيط",
+                    job.Id, run.PendingCount, slots, concurrency);
+
+                publisher.PublishNow();
+
+                try
+                {
+                    await Task.WhenAll(Enumerable.Range(0, slots)
+                        .Select(slot => RunSlotAsync(slot, concurrency, run, priority, cts.Token)));
+                }
+                finally
+                {
+                    // نقطة الاستئناف تبقى لإيقاف الخدمة فقط - إيقاف المستخدم ينهي الفحص نهائياً
+                    if (_checkpointStore != null)
+                    {
+                        if (cts.Token.IsCancellationRequested && !_userStopped.ContainsKey(job.Id))
+                            SaveCheckpoint(run, priority);
+                        else
+                            _checkpointStore.Delete(job.Id);
+                    }
+                }
+
+                job.Status = cts.Token.IsCancellationRequested
+                    ? ScanStatus.Cancelled
+                    : ScanStatus.Completed;
+            }
+            catch (OperationCanceledException)
+            {
+                job.Status = ScanStatus.Cancelled;
+            }
+            catch (Exception ex)
+            {
+                job.Status = ScanStatus.Failed;
+                report.Errors.Add(ex.Message);
+                _logger?.LogError(ex, "خطأ في الفحص الموزّع: {JobId}", job.Id);
+            }
+            finally
+            {
+                job.CompletedAt = DateTime.Now;
+
+                report.EndTime = DateTime.Now;
+                report.FinalStatus = job.Status;
+                report.TotalFiles = job.TotalFiles;
+                report.ScannedFiles = job.ScannedFiles;
+                report.ThreatsFound = job.ThreatsFound;
+                report.ErrorCount = job.ErrorCount;
+
+                publisher.Dispose();
+                publisher.PublishNow();
+
+                _activeJobs.TryRemove(job.Id, out _);
+                _userStopped.TryRemove(job.Id, out _);
+                _cancellationTokens.TryRemove(job.Id, out _);
+                cts.Dispose();
+
+                ScanCompleted?.Invoke(this, new ScanCompletedEventArgs { Report = report });
+            }
+
+            return report;
+        }
+
+        /// <summary>
+        /// خانة عامل: تسحب الأجزاء من الطابور حتى تنتهي كلها
+        /// </summary>
+        private async Task RunSlotAsync(
+            int slot,
+            int concurrency,
+            ShardRun run,
+            ScanPriorityClass priority,
+            CancellationToken ct)
+        {
+            IShardWorker? worker = null;
+
+            try
+            {
+                while (run.HasRemaining)
+                {
+                    ct.ThrowIfCancellationRequested();
+
+                    // جزء قد يعود للطابور إذا انهار عامل آخر
+                    if (!run.Pending.TryDequeue(out var shard))
+                    {
+                        await Task.Delay(PollInterval, ct);
+                        continue;
+                    }
+
+                    try
+                    {
+                        if (worker == null || !worker.IsAlive)
+                        {
+                            worker?.Dispose();
+                            worker = _workerFactory(slot, concurrency);
+                            await worker.StartAsync(ct);
+                        }
+
+                        await RunShardAsync(worker, shard, run, priority, ct);
+                        run.Complete(shard);
+                        SaveCheckpoint(run, priority);
+                    }
+                    catch (OperationCanceledException) when (ct.IsCancellationRequested)
+                    {
+                        throw;
+                    }
+                    catch (Exception ex)
+                    {
+                        worker?.Dispose();
+                        worker = null;
+
+                        // التقدم الجزئي يُلغى - الجزء سيُفحص من جديد
+                        run.ResetProgress(shard.Id);
+
+                        if (run.RecordAttempt(shard.Id) < MaxShardAttempts)
+                        {
+                            _logger?.LogWarning("انهار عامل الخانة {Slot} أثناء الجزء {Shard}، إعادة الإرسال: {Error}",
+                                slot, shard, ex.Message);
+                            run.Pending.Enqueue(shard);
+                        }
+                        else
+                        {
+                            _logger?.LogError("فشل الجزء {Shard} بعد {Attempts} محاولات: {Error}",
+                                shard, MaxShardAttempts, ex.Message);
+                            run.Fail(shard, ex.Message);
+                        }
+                    }
+                }
+            }
+            finally
+            {
+                if (worker != null)
+                {
+                    await ShutdownWorkerAsync(worker);
+                    worker.Dispose();
+                }
+            }
+        }
+
+        /// <summary>
+        /// إرسال جزء لعامل ومتابعة تقدمه حتى النهاية
+        /// </summary>
+        private async Task RunShardAsync(
+            IShardWorker worker,
+            ScanShard shard,
+            ShardRun run,
+            ScanPriorityClass priority,
+            CancellationToken ct)
+        {
+            var job = run.Job;
+            var request = new ScanShardRequest
+            {
+                ShardId = shard.Id,
+                JobId = job.Id,
+                Path = shard.Path,
+                MaxDepth = shard.MaxDepth,
+                ScanType = job.Type,
+                UseVirusTotal = job.UseVirusTotal,
+                DeepScan = job.DeepScan,
+                ScanArchives = job.ScanArchives,
+                ScanHiddenFiles = job.ScanHiddenFiles,
+                Priority = (int)priority
+            };
+
+            var accepted = await worker.SendAsync(CommandEnvelope.Create(Commands.ScanShard, request), ct);
+            if (!accepted.Success)
+                throw new InvalidOperationException(accepted.Error ?? "رفض العامل الجزء");
+
+            while (true)
+            {
+                await Task.Delay(PollInterval, ct);
+
+                var response = await worker.SendAsync(CommandEnvelope.Create(Commands.GetShardProgress), ct);
+                var progress = response.Success ? response.GetPayload<ShardProgressResponse>() : null;
+                if (progress == null)
+                    throw new InvalidOperationException(response.Error ?? "رد تقدم غير صالح");
+
+                foreach (var threat in run.Update(shard.Id, progress))
+                {
+                    ThreatDetected?.Invoke(this, new ThreatDetectedEventArgs
+                    {
+                        JobId = job.Id,
+                        Result = threat
+                    });
+                }
+
+                if (progress.IsFinal)
+                {
+                    if (progress.Status == ScanStatus.Failed)
+                        throw new InvalidOperationException($"فشل العامل في فحص {shard.Path}");
+                    return;
+                }
+            }
+        }
+
+        /// <summary>
+        /// حفظ خطة الأجزاء والمكتمل منها (بعد كل جزء، وعند الإلغاء)
+        /// </summary>
+        private void SaveCheckpoint(ShardRun run, ScanPriorityClass priority)
+        {
+            if (_checkpointStore == null)
+                return;
+
+            try
+            {
+                lock (run.CheckpointLock)
+                {
+                    _checkpointStore.Save(run.CreateCheckpoint(priority));
+                }
+            }
+            catch (Exception ex)
+            {
+                _logger?.LogWarning("تعذر حفظ نقطة استئناف الفحص الموزّع: {Error}", ex.Message);
+            }
+        }
+
+        private ScanCheckpointStore? CreateCheckpointStore()
+        {
+            if (!_settings.EnableScanCheckpoints)
+                return null;
+
+            try
+            {
+                return ScanCheckpointStore.FromSettings(_settings);
+            }
+            catch (Exception ex)
+            {
+                _logger?.LogWarning("تعذر تهيئة مخزن نقاط الاستئناف: {Error}", ex.Message);
+                return null;
+            }
+        }
+
+        private static async Task ShutdownWorkerAsync(IShardWorker worker)
+        {
+            if (!worker.IsAlive) return;
+
+            try
+            {
+                using var timeout = new CancellationTokenSource(TimeSpan.FromSeconds(2));
+                await worker.SendAsync(CommandEnvelope.Create(Commands.Shutdown), timeout.Token);
+            }
+            catch
+            {
+                // العامل سيُنهى عند Dispose
+            }
+        }
+
+        /// <summary>
+        /// إيقاف فحص بطلب المستخدم (تُحذف نقطة استئنافه)
+        /// </summary>
+        public void StopScan(Guid jobId)
+        {
+            if (_cancellationTokens.TryGetValue(jobId, out var cts))
+            {
+                _userStopped[jobId] = 0;
+                try { cts.Cancel(); } catch (ObjectDisposedException) { }
+                _logger?.LogInformation("تم طلب إيقاف الفحص الموزّع: {JobId}", jobId);
+            }
+        }
+
+        /// <summary>
+        /// إيقاف جميع الفحوصات الموزّعة بطلب المستخدم
+        /// </summary>
+        public void StopAllScans()
+        {
+            foreach (var jobId in _cancellationTokens.Keys)
+            {
+                StopScan(jobId);
+            }
+        }
+
+        /// <summary>
+        /// تعليق جميع الفحوصات الموزّعة لإيقاف الخدمة - نقاط الاستئناف تُحفظ
+        /// </summary>
+        public void SuspendAllScans()
+        {
+            foreach (var cts in _cancellationTokens.Values)
+            {
+                try { cts.Cancel(); } catch (ObjectDisposedException) { }
+            }
+        }
+
+        /// <summary>
+        /// المهام الموزّعة النشطة
+        /// </summary>
+        public IEnumerable<ScanJob> GetActiveJobs()
+        {
+            return _activeJobs.Values.ToList();
+        }
+
+        public void Dispose()
+        {
+            if (_disposed) return;
+            _disposed = true;
+
+            SuspendAllScans();
+            GC.SuppressFinalize(this);
+        }
+
+        /// <summary>
+        /// حالة تنفيذ مهمة موزّعة: طابور الأجزاء + آخر تقدم لكل جزء
+        /// </summary>
+        private sealed class ShardRun
+        {
+            private readonly object _lock = new();
+            private readonly Dictionary<int, ShardProgressResponse> _progress = new();
+            private readonly Dictionary<int, int> _attempts = new();
+            private readonly HashSet<string> _reportedThreats = new(StringComparer.OrdinalIgnoreCase);
+            private readonly HashSet<int> _completed = new();
+            private readonly List<ScanShard> _shards;
+            private readonly ScanReport _report;
+            private readonly ScanProgressPublisher _publisher;
+            private readonly ScanCheckpoint? _resumeFrom;
+            private int _remaining;
+            private int _failedFiles;
+
+            // إحصائيات الأجزاء المكتملة في الجلسات السابقة
+            private readonly int _baseScanned;
+            private readonly int _baseThreats;
+            private readonly int _baseErrors;
+
+            public ScanJob Job { get; }
+            public ConcurrentQueue<ScanShard> Pending { get; }
+            public int PendingCount { get; }
+            public bool HasRemaining => Volatile.Read(ref _remaining) > 0;
+            public object CheckpointLock { get; } = new();
+
+            public ShardRun(
+                ScanJob job,
+                List<ScanShard> shards,
+                ScanReport report,
+                ScanProgressPublisher publisher,
+                ScanCheckpoint? resumeFrom = null)
+            {
+                Job = job;
+                _shards = shards;
+                _report = report;
+                _publisher = publisher;
+                _resumeFrom = resumeFrom;
+
+                if (resumeFrom != null)
+                {
+                    _completed.UnionWith(resumeFrom.CompletedShards);
+                    _baseScanned = resumeFrom.ScannedFiles;
+                    _baseThreats = resumeFrom.ThreatsFound;
+                    _baseErrors = resumeFrom.ErrorCount;
+                }
+
+                var pending = shards.Where(s => !_completed.Contains(s.Id)).ToList();
+                Pending = new ConcurrentQueue<ScanShard>(pending);
+                PendingCount = pending.Count;
+                _remaining = pending.Count;
+
+                RecalculateLocked();
+            }
+
+            /// <summary>
+            /// تحديث تقدم جزء وإرجاع التهديدات الجديدة (بعد إزالة المكرر من المحاولات السابقة)
+            /// </summary>
+            public List<ScanResult> Update(int shardId, ShardProgressResponse progress)
+            {
+                var fresh = new List<ScanResult>();
+
+                lock (_lock)
+                {
+                    _progress[shardId] = progress;
+
+                    foreach (var threat in progress.NewThreats)
+                    {
+                        if (_reportedThreats.Add(threat.FilePath))
+                        {
+                            _report.Results.Add(threat);
+                            fresh.Add(threat);
+                        }
+                    }
+
+                    RecalculateLocked();
+                }
+
+                _publisher.MarkDirty();
+                return fresh;
+            }
+
+            public void ResetProgress(int shardId)
+            {
+                lock (_lock)
+                {
+                    _progress.Remove(shardId);
+                    RecalculateLocked();
+                }
+
+                _publisher.MarkDirty();
+            }
+
+            public int RecordAttempt(int shardId)
+            {
+                lock (_lock)
+                {
+                    _attempts.TryGetValue(shardId, out var attempts);
+                    _attempts[shardId] = ++attempts;
+                    return attempts;
+                }
+            }
+
+            public void Complete(ScanShard shard)
+            {
+                lock (_lock)
+                {
+                    _completed.Add(shard.Id);
+                }
+
+                Interlocked.Decrement(ref _remaining);
+            }
+
+            /// <summary>
+            /// نقطة استئناف: الإحصائيات من الأجزاء المكتملة فقط (الجزئي يُعاد فحصه)
+            /// </summary>
+            public ScanCheckpoint CreateCheckpoint(ScanPriorityClass priority)
+            {
+                lock (_lock)
+                {
+                    int scanned = _baseScanned, threats = _baseThreats, errors = _baseErrors;
+                    foreach (var (shardId, progress) in _progress)
+                    {
+                        if (!_completed.Contains(shardId)) continue;
+                        scanned += progress.ScannedFiles;
+                        threats += progress.ThreatsFound;
+                        errors += progress.ErrorCount;
+                    }
+
+                    return new ScanCheckpoint
+                    {
+                        JobId = Job.Id,
+                        Paths = Job.Paths,
+                        Type = Job.Type,
+                        UseVirusTotal = Job.UseVirusTotal,
+                        DeepScan = Job.DeepScan,
+                        ScanArchives = Job.ScanArchives,
+                        ScanHiddenFiles = Job.ScanHiddenFiles,
+                        MaxDepth = Job.MaxDepth,
+                        Priority = priority,
+                        StartedAt = _resumeFrom?.StartedAt ?? Job.StartedAt ?? DateTime.Now,
+                        TotalFiles = Math.Max(Job.TotalFiles, scanned),
+                        ScannedFiles = scanned,
+                        ThreatsFound = threats,
+                        ErrorCount = errors,
+                        Shards = _shards,
+                        CompletedShards = _completed.OrderBy(id => id).ToList()
+                    };
+                }
+            }
+
+            public void Fail(ScanShard shard, string error)
+            {
+                lock (_lock)
+                {
+                    _report.Errors.Add($"{shard.Path}: {error}");
+                    _failedFiles++;
+                    RecalculateLocked();
+                }
+
+                Interlocked.Decrement(ref _remaining);
+            }
+
+            private void RecalculateLocked()
+            {
+                int total = _baseScanned, scanned = _baseScanned, threats = _baseThreats, errors = _baseErrors + _failedFiles;
+
+                foreach (var progress in _progress.Values)
+                {
+                    total += progress.TotalFiles;
+                    scanned += progress.ScannedFiles;
+                    threats += progress.ThreatsFound;
+                    errors += progress.ErrorCount;
+                }
+
+                Job.TotalFiles = total;
+                Job.ScannedFiles = scanned;
+                Job.ThreatsFound = threats;
+                Job.ErrorCount = errors;
+            }
+        }
+    }
+}
@@ -0,0 +1,261 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Service/Workers/ShardWorkerHost.cs
+// عملية عامل الفحص الموزّع (--shard-worker)
+// =====================================================
+
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using Microsoft.Extensions.Logging;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Contracts;
+using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
+using ShieldAI.Service.Ipc;
+
+namespace ShieldAI.Service.Workers
+{
+    /// <summary>
+    /// نقطة دخول عملية العامل: يستمع على pipe خاص ويخدم منسقاً واحداً
+    /// </summary>
+    public static class ShardWorkerHost
+    {
+        public const string Argument = "--shard-worker";
+
+        private static readonly TimeSpan ConnectTimeout = TimeSpan.FromSeconds(30);
+
+        public static bool IsShardWorker(string[] args) =>
+            args.Contains(Argument, StringComparer.OrdinalIgnoreCase);
+
+        public static async Task<int> RunAsync(string[] args)
+        {
+            var pipeName = GetArgument(args, "--pipe");
+            if (string.IsNullOrEmpty(pipeName))
+                return 1;
+
+            int.TryParse(GetArgument(args, "--parent"), out var parentPid);
+            int.TryParse(GetArgument(args, "--concurrency"), out var concurrency);
+
+            using var loggerFactory = LoggerFactory.Create(builder =>
+                builder.AddConsole().SetMinimumLevel(Microsoft.Extensions.Logging.LogLevel.Warning));
+            var logger = loggerFactory.CreateLogger("ShardWorker");
+
+            // نقاط الاستئناف يديرها المنسق - لا نريد نقاطاً لكل جزء (إعداد داخل هذه العملية فقط)
+            ConfigManager.Instance.Settings.EnableScanCheckpoints = false;
+
+            using var cts = new CancellationTokenSource();
+            WatchParent(parentPid, cts);
+
+            using var session = new ShardWorkerSession(logger, concurrency);
+            await using var pipe = ShardPipeProtocol.CreateServer(pipeName);
+
+            try
+            {
+                using var connectCts = CancellationTokenSource.CreateLinkedTokenSource(cts.Token);
+                connectCts.CancelAfter(ConnectTimeout);
+                await pipe.WaitForConnectionAsync(connectCts.Token);
+
+                // الأوامر تُنفذ بصلاحيات الخدمة - نخدم المنسق الذي أنشأنا فقط
+                if (!ShardPipeProtocol.IsClientProcess(pipe, parentPid))
+                {
+                    logger.LogWarning("رُفض اتصال من عملية غير المنسق على {Pipe}", pipeName);
+                    return 1;
+                }
+
+                while (pipe.IsConnected && !cts.IsCancellationRequested)
+                {
+                    var json = await ShardPipeProtocol.ReadMessageAsync(pipe, cts.Token);
+                    var command = json != null ? CommandEnvelope.FromJson(json) : null;
+                    if (command == null) break;
+
+                    var response = session.Process(command);
+                    await ShardPipeProtocol.SendMessageAsync(pipe, response.ToJson(), cts.Token);
+
+                    if (command.CommandType == Commands.Shutdown)
+                        break;
+                }
+            }
+            catch (Exception ex) when (ex is OperationCanceledException or IOException)
+            {
+                // المنسق أُغلق
+            }
+
+            session.Stop();
+            return 0;
+        }
+
+        /// <summary>
+        /// إنهاء العامل إذا توقفت عملية المنسق
+        /// </summary>
+        private static void WatchParent(int parentPid, CancellationTokenSource cts)
+        {
+            if (parentPid <= 0) return;
+
+            try
+            {
+                var parent = Process.GetProcessById(parentPid);
+                parent.EnableRaisingEvents = true;
+                parent.Exited += (_, _) => cts.Cancel();
+                if (parent.HasExited) cts.Cancel();
+            }
+            catch (ArgumentException)
+            {
+                cts.Cancel();
+            }
+        }
+
+        private static string? GetArgument(string[] args, string name)
+        {
+            var index = Array.FindIndex(args, a => a.Equals(name, StringComparison.OrdinalIgnoreCase));
+            return index >= 0 && index + 1 < args.Length ? args[index + 1] : null;
+        }
+    }
+
+    /// <summary>
+    /// جلسة العامل - تنفذ جزءاً واحداً في كل مرة عبر ScanOrchestrator محلي
+    /// </summary>
+    public sealed class ShardWorkerSession : IDisposable
+    {
+        private const int MaxThreatsPerPoll = 200;
+
+        private readonly ScanOrchestrator _orchestrator;
+        private readonly ConcurrentQueue<ScanResult> _newThreats = new();
+        private readonly object _lock = new();
+        private ScanJob? _job;
+        private Task<ScanReport>? _scanTask;
+        private CancellationTokenSource? _cts;
+        private int _shardId;
+
+        public ShardWorkerSession(ILogger? logger = null, int concurrency = 0)
+        {
+            // concurrency = حصة هذا العامل من ميزانية المنسق (بعد خانات الفحص الفوري في الخدمة
+            // ونصيب فئة الأولوية)، ولا فحص فوري داخل هذه العملية فلا خانات محجوزة هنا
+            var executor = new ScanExecutor(concurrency, reservedRealtimeSlots: 0, logger: logger);
+            _orchestrator = new ScanOrchestrator(logger, ConfigManager.Instance.Settings.VirusTotalApiKey, executor);
+            _orchestrator.ThreatDetected += (_, e) => _newThreats.Enqueue(e.Result);
+        }
+
+        /// <summary>
+        /// معالجة أمر من المنسق
+        /// </summary>
+        public ResponseEnvelope Process(CommandEnvelope command)
+        {
+            try
+            {
+                switch (command.CommandType)
+                {
+                    case Commands.Ping:
+                        return ResponseEnvelope.Ok(command.Id);
+
+                    case Commands.ScanShard:
+                        return HandleScanShard(command);
+
+                    case Commands.GetShardProgress:
+                        return HandleGetShardProgress(command);
+
+                    case Commands.StopScan:
+                    case Commands.Shutdown:
+                        Stop();
+                        return ResponseEnvelope.Ok(command.Id);
+
+                    default:
+                        return ResponseEnvelope.Fail(command.Id, $"Unknown command: {command.CommandType}");
+                }
+            }
+            catch (Exception ex)
+            {
+                return ResponseEnvelope.Fail(command.Id, ex.Message);
+            }
+        }
+
+        private ResponseEnvelope HandleScanShard(CommandEnvelope command)
+        {
+            var request = command.GetPayload<ScanShardRequest>();
+            if (request == null || string.IsNullOrEmpty(request.Path))
+                return ResponseEnvelope.Fail(command.Id, "Invalid shard");
+
+            lock (_lock)
+            {
+                if (_scanTask != null && !_scanTask.IsCompleted)
+                    return ResponseEnvelope.Fail(command.Id, "Worker busy");
+
+                _newThreats.Clear();
+                _cts?.Dispose();
+                _cts = new CancellationTokenSource();
+                _shardId = request.ShardId;
+                _job = new ScanJob
+                {
+                    Paths = new List<string> { request.Path },
+                    Type = request.ScanType,
+                    UseVirusTotal = request.UseVirusTotal,
+                    DeepScan = request.DeepScan,
+                    ScanArchives = request.ScanArchives,
+                    ScanHiddenFiles = request.ScanHiddenFiles,
+                    MaxDepth = request.MaxDepth
+                };
+
+                var job = _job;
+                var token = _cts.Token;
+                var priority = (ScanPriorityClass)request.Priority;
+                _scanTask = Task.Run(() => _orchestrator.ExecuteScanJobAsync(job, token, priority));
+            }
+
+            return ResponseEnvelope.Ok(command.Id);
+        }
+
+        private ResponseEnvelope HandleGetShardProgress(CommandEnvelope command)
+        {
+            ScanJob? job;
+            Task<ScanReport>? scanTask;
+            lock (_lock)
+            {
+                job = _job;
+                scanTask = _scanTask;
+            }
+
+            if (job == null || scanTask == null)
+                return ResponseEnvelope.Fail(command.Id, "No shard");
+
+            // الأحداث تُطلق قبل اكتمال المهمة، فالتهديدات كلها في الطابور عند الانتهاء
+            bool done = scanTask.IsCompleted;
+            var status = done
+                ? (scanTask.IsFaulted ? ScanStatus.Failed : job.Status)
+                : ScanStatus.Running;
+
+            var response = new ShardProgressResponse
+            {
+                ShardId = _shardId,
+                Status = status,
+                TotalFiles = job.TotalFiles,
+                ScannedFiles = job.ScannedFiles,
+                ThreatsFound = job.ThreatsFound,
+                ErrorCount = job.ErrorCount
+            };
+
+            while (response.NewThreats.Count < MaxThreatsPerPoll && _newThreats.TryDequeue(out var threat))
+                response.NewThreats.Add(threat);
+
+            response.IsFinal = done && _newThreats.IsEmpty;
+
+            return ResponseEnvelope.Ok(command.Id, response);
+        }
+
+        /// <summary>
+        /// إيقاف الجزء الحالي
+        /// </summary>
+        public void Stop()
+        {
+            lock (_lock)
+            {
+                try { _cts?.Cancel(); } catch (ObjectDisposedException) { }
+            }
+        }
+
+        public void Dispose()
+        {
+            Stop();
+            _orchestrator.Dispose();
+            _cts?.Dispose();
+        }
+    }
+}
@@ -26,24 +26,41 @@ namespace ShieldAI.Service.Workers
         private readonly AppSettings _settings;
         
         private ScanOrchestrator? _scanOrchestrator;
+        private ShardCoordinator? _shardCoordinator;
         private RealTimeMonitor? _realTimeMonitor;
         private RealtimeWorker? _realtimeWorker;
         private Core.Security.QuarantineManager? _quarantineManager;
         private QuarantineStore? _quarantineStore;
+        private QuarantineActionQueue? _quarantineQueue;
+        private QuarantineCommandHandler? _quarantineCommands;
         private PipeServer? _pipeServer;
 
         private bool _isDegradedMode;
         private int _watchdogRestartCount;
+        private Dictionary<Core.Monitoring.Pipeline.FileEventLane, long> _lastLaneDrops = new();
 
         public static ShieldAIWorker? Instance { get; private set; }
 
+        /// <summary>
+        /// منسق الفحص إن اكتملت التهيئة (null قبلها - للخدمات المستضافة المجاورة)
+        /// </summary>
+        public ScanOrchestrator? TryGetScanOrchestrator() => _scanOrchestrator;
+
         // المكونات العامة
         public ScanOrchestrator ScanOrchestrator => _scanOrchestrator 
             ?? throw new InvalidOperationException("Service not started");
+        public ShardCoordinator ShardCoordinator => _shardCoordinator
+            ?? throw new InvalidOperationException("Service not started");
         public RealTimeMonitor RealTimeMonitor => _realTimeMonitor 
             ?? throw new InvalidOperationException("Service not started");
         public Core.Security.QuarantineManager QuarantineManager => _quarantineManager 
             ?? throw new InvalidOperationException("Service not started");
+        public QuarantineStore QuarantineStore => _quarantineStore
+            ?? throw new InvalidOperationException("Service not started");
+        public QuarantineActionQueue QuarantineQueue => _quarantineQueue
+            ?? throw new InvalidOperationException("Service not started");
+        public QuarantineCommandHandler QuarantineCommands => _quarantineCommands
+            ?? throw new InvalidOperationException("Service not started");
 
         // الإحصائيات
         public DateTime StartTime { get; private set; }
@@ -96,6 +113,7 @@ namespace ShieldAI.Service.Workers
                     await Task.Delay(5000, stoppingToken);
                     RunWatchdogCheck();
                     UpdateDegradedMode();
+                    LogQueueDrops();
                 }
             }
             catch (OperationCanceledException)
@@ -123,19 +141,35 @@ namespace ShieldAI.Service.Workers
             _scanOrchestrator.ThreatDetected += OnThreatDetected;
             _scanOrchestrator.ScanCompleted += OnScanCompleted;
 
+            // منسق الفحص الموزّع على عدة عمليات
+            _shardCoordinator = new ShardCoordinator(_logger);
+            _shardCoordinator.ThreatDetected += OnThreatDetected;
+            _shardCoordinator.ScanCompleted += OnScanCompleted;
+
             // مدير الحجر
             _quarantineManager = new Core.Security.QuarantineManager(_logger);
 
             // مخزن الحجر الآمن
             _quarantineStore = new QuarantineStore();
+            _ = MigrateQuarantineAsync(_quarantineStore);
+
+            // قائمة إجراءات الحجر المشتركة (دفعات + تشفير متوازٍ)
+            _quarantineQueue = new QuarantineActionQueue(
+                _quarantineStore, QuarantineActionQueueOptions.FromSettings(_settings));
+
+            // أوامر الحجر عبر IPC - المخزن الجديد مع عناصر QuarantineManager القديمة
+            _quarantineCommands = new QuarantineCommandHandler(
+                _quarantineStore, _quarantineQueue, _quarantineManager,
+                () => ActionExecutor?.GetPendingThreats().Select(t => t.FilePath) ?? Enumerable.Empty<string>());
 
             // مراقب الوقت الفعلي (Legacy)
             _realTimeMonitor = new RealTimeMonitor(_logger, vtApiKey);
             _realTimeMonitor.ThreatFound += OnRealTimeThreat;
 
             // مراقب Pipeline الفوري مع Quick Gate
-            _realtimeWorker = new RealtimeWorker(_logger, _quarantineStore);
+            _realtimeWorker = new RealtimeWorker(_logger, _quarantineStore, actionQueue: _quarantineQueue);
             _realtimeWorker.ThreatDetected += OnRealtimeWorkerThreat;
+            _realtimeWorker.LoadTierChanged += OnLoadTierChanged;
 
             // ربط أحداث إجراءات التهديد بالبث عبر IPC
             _realtimeWorker.ActionExecutor.ThreatActionRequired += OnThreatActionRequired;
@@ -144,6 +178,23 @@ namespace ShieldAI.Service.Workers
             _logger.LogInformation("تم تهيئة جميع المكونات");
         }
 
+        /// <summary>
+        /// ترحيل ملفات الحجر القديمة إلى الحاوية المجزأة في الخلفية
+        /// </summary>
+        private async Task MigrateQuarantineAsync(QuarantineStore store)
+        {
+            try
+            {
+                var migrated = await store.MigrateLegacyItemsAsync().ConfigureAwait(false);
+                if (migrated > 0)
+                    _logger.LogInformation("تم ترحيل {Count} عنصر حجر إلى الصيغة المجزأة", migrated);
+            }
+            catch (Exception ex)
+            {
+                _logger.LogWarning(ex, "فشل ترحيل ملفات الحجر القديمة");
+            }
+        }
+
         private void OnThreatDetected(object? sender, Core.Models.ThreatDetectedEventArgs e)
         {
             TotalThreatsBlocked++;
@@ -151,13 +202,7 @@ namespace ShieldAI.Service.Workers
                 e.Result.FilePath, e.Result.ThreatName);
 
             // الحجر التلقائي
-            if (_settings.AutoQuarantine && _quarantineManager != null)
-            {
-                Task.Run(async () =>
-                {
-                    await _quarantineManager.QuarantineFileAsync(e.Result.FilePath, e.Result);
-                });
-            }
+            QueueAutoQuarantine(e.Result);
 
             // TODO: إرسال Event للـ UI عبر IPC
         }
@@ -174,17 +219,26 @@ namespace ShieldAI.Service.Workers
             _logger.LogWarning("تهديد فوري: {File}", e.Result.FilePath);
 
             // الحجر التلقائي
-            if (_settings.AutoQuarantine && _quarantineManager != null)
+            QueueAutoQuarantine(e.Result);
+        }
+
+        /// <summary>
+        /// إضافة طلب حجر للقائمة المشتركة - لا يحجب خيط الحدث عند امتلائها
+        /// </summary>
+        private void QueueAutoQuarantine(Core.Models.ScanResult result)
+        {
+            if (!_settings.AutoQuarantine || _quarantineQueue == null)
+                return;
+
+            var filePath = result.FilePath;
+            _quarantineQueue.Post(QuarantineRequest.ForDetection(result)).ContinueWith(t =>
             {
-                Task.Run(async () =>
-                {
-                    var entry = await _quarantineManager.QuarantineFileAsync(e.Result.FilePath, e.Result);
-                    if (entry != null)
-                    {
-                        _logger.LogInformation("تم حجر الملف: {File}", e.Result.FilePath);
-                    }
-                });
-            }
+                var outcome = t.Result;
+                if (outcome.Success)
+                    _logger.LogInformation("تم حجر الملف: {File}", filePath);
+                else
+                    _logger.LogWarning("فشل حجر الملف: {File} - {Error}", filePath, outcome.Error);
+            }, TaskContinuationOptions.OnlyOnRanToCompletion);
         }
 
         /// <summary>
@@ -222,8 +276,9 @@ namespace ShieldAI.Service.Workers
                 try
                 {
                     _realtimeWorker.Dispose();
-                    _realtimeWorker = new RealtimeWorker(_logger, _quarantineStore!);
+                    _realtimeWorker = new RealtimeWorker(_logger, _quarantineStore!, actionQueue: _quarantineQueue);
                     _realtimeWorker.ThreatDetected += OnRealtimeWorkerThreat;
+                    _realtimeWorker.LoadTierChanged += OnLoadTierChanged;
                     _realtimeWorker.Start();
                     _logger.LogInformation("Watchdog: تم إعادة تشغيل RealtimeWorker بنجاح");
                 }
@@ -235,29 +290,106 @@ namespace ShieldAI.Service.Workers
         }
 
         /// <summary>
-        /// تحديث حالة الوضع المخفف بناءً على ضغط الطابور
+        /// تحديث حالة الوضع المخفف - أي مستوى تخفيف حمل فوق Normal.
+        /// التقييم الدوري يضمن النزول وتصريف المؤجل حتى دون أحداث جديدة.
         /// </summary>
         private void UpdateDegradedMode()
         {
             if (_realtimeWorker == null)
                 return;
 
-            var pending = _realtimeWorker.PendingCount;
+            var tier = _realtimeWorker.EvaluateLoad();
+            _isDegradedMode = tier != Core.Monitoring.Pipeline.LoadShedTier.Normal;
+        }
+
+        private void OnLoadTierChanged(object? sender, Core.Monitoring.Pipeline.LoadTierTransition transition)
+        {
+            _isDegradedMode = transition.To != Core.Monitoring.Pipeline.LoadShedTier.Normal;
 
-            if (!_isDegradedMode && pending >= _settings.DegradedModeThreshold)
+            if (_pipeServer != null)
             {
-                _isDegradedMode = true;
-                _logger.LogWarning(
-                    "Degraded Mode: تفعيل - الطابور {Pending} >= {Threshold}",
-                    pending, _settings.DegradedModeThreshold);
+                _ = _pipeServer.BroadcastAsync(Events.LoadTierChanged, ToDto(transition));
             }
-            else if (_isDegradedMode && pending <= _settings.DegradedRecoveryThreshold)
+        }
+
+        private static LoadTierTransitionDto ToDto(Core.Monitoring.Pipeline.LoadTierTransition transition) => new()
+        {
+            From = transition.From.ToString(),
+            To = transition.To.ToString(),
+            TimestampUtc = transition.TimestampUtc,
+            PendingEvents = transition.PendingEvents,
+            QueueLatencyMs = transition.QueueLatencyMs
+        };
+
+        /// <summary>
+        /// تسجيل الأحداث المُزاحة من مسارات القائمة منذ آخر فحص
+        /// </summary>
+        private void LogQueueDrops()
+        {
+            if (_realtimeWorker == null)
+                return;
+
+            var drops = new Dictionary<Core.Monitoring.Pipeline.FileEventLane, long>();
+            foreach (var lane in _realtimeWorker.GetQueueStats())
             {
-                _isDegradedMode = false;
-                _logger.LogInformation(
-                    "Degraded Mode: تعطيل - الطابور {Pending} <= {Threshold}",
-                    pending, _settings.DegradedRecoveryThreshold);
+                var lost = lane.Dropped + lane.Rejected;
+                drops[lane.Lane] = lost;
+
+                _lastLaneDrops.TryGetValue(lane.Lane, out var previous);
+                // بعد إعادة تشغيل العامل تبدأ العدادات من الصفر
+                var delta = lost >= previous ? lost - previous : lost;
+                if (delta > 0)
+                {
+                    _logger.LogWarning(
+                        "Pipeline: مسار {Lane} أسقط {Delta} حدث (الإجمالي {Total}، المعلق {Pending}/{Capacity})",
+                        lane.Lane, delta, lost, lane.Pending, lane.Capacity);
+                }
             }
+
+            _lastLaneDrops = drops;
+        }
+
+        /// <summary>
+        /// حالة الحماية الفورية وإحصائيات القائمة
+        /// </summary>
+        public RealTimeStatusResponse GetRealTimeStatus()
+        {
+            var status = new RealTimeStatusResponse
+            {
+                Enabled = IsRealTimeEnabled,
+                DegradedMode = _isDegradedMode
+            };
+
+            var worker = _realtimeWorker;
+            if (worker == null)
+                return status;
+
+            status.EventSource = worker.EventSourceName;
+            status.PendingEvents = worker.PendingCount;
+            status.CoalescerPending = worker.CoalescerPendingCount;
+            status.CoalescerRetryPending = worker.CoalescerRetryPendingCount;
+            status.CoalescerDropped = worker.CoalescerDroppedCount;
+            status.OverflowRecoveries = worker.OverflowRecoveryCount;
+            status.OverflowRecoveredFiles = worker.OverflowRecoveredFileCount;
+            status.LoadTier = worker.LoadTier.ToString();
+            status.QueueLatencyMs = worker.QueueLatencyMs;
+            status.DeferredPending = worker.DeferredPendingCount;
+            status.DeferredTotal = worker.DeferredTotalCount;
+            status.DeferredDrained = worker.DeferredDrainedCount;
+            status.DeferredOverflow = worker.DeferredOverflowCount;
+            status.LoadTierTransitions = worker.GetLoadTransitions().Select(ToDto).ToList();
+            status.Lanes = worker.GetQueueStats().Select(lane => new EventLaneStatusDto
+            {
+                Lane = lane.Lane.ToString(),
+                Pending = lane.Pending,
+                Capacity = lane.Capacity,
+                Enqueued = lane.Enqueued,
+                Dequeued = lane.Dequeued,
+                Dropped = lane.Dropped,
+                Rejected = lane.Rejected
+            }).ToList();
+
+            return status;
         }
 
         private void OnRealtimeWorkerThreat(object? sender, Core.Detection.ThreatScoring.AggregatedThreatResult result)
@@ -303,7 +435,9 @@ namespace ShieldAI.Service.Workers
         {
             _realtimeWorker?.Dispose();
             _realTimeMonitor?.Dispose();
+            _shardCoordinator?.Dispose();
             _scanOrchestrator?.Dispose();
+            _quarantineQueue?.Dispose();
             _quarantineStore?.Dispose();
             _logger.LogInformation("تم تنظيف الموارد");
         }
@@ -0,0 +1,222 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/ArchiveScannerTests.cs
+// اختبارات فحص الأرشيفات من الذاكرة وحدود قنابل الضغط
+// =====================================================
+
+using System.Formats.Tar;
+using System.IO.Compression;
+using System.Text;
+using ShieldAI.Core.Detection;
+using ShieldAI.Core.Detection.ThreatScoring;
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class ArchiveScannerTests : IDisposable
+    {
+        // EICAR standard test string (safe, not a real virus)
+        private const string EicarString =
+            @"X5O!P%@AP[4\PZX54(P^)7CC)7}$EICAR-STANDARD-ANTIVIRUS-TEST-FILE!$H+H*";
+
+        private readonly string _testDir;
+        private readonly ThreatAggregator _aggregator;
+
+        public ArchiveScannerTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_Archive_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+
+            var sigDb = new SignatureDatabase(databasePath: Path.Combine(_testDir, "sig.json"));
+            _aggregator = new ThreatAggregator(new IThreatEngine[] { new SignatureEngine(sigDb) });
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private static byte[] CreateZip(params (string Name, byte[] Content)[] entries)
+        {
+            using var ms = new MemoryStream();
+            using (var zip = new ZipArchive(ms, ZipArchiveMode.Create, leaveOpen: true))
+            {
+                foreach (var (name, content) in entries)
+                {
+                    var entry = zip.CreateEntry(name, CompressionLevel.Optimal);
+                    using var stream = entry.Open();
+                    stream.Write(content);
+                }
+            }
+            return ms.ToArray();
+        }
+
+        private string WriteArchive(string name, byte[] content)
+        {
+            var path = Path.Combine(_testDir, name);
+            File.WriteAllBytes(path, content);
+            return path;
+        }
+
+        [Fact]
+        public void DetectFormat_ShouldRecognizeMagicBytes()
+        {
+            var zip = CreateZip(("a.txt", Encoding.ASCII.GetBytes("hello")));
+
+            Assert.Equal(ArchiveFormat.Zip, ArchiveScanner.DetectFormat(zip));
+            Assert.Equal(ArchiveFormat.GZip, ArchiveScanner.DetectFormat(new byte[] { 0x1F, 0x8B, 0x08 }));
+            Assert.Equal(ArchiveFormat.None, ArchiveScanner.DetectFormat(Encoding.ASCII.GetBytes("MZ plain file")));
+        }
+
+        [Fact]
+        public async Task Zip_WithEicarEntry_ShouldDetectEntry()
+        {
+            // Arrange
+            var path = WriteArchive("sample.zip", CreateZip(
+                ("readme.txt", Encoding.ASCII.GetBytes("clean file")),
+                ("bin/eicar.com", Encoding.ASCII.GetBytes(EicarString))));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits());
+
+            // Act
+            var result = await scanner.ScanAsync(path);
+
+            // Assert
+            Assert.Equal(ArchiveFormat.Zip, result.Format);
+            Assert.Equal(2, result.EntriesScanned);
+            Assert.True(result.IsThreat);
+            Assert.Equal("bin/eicar.com", result.WorstEntry!.EntryPath);
+            Assert.Equal(new[] { "sample.zip" }, Directory.GetFiles(_testDir, "*.zip").Select(Path.GetFileName));
+        }
+
+        [Fact]
+        public async Task NestedZip_ShouldRecurseWithinDepthLimit()
+        {
+            var inner = CreateZip(("eicar.com", Encoding.ASCII.GetBytes(EicarString)));
+            var path = WriteArchive("outer.zip", CreateZip(("inner.zip", inner)));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits { MaxDepth = 2 });
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.True(result.IsThreat);
+            Assert.Equal("inner.zip>eicar.com", result.WorstEntry!.EntryPath);
+            Assert.Null(result.LimitReason);
+        }
+
+        [Fact]
+        public async Task NestedZip_BeyondMaxDepth_ShouldNotRecurse()
+        {
+            var inner = CreateZip(("eicar.com", Encoding.ASCII.GetBytes(EicarString)));
+            var path = WriteArchive("outer.zip", CreateZip(("inner.zip", inner)));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits { MaxDepth = 1 });
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.NotNull(result.LimitReason);
+            Assert.DoesNotContain(result.Entries, e => e.EntryPath.Contains('>'));
+            Assert.Equal("inner.zip", Assert.Single(result.UnscannedEntries).EntryPath);
+            Assert.True(result.IsThreat);
+        }
+
+        [Fact]
+        public async Task OversizedEntry_ShouldBeReportedAsUnscanned()
+        {
+            var large = new byte[4096];
+            new Random(7).NextBytes(large);
+            var path = WriteArchive("large.zip", CreateZip(
+                ("small.txt", Encoding.ASCII.GetBytes("clean file")),
+                ("large.bin", large)));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits { MaxEntryBytes = 1024 });
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.False(result.BombDetected);
+            Assert.Single(result.Entries);
+            Assert.Equal("large.bin", Assert.Single(result.UnscannedEntries).EntryPath);
+            Assert.True(result.IsThreat);
+        }
+
+        [Fact]
+        public async Task EntriesBeyondMaxEntries_ShouldBeReportedAsUnscanned()
+        {
+            var content = Encoding.ASCII.GetBytes("clean file");
+            var path = WriteArchive("many.zip", CreateZip(("a.txt", content), ("b.txt", content), ("c.txt", content)));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits { MaxEntries = 2 });
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.Equal(2, result.Entries.Count);
+            Assert.Equal("c.txt", Assert.Single(result.UnscannedEntries).EntryPath);
+            Assert.True(result.IsThreat);
+        }
+
+        [Fact]
+        public async Task HighlyCompressedEntry_ShouldBeFlaggedAsBomb()
+        {
+            // 32 MB من الأصفار تنضغط لبضعة كيلوبايت
+            var path = WriteArchive("bomb.zip", CreateZip(("zeros.bin", new byte[32 * 1024 * 1024])));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits { MaxCompressionRatio = 100 });
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.True(result.BombDetected);
+            Assert.True(result.IsThreat);
+            Assert.True(result.BytesInflated < 32 * 1024 * 1024);
+        }
+
+        [Fact]
+        public async Task TotalInflatedBytes_ShouldBeCapped()
+        {
+            var random = new Random(42);
+            var chunk = new byte[600 * 1024];
+            random.NextBytes(chunk);
+            var path = WriteArchive("big.zip", CreateZip(("a.bin", chunk), ("b.bin", chunk.Reverse().ToArray())));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits { MaxTotalBytes = 1024 * 1024 });
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.True(result.BombDetected);
+            Assert.True(result.BytesInflated <= 1024 * 1024 + 81920);
+        }
+
+        [Fact]
+        public async Task TarGz_ShouldScanTarEntries()
+        {
+            using var tarStream = new MemoryStream();
+            using (var tar = new TarWriter(tarStream, TarEntryFormat.Ustar, leaveOpen: true))
+            {
+                var entry = new UstarTarEntry(TarEntryType.RegularFile, "eicar.com")
+                {
+                    DataStream = new MemoryStream(Encoding.ASCII.GetBytes(EicarString))
+                };
+                tar.WriteEntry(entry);
+            }
+
+            using var gz = new MemoryStream();
+            using (var gzip = new GZipStream(gz, CompressionLevel.Optimal, leaveOpen: true))
+                gzip.Write(tarStream.ToArray());
+
+            var path = WriteArchive("sample.tar.gz", gz.ToArray());
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits());
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.Equal(ArchiveFormat.GZip, result.Format);
+            Assert.True(result.IsThreat);
+            Assert.Equal("eicar.com", result.WorstEntry!.EntryPath);
+        }
+
+        [Fact]
+        public async Task DuplicateEntries_ShouldHitVerdictCache()
+        {
+            var content = Encoding.ASCII.GetBytes("same content in every entry");
+            var path = WriteArchive("dupes.zip", CreateZip(("a.txt", content), ("b.txt", content), ("c.txt", content)));
+            var scanner = new ArchiveScanner(_aggregator, new ArchiveScanLimits());
+
+            var result = await scanner.ScanAsync(path);
+
+            Assert.Equal(3, result.Entries.Count);
+            Assert.Equal(2, result.CacheHits);
+        }
+    }
+}
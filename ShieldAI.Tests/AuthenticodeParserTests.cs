@@ -0,0 +1,444 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/AuthenticodeParserTests.cs
+// اختبارات محلل Authenticode وكاش أحكام التوقيع
+// =====================================================
+
+using System.Formats.Asn1;
+using System.Reflection.PortableExecutable;
+using System.Security.Cryptography;
+using System.Security.Cryptography.X509Certificates;
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class AuthenticodeParserTests
+    {
+        private const string Sha256Oid = "2.16.840.1.101.3.4.2.1";
+        private const string SpcIndirectDataOid = "1.3.6.1.4.1.311.2.1.4";
+
+        private static byte[] UnsignedImage() =>
+            File.ReadAllBytes(typeof(AuthenticodeParserTests).Assembly.Location);
+
+        private static PEHeaders Headers(byte[] image)
+        {
+            using var reader = new PEReader(new MemoryStream(image));
+            return reader.PEHeaders;
+        }
+
+        /// <summary>
+        /// توقيع صورة PE حقيقية بشهادة ذاتية: بصمة الصورة ثم PKCS#7 في جدول الشهادات
+        /// </summary>
+        private static byte[] SignImage(
+            byte[] image, RSA key, X509Certificate2 certificate, Func<byte[], byte[]>? counterSign = null,
+            params X509Certificate2[] extraCertificates)
+        {
+            var headers = Headers(image);
+            var checksum = headers.PEHeaderStartOffset + 64;
+            var certEntry = headers.PEHeaderStartOffset + (headers.PEHeader!.Magic == PEMagic.PE32Plus ? 144 : 128);
+
+            var padded = new byte[(image.Length + 7) & ~7];
+            image.CopyTo(padded, 0);
+
+            using var imageHash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+            imageHash.AppendData(padded, 0, checksum);
+            imageHash.AppendData(padded, checksum + 4, certEntry - checksum - 4);
+            imageHash.AppendData(padded, certEntry + 8, padded.Length - certEntry - 8);
+
+            var pkcs7 = BuildPkcs7(imageHash.GetHashAndReset(), key, certificate, counterSign, extraCertificates);
+            var entryLength = (8 + pkcs7.Length + 7) & ~7;
+
+            var signed = new byte[padded.Length + entryLength];
+            padded.CopyTo(signed, 0);
+            BitConverter.TryWriteBytes(signed.AsSpan(padded.Length), 8 + pkcs7.Length);
+            BitConverter.TryWriteBytes(signed.AsSpan(padded.Length + 4), (ushort)0x0200);
+            BitConverter.TryWriteBytes(signed.AsSpan(padded.Length + 6), (ushort)0x0002);
+            pkcs7.CopyTo(signed, padded.Length + 8);
+
+            BitConverter.TryWriteBytes(signed.AsSpan(certEntry), padded.Length);
+            BitConverter.TryWriteBytes(signed.AsSpan(certEntry + 4), entryLength);
+            return signed;
+        }
+
+        private static byte[] BuildPkcs7(
+            byte[] imageDigest, RSA key, X509Certificate2 certificate,
+            Func<byte[], byte[]>? counterSign, X509Certificate2[] extraCertificates)
+        {
+            var spcWriter = new AsnWriter(AsnEncodingRules.DER);
+            using (spcWriter.PushSequence())
+            {
+                using (spcWriter.PushSequence())
+                {
+                    spcWriter.WriteObjectIdentifier("1.3.6.1.4.1.311.2.1.15");
+                    spcWriter.WriteNull();
+                }
+                using (spcWriter.PushSequence())
+                {
+                    WriteAlgorithm(spcWriter, Sha256Oid);
+                    spcWriter.WriteOctetString(imageDigest);
+                }
+            }
+            var spc = spcWriter.Encode();
+            AsnDecoder.ReadEncodedValue(spc, AsnEncodingRules.DER, out var contentOffset, out var contentLength, out _);
+
+            var attributesWriter = new AsnWriter(AsnEncodingRules.DER);
+            using (attributesWriter.PushSetOf())
+            {
+                using (attributesWriter.PushSequence())
+                {
+                    attributesWriter.WriteObjectIdentifier("1.2.840.113549.1.9.3");
+                    using (attributesWriter.PushSetOf())
+                        attributesWriter.WriteObjectIdentifier(SpcIndirectDataOid);
+                }
+                using (attributesWriter.PushSequence())
+                {
+                    attributesWriter.WriteObjectIdentifier("1.2.840.113549.1.9.4");
+                    using (attributesWriter.PushSetOf())
+                        attributesWriter.WriteOctetString(SHA256.HashData(spc.AsSpan(contentOffset, contentLength)));
+                }
+            }
+            var attributes = attributesWriter.Encode();
+            var signature = key.SignData(attributes, HashAlgorithmName.SHA256, RSASignaturePadding.Pkcs1);
+            attributes[0] = 0xA0;
+
+            var context0 = new Asn1Tag(TagClass.ContextSpecific, 0);
+            var writer = new AsnWriter(AsnEncodingRules.DER);
+            using (writer.PushSequence())
+            {
+                writer.WriteObjectIdentifier("1.2.840.113549.1.7.2");
+                using (writer.PushSequence(context0))
+                using (writer.PushSequence())
+                {
+                    writer.WriteInteger(1);
+                    using (writer.PushSetOf())
+                        WriteAlgorithm(writer, Sha256Oid);
+                    using (writer.PushSequence())
+                    {
+                        writer.WriteObjectIdentifier(SpcIndirectDataOid);
+                        using (writer.PushSequence(context0))
+                            writer.WriteEncodedValue(spc);
+                    }
+                    using (writer.PushSetOf(context0))
+                    {
+                        writer.WriteEncodedValue(certificate.RawData);
+                        foreach (var extra in extraCertificates)
+                            writer.WriteEncodedValue(extra.RawData);
+                    }
+                    using (writer.PushSetOf())
+                    using (writer.PushSequence())
+                    {
+                        writer.WriteInteger(1);
+                        using (writer.PushSequence())
+                        {
+                            writer.WriteEncodedValue(certificate.IssuerName.RawData);
+                            writer.WriteInteger(certificate.SerialNumberBytes.Span);
+                        }
+                        WriteAlgorithm(writer, Sha256Oid);
+                        writer.WriteEncodedValue(attributes);
+                        WriteAlgorithm(writer, "1.2.840.113549.1.1.1");
+                        writer.WriteOctetString(signature);
+
+                        // الخصائص غير الموقعة: countersignature على قيمة التوقيع
+                        if (counterSign != null)
+                        {
+                            using (writer.PushSetOf(new Asn1Tag(TagClass.ContextSpecific, 1)))
+                            using (writer.PushSequence())
+                            {
+                                writer.WriteObjectIdentifier("1.2.840.113549.1.9.6");
+                                using (writer.PushSetOf())
+                                    writer.WriteEncodedValue(counterSign(signature));
+                            }
+                        }
+                    }
+                }
+            }
+
+            return writer.Encode();
+        }
+
+        private static void WriteAlgorithm(AsnWriter writer, string oid)
+        {
+            using (writer.PushSequence())
+            {
+                writer.WriteObjectIdentifier(oid);
+                writer.WriteNull();
+            }
+        }
+
+        private static (RSA Key, X509Certificate2 Certificate) CreateSigner(string subject = "CN=Contoso Test Signer, O=Contoso")
+        {
+            var key = RSA.Create(2048);
+            var request = new CertificateRequest(subject, key, HashAlgorithmName.SHA256, RSASignaturePadding.Pkcs1);
+            var certificate = request.CreateSelfSigned(DateTimeOffset.UtcNow.AddDays(-1), DateTimeOffset.UtcNow.AddYears(1));
+            return (key, certificate);
+        }
+
+        /// <summary>
+        /// PKCS#9 countersignature من سلطة ختم: signingTime + بصمة قيمة توقيع الموقّع
+        /// </summary>
+        private static byte[] BuildCounterSignature(byte[] signatureValue, RSA key, X509Certificate2 certificate, DateTimeOffset signingTime)
+        {
+            var attributesWriter = new AsnWriter(AsnEncodingRules.DER);
+            using (attributesWriter.PushSetOf())
+            {
+                using (attributesWriter.PushSequence())
+                {
+                    attributesWriter.WriteObjectIdentifier("1.2.840.113549.1.9.5");
+                    using (attributesWriter.PushSetOf())
+                        attributesWriter.WriteUtcTime(signingTime);
+                }
+                using (attributesWriter.PushSequence())
+                {
+                    attributesWriter.WriteObjectIdentifier("1.2.840.113549.1.9.4");
+                    using (attributesWriter.PushSetOf())
+                        attributesWriter.WriteOctetString(SHA256.HashData(signatureValue));
+                }
+            }
+            var attributes = attributesWriter.Encode();
+            var signature = key.SignData(attributes, HashAlgorithmName.SHA256, RSASignaturePadding.Pkcs1);
+            attributes[0] = 0xA0;
+
+            var writer = new AsnWriter(AsnEncodingRules.DER);
+            using (writer.PushSequence())
+            {
+                writer.WriteInteger(1);
+                using (writer.PushSequence())
+                {
+                    writer.WriteEncodedValue(certificate.IssuerName.RawData);
+                    writer.WriteInteger(certificate.SerialNumberBytes.Span);
+                }
+                WriteAlgorithm(writer, Sha256Oid);
+                writer.WriteEncodedValue(attributes);
+                WriteAlgorithm(writer, "1.2.840.113549.1.1.1");
+                writer.WriteOctetString(signature);
+            }
+
+            return writer.Encode();
+        }
+
+        private static (RSA Key, X509Certificate2 Certificate) CreateRoot()
+        {
+            var key = RSA.Create(2048);
+            var request = new CertificateRequest("CN=ShieldAI Test Root", key, HashAlgorithmName.SHA256, RSASignaturePadding.Pkcs1);
+            request.CertificateExtensions.Add(new X509BasicConstraintsExtension(true, false, 0, true));
+            request.CertificateExtensions.Add(new X509KeyUsageExtension(X509KeyUsageFlags.KeyCertSign, true));
+            var certificate = request.CreateSelfSigned(DateTimeOffset.UtcNow.AddYears(-5), DateTimeOffset.UtcNow.AddYears(5));
+            return (key, certificate);
+        }
+
+        /// <summary>
+        /// شهادة صادرة من الجذر بغرض (EKU) وفترة صلاحية محددين
+        /// </summary>
+        private static (RSA Key, X509Certificate2 Certificate) Issue(
+            X509Certificate2 root, string subject, string eku, DateTimeOffset notBefore, DateTimeOffset notAfter)
+        {
+            var key = RSA.Create(2048);
+            var request = new CertificateRequest(subject, key, HashAlgorithmName.SHA256, RSASignaturePadding.Pkcs1);
+            request.CertificateExtensions.Add(new X509BasicConstraintsExtension(false, false, 0, false));
+            request.CertificateExtensions.Add(new X509EnhancedKeyUsageExtension(new OidCollection { new Oid(eku) }, false));
+            var certificate = request.Create(root, notBefore, notAfter, RandomNumberGenerator.GetBytes(8));
+            return (key, certificate);
+        }
+
+        private static PublisherVerdict Verify(AuthenticodeVerifier verifier, byte[] image) =>
+            verifier.GetPublisherVerdict(AuthenticodeParser.Parse(image, Headers(image)))!;
+
+        [Fact]
+        public void SignedImage_ShouldExposeSignerAndVerify()
+        {
+            var (key, certificate) = CreateSigner();
+            using (key)
+            {
+                var image = SignImage(UnsignedImage(), key, certificate);
+
+                var signature = AuthenticodeParser.Parse(image, Headers(image));
+
+                Assert.True(signature.IsSigned);
+                Assert.True(signature.SignatureIntact);
+                Assert.Equal(true, signature.ImageHashMatches);
+                Assert.True(signature.IsValid);
+                Assert.Equal("Contoso Test Signer", signature.SignerName);
+                Assert.Equal(certificate.Thumbprint, signature.Thumbprint);
+                Assert.Equal("SHA256", signature.DigestAlgorithm);
+                Assert.Equal(certificate.Subject, Assert.Single(signature.ChainSubjects));
+            }
+        }
+
+        [Fact]
+        public void ModifiedImage_ShouldFailImageHashButKeepSignerIntact()
+        {
+            var (key, certificate) = CreateSigner();
+            using (key)
+            {
+                var image = SignImage(UnsignedImage(), key, certificate);
+                image[image.Length / 3] ^= 0xFF;
+
+                var signature = AuthenticodeParser.Parse(image, Headers(image));
+
+                Assert.True(signature.IsSigned);
+                Assert.True(signature.SignatureIntact);
+                Assert.Equal(false, signature.ImageHashMatches);
+                Assert.False(signature.IsValid);
+            }
+        }
+
+        [Fact]
+        public void UnsignedAndNonPeFiles_ShouldNotThrow()
+        {
+            var image = UnsignedImage();
+            Assert.Same(AuthenticodeSignature.Unsigned, AuthenticodeParser.Parse(image, Headers(image)));
+
+            var textPath = Path.Combine(Path.GetTempPath(), $"ShieldAI_Auth_{Guid.NewGuid():N}.txt");
+            try
+            {
+                File.WriteAllText(textPath, "not a portable executable");
+                Assert.False(AuthenticodeParser.Parse(textPath).IsSigned);
+            }
+            finally
+            {
+                File.Delete(textPath);
+            }
+        }
+
+        [Fact]
+        public void CorruptCertificateTable_ShouldBeSignedButInvalid()
+        {
+            var (key, certificate) = CreateSigner();
+            using (key)
+            {
+                var image = SignImage(UnsignedImage(), key, certificate);
+                // طول الـ SEQUENCE الخارجي للـ PKCS#7 بعد ترويسة WIN_CERTIFICATE
+                var tableOffset = Headers(image).PEHeader!.CertificateTableDirectory.RelativeVirtualAddress;
+                image[tableOffset + 9] ^= 0x55;
+
+                var signature = AuthenticodeParser.Parse(image, Headers(image));
+
+                Assert.True(signature.IsSigned);
+                Assert.False(signature.IsValid);
+                Assert.NotNull(signature.Error);
+            }
+        }
+
+        [Fact]
+        public void StreamParse_ShouldMatchInMemoryParse()
+        {
+            var (key, certificate) = CreateSigner();
+            var path = Path.Combine(Path.GetTempPath(), $"ShieldAI_Auth_{Guid.NewGuid():N}.dll");
+            using (key)
+            {
+                try
+                {
+                    var image = SignImage(UnsignedImage(), key, certificate);
+                    File.WriteAllBytes(path, image);
+
+                    var fromFile = AuthenticodeParser.Parse(path);
+
+                    Assert.True(fromFile.IsValid);
+                    Assert.Equal(AuthenticodeParser.Parse(image, Headers(image)).Digest, fromFile.Digest);
+                }
+                finally
+                {
+                    File.Delete(path);
+                }
+            }
+        }
+
+        [Fact]
+        public void Verifier_ShouldCacheByFileHashAndThumbprint()
+        {
+            var (key, certificate) = CreateSigner();
+            using (key)
+            {
+                var verifier = new AuthenticodeVerifier();
+                var analyzer = new PEAnalyzer(verifier);
+                var image = SignImage(UnsignedImage(), key, certificate);
+
+                var first = analyzer.Analyze(image);
+                var second = analyzer.Analyze(image);
+
+                Assert.True(first.HasDigitalSignature);
+                Assert.True(first.Signature!.IsValid);
+                Assert.Same(first.Signature, second.Signature);
+                Assert.Equal(1, verifier.SignatureCacheStatistics.Hits);
+
+                var verdict = verifier.GetPublisherVerdict(first.Signature);
+                Assert.Same(verdict, verifier.GetPublisherVerdict(second.Signature!));
+                Assert.False(verdict!.ChainTrusted); // ذاتية التوقيع
+                Assert.Equal("Contoso Test Signer", verdict.PublisherName);
+                Assert.Equal(1, verifier.VerdictCacheStatistics.Hits);
+                Assert.Null(verifier.GetPublisherVerdict(AuthenticodeSignature.Unsigned));
+            }
+        }
+
+        [Fact]
+        public void Verifier_ExpiredSignerWithoutTimestamp_ShouldNotBeTrusted()
+        {
+            var (rootKey, root) = CreateRoot();
+            var now = DateTimeOffset.UtcNow;
+            var (currentKey, current) = Issue(root, "CN=Current Signer", "1.3.6.1.5.5.7.3.3", now.AddDays(-1), now.AddYears(1));
+            var (expiredKey, expired) = Issue(root, "CN=Expired Signer", "1.3.6.1.5.5.7.3.3", now.AddYears(-2), now.AddYears(-1));
+            using (rootKey)
+            using (currentKey)
+            using (expiredKey)
+            {
+                var verifier = new AuthenticodeVerifier(trustedRoots: new X509Certificate2Collection(root));
+
+                var currentVerdict = Verify(verifier, SignImage(UnsignedImage(), currentKey, current));
+                var expiredVerdict = Verify(verifier, SignImage(UnsignedImage(), expiredKey, expired));
+
+                Assert.True(currentVerdict.ChainTrusted, currentVerdict.ChainStatus);
+                Assert.False(expiredVerdict.ChainTrusted);
+                Assert.False(expiredVerdict.TimeValid);
+                Assert.Null(expiredVerdict.TimestampUtc);
+            }
+        }
+
+        [Fact]
+        public void Verifier_ExpiredSignerWithTrustedTimestamp_ShouldBeTrusted()
+        {
+            var (rootKey, root) = CreateRoot();
+            var now = DateTimeOffset.UtcNow;
+            var (signerKey, signer) = Issue(root, "CN=Expired Signer", "1.3.6.1.5.5.7.3.3", now.AddYears(-2), now.AddYears(-1));
+            var (tsaKey, tsa) = Issue(root, "CN=Test TSA", "1.3.6.1.5.5.7.3.8", now.AddYears(-3), now.AddYears(3));
+            using (rootKey)
+            using (signerKey)
+            using (tsaKey)
+            {
+                var verifier = new AuthenticodeVerifier(trustedRoots: new X509Certificate2Collection(root));
+                var signedAt = now.AddMonths(-18);
+
+                var image = SignImage(UnsignedImage(), signerKey, signer,
+                    value => BuildCounterSignature(value, tsaKey, tsa, signedAt), tsa);
+                var verdict = Verify(verifier, image);
+
+                Assert.True(verdict.ChainTrusted, verdict.ChainStatus);
+                Assert.True(verdict.TimeValid);
+                Assert.True(Math.Abs((verdict.TimestampUtc!.Value - signedAt.UtcDateTime).TotalSeconds) < 1);
+
+                // ختم بعد انتهاء الشهادة لا ينقذها
+                var late = SignImage(UnsignedImage(), signerKey, signer,
+                    value => BuildCounterSignature(value, tsaKey, tsa, now.AddMonths(-6)), tsa);
+                Assert.False(Verify(verifier, late).ChainTrusted);
+            }
+        }
+
+        [Fact]
+        public void Verifier_SignerWithoutCodeSigningEku_ShouldNotBeTrusted()
+        {
+            var (rootKey, root) = CreateRoot();
+            var now = DateTimeOffset.UtcNow;
+            var (serverKey, server) = Issue(root, "CN=Web Server", "1.3.6.1.5.5.7.3.1", now.AddDays(-1), now.AddYears(1));
+            using (rootKey)
+            using (serverKey)
+            {
+                var verifier = new AuthenticodeVerifier(trustedRoots: new X509Certificate2Collection(root));
+
+                var verdict = Verify(verifier, SignImage(UnsignedImage(), serverKey, server));
+
+                Assert.False(verdict.ChainTrusted);
+                Assert.True(verdict.TimeValid);
+            }
+        }
+    }
+}
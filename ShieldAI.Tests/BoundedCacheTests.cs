@@ -0,0 +1,165 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/BoundedCacheTests.cs
+// اختبارات الكاش المحدود: الميزانيات، الصلاحية، السياسات، الحفظ
+// =====================================================
+
+using ShieldAI.Core.Caching;
+using ShieldAI.Core.Detection.ThreatScoring;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class BoundedCacheTests
+    {
+        private DateTime _now = new(2025, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        private BoundedCache<string, string> Create(
+            int maxEntries = 100,
+            long maxBytes = 0,
+            TimeSpan? ttl = null,
+            CacheEvictionPolicy policy = CacheEvictionPolicy.Lru,
+            string? path = null) => new(
+            new BoundedCacheOptions
+            {
+                Name = "Test",
+                MaxEntries = maxEntries,
+                MaxBytes = maxBytes,
+                Ttl = ttl,
+                Policy = policy,
+                PersistencePath = path
+            },
+            sizeOf: v => v.Length,
+            clock: () => _now);
+
+        [Fact]
+        public void Lru_ShouldEvictLeastRecentlyRead()
+        {
+            var cache = Create(maxEntries: 3);
+            cache.Set("a", "1");
+            cache.Set("b", "2");
+            cache.Set("c", "3");
+
+            Assert.True(cache.TryGet("a", out _));
+            cache.Set("d", "4");
+
+            Assert.False(cache.TryGet("b", out _));
+            Assert.True(cache.TryGet("a", out _));
+            Assert.Equal(3, cache.Count);
+            Assert.Equal(1, cache.GetStatistics().Evictions);
+        }
+
+        [Fact]
+        public void Fifo_ShouldIgnoreReads()
+        {
+            var cache = Create(maxEntries: 3, policy: CacheEvictionPolicy.Fifo);
+            cache.Set("a", "1");
+            cache.Set("b", "2");
+            cache.Set("c", "3");
+
+            Assert.True(cache.TryGet("a", out _));
+            cache.Set("d", "4");
+
+            Assert.False(cache.TryGet("a", out _));
+            Assert.True(cache.TryGet("b", out _));
+        }
+
+        [Fact]
+        public void ByteBudget_ShouldEvictAndRejectOversizedValues()
+        {
+            var cache = Create(maxBytes: 10);
+            cache.Set("a", "xxxx");
+            cache.Set("b", "xxxx");
+            cache.Set("c", "xxxx");
+
+            Assert.False(cache.TryGet("a", out _));
+            Assert.Equal(8, cache.Bytes);
+
+            cache.Set("big", new string('x', 11));
+            Assert.False(cache.TryGet("big", out _));
+            Assert.Equal(2, cache.Count);
+        }
+
+        [Fact]
+        public void Ttl_ShouldExpireAndCountExpirations()
+        {
+            var cache = Create(ttl: TimeSpan.FromMinutes(5));
+            cache.Set("a", "1");
+            cache.Set("b", "2");
+
+            _now = _now.AddMinutes(6);
+            cache.Set("c", "3");
+
+            Assert.False(cache.TryGet("a", out _));
+            Assert.Equal(1, cache.RemoveExpired());
+            Assert.True(cache.TryGet("c", out var value));
+            Assert.Equal("3", value);
+
+            var stats = cache.GetStatistics();
+            Assert.Equal(1, stats.Hits);
+            Assert.Equal(1, stats.Misses);
+            Assert.Equal(2, stats.Expirations);
+            Assert.Equal(0.5, stats.HitRatio);
+        }
+
+        [Fact]
+        public async Task ConcurrentAccess_ShouldRespectEntryBudget()
+        {
+            var cache = new BoundedCache<int, int>(new BoundedCacheOptions { MaxEntries = 4096, SegmentCount = 8 });
+
+            await Task.WhenAll(Enumerable.Range(0, 8).Select(t => Task.Run(() =>
+            {
+                for (int i = 0; i < 20_000; i++)
+                {
+                    cache.Set(t * 100_000 + i, i);
+                    cache.TryGet(t * 100_000 + i / 2, out _);
+                }
+            })));
+
+            Assert.InRange(cache.Count, 1, 4096);
+            Assert.True(cache.GetStatistics().Evictions >= 8 * 20_000 - 4096);
+        }
+
+        [Fact]
+        public void Persistence_ShouldRoundTripAndDropExpired()
+        {
+            var path = Path.Combine(Path.GetTempPath(), $"ShieldAI_Cache_{Guid.NewGuid():N}.json");
+            try
+            {
+                var cache = Create(ttl: TimeSpan.FromHours(1), path: path);
+                cache.Set("old", "1");
+                _now = _now.AddMinutes(45);
+                cache.Set("new", "2");
+                cache.Save();
+
+                _now = _now.AddMinutes(30);
+                var reloaded = Create(ttl: TimeSpan.FromHours(1), path: path);
+
+                Assert.False(reloaded.TryGet("old", out _));
+                Assert.True(reloaded.TryGet("new", out var value));
+                Assert.Equal("2", value);
+
+                File.WriteAllText(path, "{not json");
+                Assert.Equal(0, Create(path: path).Count);
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+        [Fact]
+        public void ReputationCache_ShouldBeBounded()
+        {
+            var cache = new ReputationCache(TimeSpan.FromMinutes(30), maxEntries: 2);
+            cache.Store("h1", new ReputationResult { Score = 1 });
+            cache.Store("h2", new ReputationResult { Score = 2 });
+            cache.Store("h3", new ReputationResult { Score = 3 });
+
+            Assert.False(cache.TryGet("h1", out _));
+            Assert.True(cache.TryGet("H3", out var result));
+            Assert.Equal(3, result!.Score);
+            Assert.Equal(1, cache.Statistics.Evictions);
+        }
+    }
+}
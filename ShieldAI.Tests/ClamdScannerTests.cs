@@ -0,0 +1,345 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/ClamdScannerTests.cs
+// اختبارات عميل clamd ومحرك الماسح الخارجي مقابل خادم محلي
+// =====================================================
+
+using System.Buffers.Binary;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using ShieldAI.Core.Detection.ExternalScanners;
+using ShieldAI.Core.Detection.ThreatScoring;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class ClamdScannerTests : IDisposable
+    {
+        private const string EicarMarker = "EICAR-STANDARD-ANTIVIRUS-TEST-FILE";
+
+        private readonly string _testDir;
+
+        public ClamdScannerTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_Clamd_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private string WriteFile(string name, string content)
+        {
+            var path = Path.Combine(_testDir, name);
+            File.WriteAllText(path, content);
+            return path;
+        }
+
+        private static ClamdScanner CreateScanner(StubClamd server, int maxConnections = 2, long maxStreamBytes = 1024 * 1024) => new(
+            new ClamdScannerOptions
+            {
+                Endpoint = $"tcp://127.0.0.1:{server.Port}",
+                MaxConnections = maxConnections,
+                MaxStreamBytes = maxStreamBytes,
+                ChunkSize = 16
+            });
+
+        [Fact]
+        public async Task Ping_ShouldReportAvailability()
+        {
+            using var server = new StubClamd();
+            using var scanner = CreateScanner(server);
+
+            Assert.True(await scanner.PingAsync());
+
+            server.Dispose();
+            Assert.False(await scanner.PingAsync());
+        }
+
+        [Fact]
+        public async Task Batch_ShouldUseOneSessionAndMapRepliesById()
+        {
+            using var server = new StubClamd { ShuffleReplies = true };
+            using var scanner = CreateScanner(server);
+
+            var items = new[]
+            {
+                new ExternalScanItem(WriteFile("a.txt", "hello world, a clean file longer than one chunk")),
+                new ExternalScanItem(WriteFile("b.txt", "X5O!P%@AP " + EicarMarker)),
+                new ExternalScanItem("archive.zip|inner.js", Encoding.ASCII.GetBytes("in memory " + EicarMarker)),
+                new ExternalScanItem(WriteFile("c.txt", ""))
+            };
+
+            var verdicts = await scanner.ScanBatchAsync(items);
+
+            Assert.Equal(ExternalScanStatus.Clean, verdicts[0].Status);
+            Assert.Equal(ExternalScanStatus.Infected, verdicts[1].Status);
+            Assert.Equal("Eicar-Test-Signature", verdicts[1].ThreatName);
+            Assert.Equal(ExternalScanStatus.Infected, verdicts[2].Status);
+            Assert.Equal(ExternalScanStatus.Clean, verdicts[3].Status);
+            Assert.Equal(1, server.ConnectionCount);
+            Assert.Equal(4, server.ScanCount);
+        }
+
+        [Fact]
+        public async Task SequentialBatches_ShouldReusePooledSession()
+        {
+            using var server = new StubClamd();
+            using var scanner = CreateScanner(server);
+            var path = WriteFile("clean.txt", "clean");
+
+            for (int i = 0; i < 5; i++)
+                await scanner.ScanBatchAsync(new[] { new ExternalScanItem(path) });
+
+            Assert.Equal(1, server.ConnectionCount);
+            Assert.Equal(1, scanner.SessionsOpened);
+            Assert.Equal(5, server.ScanCount);
+        }
+
+        [Fact]
+        public async Task SessionClosedByDaemon_ShouldReconnectTransparently()
+        {
+            using var server = new StubClamd { CloseAfterCommands = 1 };
+            using var scanner = CreateScanner(server);
+            var path = WriteFile("clean.txt", "clean");
+
+            var first = await scanner.ScanBatchAsync(new[] { new ExternalScanItem(path) });
+            await Task.Delay(50);
+            var second = await scanner.ScanBatchAsync(new[] { new ExternalScanItem(path) });
+
+            Assert.Equal(ExternalScanStatus.Clean, first[0].Status);
+            Assert.Equal(ExternalScanStatus.Clean, second[0].Status);
+            Assert.Equal(2, scanner.SessionsOpened);
+        }
+
+        [Fact]
+        public async Task OversizedAndMissingFiles_ShouldNotBeSent()
+        {
+            using var server = new StubClamd();
+            using var scanner = CreateScanner(server, maxStreamBytes: 8);
+
+            var verdicts = await scanner.ScanBatchAsync(new[]
+            {
+                new ExternalScanItem(WriteFile("big.txt", "more than eight bytes")),
+                new ExternalScanItem(Path.Combine(_testDir, "missing.txt"))
+            });
+
+            Assert.Equal(ExternalScanStatus.Skipped, verdicts[0].Status);
+            Assert.Equal(ExternalScanStatus.Failed, verdicts[1].Status);
+            Assert.Equal(0, server.ConnectionCount);
+        }
+
+        [Fact]
+        public void SessionReplies_ShouldParse()
+        {
+            Assert.Equal((7, ExternalScanVerdict.Clean), ClamdScanner.ParseSessionReply("7: stream: OK"));
+
+            var (id, infected) = ClamdScanner.ParseSessionReply("12: stream: Win.Trojan.Agent-1 FOUND");
+            Assert.Equal(12, id);
+            Assert.Equal("Win.Trojan.Agent-1", infected.ThreatName);
+
+            var (_, error) = ClamdScanner.ParseSessionReply("3: INSTREAM size limit exceeded. ERROR");
+            Assert.Equal(ExternalScanStatus.Failed, error.Status);
+            Assert.Equal("INSTREAM size limit exceeded.", error.Message);
+
+            Assert.Throws<InvalidDataException>(() => ClamdScanner.ParseSessionReply("garbage"));
+        }
+
+        [Fact]
+        public async Task Engine_ShouldCoalesceConcurrentScansIntoBatches()
+        {
+            using var server = new StubClamd { ReplyDelay = TimeSpan.FromMilliseconds(30) };
+            var scanner = CreateScanner(server, maxConnections: 1);
+            Assert.True(await scanner.PingAsync());
+            using var engine = new ExternalScannerEngine(scanner, "ClamAvEngine");
+
+            var contexts = Enumerable.Range(0, 20)
+                .Select(i => ThreatScanContext.FromFile(WriteFile($"f{i}.txt", i == 7 ? EicarMarker : $"clean {i}")))
+                .ToList();
+
+            var results = await Task.WhenAll(contexts.Select(c => engine.ScanAsync(c)));
+
+            Assert.Equal(EngineVerdict.Malicious, results[7].Verdict);
+            Assert.Equal(95, results[7].Score);
+            Assert.Equal(19, results.Count(r => r.Verdict == EngineVerdict.Clean && !r.HasError));
+            Assert.Equal(20, server.ScanCount);
+            Assert.True(engine.BatchesDispatched < 20);
+            Assert.Equal(1, server.ConnectionCount);
+        }
+
+        /// <summary>
+        /// خادم clamd مصغّر: zPING و zIDSESSION و zINSTREAM و zEND
+        /// يكتشف أي محتوى يحوي علامة EICAR
+        /// </summary>
+        private sealed class StubClamd : IDisposable
+        {
+            private readonly TcpListener _listener = new(IPAddress.Loopback, 0);
+            private readonly CancellationTokenSource _cts = new();
+            private int _connections;
+            private int _scans;
+
+            public StubClamd()
+            {
+                _listener.Start();
+                Port = ((IPEndPoint)_listener.LocalEndpoint).Port;
+                _ = Task.Run(AcceptLoopAsync);
+            }
+
+            public int Port { get; }
+            public int ConnectionCount => Volatile.Read(ref _connections);
+            public int ScanCount => Volatile.Read(ref _scans);
+
+            /// <summary>
+            /// الرد على أوامر الجلسة بترتيب عشوائي (كما يفعل clamd)
+            /// </summary>
+            public bool ShuffleReplies { get; init; }
+
+            /// <summary>
+            /// إغلاق الجلسة بعد عدد أوامر (محاكاة IdleTimeout)
+            /// </summary>
+            public int CloseAfterCommands { get; init; }
+
+            public TimeSpan ReplyDelay { get; init; }
+
+            private async Task AcceptLoopAsync()
+            {
+                while (!_cts.IsCancellationRequested)
+                {
+                    TcpClient client;
+                    try
+                    {
+                        client = await _listener.AcceptTcpClientAsync(_cts.Token);
+                    }
+                    catch
+                    {
+                        return;
+                    }
+
+                    _ = Task.Run(() => HandleAsync(client));
+                }
+            }
+
+            private async Task HandleAsync(TcpClient client)
+            {
+                using var _ = client;
+                var stream = client.GetStream();
+                var writeLock = new SemaphoreSlim(1);
+                var replies = new List<Task>();
+                var random = new Random();
+                int requestId = 0;
+                bool inSession = false;
+
+                try
+                {
+                    while (true)
+                    {
+                        var command = await ReadCommandAsync(stream);
+                        if (command == null || command == "zEND")
+                            break;
+
+                        if (command == "zIDSESSION")
+                        {
+                            inSession = true;
+                            Interlocked.Increment(ref _connections);
+                            continue;
+                        }
+
+                        string reply;
+                        if (command == "zPING")
+                        {
+                            reply = "PONG";
+                        }
+                        else if (command == "zINSTREAM")
+                        {
+                            var content = await ReadStreamAsync(stream);
+                            Interlocked.Increment(ref _scans);
+                            reply = Encoding.ASCII.GetString(content).Contains(EicarMarker)
+                                ? "stream: Eicar-Test-Signature FOUND"
+                                : "stream: OK";
+                        }
+                        else
+                        {
+                            reply = "UNKNOWN COMMAND";
+                        }
+
+                        if (!inSession)
+                        {
+                            await WriteReplyAsync(stream, writeLock, reply);
+                            break;
+                        }
+
+                        var id = ++requestId;
+                        var delay = ShuffleReplies ? TimeSpan.FromMilliseconds(random.Next(0, 20)) : ReplyDelay;
+                        replies.Add(Task.Run(async () =>
+                        {
+                            await Task.Delay(delay);
+                            await WriteReplyAsync(stream, writeLock, $"{id}: {reply}");
+                        }));
+
+                        if (CloseAfterCommands > 0 && requestId >= CloseAfterCommands)
+                            break;
+                    }
+
+                    await Task.WhenAll(replies);
+                }
+                catch
+                {
+                    // انقطاع العميل
+                }
+            }
+
+            private static async Task WriteReplyAsync(NetworkStream stream, SemaphoreSlim writeLock, string reply)
+            {
+                await writeLock.WaitAsync();
+                try
+                {
+                    await stream.WriteAsync(Encoding.ASCII.GetBytes(reply + "\0"));
+                }
+                finally
+                {
+                    writeLock.Release();
+                }
+            }
+
+            private static async Task<string?> ReadCommandAsync(NetworkStream stream)
+            {
+                var builder = new StringBuilder();
+                var one = new byte[1];
+                while (true)
+                {
+                    if (await stream.ReadAsync(one) == 0)
+                        return null;
+                    if (one[0] == 0)
+                        return builder.ToString();
+                    builder.Append((char)one[0]);
+                }
+            }
+
+            private static async Task<byte[]> ReadStreamAsync(NetworkStream stream)
+            {
+                var content = new MemoryStream();
+                var header = new byte[4];
+                while (true)
+                {
+                    await stream.ReadExactlyAsync(header);
+                    var length = BinaryPrimitives.ReadInt32BigEndian(header);
+                    if (length == 0)
+                        return content.ToArray();
+
+                    var chunk = new byte[length];
+                    await stream.ReadExactlyAsync(chunk);
+                    content.Write(chunk);
+                }
+            }
+
+            public void Dispose()
+            {
+                _cts.Cancel();
+                _listener.Stop();
+            }
+        }
+    }
+}
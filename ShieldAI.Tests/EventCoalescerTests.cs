@@ -4,7 +4,9 @@
 // اختبارات EventCoalescer - تجميع الأحداث والتأخير
 // =====================================================
 
+using ShieldAI.Core.Configuration;
 using ShieldAI.Core.Monitoring.Pipeline;
+using ShieldAI.Core.Scanning;
 using Xunit;
 
 namespace ShieldAI.Tests
@@ -92,6 +94,117 @@ namespace ShieldAI.Tests
             Assert.Equal(3, eventCount);
         }
 
+        [Fact]
+        public async Task Coalescer_ShouldKeepQuickGateFlagAcrossMergedEvents()
+        {
+            // Arrange
+            int coalesceMs = 200;
+            using var coalescer = new EventCoalescer(_queue, coalesceMs);
+
+            var testFile = Path.Combine(_testDir, "payload.bin");
+            File.WriteAllText(testFile, "content");
+
+            // Act - only the middle event saw executable content
+            coalescer.Add(testFile, WatcherChangeTypes.Created);
+            coalescer.Add(testFile, WatcherChangeTypes.Changed, requiresQuickGate: true);
+            coalescer.Add(testFile, WatcherChangeTypes.Changed);
+
+            await Task.Delay(coalesceMs + 500);
+
+            // Assert
+            Assert.True(_queue.TryDequeue(out var fileEvent));
+            Assert.True(fileEvent!.RequiresQuickGate);
+            Assert.False(_queue.TryDequeue(out _));
+        }
+
+        [Fact]
+        public async Task Coalescer_ShouldKeepLastKnownOriginProcess()
+        {
+            // Arrange
+            int coalesceMs = 200;
+            using var coalescer = new EventCoalescer(_queue, coalesceMs);
+
+            var testFile = Path.Combine(_testDir, "dropper.bin");
+            File.WriteAllText(testFile, "content");
+
+            // Act - الحدث الأخير بلا PID (مصدر النقل) لا يمحو PID الكاتب
+            coalescer.Add(testFile, WatcherChangeTypes.Changed, originProcessId: 4242);
+            coalescer.Add(testFile, WatcherChangeTypes.Renamed);
+
+            await Task.Delay(coalesceMs + 500);
+
+            // Assert
+            Assert.True(_queue.TryDequeue(out var fileEvent));
+            Assert.Equal(4242, fileEvent!.OriginProcessId);
+        }
+
+        [Fact]
+        public async Task Coalescer_NotReadyFile_ShouldBeRetriedInsteadOfDropped()
+        {
+            // Arrange - ملف فارغ (الكاتب لم ينته بعد)
+            int coalesceMs = 100;
+            using var coalescer = new EventCoalescer(_queue, coalesceMs);
+
+            var testFile = Path.Combine(_testDir, "downloading.bin");
+            File.WriteAllBytes(testFile, Array.Empty<byte>());
+
+            // Act
+            coalescer.Add(testFile, WatcherChangeTypes.Created);
+            await Task.Delay(coalesceMs + 150);
+
+            Assert.False(_queue.TryDequeue(out _));
+            Assert.Equal(1, coalescer.RetryPendingCount);
+
+            File.WriteAllText(testFile, "finished");
+            await Task.Delay(coalesceMs * 4 + 300);
+
+            // Assert
+            Assert.True(_queue.TryDequeue(out var fileEvent));
+            Assert.Equal(testFile, fileEvent!.FilePath);
+            Assert.Equal(0, coalescer.PendingCount);
+            Assert.Equal(0, coalescer.RetryPendingCount);
+        }
+
+        [Fact]
+        public async Task Coalescer_RetriesExhausted_ShouldDropAndCount()
+        {
+            int coalesceMs = 100;
+            using var coalescer = new EventCoalescer(_queue, coalesceMs)
+            {
+                MaxReadinessRetries = 1,
+                MaxRetryDelayMs = 100
+            };
+
+            var testFile = Path.Combine(_testDir, "empty.bin");
+            File.WriteAllBytes(testFile, Array.Empty<byte>());
+
+            coalescer.Add(testFile, WatcherChangeTypes.Created);
+            await Task.Delay(coalesceMs * 3 + 300);
+
+            Assert.False(_queue.TryDequeue(out _));
+            Assert.Equal(0, coalescer.PendingCount);
+            Assert.Equal(1, coalescer.DroppedCount);
+        }
+
+        [Fact]
+        public void Coalescer_LargeBacklog_ShouldTrackAllPaths()
+        {
+            using var coalescer = new EventCoalescer(_queue, 2000);
+
+            for (int i = 0; i < 100_000; i++)
+            {
+                coalescer.Add(Path.Combine(_testDir, $"f{i}.txt"), WatcherChangeTypes.Changed);
+            }
+
+            // أحداث مكررة لا تضيف عناصر جديدة
+            for (int i = 0; i < 1_000; i++)
+            {
+                coalescer.Add(Path.Combine(_testDir, $"f{i}.txt"), WatcherChangeTypes.Changed);
+            }
+
+            Assert.Equal(100_000, coalescer.PendingCount);
+        }
+
         [Fact]
         public async Task Coalescer_NonExistentFile_ShouldNotEnqueue()
         {
@@ -204,6 +317,197 @@ namespace ShieldAI.Tests
             Assert.False(success);
         }
 
+        [Theory]
+        [InlineData("setup.exe", false, FileEventLane.High)]
+        [InlineData("run.ps1", false, FileEventLane.High)]
+        [InlineData("payload.bin", true, FileEventLane.High)]
+        [InlineData("report.docx", false, FileEventLane.Normal)]
+        [InlineData("archive.zip", false, FileEventLane.Normal)]
+        [InlineData("build.o", false, FileEventLane.Low)]
+        public void Classify_ShouldPickLaneByContent(string fileName, bool requiresQuickGate, FileEventLane expected)
+        {
+            var lane = FileEventQueue.Classify(new FileEvent
+            {
+                FilePath = Path.Combine(Path.GetTempPath(), fileName),
+                RequiresQuickGate = requiresQuickGate
+            });
+
+            Assert.Equal(expected, lane);
+        }
+
+        [Fact]
+        public void Classify_DownloadsFolder_ShouldBeHighPriority()
+        {
+            var path = Path.Combine(Path.GetTempPath(), "Downloads", "movie.mkv");
+
+            Assert.Equal(FileEventLane.High, FileEventQueue.Classify(new FileEvent { FilePath = path }));
+        }
+
+        [Fact]
+        public void Classify_ShouldUseDownloadFoldersFromPathPolicy()
+        {
+            var incoming = Path.Combine(Path.GetTempPath(), "incoming");
+            var policy = PathPolicy.FromSettings(new AppSettings { DownloadFolders = { incoming } });
+
+            Assert.Equal(FileEventLane.High, FileEventQueue.Classify(
+                new FileEvent { FilePath = Path.Combine(incoming, "movie.mkv") }, policy));
+            Assert.Equal(FileEventLane.Low, FileEventQueue.Classify(
+                new FileEvent { FilePath = Path.Combine(Path.GetTempPath(), "outgoing", "movie.mkv") }, policy));
+        }
+
+        [Fact]
+        public void LowLaneStorm_ShouldNotEvictExecutables()
+        {
+            using var queue = new FileEventQueue(new FileEventQueueOptions
+            {
+                HighCapacity = 10,
+                NormalCapacity = 10,
+                LowCapacity = 100
+            });
+
+            queue.TryEnqueue(new FileEvent { FilePath = "fresh.exe" });
+            for (int i = 0; i < 1_000; i++)
+                queue.TryEnqueue(new FileEvent { FilePath = $"out{i}.o" });
+
+            var stats = queue.GetLaneStats();
+            Assert.Equal(1, stats.Single(s => s.Lane == FileEventLane.High).Pending);
+            Assert.Equal(0, stats.Single(s => s.Lane == FileEventLane.High).Dropped);
+            Assert.Equal(900, stats.Single(s => s.Lane == FileEventLane.Low).Dropped);
+
+            Assert.True(queue.TryDequeue(out var first));
+            Assert.Equal("fresh.exe", first!.FilePath);
+        }
+
+        [Fact]
+        public void FullLane_ShouldReportDroppedEvents()
+        {
+            using var queue = new FileEventQueue(new FileEventQueueOptions { LowCapacity = 2 });
+            var dropped = new List<string>();
+            queue.EventDropped += (_, e) => dropped.Add(e.FilePath);
+
+            queue.TryEnqueue(new FileEvent { FilePath = "a.o" });
+            queue.TryEnqueue(new FileEvent { FilePath = "b.o" });
+            queue.TryEnqueue(new FileEvent { FilePath = "c.o" });
+
+            Assert.Equal("a.o", Assert.Single(dropped));
+        }
+
+        [Fact]
+        public void FullHighLane_ShouldKeepOldestAndReportOverflow()
+        {
+            using var queue = new FileEventQueue(new FileEventQueueOptions
+            {
+                HighCapacity = 1,
+                HighLaneBackpressureMs = 20
+            });
+            var dropped = new List<string>();
+            queue.EventDropped += (_, e) => dropped.Add(e.FilePath);
+
+            Assert.True(queue.TryEnqueue(new FileEvent { FilePath = "download.exe" }));
+            Assert.False(queue.TryEnqueue(new FileEvent { FilePath = "build.dll" }));
+
+            Assert.Equal("build.dll", Assert.Single(dropped));
+            Assert.Equal(1, queue.GetLaneStats().Single(s => s.Lane == FileEventLane.High).Dropped);
+            Assert.True(queue.TryDequeue(out var first));
+            Assert.Equal("download.exe", first!.FilePath);
+        }
+
+        [Fact]
+        public async Task FullHighLane_ShouldWaitForConsumer()
+        {
+            using var queue = new FileEventQueue(new FileEventQueueOptions
+            {
+                HighCapacity = 1,
+                HighLaneBackpressureMs = 5_000
+            });
+
+            queue.TryEnqueue(new FileEvent { FilePath = "a.exe" });
+            var consumer = Task.Run(async () =>
+            {
+                await Task.Delay(100);
+                return queue.TryDequeue(out var fileEvent) ? fileEvent!.FilePath : null;
+            });
+
+            Assert.True(queue.TryEnqueue(new FileEvent { FilePath = "b.exe" }));
+            Assert.Equal("a.exe", await consumer);
+            Assert.Equal(0, queue.GetLaneStats().Single(s => s.Lane == FileEventLane.High).Dropped);
+        }
+
+        [Fact]
+        public void StrictMode_ShouldDrainHigherLanesFirst()
+        {
+            using var queue = new FileEventQueue(new FileEventQueueOptions { Mode = LaneDequeueMode.Strict });
+
+            queue.TryEnqueue(new FileEvent { FilePath = "a.o" });
+            queue.TryEnqueue(new FileEvent { FilePath = "b.pdf" });
+            queue.TryEnqueue(new FileEvent { FilePath = "c.exe" });
+
+            var order = new List<string>();
+            while (queue.TryDequeue(out var fileEvent))
+                order.Add(fileEvent!.FilePath);
+
+            Assert.Equal(new[] { "c.exe", "b.pdf", "a.o" }, order);
+        }
+
+        [Fact]
+        public void WeightedMode_ShouldNotStarveLowLane()
+        {
+            using var queue = new FileEventQueue(new FileEventQueueOptions
+            {
+                Mode = LaneDequeueMode.Weighted,
+                HighWeight = 3,
+                NormalWeight = 1,
+                LowWeight = 1
+            });
+
+            for (int i = 0; i < 50; i++)
+            {
+                queue.TryEnqueue(new FileEvent { FilePath = $"h{i}.exe" });
+                queue.TryEnqueue(new FileEvent { FilePath = $"l{i}.o" });
+            }
+
+            // في أول 10 عمليات سحب يجب أن يحصل المسار المنخفض على نصيبه
+            var firstTen = new List<string>();
+            for (int i = 0; i < 10; i++)
+            {
+                Assert.True(queue.TryDequeue(out var fileEvent));
+                firstTen.Add(fileEvent!.FilePath);
+            }
+
+            Assert.Contains(firstTen, p => p.EndsWith(".o"));
+            Assert.True(firstTen.Count(p => p.EndsWith(".exe")) > firstTen.Count(p => p.EndsWith(".o")));
+        }
+
+        [Fact]
+        public async Task ReadAllAsync_ShouldCompleteAfterDrain()
+        {
+            using var queue = new FileEventQueue();
+            queue.TryEnqueue(new FileEvent { FilePath = "a.exe" });
+            queue.TryEnqueue(new FileEvent { FilePath = "b.txt" });
+            queue.Complete();
+
+            var read = new List<string>();
+            await foreach (var fileEvent in queue.ReadAllAsync())
+                read.Add(fileEvent.FilePath);
+
+            Assert.Equal(2, read.Count);
+        }
+
+        [Fact]
+        public async Task DequeueAsync_ShouldWakeOnEnqueue()
+        {
+            using var queue = new FileEventQueue();
+
+            var pending = queue.DequeueAsync().AsTask();
+            await Task.Delay(50);
+            Assert.False(pending.IsCompleted);
+
+            queue.TryEnqueue(new FileEvent { FilePath = "late.exe" });
+            var fileEvent = await pending.WaitAsync(TimeSpan.FromSeconds(5));
+
+            Assert.Equal("late.exe", fileEvent.FilePath);
+        }
+
         [Fact]
         public void PendingCount_ShouldTrack()
         {
@@ -61,6 +61,82 @@ namespace ShieldAI.Tests
             Assert.Equal(3, files.Count);
         }
 
+        [Fact]
+        public void EnumerateFiles_MaxDepth_ShouldStopDescending()
+        {
+            // Arrange
+            var deepDir = Path.Combine(_testDir, "subdir", "deeper");
+            Directory.CreateDirectory(deepDir);
+            File.WriteAllText(Path.Combine(deepDir, "file5.txt"), "content5");
+
+            // Act
+            var depthZero = _enumerator.EnumerateFiles(_testDir, maxDepth: 0).ToList();
+            var depthOne = _enumerator.EnumerateFiles(_testDir, maxDepth: 1).ToList();
+            var unlimited = _enumerator.EnumerateFiles(_testDir, maxDepth: -1).ToList();
+
+            // Assert
+            Assert.Equal(3, depthZero.Count);
+            Assert.Equal(4, depthOne.Count);
+            Assert.Equal(5, unlimited.Count);
+        }
+
+        [Fact]
+        public void EnumerateFiles_ExcludeHidden_ShouldSkipHiddenFiles()
+        {
+            // Arrange
+            var hiddenPath = Path.Combine(_testDir, ".hidden.txt");
+            File.WriteAllText(hiddenPath, "hidden");
+            File.SetAttributes(hiddenPath, File.GetAttributes(hiddenPath) | FileAttributes.Hidden);
+
+            // Act
+            var withHidden = _enumerator.EnumerateFiles(_testDir).ToList();
+            var withoutHidden = _enumerator.EnumerateFiles(_testDir, includeHidden: false).ToList();
+
+            // Assert
+            Assert.Contains(withHidden, f => f.Name == ".hidden.txt");
+            Assert.DoesNotContain(withoutHidden, f => f.Name == ".hidden.txt");
+        }
+
+        [Fact]
+        public void EnumerateFiles_ReusedEnumerator_ShouldReturnSameFiles()
+        {
+            // Act - المجدول والفحص عند الطلب يعيدان استخدام نفس المعدِّد
+            var first = _enumerator.EnumerateFiles(_testDir).Count();
+            var second = _enumerator.EnumerateFiles(_testDir).Count();
+
+            // Assert
+            Assert.Equal(first, second);
+        }
+
+        [Fact]
+        public void EnumerateFiles_ShouldHonourRootedAndMultiSegmentExclusions()
+        {
+            // Arrange - مجلد بمسار مطلق ومقطعان متتاليان (لا يطابقهما اسم مجلد واحد)
+            var rootedDir = Path.Combine(_testDir, "backup");
+            var nestedDir = Path.Combine(_testDir, "cache", "blobs");
+            var sameNameDir = Path.Combine(_testDir, "blobs");
+            foreach (var dir in new[] { rootedDir, nestedDir, sameNameDir })
+            {
+                Directory.CreateDirectory(dir);
+                File.WriteAllText(Path.Combine(dir, "data.bin"), "data");
+            }
+
+            var policy = new PathPolicyBuilder()
+                .Add(rootedDir, PathClass.Excluded)
+                .Add(Path.Combine("cache", "blobs"), PathClass.Excluded)
+                .Build();
+            var enumerator = new FileEnumerator(pathPolicy: policy);
+
+            // Act
+            var files = enumerator.EnumerateFiles(_testDir).Select(f => f.DirectoryName).ToList();
+
+            // Assert
+            Assert.DoesNotContain(rootedDir, files);
+            Assert.DoesNotContain(nestedDir, files);
+            Assert.Contains(sameNameDir, files);
+            Assert.Contains(Path.Combine(_testDir, "subdir"), files);
+        }
+
         [Fact]
         public void EnumerateFiles_SingleFile_ShouldReturnIt()
         {
@@ -103,6 +179,30 @@ namespace ShieldAI.Tests
             // Just checking it doesn't crash
         }
 
+        [Fact]
+        public void EnumerateFilesOrdered_ShouldMatchOrdinalPathOrder()
+        {
+            // Arrange - "a" مجلد و"a.txt" ملف: ترتيب الأسماء يختلف عن ترتيب المسارات الكاملة
+            var root = Path.Combine(_testDir, "ordered");
+            Directory.CreateDirectory(Path.Combine(root, "a", "nested"));
+            File.WriteAllText(Path.Combine(root, "a.txt"), "x");
+            File.WriteAllText(Path.Combine(root, "a", "z.bin"), "x");
+            File.WriteAllText(Path.Combine(root, "a", "nested", "m.bin"), "x");
+            File.WriteAllText(Path.Combine(root, "B.dat"), "x");
+            File.WriteAllText(Path.Combine(root, "b-1.dat"), "x");
+
+            // Act - الجذر المتداخل يُعد مرة واحدة
+            var files = _enumerator
+                .EnumerateFilesOrdered(new[] { Path.Combine(root, "a"), root })
+                .Select(f => f.FullName)
+                .ToList();
+
+            // Assert
+            var expected = files.OrderBy(f => f, StringComparer.Ordinal).ToList();
+            Assert.True(files.SequenceEqual(expected), string.Join(" | ", files));
+            Assert.Equal(5, files.Count);
+        }
+
         [Fact]
         public void EstimateFileCount_ShouldReturnReasonableEstimate()
         {
@@ -0,0 +1,157 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/FileEventSourceTests.cs
+// اختبارات مصادر أحداث الملفات (inotify / fanotify / FileSystemWatcher)
+// =====================================================
+
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Monitoring.EventSources;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class FileEventSourceTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly ConcurrentQueue<FileEventSourceArgs> _events = new();
+
+        public FileEventSourceTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_FES_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private async Task<FileEventSourceArgs?> WaitForEventAsync(
+            Func<FileEventSourceArgs, bool> predicate, int timeoutMs = 5000)
+        {
+            var deadline = DateTime.UtcNow.AddMilliseconds(timeoutMs);
+            while (DateTime.UtcNow < deadline)
+            {
+                var match = _events.FirstOrDefault(predicate);
+                if (match != null) return match;
+                await Task.Delay(20);
+            }
+
+            return null;
+        }
+
+        [Fact]
+        public void Resolve_ExplicitWatcher_ShouldAlwaysBeWatcher()
+        {
+            var kind = FileEventSourceFactory.Resolve(RealtimeEventSourceKind.FileSystemWatcher, () => true);
+            Assert.Equal(RealtimeEventSourceKind.FileSystemWatcher, kind);
+        }
+
+        [Fact]
+        public void Resolve_Auto_ShouldPreferFanotifyThenInotifyOnLinux()
+        {
+            var privileged = FileEventSourceFactory.Resolve(RealtimeEventSourceKind.Auto, () => true);
+            var unprivileged = FileEventSourceFactory.Resolve(RealtimeEventSourceKind.Auto, () => false);
+
+            if (OperatingSystem.IsLinux())
+            {
+                Assert.Equal(RealtimeEventSourceKind.Fanotify, privileged);
+                Assert.Equal(RealtimeEventSourceKind.Inotify, unprivileged);
+            }
+            else
+            {
+                Assert.Equal(RealtimeEventSourceKind.FileSystemWatcher, privileged);
+                Assert.Equal(RealtimeEventSourceKind.FileSystemWatcher, unprivileged);
+            }
+        }
+
+        [Fact]
+        public void StartWithFallback_ShouldReturnStartedSource()
+        {
+            var settings = new AppSettings
+            {
+                RealtimeEventSource = RealtimeEventSourceKind.Auto,
+                InotifyMaxQueuedEvents = 0,
+                InotifyMaxUserWatches = 0
+            };
+
+            using var source = FileEventSourceFactory.StartWithFallback(
+                settings, new[] { _testDir }, (_, e) => _events.Enqueue(e), (_, _) => { });
+
+            Assert.Equal(1, source.WatchedRootCount);
+        }
+
+        [Fact]
+        public async Task Inotify_ShouldReportCloseWriteInNestedDirectories()
+        {
+            if (!InotifyEventSource.IsSupported) return;
+
+            // Arrange
+            var existingDir = Directory.CreateDirectory(Path.Combine(_testDir, "a", "b")).FullName;
+            using var source = new InotifyEventSource();
+            source.FileChanged += (_, e) => _events.Enqueue(e);
+            source.Start(new[] { _testDir });
+
+            // Act - مجلد موجود مسبقاً ومجلد يُنشأ بعد البدء
+            var first = Path.Combine(existingDir, "payload.sh");
+            File.WriteAllText(first, "#!/bin/sh");
+
+            var newDir = Directory.CreateDirectory(Path.Combine(_testDir, "late")).FullName;
+            await Task.Delay(200);
+            var second = Path.Combine(newDir, "dropper.bin");
+            File.WriteAllText(second, "MZ");
+
+            // Assert
+            Assert.NotNull(await WaitForEventAsync(e => e.FullPath == first && e.ChangeType == WatcherChangeTypes.Changed));
+            Assert.NotNull(await WaitForEventAsync(e => e.FullPath == second));
+            Assert.True(source.WatchCount >= 4);
+        }
+
+        [Fact]
+        public async Task Inotify_MoveInto_ShouldReportRenamed()
+        {
+            if (!InotifyEventSource.IsSupported) return;
+
+            // Arrange - الملف يُكتب خارج المراقبة ثم يُنقل (نمط .crdownload)
+            var outside = Path.Combine(Path.GetTempPath(), $"ShieldAI_FES_{Guid.NewGuid():N}.partial");
+            File.WriteAllText(outside, "MZ");
+
+            using var source = new InotifyEventSource(renamesOnly: true);
+            source.FileChanged += (_, e) => _events.Enqueue(e);
+            source.Start(new[] { _testDir });
+
+            // Act
+            var target = Path.Combine(_testDir, "setup.exe");
+            File.Move(outside, target);
+            File.WriteAllText(Path.Combine(_testDir, "ignored.txt"), "text");
+
+            // Assert
+            Assert.NotNull(await WaitForEventAsync(e => e.FullPath == target && e.ChangeType == WatcherChangeTypes.Renamed));
+            Assert.DoesNotContain(_events, e => e.FullPath.EndsWith("ignored.txt"));
+        }
+
+        [Fact]
+        public async Task Fanotify_ShouldReportOriginProcessId()
+        {
+            if (!FanotifyEventSource.IsAvailable() || !File.Exists("/bin/sh")) return;
+
+            // Arrange
+            using var source = new FanotifyEventSource();
+            source.FileChanged += (_, e) => _events.Enqueue(e);
+            source.Start(new[] { _testDir });
+
+            // Act - كتابة من عملية أخرى (كتابات الخدمة نفسها تُتجاهل)
+            var target = Path.Combine(_testDir, "written-by-child.sh");
+            using var child = Process.Start(new ProcessStartInfo("/bin/sh", new[] { "-c", $"echo x > '{target}'" }))!;
+            var childPid = child.Id;
+            await child.WaitForExitAsync();
+
+            // Assert
+            var fileEvent = await WaitForEventAsync(e => e.FullPath == target);
+            Assert.NotNull(fileEvent);
+            Assert.Equal(childPid, fileEvent!.OriginProcessId);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/LoadSheddingPolicyTests.cs
+// اختبارات مستويات تخفيف الحمل والطابور الخلفي
+// =====================================================
+
+using ShieldAI.Core.Monitoring.Pipeline;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class LoadSheddingPolicyTests
+    {
+        private static LoadSheddingPolicy CreatePolicy() => new(new LoadSheddingOptions
+        {
+            ElevatedDepth = 100,
+            HighDepth = 200,
+            CriticalDepth = 400,
+            ElevatedLatencyMs = 1_000,
+            HighLatencyMs = 2_000,
+            CriticalLatencyMs = 4_000,
+            RecoveryRatio = 0.5,
+            RecoveryHoldMs = 1_000
+        });
+
+        [Fact]
+        public void Evaluate_ShouldEscalateImmediatelyOnDepthOrLatency()
+        {
+            var policy = CreatePolicy();
+
+            Assert.Equal(LoadShedTier.Normal, policy.Evaluate(50, 100, nowMs: 0));
+            Assert.Equal(LoadShedTier.High, policy.Evaluate(250, 100, nowMs: 10));
+            // زمن الانتظار وحده يكفي للصعود حتى مع طابور قصير
+            Assert.Equal(LoadShedTier.Critical, policy.Evaluate(10, 5_000, nowMs: 20));
+            Assert.Equal(2, policy.TransitionCount);
+        }
+
+        [Fact]
+        public void Evaluate_ShouldStepDownOneTierAfterHoldTime()
+        {
+            var policy = CreatePolicy();
+            var transitions = new List<LoadTierTransition>();
+            policy.TierChanged += (_, t) => transitions.Add(t);
+
+            policy.Evaluate(500, 0, nowMs: 0);
+            Assert.Equal(LoadShedTier.Critical, policy.CurrentTier);
+
+            // تحت حد الدخول لكن فوق حد الخروج (400 × 0.5) - لا نزول
+            Assert.Equal(LoadShedTier.Critical, policy.Evaluate(300, 0, nowMs: 5_000));
+
+            // تحت حد الخروج - ينتظر مدة التثبيت
+            Assert.Equal(LoadShedTier.Critical, policy.Evaluate(0, 0, nowMs: 6_000));
+            Assert.Equal(LoadShedTier.Critical, policy.Evaluate(0, 0, nowMs: 6_500));
+            Assert.Equal(LoadShedTier.High, policy.Evaluate(0, 0, nowMs: 7_000));
+
+            // كل نزول يحتاج مدة تثبيت جديدة
+            Assert.Equal(LoadShedTier.High, policy.Evaluate(0, 0, nowMs: 7_500));
+            Assert.Equal(LoadShedTier.Elevated, policy.Evaluate(0, 0, nowMs: 8_000));
+            Assert.Equal(LoadShedTier.Normal, policy.Evaluate(0, 0, nowMs: 9_000));
+
+            Assert.Equal(4, transitions.Count);
+            Assert.Equal(LoadShedTier.Normal, transitions[^1].To);
+            Assert.Equal(4, policy.GetRecentTransitions().Count);
+        }
+
+        [Fact]
+        public void Evaluate_SpikeDuringHold_ShouldResetHysteresis()
+        {
+            var policy = CreatePolicy();
+            policy.Evaluate(150, 0, nowMs: 0);
+
+            policy.Evaluate(0, 0, nowMs: 100);
+            // ارتفاع قصير فوق حد الخروج يلغي العد
+            policy.Evaluate(60, 0, nowMs: 900);
+            Assert.Equal(LoadShedTier.Elevated, policy.Evaluate(0, 0, nowMs: 1_200));
+            Assert.Equal(LoadShedTier.Normal, policy.Evaluate(0, 0, nowMs: 2_200));
+        }
+
+        [Fact]
+        public void TierActions_ShouldBeCumulative()
+        {
+            Assert.Equal(1, LoadSheddingPolicy.CoalesceMultiplier(LoadShedTier.Normal));
+            Assert.True(LoadSheddingPolicy.CoalesceMultiplier(LoadShedTier.Critical) >
+                        LoadSheddingPolicy.CoalesceMultiplier(LoadShedTier.Elevated));
+
+            Assert.False(LoadSheddingPolicy.SkipsHeavyEngines(LoadShedTier.Elevated));
+            Assert.True(LoadSheddingPolicy.SkipsHeavyEngines(LoadShedTier.High));
+            Assert.False(LoadSheddingPolicy.DefersNonExecutables(LoadShedTier.High));
+            Assert.True(LoadSheddingPolicy.DefersNonExecutables(LoadShedTier.Critical));
+        }
+
+        [Fact]
+        public void Backlog_ShouldDeduplicateRespectCapacityAndDrainInOrder()
+        {
+            var backlog = new DeferredBacklog(capacity: 2);
+
+            Assert.True(backlog.TryDefer(new FileEvent { FilePath = "/data/a.txt" }));
+            Assert.True(backlog.TryDefer(new FileEvent { FilePath = "/data/a.txt" }));
+            Assert.True(backlog.TryDefer(new FileEvent { FilePath = "/data/b.txt" }));
+            Assert.False(backlog.TryDefer(new FileEvent { FilePath = "/data/c.txt" }));
+
+            Assert.Equal(2, backlog.PendingCount);
+            Assert.Equal(3, backlog.DeferredCount);
+            Assert.Equal(1, backlog.OverflowCount);
+
+            // sink يرفض بعد أول حدث - الباقي يبقى مؤجلاً
+            var drained = new List<string>();
+            Assert.Equal(1, backlog.Drain(e => { if (drained.Count > 0) return false; drained.Add(e.FilePath); return true; }, 10));
+            Assert.Equal("/data/a.txt", Assert.Single(drained));
+            Assert.Equal(1, backlog.PendingCount);
+
+            Assert.Equal(1, backlog.Drain(e => true, 10));
+            Assert.Equal(0, backlog.PendingCount);
+            Assert.Equal(2, backlog.DrainedCount);
+        }
+
+        [Fact]
+        public void Coalescer_WindowMultiplier_ShouldWidenWindow()
+        {
+            using var queue = new FileEventQueue();
+            using var coalescer = new EventCoalescer(queue, 100);
+
+            coalescer.WindowMultiplier = 4;
+            Assert.Equal(400, coalescer.EffectiveCoalesceMs);
+
+            coalescer.WindowMultiplier = 100;
+            Assert.Equal(1_600, coalescer.EffectiveCoalesceMs);
+        }
+    }
+}
@@ -0,0 +1,145 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/LocalPrevalenceStoreTests.cs
+// اختبارات مخزن الانتشار المحلي (سجل إلحاقي)
+// =====================================================
+
+using System.Text.Json;
+using ShieldAI.Core.Detection.ThreatScoring;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class LocalPrevalenceStoreTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly string _storePath;
+
+        public LocalPrevalenceStoreTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_Prev_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+            _storePath = Path.Combine(_testDir, "reputation_store.dat");
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private static string Hash(int i) => i.ToString("x64");
+
+        [Fact]
+        public void Record_ShouldNotWriteUntilFlush_AndCoalesceRepeatedHashes()
+        {
+            using var store = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0);
+
+            for (int i = 0; i < 10; i++)
+                store.Record(Hash(1));
+            store.Record(Hash(2));
+
+            Assert.False(File.Exists(_storePath));
+            Assert.Equal(2, store.PendingWrites);
+
+            store.Flush();
+
+            // سجل واحد لكل بصمة في الدفعة: ترويسة 6 بايت + سجلان
+            Assert.Equal(6 + 2 * 56, new FileInfo(_storePath).Length);
+            Assert.Equal(0, store.PendingWrites);
+            Assert.Equal(2, store.LogRecordCount);
+        }
+
+        [Fact]
+        public void Reload_ShouldRestoreLatestEntryPerDigest()
+        {
+            using (var store = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0))
+            {
+                store.Record(Hash(7));
+                store.Flush();
+                store.Record(Hash(7));
+                store.Record(Hash(7).ToUpperInvariant());
+                store.Flush();
+            }
+
+            using var reloaded = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0);
+
+            Assert.True(reloaded.TryGet(Hash(7), out var entry));
+            Assert.Equal(3, entry.SeenCount);
+            Assert.True(entry.FirstSeenUtc <= entry.LastSeenUtc);
+            Assert.Equal(1, reloaded.Count);
+        }
+
+        [Fact]
+        public void TornTail_ShouldBeTruncatedOnLoad()
+        {
+            using (var store = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0))
+            {
+                store.Record(Hash(1));
+                store.Record(Hash(2));
+                store.Flush();
+            }
+
+            // كتابة انقطعت في منتصف سجل
+            using (var stream = new FileStream(_storePath, FileMode.Append))
+                stream.Write(new byte[20]);
+
+            using (var store = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0))
+            {
+                Assert.Equal(2, store.Count);
+                store.Record(Hash(3));
+                store.Flush();
+            }
+
+            using var reloaded = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0);
+            Assert.Equal(3, reloaded.Count);
+            Assert.True(reloaded.TryGet(Hash(3), out _));
+        }
+
+        [Fact]
+        public void Flush_ShouldCompactWhenLogOutgrowsLiveEntries()
+        {
+            using var store = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0);
+
+            // 10 بصمات تتكرر عبر دفعات كثيرة - السجل ينمو والإدخالات الحية ثابتة
+            for (int round = 0; round < 500; round++)
+            {
+                for (int i = 0; i < 10; i++)
+                    store.Record(Hash(i));
+                store.Flush();
+            }
+
+            Assert.True(store.CompactionCount > 0);
+            Assert.True(store.LogRecordCount <= 4096 + 10);
+
+            store.Compact();
+            Assert.Equal(10, store.LogRecordCount);
+            Assert.Equal(6 + 10 * 56, new FileInfo(_storePath).Length);
+
+            Assert.True(store.TryGet(Hash(3), out var entry));
+            Assert.Equal(500, entry.SeenCount);
+        }
+
+        [Fact]
+        public void LegacyJson_ShouldBeMigratedAndRemoved()
+        {
+            var legacyPath = Path.Combine(_testDir, "reputation_store.json");
+            var first = new DateTime(2024, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+            File.WriteAllText(legacyPath, JsonSerializer.Serialize(new Dictionary<string, PrevalenceEntry>
+            {
+                [Hash(42)] = new PrevalenceEntry { FirstSeenUtc = first, LastSeenUtc = first, SeenCount = 9 }
+            }));
+
+            using (var store = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0))
+            {
+                Assert.True(store.TryGet(Hash(42), out var migrated));
+                Assert.Equal(9, migrated.SeenCount);
+            }
+
+            Assert.False(File.Exists(legacyPath));
+
+            using var reloaded = new LocalPrevalenceStore(_storePath, flushIntervalMs: 0);
+            Assert.True(reloaded.TryGet(Hash(42), out var entry));
+            Assert.Equal(first, entry.FirstSeenUtc);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/MetadataPreGateTests.cs
+// اختبارات الفرز الأولي بالبيانات الوصفية
+// =====================================================
+
+using System.Text;
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Monitoring.Pipeline;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class MetadataPreGateTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly AppSettings _settings;
+
+        public MetadataPreGateTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_PreGate_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+
+            _settings = new AppSettings
+            {
+                MaxFileSizeMB = 1,
+                ExcludedExtensions = new List<string> { "iso" },
+                ExcludedFolders = new List<string> { "node_modules" }
+            };
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private string CreateFile(string name, byte[] content)
+        {
+            var path = Path.Combine(_testDir, name);
+            Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+            File.WriteAllBytes(path, content);
+            return path;
+        }
+
+        [Fact]
+        public void ExecutableExtension_ShouldRequireQuickGate()
+        {
+            var path = CreateFile("setup.exe", Encoding.ASCII.GetBytes("not really a PE"));
+
+            Assert.Equal(PreGateDecision.QuickGate, new MetadataPreGate(_settings).Evaluate(path));
+        }
+
+        [Fact]
+        public void PeHeaderWithInnocentExtension_ShouldRequireQuickGate()
+        {
+            var content = new byte[512];
+            content[0] = (byte)'M';
+            content[1] = (byte)'Z';
+            var path = CreateFile("invoice.pdf", content);
+
+            Assert.Equal(PreGateDecision.QuickGate, new MetadataPreGate(_settings).Evaluate(path));
+        }
+
+        [Fact]
+        public void PlainDocument_ShouldGoToNormalScan()
+        {
+            var path = CreateFile("notes.txt", Encoding.UTF8.GetBytes("just some text"));
+
+            Assert.Equal(PreGateDecision.Scan, new MetadataPreGate(_settings).Evaluate(path));
+        }
+
+        [Fact]
+        public void PathPolicy_ShouldSkipExcludedAndTemporaryFiles()
+        {
+            var preGate = new MetadataPreGate(_settings);
+
+            Assert.Equal(PreGateDecision.Skip, preGate.Evaluate(CreateFile("disk.iso", new byte[] { 1 })));
+            Assert.Equal(PreGateDecision.Skip, preGate.Evaluate(CreateFile("build.tmp", new byte[] { 1 })));
+            Assert.Equal(PreGateDecision.Skip, preGate.Evaluate(CreateFile("~$report.docx", new byte[] { 1 })));
+            Assert.Equal(PreGateDecision.Skip, preGate.Evaluate(
+                CreateFile(Path.Combine("node_modules", "pkg", "index.exe"), new byte[] { 1 })));
+        }
+
+        [Fact]
+        public void OversizedOrMissingFile_ShouldBeSkipped()
+        {
+            var preGate = new MetadataPreGate(_settings);
+
+            Assert.Equal(PreGateDecision.Skip, preGate.Evaluate(CreateFile("big.exe", new byte[2 * 1024 * 1024])));
+            Assert.Equal(PreGateDecision.Skip, preGate.Evaluate(Path.Combine(_testDir, "missing.exe")));
+        }
+
+        [Theory]
+        [InlineData(new byte[] { 0x7F, 0x45, 0x4C, 0x46 }, true)]   // ELF
+        [InlineData(new byte[] { 0x23, 0x21, 0x2F, 0x62 }, true)]   // #!/b
+        [InlineData(new byte[] { 0xD0, 0xCF, 0x11, 0xE0 }, true)]   // OLE
+        [InlineData(new byte[] { 0x25, 0x50, 0x44, 0x46 }, false)]  // %PDF
+        [InlineData(new byte[] { 0x50, 0x4B, 0x03, 0x04 }, false)]  // ZIP
+        public void IsExecutableContent_ShouldClassifyMagicBytes(byte[] header, bool expected)
+        {
+            Assert.Equal(expected, MetadataPreGate.IsExecutableContent(header));
+        }
+    }
+}
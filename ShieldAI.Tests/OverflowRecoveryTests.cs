@@ -0,0 +1,161 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/OverflowRecoveryTests.cs
+// اختبارات لقطة المجلدات واستعادة الأحداث بعد الفيضان
+// =====================================================
+
+using System.Collections.Concurrent;
+using ShieldAI.Core.Monitoring.EventSources;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class OverflowRecoveryTests : IDisposable
+    {
+        private readonly string _testDir;
+
+        public OverflowRecoveryTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_OVR_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private string CreateFile(string relativePath, string content = "data")
+        {
+            var path = Path.Combine(_testDir, relativePath);
+            Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+            File.WriteAllText(path, content);
+            File.SetLastWriteTimeUtc(path, DateTime.UtcNow.AddHours(-1));
+            return path;
+        }
+
+        [Fact]
+        public void Diff_ShouldReturnOnlyNewAndModifiedFiles()
+        {
+            // Arrange
+            for (int i = 0; i < 50; i++)
+                CreateFile(Path.Combine("docs", $"file{i}.txt"));
+            var modified = Path.Combine(_testDir, "docs", "file7.txt");
+
+            var store = new DirectorySnapshotStore();
+            store.Capture(_testDir);
+
+            // Act - تعديل ملف وإضافة ملف، والباقي دون تغيير
+            File.WriteAllText(modified, "changed content");
+            var added = Path.Combine(_testDir, "docs", "new.exe");
+            File.WriteAllText(added, "MZ");
+
+            var changed = store.DiffAndRefresh(_testDir);
+
+            // Assert
+            Assert.Equal(2, changed.Count);
+            Assert.Contains(modified, changed);
+            Assert.Contains(added, changed);
+            Assert.Equal(51, store.FileCount);
+        }
+
+        [Fact]
+        public void Diff_RecordedEvents_ShouldNotBeReportedAgain()
+        {
+            var path = CreateFile("a.txt");
+            var store = new DirectorySnapshotStore();
+            store.Capture(_testDir);
+
+            // الحدث وصل عادياً قبل الفيضان
+            File.WriteAllText(path, "delivered write");
+            store.Record(path);
+
+            Assert.Empty(store.DiffAndRefresh(_testDir));
+        }
+
+        [Fact]
+        public void Diff_NewDirectory_ShouldReportAllItsFiles_AndDropDeletedDirectories()
+        {
+            CreateFile(Path.Combine("old", "x.txt"));
+            var store = new DirectorySnapshotStore();
+            store.Capture(_testDir);
+
+            Directory.Delete(Path.Combine(_testDir, "old"), true);
+            var first = CreateFile(Path.Combine("extracted", "one.dll"));
+            var second = CreateFile(Path.Combine("extracted", "nested", "two.dll"));
+
+            var changed = store.DiffAndRefresh(_testDir);
+
+            Assert.Equal(2, changed.Count);
+            Assert.Contains(first, changed);
+            Assert.Contains(second, changed);
+            Assert.Equal(2, store.FileCount);
+        }
+
+        [Fact]
+        public void Diff_ShouldBeLimitedToAffectedSubtree()
+        {
+            CreateFile(Path.Combine("a", "1.txt"));
+            CreateFile(Path.Combine("b", "1.txt"));
+            var store = new DirectorySnapshotStore();
+            store.Capture(_testDir);
+
+            var inA = Path.Combine(_testDir, "a", "2.txt");
+            var inB = Path.Combine(_testDir, "b", "2.txt");
+            File.WriteAllText(inA, "new");
+            File.WriteAllText(inB, "new");
+
+            var changed = store.DiffAndRefresh(Path.Combine(_testDir, "a"));
+
+            Assert.Equal(inA, Assert.Single(changed));
+        }
+
+        [Fact]
+        public void Truncated_ShouldFallBackToModificationTime()
+        {
+            // Arrange - لقطة بسعة ملفين فقط
+            CreateFile(Path.Combine("a", "1.txt"));
+            CreateFile(Path.Combine("a", "2.txt"));
+            CreateFile(Path.Combine("b", "old.txt"));
+
+            var store = new DirectorySnapshotStore(maxFiles: 2);
+            store.Capture(_testDir);
+            Assert.True(store.IsTruncated);
+
+            // Act - المجلد الذي لم يتسع في اللقطة: فقط ما عُدّل بعد المزامنة يُبلَّغ
+            var fresh = Path.Combine(_testDir, "b", "fresh.txt");
+            File.WriteAllText(fresh, "new");
+
+            var changed = store.DiffAndRefresh(_testDir);
+
+            // Assert
+            Assert.Equal(fresh, Assert.Single(changed));
+        }
+
+        [Fact]
+        public async Task Recovery_OnOverflow_ShouldReinjectChangedFiles()
+        {
+            // Arrange
+            CreateFile("stable.txt");
+            var reinjected = new ConcurrentQueue<string>();
+            using var recovery = new OverflowRecovery(reinjected.Enqueue, delayMs: 0);
+            recovery.Start(new[] { _testDir });
+            await recovery.CaptureCompletion;
+
+            var lost = Path.Combine(_testDir, "lost-event.exe");
+            File.WriteAllText(lost, "MZ");
+
+            // Act
+            Assert.False(recovery.HandleError(this, new IOException("unrelated")));
+            Assert.True(recovery.HandleError(this, new EventSourceOverflowException("overflow", _testDir)));
+
+            var deadline = DateTime.UtcNow.AddSeconds(5);
+            while (recovery.RecoveryCount == 0 && DateTime.UtcNow < deadline)
+                await Task.Delay(20);
+
+            // Assert
+            Assert.Equal(lost, Assert.Single(reinjected));
+            Assert.Equal(1, recovery.RecoveredFileCount);
+        }
+    }
+}
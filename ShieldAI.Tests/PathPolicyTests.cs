@@ -0,0 +1,117 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/PathPolicyTests.cs
+// اختبارات سياسة المسارات المترجمة
+// =====================================================
+
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class PathPolicyTests
+    {
+        [Fact]
+        public void AnchoredRoot_ShouldMatchDescendantsOnly_AcrossSeparatorsAndCase()
+        {
+            var policy = new PathPolicyBuilder()
+                .AddRoot(@"C:\Program Files\", PathClass.Trusted)
+                .Build();
+
+            Assert.Equal(PathClass.Trusted, policy.Classify(@"c:\program files\App\app.exe"));
+            Assert.Equal(PathClass.Trusted, policy.Classify("C:/Program Files/App/app.exe"));
+            Assert.Equal(PathClass.None, policy.Classify(@"C:\Program Files Evil\app.exe"));
+            Assert.Equal(PathClass.None, policy.Classify(@"D:\Program Files\app.exe"));
+        }
+
+        [Fact]
+        public void FloatingSegments_ShouldMatchDirectoriesAnywhere_ButNotFileName()
+        {
+            var policy = new PathPolicyBuilder()
+                .AddSegments("node_modules", PathClass.Excluded)
+                .AddSegments(@"appdata\roaming", PathClass.Suspicious)
+                .Build();
+
+            Assert.Equal(PathClass.Excluded, policy.Classify("/home/dev/web/node_modules/lib/index.js"));
+            Assert.Equal(PathClass.Suspicious, policy.Classify(@"C:\Users\a\AppData\Roaming\x.exe"));
+
+            // اسم الملف ليس مجلداً، والجزء من المقطع لا يطابق
+            Assert.Equal(PathClass.None, policy.Classify("/home/dev/node_modules"));
+            Assert.Equal(PathClass.Excluded, policy.Classify("/home/dev/node_modules", isDirectory: true));
+            Assert.Equal(PathClass.None, policy.Classify("/home/dev/node_modules_backup/a.js"));
+            Assert.Equal(PathClass.None, policy.Classify(@"C:\Users\a\AppData\Local\x.exe"));
+        }
+
+        [Fact]
+        public void Classify_ShouldCombineClassesAndReportRule()
+        {
+            var policy = new PathPolicyBuilder()
+                .AddRoot(@"C:\Windows", PathClass.Trusted)
+                .AddSegments("temp", PathClass.Suspicious)
+                .Build();
+
+            const string path = @"C:\Windows\Temp\drop.exe";
+
+            Assert.Equal(PathClass.Trusted | PathClass.Suspicious, policy.Classify(path));
+            Assert.Equal(@"C:\Windows", policy.FindRule(path, PathClass.Trusted));
+            Assert.Equal("temp", policy.FindRule(path, PathClass.Suspicious));
+            Assert.Null(policy.FindRule(path, PathClass.Quarantine));
+        }
+
+        [Fact]
+        public void ParentReferences_ShouldBeResolvedBeforeMatching()
+        {
+            var root = Path.Combine(Path.GetTempPath(), "ShieldAI_PP_Quarantine");
+            var policy = new PathPolicyBuilder().AddRoot(root, PathClass.Quarantine).Build();
+
+            var escaped = Path.Combine(root, "..", "outside.exe");
+            var inside = Path.Combine(root, "sub", "..", "inside.exe");
+
+            Assert.False(policy.Matches(escaped, PathClass.Quarantine));
+            Assert.True(policy.Matches(inside, PathClass.Quarantine));
+        }
+
+        [Fact]
+        public void WithRule_ShouldReturnNewPolicyAndKeepOriginal()
+        {
+            var original = new PathPolicyBuilder().AddSegments("cache", PathClass.Excluded).Build();
+            var extended = original.WithRule("/srv/quarantined/file.exe", PathClass.Quarantine);
+
+            Assert.False(original.Matches("/srv/quarantined/file.exe", PathClass.Quarantine));
+            Assert.True(extended.Matches("/srv/quarantined/file.exe", PathClass.Quarantine));
+            Assert.True(extended.Matches("/var/cache/x.bin", PathClass.Excluded));
+            Assert.Equal(original.Rules.Count + 1, extended.Rules.Count);
+        }
+
+        [Fact]
+        public void FromSettings_ShouldCompileExclusionsQuarantineAndTrustedPaths()
+        {
+            var settings = new AppSettings
+            {
+                QuarantinePath = "/var/lib/shieldai/quarantine",
+                ExcludedFolders = new List<string> { "node_modules", "/mnt/backup" },
+                TrustedPaths = new List<string> { "/opt/vendor" }
+            };
+
+            var policy = PathPolicy.FromSettings(settings);
+
+            Assert.True(policy.Matches("/var/lib/shieldai/quarantine/abc.bin", PathClass.Quarantine));
+            Assert.True(policy.Matches("/mnt/backup/disk.img", PathClass.Excluded));
+            Assert.True(policy.Matches("/src/node_modules/a.js", PathClass.Excluded));
+            Assert.True(policy.Matches("/opt/vendor/bin/tool", PathClass.Trusted));
+            Assert.True(policy.Matches(Path.Combine(Path.GetTempPath(), "x.exe"), PathClass.TempOrAppData));
+            Assert.True(policy.Matches(@"C:\Users\Public\Downloads\a.exe", PathClass.Suspicious));
+            Assert.Equal(PathClass.None, policy.Classify("/srv/data/report.pdf"));
+        }
+
+        [Fact]
+        public void DeepPaths_ShouldFallBackToPooledBuffer()
+        {
+            var policy = new PathPolicyBuilder().AddSegments("deep", PathClass.Excluded).Build();
+            var path = "/" + string.Join("/", Enumerable.Repeat("d", 100)) + "/deep/file.txt";
+
+            Assert.Equal(PathClass.Excluded, policy.Classify(path));
+        }
+    }
+}
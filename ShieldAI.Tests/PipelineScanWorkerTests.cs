@@ -0,0 +1,181 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/PipelineScanWorkerTests.cs
+// اختبارات تتبع الملفات قيد الفحص في PipelineScanWorker
+// =====================================================
+
+using ShieldAI.Core.Detection.ThreatScoring;
+using ShieldAI.Core.Monitoring.Pipeline;
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class PipelineScanWorkerTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly FileEventQueue _queue = new();
+        private readonly SlowEngine _engine = new();
+        private readonly PipelineScanWorker _worker;
+
+        public PipelineScanWorkerTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_PSW_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+
+            var aggregator = new ThreatAggregator(new IThreatEngine[] { _engine });
+            _worker = new PipelineScanWorker(_queue, aggregator, executor: new ScanExecutor(4, reservedRealtimeSlots: 0));
+        }
+
+        public void Dispose()
+        {
+            _worker.StopAsync().GetAwaiter().GetResult();
+            _worker.Dispose();
+            _queue.Dispose();
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private string CreateFile(string name)
+        {
+            var path = Path.Combine(_testDir, name);
+            File.WriteAllText(path, "database page");
+            return path;
+        }
+
+        private static async Task WaitUntilAsync(Func<bool> condition, int timeoutMs = 5000)
+        {
+            var deadline = DateTime.UtcNow.AddMilliseconds(timeoutMs);
+            while (!condition() && DateTime.UtcNow < deadline)
+                await Task.Delay(20);
+        }
+
+        [Fact]
+        public async Task ReEventsDuringScan_ShouldCauseExactlyOneFollowUpScan()
+        {
+            // عدد العمال محدود بعدد المعالجات - التداخل يحتاج عاملين على الأقل
+            if (Environment.ProcessorCount < 2) return;
+
+            // Arrange
+            var path = CreateFile("app.db");
+            _worker.Start(4);
+
+            // Act - الحدث الأول يبدأ الفحص، ثم خمسة أحداث أثناءه
+            _queue.TryEnqueue(new FileEvent { FilePath = path });
+            await WaitUntilAsync(() => _engine.Started >= 1);
+
+            for (int i = 0; i < 5; i++)
+                _queue.TryEnqueue(new FileEvent { FilePath = path });
+
+            await WaitUntilAsync(() => _worker.DirtyMarkCount >= 5);
+            await WaitUntilAsync(() => _worker.InFlightCount == 0);
+
+            // Assert
+            Assert.Equal(2, _engine.Started);
+            Assert.Equal(1, _engine.MaxConcurrent);
+            Assert.Equal(1, _worker.FollowUpScanCount);
+        }
+
+        [Fact]
+        public async Task DifferentFiles_ShouldScanInParallel()
+        {
+            if (Environment.ProcessorCount < 2) return;
+
+            var first = CreateFile("a.db");
+            var second = CreateFile("b.db");
+            _worker.Start(4);
+
+            _queue.TryEnqueue(new FileEvent { FilePath = first });
+            _queue.TryEnqueue(new FileEvent { FilePath = second });
+
+            await WaitUntilAsync(() => _engine.Started >= 2);
+            await WaitUntilAsync(() => _worker.InFlightCount == 0);
+
+            Assert.Equal(2, _engine.Started);
+            Assert.Equal(2, _engine.MaxConcurrent);
+            Assert.Equal(0, _worker.FollowUpScanCount);
+        }
+
+        [Fact]
+        public async Task FileEventHandled_ShouldFireOnlyAfterScanCompletes()
+        {
+            var path = CreateFile("late.db");
+            var completedAtHandled = -1;
+            _worker.FileEventHandled += (_, handled) =>
+            {
+                if (handled == path)
+                    Volatile.Write(ref completedAtHandled, _engine.Completed);
+            };
+            _worker.Start(1);
+
+            _queue.TryEnqueue(new FileEvent { FilePath = path });
+            await WaitUntilAsync(() => Volatile.Read(ref completedAtHandled) >= 0);
+
+            // اللقطة لا تُحدَّث إلا بعد انتهاء المحرك
+            Assert.Equal(1, Volatile.Read(ref completedAtHandled));
+        }
+
+        [Fact]
+        public async Task QuarantinedPaths_ShouldBeSkippedWithoutPolicyRebuild()
+        {
+            var quarantineDir = Path.Combine(_testDir, "Quarantine");
+            Directory.CreateDirectory(quarantineDir);
+            var inQuarantine = Path.Combine(quarantineDir, "item.db");
+            File.WriteAllText(inQuarantine, "encrypted");
+            var quarantinedFile = CreateFile("threat.db");
+            var clean = CreateFile("clean.db");
+
+            _worker.AddQuarantinedPath(quarantineDir + Path.DirectorySeparatorChar);
+            for (int i = 0; i < 1_000; i++)
+                _worker.AddQuarantinedPath(Path.Combine(_testDir, $"gone{i}.exe"));
+            _worker.AddQuarantinedPath(quarantinedFile);
+
+            var handled = 0;
+            _worker.FileEventHandled += (_, _) => Interlocked.Increment(ref handled);
+            _worker.Start(1);
+
+            _queue.TryEnqueue(new FileEvent { FilePath = inQuarantine });
+            _queue.TryEnqueue(new FileEvent { FilePath = quarantinedFile });
+            _queue.TryEnqueue(new FileEvent { FilePath = clean });
+            await WaitUntilAsync(() => Volatile.Read(ref handled) >= 3);
+
+            Assert.Equal(1, _engine.Started);
+        }
+
+        /// <summary>
+        /// محرك بطيء يقيس التوازي لكل ملف
+        /// </summary>
+        private sealed class SlowEngine : IThreatEngine
+        {
+            private int _running;
+            private int _started;
+            private int _maxConcurrent;
+            private int _completed;
+
+            public string EngineName => "Slow";
+            public double DefaultWeight => 1.0;
+            public bool IsReady => true;
+
+            public int Started => Volatile.Read(ref _started);
+            public int MaxConcurrent => Volatile.Read(ref _maxConcurrent);
+            public int Completed => Volatile.Read(ref _completed);
+
+            public async Task<ThreatScanResult> ScanAsync(ThreatScanContext context, CancellationToken ct = default)
+            {
+                Interlocked.Increment(ref _started);
+                var running = Interlocked.Increment(ref _running);
+
+                int max;
+                while (running > (max = Volatile.Read(ref _maxConcurrent)) &&
+                       Interlocked.CompareExchange(ref _maxConcurrent, running, max) != max)
+                {
+                }
+
+                await Task.Delay(300, ct);
+                Interlocked.Decrement(ref _running);
+                Interlocked.Increment(ref _completed);
+
+                return new ThreatScanResult { EngineName = EngineName };
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/PrevalenceSketchTests.cs
+// اختبارات تقدير الانتشار بذاكرة ثابتة
+// =====================================================
+
+using System.Security.Cryptography;
+using System.Text;
+using ShieldAI.Core.Detection.ThreatScoring;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class PrevalenceSketchTests
+    {
+        private DateTime _now = new(2025, 1, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        private static string Hash(int i) =>
+            Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes($"file-{i}")));
+
+        private PrevalenceSketch CreateSketch(int width = 1 << 12, double decay = 0.5) => new(
+            new PrevalenceSketchOptions
+            {
+                Width = width,
+                Depth = 4,
+                WindowDuration = TimeSpan.FromHours(24),
+                WindowCount = 3,
+                DecayFactor = decay
+            },
+            clock: () => _now);
+
+        [Fact]
+        public void Record_ShouldCountRepeatsAndNeverUnderestimate()
+        {
+            var sketch = CreateSketch();
+
+            for (int i = 0; i < 5; i++)
+                sketch.Record(Hash(1));
+
+            // حمل خلفي من بصمات أخرى
+            for (int i = 100; i < 1100; i++)
+                sketch.Record(Hash(i));
+
+            Assert.True(sketch.TryGet(Hash(1), out var entry));
+            Assert.InRange(entry.SeenCount, 5, 7);
+            Assert.False(sketch.TryGet(Hash(99_999), out _));
+            Assert.Equal(1, sketch.Record(Hash(50_000)).SeenCount);
+        }
+
+        [Fact]
+        public void Windows_ShouldDecayAndExpire_AndTrackFirstSeen()
+        {
+            var sketch = CreateSketch();
+            var start = _now;
+
+            for (int i = 0; i < 8; i++)
+                sketch.Record(Hash(1));
+
+            // نافذة لاحقة: الرؤى القديمة بوزن 0.5
+            _now = start.AddHours(25);
+            var entry = sketch.Record(Hash(1));
+            Assert.Equal(5, entry.SeenCount);
+            Assert.Equal(start, entry.FirstSeenUtc);
+            Assert.Equal(_now, entry.LastSeenUtc);
+
+            // بعد خروج كل النوافذ من الحلقة لا يبقى أثر
+            _now = start.AddDays(10);
+            Assert.False(sketch.TryGet(Hash(1), out _));
+        }
+
+        [Fact]
+        public void DistinctCount_ShouldEstimateCardinalityWithinFewPercent()
+        {
+            var sketch = CreateSketch();
+
+            for (int i = 0; i < 20_000; i++)
+            {
+                sketch.Record(Hash(i));
+                if (i % 4 == 0)
+                    sketch.Record(Hash(i));
+            }
+
+            Assert.InRange(sketch.DistinctCount, 19_000, 21_000);
+        }
+
+        [Fact]
+        public void Memory_ShouldStayFixedRegardlessOfPopulation()
+        {
+            var sketch = CreateSketch(width: 1 << 10);
+            var before = sketch.MemoryBytes;
+
+            for (int i = 0; i < 50_000; i++)
+                sketch.Record(Hash(i));
+
+            Assert.Equal(before, sketch.MemoryBytes);
+            Assert.Equal(3 * ((1 << 10) * 4 * 2 + HyperLogLog.MemoryBytes), before);
+        }
+
+        [Fact]
+        public void Saturation_FreshKeyShouldStayRareAfterMillionsOfDistinctKeys()
+        {
+            // الهندسة الافتراضية (العرض 2^19) تحت حمل أسبوع مزدحم: ~20 مليون بصمة مختلفة في نافذة واحدة
+            var sketch = new PrevalenceSketch(new PrevalenceSketchOptions(), clock: () => _now);
+            ulong state = 42;
+            PrevalenceDigest Next() => new(SplitMix(ref state), SplitMix(ref state), SplitMix(ref state), SplitMix(ref state));
+
+            var common = Hash(0);
+            var moderate = Hash(1);
+            for (int i = 0; i < 20_000_000; i++)
+            {
+                sketch.Record(Next());
+                if (i % 100_000 == 0)
+                    sketch.Record(common);
+                if (i % 500_000 == 0)
+                    sketch.Record(moderate);
+            }
+
+            var fresh = sketch.Record(Next());
+
+            Assert.True(fresh.SeenCount <= 1, $"SeenCount={fresh.SeenCount}");
+            Assert.Equal(_now, fresh.FirstSeenUtc);
+            Assert.False(sketch.TryGet(Hash(-1), out _));
+
+            // بصمة شائعة فعلاً تبقى فوق الضجيج (التقدير ناقص الضجيج المقاس)
+            Assert.True(sketch.TryGet(common, out var entry));
+            Assert.True(entry.SeenCount >= 175, $"SeenCount={entry.SeenCount}");
+
+            // 40 رؤية تحت حد الخطأ النظري (~100) ومع ذلك مرئية
+            Assert.True(sketch.TryGet(moderate, out var moderateEntry));
+            Assert.True(moderateEntry.SeenCount >= 15, $"SeenCount={moderateEntry.SeenCount}");
+        }
+
+        private static ulong SplitMix(ref ulong state)
+        {
+            var z = state += 0x9E3779B97F4A7C15UL;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+            return z ^ (z >> 31);
+        }
+
+        [Fact]
+        public void Snapshot_ShouldRoundTrip()
+        {
+            var path = Path.Combine(Path.GetTempPath(), $"ShieldAI_Sketch_{Guid.NewGuid():N}.bin");
+            try
+            {
+                var options = new PrevalenceSketchOptions { Width = 1 << 10, WindowCount = 2 };
+                using (var sketch = new PrevalenceSketch(options, path, clock: () => _now))
+                {
+                    for (int i = 0; i < 3; i++)
+                        sketch.Record(Hash(7));
+                }
+
+                using var reloaded = new PrevalenceSketch(options, path, clock: () => _now);
+                Assert.True(reloaded.TryGet(Hash(7), out var entry));
+                Assert.Equal(3, entry.SeenCount);
+
+                // هندسة مختلفة: اللقطة تُتجاهل
+                using var resized = new PrevalenceSketch(
+                    new PrevalenceSketchOptions { Width = 1 << 11, WindowCount = 2 }, path, clock: () => _now);
+                Assert.False(resized.TryGet(Hash(7), out _));
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+        [Fact]
+        public async Task ReputationEngine_ShouldUseInjectedTracker()
+        {
+            var sketch = CreateSketch();
+            var engine = new ReputationEngine(sketch);
+            var context = new ThreatScanContext { FilePath = "/srv/data/tool.bin", Sha256Hash = Hash(3) };
+
+            var first = await engine.ScanAsync(context);
+
+            Assert.Equal(1, context.LocalSeenCount);
+            Assert.Contains(first.Reasons, r => r.Contains("نادر"));
+            Assert.True(sketch.TryGet(Hash(3), out _));
+        }
+    }
+}
@@ -0,0 +1,151 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/QuarantineActionQueueTests.cs
+// اختبارات قائمة إجراءات الحجر: الدفعات والنتائج لكل عنصر
+// =====================================================
+
+using ShieldAI.Core.Monitoring.Quarantine;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class QuarantineActionQueueTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly QuarantineStore _store;
+        private readonly QuarantineActionQueue _queue;
+
+        public QuarantineActionQueueTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_QQueue_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+            _store = new QuarantineStore(Path.Combine(_testDir, "Quarantine"));
+            _queue = new QuarantineActionQueue(_store, new QuarantineActionQueueOptions
+            {
+                Capacity = 16,
+                MaxBatchSize = 8,
+                MaxParallelism = 4
+            });
+        }
+
+        public void Dispose()
+        {
+            _queue.Dispose();
+            _store.Dispose();
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private List<string> CreateSamples(int count)
+        {
+            var paths = new List<string>();
+            for (int i = 0; i < count; i++)
+            {
+                var path = Path.Combine(_testDir, $"sample{i}.bin");
+                File.WriteAllText(path, $"malicious payload {i}");
+                paths.Add(path);
+            }
+            return paths;
+        }
+
+        [Fact]
+        public async Task QuarantineMany_ShouldBatchCommitsAndPreserveOrder()
+        {
+            var paths = CreateSamples(40);
+
+            var outcomes = await _queue.QuarantineManyAsync(paths.Select(p => new QuarantineRequest(p)));
+
+            Assert.Equal(40, outcomes.Length);
+            Assert.All(outcomes, o => Assert.True(o.Success, o.Error));
+            Assert.True(paths.SequenceEqual(outcomes.Select(o => o.Target)));
+            Assert.All(paths, p => Assert.False(File.Exists(p)));
+
+            Assert.Equal(40, _store.Count);
+            Assert.Equal(40, _queue.ItemsProcessed);
+            Assert.True(_queue.BatchesProcessed < 40);
+        }
+
+        [Fact]
+        public async Task QuarantineMany_ShouldReportPerItemFailures()
+        {
+            var paths = CreateSamples(3);
+            paths.Insert(1, Path.Combine(_testDir, "missing.bin"));
+
+            var outcomes = await _queue.QuarantineManyAsync(paths.Select(p => new QuarantineRequest(p)));
+
+            Assert.False(outcomes[1].Success);
+            Assert.Equal("File not found", outcomes[1].Error);
+            Assert.Equal(3, outcomes.Count(o => o.Success));
+            Assert.Equal(3, _store.Count);
+        }
+
+        [Fact]
+        public async Task AtomicMove_ShouldKeepOriginalPath()
+        {
+            var path = CreateSamples(1)[0];
+
+            var outcome = await _queue.QuarantineAsync(new QuarantineRequest(path) { ThreatName = "Test.Threat", AtomicMove = true });
+
+            Assert.True(outcome.Success, outcome.Error);
+            Assert.Equal(path, outcome.Item!.OriginalPath);
+            Assert.Equal("Test.Threat", outcome.Item.ThreatName);
+            Assert.False(File.Exists(path));
+        }
+
+        [Fact]
+        public async Task DeleteMany_ShouldReportUnknownIds()
+        {
+            var quarantined = await _queue.QuarantineManyAsync(CreateSamples(2).Select(p => new QuarantineRequest(p)));
+            var ids = quarantined.Select(o => o.Item!.Id).Append("unknown-id").ToList();
+
+            var outcomes = await _queue.DeleteManyAsync(ids);
+
+            Assert.True(outcomes[0].Success);
+            Assert.True(outcomes[1].Success);
+            Assert.False(outcomes[2].Success);
+            Assert.Equal("Item not found", outcomes[2].Error);
+            Assert.Equal(0, _store.Count);
+            Assert.Equal(0, _store.BlobCount);
+        }
+
+        [Fact]
+        public async Task RestoreMany_ShouldFailUnknownIds()
+        {
+            var outcomes = await _queue.RestoreManyAsync(new[] { new QuarantineRestoreRequest("unknown-id") });
+
+            Assert.False(Assert.Single(outcomes).Success);
+        }
+
+        [Fact]
+        public async Task Post_FullQueue_ShouldNotBlockCaller()
+        {
+            using var queue = new QuarantineActionQueue(_store, new QuarantineActionQueueOptions
+            {
+                Capacity = 1,
+                MaxBatchSize = 1,
+                MaxParallelism = 1
+            });
+            var paths = CreateSamples(30);
+
+            // Act - كل Post يعود فوراً بمهمة حتى عند امتلاء القائمة
+            var pending = paths.Select(p => queue.Post(new QuarantineRequest(p))).ToList();
+            var outcomes = await Task.WhenAll(pending);
+
+            // Assert
+            Assert.True(queue.OverflowedPostCount > 0);
+            Assert.Equal(0, queue.WaitingPostCount);
+            Assert.All(outcomes, o => Assert.True(o.Success, o.Error));
+        }
+
+        [Fact]
+        public async Task Dispose_ShouldRejectNewRequests()
+        {
+            var path = CreateSamples(1)[0];
+            _queue.Dispose();
+
+            var outcome = await _queue.Post(new QuarantineRequest(path));
+
+            Assert.False(outcome.Success);
+            Assert.True(File.Exists(path));
+        }
+    }
+}
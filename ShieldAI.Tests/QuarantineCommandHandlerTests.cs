@@ -0,0 +1,134 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/QuarantineCommandHandlerTests.cs
+// اختبارات أوامر الحجر عبر IPC فوق QuarantineStore
+// =====================================================
+
+using ShieldAI.Core.Contracts;
+using ShieldAI.Core.Models;
+using ShieldAI.Core.Monitoring.Quarantine;
+using ShieldAI.Service.Ipc;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class QuarantineCommandHandlerTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly QuarantineStore _store;
+        private readonly QuarantineActionQueue _queue;
+        private readonly QuarantineCommandHandler _handler;
+
+        public QuarantineCommandHandlerTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_QIpc_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+            _store = new QuarantineStore(Path.Combine(_testDir, "Quarantine"));
+            _queue = new QuarantineActionQueue(_store, new QuarantineActionQueueOptions { MaxParallelism = 2 });
+            _handler = new QuarantineCommandHandler(_store, _queue);
+        }
+
+        public void Dispose()
+        {
+            _queue.Dispose();
+            _store.Dispose();
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private async Task<QuarantineItemOutcome> QueueDetectionAsync(string name)
+        {
+            var path = Path.Combine(_testDir, name);
+            File.WriteAllText(path, $"payload {name}");
+
+            // نفس الطلب الذي ينشئه ShieldAIWorker للكشف التلقائي
+            return await _queue.Post(QuarantineRequest.ForDetection(new ScanResult
+            {
+                FilePath = path,
+                ThreatName = "Test.Detection",
+                Verdict = ScanVerdict.Malicious
+            }));
+        }
+
+        private List<QuarantineItemDto> GetList()
+        {
+            var response = _handler.GetList(CommandEnvelope.Create(Commands.GetQuarantineList));
+            Assert.True(response.Success, response.Error);
+            return response.GetPayload<QuarantineListResponse>()!.Items;
+        }
+
+        [Fact]
+        public async Task QueuedDetection_ShouldAppearInQuarantineList()
+        {
+            var outcome = await QueueDetectionAsync("detected.exe");
+            Assert.True(outcome.Success, outcome.Error);
+
+            var item = Assert.Single(GetList());
+            Assert.Equal(Guid.Parse(outcome.Item!.Id), item.Id);
+            Assert.Equal(Path.Combine(_testDir, "detected.exe"), item.OriginalPath);
+            Assert.Equal("Test.Detection", item.ThreatName);
+            Assert.Equal(1, _handler.Count);
+        }
+
+        [Fact]
+        public async Task DeleteCommand_ShouldRemoveListedItem()
+        {
+            await QueueDetectionAsync("a.exe");
+            var listed = Assert.Single(GetList());
+
+            var response = await _handler.DeleteAsync(CommandEnvelope.Create(Commands.DeleteFromQuarantine,
+                new QuarantineActionRequest { EntryId = listed.Id }));
+
+            Assert.True(response.Success, response.Error);
+            Assert.Empty(GetList());
+            Assert.Equal(0, _store.Count);
+        }
+
+        [Fact]
+        public async Task BulkDelete_ShouldAcceptListedIdsInAnyGuidFormat()
+        {
+            await QueueDetectionAsync("a.exe");
+            await QueueDetectionAsync("b.exe");
+            var ids = GetList().Select(i => i.Id.ToString()).Append(Guid.NewGuid().ToString()).ToList();
+
+            var response = await _handler.BulkDeleteAsync(CommandEnvelope.Create(Commands.BulkDeleteQuarantine,
+                new BulkQuarantineActionRequest { ItemIds = ids }));
+
+            var result = response.GetPayload<BulkQuarantineResponse>()!;
+            Assert.Equal(2, result.Succeeded);
+            Assert.Equal(1, result.Failed);
+            Assert.False(result.Outcomes[2].Success);
+            Assert.Equal(0, _store.Count);
+        }
+
+        [Fact]
+        public async Task BulkQuarantine_ShouldOnlyAcceptPendingDetections()
+        {
+            var pendingPath = Path.Combine(_testDir, "pending.exe");
+            var otherPath = Path.Combine(_testDir, "innocent.txt");
+            File.WriteAllText(pendingPath, "pending");
+            File.WriteAllText(otherPath, "innocent");
+            var handler = new QuarantineCommandHandler(_store, _queue, pendingDetections: () => new[] { pendingPath });
+
+            var response = await handler.BulkQuarantineAsync(CommandEnvelope.Create(Commands.BulkQuarantine,
+                new BulkQuarantineRequest { Paths = new List<string> { otherPath, pendingPath } }));
+
+            var result = response.GetPayload<BulkQuarantineResponse>()!;
+            Assert.False(result.Outcomes[0].Success);
+            Assert.Equal("Not a pending detection", result.Outcomes[0].Error);
+            Assert.True(result.Outcomes[1].Success, result.Outcomes[1].Error);
+            Assert.True(File.Exists(otherPath));
+            Assert.False(File.Exists(pendingPath));
+        }
+
+        [Fact]
+        public async Task ClearCommand_ShouldEmptyStore()
+        {
+            await QueueDetectionAsync("a.exe");
+
+            var response = await _handler.ClearAsync(CommandEnvelope.Create(Commands.ClearQuarantine));
+
+            Assert.True(response.Success, response.Error);
+            Assert.Empty(GetList());
+        }
+    }
+}
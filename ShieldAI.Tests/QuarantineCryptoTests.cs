@@ -0,0 +1,187 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/QuarantineCryptoTests.cs
+// اختبارات الحاوية المجزأة AES-GCM وترحيل الصيغة القديمة
+// =====================================================
+
+using System.Security.Cryptography;
+using ShieldAI.Core.Monitoring.Quarantine;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class QuarantineCryptoTests : IDisposable
+    {
+        private const int ChunkSize = 1024;
+
+        private readonly string _testDir;
+        private readonly QuarantineCrypto _crypto;
+
+        public QuarantineCryptoTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_QCrypto_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+            _crypto = new QuarantineCrypto(_testDir);
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private static byte[] RandomBytes(int length)
+        {
+            var data = new byte[length];
+            new Random(length).NextBytes(data);
+            return data;
+        }
+
+        private async Task<byte[]> EncryptAsync(byte[] plain)
+        {
+            using var output = new MemoryStream();
+            await _crypto.EncryptStreamAsync(new MemoryStream(plain), output, ChunkSize);
+            return output.ToArray();
+        }
+
+        private async Task<byte[]> DecryptAsync(byte[] container)
+        {
+            using var output = new MemoryStream();
+            await _crypto.DecryptStreamAsync(new MemoryStream(container), output);
+            return output.ToArray();
+        }
+
+        [Fact]
+        public async Task Roundtrip_ShouldPreserveContentAcrossChunkBoundaries()
+        {
+            foreach (var length in new[] { 0, 1, ChunkSize - 1, ChunkSize, ChunkSize + 1, ChunkSize * 5 })
+            {
+                var plain = RandomBytes(length);
+                using var encrypted = new MemoryStream();
+
+                var (hash, written) = await _crypto.EncryptStreamAsync(new MemoryStream(plain), encrypted, ChunkSize);
+
+                Assert.Equal(length, written);
+                Assert.Equal(QuarantineCrypto.ComputeSha256(plain), hash);
+                Assert.True(QuarantineCrypto.IsChunkedContainer(new MemoryStream(encrypted.ToArray())));
+
+                using var decrypted = new MemoryStream();
+                var (restoredHash, _) = await _crypto.DecryptStreamAsync(new MemoryStream(encrypted.ToArray()), decrypted);
+
+                Assert.True(plain.AsSpan().SequenceEqual(decrypted.ToArray()), $"length {length}");
+                Assert.Equal(hash, restoredHash);
+            }
+        }
+
+        [Fact]
+        public async Task CompressedRoundtrip_ShouldPreserveContentAndDetectTampering()
+        {
+            foreach (var plain in new[] { Array.Empty<byte>(), RandomBytes(ChunkSize * 3 + 7), new byte[ChunkSize * 40] })
+            {
+                using var encrypted = new MemoryStream();
+                var (hash, written) = await _crypto.EncryptStreamAsync(new MemoryStream(plain), encrypted, ChunkSize, compress: true);
+
+                Assert.Equal(plain.Length, written);
+                Assert.Equal(QuarantineCrypto.ComputeSha256(plain), hash);
+
+                var decrypted = await DecryptAsync(encrypted.ToArray());
+                Assert.True(plain.AsSpan().SequenceEqual(decrypted), $"length {plain.Length}");
+            }
+
+            // المحتوى المتكرر يصغر كثيراً
+            using var zeros = new MemoryStream();
+            await _crypto.EncryptStreamAsync(new MemoryStream(new byte[ChunkSize * 40]), zeros, ChunkSize, compress: true);
+            Assert.True(zeros.Length < ChunkSize * 2);
+
+            // علم الضغط جزء من البيانات المصادَق عليها
+            var container = zeros.ToArray();
+            container[5] = 0;
+            await Assert.ThrowsAnyAsync<CryptographicException>(() => DecryptAsync(container));
+        }
+
+        [Fact]
+        public async Task SameContent_ShouldEncryptDifferentlyEachTime()
+        {
+            var plain = RandomBytes(3000);
+
+            var first = await EncryptAsync(plain);
+            var second = await EncryptAsync(plain);
+
+            Assert.False(first.AsSpan().SequenceEqual(second));
+        }
+
+        [Fact]
+        public async Task TamperedChunk_ShouldFailVerification()
+        {
+            var container = await EncryptAsync(RandomBytes(ChunkSize * 3));
+            container[28 + 4 + ChunkSize + 16 + 4 + 10] ^= 0x01; // داخل القطعة الثانية
+
+            await Assert.ThrowsAnyAsync<CryptographicException>(() => DecryptAsync(container));
+        }
+
+        [Fact]
+        public async Task TruncatedOrReorderedContainer_ShouldFail()
+        {
+            var container = await EncryptAsync(RandomBytes(ChunkSize * 3 + 100));
+            const int recordSize = 4 + ChunkSize + 16;
+
+            // حذف القطعة الأخيرة (الاقتطاع عند حدود قطعة)
+            var truncated = container.AsSpan(0, 28 + recordSize * 3).ToArray();
+            await Assert.ThrowsAnyAsync<CryptographicException>(() => DecryptAsync(truncated));
+
+            // تبديل القطعتين الأولى والثانية
+            var swapped = (byte[])container.Clone();
+            container.AsSpan(28, recordSize).CopyTo(swapped.AsSpan(28 + recordSize));
+            container.AsSpan(28 + recordSize, recordSize).CopyTo(swapped.AsSpan(28));
+            await Assert.ThrowsAnyAsync<CryptographicException>(() => DecryptAsync(swapped));
+
+            // بيانات ملحقة بعد القطعة الأخيرة
+            var appended = container.Concat(new byte[] { 1, 2, 3 }).ToArray();
+            await Assert.ThrowsAnyAsync<CryptographicException>(() => DecryptAsync(appended));
+        }
+
+        [Fact]
+        public async Task LegacyContainer_ShouldStillDecrypt()
+        {
+            var plain = RandomBytes(5000);
+            var legacy = _crypto.Encrypt(plain);
+
+            Assert.False(QuarantineCrypto.IsChunkedContainer(new MemoryStream(legacy)));
+            var decrypted = await DecryptAsync(legacy);
+            Assert.True(plain.AsSpan().SequenceEqual(decrypted));
+        }
+
+        [Fact]
+        public async Task Store_ShouldWriteChunkedFilesAndMigrateLegacyOnes()
+        {
+            var quarantineDir = Path.Combine(_testDir, "Quarantine");
+            var source = Path.Combine(_testDir, "sample.bin");
+            var plain = RandomBytes(700_000);
+            File.WriteAllBytes(source, plain);
+
+            using var store = new QuarantineStore(quarantineDir);
+            var item = await store.QuarantineFileAsync(source);
+
+            Assert.NotNull(item);
+            Assert.Equal(QuarantineCrypto.ChunkedFormatVersion, item!.ContainerVersion);
+            Assert.Equal(QuarantineCrypto.ComputeSha256(plain), item.Sha256Hash);
+            Assert.Equal(plain.Length, item.FileSize);
+
+            // محاكاة عنصر قديم: نفس المفتاح، صيغة v1
+            var qarPath = Path.Combine(quarantineDir, item.QuarantineFileName);
+            var storeCrypto = new QuarantineCrypto(quarantineDir);
+            File.WriteAllBytes(qarPath, storeCrypto.Encrypt(plain));
+            item.ContainerVersion = 1;
+
+            Assert.Equal(1, await store.MigrateLegacyItemsAsync());
+            Assert.Equal(QuarantineCrypto.ChunkedFormatVersion, store.GetItem(item.Id)!.ContainerVersion);
+
+            await using var qar = File.OpenRead(qarPath);
+            Assert.True(QuarantineCrypto.IsChunkedContainer(qar));
+            using var restored = new MemoryStream();
+            var (hash, _) = await storeCrypto.DecryptStreamAsync(qar, restored);
+            Assert.Equal(item.Sha256Hash, hash);
+
+            Assert.Equal(0, await store.MigrateLegacyItemsAsync());
+        }
+    }
+}
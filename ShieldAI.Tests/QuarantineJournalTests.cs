@@ -0,0 +1,172 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/QuarantineJournalTests.cs
+// اختبارات سجل metadata الحجر: إعادة التشغيل والتلاعب والضغط
+// =====================================================
+
+using ShieldAI.Core.Monitoring.Quarantine;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class QuarantineJournalTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly string _quarantineDir;
+
+        public QuarantineJournalTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_QJournal_{Guid.NewGuid():N}");
+            _quarantineDir = Path.Combine(_testDir, "Quarantine");
+            Directory.CreateDirectory(_testDir);
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private string JournalPath => Path.Combine(_quarantineDir, "metadata.journal");
+        private string SnapshotPath => Path.Combine(_quarantineDir, "metadata.json");
+
+        private async Task<List<QuarantineItemMetadata>> QuarantineSamplesAsync(QuarantineStore store, int count)
+        {
+            var items = new List<QuarantineItemMetadata>();
+            for (int i = 0; i < count; i++)
+            {
+                var path = Path.Combine(_testDir, $"sample{i}_{Guid.NewGuid():N}.bin");
+                File.WriteAllText(path, $"sample content {i}");
+                var item = await store.QuarantineFileAsync(path);
+                Assert.NotNull(item);
+                items.Add(item!);
+            }
+            return items;
+        }
+
+        [Fact]
+        public async Task Operations_ShouldAppendWithoutRewritingSnapshot()
+        {
+            using var store = new QuarantineStore(_quarantineDir);
+            var snapshot = File.ReadAllBytes(SnapshotPath);
+
+            var items = await QuarantineSamplesAsync(store, 5);
+            Assert.True(await store.DeleteFileAsync(items[0].Id));
+
+            Assert.Equal(6, store.PendingJournalRecords);
+            Assert.True(snapshot.AsSpan().SequenceEqual(File.ReadAllBytes(SnapshotPath)));
+        }
+
+        [Fact]
+        public async Task Reopen_ShouldReplayJournalOverSnapshot()
+        {
+            List<QuarantineItemMetadata> items;
+            using (var store = new QuarantineStore(_quarantineDir))
+            {
+                items = await QuarantineSamplesAsync(store, 4);
+                store.CompactMetadata();
+
+                // عمليات بعد اللقطة تعيش في السجل فقط
+                Assert.True(await store.DeleteFileAsync(items[1].Id));
+                items.AddRange(await QuarantineSamplesAsync(store, 1));
+            }
+
+            using var reopened = new QuarantineStore(_quarantineDir);
+
+            Assert.Equal(4, reopened.Count);
+            Assert.Null(reopened.GetItem(items[1].Id));
+            Assert.Equal(items[4].Sha256Hash, reopened.GetItem(items[4].Id)!.Sha256Hash);
+            Assert.Equal(2, reopened.PendingJournalRecords);
+        }
+
+        [Fact]
+        public async Task TamperedRecord_ShouldStopReplayAtBrokenLink()
+        {
+            List<QuarantineItemMetadata> items;
+            using (var store = new QuarantineStore(_quarantineDir))
+                items = await QuarantineSamplesAsync(store, 3);
+
+            // تعديل بايت داخل محتوى السجل الثاني يكسر السلسلة منه فصاعداً
+            var journal = File.ReadAllBytes(JournalPath);
+            var firstRecordLength = BitConverter.ToInt32(journal, 38);
+            journal[38 + 36 + firstRecordLength + 36 + 20] ^= 0x01;
+            File.WriteAllBytes(JournalPath, journal);
+
+            using var reopened = new QuarantineStore(_quarantineDir);
+
+            Assert.Equal(items[0].Id, Assert.Single(reopened.GetAllItems()).Id);
+            Assert.Equal(1, reopened.PendingJournalRecords);
+            Assert.Equal(38 + 36 + firstRecordLength, new FileInfo(JournalPath).Length);
+        }
+
+        [Fact]
+        public async Task TornTail_ShouldBeTruncatedAndAppendable()
+        {
+            using (var store = new QuarantineStore(_quarantineDir))
+                await QuarantineSamplesAsync(store, 2);
+
+            var intactLength = new FileInfo(JournalPath).Length;
+            using (var stream = new FileStream(JournalPath, FileMode.Append))
+                stream.Write(new byte[] { 200, 0, 0, 0, 1, 2, 3 });
+
+            using (var reopened = new QuarantineStore(_quarantineDir))
+            {
+                Assert.Equal(2, reopened.Count);
+                Assert.Equal(intactLength, new FileInfo(JournalPath).Length);
+                await QuarantineSamplesAsync(reopened, 1);
+            }
+
+            using var third = new QuarantineStore(_quarantineDir);
+            Assert.Equal(3, third.Count);
+        }
+
+        [Fact]
+        public async Task Compaction_ShouldFoldJournalIntoSnapshot()
+        {
+            using (var store = new QuarantineStore(_quarantineDir))
+            {
+                await QuarantineSamplesAsync(store, 3);
+                store.CompactMetadata();
+
+                Assert.Equal(0, store.PendingJournalRecords);
+                Assert.Equal(38, new FileInfo(JournalPath).Length);
+            }
+
+            using var reopened = new QuarantineStore(_quarantineDir);
+            Assert.Equal(3, reopened.Count);
+        }
+
+        [Fact]
+        public async Task JournalFromOlderSnapshot_ShouldBeIgnored()
+        {
+            using (var store = new QuarantineStore(_quarantineDir))
+                await QuarantineSamplesAsync(store, 2);
+            var staleJournal = File.ReadAllBytes(JournalPath);
+
+            // انقطاع بعد كتابة لقطة جديدة وقبل تصفير السجل
+            using (var store = new QuarantineStore(_quarantineDir))
+            {
+                await QuarantineSamplesAsync(store, 1);
+                store.CompactMetadata();
+            }
+            File.WriteAllBytes(JournalPath, staleJournal);
+
+            using var reopened = new QuarantineStore(_quarantineDir);
+            Assert.Equal(3, reopened.Count);
+            Assert.Equal(0, reopened.PendingJournalRecords);
+        }
+
+        [Fact]
+        public async Task ClearAll_ShouldReplayAsEmpty()
+        {
+            using (var store = new QuarantineStore(_quarantineDir))
+            {
+                await QuarantineSamplesAsync(store, 3);
+                store.CompactMetadata();
+                await store.ClearAllAsync();
+            }
+
+            using var reopened = new QuarantineStore(_quarantineDir);
+            Assert.Equal(0, reopened.Count);
+        }
+    }
+}
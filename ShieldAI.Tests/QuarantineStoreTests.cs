@@ -308,5 +308,103 @@ namespace ShieldAI.Tests
         }
 
         #endregion
+
+        #region Content-Addressed Storage Tests
+
+        private async Task<QuarantineItemMetadata> QuarantineContentAsync(string name, string content)
+        {
+            var path = Path.Combine(_testDir, name);
+            File.WriteAllText(path, content);
+            var metadata = await _store.QuarantineFileAsync(path);
+            Assert.NotNull(metadata);
+            return metadata!;
+        }
+
+        private int BlobFilesOnDisk() => Directory.GetFiles(_quarantineDir, "*.qar").Length;
+
+        [Fact]
+        public async Task DuplicateContent_ShouldShareOneEncryptedBlob()
+        {
+            var first = await QuarantineContentAsync("dup_a.exe", "same malware payload");
+            var second = await QuarantineContentAsync("dup_b.exe", "same malware payload");
+            var third = await QuarantineContentAsync("dup_c.exe", "same malware payload");
+            await QuarantineContentAsync("other.exe", "different payload");
+
+            Assert.Equal(4, _store.Count);
+            Assert.Equal(2, _store.BlobCount);
+            Assert.Equal(2, BlobFilesOnDisk());
+            Assert.Equal(first.QuarantineFileName, second.QuarantineFileName);
+            Assert.Equal(first.QuarantineFileName, third.QuarantineFileName);
+            Assert.NotEqual(first.Id, second.Id);
+            Assert.Equal(first.Sha256Hash + ".qar", first.QuarantineFileName);
+        }
+
+        [Fact]
+        public async Task DeleteEntry_ShouldKeepSharedBlobUntilLastReference()
+        {
+            var first = await QuarantineContentAsync("shared_a.exe", "shared payload");
+            var second = await QuarantineContentAsync("shared_b.exe", "shared payload");
+            var blobPath = Path.Combine(_quarantineDir, first.QuarantineFileName);
+
+            Assert.True(await _store.DeleteFileAsync(first.Id));
+            Assert.True(File.Exists(blobPath));
+            Assert.Null(_store.GetItem(first.Id));
+            Assert.NotNull(_store.GetItem(second.Id));
+
+            // المرجع المتبقي ما زال قابلاً للفك
+            using (var plain = new MemoryStream())
+            {
+                await using var input = File.OpenRead(blobPath);
+                var (hash, _) = await new QuarantineCrypto(_quarantineDir).DecryptStreamAsync(input, plain);
+                Assert.Equal(second.Sha256Hash, hash);
+            }
+
+            Assert.True(await _store.DeleteFileAsync(second.Id));
+            Assert.False(File.Exists(blobPath));
+            Assert.Equal(0, _store.BlobCount);
+        }
+
+        [Fact]
+        public async Task Reopen_ShouldRebuildBlobReferences()
+        {
+            var first = await QuarantineContentAsync("reopen_a.exe", "reopen payload");
+            var second = await QuarantineContentAsync("reopen_b.exe", "reopen payload");
+            var blobPath = Path.Combine(_quarantineDir, first.QuarantineFileName);
+
+            using (var reopened = new QuarantineStore(_quarantineDir))
+            {
+                Assert.Equal(1, reopened.BlobCount);
+                Assert.True(await reopened.DeleteFileAsync(first.Id));
+                Assert.True(File.Exists(blobPath));
+                Assert.True(await reopened.DeleteFileAsync(second.Id));
+                Assert.False(File.Exists(blobPath));
+            }
+        }
+
+        [Fact]
+        public async Task CompressibleContent_ShouldBeStoredCompressed()
+        {
+            var content = string.Concat(Enumerable.Repeat("MZ compressible script body; ", 20_000));
+            var metadata = await QuarantineContentAsync("script.js", content);
+
+            var blobSize = new FileInfo(Path.Combine(_quarantineDir, metadata.QuarantineFileName)).Length;
+            Assert.Equal(content.Length, metadata.FileSize);
+            Assert.True(blobSize < content.Length / 10, $"blob size {blobSize}");
+        }
+
+        [Fact]
+        public async Task ClearAll_ShouldDeleteSharedBlobs()
+        {
+            await QuarantineContentAsync("clear_a.exe", "clear payload");
+            await QuarantineContentAsync("clear_b.exe", "clear payload");
+            await QuarantineContentAsync("clear_c.exe", "another payload");
+
+            await _store.ClearAllAsync();
+
+            Assert.Equal(0, _store.BlobCount);
+            Assert.Equal(0, BlobFilesOnDisk());
+        }
+
+        #endregion
     }
 }
@@ -0,0 +1,147 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/ScanCheckpointTests.cs
+// اختبارات نقاط الاستئناف: الموضع، التخزين، تخطي الملفات المكتملة
+// =====================================================
+
+using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class ScanCheckpointTests : IDisposable
+    {
+        private readonly string _testDir;
+
+        public ScanCheckpointTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_CheckpointTest_{Guid.NewGuid()}");
+            Directory.CreateDirectory(_testDir);
+        }
+
+        public void Dispose()
+        {
+            try
+            {
+                if (Directory.Exists(_testDir))
+                    Directory.Delete(_testDir, true);
+            }
+            catch { }
+        }
+
+        [Fact]
+        public void Cursor_ShouldAdvanceLowWater_OnlyWhenContiguous()
+        {
+            var cursor = new ScanCursor();
+
+            cursor.MarkCompleted(1);
+            cursor.MarkCompleted(3);
+            Assert.Equal(0, cursor.LowWaterMark);
+
+            cursor.MarkCompleted(0);
+            Assert.Equal(2, cursor.LowWaterMark);
+
+            cursor.MarkCompleted(2);
+            Assert.Equal(4, cursor.LowWaterMark);
+
+            var (lowWater, ahead) = cursor.Snapshot();
+            Assert.Equal(4, lowWater);
+            Assert.Empty(ahead);
+        }
+
+        [Fact]
+        public void Cursor_SnapshotPaths_ShouldTrackPathsWithoutFileList()
+        {
+            var cursor = new ScanCursor();
+
+            cursor.MarkCompleted(2, "/data/c.bin");
+            cursor.MarkCompleted(0, "/data/a.bin");
+
+            var (lowWaterPath, ahead) = cursor.SnapshotPaths();
+            Assert.Equal("/data/a.bin", lowWaterPath);
+            Assert.Equal("/data/c.bin", Assert.Single(ahead));
+
+            cursor.MarkCompleted(1, "/data/b.bin");
+
+            (lowWaterPath, ahead) = cursor.SnapshotPaths();
+            Assert.Equal("/data/c.bin", lowWaterPath);
+            Assert.Empty(ahead);
+        }
+
+        [Fact]
+        public void Checkpoint_IsCompleted_ShouldCoverLowWaterAndAhead()
+        {
+            var checkpoint = new ScanCheckpoint
+            {
+                LowWaterPath = "/data/b.bin",
+                CompletedAhead = new List<string> { "/data/d.bin" }
+            };
+
+            Assert.True(checkpoint.IsCompleted("/data/a.bin"));
+            Assert.True(checkpoint.IsCompleted("/data/b.bin"));
+            Assert.False(checkpoint.IsCompleted("/data/c.bin"));
+            Assert.True(checkpoint.IsCompleted("/data/d.bin"));
+            Assert.False(checkpoint.IsCompleted("/data/e.bin"));
+        }
+
+        [Fact]
+        public void Store_SaveLoadDelete_ShouldRoundTrip()
+        {
+            // Arrange
+            var store = new ScanCheckpointStore(_testDir);
+            var jobId = Guid.NewGuid();
+
+            // Act
+            store.Save(new ScanCheckpoint
+            {
+                JobId = jobId,
+                Paths = new List<string> { @"C:\" },
+                Type = ScanType.Full,
+                TotalFiles = 1000,
+                ScannedFiles = 400,
+                LowWaterPath = @"C:\Windows\a.dll",
+                CompletedAhead = new List<string> { @"C:\Windows\c.dll" }
+            });
+            var loaded = store.TryLoad(jobId);
+
+            // Assert
+            Assert.NotNull(loaded);
+            Assert.Equal(ScanType.Full, loaded!.Type);
+            Assert.Equal(40, loaded.ProgressPercent, 1);
+            Assert.Equal(@"C:\Windows\a.dll", loaded.LowWaterPath);
+            Assert.Single(store.GetAll());
+
+            Assert.True(store.Delete(jobId));
+            Assert.Null(store.TryLoad(jobId));
+        }
+
+        [Fact]
+        public void Store_ShouldPruneExpiredAndExcessCheckpoints()
+        {
+            // Arrange - حد 2 نقاط وعمر يوم واحد
+            var store = new ScanCheckpointStore(_testDir, TimeSpan.FromDays(1), maxCount: 2);
+            var expired = Guid.NewGuid();
+            store.Save(new ScanCheckpoint { JobId = expired });
+            File.SetLastWriteTimeUtc(
+                Path.Combine(_testDir, $"{expired:N}.checkpoint"), DateTime.UtcNow.AddDays(-2));
+
+            var ids = Enumerable.Range(0, 3).Select(_ => Guid.NewGuid()).ToList();
+            for (int i = 0; i < ids.Count; i++)
+            {
+                store.Save(new ScanCheckpoint { JobId = ids[i] });
+                File.SetLastWriteTimeUtc(
+                    Path.Combine(_testDir, $"{ids[i]:N}.checkpoint"), DateTime.UtcNow.AddMinutes(i - 10));
+            }
+
+            // Act
+            var all = store.GetAll();
+
+            // Assert - المنتهية والأقدم فوق الحد حُذفت
+            Assert.Equal(2, all.Count);
+            Assert.Null(store.TryLoad(expired));
+            Assert.Null(store.TryLoad(ids[0]));
+            Assert.NotNull(store.TryLoad(ids[2]));
+        }
+    }
+}
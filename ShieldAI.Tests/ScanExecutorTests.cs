@@ -0,0 +1,139 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/ScanExecutorTests.cs
+// اختبارات المنفذ المشترك: الأولوية، الخانات المحجوزة، الإلغاء
+// =====================================================
+
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class ScanExecutorTests
+    {
+        [Fact]
+        public async Task RunAsync_ShouldReturnWorkResult()
+        {
+            using var executor = new ScanExecutor(maxConcurrency: 2, reservedRealtimeSlots: 0);
+
+            var result = await executor.RunAsync(ScanPriorityClass.OnDemand, _ => Task.FromResult(42));
+
+            Assert.Equal(42, result);
+            Assert.Equal(1, executor.GetCompletedCount(ScanPriorityClass.OnDemand));
+        }
+
+        [Fact]
+        public async Task Realtime_ShouldRunBeforeQueuedBackgroundWork()
+        {
+            // Arrange - خانة واحدة مشغولة بعمل مجدول
+            using var executor = new ScanExecutor(maxConcurrency: 1, reservedRealtimeSlots: 0);
+            var gate = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+            var order = new List<string>();
+
+            var blocker = executor.RunAsync(ScanPriorityClass.Scheduled, async _ => { await gate.Task; });
+            var scheduled = executor.RunAsync(ScanPriorityClass.Scheduled, _ => { lock (order) order.Add("scheduled"); return Task.CompletedTask; });
+            var onDemand = executor.RunAsync(ScanPriorityClass.OnDemand, _ => { lock (order) order.Add("ondemand"); return Task.CompletedTask; });
+            var realtime = executor.RunAsync(ScanPriorityClass.Realtime, _ => { lock (order) order.Add("realtime"); return Task.CompletedTask; });
+
+            // Act - تحرير الخانة عند حد الملف
+            gate.SetResult(true);
+            await Task.WhenAll(blocker, scheduled, onDemand, realtime);
+
+            // Assert
+            Assert.Equal("realtime", order[0]);
+            Assert.Equal("ondemand", order[1]);
+            Assert.Equal("scheduled", order[2]);
+        }
+
+        [Fact]
+        public async Task ReservedSlot_ShouldKeepRealtimeResponsive()
+        {
+            // Arrange - خانتان، واحدة محجوزة للفوري
+            using var executor = new ScanExecutor(maxConcurrency: 2, reservedRealtimeSlots: 1);
+            var gate = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+
+            var background = Enumerable.Range(0, 4)
+                .Select(_ => executor.RunAsync(ScanPriorityClass.Scheduled, async _ => { await gate.Task; }))
+                .ToList();
+
+            // Act
+            var realtime = executor.RunAsync(ScanPriorityClass.Realtime, _ => Task.FromResult(true));
+            var completed = await Task.WhenAny(realtime, Task.Delay(5000));
+
+            // Assert
+            Assert.Same(realtime, completed);
+            Assert.Equal(1, executor.GetRunningCount(ScanPriorityClass.Scheduled));
+
+            gate.SetResult(true);
+            await Task.WhenAll(background);
+        }
+
+        [Fact]
+        public async Task CancelledWork_ShouldNotRun()
+        {
+            using var executor = new ScanExecutor(maxConcurrency: 1, reservedRealtimeSlots: 0);
+            var gate = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+            using var cts = new CancellationTokenSource();
+            bool ran = false;
+
+            var blocker = executor.RunAsync(ScanPriorityClass.OnDemand, async _ => { await gate.Task; });
+            var queued = executor.RunAsync(ScanPriorityClass.OnDemand, _ => { ran = true; return Task.CompletedTask; }, cts.Token);
+
+            cts.Cancel();
+            gate.SetResult(true);
+            await blocker;
+
+            await Assert.ThrowsAnyAsync<OperationCanceledException>(() => queued);
+            Assert.False(ran);
+        }
+
+        [Fact]
+        public async Task CancelledQueuedWork_ShouldLeaveQueueWithoutWaitingForSlot()
+        {
+            using var executor = new ScanExecutor(maxConcurrency: 1, reservedRealtimeSlots: 0);
+            var gate = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+            using var cts = new CancellationTokenSource();
+
+            var blocker = executor.RunAsync(ScanPriorityClass.OnDemand, async _ => { await gate.Task; });
+            var queued = Enumerable.Range(0, 3)
+                .Select(_ => executor.RunAsync(ScanPriorityClass.OnDemand, _ => Task.CompletedTask, cts.Token))
+                .ToList();
+
+            // Act - الخانة ما زالت مشغولة
+            cts.Cancel();
+
+            // Assert
+            var all = Task.WhenAll(queued);
+            Assert.Same(all, await Task.WhenAny(all, Task.Delay(5000)));
+            Assert.All(queued, t => Assert.True(t.IsCanceled));
+            Assert.Equal(0, executor.GetQueuedCount(ScanPriorityClass.OnDemand));
+
+            gate.SetResult(true);
+            await blocker;
+        }
+
+        [Fact]
+        public async Task SubmissionWindow_ShouldBoundInFlightWork()
+        {
+            using var executor = new ScanExecutor(maxConcurrency: 1, reservedRealtimeSlots: 0);
+            var window = new ScanSubmissionWindow(executor);
+            var gate = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+
+            var first = await window.SubmitAsync(() => executor.RunAsync(ScanPriorityClass.OnDemand, async _ => { await gate.Task; }));
+            var second = await window.SubmitAsync(() => executor.RunAsync(ScanPriorityClass.OnDemand, _ => Task.CompletedTask));
+
+            // Act - النافذة ممتلئة (ضعف السعة)
+            var third = window.SubmitAsync(() => executor.RunAsync(ScanPriorityClass.OnDemand, _ => Task.CompletedTask));
+            await Task.Delay(100);
+
+            // Assert
+            Assert.Equal(2, window.Capacity);
+            Assert.False(third.IsCompleted);
+            Assert.Equal(1, executor.GetQueuedCount(ScanPriorityClass.OnDemand));
+
+            gate.SetResult(true);
+            await Task.WhenAll(first, second, await third);
+            Assert.Equal(0, window.InFlight);
+        }
+    }
+}
@@ -0,0 +1,88 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/ScanProgressPublisherTests.cs
+// اختبارات العدادات الذرية وناشر التقدم بمعدل ثابت
+// =====================================================
+
+using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class ScanProgressPublisherTests
+    {
+        [Fact]
+        public async Task Counters_ShouldBeExact_UnderParallelIncrements()
+        {
+            var job = new ScanJob();
+
+            await Task.WhenAll(Enumerable.Range(0, 8).Select(_ => Task.Run(() =>
+            {
+                for (int i = 0; i < 10_000; i++)
+                {
+                    job.IncrementScannedFiles();
+                    if (i % 10 == 0) job.IncrementThreatsFound();
+                }
+            })));
+
+            Assert.Equal(80_000, job.ScannedFiles);
+            Assert.Equal(8_000, job.ThreatsFound);
+        }
+
+        [Fact]
+        public async Task Publisher_ShouldCoalesceUpdates()
+        {
+            // Arrange
+            var job = new ScanJob { TotalFiles = 10_000 };
+            var published = new List<ScanProgressEventArgs>();
+            using var publisher = new ScanProgressPublisher(
+                job, e => { lock (published) published.Add(e); }, TimeSpan.FromMilliseconds(50));
+
+            // Act - آلاف التحديثات خلال فترة قصيرة
+            for (int i = 0; i < 10_000; i++)
+            {
+                job.IncrementScannedFiles();
+                publisher.MarkDirty();
+            }
+            await Task.Delay(300);
+
+            // Assert
+            lock (published)
+            {
+                Assert.NotEmpty(published);
+                Assert.True(published.Count < 20);
+                Assert.Equal(10_000, published[^1].ScannedFiles);
+                Assert.Equal(100, published[^1].ProgressPercent, 1);
+            }
+        }
+
+        [Fact]
+        public async Task Publisher_WithoutUpdates_ShouldNotPublish()
+        {
+            var job = new ScanJob();
+            int count = 0;
+            using var publisher = new ScanProgressPublisher(
+                job, _ => Interlocked.Increment(ref count), TimeSpan.FromMilliseconds(20));
+
+            await Task.Delay(150);
+
+            Assert.Equal(0, Volatile.Read(ref count));
+        }
+
+        [Fact]
+        public void Snapshot_ThreatsShouldNotExceedScanned()
+        {
+            var job = new ScanJob { TotalFiles = 4 };
+            job.IncrementScannedFiles();
+            job.IncrementThreatsFound();
+            job.IncrementScannedFiles();
+
+            var snapshot = job.CreateProgressSnapshot();
+
+            Assert.Equal(2, snapshot.ScannedFiles);
+            Assert.Equal(1, snapshot.ThreatsFound);
+            Assert.Equal(50, snapshot.ProgressPercent, 1);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/ScanThrottleTests.cs
+// اختبارات تقييد الفحص: Token Bucket، نسبة CPU، وضع الخمول
+// =====================================================
+
+using ShieldAI.Core.Configuration;
+using ShieldAI.Core.Scanning;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class ScanThrottleTests
+    {
+        [Fact]
+        public void TokenBucket_WithinBurst_ShouldNotDelay()
+        {
+            var bucket = new TokenBucket(ratePerSecond: 100);
+
+            var delay = bucket.Reserve(50);
+
+            Assert.Equal(TimeSpan.Zero, delay);
+        }
+
+        [Fact]
+        public void TokenBucket_BeyondBurst_ShouldReturnProportionalDelay()
+        {
+            var bucket = new TokenBucket(ratePerSecond: 100);
+
+            bucket.Reserve(100);
+            var delay = bucket.Reserve(50);
+
+            // 50 رمز بمعدل 100/ثانية ≈ نصف ثانية
+            Assert.InRange(delay.TotalMilliseconds, 400, 510);
+        }
+
+        [Fact]
+        public void TokenBucket_IdleMultiplier_ShouldShortenDelay()
+        {
+            var normal = new TokenBucket(ratePerSecond: 100);
+            var boosted = new TokenBucket(ratePerSecond: 100);
+
+            normal.Reserve(100);
+            boosted.Reserve(100);
+
+            var normalDelay = normal.Reserve(100);
+            var boostedDelay = boosted.Reserve(100, rateMultiplier: 4);
+
+            Assert.True(boostedDelay < normalDelay);
+        }
+
+        [Theory]
+        [InlineData(100, 0)]
+        [InlineData(50, 100)]
+        [InlineData(25, 300)]
+        public void DutyCycle_ShouldRestProportionally(int dutyPercent, int expectedRestMs)
+        {
+            var throttle = new ScanThrottle(
+                new ScanThrottleOptions { CpuDutyCyclePercent = dutyPercent },
+                loadProvider: () => 1.0);
+
+            var rest = throttle.GetDutyCycleDelay(TimeSpan.FromMilliseconds(100));
+
+            Assert.Equal(expectedRestMs, (int)Math.Round(rest.TotalMilliseconds));
+        }
+
+        [Fact]
+        public void DutyCycle_WhenIdle_ShouldNotRest()
+        {
+            var throttle = new ScanThrottle(
+                new ScanThrottleOptions { CpuDutyCyclePercent = 50, IdleAware = true },
+                loadProvider: () => 0.05);
+
+            Assert.True(throttle.IsIdle);
+            Assert.Equal(TimeSpan.Zero, throttle.GetDutyCycleDelay(TimeSpan.FromMilliseconds(100)));
+        }
+
+        [Fact]
+        public async Task DutyCycle_ShouldStretchWallClockOfParallelScan()
+        {
+            // نفس نمط ScanOrchestrator: نافذة إرسال + عمل عبر المنفذ + راحة داخل المهمة المُرسلة
+            static async Task<TimeSpan> RunAsync(ScanThrottle? throttle)
+            {
+                using var executor = new ScanExecutor(maxConcurrency: 2, reservedRealtimeSlots: 0);
+                var window = new ScanSubmissionWindow(executor, throttle);
+                var busy = TimeSpan.FromMilliseconds(30);
+                var tasks = new List<Task>();
+                var stopwatch = System.Diagnostics.Stopwatch.StartNew();
+
+                for (int i = 0; i < 12; i++)
+                {
+                    tasks.Add(await window.SubmitAsync(async () =>
+                    {
+                        await executor.RunAsync(ScanPriorityClass.OnDemand, token => Task.Delay(busy, token));
+                        if (throttle != null)
+                            await throttle.AfterFileAsync(busy);
+                    }));
+                }
+
+                await Task.WhenAll(tasks);
+                return stopwatch.Elapsed;
+            }
+
+            var unthrottled = await RunAsync(null);
+            var halfDuty = await RunAsync(new ScanThrottle(
+                new ScanThrottleOptions { CpuDutyCyclePercent = 50 },
+                loadProvider: () => 1.0));
+
+            // 12 ملف × (30 عمل + 30 راحة) / خانتان ≈ 360ms مقابل ≈ 180ms بلا تقييد
+            Assert.True(halfDuty.TotalMilliseconds >= 300, $"halfDuty={halfDuty.TotalMilliseconds}ms");
+            Assert.True(halfDuty > unthrottled * 1.5,
+                $"halfDuty={halfDuty.TotalMilliseconds}ms unthrottled={unthrottled.TotalMilliseconds}ms");
+        }
+
+        [Fact]
+        public async Task LoadFactor_ShouldReadInjectedExecutor()
+        {
+            // Arrange - عمل فوري منتظر في منفذ غير المشترك
+            using var executor = new ScanExecutor(maxConcurrency: 1, reservedRealtimeSlots: 0);
+            var gate = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+            var blocker = executor.RunAsync(ScanPriorityClass.Scheduled, async _ => { await gate.Task; });
+            var realtime = executor.RunAsync(ScanPriorityClass.Realtime, _ => Task.CompletedTask);
+
+            var throttle = ScanThrottle.Create(new ScanThrottleOptions
+            {
+                IdleAware = true,
+                IdleLoadThreshold = 1.0,
+                CpuDutyCyclePercent = 50
+            }, executor);
+
+            // Act & Assert - الحمل يُقرأ من المنفذ المحقون لا من المشترك
+            Assert.Equal(1.0, SystemLoadMonitor.GetLoadFactor(executor));
+            Assert.False(throttle!.IsIdle);
+
+            gate.SetResult(true);
+            await Task.WhenAll(blocker, realtime);
+        }
+
+        [Fact]
+        public void Profiles_ShouldMapToThrottleOptions()
+        {
+            Assert.True(ScanProfile.QuickScan.GetThrottleOptions().IsUnlimited);
+            Assert.Null(ScanThrottle.Create(ScanProfile.Custom.GetThrottleOptions()));
+
+            var full = ScanProfile.FullScan.GetThrottleOptions();
+            Assert.False(full.IsUnlimited);
+            Assert.True(full.IdleAware);
+            Assert.NotNull(ScanThrottle.Create(full));
+        }
+    }
+}
@@ -0,0 +1,354 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/ShardCoordinatorTests.cs
+// اختبارات تقسيم الفحص إلى أجزاء ومنسق العمليات
+// =====================================================
+
+using ShieldAI.Core.Contracts;
+using ShieldAI.Core.Models;
+using ShieldAI.Core.Scanning;
+using ShieldAI.Service.Ipc;
+using ShieldAI.Service.Workers;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class ShardCoordinatorTests : IDisposable
+    {
+        private readonly string _testDir;
+        private readonly string _checkpointDir;
+
+        public ShardCoordinatorTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_Shard_{Guid.NewGuid():N}");
+            _checkpointDir = _testDir + "_checkpoints";
+            Directory.CreateDirectory(_testDir);
+
+            // root/{a.txt, b.bad}, root/x/{c.txt, deep/d.txt}, root/y/{e.bad}, root/z/
+            CreateFile("a.txt");
+            CreateFile("b.bad");
+            CreateFile(Path.Combine("x", "c.txt"));
+            CreateFile(Path.Combine("x", "deep", "d.txt"));
+            CreateFile(Path.Combine("y", "e.bad"));
+            Directory.CreateDirectory(Path.Combine(_testDir, "z"));
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+            try { if (Directory.Exists(_checkpointDir)) Directory.Delete(_checkpointDir, true); } catch { }
+        }
+
+        private void CreateFile(string relativePath)
+        {
+            var path = Path.Combine(_testDir, relativePath);
+            Directory.CreateDirectory(Path.GetDirectoryName(path)!);
+            File.WriteAllText(path, relativePath);
+        }
+
+        private static List<string> ExpandShards(IEnumerable<ScanShard> shards)
+        {
+            var enumerator = new FileEnumerator();
+            return shards
+                .SelectMany(s => enumerator.EnumerateFiles(s.Path, true, s.MaxDepth))
+                .Select(f => f.FullName)
+                .ToList();
+        }
+
+        [Fact]
+        public void Plan_ShouldCoverEveryFileExactlyOnce()
+        {
+            var shards = ScanShardPlanner.Plan(new[] { _testDir }, targetShards: 8);
+
+            var files = ExpandShards(shards);
+
+            Assert.True(shards.Count > 1);
+            Assert.Equal(5, files.Count);
+            Assert.Equal(files.Count, files.Distinct(StringComparer.OrdinalIgnoreCase).Count());
+        }
+
+        [Fact]
+        public void Plan_ShouldRespectJobMaxDepth()
+        {
+            // عمق 1: ملفات الجذر + ملفات المجلدات المباشرة فقط (بدون deep/d.txt)
+            var shards = ScanShardPlanner.Plan(new[] { _testDir }, targetShards: 8, maxDepth: 1);
+
+            var files = ExpandShards(shards);
+
+            Assert.Equal(4, files.Count);
+            Assert.DoesNotContain(files, f => f.EndsWith("d.txt"));
+        }
+
+        [Fact]
+        public void Plan_WithSingleTarget_ShouldNotExpand()
+        {
+            var shards = ScanShardPlanner.Plan(new[] { _testDir }, targetShards: 1);
+
+            Assert.Single(shards);
+            Assert.Equal(-1, shards[0].MaxDepth);
+        }
+
+        [Fact]
+        public async Task Coordinator_ShouldMergeProgressAndThreatsFromWorkers()
+        {
+            // Arrange
+            var started = 0;
+            using var coordinator = new ShardCoordinator(workerCount: 2, workerFactory: (slot, _) =>
+            {
+                Interlocked.Increment(ref started);
+                return new FakeShardWorker(slot);
+            }) { PollInterval = TimeSpan.FromMilliseconds(10) };
+
+            var detected = new List<string>();
+            coordinator.ThreatDetected += (_, e) => { lock (detected) detected.Add(e.Result.FilePath); };
+
+            var job = new ScanJob { Paths = new List<string> { _testDir }, Type = ScanType.Full };
+
+            // Act
+            var report = await coordinator.ExecuteScanJobAsync(job);
+
+            // Assert
+            Assert.Equal(ScanStatus.Completed, report.FinalStatus);
+            Assert.Equal(5, report.TotalFiles);
+            Assert.Equal(5, report.ScannedFiles);
+            Assert.Equal(2, report.ThreatsFound);
+            Assert.Equal(2, report.Threats.Count);
+            Assert.Equal(2, detected.Count);
+            Assert.Equal(2, started);
+            Assert.Empty(coordinator.GetActiveJobs());
+        }
+
+        [Fact]
+        public async Task Coordinator_ShouldRedispatchShardWhenWorkerCrashes()
+        {
+            // العامل الأول ينهار في منتصف أول جزء
+            var crashes = 1;
+            using var coordinator = new ShardCoordinator(workerCount: 1, workerFactory: (slot, _) =>
+                new FakeShardWorker(slot) { CrashOnProgress = Interlocked.Exchange(ref crashes, 0) == 1 })
+            {
+                PollInterval = TimeSpan.FromMilliseconds(10)
+            };
+
+            var job = new ScanJob { Paths = new List<string> { _testDir }, Type = ScanType.Full };
+
+            var report = await coordinator.ExecuteScanJobAsync(job);
+
+            Assert.Equal(ScanStatus.Completed, report.FinalStatus);
+            Assert.Equal(5, report.ScannedFiles);
+            Assert.Equal(2, report.ThreatsFound);
+            Assert.Empty(report.Errors);
+        }
+
+        [Fact]
+        public async Task Coordinator_ShouldReportShardAfterMaxAttempts()
+        {
+            using var coordinator = new ShardCoordinator(workerCount: 1, workerFactory: (slot, _) =>
+                new FakeShardWorker(slot) { CrashOnProgress = true })
+            {
+                PollInterval = TimeSpan.FromMilliseconds(10),
+                MaxShardAttempts = 2
+            };
+
+            var job = new ScanJob { Paths = new List<string> { _testDir }, Type = ScanType.Full };
+
+            var report = await coordinator.ExecuteScanJobAsync(job);
+
+            Assert.NotEmpty(report.Errors);
+            Assert.Equal(0, report.ScannedFiles);
+        }
+
+        [Fact]
+        public async Task Coordinator_ShouldScaleWorkerConcurrencyFromExecutorBudget()
+        {
+            // 6 خانات منها 2 للفوري: 4 للفئات الخلفية بين عاملين
+            using var executor = new ScanExecutor(maxConcurrency: 6, reservedRealtimeSlots: 2);
+            var concurrencies = new List<int>();
+            using var coordinator = new ShardCoordinator(
+                workerCount: 2,
+                workerFactory: (slot, concurrency) =>
+                {
+                    lock (concurrencies) concurrencies.Add(concurrency);
+                    return new FakeShardWorker(slot);
+                },
+                executor: executor,
+                checkpointStore: new ScanCheckpointStore(_checkpointDir))
+            {
+                PollInterval = TimeSpan.FromMilliseconds(10)
+            };
+
+            await coordinator.ExecuteScanJobAsync(
+                new ScanJob { Paths = new List<string> { _testDir }, Type = ScanType.Full });
+            Assert.All(concurrencies, c => Assert.Equal(2, c));
+
+            // المجدول يأخذ نصيبه بالوزن فقط (خيط واحد لكل عامل كحد أدنى)
+            concurrencies.Clear();
+            await coordinator.ExecuteScanJobAsync(
+                new ScanJob { Paths = new List<string> { _testDir }, Type = ScanType.Full },
+                priority: ScanPriorityClass.Scheduled);
+            Assert.All(concurrencies, c => Assert.Equal(1, c));
+            Assert.Equal(4, executor.GetClassBudget(ScanPriorityClass.OnDemand));
+            Assert.Equal(6, executor.GetClassBudget(ScanPriorityClass.Realtime));
+        }
+
+        [Fact]
+        public async Task Coordinator_ShouldResumeOnlyIncompleteShards()
+        {
+            // Arrange - نصف الأجزاء اكتمل في جلسة سابقة
+            var store = new ScanCheckpointStore(_checkpointDir);
+            var shards = ScanShardPlanner.Plan(new[] { _testDir }, targetShards: 8);
+            var completed = shards.Take(shards.Count / 2).ToList();
+            var jobId = Guid.NewGuid();
+
+            store.Save(new ScanCheckpoint
+            {
+                JobId = jobId,
+                Paths = new List<string> { _testDir },
+                Type = ScanType.Full,
+                TotalFiles = 5,
+                ScannedFiles = ExpandShards(completed).Count,
+                ThreatsFound = ExpandShards(completed).Count(f => f.EndsWith(".bad")),
+                Shards = shards,
+                CompletedShards = completed.Select(s => s.Id).ToList()
+            });
+
+            var dispatched = new List<int>();
+            using var coordinator = new ShardCoordinator(
+                workerCount: 2,
+                workerFactory: (slot, _) => new FakeShardWorker(slot)
+                {
+                    OnShard = request => { lock (dispatched) dispatched.Add(request.ShardId); }
+                },
+                checkpointStore: store)
+            {
+                PollInterval = TimeSpan.FromMilliseconds(10)
+            };
+
+            Assert.Single(coordinator.GetResumableScans());
+
+            // Act
+            var report = await coordinator.ResumeScanAsync(jobId);
+
+            // Assert
+            Assert.NotNull(report);
+            Assert.Equal(ScanStatus.Completed, report!.FinalStatus);
+            Assert.Equal(shards.Count - completed.Count, dispatched.Count);
+            Assert.DoesNotContain(dispatched, id => completed.Any(s => s.Id == id));
+            Assert.Equal(5, report.ScannedFiles);
+            Assert.Equal(2, report.ThreatsFound);
+            Assert.Null(store.TryLoad(jobId));
+        }
+
+        [Theory]
+        [InlineData(true)]
+        [InlineData(false)]
+        public async Task Coordinator_ShouldKeepCheckpointOnlyWhenSuspended(bool userStop)
+        {
+            var store = new ScanCheckpointStore(_checkpointDir);
+            var dispatched = new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
+            using var coordinator = new ShardCoordinator(
+                workerCount: 1,
+                workerFactory: (slot, _) => new FakeShardWorker(slot)
+                {
+                    HoldProgress = true,
+                    OnShard = _ => dispatched.TrySetResult()
+                },
+                checkpointStore: store)
+            {
+                PollInterval = TimeSpan.FromMilliseconds(10)
+            };
+
+            var job = new ScanJob { Paths = new List<string> { _testDir }, Type = ScanType.Full };
+            var scan = coordinator.ExecuteScanJobAsync(job);
+            await dispatched.Task.WaitAsync(TimeSpan.FromSeconds(5));
+
+            // إيقاف المستخدم ينهي الفحص، وإيقاف الخدمة يتركه قابلاً للاستئناف
+            if (userStop)
+                coordinator.StopScan(job.Id);
+            else
+                coordinator.SuspendAllScans();
+
+            var report = await scan;
+
+            Assert.Equal(ScanStatus.Cancelled, report.FinalStatus);
+            Assert.Equal(!userStop, store.TryLoad(job.Id) != null);
+        }
+
+        /// <summary>
+        /// عامل داخل العملية: يعد ملفات الجزء ويعتبر *.bad تهديداً
+        /// </summary>
+        private sealed class FakeShardWorker : IShardWorker
+        {
+            private ScanShardRequest? _request;
+            private bool _alive;
+
+            public FakeShardWorker(int slotId) => SlotId = slotId;
+
+            public int SlotId { get; }
+            public bool IsAlive => _alive;
+            public bool CrashOnProgress { get; init; }
+            public Action<ScanShardRequest>? OnShard { get; init; }
+            public bool HoldProgress { get; init; }
+
+            public Task StartAsync(CancellationToken ct)
+            {
+                _alive = true;
+                return Task.CompletedTask;
+            }
+
+            public Task<ResponseEnvelope> SendAsync(CommandEnvelope command, CancellationToken ct)
+            {
+                if (!_alive)
+                    throw new IOException("worker is dead");
+
+                switch (command.CommandType)
+                {
+                    case Commands.ScanShard:
+                        _request = command.GetPayload<ScanShardRequest>();
+                        OnShard?.Invoke(_request!);
+                        return Task.FromResult(ResponseEnvelope.Ok(command.Id));
+
+                    case Commands.GetShardProgress:
+                        if (CrashOnProgress)
+                        {
+                            _alive = false;
+                            throw new IOException("worker crashed");
+                        }
+
+                        if (HoldProgress)
+                        {
+                            return Task.FromResult(ResponseEnvelope.Ok(command.Id, new ShardProgressResponse
+                            {
+                                ShardId = _request!.ShardId,
+                                Status = ScanStatus.Running
+                            }));
+                        }
+
+                        var files = new FileEnumerator()
+                            .EnumerateFiles(_request!.Path, true, _request.MaxDepth)
+                            .ToList();
+
+                        var progress = new ShardProgressResponse
+                        {
+                            ShardId = _request.ShardId,
+                            Status = ScanStatus.Completed,
+                            TotalFiles = files.Count,
+                            ScannedFiles = files.Count,
+                            IsFinal = true,
+                            NewThreats = files
+                                .Where(f => f.Extension == ".bad")
+                                .Select(f => new ScanResult { FilePath = f.FullName, Verdict = ScanVerdict.Malicious })
+                                .ToList()
+                        };
+                        progress.ThreatsFound = progress.NewThreats.Count;
+
+                        return Task.FromResult(ResponseEnvelope.Ok(command.Id, progress));
+
+                    default:
+                        return Task.FromResult(ResponseEnvelope.Ok(command.Id));
+                }
+            }
+
+            public void Dispose() => _alive = false;
+        }
+    }
+}
@@ -0,0 +1,107 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/TimingWheelTests.cs
+// اختبارات عجلة التوقيت الهرمية
+// =====================================================
+
+using ShieldAI.Core.Monitoring.Pipeline;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class TimingWheelTests
+    {
+        [Fact]
+        public void Advance_ShouldExpireOnlyDueItems()
+        {
+            var wheel = new TimingWheel<string>(tickMs: 10);
+            wheel.Schedule("a", 50);
+            wheel.Schedule("b", 120);
+
+            var expired = new List<string>();
+            wheel.Advance(60, expired);
+
+            Assert.Equal(new[] { "a" }, expired);
+            Assert.Equal(1, wheel.Count);
+
+            expired.Clear();
+            wheel.Advance(119, expired);
+            Assert.Empty(expired);
+
+            wheel.Advance(120, expired);
+            Assert.Equal(new[] { "b" }, expired);
+            Assert.Equal(0, wheel.Count);
+        }
+
+        [Fact]
+        public void Advance_ShouldCascadeFarItemsThroughLevels()
+        {
+            // 4 خانات لكل مستوى: المستوى 0 يغطي 4 ticks، الأول 16، الثاني 64
+            var wheel = new TimingWheel<int>(tickMs: 1, slotBits: 2, levels: 3);
+            var dueTimes = new[] { 3, 7, 17, 40, 63 };
+            foreach (var due in dueTimes)
+                wheel.Schedule(due, due);
+
+            var expiredAt = new Dictionary<int, long>();
+            var expired = new List<int>();
+            for (long now = 1; now <= 70; now++)
+            {
+                wheel.Advance(now, expired);
+                foreach (var item in expired)
+                    expiredAt[item] = now;
+                expired.Clear();
+            }
+
+            foreach (var due in dueTimes)
+                Assert.Equal(due, expiredAt[due]);
+        }
+
+        [Fact]
+        public void Schedule_BeyondRange_ShouldStillExpireOnTime()
+        {
+            // المدى الكامل 16 tick - العنصر عند 40 يُعاد وضعه أكثر من مرة
+            var wheel = new TimingWheel<string>(tickMs: 1, slotBits: 2, levels: 2);
+            wheel.Schedule("far", 40);
+
+            var expired = new List<string>();
+            wheel.Advance(39, expired);
+            Assert.Empty(expired);
+
+            wheel.Advance(40, expired);
+            Assert.Equal(new[] { "far" }, expired);
+        }
+
+        [Fact]
+        public void Schedule_InThePast_ShouldExpireOnNextAdvance()
+        {
+            var wheel = new TimingWheel<string>(tickMs: 10, startMs: 1000);
+            wheel.Schedule("late", 500);
+
+            var expired = new List<string>();
+            wheel.Advance(1000, expired);
+
+            Assert.Equal(new[] { "late" }, expired);
+        }
+
+        [Fact]
+        public void LargeBacklog_ShouldExpireInDeadlineOrderBuckets()
+        {
+            var wheel = new TimingWheel<int>(tickMs: 10);
+            for (int i = 0; i < 100_000; i++)
+                wheel.Schedule(i, 100 + (i % 1000) * 10);
+
+            var expired = new List<int>();
+            wheel.Advance(100, expired);
+
+            // عند t=100 فقط العناصر ذات الموعد 100
+            Assert.Equal(100, expired.Count);
+            Assert.All(expired, i => Assert.Equal(0, i % 1000));
+            Assert.Equal(99_900, wheel.Count);
+
+            expired.Clear();
+            wheel.Advance(10_090, expired);
+            Assert.Equal(99_900, expired.Count);
+            Assert.Equal(0, wheel.Count);
+        }
+    }
+}
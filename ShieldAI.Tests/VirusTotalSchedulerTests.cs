@@ -0,0 +1,257 @@
+// =====================================================
+// ShieldAI - AI-Powered Antivirus Solution
+// Tests/VirusTotalSchedulerTests.cs
+// اختبارات مجدول VirusTotal مقابل خادم HTTP محلي
+// =====================================================
+
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using System.Text;
+using ShieldAI.Core.Detection;
+using Xunit;
+
+namespace ShieldAI.Tests
+{
+    public class VirusTotalSchedulerTests : IDisposable
+    {
+        private readonly string _testDir;
+
+        public VirusTotalSchedulerTests()
+        {
+            _testDir = Path.Combine(Path.GetTempPath(), $"ShieldAI_VT_{Guid.NewGuid():N}");
+            Directory.CreateDirectory(_testDir);
+        }
+
+        public void Dispose()
+        {
+            try { if (Directory.Exists(_testDir)) Directory.Delete(_testDir, true); } catch { }
+        }
+
+        private static string Hash(int i) => i.ToString("x64");
+
+        private static string Report(int malicious) =>
+            "{\"data\":{\"attributes\":{\"last_analysis_stats\":{\"malicious\":" + malicious +
+            ",\"suspicious\":0,\"harmless\":1,\"undetected\":10},\"last_analysis_results\":{}}}}";
+
+        private VirusTotalClient CreateClient(StubServer server, VirusTotalSchedulerOptions options) => new(
+            "test-key",
+            cachePath: Path.Combine(_testDir, $"vt_{Guid.NewGuid():N}.json"),
+            schedulerOptions: options,
+            baseUrl: server.BaseUrl);
+
+        [Fact]
+        public async Task DuplicateHashes_ShouldShareOneRequest()
+        {
+            var release = new TaskCompletionSource();
+            using var server = new StubServer(async (method, path) =>
+            {
+                await release.Task;
+                return (200, Report(2), null);
+            });
+            using var client = CreateClient(server, new VirusTotalSchedulerOptions { RequestsPerMinute = 6000, BurstSize = 10 });
+
+            var tasks = Enumerable.Range(0, 5)
+                .Select(_ => client.GetFileReportAsync(Hash(1)))
+                .ToList();
+            await Task.Delay(100);
+            release.SetResult();
+            var results = await Task.WhenAll(tasks);
+
+            Assert.All(results, r => Assert.Equal(2, r.Malicious));
+            Assert.Equal(1, server.Requests.Count);
+            Assert.Equal(4, client.Scheduler.CoalescedCount);
+
+            // النتيجة في الكاش: لا طلب جديد
+            await client.GetFileReportAsync(Hash(1));
+            Assert.Equal(1, server.Requests.Count);
+        }
+
+        [Fact]
+        public async Task Queue_ShouldServeHigherRiskFirst_AndRespectRate()
+        {
+            using var server = new StubServer((method, path) => Task.FromResult((200, Report(0), (int?)null)));
+            using var client = CreateClient(server, new VirusTotalSchedulerOptions { RequestsPerMinute = 600, BurstSize = 1 });
+            var scheduler = client.Scheduler;
+
+            // استهلاك رمز الدفعة الوحيد: ما يلي يصطف كله قبل أن يتوفر رمز جديد
+            await scheduler.SubmitAsync(Hash(100), null, riskScore: 0);
+            var stopwatch = Stopwatch.StartNew();
+
+            var tasks = new[]
+            {
+                scheduler.SubmitAsync(Hash(1), null, riskScore: 5),
+                scheduler.SubmitAsync(Hash(2), null, riskScore: 10),
+                scheduler.SubmitAsync(Hash(3), null, riskScore: 90),
+                scheduler.SubmitAsync(Hash(4), null, riskScore: 50)
+            };
+            await Task.WhenAll(tasks);
+
+            Assert.Equal(
+                $"GET /files/{Hash(100)}|GET /files/{Hash(3)}|GET /files/{Hash(4)}|GET /files/{Hash(2)}|GET /files/{Hash(1)}",
+                string.Join("|", server.Requests));
+
+            // 10 طلبات/ثانية بدفعة 1: أربعة انتظارات (~100ms لكل منها)
+            Assert.True(stopwatch.ElapsedMilliseconds >= 350);
+        }
+
+        [Fact]
+        public async Task RateLimitedResponse_ShouldHonourRetryAfter()
+        {
+            int calls = 0;
+            using var server = new StubServer((method, path) => Task.FromResult(
+                Interlocked.Increment(ref calls) == 1
+                    ? (429, "", (int?)1)
+                    : (200, Report(7), (int?)null)));
+            using var client = CreateClient(server, new VirusTotalSchedulerOptions { RequestsPerMinute = 6000, BurstSize = 10 });
+            var stopwatch = Stopwatch.StartNew();
+
+            var result = await client.GetFileReportAsync(Hash(9));
+
+            Assert.Equal(7, result.Malicious);
+            Assert.Equal(1, client.Scheduler.RateLimitedCount);
+            Assert.Equal(2, server.Requests.Count);
+            Assert.True(stopwatch.ElapsedMilliseconds >= 900);
+        }
+
+        [Fact]
+        public async Task UnknownFile_ShouldUploadAndPollWithBackoff()
+        {
+            var filePath = Path.Combine(_testDir, "sample.bin");
+            File.WriteAllBytes(filePath, Encoding.UTF8.GetBytes("unknown sample"));
+            var sha = Hash(5);
+            int polls = 0, reports = 0;
+
+            using var server = new StubServer((method, path) =>
+            {
+                if (method == "POST" && path == "/files")
+                    return Task.FromResult((200, "{\"data\":{\"id\":\"an1\"}}", (int?)null));
+                if (path == "/analyses/an1")
+                {
+                    var status = Interlocked.Increment(ref polls) < 3 ? "queued" : "completed";
+                    return Task.FromResult((200,
+                        "{\"data\":{\"attributes\":{\"status\":\"" + status + "\"},\"meta\":{\"file_info\":{\"sha256\":\"" + sha + "\"}}}}",
+                        (int?)null));
+                }
+                return Task.FromResult(Interlocked.Increment(ref reports) == 1
+                    ? (404, "", (int?)null)
+                    : (200, Report(4), (int?)null));
+            });
+            using var client = CreateClient(server, new VirusTotalSchedulerOptions
+            {
+                RequestsPerMinute = 6000,
+                BurstSize = 10,
+                AllowUpload = true,
+                PollInitialDelay = TimeSpan.FromMilliseconds(50),
+                PollBackoffFactor = 2
+            });
+            var stopwatch = Stopwatch.StartNew();
+
+            var result = await client.ScanFileAsync(filePath, sha, riskScore: 70);
+
+            Assert.True(result.Found);
+            Assert.Equal(4, result.Malicious);
+            Assert.Equal(3, polls);
+            // 50 + 100 + 200 مللي ثانية بين محاولات الاستطلاع
+            Assert.True(stopwatch.ElapsedMilliseconds >= 330);
+            Assert.Equal(
+                $"GET /files/{sha}|POST /files|GET /analyses/an1|GET /analyses/an1|GET /analyses/an1|GET /files/{sha}",
+                string.Join("|", server.Requests));
+        }
+
+        [Fact]
+        public async Task UploadDisabled_ShouldReturnNotFoundWithoutUploading()
+        {
+            var filePath = Path.Combine(_testDir, "private.bin");
+            File.WriteAllText(filePath, "private");
+            using var server = new StubServer((method, path) => Task.FromResult((404, "", (int?)null)));
+            using var client = CreateClient(server, new VirusTotalSchedulerOptions { RequestsPerMinute = 6000, AllowUpload = false });
+
+            var result = await client.ScanFileAsync(filePath, Hash(6), riskScore: 80);
+
+            Assert.False(result.Found);
+            Assert.False(result.HasError);
+            Assert.Equal($"GET /files/{Hash(6)}", Assert.Single(server.Requests));
+        }
+
+        [Fact]
+        public async Task DailyQuota_ShouldFailFastOnceExhausted()
+        {
+            using var server = new StubServer((method, path) => Task.FromResult((200, Report(1), (int?)null)));
+            using var client = CreateClient(server, new VirusTotalSchedulerOptions { RequestsPerMinute = 6000, BurstSize = 10, DailyQuota = 1 });
+
+            var first = await client.GetFileReportAsync(Hash(1));
+            var second = await client.GetFileReportAsync(Hash(2));
+
+            Assert.True(first.Found);
+            Assert.True(second.HasError);
+            Assert.Equal(1, server.Requests.Count);
+        }
+
+        /// <summary>
+        /// خادم HTTP محلي يسجل الطلبات ويرد حسب الدالة المعطاة (الحالة، المحتوى، Retry-After)
+        /// </summary>
+        private sealed class StubServer : IDisposable
+        {
+            private readonly HttpListener _listener = new();
+            private readonly Func<string, string, Task<(int Status, string Body, int? RetryAfter)>> _handler;
+            private readonly string _prefixPath = "/api/v3";
+
+            public StubServer(Func<string, string, Task<(int Status, string Body, int? RetryAfter)>> handler)
+            {
+                _handler = handler;
+                var probe = new TcpListener(IPAddress.Loopback, 0);
+                probe.Start();
+                var port = ((IPEndPoint)probe.LocalEndpoint).Port;
+                probe.Stop();
+
+                BaseUrl = $"http://127.0.0.1:{port}{_prefixPath}/";
+                _listener.Prefixes.Add(BaseUrl);
+                _listener.Start();
+                _ = Task.Run(ServeAsync);
+            }
+
+            public string BaseUrl { get; }
+
+            public ConcurrentQueue<string> Requests { get; } = new();
+
+            private async Task ServeAsync()
+            {
+                while (_listener.IsListening)
+                {
+                    HttpListenerContext context;
+                    try
+                    {
+                        context = await _listener.GetContextAsync();
+                    }
+                    catch
+                    {
+                        return;
+                    }
+
+                    _ = Task.Run(async () =>
+                    {
+                        var path = context.Request.Url!.AbsolutePath[_prefixPath.Length..];
+                        Requests.Enqueue($"{context.Request.HttpMethod} {path}");
+
+                        var (status, body, retryAfter) = await _handler(context.Request.HttpMethod, path);
+                        context.Response.StatusCode = status;
+                        if (retryAfter != null)
+                            context.Response.Headers["Retry-After"] = retryAfter.Value.ToString();
+                        var bytes = Encoding.UTF8.GetBytes(body);
+                        context.Response.ContentType = "application/json";
+                        await context.Response.OutputStream.WriteAsync(bytes);
+                        context.Response.Close();
+                    });
+                }
+            }
+
+            public void Dispose()
+            {
+                _listener.Stop();
+                _listener.Close();
+            }
+        }
+    }
+}
@@ -106,6 +106,15 @@ namespace ShieldAI.UI.Services
             return response?.GetPayload<ServiceStatusResponse>();
         }
 
+        /// <summary>
+        /// حالة الحماية الفورية وإحصائيات مسارات الأحداث
+        /// </summary>
+        public async Task<RealTimeStatusResponse?> GetRealTimeStatusAsync()
+        {
+            var response = await SendCommandAsync(CommandEnvelope.Create(Commands.GetRealTimeStatus));
+            return response?.GetPayload<RealTimeStatusResponse>();
+        }
+
         /// <summary>
         /// بدء فحص
         /// </summary>
@@ -151,6 +160,26 @@ namespace ShieldAI.UI.Services
             return response?.GetPayload<ScanProgressResponse>();
         }
 
+        /// <summary>
+        /// الفحوصات المنقطعة القابلة للاستئناف
+        /// </summary>
+        public async Task<ResumableScansResponse?> GetResumableScansAsync()
+        {
+            var response = await SendCommandAsync(CommandEnvelope.Create(Commands.GetResumableScans));
+            return response?.GetPayload<ResumableScansResponse>();
+        }
+
+        /// <summary>
+        /// استئناف فحص منقطع
+        /// </summary>
+        public async Task<StartScanResponse?> ResumeScanAsync(Guid jobId)
+        {
+            var response = await SendCommandAsync(
+                CommandEnvelope.Create(Commands.ResumeScan, new ResumeScanRequest { JobId = jobId }));
+
+            return response?.GetPayload<StartScanResponse>();
+        }
+
         /// <summary>
         /// تفعيل الحماية الفورية
         /// </summary>